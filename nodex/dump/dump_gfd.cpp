@@ -0,0 +1,24 @@
+#include "block2_core.hpp"
+#include "block2_dmrg.hpp"
+using namespace block2;
+int main(int argc, char *argv[]) {
+    frame_<double>() = make_shared<DataFrame<double>>(1LL << 24, 1LL << 30, "nodex");
+    threading_() = make_shared<Threading>(ThreadingTypes::OperatorBatchedGEMM | ThreadingTypes::Global, 1, 1, 1);
+    for (string f : {"data/N2.STO3G.FCIDUMP", "data/N2.STO3G.UHF.FCIDUMP"})
+        for (int c = 0; c < 2; c++) {
+            shared_ptr<FCIDUMP<double>> fd = c ? make_shared<CompressedFCIDUMP<double>>(1E-13, 5, 128) : make_shared<FCIDUMP<double>>();
+            fd->read(f);
+            for (auto et : {ElemOpTypes::SU2, ElemOpTypes::SZ}) {
+                if (fd->uhf && et == ElemOpTypes::SU2) continue;
+                auto g = GeneralFCIDUMP<double>::initialize_from_qc(fd, et);
+                cout << setprecision(15);
+                for (size_t i = 0; i < g->exprs.size(); i++) {
+                    cout << g->exprs[i] << " " << g->indices[i].size() << endl;
+                    for (auto x : g->indices[i]) cout << x << " ";
+                    for (auto x : g->data[i]) cout << x << " ";
+                    cout << endl;
+                }
+            }
+        }
+    return 0;
+}
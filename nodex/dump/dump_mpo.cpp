@@ -0,0 +1,71 @@
+#include "block2_core.hpp"
+#include "block2_dmrg.hpp"
+
+using namespace block2;
+
+template <typename S>
+shared_ptr<MPO<S, double>> mk(const shared_ptr<HamiltonianQC<S, double>> &h,
+                              QCTypes mode, int trans, bool sym) {
+    return make_shared<MPOQC<S, double>>(h, mode, "HQC", trans);
+}
+
+template <>
+shared_ptr<MPO<SZ, double>> mk<SZ>(const shared_ptr<HamiltonianQC<SZ, double>> &h,
+                              QCTypes mode, int trans, bool sym) {
+    return make_shared<MPOQC<SZ, double>>(h, mode, "HQC", trans, 1, sym);
+}
+
+template <typename S>
+void dump(const string &fname, bool compressed, QCTypes mode, int trans,
+          ostream &os, bool sym = true) {
+    shared_ptr<FCIDUMP<double>> fcidump =
+        compressed ? make_shared<CompressedFCIDUMP<double>>(1E-13, 5, 128)
+                   : make_shared<FCIDUMP<double>>();
+    fcidump->read(fname);
+    vector<uint8_t> orbsym = fcidump->template orb_sym<uint8_t>();
+    transform(orbsym.begin(), orbsym.end(), orbsym.begin(),
+              PointGroup::swap_pg(PGTypes::D2H));
+    shared_ptr<HamiltonianQC<S, double>> hamil =
+        make_shared<HamiltonianQC<S, double>>(S(0), fcidump->n_sites(), orbsym,
+                                              fcidump);
+    shared_ptr<MPO<S, double>> mpo = mk<S>(hamil, mode, trans, sym);
+    os << setprecision(12);
+    for (int i = 0; i < mpo->n_sites; i++) {
+        mpo->load_tensor(i, true);
+        os << "SITE " << i << endl;
+        os << mpo->tensors[i]->lmat;
+        mpo->unload_tensor(i);
+        mpo->load_left_operators(i);
+        os << mpo->left_operator_names[i];
+        mpo->unload_left_operators(i);
+    }
+    if (mpo->schemer != nullptr) {
+        mpo->load_schemer();
+        for (auto &x : mpo->schemer->left_new_operator_exprs->data)
+            os << x << endl;
+        for (auto &x : mpo->schemer->right_new_operator_exprs->data)
+            os << x << endl;
+        mpo->unload_schemer();
+    }
+    mpo->deallocate();
+    hamil->deallocate();
+    fcidump->deallocate();
+}
+
+int main(int argc, char *argv[]) {
+    frame_<double>() = make_shared<DataFrame<double>>(1LL << 24, 1LL << 30,
+                                                      "nodex");
+    threading_() = make_shared<Threading>(
+        ThreadingTypes::OperatorBatchedGEMM | ThreadingTypes::Global, 1, 1, 1);
+    bool cps = argc > 1 && string(argv[1]) == "c";
+    for (auto mode : {QCTypes::NC, QCTypes::CN, QCTypes::Conventional}) {
+        ofstream ofs(string("nodex/out_su2_") + to_string((int)mode) +
+                     (cps ? "c" : ""));
+        dump<SU2>("data/N2.STO3G.FCIDUMP", cps, mode, 4, ofs);
+        ofstream ofs2(string("nodex/out_sz_") + to_string((int)mode) +
+                      (cps ? "c" : ""));
+        dump<SZ>("data/N2.STO3G.FCIDUMP", cps, mode, 4, ofs2);
+        dump<SZ>("data/N2.STO3G.FCIDUMP", cps, mode, 4, ofs2, false);
+    }
+    return 0;
+}
@@ -87,6 +87,55 @@ class SubTensor:
         return "(Q=) %r (R=) %r" % (self.q_labels, self.reduced)
 
 
+_native_classes = None
+
+
+def _native_backend(*tss):
+    """
+    Native block-sparse tensor class (``BlockSparseTensor`` in block2)
+    for operands with SZ labels and float64/complex128 data, or None.
+    """
+    global _native_classes
+    if not Tensor.use_native or any(ts.rank == 0 for ts in tss):
+        return None
+    if _native_classes is None:
+        _native_classes = {}
+        try:
+            import block2
+        except ImportError:
+            block2 = None
+        for is_cpx, mod in [(False, "sz"), (True, "cpx.sz")]:
+            try:
+                sub = block2
+                for x in mod.split("."):
+                    sub = getattr(sub, x)
+                _native_classes[block2.SZ, is_cpx] = sub.BlockSparseTensor
+            except (ImportError, AttributeError):
+                pass
+    is_cpx = False
+    for ts in tss:
+        for block in ts.blocks:
+            dtype = getattr(block.reduced, "dtype", None)
+            if dtype == np.complex128:
+                is_cpx = True
+            elif dtype != np.float64:
+                return None
+    q_type = type(tss[0].blocks[0].q_labels[0])
+    return _native_classes.get((q_type, is_cpx), None)
+
+
+def _to_native(cls, ts):
+    return cls([b.q_labels for b in ts.blocks], [b.reduced for b in ts.blocks])
+
+
+def _from_native(nts):
+    return Tensor(blocks=[SubTensor(q_labels=q, reduced=r) for q, r in nts.blocks])
+
+
+def _mats_from_native(nmats):
+    return {q[0]: r for q, r in nmats.blocks}
+
+
 class Tensor:
     """
     Block-sparse tensor.
@@ -94,8 +143,14 @@ class Tensor:
     Attributes:
         blocks : list(SubTensor)
             A list of (non-zero) blocks.
+        use_native : bool
+            Class attribute. If True, contraction, canonicalization
+            and compression use the native block2 backend when it is available
+            for the quantum label type and data type. Default is False.
     """
 
+    use_native = False
+
     def __init__(self, blocks=None):
         self.blocks = blocks if blocks is not None else []
 
@@ -175,6 +230,14 @@ class Tensor:
         out_idx_a = list(set(range(0, tsa.rank)) - set(idxa))
         out_idx_b = list(set(range(0, tsb.rank)) - set(idxb))
 
+        native = _native_backend(tsa, tsb)
+        if native is not None:
+            r = native.contract(_to_native(native, tsa), _to_native(native, tsb),
+                                idxa, idxb, fidxa, fidxb, out_trans)
+            if len(out_idx_a) + len(out_idx_b) == 0:
+                return 0.0 if r.n_blocks == 0 else r.blocks[0][1].item()
+            return _from_native(r)
+
         # tuple of mutable object cannot be used as key
         map_idx_b = {}
         for block in tsb.blocks:
@@ -239,6 +302,13 @@ class Tensor:
             r_blocks : dict(q_label_r -> numpy.ndarray)
                 The R matrix for each right-index quantum label.
         """
+        native = _native_backend(self) if mode == 'reduced' else None
+        if native is not None:
+            q, r = _to_native(native, self).left_canonicalize()
+            q_map = {tuple(qs): x for qs, x in q.blocks}
+            for b in self.blocks:
+                b.reduced = q_map[tuple(b.q_labels)]
+            return _mats_from_native(r)
         collected_rows = {}
         for block in self.blocks:
             q_label_r = block.q_labels[-1]
@@ -266,6 +336,13 @@ class Tensor:
             l_blocks : dict(q_label_l -> numpy.ndarray)
                 The L matrix for each left-index quantum label.
         """
+        native = _native_backend(self) if mode == 'reduced' else None
+        if native is not None:
+            q, l = _to_native(native, self).right_canonicalize()
+            q_map = {tuple(qs): x for qs, x in q.blocks}
+            for b in self.blocks:
+                b.reduced = q_map[tuple(b.q_labels)]
+            return _mats_from_native(l)
         collected_cols = {}
         for block in self.blocks:
             q_label_l = block.q_labels[0]
@@ -294,6 +371,13 @@ class Tensor:
             mats : dict(q_label_r -> numpy.ndarray)
                 The R matrix for each right-index quantum label.
         """
+        native = _native_backend(self) if len(mats) != 0 else None
+        if native is not None:
+            mt = Tensor(blocks=[SubTensor((q, q), m) for q, m in mats.items()])
+            if _native_backend(self, mt) is native:
+                self.blocks = _from_native(_to_native(native, self).left_multiply(
+                    _to_native(native, mt))).blocks
+                return
         blocks = []
         for block in self.blocks:
             q_label_r = block.q_labels[0]
@@ -312,6 +396,13 @@ class Tensor:
             mats : dict(q_label_l -> numpy.ndarray)
                 The L matrix for each left-index quantum label.
         """
+        native = _native_backend(self) if len(mats) != 0 else None
+        if native is not None:
+            mt = Tensor(blocks=[SubTensor((q, q), m) for q, m in mats.items()])
+            if _native_backend(self, mt) is native:
+                self.blocks = _from_native(_to_native(native, self).right_multiply(
+                    _to_native(native, mt))).blocks
+                return
         blocks = []
         for block in self.blocks:
             q_label_l = block.q_labels[-1]
@@ -378,6 +469,10 @@ class Tensor:
         Returns:
             compressed tensor, dict of right blocks, compression error
         """
+        native = _native_backend(self)
+        if native is not None:
+            l, r, error = _to_native(native, self).left_compress(k, cutoff)
+            return _from_native(l), _mats_from_native(r), error
         collected_rows = {}
         for block in self.blocks:
             q_label_r = block.q_labels[-1]
@@ -430,6 +525,11 @@ class Tensor:
         Returns:
             compressed tensor, dict of left blocks, compression error
         """
+        native = _native_backend(self)
+        if native is not None:
+            r, l, error = _to_native(native, self).right_compress(
+                k, cutoff, sv_on_l)
+            return _from_native(r), _mats_from_native(l), error
         collected_cols = {}
         for block in self.blocks:
             q_label_l = block.q_labels[0]
@@ -25,6 +25,17 @@ import numpy as np
 from .core import MPS, MPO, Tensor, SubTensor
 
 class TensorTools:
+    """
+    Attributes:
+        use_flat : bool
+            Class attribute. If True, MPS/MPO tensors are exchanged with block2
+            through the native ``FlatSparseTensor`` (one flat array per site
+            tensor) when it is available. Otherwise (default) the python
+            block-by-block translation is used.
+    """
+
+    use_flat = False
+
     @staticmethod
     def from_block2_fused(bspmat, l, r, lr, clr):
         """Translate block2 rank2 left-fused right-boundary SparseMatrix to pyblock2 rank2 tensor."""
@@ -137,6 +148,54 @@ class TensorTools:
             assert ipl == pmat.shape[0]
         return Tensor(blocks=blocks)
 
+    @staticmethod
+    def from_flat(fts, drop_left=False, drop_right=False):
+        """
+        Translate block2 FlatSparseTensor to pyblock2 tensor.
+        Blocks are views of the flat data array (no copy).
+        The first/last index (of dim 1) is removed if drop_left/drop_right.
+        """
+        data, shapes, offsets = fts.data, fts.shapes, fts.offsets
+        sl = slice(1 if drop_left else 0, fts.rank - 1 if drop_right else fts.rank)
+        blocks = []
+        for q, sh, i, j in zip(fts.q_labels, shapes, offsets[:-1], offsets[1:]):
+            rmat = data[i:j].reshape(tuple(sh[sl]))
+            blocks.append(SubTensor(q_labels=q[sl], reduced=rmat))
+        return Tensor(blocks=blocks)
+
+    @staticmethod
+    def to_flat(fcls, tensor, left_q=None, right_q=None):
+        """
+        Translate pyblock2 tensor to block2 FlatSparseTensor (class fcls).
+        An index of dim 1 with label left_q/right_q is added if not None.
+        """
+        q_labels, shapes = [], []
+        for block in tensor.blocks:
+            q, sh = tuple(block.q_labels), block.reduced.shape
+            if left_q is not None:
+                q, sh = (left_q,) + q, (1,) + sh
+            if right_q is not None:
+                q, sh = q + (right_q,), sh + (1,)
+            q_labels.append(q)
+            shapes.append(sh)
+        rank = tensor.blocks[0].rank + (left_q is not None) + (right_q is not None)
+        data = np.concatenate([block.reduced.ravel() for block in tensor.blocks])
+        return fcls(rank, q_labels, np.array(shapes).reshape(-1, rank), data)
+
+
+def _flat_class(bobj):
+    """Native FlatSparseTensor class for a block2 MPS/MPO object, or None."""
+    if not TensorTools.use_flat:
+        return None
+    try:
+        import block2
+    except ImportError:
+        return None
+    sub = block2
+    for x in type(bobj).__module__.split(".")[1:]:
+        sub = getattr(sub, x, None)
+    return getattr(sub, "FlatSparseTensor", None)
+
 
 def init_block2_types(Q, DT):
     import block2 as b
@@ -169,9 +228,39 @@ def init_block2_types(Q, DT):
 
 
 class MPSTools:
+    @staticmethod
+    def _has_flat_forms(bmps):
+        """Whether all site tensors of block2 MPS can be exported one by one."""
+        if bmps.__class__.__name__ == "MultiMPS" or _flat_class(bmps) is None:
+            return False
+        n = bmps.n_sites
+        return all(
+            bmps.tensors[i] is not None
+            and (c in "LKRS" or (c == "C" and (i == 0 or i == n - 1)))
+            for i, c in enumerate(bmps.canonical_form)
+        )
+
+    @staticmethod
+    def iter_from_block2(bmps):
+        """
+        Translate block2 MPS to pyblock2 MPS tensors, site by site.
+        Only one site tensor is loaded from disk at a time, so that large
+        MPS can be streamed without holding all block2 tensors in memory.
+        """
+        if not MPSTools._has_flat_forms(bmps):
+            for ts in MPSTools.from_block2(bmps).tensors:
+                yield ts
+            return
+        fcls, n = _flat_class(bmps), bmps.n_sites
+        for i in range(n):
+            fts = fcls.from_mps_tensor(i, bmps)
+            yield TensorTools.from_flat(fts, drop_left=i == 0, drop_right=i == n - 1)
+
     @staticmethod
     def from_block2(bmps):
         """Translate block2 MPS to pyblock2 MPS."""
+        if MPSTools._has_flat_forms(bmps):
+            return MPS(tensors=list(MPSTools.iter_from_block2(bmps)))
         tensors = [None] * bmps.n_sites
         for i in range(0, bmps.n_sites):
             if bmps.tensors[i] is None:
@@ -376,29 +465,41 @@ class MPSTools:
         info.bond_dim = info.get_max_bond_dimension()
         info.save_mutable()
         info.save_data("%s/%s-mps_info.bin" % (save_dir, tag))
-        tensors = [bs.SparseTensor() for _ in range(n_sites)]
-        for i, bb in enumerate(basis):
-            tensors[i].data = bs.VectorVectorPSSTensor(
-                [bs.VectorPSSTensor() for _ in range(bb.n)]
-            )
-            for block in mps[i].blocks:
-                if i == 0:
-                    ql = left_vacuum
-                    qm, qr = block.q_labels
-                    blk = block.reduced.reshape((1, *block.reduced.shape))
-                elif i == n_sites - 1:
-                    ql, qm = block.q_labels
-                    qr = target
-                    blk = block.reduced.reshape((*block.reduced.shape, 1))
-                else:
-                    ql, qm, qr = block.q_labels
-                    blk = block.reduced
-                im = bb.find_state(qm)
-                assert im != -1
-                tensors[i].data[im].append(
-                    ((ql, qr), bx.Tensor(b.VectorMKLInt(blk.shape)))
+        fcls = getattr(bs, "FlatSparseTensor", None) if TensorTools.use_flat else None
+        if fcls is not None:
+            tensors = [None] * n_sites
+            for i, bb in enumerate(basis):
+                fts = TensorTools.to_flat(
+                    fcls,
+                    mps[i],
+                    left_q=left_vacuum if i == 0 else None,
+                    right_q=target if i == n_sites - 1 else None,
+                )
+                tensors[i] = fts.to_sparse_tensor(bb)
+        else:
+            tensors = [bs.SparseTensor() for _ in range(n_sites)]
+            for i, bb in enumerate(basis):
+                tensors[i].data = bs.VectorVectorPSSTensor(
+                    [bs.VectorPSSTensor() for _ in range(bb.n)]
                 )
-                np.array(tensors[i].data[im][-1][1], copy=False)[:] = blk
+                for block in mps[i].blocks:
+                    if i == 0:
+                        ql = left_vacuum
+                        qm, qr = block.q_labels
+                        blk = block.reduced.reshape((1, *block.reduced.shape))
+                    elif i == n_sites - 1:
+                        ql, qm = block.q_labels
+                        qr = target
+                        blk = block.reduced.reshape((*block.reduced.shape, 1))
+                    else:
+                        ql, qm, qr = block.q_labels
+                        blk = block.reduced
+                    im = bb.find_state(qm)
+                    assert im != -1
+                    tensors[i].data[im].append(
+                        ((ql, qr), bx.Tensor(b.VectorMKLInt(blk.shape)))
+                    )
+                    np.array(tensors[i].data[im][-1][1], copy=False)[:] = blk
 
         umps = bs.UnfusedMPS()
         umps.info = info
@@ -678,7 +779,9 @@ class MPSTools:
             n_sites = len(tensors)
             f.write(struct.pack('i', n_sites))
             for ii in range(n_sites):
-                tensor = tensors[ii].__class__(blocks=[x.copy() for x in tensors[ii].blocks])
+                # blocks are re-assigned below, never modified in place
+                tensor = tensors[ii].__class__(blocks=[
+                    SubTensor(q_labels=x.q_labels, reduced=x.reduced) for x in tensors[ii].blocks])
                 for block in tensor.blocks:
                     if is_se:
                         block.q_labels, block.reduced = block.q_labels[::-1], block.reduced.T
@@ -776,6 +879,13 @@ class MPOTools:
 
         if bmpo.__class__.__name__ == "MPOQC":
             assert bmpo.mode == QCTypes.NC or bmpo.mode == QCTypes.CN
+        fcls = _flat_class(bmpo)
+        if fcls is not None:
+            tensors = [
+                TensorTools.from_flat(fcls.from_mpo_tensor(i, bmpo))
+                for i in range(bmpo.n_sites)
+            ]
+            return MPO(tensors=tensors, const_e=bmpo.const_e)
         tensors = [None] * bmpo.n_sites
         # translate operator name symbols to quantum labels
         idx_mps, idx_qss, idx_imps = [], [], []
@@ -90,6 +90,7 @@ for eq in [
     fix_eri_permutations(eq)
 
 from pyscf.cc import eom_gccsd
+from pyblock2.cc.native import wick_exec, GCC_PACKED
 
 
 def wick_eomccsd_diag(eom, eq_type, imds=None):
@@ -100,18 +101,20 @@ def wick_eomccsd_diag(eom, eq_type, imds=None):
     if eq_type == "ee":
         hr1 = np.zeros((nocc, nvir), dtype=t1.dtype)
         hr2 = np.zeros((nocc, nocc, nvir, nvir), dtype=t2.dtype)
-        eom_eq = gr_eomee_diag_eq.to_einsum()
+        eom_gr = gr_eomee_diag_eq
     elif eq_type == "ip":
         hr1 = np.zeros((nocc,), dtype=t1.dtype)
         hr2 = np.zeros((nocc, nocc, nvir), dtype=t2.dtype)
-        eom_eq = gr_eomip_diag_eq.to_einsum()
+        eom_gr = gr_eomip_diag_eq
     elif eq_type == "ea":
         hr1 = np.zeros((nvir,), dtype=t1.dtype)
         hr2 = np.zeros((nocc, nvir, nvir), dtype=t2.dtype)
-        eom_eq = gr_eomea_diag_eq.to_einsum()
-    exec(
-        eom_eq,
-        globals(),
+        eom_gr = gr_eomea_diag_eq
+    # the diagonal is not antisymmetric, so hr2 is kept dense
+    packed = GCC_PACKED
+    wick_exec(
+        eom._cc,
+        eom_gr,
         {
             "hIE": eris.fock[:nocc, nocc:],
             "hEI": eris.fock[nocc:, :nocc],
@@ -132,6 +135,7 @@ def wick_eomccsd_diag(eom, eq_type, imds=None):
             "deltaEE": np.eye(nvir),
             **{"ident%d" % d: np.ones((1,) * d) for d in [1, 2, 3]},
         },
+        packed,
     )
     return eom.amplitudes_to_vector(hr1, hr2)
 
@@ -145,23 +149,27 @@ def wick_eomccsd_matvec(eom, eq_type, vector, imds=None, diag=None):
     hr1 = np.zeros_like(r1)
     hr2 = np.zeros_like(r2)
     if eq_type == "ee":
-        eom_eq = gr_eomee_eq.to_einsum()
+        eom_gr = gr_eomee_eq
         r_amps = {"rIE": r1, "rIIEE": r2}
     elif eq_type == "ip":
-        eom_eq = gr_eomip_eq.to_einsum()
+        eom_gr = gr_eomip_eq
         r_amps = {"rI": r1, "rIIE": r2}
     elif eq_type == "lip":
-        eom_eq = gr_eomip_left_eq.to_einsum()
+        eom_gr = gr_eomip_left_eq
         r_amps = {"rI": r1, "rIIE": r2}
     elif eq_type == "ea":
-        eom_eq = gr_eomea_eq.to_einsum()
+        eom_gr = gr_eomea_eq
         r_amps = {"rE": r1, "rIEE": r2}
     elif eq_type == "lea":
-        eom_eq = gr_eomea_left_eq.to_einsum()
+        eom_gr = gr_eomea_left_eq
         r_amps = {"rE": r1, "rIEE": r2}
-    exec(
-        eom_eq,
-        globals(),
+    # r2 and hr2 are antisymmetric in the occupied and virtual indices
+    r2_key = [k for k in r_amps if len(k) > 2][0]
+    groups = {"rIIEE": [2, 2], "rIIE": [2, 1], "rIEE": [1, 2]}[r2_key]
+    packed = {**GCC_PACKED, r2_key: groups, "hr2": groups}
+    wick_exec(
+        eom._cc,
+        eom_gr,
         {
             "hIE": eris.fock[:nocc, nocc:],
             "hEI": eris.fock[nocc:, :nocc],
@@ -180,6 +188,7 @@ def wick_eomccsd_matvec(eom, eq_type, vector, imds=None, diag=None):
             "hr2": hr2,
             **r_amps,
         },
+        packed,
     )
     return eom.amplitudes_to_vector(hr1, hr2)
 
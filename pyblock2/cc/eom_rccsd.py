@@ -144,6 +144,7 @@ for eq in [
     fix_eri_permutations(eq)
 
 from pyscf.cc import eom_rccsd
+from pyblock2.cc.native import wick_exec
 
 
 def wick_eomccsd_diag(eom, eq_type, imds=None):
@@ -154,18 +155,18 @@ def wick_eomccsd_diag(eom, eq_type, imds=None):
     if eq_type == "ee":
         hr1 = np.zeros((nocc, nvir), dtype=t1.dtype)
         hr2 = np.zeros((nocc, nocc, nvir, nvir), dtype=t2.dtype)
-        eom_eq = gr_eomee_diag_eq.to_einsum()
+        eom_gr = gr_eomee_diag_eq
     elif eq_type == "ip":
         hr1 = np.zeros((nocc,), dtype=t1.dtype)
         hr2 = np.zeros((nocc, nocc, nvir), dtype=t2.dtype)
-        eom_eq = gr_eomip_diag_eq.to_einsum()
+        eom_gr = gr_eomip_diag_eq
     elif eq_type == "ea":
         hr1 = np.zeros((nvir,), dtype=t1.dtype)
         hr2 = np.zeros((nocc, nvir, nvir), dtype=t2.dtype)
-        eom_eq = gr_eomea_diag_eq.to_einsum()
-    exec(
-        eom_eq,
-        globals(),
+        eom_gr = gr_eomea_diag_eq
+    wick_exec(
+        eom._cc,
+        eom_gr,
         {
             "fIE": eris.fock[:nocc, nocc:],
             "fEI": eris.fock[nocc:, :nocc],
@@ -202,26 +203,26 @@ def wick_eomccsd_matvec(eom, eq_type, vector, imds=None, diag=None):
     hr1 = np.zeros_like(r1)
     hr2 = np.zeros_like(r2)
     if eq_type == "ee":
-        eom_eq = gr_eomee_eq.to_einsum()
+        eom_gr = gr_eomee_eq
         r_amps = {"rIE": r1, "rIIEE": r2}
     elif eq_type == "lee":
-        eom_eq = gr_eomee_left_eq.to_einsum()
+        eom_gr = gr_eomee_left_eq
         r_amps = {"rIE": r1, "rIIEE": r2}
     elif eq_type == "ip":
-        eom_eq = gr_eomip_eq.to_einsum()
+        eom_gr = gr_eomip_eq
         r_amps = {"rI": r1, "rIIE": r2}
     elif eq_type == "lip":
-        eom_eq = gr_eomip_left_eq.to_einsum()
+        eom_gr = gr_eomip_left_eq
         r_amps = {"rI": r1, "rIIE": r2}
     elif eq_type == "ea":
-        eom_eq = gr_eomea_eq.to_einsum()
+        eom_gr = gr_eomea_eq
         r_amps = {"rE": r1, "rIEE": r2}
     elif eq_type == "lea":
-        eom_eq = gr_eomea_left_eq.to_einsum()
+        eom_gr = gr_eomea_left_eq
         r_amps = {"rE": r1, "rIEE": r2}
-    exec(
-        eom_eq,
-        globals(),
+    wick_exec(
+        eom._cc,
+        eom_gr,
         {
             "fIE": eris.fock[:nocc, nocc:],
             "fEI": eris.fock[nocc:, :nocc],
@@ -124,19 +124,20 @@ fix_eri_permutations(gr_pt3_eq)
 fix_eri_permutations(gr_pt3_en_eq)
 
 from pyscf.cc import gccsd
+from pyblock2.cc.native import wick_exec, GCC_PACKED
 
 def wick_energy(cc, t1, t2, eris):
     assert isinstance(eris, gccsd._PhysicistsERIs)
     assert cc.level_shift == 0
     nocc = t1.shape[0]
     E = np.array(0.0)
-    exec(gr_en_eq.to_einsum(), globals(), {
+    wick_exec(cc, gr_en_eq, {
         "hIE": eris.fock[:nocc, nocc:],
         "vIIEE": np.array(eris.oovv),
         "tIE": t1,
         "tIIEE": t2,
         "E": E
-    })
+    }, GCC_PACKED)
     return E
 
 def wick_update_amps(cc, t1, t2, eris):
@@ -145,7 +146,7 @@ def wick_update_amps(cc, t1, t2, eris):
     nocc = t1.shape[0]
     t1new = np.zeros_like(t1)
     t2new = np.zeros_like(t2)
-    exec(gr_amps_eq.to_einsum(), globals(), {
+    wick_exec(cc, gr_amps_eq, {
         "hIE": eris.fock[:nocc, nocc:],
         "hEI": eris.fock[nocc:, :nocc],
         "hEE": eris.fock[nocc:, nocc:],
@@ -161,7 +162,7 @@ def wick_update_amps(cc, t1, t2, eris):
         "tIIEE": t2,
         "t1new": t1new,
         "t2new": t2new
-    })
+    }, GCC_PACKED)
     fii, faa = np.diag(eris.fock)[:nocc], np.diag(eris.fock)[nocc:]
     eia = fii[:, None] - faa[None, :]
     eijab = eia[:, None, :, None] + eia[None, :, None, :]
@@ -176,7 +177,7 @@ def wick_t3_amps(cc, t1=None, t2=None, eris=None):
     assert isinstance(eris, gccsd._PhysicistsERIs)
     nocc, nvir = t1.shape
     t3 = np.zeros((nocc, ) * 3 + (nvir, ) * 3)
-    exec(gr_pt3_eq.to_einsum(), globals(), {
+    wick_exec(cc, gr_pt3_eq, {
         "vIIII": np.array(eris.oooo),
         "vIIIE": np.array(eris.ooov),
         "vIIEE": np.array(eris.oovv),
@@ -186,7 +187,7 @@ def wick_t3_amps(cc, t1=None, t2=None, eris=None):
         "vEEEE": np.array(eris.vvvv),
         "tIIEE": t2,
         "t3": t3,
-    })
+    }, GCC_PACKED)
     fii, faa = np.diag(eris.fock)[:nocc], np.diag(eris.fock)[nocc:]
     eia = fii[:, None] - faa[None, :]
     eiiaa = eia[:, None, :, None] + eia[None, :, None, :]
@@ -205,7 +206,7 @@ def wick_ccsd_t(cc, t1=None, t2=None, eris=None, t3=None):
     if t3 is None:
         t3 = wick_t3_amps(cc, t1=t1, t2=t2, eris=eris)
     e_t = np.array(0.0)
-    exec(gr_pt3_en_eq.to_einsum(), globals(), {
+    wick_exec(cc, gr_pt3_en_eq, {
         "hIE": eris.fock[:nocc, nocc:],
         "vIIEE": np.array(eris.oovv),
         "vIIIE": np.array(eris.ooov),
@@ -214,12 +215,15 @@ def wick_ccsd_t(cc, t1=None, t2=None, eris=None, t3=None):
         "tIIEE": t2,
         "tIIIEEE": t3,
         "E": e_t
-    })
+    }, GCC_PACKED)
     return e_t
 
 class WickGCCSD(gccsd.GCCSD):
-    def __init__(self, mf, **kwargs):
+    def __init__(self, mf, native_exec=False, **kwargs):
         gccsd.GCCSD.__init__(self, mf, **kwargs)
+        # evaluate the equations with the C++ WickGraphExecutor
+        # (antisymmetric amplitudes and integrals are stored packed)
+        self.native_exec = native_exec
     energy = wick_energy
     update_amps = wick_update_amps
     ccsd_t = wick_ccsd_t
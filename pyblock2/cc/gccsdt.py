@@ -24,11 +24,12 @@ need internal contraction module of block2.
 try:
     from block2 import WickIndexTypes, WickIndex, WickExpr, WickTensor, WickPermutation
     from block2 import MapWickIndexTypesSet, MapPStrIntVectorWickPermutation
-    from block2 import WickGraph
+    from block2 import WickGraph, WickPackedTensor
 except ImportError:
     raise RuntimeError("block2 needs to be compiled with '-DUSE_IC=ON'!")
 
 import itertools
+import math
 import numpy as np
 
 
@@ -117,7 +118,7 @@ def get_cc_amps_eqs(order):
         t1_eq = t1_eq + P("h[ii]\n - h[aa]") * P("t[ia]")
         fix_eri_permutations(t1_eq)
         # eqs.append(t1_eq.to_einsum(PT("t1new[ia]")))
-        eqs.append(WickGraph().add_term(PT("t1new[ia]"), t1_eq).simplify().to_einsum())
+        eqs.append(WickGraph().add_term(PT("t1new[ia]"), t1_eq).simplify())
         print("%8.3f sec" % (time.perf_counter() - tt))
     if order >= 2:
         print("2...", end="", flush=True)
@@ -126,7 +127,7 @@ def get_cc_amps_eqs(order):
         t2_eq = t2_eq + P("h[ii]\n + h[jj]\n - h[aa]\n - h[bb]") * P("t[ijab]")
         fix_eri_permutations(t2_eq)
         # eqs.append(t2_eq.to_einsum(PT("t2new[ijab]")))
-        eqs.append(WickGraph().add_term(PT("t2new[ijab]"), t2_eq).simplify().to_einsum())
+        eqs.append(WickGraph().add_term(PT("t2new[ijab]"), t2_eq).simplify())
         print("%8.3f sec" % (time.perf_counter() - tt))
     if order >= 3:
         print("3...", end="", flush=True)
@@ -137,7 +138,7 @@ def get_cc_amps_eqs(order):
         ) * P("t[ijkabc]")
         fix_eri_permutations(t3_eq)
         # eqs.append(t3_eq.to_einsum(PT("t3new[ijkabc]")))
-        eqs.append(WickGraph().add_term(PT("t3new[ijkabc]"), t3_eq).simplify().to_einsum())
+        eqs.append(WickGraph().add_term(PT("t3new[ijkabc]"), t3_eq).simplify())
         print("%8.3f sec" % (time.perf_counter() - tt))
     # if order >= 4:
     #     print('4...', end='', flush=True)
@@ -154,6 +155,27 @@ def get_cc_amps_eqs(order):
 eqs = [None] * 6
 
 from pyscf.cc import gccsd
+from pyblock2.cc.native import wick_exec, GCC_PACKED
+from pyblock2.cc.native import pack_tensors, packed_denominator
+
+
+# in the native path, t2, t3, ... are kept as WickPackedTensor between
+# iterations, with groups [k, k] for the order k amplitudes
+def is_packed(t):
+    return not isinstance(t, np.ndarray)
+
+
+def amp_data(t):
+    # numpy view of the (packed) amplitudes
+    return np.asarray(t.data) if is_packed(t) else t
+
+
+def packed_eris(cc, eris):
+    # the integrals stored packed are only packed once for each eris
+    if getattr(cc, "_packed_eris", (None,))[0] is not eris:
+        tensors = {"vIIII": np.array(eris.oooo), "vEEEE": np.array(eris.vvvv)}
+        cc._packed_eris = (eris, pack_tensors(tensors, GCC_PACKED))
+    return cc._packed_eris[1]
 
 
 def wick_energy(cc, tamps, eris):
@@ -164,10 +186,11 @@ def wick_energy(cc, tamps, eris):
     tdics = {}
     for it, t in enumerate(tamps):
         tdics["t" + "I" * (it + 1) + "E" * (it + 1)] = t
-    exec(
-        gr_en_eq.to_einsum(),
-        globals(),
+    wick_exec(
+        cc,
+        gr_en_eq,
         {"hIE": eris.fock[:nocc, nocc:], "vIIEE": np.array(eris.oovv), **tdics, "E": E},
+        GCC_PACKED,
     )
     return E
 
@@ -179,37 +202,44 @@ def wick_update_amps(cc, tamps, eris):
     tamps_new = [None] * len(tamps)
     tdics = {}
     for it, t in enumerate(tamps):
-        tamps_new[it] = np.zeros_like(t)
+        if is_packed(t):
+            tamps_new[it] = WickPackedTensor(t.shape, t.groups)
+        else:
+            tamps_new[it] = np.zeros_like(t)
         tdics["t" + "I" * (it + 1) + "E" * (it + 1)] = t
         tdics["t%dnew" % (it + 1)] = tamps_new[it]
     if eqs[cc.order] is None:
         eqs[cc.order] = get_cc_amps_eqs(cc.order)
-    amps_eq = "".join(eqs[cc.order])
-    exec(
-        amps_eq,
-        globals(),
-        {
-            "hIE": eris.fock[:nocc, nocc:],
-            "hEI": eris.fock[nocc:, :nocc],
-            "hEE": eris.fock[nocc:, nocc:],
-            "hII": eris.fock[:nocc, :nocc],
-            "vIIII": np.array(eris.oooo),
-            "vIIIE": np.array(eris.ooov),
-            "vIIEE": np.array(eris.oovv),
-            "vIEEI": np.array(eris.ovvo),
-            "vIEIE": np.array(eris.ovov),
-            "vIEEE": np.array(eris.ovvv),
-            "vEEEE": np.array(eris.vvvv),
-            **tdics,
-        },
-    )
+    tensors = {
+        "hIE": eris.fock[:nocc, nocc:],
+        "hEI": eris.fock[nocc:, :nocc],
+        "hEE": eris.fock[nocc:, nocc:],
+        "hII": eris.fock[:nocc, :nocc],
+        "vIIIE": np.array(eris.ooov),
+        "vIIEE": np.array(eris.oovv),
+        "vIEEI": np.array(eris.ovvo),
+        "vIEIE": np.array(eris.ovov),
+        "vIEEE": np.array(eris.ovvv),
+        **tdics,
+    }
+    if getattr(cc, "native_exec", False):
+        tensors.update(packed_eris(cc, eris))
+    else:
+        tensors["vIIII"] = np.array(eris.oooo)
+        tensors["vEEEE"] = np.array(eris.vvvv)
+    for gr in eqs[cc.order]:
+        wick_exec(cc, gr, tensors, GCC_PACKED)
     fii, faa = np.diag(eris.fock)[:nocc], np.diag(eris.fock)[nocc:]
     eia = fii[:, None] - faa[None, :]
     tamps_new[0] /= eia
-    if cc.order >= 2:
+    for it, t in enumerate(tamps_new[1:]):
+        if is_packed(t):
+            amp_data(t)[:] /= packed_denominator(fii, faa, it + 2)
+    if cc.order >= 2 and not is_packed(tamps_new[1]):
         eiiaa = eia[:, None, :, None] + eia[None, :, None, :]
         tamps_new[1] /= eiiaa
-    if cc.order >= 3:
+    if cc.order >= 3 and not is_packed(tamps_new[2]):
+        eiiaa = eia[:, None, :, None] + eia[None, :, None, :]
         eiiiaaa = eiiaa[:, :, None, :, :, None] + eia[None, None, :, None, None, :]
         tamps_new[2] /= eiiiaaa
     # if cc.order >= 4:
@@ -234,31 +264,42 @@ def wick_update_amps(cc, tamps, eris):
 
 
 def wick_amplitudes_to_vector(tamps, out=None):
+    # packed amplitudes of order k are scaled by k!, so that norms and
+    # inner products (DIIS) are the same as those of the dense amplitudes
     nocc, nvir = tamps[0].shape
     nov = nocc * nvir
     size = 0
-    for it, _ in enumerate(tamps):
-        size += nov ** (it + 1)
+    for it, t in enumerate(tamps):
+        size += t.size if is_packed(t) else nov ** (it + 1)
     vector = np.ndarray(size, tamps[0].dtype, buffer=out)
     size = 0
     for it, t in enumerate(tamps):
-        vector[size : size + nov ** (it + 1)] = t.ravel()
-        size += nov ** (it + 1)
+        if is_packed(t):
+            vector[size : size + t.size] = amp_data(t) * math.factorial(it + 1)
+            size += t.size
+        else:
+            vector[size : size + nov ** (it + 1)] = t.ravel()
+            size += nov ** (it + 1)
     return vector
 
 
-def wick_vector_to_amplitudes(vector, nmo, nocc):
+def wick_vector_to_amplitudes(vector, nmo, nocc, packed=False):
     nvir = nmo - nocc
     nov = nocc * nvir
     size = 0
     tamps = []
     it = 0
     while size < vector.size:
-        t = vector[size : size + nov ** (it + 1)].reshape(
-            (*([nocc] * (it + 1)), *([nvir] * (it + 1)))
-        )
-        tamps.append(t)
-        size += nov ** (it + 1)
+        shape = (*([nocc] * (it + 1)), *([nvir] * (it + 1)))
+        if packed and it != 0:
+            t = WickPackedTensor(list(shape), [it + 1, it + 1])
+            amp_data(t)[:] = vector[size : size + t.size] / math.factorial(it + 1)
+            tamps.append(t)
+            size += t.size
+        else:
+            t = vector[size : size + nov ** (it + 1)].reshape(shape)
+            tamps.append(t)
+            size += nov ** (it + 1)
         it += 1
     return tamps
 
@@ -294,9 +335,13 @@ def wick_init_amps(mycc, eris=None):
     logger.info(mycc, "Init t2, MP2 energy = %.15g", mycc.emp2)
     tamps = [t1, t2]
     for it in range(3, mycc.order + 1):
-        tamps.append(
-            np.zeros((*([t1.shape[0]] * it), *([t1.shape[1]] * it)), dtype=t1.dtype)
-        )
+        shape = (*([t1.shape[0]] * it), *([t1.shape[1]] * it))
+        if getattr(mycc, "native_exec", False):
+            tamps.append(WickPackedTensor(list(shape), [it, it]))
+        else:
+            tamps.append(np.zeros(shape, dtype=t1.dtype))
+    if getattr(mycc, "native_exec", False) and len(tamps) >= 2:
+        tamps[1] = pack_tensors({"t": t2}, {"t": [2, 2]})["t"]
     return mycc.emp2, tamps[: mycc.order]
 
 
@@ -345,8 +390,8 @@ def wick_kernel(
         if mycc.iterative_damping < 1.0:
             alpha = mycc.iterative_damping
             for tx, tx_new in zip(tamps, tamps_new):
-                tx_new *= alpha
-                tx_new += (1 - alpha) * tx
+                amp_data(tx_new)[:] *= alpha
+                amp_data(tx_new)[:] += (1 - alpha) * amp_data(tx)
         tamps = tamps_new
         tamps_new = None
         tamps = mycc.run_diis(tamps, istep, normt, ecc - eold, adiis)
@@ -368,9 +413,12 @@ def wick_kernel(
 
 
 class WickGCC(gccsd.GCCSD):
-    def __init__(self, mf, order=3, **kwargs):
+    def __init__(self, mf, order=3, native_exec=False, **kwargs):
         self.order = order
         gccsd.GCCSD.__init__(self, mf, **kwargs)
+        # evaluate the equations with the C++ WickGraphExecutor,
+        # with t2, t3, ... kept as WickPackedTensor in self.tamps
+        self.native_exec = native_exec
         self.e_hf = mf.e_tot
 
     energy = wick_energy
@@ -386,7 +434,7 @@ class WickGCC(gccsd.GCCSD):
             nocc = self.nocc
         if nmo is None:
             nmo = self.nmo
-        return wick_vector_to_amplitudes(vec, nmo, nocc)
+        return wick_vector_to_amplitudes(vec, nmo, nocc, self.native_exec)
 
     def get_init_guess(self, eris=None):
         return self.init_amps(eris)[1]
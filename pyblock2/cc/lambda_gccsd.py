@@ -44,6 +44,7 @@ gr_lambda_eq = WickGraph().add_term(PT("l1new[ia]"), l1_eq).add_term(PT("l2new[i
 fix_eri_permutations(gr_lambda_eq)
 
 from pyscf.cc import gccsd, ccsd_lambda
+from pyblock2.cc.native import wick_exec, GCC_PACKED
 from pyscf.lib import logger
 
 def wick_update_lambda(cc, t1, t2, l1, l2, eris, imds):
@@ -52,7 +53,7 @@ def wick_update_lambda(cc, t1, t2, l1, l2, eris, imds):
     nocc = t1.shape[0]
     l1new = np.zeros_like(l1)
     l2new = np.zeros_like(l2)
-    exec(gr_lambda_eq.to_einsum(), globals(), {
+    wick_exec(cc, gr_lambda_eq, {
         "hIE": eris.fock[:nocc, nocc:],
         "hEI": eris.fock[nocc:, :nocc],
         "hEE": eris.fock[nocc:, nocc:],
@@ -70,7 +71,7 @@ def wick_update_lambda(cc, t1, t2, l1, l2, eris, imds):
         "lIIEE": l2,
         "l1new": l1new,
         "l2new": l2new
-    })
+    }, GCC_PACKED)
     fii, faa = np.diag(eris.fock)[:nocc], np.diag(eris.fock)[nocc:]
     eia = fii[:, None] - faa[None, :]
     eijab = eia[:, None, :, None] + eia[None, :, None, :]
@@ -49,6 +49,7 @@ gr_lambda_eq = WickGraph().add_term(PT("l1new[ia]"), l1_eq).add_term(PT("l2new[i
 fix_eri_permutations(gr_lambda_eq)
 
 from pyscf.cc import rccsd, ccsd_lambda
+from pyblock2.cc.native import wick_exec
 from pyscf.lib import logger
 
 def wick_update_lambda(cc, t1, t2, l1, l2, eris, imds):
@@ -57,7 +58,7 @@ def wick_update_lambda(cc, t1, t2, l1, l2, eris, imds):
     nocc = t1.shape[0]
     l1new = np.zeros_like(l1)
     l2new = np.zeros_like(l2)
-    exec(gr_lambda_eq.to_einsum(), globals(), {
+    wick_exec(cc, gr_lambda_eq, {
         "fIE": eris.fock[:nocc, nocc:],
         "fEI": eris.fock[nocc:, :nocc],
         "fEE": eris.fock[nocc:, nocc:],
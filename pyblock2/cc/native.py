@@ -0,0 +1,107 @@
+#  block2: Efficient MPO implementation of quantum chemistry DMRG
+#  Copyright (C) 2020-2021 Huanchen Zhai <hczhai@caltech.edu>
+#
+#  This program is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program. If not, see <https://www.gnu.org/licenses/>.
+#
+#
+
+"""
+Evaluation of WickGraph equations either as generated numpy code
+or with the C++ WickGraphExecutor.
+"""
+
+import numpy as np
+
+# sizes of the antisymmetric index groups of the spin-orbital
+# tensors that can be stored packed (i < j, a < b, ...)
+GCC_PACKED = {
+    "vIIII": [2, 2],
+    "vEEEE": [2, 2],
+    "tIIEE": [2, 2],
+    "t2new": [2, 2],
+    "tIIIEEE": [3, 3],
+    "t3": [3, 3],
+    "t3new": [3, 3],
+    "lIIEE": [2, 2],
+    "l2new": [2, 2],
+}
+
+
+# compiled numpy code of each graph, keeping the graph alive
+# so that its id is not reused
+_einsum_code = {}
+
+
+def wick_exec(cc, gr, tensors, packed=None):
+    """
+    Evaluate the equations in gr. Output arrays in tensors are updated in place.
+
+    Args:
+        cc : object
+            If cc.native_exec is True, the C++ WickGraphExecutor is used.
+            Otherwise the numpy code from gr.to_einsum() is executed.
+        gr : WickGraph
+            The equations.
+        tensors : dict(str, np.ndarray or WickPackedTensor)
+            Inputs (named as in to_einsum, e.g. "vIIEE") and outputs.
+            WickPackedTensor values (native executor only) are used
+            without packing and updated in place.
+        packed : None or dict(str, list(int))
+            Tensors stored packed by the native executor and the sizes of
+            their antisymmetric index groups. Ignored by the numpy code.
+    """
+    if not getattr(cc, "native_exec", False):
+        if id(gr) not in _einsum_code:
+            code = compile(gr.to_einsum(), "<WickGraph>", "exec")
+            _einsum_code[id(gr)] = (gr, code)
+        exec(_einsum_code[id(gr)][1], globals(), tensors)
+        return
+    from block2 import WickGraphExecutor, WickPackedTensor, NDArray
+
+    packed = {} if packed is None else packed
+    ex = WickGraphExecutor(gr)
+    for k, v in tensors.items():
+        if isinstance(v, WickPackedTensor):
+            ex.packed[k] = v
+        elif k in packed:
+            ex.packed[k] = WickPackedTensor.pack(NDArray(v), packed[k])
+        else:
+            ex.dense[k] = NDArray(v, copy=False)
+    ex.iprint = 1 if getattr(cc, "verbose", 0) >= 5 else 0
+    ex.execute()
+    for wt in gr.left:
+        if wt.name in packed and isinstance(tensors.get(wt.name), np.ndarray):
+            tensors[wt.name][...] = np.asarray(ex.packed[wt.name].unpack())
+
+
+def pack_tensors(tensors, packed):
+    """Pack the arrays in tensors listed in packed, for use in several calls."""
+    from block2 import WickPackedTensor, NDArray
+
+    return {
+        k: WickPackedTensor.pack(NDArray(v), packed[k]) if k in packed else v
+        for k, v in tensors.items()
+    }
+
+
+def packed_denominator(eo, ev, k):
+    """
+    Orbital energy denominators e_i + e_j + ... - e_a - e_b - ... in the
+    layout of WickPackedTensor with groups [k, k] (i < j < ..., a < b < ...).
+    """
+    import itertools
+
+    xo = [eo[list(x)].sum() for x in itertools.combinations(range(len(eo)), k)]
+    xv = [ev[list(x)].sum() for x in itertools.combinations(range(len(ev)), k)]
+    return (np.array(xo)[:, None] - np.array(xv)[None, :]).ravel()
@@ -159,13 +159,14 @@ fix_eri_permutations(gr_pt3_eq)
 fix_eri_permutations(gr_pt3_en_eq)
 
 from pyscf.cc import rccsd
+from pyblock2.cc.native import wick_exec
 
 def wick_energy(cc, t1, t2, eris):
     assert isinstance(eris, rccsd._ChemistsERIs)
     assert cc.level_shift == 0
     nocc = t1.shape[0]
     E = np.array(0.0)
-    exec(gr_en_eq.to_einsum(), globals(), {
+    wick_exec(cc, gr_en_eq, {
         "fIE": eris.fock[:nocc, nocc:],
         "vIEIE": np.array(eris.ovov),
         "tIE": t1,
@@ -180,7 +181,7 @@ def wick_update_amps(cc, t1, t2, eris):
     nocc = t1.shape[0]
     t1new = np.zeros_like(t1)
     t2new = np.zeros_like(t2)
-    exec(gr_amps_eq.to_einsum(), globals(), {
+    wick_exec(cc, gr_amps_eq, {
         "fIE": eris.fock[:nocc, nocc:],
         "fEI": eris.fock[nocc:, :nocc],
         "fEE": eris.fock[nocc:, nocc:],
@@ -213,7 +214,7 @@ def wick_t3_amps(cc, t1=None, t2=None, eris=None):
     nocc, nvir = t1.shape
 
     t3 = np.zeros((nocc, ) * 3 + (nvir, ) * 3)
-    exec(gr_pt3_eq.to_einsum(), globals(), {
+    wick_exec(cc, gr_pt3_eq, {
         "vIIII": np.array(eris.oooo),
         "vIEII": np.array(eris.ovoo),
         "vIIEE": np.array(eris.oovv),
@@ -241,7 +242,7 @@ def wick_ccsd_t(cc, t1=None, t2=None, eris=None, t3=None):
     if t3 is None:
         t3 = wick_t3_amps(cc, t1=t1, t2=t2, eris=eris)
     e_t = np.array(0.0)
-    exec(gr_pt3_en_eq.to_einsum(), globals(), {
+    wick_exec(cc, gr_pt3_en_eq, {
         "fIE": eris.fock[:nocc, nocc:],
         "vIIEE": np.array(eris.oovv),
         "vIEII": np.array(eris.ovoo),
@@ -255,8 +256,10 @@ def wick_ccsd_t(cc, t1=None, t2=None, eris=None, t3=None):
     return e_t
 
 class WickRCCSD(rccsd.RCCSD):
-    def __init__(self, mf, **kwargs):
+    def __init__(self, mf, native_exec=False, **kwargs):
         rccsd.RCCSD.__init__(self, mf, **kwargs)
+        # evaluate the equations with the C++ WickGraphExecutor
+        self.native_exec = native_exec
     energy = wick_energy
     update_amps = wick_update_amps
     ccsd_t = wick_ccsd_t
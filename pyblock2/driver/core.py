@@ -535,6 +535,12 @@ class Block2Wrapper:
             self.SX = self.SXT = b.SGB
             self.VectorSX = b.VectorSGB
             self.VectorVectorSX = b.VectorVectorSGB
+        # with -DSPLIT_PYMODULES=ON, only import the extension modules
+        # for the symmetry types used in this driver
+        if hasattr(b, "load_module"):
+            for bm in [self.bs, self.brs, self.bcs]:
+                if bm is not None:
+                    b.load_module(bm)
 
     def set_symmetry_groups(self, *args, hints=None):
         """
@@ -607,6 +613,7 @@ class DMRGDriver:
         seq_type=None,
         align_type=0,
         compressed_mps_storage=False,
+        env_container=False,
     ):
         """
         Initialize :class:`DMRGDriver`.
@@ -670,6 +677,11 @@ class DMRGDriver:
             compressed_mps_storage : bool
                 Whether block-sparse tensor should be stored in compressed form to save storage (mainly for MPS).
                 Default is False.
+            env_container : bool
+                Whether renormalized operators should be stored as records in one container file
+                per processor (instead of one file per site), to reduce the number of files in scratch.
+                When ``restart_dir`` is set, a snapshot of the container is also written there after each sweep.
+                Default is False.
         """
         if mpi is not None and mpi:
             self.mpi = True
@@ -689,6 +701,7 @@ class DMRGDriver:
         self.fp_codec_chunk = fp_codec_chunk
         self.min_mpo_mem = min_mpo_mem
         self.compressed_mps_storage = compressed_mps_storage
+        self.env_container = env_container
         self.symm_type = symm_type
         self.clean_scratch = clean_scratch
         bw = self.bw
@@ -831,6 +844,14 @@ class DMRGDriver:
                 bw.b.ParallelSimpleTypes.Nothing, self.mpi
             )
 
+        if self.env_container:
+            import os
+
+            rank = 0 if self.mpi is None else self.mpi.rank
+            self.frame.partition_container = bw.b.FileContainer(
+                os.path.join(self._scratch, "F%d.PART.bin" % rank), True
+            )
+
         if self.restart_dir is not None:
             import os
 
@@ -5654,6 +5675,7 @@ class DMRGDriver:
         iprint=0,
         max_bond_dim=None,
         fermionic_ops=None,
+        scheme_cache_dir=None,
     ):
         """
         Compute the N-Particle Density Matrix (NPDM) for the given MPS.
@@ -5722,6 +5744,11 @@ class DMRGDriver:
                 operators (for computing signs for swapping operators).
                 Default is None, and operators like "cdCD" will be treated as Fermion
                 operators.
+            scheme_cache_dir : None or str
+                If not None, the generated NPDM spin permutation schemes will be
+                stored in (or loaded from, if already generated) this directory.
+                This is useful for high order NPDMs, where generating the schemes
+                can be expensive. Default is None (no caching).
 
         Returns:
             dms : np.ndarray[flat|complex] or list[np.ndarray[flat|complex]]
@@ -5778,6 +5805,7 @@ class DMRGDriver:
             self.mpi.barrier()
 
         xlen = lambda x: len(self.parse_operator_string(x))
+        cache_dir = "" if scheme_cache_dir is None else scheme_cache_dir
 
         if SymmetryTypes.SU2 in bw.symm_type:
             assert fermionic_ops is None
@@ -5798,7 +5826,7 @@ class DMRGDriver:
                         bw.b.VectorUInt16(mask[ixm])
                         if len(mask) != 0 and not isinstance(mask[0], int)
                         else bw.b.VectorUInt16(mask)),
-                    max_n_sites=ket.n_sites) for ixm, cd in enumerate(op_str)
+                    max_n_sites=ket.n_sites, cache_dir=cache_dir) for ixm, cd in enumerate(op_str)
             ])
         elif SymmetryTypes.SZ in bw.symm_type:
             if npdm_expr is not None and isinstance(npdm_expr, str):
@@ -5813,9 +5841,9 @@ class DMRGDriver:
                 perms = bw.b.VectorSpinPermScheme(
                     [
                         bw.b.SpinPermScheme.initialize_sz(xlen(cd), cd, True,
-                            mask=bw.b.VectorUInt16(), max_n_sites=ket.n_sites) if fermionic_ops is None else
+                            mask=bw.b.VectorUInt16(), max_n_sites=ket.n_sites, cache_dir=cache_dir) if fermionic_ops is None else
                         bw.b.SpinPermScheme.initialize_sany(xlen(cd), cd, fermionic_ops,
-                            mask=bw.b.VectorUInt16(), max_n_sites=ket.n_sites) for cd in op_str
+                            mask=bw.b.VectorUInt16(), max_n_sites=ket.n_sites, cache_dir=cache_dir) for cd in op_str
                     ]
                 )
             elif len(mask) != 0 and not isinstance(mask[0], int):
@@ -5823,10 +5851,10 @@ class DMRGDriver:
                 perms = bw.b.VectorSpinPermScheme(
                     [
                         bw.b.SpinPermScheme.initialize_sz(
-                            xlen(cd), cd, True, mask=bw.b.VectorUInt16(xm), max_n_sites=ket.n_sites
+                            xlen(cd), cd, True, mask=bw.b.VectorUInt16(xm), max_n_sites=ket.n_sites, cache_dir=cache_dir
                         ) if fermionic_ops is None else
                         bw.b.SpinPermScheme.initialize_sany(
-                            xlen(cd), cd, fermionic_ops, mask=bw.b.VectorUInt16(xm), max_n_sites=ket.n_sites
+                            xlen(cd), cd, fermionic_ops, mask=bw.b.VectorUInt16(xm), max_n_sites=ket.n_sites, cache_dir=cache_dir
                         ) for cd, xm in zip(op_str, mask)
                     ]
                 )
@@ -5834,10 +5862,10 @@ class DMRGDriver:
                 perms = bw.b.VectorSpinPermScheme(
                     [
                         bw.b.SpinPermScheme.initialize_sz(
-                            xlen(cd), cd, True, mask=bw.b.VectorUInt16(mask), max_n_sites=ket.n_sites
+                            xlen(cd), cd, True, mask=bw.b.VectorUInt16(mask), max_n_sites=ket.n_sites, cache_dir=cache_dir
                         ) if fermionic_ops is None else
                         bw.b.SpinPermScheme.initialize_sany(
-                            xlen(cd), cd, fermionic_ops, mask=bw.b.VectorUInt16(mask), max_n_sites=ket.n_sites
+                            xlen(cd), cd, fermionic_ops, mask=bw.b.VectorUInt16(mask), max_n_sites=ket.n_sites, cache_dir=cache_dir
                         ) for cd in op_str
                     ]
                 )
@@ -5852,9 +5880,9 @@ class DMRGDriver:
                 perms = bw.b.VectorSpinPermScheme(
                     [
                         bw.b.SpinPermScheme.initialize_sz(xlen(cd), cd, True,
-                            mask=bw.b.VectorUInt16(), max_n_sites=ket.n_sites) if fermionic_ops is None else
+                            mask=bw.b.VectorUInt16(), max_n_sites=ket.n_sites, cache_dir=cache_dir) if fermionic_ops is None else
                         bw.b.SpinPermScheme.initialize_sany(xlen(cd), cd, fermionic_ops,
-                            mask=bw.b.VectorUInt16(), max_n_sites=ket.n_sites) for cd in op_str
+                            mask=bw.b.VectorUInt16(), max_n_sites=ket.n_sites, cache_dir=cache_dir) for cd in op_str
                     ]
                 )
             elif len(mask) != 0 and not isinstance(mask[0], int):
@@ -5862,10 +5890,10 @@ class DMRGDriver:
                 perms = bw.b.VectorSpinPermScheme(
                     [
                         bw.b.SpinPermScheme.initialize_sz(
-                            xlen(cd), cd, True, mask=bw.b.VectorUInt16(xm), max_n_sites=ket.n_sites
+                            xlen(cd), cd, True, mask=bw.b.VectorUInt16(xm), max_n_sites=ket.n_sites, cache_dir=cache_dir
                         ) if fermionic_ops is None else
                         bw.b.SpinPermScheme.initialize_sany(
-                            xlen(cd), cd, fermionic_ops, mask=bw.b.VectorUInt16(xm), max_n_sites=ket.n_sites
+                            xlen(cd), cd, fermionic_ops, mask=bw.b.VectorUInt16(xm), max_n_sites=ket.n_sites, cache_dir=cache_dir
                         )
                         for cd, xm in zip(op_str, mask)
                     ]
@@ -5874,10 +5902,10 @@ class DMRGDriver:
                 perms = bw.b.VectorSpinPermScheme(
                     [
                         bw.b.SpinPermScheme.initialize_sz(
-                            xlen(cd), cd, True, mask=bw.b.VectorUInt16(mask), max_n_sites=ket.n_sites
+                            xlen(cd), cd, True, mask=bw.b.VectorUInt16(mask), max_n_sites=ket.n_sites, cache_dir=cache_dir
                         ) if fermionic_ops is None else
                         bw.b.SpinPermScheme.initialize_sany(
-                            xlen(cd), cd, fermionic_ops, mask=bw.b.VectorUInt16(mask), max_n_sites=ket.n_sites
+                            xlen(cd), cd, fermionic_ops, mask=bw.b.VectorUInt16(mask), max_n_sites=ket.n_sites, cache_dir=cache_dir
                         ) for cd in op_str
                     ]
                 )
@@ -5889,7 +5917,7 @@ class DMRGDriver:
                 perms = bw.b.VectorSpinPermScheme(
                     [
                         bw.b.SpinPermScheme.initialize_sany(xlen(cd), cd, fermionic_ops,
-                            mask=bw.b.VectorUInt16(), max_n_sites=ket.n_sites) for cd in op_str
+                            mask=bw.b.VectorUInt16(), max_n_sites=ket.n_sites, cache_dir=cache_dir) for cd in op_str
                     ]
                 )
             elif len(mask) != 0 and not isinstance(mask[0], int):
@@ -5897,7 +5925,7 @@ class DMRGDriver:
                 perms = bw.b.VectorSpinPermScheme(
                     [
                         bw.b.SpinPermScheme.initialize_sany(
-                            xlen(cd), cd, fermionic_ops, mask=bw.b.VectorUInt16(xm), max_n_sites=ket.n_sites
+                            xlen(cd), cd, fermionic_ops, mask=bw.b.VectorUInt16(xm), max_n_sites=ket.n_sites, cache_dir=cache_dir
                         )
                         for cd, xm in zip(op_str, mask)
                     ]
@@ -5906,7 +5934,7 @@ class DMRGDriver:
                 perms = bw.b.VectorSpinPermScheme(
                     [
                         bw.b.SpinPermScheme.initialize_sany(
-                            xlen(cd), cd, fermionic_ops, mask=bw.b.VectorUInt16(mask), max_n_sites=ket.n_sites
+                            xlen(cd), cd, fermionic_ops, mask=bw.b.VectorUInt16(mask), max_n_sites=ket.n_sites, cache_dir=cache_dir
                         )
                         for cd in op_str
                     ]
@@ -6470,6 +6498,204 @@ class DMRGDriver:
         self.align_mps_center(ket, refc, max_bond_dim=max_bond_dim)
         return ket
 
+    def orbital_rotation(self, ket, rot, max_bond_dim=None, cutoff=1e-14, iprint=0):
+        """
+        Rotate the orbitals of the MPS (inplace) using nearest-neighbour
+        Givens rotation gates applied in MPS sweeps. If the input MPS is
+        expressed in orbitals ``phi_j = sum_i phi'_i rot[i, j]``, the rotated
+        MPS represents the same state in orbitals ``phi'``.
+
+        The rotation must preserve the point group symmetry: it may only mix
+        orbitals of the same irrep, and the mixed orbitals of each irrep must
+        be contiguous in the site order. Otherwise a ``RuntimeError`` is raised.
+
+        Args:
+            ket : MPS
+                The block2 MPS object. Will be changed to "2-site" type.
+            rot : np.ndarray[float]
+                The real orthogonal rotation matrix,
+                with shape ``(n_sites, n_sites)``.
+            max_bond_dim : None or int
+                If not None, will restrict the maximal bond dimension of the
+                rotated MPS to the given number. Default is None, meaning
+                that the current bond dimension of the MPS is used.
+            cutoff : float
+                States with eigenvalue below this number will be discarded,
+                even when the bond dimension is large enough to keep this state.
+                Default is 1E-14.
+            iprint : int
+                Verbosity. Default is 0 (quiet).
+
+        Returns:
+            ket : MPS
+                The rotated MPS.
+        """
+        import numpy as np
+
+        bw = self.bw
+        if self.mpi is not None:
+            raise NotImplementedError()
+        rot = np.asarray(rot, dtype=float)
+        assert rot.shape == (ket.n_sites, ket.n_sites)
+        if self.orb_sym is not None:
+            bw.bs.OrbitalRotation.check_rotation(
+                bw.VectorFP(rot.flatten()), bw.b.VectorInt(list(self.orb_sym))
+            )
+        ket, _ = self.adjust_mps(ket, dot=2)
+        if ket.center != 0 and ket.center != ket.n_sites - 2:
+            self.align_mps_center(ket, 0)
+            ket, _ = self.adjust_mps(ket, dot=2)
+        ket.info.load_mutable()
+        if max_bond_dim is None:
+            max_bond_dim = max(ket.info.bond_dim, ket.info.get_max_bond_dimension())
+        orot = bw.bs.OrbitalRotation(ket, max_bond_dim)
+        orot.cutoff = cutoff
+        orot.iprint = iprint
+        orot.solve(bw.VectorFP(rot.flatten()))
+        ket.info.save_data(self.scratch + "/%s-mps_info.bin" % ket.info.tag)
+        return ket
+
+    def geometry_continuation(
+        self,
+        ket,
+        ovlp,
+        h1e=None,
+        g2e=None,
+        orb_sym=None,
+        max_bond_dim=None,
+        cutoff=1e-14,
+        iprint=0,
+        ecore=0.0,
+        n_sweeps=4,
+        tol=1e-8,
+        bond_dims=None,
+        noises=None,
+        thrds=None,
+    ):
+        """
+        Warm start for a potential energy scan (inplace). The orbitals of the
+        new geometry are permuted and sign-flipped to follow the sites of the
+        MPS converged at the previous geometry, and the remaining small
+        rotation is applied to the MPS. When the integrals at the new geometry
+        are given, they are aligned in the same way and a DMRG with a short
+        schedule is run from the rotated MPS.
+
+        Limitation: a saving over a cold start has only been measured when the
+        alignment is a pure permutation / sign change, where the MPS is reused
+        as is. With a non-trivial residual rotation, the whole scan was
+        measured slower than converging every point from a random MPS on a
+        small system (N2 6-31G, 16 orbitals, M = 100, rotation at
+        ``max_bond_dim = 2M``: 99.8 s vs 73.4 s); rotating at ``M`` truncated
+        too much. Check the printed max rotation (``iprint``) and prefer a
+        cold start when it is large.
+
+        Args:
+            ket : MPS
+                The block2 MPS object converged at the previous geometry.
+            ovlp : np.ndarray[float]
+                Orbital overlap matrix ``<old site i | new orbital j>``,
+                with shape ``(n_sites, n_sites)``.
+            h1e, g2e : None or np.ndarray[float]
+                Full (unpacked) integrals at the new geometry, in the
+                original orbital order. Tuples are transformed elementwise.
+            orb_sym : None or (list[int], list[int])
+                If not None, the point group irreps of the old sites and of
+                the new orbitals. Orbitals are only matched within an irrep.
+                An irrep with a non-trivial residual rotation must occupy
+                contiguous sites.
+            max_bond_dim : None or int
+                Maximal bond dimension of the rotated MPS.
+                Default is None, meaning the current bond dimension.
+            cutoff : float
+                Singular value cutoff in the rotation. Default is 1E-14.
+            iprint : int
+                Verbosity. Default is 0 (quiet).
+            ecore : float
+                Core energy at the new geometry. Default is 0.0.
+            n_sweeps : int
+                Number of DMRG sweeps from the warm start. Default is 4.
+                If zero, or if ``h1e`` or ``g2e`` is None, no DMRG is run.
+            tol : float
+                Energy convergence threshold of the DMRG. Default is 1E-8.
+            bond_dims, noises, thrds : None or list
+                Schedule of the DMRG. Default is the bond dimension of the
+                MPS, noises ``[1E-5, 0]`` and the default thresholds of
+                ``dmrg``.
+
+        Returns:
+            energy : None or float
+                The DMRG energy at the new geometry (None if no DMRG is run).
+            ket : MPS
+                The rotated (and optimized) MPS.
+            h1e, g2e : None or np.ndarray[float]
+                The aligned integrals.
+            idx : np.ndarray[int]
+                ``idx[k]`` is the new orbital placed at site ``k``.
+            phases : np.ndarray[float]
+                Sign of the new orbital placed at site ``k``. The aligned
+                orbital coefficients are ``mo_coeff[:, idx] * phases``.
+        """
+        import numpy as np
+
+        bw = self.bw
+        n = ket.n_sites
+        ovlp = np.asarray(ovlp, dtype=float)
+        assert ovlp.shape == (n, n)
+        if orb_sym is None:
+            gc = bw.bs.GeometryContinuation(bw.VectorFP(ovlp.flatten()), n)
+        else:
+            gc = bw.bs.GeometryContinuation(
+                bw.VectorFP(ovlp.flatten()),
+                n,
+                bw.b.VectorUInt8(orb_sym[0]),
+                bw.b.VectorUInt8(orb_sym[1]),
+            )
+        idx = np.array(gc.reorder, dtype=int)
+        phases = np.array(gc.phases, dtype=float)
+        if iprint:
+            print(
+                "Geometry continuation | Nperm = %4d | Min overlap = %10.3E"
+                " | Max rotation = %10.3E"
+                % (gc.n_permuted(), gc.min_overlap, gc.max_rotation)
+            )
+        # permutation and signs only relabel the sites
+        if gc.max_rotation >= 1e-12:
+            gc.check_rotation()
+            rot = np.array(gc.rotation, dtype=float).reshape(n, n)
+            self.orbital_rotation(
+                ket, rot.T, max_bond_dim=max_bond_dim, cutoff=cutoff, iprint=iprint
+            )
+
+        def align(x, nd):
+            if x is None:
+                return None
+            elif isinstance(x, (tuple, list)):
+                return type(x)(align(xx, nd) for xx in x)
+            x = np.asarray(x)[np.ix_(*[idx] * nd)]
+            for i in range(nd):
+                x = x * phases.reshape((1,) * i + (n,) + (1,) * (nd - i - 1))
+            return x
+
+        h1e, g2e = align(h1e, 2), align(g2e, 4)
+        energy = None
+        if h1e is not None and g2e is not None and n_sweeps > 0:
+            mpo = self.get_qc_mpo(h1e=h1e, g2e=g2e, ecore=ecore, iprint=iprint)
+            if bond_dims is None:
+                bond_dims = [ket.info.bond_dim]
+            if noises is None:
+                noises = [1e-5, 0]
+            energy = self.dmrg(
+                mpo,
+                ket,
+                n_sweeps=n_sweeps,
+                tol=tol,
+                bond_dims=bond_dims,
+                noises=noises,
+                thrds=thrds,
+                iprint=iprint,
+            )
+        return energy, ket, h1e, g2e, idx, phases
+
     def align_mps_center(self, ket, ref, max_bond_dim=None):
         """
         Change the canonical center of the given MPS, or align the canonical center
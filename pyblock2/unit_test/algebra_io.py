@@ -0,0 +1,39 @@
+import numpy as np
+import pytest
+
+from pyblock2.algebra.io import MPSTools, TensorTools
+from pyblock2.algebra.pde import PDETools1D
+
+
+pytestmark = pytest.mark.filterwarnings("ignore::DeprecationWarning")
+
+
+@pytest.fixture(params=[False, True], ids=["python", "flat"])
+def use_flat(request):
+    old = TensorTools.use_flat
+    TensorTools.use_flat = request.param
+    yield request.param
+    TensorTools.use_flat = old
+
+
+@pytest.mark.parametrize("center", [0, 2, 4])
+def test_mps_round_trip(tmp_path, use_flat, center):
+    pde = PDETools1D(5, xi=-1.0, xf=1.0, bases=2)
+    pde.init_dmrg_driver(scratch=str(tmp_path / "nodex"))
+    driver = pde.driver
+    try:
+        pyket = pde.pymps_from_range(-0.2, 0.6, 1.0)
+        _, ref = pde.pymps_rasterize(pyket)
+        ket = MPSTools.to_block2(pyket, driver.basis, center=center, tag="KET")
+        ket = driver.adjust_mps(ket, dot=1)[0]
+        pyket2 = MPSTools.from_block2(ket)
+        _, values = pde.pymps_rasterize(pyket2)
+        # second round trip starting from the block2 side
+        ket2 = MPSTools.to_block2(pyket2, driver.basis, center=center, tag="KET2")
+        ket2 = driver.adjust_mps(ket2, dot=1)[0]
+        _, values2 = pde.pymps_rasterize(MPSTools.from_block2(ket2))
+    finally:
+        driver.finalize()
+
+    np.testing.assert_allclose(values, ref, atol=1e-12)
+    np.testing.assert_allclose(values2, ref, atol=1e-12)
@@ -0,0 +1,65 @@
+import pytest
+import sys
+import json
+import subprocess
+
+pytestmark = pytest.mark.filterwarnings("ignore::DeprecationWarning")
+
+# each measurement runs in a fresh interpreter, so that
+# the import cost and peak RSS are not shared between cases
+SCRIPT = """
+import sys, time, json, resource, tempfile
+t = time.perf_counter()
+import block2
+t_import = time.perf_counter() - t
+r = {"split": hasattr(block2, "loaded_modules")}
+r["base"] = block2.loaded_modules() if r["split"] else []
+if "%s" == "driver":
+    from pyblock2.driver.core import DMRGDriver, SymmetryTypes
+    t = time.perf_counter()
+    driver = DMRGDriver(
+        scratch=tempfile.mkdtemp(), stack_mem=1 << 26,
+        symm_type=SymmetryTypes.SU2, n_threads=1
+    )
+    driver.initialize_system(n_sites=4, n_elec=4, spin=0)
+    mps = driver.get_random_mps(tag="KET", bond_dim=10)
+    r["t_driver"] = time.perf_counter() - t
+elif "%s" == "all":
+    for sub in ["su2", "sz", "sgf", "sgb", "su2k", "szk", "sany"]:
+        if hasattr(block2, sub):
+            getattr(block2, sub).MPS
+r["t_import"] = t_import
+r["loaded"] = block2.loaded_modules() if r["split"] else []
+r["rss"] = resource.getrusage(resource.RUSAGE_SELF).ru_maxrss
+print(json.dumps(r))
+"""
+
+
+def run_case(case):
+    out = subprocess.run(
+        [sys.executable, "-c", SCRIPT % (case, case)],
+        check=True,
+        capture_output=True,
+        text=True,
+    ).stdout
+    return json.loads(out.strip().splitlines()[-1])
+
+
+class TestImportTime:
+    def test_import_time(self):
+        base, driver, full = [run_case(c) for c in ["base", "driver", "all"]]
+        for case, r in [("base", base), ("driver", driver), ("all", full)]:
+            print(
+                "%6s import = %8.3f s rss = %10d KB modules = %s"
+                % (case, r["t_import"], r["rss"], " ".join(r["loaded"]))
+            )
+        print("driver init = %8.3f s" % driver["t_driver"])
+        if not base["split"]:
+            return
+        # nothing symmetry specific is imported by "import block2"
+        assert base["base"] == [] and base["loaded"] == []
+        # SU2 driver only imports the SU2/SZ modules and their dependences
+        assert "_block2_u" in driver["loaded"]
+        for x in ["_block2_k", "_block2_g", "_block2_a"]:
+            assert x not in driver["loaded"]
+        assert base["rss"] < full["rss"]
@@ -0,0 +1,77 @@
+import pytest
+import numpy as np
+
+pytestmark = pytest.mark.filterwarnings("ignore::DeprecationWarning")
+
+
+@pytest.fixture(scope="module")
+def mf():
+    from pyscf import gto, scf
+
+    mol = gto.M(atom="O 0 0 0; H 0 1 0; H 0 0 1", basis="sto3g", verbose=0)
+    return scf.RHF(mol).run(conv_tol=1e-14)
+
+
+@pytest.fixture(scope="module", params=[False, True], ids=["numpy", "native"])
+def native_exec(request):
+    return request.param
+
+
+class TestWickCC:
+    def test_gccsd(self, mf, native_exec):
+        from pyscf import cc
+        from pyblock2.cc.gccsd import WickGCCSD
+
+        gmf = mf.to_ghf()
+        ref = cc.GCCSD(gmf).run(conv_tol=1e-12)
+        mcc = WickGCCSD(gmf, native_exec=native_exec).run(conv_tol=1e-12)
+        assert abs(mcc.e_corr - ref.e_corr) < 1e-8
+        assert abs(mcc.ccsd_t() - ref.ccsd_t()) < 1e-8
+        l1, l2 = mcc.solve_lambda()
+        ref_l1, ref_l2 = ref.solve_lambda()
+        assert np.linalg.norm(l1 - ref_l1) < 1e-6
+        assert np.linalg.norm(l2 - ref_l2) < 1e-6
+        eip = mcc.ipccsd(nroots=2)[0]
+        eea = mcc.eaccsd(nroots=2)[0]
+        assert np.linalg.norm(eip - ref.ipccsd(nroots=2)[0]) < 1e-6
+        assert np.linalg.norm(eea - ref.eaccsd(nroots=2)[0]) < 1e-6
+
+    def test_gccsd_generated(self, mf, native_exec):
+        from pyscf import cc
+        from pyblock2.cc.gccsdt import GCCSD
+
+        gmf = mf.to_ghf()
+        ref = cc.GCCSD(gmf).run(conv_tol=1e-12)
+        mcc = GCCSD(gmf, native_exec=native_exec)
+        mcc.conv_tol = 1e-12
+        mcc.kernel()
+        assert abs(mcc.e_corr - ref.e_corr) < 1e-8
+
+    def test_gccsdt_packed(self, mf):
+        from pyblock2.cc.gccsdt import GCCSDT
+
+        gmf = mf.to_ghf()
+        ref = GCCSDT(gmf)
+        ref.kernel()
+        mcc = GCCSDT(gmf, native_exec=True)
+        mcc.kernel()
+        # t2 and t3 stay packed between iterations
+        assert not isinstance(mcc.tamps[2], np.ndarray)
+        assert abs(mcc.e_corr - ref.e_corr) < 1e-7
+        t3 = np.asarray(mcc.tamps[2].unpack())
+        assert np.linalg.norm(t3 - ref.tamps[2]) < 1e-5
+
+    def test_rccsd(self, mf, native_exec):
+        from pyscf import cc
+        from pyblock2.cc.rccsd import WickRCCSD
+
+        ref = cc.RCCSD(mf).run(conv_tol=1e-12)
+        mcc = WickRCCSD(mf, native_exec=native_exec).run(conv_tol=1e-12)
+        assert abs(mcc.e_corr - ref.e_corr) < 1e-8
+        assert abs(mcc.ccsd_t() - ref.ccsd_t()) < 1e-8
+        l1, l2 = mcc.solve_lambda()
+        ref_l1, ref_l2 = ref.solve_lambda()
+        assert np.linalg.norm(l1 - ref_l1) < 1e-6
+        assert np.linalg.norm(l2 - ref_l2) < 1e-6
+        eip = mcc.ipccsd(nroots=2)[0]
+        assert np.linalg.norm(eip - ref.ipccsd(nroots=2)[0]) < 1e-6
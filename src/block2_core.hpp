@@ -24,6 +24,7 @@
 #include "core/archived_sparse_matrix.hpp"
 #include "core/archived_tensor_functions.hpp"
 #include "core/batch_gemm.hpp"
+#include "core/block_sparse_tensor.hpp"
 #include "core/clebsch_gordan.hpp"
 #include "core/complex_matrix_functions.hpp"
 #include "core/csr_matrix.hpp"
@@ -34,6 +35,7 @@
 #include "core/delayed_tensor_functions.hpp"
 #include "core/expr.hpp"
 #include "core/fft.hpp"
+#include "core/file_container.hpp"
 #include "core/flow.hpp"
 #include "core/fp_codec.hpp"
 #include "core/general_symm_permutation.hpp"
@@ -25,16 +25,21 @@
 #include "dmrg/dmrg_driver.hpp"
 #include "dmrg/effective_functions.hpp"
 #include "dmrg/effective_hamiltonian.hpp"
+#include "dmrg/flat_sparse_tensor.hpp"
 #include "dmrg/general_hamiltonian.hpp"
 #include "dmrg/general_mpo.hpp"
 #include "dmrg/general_npdm.hpp"
+#include "dmrg/geometry_continuation.hpp"
+#include "dmrg/memory_budget.hpp"
 #include "dmrg/moving_environment.hpp"
 #include "dmrg/mpo.hpp"
 #include "dmrg/mpo_fusing.hpp"
 #include "dmrg/mpo_simplification.hpp"
 #include "dmrg/mps.hpp"
 #include "dmrg/mps_unfused.hpp"
+#include "dmrg/orbital_gradient.hpp"
 #include "dmrg/orbital_ordering.hpp"
+#include "dmrg/orbital_rotation.hpp"
 #include "dmrg/parallel_mpo.hpp"
 #include "dmrg/parallel_mps.hpp"
 #include "dmrg/parallel_simple.hpp"
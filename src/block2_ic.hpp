@@ -20,6 +20,8 @@
 
 #pragma once
 
+#include "ic/guga_ci.hpp"
 #include "ic/guga_drt.hpp"
 #include "ic/nd_array.hpp"
 #include "ic/wick.hpp"
+#include "ic/wick_executor.hpp"
@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include "file_container.hpp"
 #include "fp_codec.hpp"
 #include "utils.hpp"
 #ifdef _HAS_TBB
@@ -370,6 +371,79 @@ template <typename T> struct VectorAllocator : Allocator<T> {
     }
 };
 
+/** Allocator handing out consecutive pieces of one contiguous slab.
+ * Used when all data of an operator tensor is loaded with a single read.
+ * Pieces are never freed individually; the slab is released when the last
+ * matrix holding this allocator is destroyed.
+ * @tparam T The type of the element in the array.
+ */
+template <typename T> struct SlabAllocator : Allocator<T> {
+    vector<T> buffer; //!< The slab (with extra space for alignment).
+    T *data;          //!< Aligned start of the slab.
+    size_t size;      //!< Number of elements in the slab.
+    size_t used;      //!< Number of elements handed out.
+    vector<vector<T>> grown; //!< Pieces that have grown out of the slab.
+    /** Constructor.
+     * @param size Number of elements in the slab.
+     */
+    SlabAllocator(size_t size) : size(size), used(0) {
+        const size_t xalign = 64 / sizeof(T);
+        buffer.resize(size + xalign);
+        const uintptr_t unaligned =
+            ((uintptr_t)(const void *)buffer.data()) % 64;
+        data = unaligned == 0 ? buffer.data()
+                              : (T *)((uintptr_t)(const void *)buffer.data() +
+                                      (64 - unaligned));
+    }
+    /** Take the next length n piece of the slab.
+     * @param n Number of elements in the array.
+     * @return The allocated pointer.
+     */
+    T *allocate(size_t n) override {
+        if (threading->align_type != AlignTypes::None) {
+            const uint32_t xalign =
+                (uint8_t)threading->align_type / sizeof(T);
+            used = (used + xalign - 1) / xalign * xalign;
+        }
+        if (used + n > size)
+            throw runtime_error("SlabAllocator::allocate: exceeding slab size " +
+                                to_string(size) + ".");
+        T *ptr = data + used;
+        used += n;
+        return ptr;
+    }
+    /** Deallocation is a no-op, since the slab is freed as a whole.
+     * @param ptr The pointer to be deallocated.
+     * @param n Number of elements in the array.
+     */
+    void deallocate(void *ptr, size_t n) override {}
+    /** Change the size of one piece. Shrinking is done in place. The last
+     * piece of the slab grows in place if the slab has enough space left,
+     * other pieces are moved to a separate buffer owned by this allocator
+     * (the old space in the slab is not reused).
+     * @param ptr The allocated pointer.
+     * @param n Number of elements in original allocation.
+     * @param new_n Number of elements in the new allocation.
+     * @return The new pointer.
+     */
+    T *reallocate(T *ptr, size_t n, size_t new_n) override {
+        if (new_n <= n)
+            return ptr;
+        if (ptr + n == data + used && used - n + new_n <= size) {
+            used += new_n - n;
+            return ptr;
+        }
+        grown.push_back(vector<T>(new_n));
+        return grown.back().data();
+    }
+    /** Return an independent allocator for deep copies.
+     * @return The copy of this allocator.
+     */
+    shared_ptr<Allocator<T>> copy() const override {
+        return make_shared<VectorAllocator<T>>();
+    }
+};
+
 #ifdef _USE_GLOBAL_VARIABLE
 
 extern shared_ptr<StackAllocator<uint32_t>> _g_ialloc;
@@ -483,6 +557,9 @@ template <typename FL> struct DataFrame {
     //!< Buffers for async saving.
     mutable vector<shared_future<void>> save_futures;
     //!< Async saving files.
+    mutable vector<size_t> buffer_sizes;
+    //!< Sizes (in Bytes) of the loading buffers (first ``n_frames`` elements)
+    //!< and saving buffers (last ``n_frames`` elements).
     bool load_buffering = false, //!< Whether load buffering should be used. If
                                  //!< true, memory usage will increase.
         save_buffering =
@@ -503,9 +580,17 @@ template <typename FL> struct DataFrame {
     bool compressed_sparse_tensor_storage =
         false; //!< Whether block-sparse tensor should be stored in compressed
                //!< form to save storage (mainly for MPS).
+    bool compact_operator_storage =
+        false; //!< Whether operator tensors should be saved with one shared
+               //!< SparseMatrixInfo record per distinct info and all operator
+               //!< data in one contiguous slab (loaded with a single read).
     shared_ptr<FPCodec<FL>> fp_codec =
         nullptr; //!< Floating-point compression codec. If nullptr,
                  //!< floating-point compression will not be used.
+    shared_ptr<FileContainer> partition_container =
+        nullptr; //!< If not nullptr, renormalized operators and partition
+                 //!< infos are stored as records in this single file, using
+                 //!< the scratch filenames as record names.
     /** Constructor.
      * @param isize Max size (in bytes) of all integer stacks.
      * @param dsize Max size (in bytes) of all double stacks.
@@ -526,6 +611,7 @@ template <typename FL> struct DataFrame {
         load_buffers.resize(n_frames);
         save_buffers.resize(n_frames);
         save_futures.resize(n_frames);
+        buffer_sizes.resize(n_frames * 2);
         this->isize = isize >> 2;
         this->dsize = dsize / sizeof(FL);
         const size_t ipk = 64 / sizeof(uint32_t), dpk = 64 / sizeof(FL);
@@ -582,6 +668,7 @@ template <typename FL> struct DataFrame {
         if (save_buffering && save_futures[i].valid())
             save_futures[i].wait();
         save_buffers[i] = make_pair("", nullptr);
+        buffer_sizes[i] = buffer_sizes[n_frames + i] = 0;
     }
     /** Rename one scratch file.
      * @param old_filename original filename.
@@ -589,12 +676,47 @@ template <typename FL> struct DataFrame {
      */
     void rename_data(const string &old_filename,
                      const string &new_filename) const {
-        if (!Parsing::rename_file(old_filename, new_filename))
+        if (partition_container != nullptr) {
+            if (!partition_container->rename(old_filename, new_filename))
+                throw runtime_error("Renaming '" + old_filename + "' to '" +
+                                    new_filename + "' failed.");
+        } else if (!Parsing::rename_file(old_filename, new_filename))
             throw runtime_error("Renaming '" + old_filename + "' to '" +
                                 new_filename + "' failed.");
         for (auto &fn : present_filenames)
             fn = "";
     }
+    /** Remove one scratch file, if it exists.
+     * @param filename The filename.
+     */
+    void remove_data(const string &filename) const {
+        if (partition_container != nullptr)
+            partition_container->remove(filename);
+        else if (Parsing::file_exists(filename))
+            Parsing::remove_file(filename);
+    }
+    /** Make one scratch file refer to the content of another.
+     * @param source The existing filename.
+     * @param filename The new filename.
+     */
+    void link_data(const string &source, const string &filename) const {
+        if (partition_container != nullptr)
+            partition_container->link(source, filename);
+        else
+            Parsing::link_file(source, filename);
+    }
+    /** Write an atomic snapshot of the partition container (if used).
+     * @param dir The directory for the snapshot file.
+     */
+    void snapshot_partition_container(const string &dir) const {
+        if (partition_container == nullptr || !partition_can_write)
+            return;
+        for (const auto &ft : save_futures)
+            if (ft.valid())
+                ft.wait();
+        partition_container->snapshot(
+            dir + "/" + Parsing::get_filename(partition_container->filename));
+    }
     /** Load one data frame from input stream.
      * @param i The index of the data frame.
      * @param ifs The input stream.
@@ -626,6 +748,7 @@ template <typename FL> struct DataFrame {
             load_buffers[i].second->seekg(0);
             load_data_from(i, *load_buffers[i].second);
             load_buffers[i] = make_pair(present_filenames[i], ss);
+            buffer_sizes[i] = (size_t)ss->tellp();
             present_filenames[i] = filename;
             tread += _t.get_time();
             return;
@@ -633,6 +756,7 @@ template <typename FL> struct DataFrame {
             shared_ptr<stringstream> ss = make_shared<stringstream>();
             save_data_to(i, *ss);
             load_buffers[i] = make_pair(present_filenames[i], ss);
+            buffer_sizes[i] = (size_t)ss->tellp();
         }
         if (save_buffers[i].first == filename) {
             if (save_futures[i].valid())
@@ -644,15 +768,20 @@ template <typename FL> struct DataFrame {
             tread += _t.get_time();
             return;
         }
-        ifstream ifs(filename.c_str(), ios::binary);
-        if (!ifs.good())
-            throw runtime_error("DataFrame::load_data on '" + filename +
-                                "' failed.");
-        load_data_from(i, ifs);
-        if (ifs.fail() || ifs.bad())
-            throw runtime_error("DataFrame::load_data on '" + filename +
-                                "' failed.");
-        ifs.close();
+        if (partition_container != nullptr)
+            partition_container->read(
+                filename, [this, i](istream &ifs) { load_data_from(i, ifs); });
+        else {
+            ifstream ifs(filename.c_str(), ios::binary);
+            if (!ifs.good())
+                throw runtime_error("DataFrame::load_data on '" + filename +
+                                    "' failed.");
+            load_data_from(i, ifs);
+            if (ifs.fail() || ifs.bad())
+                throw runtime_error("DataFrame::load_data on '" + filename +
+                                    "' failed.");
+            ifs.close();
+        }
         tread += _t.get_time();
         update_peak_used_memory();
         present_filenames[i] = filename;
@@ -698,6 +827,20 @@ template <typename FL> struct DataFrame {
         ofs.close();
         *tasync += tx.get_time();
     }
+    /** Save the data in buffer stream into a container record.
+     * @param container The container.
+     * @param filename The record name.
+     * @param ss The buffer stream.
+     * @param tasync Pointer to the time recorder for async saving.
+     */
+    static void buffer_save_container(
+        const shared_ptr<FileContainer> &container, const string &filename,
+        const shared_ptr<stringstream> &ss, double *tasync) {
+        Timer tx;
+        tx.get_time();
+        container->write(filename, ss->str());
+        *tasync += tx.get_time();
+    }
     /** Save one data frame to disk.
      * @param i The index of the data frame.
      * @param filename The filename for the data frame.
@@ -715,8 +858,25 @@ template <typename FL> struct DataFrame {
             shared_ptr<stringstream> ss = make_shared<stringstream>();
             save_data_to(i, *ss);
             save_buffers[i] = make_pair(filename, ss);
-            save_futures[i] = async(launch::async, &DataFrame::buffer_save_data,
-                                    filename, ss, &tasync);
+            // measured before the async thread starts reading the stream
+            buffer_sizes[n_frames + i] = (size_t)ss->tellp();
+            if (partition_container != nullptr)
+                save_futures[i] =
+                    async(launch::async, &DataFrame::buffer_save_container,
+                          partition_container, filename, ss, &tasync);
+            else
+                save_futures[i] =
+                    async(launch::async, &DataFrame::buffer_save_data,
+                          filename, ss, &tasync);
+            twrite += _t.get_time();
+            update_peak_used_memory();
+            present_filenames[i] = filename;
+            return;
+        }
+        if (partition_container != nullptr) {
+            stringstream ss;
+            save_data_to(i, ss);
+            partition_container->write(filename, ss.str());
             twrite += _t.get_time();
             update_peak_used_memory();
             present_filenames[i] = filename;
@@ -759,6 +919,15 @@ template <typename FL> struct DataFrame {
             r += dallocs[i]->used * sizeof(FL) + iallocs[i]->used * 4;
         return r;
     }
+    /** Return the current memory used by the loading and saving buffers.
+     * @return The buffer memory in Bytes (allocated on the heap).
+     */
+    size_t buffer_memory_used() const {
+        size_t r = 0;
+        for (auto &x : buffer_sizes)
+            r += x;
+        return r;
+    }
     /** Update peak used memory statistics. */
     void update_peak_used_memory() const {
         for (int i = 0; i < n_frames; i++) {
@@ -788,7 +957,15 @@ template <typename FL> struct DataFrame {
         if (df.fp_codec != nullptr)
             os << " FPCompression: prec = " << scientific << setprecision(2)
                << df.fp_codec->prec << " chunk = " << fixed
-               << df.fp_codec->chunk_size << endl;
+               << df.fp_codec->chunk_size << " block = "
+               << df.fp_codec->block_size << endl;
+        if (df.partition_container != nullptr)
+            os << " Container = " << df.partition_container->filename
+               << " records = " << df.partition_container->n_records()
+               << " size = "
+               << Parsing::to_size_string(
+                      df.partition_container->data_size())
+               << endl;
         os << " IMain = " << Parsing::to_size_string(df.iallocs[0]->used * 4)
            << " / " << Parsing::to_size_string(df.iallocs[0]->size * 4);
         os << " DMain = "
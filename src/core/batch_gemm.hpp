@@ -31,6 +31,7 @@
 #include <cassert>
 #include <iomanip>
 #include <iostream>
+#include <limits>
 #include <map>
 #include <memory>
 #include <utility>
@@ -856,6 +857,17 @@ template <typename FL> struct BatchGEMMSeq {
     FL *work, *rwork;
     SeqTypes mode;
     bool no_check = true;
+    // Sparsity screening of [H] x [c] (off when screen_thrd == 0):
+    // a rotation is skipped when the bound |scale| |bra| |c block| |ket|
+    // (Frobenius norms) of its contribution is below screen_thrd * |c|
+    FP screen_thrd = 0, screen_cnorm = 0;
+    // (offset, size) of the blocks of [c] (for precomputed Tasked mode)
+    vector<pair<size_t, size_t>> screen_blocks;
+    vector<FP> screen_norms;
+    vector<int> screen_idx;
+    // sum of skipped bounds relative to |c| in current / worst [H] x [c]
+    FP screen_error = 0, screen_max_error = 0;
+    size_t screen_nskip = 0, screen_ntotal = 0;
     BatchGEMMSeq(size_t max_batch_flops = 1LU << 30,
                  SeqTypes mode = SeqTypes::None)
         : max_batch_flops(max_batch_flops), mode(mode), vdata(nullptr) {
@@ -869,6 +881,9 @@ template <typename FL> struct BatchGEMMSeq {
         seq->batch.clear();
         seq->batch.push_back(make_shared<BatchGEMM<FL>>());
         seq->batch.push_back(make_shared<BatchGEMM<FL>>());
+        seq->screen_norms.clear(), seq->screen_idx.clear();
+        seq->screen_error = seq->screen_max_error = 0;
+        seq->screen_nskip = seq->screen_ntotal = 0;
         return seq;
     }
     // [a] = cfactor * [a] + scale * [b]
@@ -1399,6 +1414,104 @@ template <typename FL> struct BatchGEMMSeq {
     }
     // Deallocate work arrays
     void deallocate() { vdata = nullptr; }
+    // Frobenius norm of a (m x n) matrix with leading dimension lda
+    static FP screen_norm(const FL *a, MKL_INT m, MKL_INT n, MKL_INT lda) {
+        const MKL_INT inc = 1;
+        if (lda == n) {
+            const MKL_INT mn = m * n;
+            return xnrm2<FL>(&mn, a, &inc);
+        }
+        FP r = 0;
+        for (MKL_INT i = 0; i < m; i++) {
+            const FP x = xnrm2<FL>(&n, a + (size_t)i * lda, &inc);
+            r += x * x;
+        }
+        return sqrt(r);
+    }
+    void screen_begin(FP cnorm) {
+        screen_cnorm = cnorm;
+        screen_error = 0;
+    }
+    void screen_end() {
+        screen_max_error = max(screen_max_error, screen_error);
+    }
+    // Collect screening statistics from a thread-local copy
+    void screen_merge(const BatchGEMMSeq &other) {
+        screen_error += other.screen_error;
+        screen_nskip += other.screen_nskip;
+        screen_ntotal += other.screen_ntotal;
+    }
+    // Test whether a contribution with norm bound can be skipped
+    // (thread-safe, for direct multiplication)
+    bool screen(FP bound) {
+        const bool skip = bound < screen_thrd * screen_cnorm;
+#pragma omp atomic
+        screen_ntotal++;
+        if (skip) {
+            const FP err = bound / screen_cnorm;
+#pragma omp atomic
+            screen_nskip++;
+#pragma omp atomic
+            screen_error += err;
+        }
+        return skip;
+    }
+    // Operator norm bound of each precomputed rotation
+    // (real Tasked mode, where batch[0]/batch[1] are paired rotations)
+    void screen_prepare() {
+        const size_t n = batch[0]->c.size();
+        screen_norms.resize(n);
+        screen_idx.resize(n);
+        for (size_t i = 0; i < n; i++) {
+            const BatchGEMM<FL> &b0 = *batch[0], &b1 = *batch[1];
+            const bool tb = b0.tb[i] != CblasNoTrans,
+                       ta = b1.ta[i] != CblasNoTrans;
+            const FP kn = screen_norm(b0.b[i], tb ? b0.n[i] : b0.k[i],
+                                      tb ? b0.k[i] : b0.n[i], b0.ldb[i]);
+            const FP bn = screen_norm(b1.a[i], ta ? b1.k[i] : b1.m[i],
+                                      ta ? b1.m[i] : b1.k[i], b1.lda[i]);
+            screen_norms[i] = abs(b0.alpha[i] * b1.alpha[i]) * kn * bn;
+            const pair<size_t, size_t> offset =
+                make_pair((size_t)(b0.a[i] - (FL *)0),
+                          numeric_limits<size_t>::max());
+            screen_idx[i] =
+                (int)(upper_bound(screen_blocks.begin(), screen_blocks.end(),
+                                  offset) -
+                      screen_blocks.begin()) -
+                1;
+            assert(screen_idx[i] >= 0);
+        }
+    }
+    // Mark skipped rotations for a given [c]; returns skipped flops
+    // (screen_end is left to the caller, after merging other ranks)
+    size_t screen_mask(const GMatrix<FL> &c, vector<uint8_t> &skip) {
+        if (screen_norms.size() != batch[0]->c.size())
+            screen_prepare();
+        vector<FP> cnorms(screen_blocks.size());
+        FP cnorm = 0;
+        for (size_t ib = 0; ib < screen_blocks.size(); ib++) {
+            const MKL_INT sz = (MKL_INT)screen_blocks[ib].second, inc = 1;
+            cnorms[ib] = xnrm2<FL>(&sz, c.data + screen_blocks[ib].first, &inc);
+            cnorm += cnorms[ib] * cnorms[ib];
+        }
+        screen_begin(sqrt(cnorm));
+        skip.resize(screen_norms.size());
+        size_t nflop = 0;
+        for (size_t i = 0; i < screen_norms.size(); i++) {
+            const FP bound = screen_norms[i] * cnorms[screen_idx[i]];
+            skip[i] = bound < screen_thrd * screen_cnorm;
+            if (skip[i]) {
+                screen_error += bound / screen_cnorm;
+                nflop += (size_t)batch[0]->m[i] * batch[0]->n[i] *
+                             batch[0]->k[i] +
+                         (size_t)batch[1]->m[i] * batch[1]->n[i] *
+                             batch[1]->k[i];
+                screen_nskip++;
+            }
+        }
+        screen_ntotal += screen_norms.size();
+        return nflop;
+    }
     // Perform non-conflicting batched DGEMM
     void simple_perform() {
         divide_batch();
@@ -1622,6 +1735,11 @@ template <typename FL> struct BatchGEMMSeq {
                 batch[0]->build_acc_gp();
                 batch[1]->build_acc_gp();
             }
+            vector<uint8_t> skip;
+            size_t skip_nflop = 0;
+            if (screen_thrd != 0 && screen_blocks.size() != 0 &&
+                batch[0]->acidxs.size() == 0)
+                skip_nflop = screen_mask(c, skip);
 #pragma omp parallel num_threads(ntop)
             {
                 int tid = threading->get_thread_id();
@@ -1634,6 +1752,8 @@ template <typename FL> struct BatchGEMMSeq {
                 if (batch[0]->acidxs.size() == 0)
 #pragma omp for schedule(static)
                     for (int i = 0; i < (int)batch[0]->c.size(); i++) {
+                        if (skip.size() != 0 && skip[i])
+                            continue;
                         batch[0]->perform_single(i, batch[0]->a[i] + cshift,
                                                  batch[0]->b[i],
                                                  works[tid].data);
@@ -1686,6 +1806,7 @@ template <typename FL> struct BatchGEMMSeq {
             threading->activate_normal();
             cumulative_nflop += batch[0]->nflop;
             cumulative_nflop += batch[1]->nflop;
+            cumulative_nflop -= skip_nflop;
         } else
             assert(false);
     }
@@ -1696,6 +1817,8 @@ template <typename FL> struct BatchGEMMSeq {
         post_batch.clear();
         refs.clear();
         max_rwork = max_work = 0;
+        screen_norms.clear();
+        screen_idx.clear();
     }
     friend ostream &operator<<(ostream &os, const BatchGEMMSeq<FL> &c) {
         os << endl;
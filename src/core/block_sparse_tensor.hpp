@@ -0,0 +1,565 @@
+
+/*
+ * block2: Efficient MPO implementation of quantum chemistry DMRG
+ * Copyright (C) 2020-2021 Huanchen Zhai <hczhai@caltech.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/** Block-sparse tensor with quantum number labels (native backend of
+ * pyblock2.algebra). */
+
+#pragma once
+
+#include "complex_matrix_functions.hpp"
+#include "matrix_functions.hpp"
+#include "threading.hpp"
+#include <algorithm>
+#include <cassert>
+#include <map>
+#include <memory>
+#include <numeric>
+#include <tuple>
+#include <vector>
+
+using namespace std;
+
+namespace block2 {
+
+/** Block-sparse tensor. Each block has one quantum label per rank and
+ * a dense reduced array stored in C order. The semantics follow
+ * ``pyblock2.algebra.core.Tensor``.
+ * @tparam S Quantum label type.
+ * @tparam FL Element type.
+ */
+template <typename S, typename FL> struct BlockSparseTensor {
+    typedef typename GMatrix<FL>::FP FP;
+    vector<vector<S>> q_labels;          //!< Labels of each block.
+    vector<vector<MKL_INT>> shapes;      //!< Shape of each block.
+    vector<shared_ptr<vector<FL>>> data; //!< Data of each block.
+    BlockSparseTensor() {}
+    int rank() const {
+        return q_labels.size() == 0 ? 0 : (int)q_labels[0].size();
+    }
+    size_t n_blocks() const { return q_labels.size(); }
+    size_t size(size_t ib) const {
+        size_t r = 1;
+        for (auto &x : shapes[ib])
+            r *= (size_t)x;
+        return r;
+    }
+    void add_block(const vector<S> &q, const vector<MKL_INT> &shape,
+                   const shared_ptr<vector<FL>> &d = nullptr) {
+        q_labels.push_back(q);
+        shapes.push_back(shape);
+        data.push_back(d != nullptr ? d : make_shared<vector<FL>>(1));
+        if (d == nullptr)
+            data.back()->resize(size(n_blocks() - 1), (FL)0.0);
+        assert(data.back()->size() == size(n_blocks() - 1));
+    }
+    // b[i0, i1, ..] = a[.., i0 at perm[0], ..]
+    static void permute(const FL *a, const vector<MKL_INT> &shape,
+                        const vector<int> &perm, FL *b) {
+        const int nr = (int)shape.size();
+        vector<size_t> sa(nr, 1), sb(nr), idx(nr, 0);
+        vector<MKL_INT> bshape(nr);
+        for (int i = nr - 2; i >= 0; i--)
+            sa[i] = sa[i + 1] * shape[i + 1];
+        size_t n = 1;
+        for (int i = 0; i < nr; i++)
+            sb[i] = sa[perm[i]], bshape[i] = shape[perm[i]], n *= shape[i];
+        if (n == 0)
+            return;
+        if (nr == 0) {
+            b[0] = a[0];
+            return;
+        }
+        const MKL_INT nl = bshape[nr - 1];
+        const size_t sl = sb[nr - 1];
+        for (size_t ib = 0; ib < n; ib += nl) {
+            size_t ia = 0;
+            for (int i = 0; i < nr - 1; i++)
+                ia += idx[i] * sb[i];
+            for (MKL_INT j = 0; j < nl; j++)
+                b[ib + j] = a[ia + j * sl];
+            for (int i = nr - 2; i >= 0; i--)
+                if (++idx[i] == (size_t)bshape[i])
+                    idx[i] = 0;
+                else
+                    break;
+        }
+    }
+    static bool is_identity(const vector<int> &perm) {
+        for (int i = 0; i < (int)perm.size(); i++)
+            if (perm[i] != i)
+                return false;
+        return true;
+    }
+    // fermionic phase of one pair of blocks in contract
+    static bool fermion_phase(const vector<S> &qa, const vector<S> &qb,
+                              const vector<int> &idxa,
+                              const vector<int> &fidxa,
+                              const vector<int> &fidxb) {
+        if (fidxa.size() == 2) {
+            // operator product x two-site state
+            assert(idxa.size() == 2 && fidxb.size() == 1);
+            return (qa[fidxa[0]] + qa[idxa[0]] + qa[fidxa[1]] + qa[idxa[1]])
+                       .is_fermion() &&
+                   qb[fidxb[0]].is_fermion();
+        } else if (fidxa.size() == 1) {
+            assert(idxa.size() == 1);
+            if (fidxb.size() == 2)
+                // operator x operator
+                return qa[fidxa[0]].is_fermion() &&
+                       (qb[fidxb[0]] + qb[fidxb[1]]).is_fermion();
+            else
+                // operator x one-site state
+                return (qa[fidxa[0]] + qa[idxa[0]]).is_fermion() &&
+                       qb[fidxb[0]].is_fermion();
+        }
+        return false;
+    }
+    /** Contract two tensors. Blocks are matched by the quantum labels of
+     * the contracted indices, and the products of all pairs contributing
+     * to the same output block are accumulated by GEMM.
+     * @param a Left operand.
+     * @param b Right operand.
+     * @param idxa Contracted indices in a (can be negative).
+     * @param idxb Contracted indices in b (can be negative).
+     * @param fidxa Empty or indices in a for the fermionic phase.
+     * @param fidxb Empty or indices in b for the fermionic phase.
+     * @param out_trans Empty or permutation of output indices.
+     * @return The contracted tensor. If all indices are contracted, it has
+     *   at most one block of rank zero.
+     */
+    static shared_ptr<BlockSparseTensor>
+    contract(const shared_ptr<BlockSparseTensor> &a,
+             const shared_ptr<BlockSparseTensor> &b, vector<int> idxa,
+             vector<int> idxb, const vector<int> &fidxa = vector<int>(),
+             const vector<int> &fidxb = vector<int>(),
+             const vector<int> &out_trans = vector<int>()) {
+        assert(idxa.size() == idxb.size());
+        const int ra = a->rank(), rb = b->rank(), nc = (int)idxa.size();
+        for (auto &x : idxa)
+            x = x >= 0 ? x : ra + x;
+        for (auto &x : idxb)
+            x = x >= 0 ? x : rb + x;
+        vector<int> outa, outb;
+        for (int i = 0; i < ra; i++)
+            if (find(idxa.begin(), idxa.end(), i) == idxa.end())
+                outa.push_back(i);
+        for (int i = 0; i < rb; i++)
+            if (find(idxb.begin(), idxb.end(), i) == idxb.end())
+                outb.push_back(i);
+        // a as [out, ctr] matrix (or [ctr, out] if ta), b as [ctr, out]
+        vector<int> perma(outa), permb(idxb), tpa(idxa), tpb(outb);
+        perma.insert(perma.end(), idxa.begin(), idxa.end());
+        permb.insert(permb.end(), outb.begin(), outb.end());
+        tpa.insert(tpa.end(), outa.begin(), outa.end());
+        tpb.insert(tpb.end(), idxb.begin(), idxb.end());
+        const bool ta = !is_identity(perma) && is_identity(tpa);
+        const bool tb = !is_identity(permb) && is_identity(tpb);
+        map<vector<S>, vector<int>> map_b;
+        vector<S> q;
+        for (int ib = 0; ib < (int)b->n_blocks(); ib++) {
+            q.resize(nc);
+            for (int i = 0; i < nc; i++)
+                q[i] = b->q_labels[ib][idxb[i]];
+            map_b[q].push_back(ib);
+        }
+        shared_ptr<BlockSparseTensor> r = make_shared<BlockSparseTensor>();
+        map<vector<S>, int> map_out;
+        vector<vector<tuple<int, int, bool>>> tasks;
+        vector<char> used_a(a->n_blocks(), 0), used_b(b->n_blocks(), 0);
+        for (int ia = 0; ia < (int)a->n_blocks(); ia++) {
+            const vector<S> &qa = a->q_labels[ia];
+            q.resize(nc);
+            for (int i = 0; i < nc; i++)
+                q[i] = qa[idxa[i]];
+            auto it = map_b.find(q);
+            if (it == map_b.end())
+                continue;
+            for (int ib : it->second) {
+                const vector<S> &qb = b->q_labels[ib];
+                vector<S> qo;
+                vector<MKL_INT> so;
+                for (int i : outa)
+                    qo.push_back(qa[i]), so.push_back(a->shapes[ia][i]);
+                for (int i : outb)
+                    qo.push_back(qb[i]), so.push_back(b->shapes[ib][i]);
+                auto ito = map_out.find(qo);
+                int io;
+                if (ito == map_out.end()) {
+                    io = map_out[qo] = (int)r->n_blocks();
+                    r->add_block(qo, so);
+                    tasks.push_back(vector<tuple<int, int, bool>>());
+                } else
+                    io = ito->second;
+                tasks[io].push_back(make_tuple(
+                    ia, ib, fermion_phase(qa, qb, idxa, fidxa, fidxb)));
+                used_a[ia] = used_b[ib] = 1;
+            }
+        }
+        int ntg = threading->activate_global();
+        // transposed copies of the operands (if needed)
+        vector<shared_ptr<vector<FL>>> xa(a->n_blocks()), xb(b->n_blocks());
+        const bool pa = !ta && !is_identity(perma);
+        const bool pb = !tb && !is_identity(permb);
+#pragma omp parallel for schedule(dynamic) num_threads(ntg)
+        for (int ix = 0; ix < (int)(a->n_blocks() + b->n_blocks()); ix++) {
+            const bool is_a = ix < (int)a->n_blocks();
+            const int i = is_a ? ix : ix - (int)a->n_blocks();
+            const shared_ptr<BlockSparseTensor> &t = is_a ? a : b;
+            if (!(is_a ? used_a[i] && pa : used_b[i] && pb))
+                continue;
+            shared_ptr<vector<FL>> d = make_shared<vector<FL>>(t->size(i));
+            permute(t->data[i]->data(), t->shapes[i], is_a ? perma : permb,
+                    d->data());
+            (is_a ? xa : xb)[i] = d;
+        }
+#pragma omp parallel for schedule(dynamic) num_threads(ntg)
+        for (int io = 0; io < (int)r->n_blocks(); io++) {
+            for (auto &tk : tasks[io]) {
+                const int ia = get<0>(tk), ib = get<1>(tk);
+                MKL_INT m = 1, n = 1, k = 1;
+                for (int i : outa)
+                    m *= a->shapes[ia][i];
+                for (int i : outb)
+                    n *= b->shapes[ib][i];
+                for (int i : idxa)
+                    k *= a->shapes[ia][i];
+                if (m == 0 || n == 0 || k == 0)
+                    continue;
+                FL *pda = (pa ? xa[ia] : a->data[ia])->data();
+                FL *pdb = (pb ? xb[ib] : b->data[ib])->data();
+                GMatrixFunctions<FL>::multiply(
+                    ta ? GMatrix<FL>(pda, k, m) : GMatrix<FL>(pda, m, k), ta,
+                    tb ? GMatrix<FL>(pdb, n, k) : GMatrix<FL>(pdb, k, n), tb,
+                    GMatrix<FL>(r->data[io]->data(), m, n),
+                    get<2>(tk) ? (FL)-1.0 : (FL)1.0, 1.0);
+            }
+            if (out_trans.size() != 0 && !is_identity(out_trans)) {
+                shared_ptr<vector<FL>> d =
+                    make_shared<vector<FL>>(r->data[io]->size());
+                permute(r->data[io]->data(), r->shapes[io], out_trans,
+                        d->data());
+                vector<S> qo(out_trans.size());
+                vector<MKL_INT> so(out_trans.size());
+                for (int i = 0; i < (int)out_trans.size(); i++)
+                    qo[i] = r->q_labels[io][out_trans[i]],
+                    so[i] = r->shapes[io][out_trans[i]];
+                r->q_labels[io] = qo, r->shapes[io] = so, r->data[io] = d;
+            }
+        }
+        threading->activate_normal();
+        return r;
+    }
+    // blocks grouped by the label at index idx, in the order of appearance
+    vector<pair<S, vector<int>>> collect_blocks(int idx) const {
+        vector<pair<S, vector<int>>> r;
+        map<S, int> mp;
+        for (int ib = 0; ib < (int)n_blocks(); ib++) {
+            const S &q = q_labels[ib][idx >= 0 ? idx : rank() + idx];
+            if (!mp.count(q))
+                mp[q] = (int)r.size(), r.push_back(make_pair(q, vector<int>()));
+            r[mp.at(q)].second.push_back(ib);
+        }
+        return r;
+    }
+    // stack blocks in a group as [sum left, right] or [left, sum right]
+    vector<FL> stack_blocks(const vector<int> &ibs, bool left, MKL_INT &m,
+                            MKL_INT &n, vector<MKL_INT> &offs) const {
+        offs.resize(ibs.size() + 1, 0);
+        for (size_t i = 0; i < ibs.size(); i++) {
+            const vector<MKL_INT> &sh = shapes[ibs[i]];
+            MKL_INT w = 1;
+            for (size_t j = left ? 0 : 1; j < sh.size() - (left ? 1 : 0); j++)
+                w *= sh[j];
+            offs[i + 1] = offs[i] + w;
+        }
+        m = left ? offs.back() : shapes[ibs[0]][0];
+        n = left ? shapes[ibs[0]].back() : offs.back();
+        vector<FL> mat((size_t)m * n);
+        for (size_t i = 0; i < ibs.size(); i++) {
+            const FL *d = data[ibs[i]]->data();
+            const MKL_INT w = offs[i + 1] - offs[i];
+            if (left)
+                memcpy(mat.data() + (size_t)offs[i] * n, d,
+                       sizeof(FL) * w * n);
+            else
+                for (MKL_INT j = 0; j < m; j++)
+                    memcpy(mat.data() + (size_t)j * n + offs[i],
+                           d + (size_t)j * w, sizeof(FL) * w);
+        }
+        return mat;
+    }
+    /** Left canonicalization using QR for each right-index label.
+     * @return Pair of the left canonical tensor and the R matrices
+     *   as a rank-2 tensor with labels (q_r, q_r).
+     */
+    pair<shared_ptr<BlockSparseTensor>, shared_ptr<BlockSparseTensor>>
+    left_canonicalize() const {
+        return canonicalize(true);
+    }
+    /** Right canonicalization using LQ for each left-index label.
+     * @return Pair of the right canonical tensor and the L matrices
+     *   as a rank-2 tensor with labels (q_l, q_l).
+     */
+    pair<shared_ptr<BlockSparseTensor>, shared_ptr<BlockSparseTensor>>
+    right_canonicalize() const {
+        return canonicalize(false);
+    }
+    pair<shared_ptr<BlockSparseTensor>, shared_ptr<BlockSparseTensor>>
+    canonicalize(bool left) const {
+        vector<pair<S, vector<int>>> groups = collect_blocks(left ? -1 : 0);
+        shared_ptr<BlockSparseTensor> r = make_shared<BlockSparseTensor>();
+        shared_ptr<BlockSparseTensor> x = make_shared<BlockSparseTensor>();
+        *r = *this;
+        for (auto &g : groups)
+            x->add_block(vector<S>{g.first, g.first}, vector<MKL_INT>{0, 0});
+        int ntg = threading->activate_global();
+#pragma omp parallel for schedule(dynamic) num_threads(ntg)
+        for (int ig = 0; ig < (int)groups.size(); ig++) {
+            const vector<int> &ibs = groups[ig].second;
+            MKL_INT m, n;
+            vector<MKL_INT> offs;
+            vector<FL> mat = stack_blocks(ibs, left, m, n, offs);
+            const MKL_INT k = min(m, n);
+            vector<FL> q((size_t)(left ? m : n) * k);
+            shared_ptr<vector<FL>> xr =
+                make_shared<vector<FL>>((size_t)(left ? n : m) * k);
+            if (k != 0 && left)
+                GMatrixFunctions<FL>::qr(GMatrix<FL>(mat.data(), m, n),
+                                         GMatrix<FL>(q.data(), m, k),
+                                         GMatrix<FL>(xr->data(), k, n));
+            else if (k != 0)
+                GMatrixFunctions<FL>::lq(GMatrix<FL>(mat.data(), m, n),
+                                         GMatrix<FL>(xr->data(), m, k),
+                                         GMatrix<FL>(q.data(), k, n));
+            x->shapes[ig] = left ? vector<MKL_INT>{k, n}
+                                 : vector<MKL_INT>{m, k};
+            x->data[ig] = xr;
+            for (size_t i = 0; i < ibs.size(); i++) {
+                const MKL_INT w = offs[i + 1] - offs[i];
+                shared_ptr<vector<FL>> d =
+                    make_shared<vector<FL>>((size_t)w * k);
+                if (left)
+                    memcpy(d->data(), q.data() + (size_t)offs[i] * k,
+                           sizeof(FL) * w * k);
+                else
+                    for (MKL_INT j = 0; j < k; j++)
+                        memcpy(d->data() + (size_t)j * w,
+                               q.data() + (size_t)j * n + offs[i],
+                               sizeof(FL) * w);
+                r->data[ibs[i]] = d;
+                (left ? r->shapes[ibs[i]].back() : r->shapes[ibs[i]][0]) = k;
+            }
+        }
+        threading->activate_normal();
+        return make_pair(r, x);
+    }
+    /** Multiply matrices from the left (left == true) or right to each
+     * block. Blocks without a matching matrix are dropped.
+     * @param mats Rank-2 tensor of matrices, labeled (q, q).
+     */
+    shared_ptr<BlockSparseTensor>
+    multiply(const shared_ptr<BlockSparseTensor> &mats, bool left) const {
+        map<S, int> mp;
+        for (int im = 0; im < (int)mats->n_blocks(); im++)
+            mp[mats->q_labels[im][0]] = im;
+        shared_ptr<BlockSparseTensor> r = make_shared<BlockSparseTensor>();
+        vector<int> ims;
+        for (int ib = 0; ib < (int)n_blocks(); ib++) {
+            auto it = mp.find(q_labels[ib][left ? 0 : rank() - 1]);
+            if (it == mp.end())
+                continue;
+            vector<MKL_INT> sh = shapes[ib];
+            if (left)
+                sh[0] = mats->shapes[it->second][0];
+            else
+                sh.back() = mats->shapes[it->second][1];
+            r->add_block(q_labels[ib], sh);
+            ims.push_back(ib), ims.push_back(it->second);
+        }
+        int ntg = threading->activate_global();
+#pragma omp parallel for schedule(dynamic) num_threads(ntg)
+        for (int i = 0; i < (int)r->n_blocks(); i++) {
+            const int ib = ims[i * 2], im = ims[i * 2 + 1];
+            const MKL_INT p = mats->shapes[im][0], q = mats->shapes[im][1];
+            const MKL_INT x = left ? shapes[ib][0] : shapes[ib].back();
+            if (p == 0 || q == 0 || x == 0 || size(ib) == 0)
+                continue;
+            const MKL_INT w = (MKL_INT)(size(ib) / x);
+            GMatrix<FL> mat(mats->data[im]->data(), p, q);
+            if (left)
+                GMatrixFunctions<FL>::multiply(
+                    mat, false, GMatrix<FL>(data[ib]->data(), q, w), false,
+                    GMatrix<FL>(r->data[i]->data(), p, w), 1.0, 0.0);
+            else
+                GMatrixFunctions<FL>::multiply(
+                    GMatrix<FL>(data[ib]->data(), w, p), false, mat, false,
+                    GMatrix<FL>(r->data[i]->data(), w, q), 1.0, 0.0);
+        }
+        threading->activate_normal();
+        return r;
+    }
+    shared_ptr<BlockSparseTensor>
+    left_multiply(const shared_ptr<BlockSparseTensor> &mats) const {
+        return multiply(mats, true);
+    }
+    shared_ptr<BlockSparseTensor>
+    right_multiply(const shared_ptr<BlockSparseTensor> &mats) const {
+        return multiply(mats, false);
+    }
+    /** Select kept singular values among all labels.
+     * @param svd_s Singular values for each label.
+     * @param k Maximal total bond dimension (-1 for no restriction).
+     * @param cutoff Minimal kept singular value.
+     * @param gls (output) Kept indices for each label.
+     * @return Truncation error (same unit as singular value).
+     */
+    static FP truncate_singular_values(const vector<vector<FP>> &svd_s,
+                                       int k, FP cutoff,
+                                       vector<vector<int>> &gls) {
+        vector<pair<int, int>> ss;
+        for (int i = 0; i < (int)svd_s.size(); i++)
+            for (int j = 0; j < (int)svd_s[i].size(); j++)
+                ss.push_back(make_pair(i, j));
+        stable_sort(ss.begin(), ss.end(),
+                    [&svd_s](const pair<int, int> &a,
+                             const pair<int, int> &b) {
+                        return svd_s[a.first][a.second] >
+                               svd_s[b.first][b.second];
+                    });
+        size_t nk = 0;
+        while (nk < ss.size() && svd_s[ss[nk].first][ss[nk].second] >= cutoff)
+            nk++;
+        if (k != -1)
+            nk = min(nk, (size_t)k);
+        sort(ss.begin(), ss.begin() + nk);
+        gls.assign(svd_s.size(), vector<int>());
+        for (size_t i = 0; i < nk; i++)
+            gls[ss[i].first].push_back(ss[i].second);
+        FP error = 0.0;
+        for (size_t i = nk; i < ss.size(); i++)
+            error += svd_s[ss[i].first][ss[i].second] *
+                     svd_s[ss[i].first][ss[i].second];
+        return sqrt(error);
+    }
+    /** Left (left == true) or right compression using SVD. The rightmost
+     * (or leftmost) bond is truncated.
+     * @param k Maximal total bond dimension (-1 for no restriction).
+     * @param cutoff Minimal kept singular value.
+     * @param sv_on_l Whether singular values are merged to the left part.
+     *   Singular values always go to the matrices in left compression.
+     * @return The compressed tensor, the rank-2 tensor of the other part
+     *   of the decomposition, and the truncation error.
+     */
+    tuple<shared_ptr<BlockSparseTensor>, shared_ptr<BlockSparseTensor>, FP>
+    compress(bool left, int k = -1, FP cutoff = 0.0,
+             bool sv_on_l = true) const {
+        vector<pair<S, vector<int>>> groups = collect_blocks(left ? -1 : 0);
+        const int ng = (int)groups.size();
+        vector<vector<FL>> us(ng), vts(ng);
+        vector<vector<FP>> svd_s(ng);
+        vector<MKL_INT> ms(ng), ns(ng);
+        vector<vector<MKL_INT>> offs(ng);
+        int ntg = threading->activate_global();
+#pragma omp parallel for schedule(dynamic) num_threads(ntg)
+        for (int ig = 0; ig < ng; ig++) {
+            MKL_INT &m = ms[ig], &n = ns[ig];
+            vector<FL> mat =
+                stack_blocks(groups[ig].second, left, m, n, offs[ig]);
+            const MKL_INT kk = min(m, n);
+            us[ig].resize((size_t)m * kk);
+            vts[ig].resize((size_t)kk * n);
+            svd_s[ig].resize(kk);
+            if (kk != 0)
+                GMatrixFunctions<FL>::svd(GMatrix<FL>(mat.data(), m, n),
+                                          GMatrix<FL>(us[ig].data(), m, kk),
+                                          GMatrix<FP>(svd_s[ig].data(), 1, kk),
+                                          GMatrix<FL>(vts[ig].data(), kk, n));
+        }
+        threading->activate_normal();
+        vector<vector<int>> gls;
+        FP error = truncate_singular_values(svd_s, k, cutoff, gls);
+        shared_ptr<BlockSparseTensor> r = make_shared<BlockSparseTensor>();
+        shared_ptr<BlockSparseTensor> x = make_shared<BlockSparseTensor>();
+        for (int ig = 0; ig < ng; ig++) {
+            const vector<int> &gl = gls[ig], &ibs = groups[ig].second;
+            const MKL_INT m = ms[ig], n = ns[ig], kk = min(m, n);
+            const MKL_INT nk = (MKL_INT)gl.size();
+            if (nk == 0)
+                continue;
+            const vector<FL> &u = us[ig], &vt = vts[ig];
+            const vector<FP> &s = svd_s[ig];
+            // kept columns of u and rows of vt
+            shared_ptr<vector<FL>> xu =
+                make_shared<vector<FL>>((size_t)m * nk);
+            shared_ptr<vector<FL>> xvt =
+                make_shared<vector<FL>>((size_t)nk * n);
+            for (MKL_INT i = 0; i < m; i++)
+                for (MKL_INT j = 0; j < nk; j++)
+                    (*xu)[i * nk + j] = u[(size_t)i * kk + gl[j]];
+            for (MKL_INT j = 0; j < nk; j++)
+                for (MKL_INT i = 0; i < n; i++)
+                    (*xvt)[(size_t)j * n + i] = vt[(size_t)gl[j] * n + i];
+            const bool sv_on_u = left ? false : sv_on_l;
+            const bool sv_on_vt = left ? true : !sv_on_l;
+            if (sv_on_u)
+                for (MKL_INT i = 0; i < m; i++)
+                    for (MKL_INT j = 0; j < nk; j++)
+                        (*xu)[i * nk + j] *= s[gl[j]];
+            if (sv_on_vt)
+                for (MKL_INT j = 0; j < nk; j++)
+                    for (MKL_INT i = 0; i < n; i++)
+                        (*xvt)[(size_t)j * n + i] *= s[gl[j]];
+            for (size_t i = 0; i < ibs.size(); i++) {
+                const MKL_INT w = offs[ig][i + 1] - offs[ig][i];
+                vector<MKL_INT> sh = shapes[ibs[i]];
+                shared_ptr<vector<FL>> d =
+                    make_shared<vector<FL>>((size_t)w * nk);
+                if (left) {
+                    sh.back() = nk;
+                    memcpy(d->data(), xu->data() + (size_t)offs[ig][i] * nk,
+                           sizeof(FL) * w * nk);
+                } else {
+                    sh[0] = nk;
+                    for (MKL_INT j = 0; j < nk; j++)
+                        memcpy(d->data() + (size_t)j * w,
+                               xvt->data() + (size_t)j * n + offs[ig][i],
+                               sizeof(FL) * w);
+                }
+                r->add_block(q_labels[ibs[i]], sh, d);
+            }
+            const S &q = groups[ig].first;
+            if (left)
+                x->add_block(vector<S>{q, q}, vector<MKL_INT>{nk, n}, xvt);
+            else
+                x->add_block(vector<S>{q, q}, vector<MKL_INT>{m, nk}, xu);
+        }
+        return make_tuple(r, x, error);
+    }
+    tuple<shared_ptr<BlockSparseTensor>, shared_ptr<BlockSparseTensor>, FP>
+    left_compress(int k = -1, FP cutoff = 0.0) const {
+        return compress(true, k, cutoff);
+    }
+    tuple<shared_ptr<BlockSparseTensor>, shared_ptr<BlockSparseTensor>, FP>
+    right_compress(int k = -1, FP cutoff = 0.0, bool sv_on_l = true) const {
+        return compress(false, k, cutoff, sv_on_l);
+    }
+};
+
+} // namespace block2
@@ -161,6 +161,13 @@ extern VRETT LFNAME(cheev)(const char *jobz, const char *uplo, const MKL_INT *n,
                            complex<float> *work, const MKL_INT *lwork,
                            float *rwork, MKL_INT *info);
 
+extern VRETT LFNAME(cheevd)(const char *jobz, const char *uplo,
+                            const MKL_INT *n, complex<float> *a,
+                            const MKL_INT *lda, float *w, complex<float> *work,
+                            const MKL_INT *lwork, float *rwork,
+                            const MKL_INT *lrwork, MKL_INT *iwork,
+                            const MKL_INT *liwork, MKL_INT *info);
+
 // SVD
 // mat [a] = mat [u] * vector [sigma] * mat [vt]
 extern VRETT LFNAME(cgesvd)(const char *jobu, const char *jobvt,
@@ -171,6 +178,15 @@ extern VRETT LFNAME(cgesvd)(const char *jobu, const char *jobvt,
                             complex<float> *work, const MKL_INT *lwork,
                             float *rwork, MKL_INT *info);
 
+// SVD (divide-and-conquer)
+extern VRETT LFNAME(cgesdd)(const char *jobz, const MKL_INT *m,
+                            const MKL_INT *n, complex<float> *a,
+                            const MKL_INT *lda, float *s, complex<float> *u,
+                            const MKL_INT *ldu, complex<float> *vt,
+                            const MKL_INT *ldvt, complex<float> *work,
+                            const MKL_INT *lwork, float *rwork, MKL_INT *iwork,
+                            MKL_INT *info);
+
 // vector scale
 // vector [sx] = double [sa] * vector [sx]
 extern VRETT FNAME(zdscal)(const MKL_INT *n, const double *sa,
@@ -301,6 +317,14 @@ extern VRETT LFNAME(zheev)(const char *jobz, const char *uplo, const MKL_INT *n,
                            complex<double> *work, const MKL_INT *lwork,
                            double *rwork, MKL_INT *info);
 
+extern VRETT LFNAME(zheevd)(const char *jobz, const char *uplo,
+                            const MKL_INT *n, complex<double> *a,
+                            const MKL_INT *lda, double *w,
+                            complex<double> *work, const MKL_INT *lwork,
+                            double *rwork, const MKL_INT *lrwork,
+                            MKL_INT *iwork, const MKL_INT *liwork,
+                            MKL_INT *info);
+
 // SVD
 // mat [a] = mat [u] * vector [sigma] * mat [vt]
 extern VRETT LFNAME(zgesvd)(const char *jobu, const char *jobvt,
@@ -311,6 +335,15 @@ extern VRETT LFNAME(zgesvd)(const char *jobu, const char *jobvt,
                             complex<double> *work, const MKL_INT *lwork,
                             double *rwork, MKL_INT *info);
 
+// SVD (divide-and-conquer)
+extern VRETT LFNAME(zgesdd)(const char *jobz, const MKL_INT *m,
+                            const MKL_INT *n, complex<double> *a,
+                            const MKL_INT *lda, double *s, complex<double> *u,
+                            const MKL_INT *ldu, complex<double> *vt,
+                            const MKL_INT *ldvt, complex<double> *work,
+                            const MKL_INT *lwork, double *rwork, MKL_INT *iwork,
+                            MKL_INT *info);
+
 #endif
 }
 
@@ -616,6 +649,35 @@ inline void xgesvd(const char *jobu, const char *jobvt, const MKL_INT *m,
      info);
 }
 
+template <>
+inline void xgesdd(const char *jobz, const MKL_INT *m, const MKL_INT *n,
+                   complex<float> *a, const MKL_INT *lda, float *s,
+                   complex<float> *u, const MKL_INT *ldu, complex<float> *vt,
+                   const MKL_INT *ldvt, complex<float> *work,
+                   const MKL_INT *lwork, MKL_INT *iwork, MKL_INT *info) {
+    const MKL_INT mn = min(*m, *n), mx = max(*m, *n);
+    const MKL_INT lrwork = max(mn * max(5 * mn + 7, 2 * mx + 2 * mn + 1),
+                               (MKL_INT)1);
+    vector<float> rwork((size_t)lrwork);
+    LFNAME(cgesdd)
+    (jobz, m, n, a, lda, s, u, ldu, vt, ldvt, work, lwork, rwork.data(), iwork,
+     info);
+}
+template <>
+inline void xgesdd(const char *jobz, const MKL_INT *m, const MKL_INT *n,
+                   complex<double> *a, const MKL_INT *lda, double *s,
+                   complex<double> *u, const MKL_INT *ldu, complex<double> *vt,
+                   const MKL_INT *ldvt, complex<double> *work,
+                   const MKL_INT *lwork, MKL_INT *iwork, MKL_INT *info) {
+    const MKL_INT mn = min(*m, *n), mx = max(*m, *n);
+    const MKL_INT lrwork = max(mn * max(5 * mn + 7, 2 * mx + 2 * mn + 1),
+                               (MKL_INT)1);
+    vector<double> rwork((size_t)lrwork);
+    LFNAME(zgesdd)
+    (jobz, m, n, a, lda, s, u, ldu, vt, ldvt, work, lwork, rwork.data(), iwork,
+     info);
+}
+
 template <>
 inline void xgesv(const MKL_INT *n, const MKL_INT *nrhs, complex<float> *a,
                   const MKL_INT *lda, MKL_INT *ipiv, complex<float> *b,
@@ -646,6 +708,26 @@ inline void xheev(const char *jobz, const char *uplo, const MKL_INT *n,
     LFNAME(zheev)(jobz, uplo, n, a, lda, w, work, lwork, rwork, info);
 }
 
+template <>
+inline void xheevd(const char *jobz, const char *uplo, const MKL_INT *n,
+                   complex<float> *a, const MKL_INT *lda, float *w,
+                   complex<float> *work, const MKL_INT *lwork, float *rwork,
+                   const MKL_INT *lrwork, MKL_INT *iwork, const MKL_INT *liwork,
+                   MKL_INT *info) {
+    LFNAME(cheevd)
+    (jobz, uplo, n, a, lda, w, work, lwork, rwork, lrwork, iwork, liwork, info);
+}
+
+template <>
+inline void xheevd(const char *jobz, const char *uplo, const MKL_INT *n,
+                   complex<double> *a, const MKL_INT *lda, double *w,
+                   complex<double> *work, const MKL_INT *lwork, double *rwork,
+                   const MKL_INT *lrwork, MKL_INT *iwork, const MKL_INT *liwork,
+                   MKL_INT *info) {
+    LFNAME(zheevd)
+    (jobz, uplo, n, a, lda, w, work, lwork, rwork, lrwork, iwork, liwork, info);
+}
+
 template <>
 inline void xhegv(const MKL_INT *itype, const char *jobz, const char *uplo,
                   const MKL_INT *n, complex<float> *a, const MKL_INT *lda,
@@ -1534,6 +1616,28 @@ struct GMatrixFunctions<FL, typename enable_if<is_complex<FL>::value>::type> {
         assert(info == 0);
         d_alloc->complex_deallocate(work, lwork);
     }
+    // SVD using divide-and-conquer driver; original matrix will be destroyed
+    static void svd_dc(const GMatrix<FL> &a, const GMatrix<FL> &l,
+                       const GMatrix<FP> &s, const GMatrix<FL> &r) {
+        shared_ptr<VectorAllocator<FP>> d_alloc =
+            make_shared<VectorAllocator<FP>>();
+        shared_ptr<VectorAllocator<MKL_INT>> i_alloc =
+            make_shared<VectorAllocator<MKL_INT>>();
+        MKL_INT k = min(a.m, a.n), info = 0, lwork = -1;
+        FL twork;
+        assert(a.m == l.m && a.n <= r.n && l.n >= k && r.m == k && s.n == k);
+        MKL_INT *iwork = i_alloc->allocate(8 * k);
+        xgesdd<FL>("S", &a.n, &a.m, a.data, &a.n, s.data, r.data, &r.n,
+                   l.data, &l.n, &twork, &lwork, iwork, &info);
+        assert(info == 0);
+        lwork = (MKL_INT)xreal<FL>(twork);
+        FL *work = d_alloc->complex_allocate(lwork);
+        xgesdd<FL>("S", &a.n, &a.m, a.data, &a.n, s.data, r.data, &r.n,
+                   l.data, &l.n, work, &lwork, iwork, &info);
+        assert(info == 0);
+        d_alloc->complex_deallocate(work, lwork);
+        i_alloc->deallocate(iwork, 8 * k);
+    }
     // Rank revealing QR; original matrix will be destroyed
     static void rrqr(const GMatrix<FL> &a, const GMatrix<FL> &l,
                      const GMatrix<FP> &s, const GMatrix<FL> &r) {
@@ -1826,6 +1930,36 @@ struct GMatrixFunctions<FL, typename enable_if<is_complex<FL>::value>::type> {
         d_alloc->complex_deallocate(work, lwork);
         d_alloc->deallocate(rwork, max((MKL_INT)1, 3 * a.n - 2));
     }
+    // eigenvectors are row right vectors (divide-and-conquer driver)
+    static void eigs_dc(const GMatrix<FL> &a, const GDiagonalMatrix<FP> &w) {
+        shared_ptr<VectorAllocator<FP>> d_alloc =
+            make_shared<VectorAllocator<FP>>();
+        shared_ptr<VectorAllocator<MKL_INT>> i_alloc =
+            make_shared<VectorAllocator<MKL_INT>>();
+        assert(a.m == a.n && w.n == a.n);
+        const FP scale = -1.0;
+        MKL_INT lwork = -1, lrwork = -1, liwork = -1, n = a.m * a.n, incx = 2;
+        MKL_INT info, tiwork;
+        FL twork;
+        FP trwork;
+        xheevd<FL>("V", "U", &a.n, a.data, &a.n, w.data, &twork, &lwork,
+                   &trwork, &lrwork, &tiwork, &liwork, &info);
+        assert(info == 0);
+        lwork = (MKL_INT)xreal<FL>(twork), lrwork = (MKL_INT)trwork;
+        liwork = tiwork;
+        FL *work = d_alloc->complex_allocate(lwork);
+        FP *rwork = d_alloc->allocate(lrwork);
+        MKL_INT *iwork = i_alloc->allocate(liwork);
+        xheevd<FL>("V", "U", &a.n, a.data, &a.n, w.data, work, &lwork, rwork,
+                   &lrwork, iwork, &liwork, &info);
+        assert((size_t)a.m * a.n == n);
+        xscal<FP>(&n, &scale, (FP *)a.data + 1, &incx);
+        if (info != 0)
+            cout << "ATTENTION: xheevd info = " << info << endl;
+        i_alloc->deallocate(iwork, liwork);
+        d_alloc->deallocate(rwork, lrwork);
+        d_alloc->complex_deallocate(work, lwork);
+    }
     // z = r / aa
     static void cg_precondition(const GMatrix<FL> &z, const GMatrix<FL> &r,
                                 const GDiagonalMatrix<FL> &aa) {
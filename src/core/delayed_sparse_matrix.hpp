@@ -117,4 +117,137 @@ struct DelayedSparseMatrix<S, FL, OpExpr<S>> : DelayedSparseMatrix<S, FL> {
     }
 };
 
+// Basis of a low-rank factorized block of operators
+// sharing the same SparseMatrixInfo (rank x size flat array)
+template <typename FL> struct LowRankBasis {
+    FL *data;
+    int rank;
+    size_t size;
+    LowRankBasis(FL *data, int rank, size_t size)
+        : data(data), rank(rank), size(size) {}
+};
+
+// Operator as a linear combination of low-rank basis
+// (for compressed complementary operators in renormalized blocks)
+// The basis is real-linear: complex data is treated as a real array
+// The memory of the basis is attached to one (owner) matrix in the block
+template <typename S, typename FL>
+struct DelayedSparseMatrix<S, FL, LowRankBasis<FL>>
+    : DelayedSparseMatrix<S, FL> {
+    typedef typename GMatrix<FL>::FP FP;
+    using SparseMatrix<S, FL>::cpx_sz;
+    shared_ptr<LowRankBasis<FL>> basis;
+    vector<FP> coeffs;
+    bool owner;
+    DelayedSparseMatrix(
+        const shared_ptr<LowRankBasis<FL>> &basis = nullptr,
+        const vector<FP> &coeffs = vector<FP>(),
+        const shared_ptr<SparseMatrixInfo<S>> &info = nullptr,
+        bool owner = false)
+        : DelayedSparseMatrix<S, FL>(), basis(basis), coeffs(coeffs),
+          owner(owner) {
+        this->info = info;
+    }
+    void deallocate() override {
+        if (owner)
+            SparseMatrix<S, FL>::deallocate();
+    }
+    void load_data(istream &ifs, bool pointer_only = false) override {
+        int rank;
+        size_t size;
+        ifs.read((char *)&this->factor, sizeof(this->factor));
+        ifs.read((char *)&owner, sizeof(owner));
+        ifs.read((char *)&rank, sizeof(rank));
+        ifs.read((char *)&size, sizeof(size));
+        coeffs.resize(rank);
+        ifs.read((char *)coeffs.data(), sizeof(FP) * rank);
+        FL *ptr = nullptr;
+        if (rank != 0 && pointer_only) {
+            size_t psz;
+            ifs.read((char *)&psz, sizeof(psz));
+            ptr = (FL *)(dalloc_<FP>()->data + psz);
+        } else if (rank != 0) {
+            // without pointer sharing every matrix keeps its own basis
+            if (this->alloc == nullptr)
+                this->alloc = dalloc_<FP>();
+            ptr = (FL *)this->alloc->allocate(rank * size * cpx_sz);
+            ifs.read((char *)ptr, sizeof(FL) * rank * size);
+            owner = true;
+        }
+        basis = make_shared<LowRankBasis<FL>>(ptr, rank, size);
+        if (owner)
+            this->data = ptr, this->total_memory = rank * size;
+    }
+    void save_data(ostream &ofs, bool pointer_only = false) const override {
+        ofs.write((char *)&this->factor, sizeof(this->factor));
+        ofs.write((char *)&owner, sizeof(owner));
+        ofs.write((char *)&basis->rank, sizeof(basis->rank));
+        ofs.write((char *)&basis->size, sizeof(basis->size));
+        ofs.write((char *)coeffs.data(), sizeof(FP) * basis->rank);
+        if (basis->rank != 0 && pointer_only) {
+            size_t psz = (FP *)basis->data - dalloc_<FP>()->data;
+            ofs.write((char *)&psz, sizeof(psz));
+        } else if (basis->rank != 0)
+            ofs.write((char *)basis->data,
+                      sizeof(FL) * basis->rank * basis->size);
+    }
+    shared_ptr<SparseMatrix<S, FL>> build() override {
+        shared_ptr<SparseMatrix<S, FL>> rmat =
+            make_shared<SparseMatrix<S, FL>>();
+        rmat->allocate(this->info);
+        assert(rmat->total_memory == basis->size);
+        const MKL_INT n = (MKL_INT)(basis->size * cpx_sz);
+        GMatrix<FP> r((FP *)rmat->data, n, 1);
+        for (int k = 0; k < basis->rank; k++)
+            if (coeffs[k] != (FP)0.0)
+                GMatrixFunctions<FP>::iadd(
+                    r, GMatrix<FP>((FP *)basis->data + (size_t)k * n, n, 1),
+                    coeffs[k]);
+        rmat->factor = this->factor;
+        return rmat;
+    }
+    // basis vectors are orthogonal
+    FP norm() const override {
+        const MKL_INT n = (MKL_INT)(basis->size * cpx_sz);
+        FP r = 0;
+        for (int k = 0; k < basis->rank; k++) {
+            FP x = coeffs[k] * GMatrixFunctions<FP>::norm(GMatrix<FP>(
+                                   (FP *)basis->data + (size_t)k * n, n, 1));
+            r += x * x;
+        }
+        return sqrt(r);
+    }
+    shared_ptr<DelayedSparseMatrix<S, FL>> copy() override {
+        shared_ptr<DelayedSparseMatrix> mat = make_shared<DelayedSparseMatrix>(
+            basis, coeffs, this->info, false);
+        mat->factor = this->factor;
+        return mat;
+    }
+    // copy of the owner matrix with the basis copied into new memory
+    shared_ptr<DelayedSparseMatrix>
+    copy_with_basis(const shared_ptr<Allocator<FP>> &alloc) const {
+        assert(owner);
+        shared_ptr<DelayedSparseMatrix> mat = make_shared<DelayedSparseMatrix>(
+            nullptr, coeffs, this->info, true);
+        mat->factor = this->factor;
+        mat->alloc = alloc == nullptr ? dalloc_<FP>() : alloc;
+        FL *ptr = nullptr;
+        if (basis->rank != 0) {
+            ptr = (FL *)mat->alloc->allocate(basis->rank * basis->size *
+                                             cpx_sz);
+            memcpy(ptr, basis->data, sizeof(FL) * basis->rank * basis->size);
+        }
+        mat->basis =
+            make_shared<LowRankBasis<FL>>(ptr, basis->rank, basis->size);
+        mat->data = ptr, mat->total_memory = basis->rank * basis->size;
+        return mat;
+    }
+    shared_ptr<DelayedSparseMatrix<S, FL>>
+    selective_copy(const shared_ptr<SparseMatrixInfo<S>> &info) override {
+        // only renormalized operators are factorized
+        assert(false);
+        return nullptr;
+    }
+};
+
 } // namespace block2
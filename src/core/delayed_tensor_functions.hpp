@@ -30,14 +30,170 @@ namespace block2 {
 // Operations for operator tensors
 template <typename S, typename FL>
 struct DelayedTensorFunctions : TensorFunctions<S, FL> {
+    typedef typename GMatrix<FL>::FP FP;
     using TensorFunctions<S, FL>::opf;
+    // Max discarded squared norm for the low-rank factorization of
+    // each symmetry block of renormalized operators (0 = no factorization)
+    FP low_rank_cutoff = 0;
+    // Names of renormalized operators that can be factorized
+    OpNamesSet low_rank_ops = OpNamesSet({OpNames::P, OpNames::PD, OpNames::Q,
+                                          OpNames::R, OpNames::RD});
     DelayedTensorFunctions(const shared_ptr<OperatorFunctions<S, FL>> &opf)
         : TensorFunctions<S, FL>(opf) {}
     TensorFunctionsTypes get_type() const override {
         return TensorFunctionsTypes::Delayed;
     }
     shared_ptr<TensorFunctions<S, FL>> copy() const override {
-        return make_shared<DelayedTensorFunctions<S, FL>>(opf->copy());
+        shared_ptr<DelayedTensorFunctions<S, FL>> tf =
+            make_shared<DelayedTensorFunctions<S, FL>>(opf->copy());
+        tf->low_rank_cutoff = low_rank_cutoff;
+        tf->low_rank_ops = low_rank_ops;
+        return tf;
+    }
+    // Low-rank factorization of rotated operators in c with the same
+    // SparseMatrixInfo, using eigenvectors U of the gram matrix:
+    //   O_i = sum_k U[k, i] B_k,  B_k = sum_i U[k, i] O_i
+    // Factorized operators are replaced by delayed operators
+    // and the stack memory is compacted. This must be called when the
+    // operators in c are the last allocated ones in the current frame.
+    // Returns (original size, compressed size, discarded squared norm)
+    tuple<size_t, size_t, FP>
+    low_rank_compress(const shared_ptr<OperatorTensor<S, FL>> &c) const {
+        const int cpx_sz = sizeof(FL) / sizeof(FP);
+        const size_t org_mem = c->get_total_memory();
+        tuple<size_t, size_t, FP> r = make_tuple(org_mem, org_mem, (FP)0.0);
+        if (low_rank_cutoff <= (FP)0.0)
+            return r;
+        const shared_ptr<StackAllocator<FP>> &d_alloc = dalloc_<FP>();
+        // operators in stack memory, in the order of allocation
+        vector<pair<shared_ptr<OpExpr<S>>, shared_ptr<SparseMatrix<S, FL>>>>
+            mp;
+        for (auto &p : c->ops)
+            if (p.second->get_type() == SparseMatrixTypes::Normal &&
+                p.second->total_memory != 0 && p.second->alloc == d_alloc)
+                mp.push_back(make_pair(p.first, p.second));
+        sort(mp.begin(), mp.end(),
+             [](const pair<shared_ptr<OpExpr<S>>,
+                           shared_ptr<SparseMatrix<S, FL>>> &a,
+                const pair<shared_ptr<OpExpr<S>>,
+                           shared_ptr<SparseMatrix<S, FL>>> &b) {
+                 return a.second->data < b.second->data;
+             });
+        auto aligned = [](size_t n) {
+            if (threading->align_type != AlignTypes::None) {
+                const size_t xalign =
+                    (uint8_t)threading->align_type / sizeof(FP);
+                n = (n + xalign - 1) / xalign * xalign;
+            }
+            return n;
+        };
+        // stack memory must be released in reverse order
+        size_t top = d_alloc->used;
+        for (auto it = mp.rbegin(); it != mp.rend(); it++) {
+            const size_t n = aligned(it->second->total_memory * cpx_sz);
+            if (top < n || (FP *)it->second->data != d_alloc->data + top - n)
+                return r;
+            top -= n;
+        }
+        // group operators by SparseMatrixInfo
+        vector<vector<size_t>> groups;
+        unordered_map<SparseMatrixInfo<S> *, size_t> gmp;
+        for (size_t i = 0; i < mp.size(); i++) {
+            shared_ptr<OpElement<S, FL>> op =
+                dynamic_pointer_cast<OpElement<S, FL>>(mp[i].first);
+            if (op == nullptr || !low_rank_ops(op->name))
+                continue;
+            if (!gmp.count(mp[i].second->info.get())) {
+                gmp[mp[i].second->info.get()] = groups.size();
+                groups.push_back(vector<size_t>());
+            }
+            groups[gmp.at(mp[i].second->info.get())].push_back(i);
+        }
+        vector<int> ranks(groups.size(), -1);
+        vector<vector<FP>> bases(groups.size()), coeffs(groups.size());
+        vector<uint8_t> compressed(mp.size(), 0);
+        size_t ig0 = mp.size();
+        FP dw = 0;
+        for (size_t ig = 0; ig < groups.size(); ig++) {
+            const vector<size_t> &g = groups[ig];
+            const MKL_INT m = (MKL_INT)g.size();
+            const MKL_INT n =
+                (MKL_INT)(mp[g[0]].second->total_memory * cpx_sz);
+            if (m < 2)
+                continue;
+            vector<FP> amat((size_t)m * n), gmat((size_t)m * m);
+            vector<FP> w(m);
+            for (MKL_INT i = 0; i < m; i++)
+                memcpy(amat.data() + (size_t)i * n, mp[g[i]].second->data,
+                       sizeof(FP) * n);
+            GMatrix<FP> xa(amat.data(), m, n), xg(gmat.data(), m, m);
+            GMatrixFunctions<FP>::multiply(xa, false, xa, true, xg, 1.0, 0.0);
+            // eigenvalues in ascending order
+            GMatrixFunctions<FP>::eigs(xg, GDiagonalMatrix<FP>(w.data(), m));
+            MKL_INT nd = 0;
+            FP gdw = 0;
+            for (; nd < m && gdw + max(w[nd], (FP)0.0) <= low_rank_cutoff;
+                 nd++)
+                gdw += max(w[nd], (FP)0.0);
+            const MKL_INT rk = m - nd;
+            if (rk == m)
+                continue;
+            ranks[ig] = (int)rk, dw += gdw;
+            bases[ig].resize((size_t)rk * n);
+            coeffs[ig].resize((size_t)rk * m);
+            if (rk != 0)
+                GMatrixFunctions<FP>::multiply(
+                    GMatrix<FP>(gmat.data() + (size_t)nd * m, rk, m), false,
+                    xa, false, GMatrix<FP>(bases[ig].data(), rk, n), 1.0,
+                    0.0);
+            memcpy(coeffs[ig].data(), gmat.data() + (size_t)nd * m,
+                   sizeof(FP) * rk * m);
+            for (size_t i : g)
+                compressed[i] = 1, ig0 = min(ig0, i);
+        }
+        if (ig0 == mp.size())
+            return r;
+        // compact stack memory above the first factorized operator
+        for (size_t i = mp.size(); i > ig0; i--)
+            d_alloc->deallocate((FP *)mp[i - 1].second->data,
+                                mp[i - 1].second->total_memory * cpx_sz);
+        for (size_t i = ig0; i < mp.size(); i++)
+            if (!compressed[i]) {
+                const size_t n = mp[i].second->total_memory * cpx_sz;
+                FP *ptr = d_alloc->allocate(n);
+                if (ptr != (FP *)mp[i].second->data)
+                    memmove(ptr, mp[i].second->data, sizeof(FP) * n);
+                mp[i].second->data = (FL *)ptr;
+            }
+        for (size_t ig = 0; ig < groups.size(); ig++) {
+            if (ranks[ig] == -1)
+                continue;
+            const vector<size_t> &g = groups[ig];
+            const int rk = ranks[ig];
+            const size_t size = mp[g[0]].second->total_memory;
+            FL *ptr = nullptr;
+            if (rk != 0) {
+                ptr = (FL *)d_alloc->allocate(rk * size * cpx_sz);
+                memcpy(ptr, bases[ig].data(), sizeof(FL) * rk * size);
+            }
+            shared_ptr<LowRankBasis<FL>> basis =
+                make_shared<LowRankBasis<FL>>(ptr, rk, size);
+            for (size_t i = 0; i < g.size(); i++) {
+                vector<FP> cs(rk);
+                for (int k = 0; k < rk; k++)
+                    cs[k] = coeffs[ig][(size_t)k * g.size() + i];
+                shared_ptr<DelayedSparseMatrix<S, FL, LowRankBasis<FL>>> mat =
+                    make_shared<DelayedSparseMatrix<S, FL, LowRankBasis<FL>>>(
+                        basis, cs, mp[g[i]].second->info, i == 0);
+                mat->factor = mp[g[i]].second->factor;
+                if (i == 0) {
+                    mat->alloc = d_alloc;
+                    mat->data = ptr, mat->total_memory = rk * size;
+                }
+                c->ops.at(mp[g[i]].first) = mat;
+            }
+        }
+        return make_tuple(org_mem, c->get_total_memory(), dw);
     }
     // c = a
     void left_assign(const shared_ptr<OperatorTensor<S, FL>> &a,
@@ -267,6 +423,137 @@ struct DelayedTensorFunctions : TensorFunctions<S, FL> {
                 }
         }
     }
+    // Low-rank operators from the same basis in terms of a sum
+    struct LowRankGroup {
+        // 1 (or 2) if the low-rank operators are on the left (or right)
+        int side;
+        uint8_t conj;
+        vector<shared_ptr<OpProduct<S, FL>>> terms;
+    };
+    // 1 (or 2) if the left (or right) operator is low-rank factorized
+    static int low_rank_side(const shared_ptr<SparseMatrix<S, FL>> &lmat,
+                             const shared_ptr<SparseMatrix<S, FL>> &rmat) {
+        if (dynamic_pointer_cast<DelayedSparseMatrix<S, FL, LowRankBasis<FL>>>(
+                lmat) != nullptr)
+            return 1;
+        else if (dynamic_pointer_cast<
+                     DelayedSparseMatrix<S, FL, LowRankBasis<FL>>>(rmat) !=
+                 nullptr)
+            return 2;
+        return 0;
+    }
+    // Split terms of a sum into groups of products with low-rank operators
+    // from the same basis (with the same conj and partner quantum number)
+    // that are cheaper to contract through the factors, and other terms
+    static vector<LowRankGroup> low_rank_groups(
+        const vector<shared_ptr<OpProduct<S, FL>>> &strings,
+        const unordered_map<shared_ptr<OpExpr<S>>,
+                            shared_ptr<SparseMatrix<S, FL>>> &lop,
+        const unordered_map<shared_ptr<OpExpr<S>>,
+                            shared_ptr<SparseMatrix<S, FL>>> &rop,
+        vector<shared_ptr<OpProduct<S, FL>>> &others) {
+        map<tuple<LowRankBasis<FL> *, int, uint8_t, S>, LowRankGroup> mp;
+        for (auto &op : strings) {
+            int side = 0;
+            if (op->get_type() == OpTypes::Prod && op->b != nullptr)
+                side = low_rank_side(lop.at(op->a), rop.at(op->b));
+            if (side == 0) {
+                others.push_back(op);
+                continue;
+            }
+            shared_ptr<SparseMatrix<S, FL>> lr =
+                side == 1 ? lop.at(op->a) : rop.at(op->b);
+            shared_ptr<SparseMatrix<S, FL>> px =
+                side == 1 ? rop.at(op->b) : lop.at(op->a);
+            LowRankGroup &g = mp[make_tuple(
+                dynamic_pointer_cast<
+                    DelayedSparseMatrix<S, FL, LowRankBasis<FL>>>(lr)
+                    ->basis.get(),
+                side, op->conj, px->info->delta_quantum)];
+            g.side = side, g.conj = op->conj;
+            g.terms.push_back(op);
+        }
+        vector<LowRankGroup> r;
+        for (auto &g : mp) {
+            // rank (instead of n_terms) tensor products are needed
+            const int rank = get<0>(g.first)->rank;
+            if (rank < (int)g.second.terms.size())
+                r.push_back(g.second);
+            else
+                others.insert(others.end(), g.second.terms.begin(),
+                              g.second.terms.end());
+        }
+        return r;
+    }
+    // The low-rank operators O_i = sum_k c[k, i] B_k in a group of
+    // terms f_i O_i x R_i (or f_i R_i x O_i) are contracted through
+    // the factors as sum_k B_k x (sum_i f_i c[k, i] R_i) without building O_i
+    // tp(conj, a, b) performs one tensor product with unit scale
+    template <typename T>
+    void low_rank_tensor_product(
+        const LowRankGroup &g,
+        const unordered_map<shared_ptr<OpExpr<S>>,
+                            shared_ptr<SparseMatrix<S, FL>>> &lop,
+        const unordered_map<shared_ptr<OpExpr<S>>,
+                            shared_ptr<SparseMatrix<S, FL>>> &rop,
+        T tp) const {
+        const size_t n = g.terms.size();
+        // conj of the low-rank side and the partner side
+        const bool lconj = (g.conj >> (g.side - 1)) & 1;
+        const bool pconj = (g.conj >> (2 - g.side)) & 1;
+        vector<shared_ptr<DelayedSparseMatrix<S, FL, LowRankBasis<FL>>>> lrs(n);
+        vector<shared_ptr<SparseMatrix<S, FL>>> pxs(n);
+        vector<uint8_t> built(n, 0);
+        for (size_t i = 0; i < n; i++) {
+            shared_ptr<SparseMatrix<S, FL>> lmat = lop.at(g.terms[i]->a);
+            shared_ptr<SparseMatrix<S, FL>> rmat = rop.at(g.terms[i]->b);
+            lrs[i] = dynamic_pointer_cast<
+                DelayedSparseMatrix<S, FL, LowRankBasis<FL>>>(
+                g.side == 1 ? lmat : rmat);
+            pxs[i] = g.side == 1 ? rmat : lmat;
+            if (pxs[i]->get_type() == SparseMatrixTypes::Delayed) {
+                pxs[i] =
+                    dynamic_pointer_cast<DelayedSparseMatrix<S, FL>>(pxs[i])
+                        ->build();
+                built[i] = 1;
+            }
+        }
+        const shared_ptr<LowRankBasis<FL>> &basis = lrs[0]->basis;
+        shared_ptr<SparseMatrix<S, FL>> bmat =
+            make_shared<SparseMatrix<S, FL>>();
+        bmat->info = lrs[0]->info;
+        bmat->total_memory = basis->size;
+        for (int k = 0; k < basis->rank; k++) {
+            shared_ptr<SparseMatrix<S, FL>> tmp =
+                make_shared<SparseMatrix<S, FL>>();
+            tmp->allocate(pxs[0]->info);
+            bool nonzero = false;
+            for (size_t i = 0; i < n; i++) {
+                if (lrs[i]->coeffs[k] == (FP)0.0)
+                    continue;
+                FL scale = g.terms[i]->factor * (FL)lrs[i]->coeffs[k] *
+                           (lconj ? xconj<FL>(lrs[i]->factor)
+                                  : lrs[i]->factor);
+                opf->iadd(tmp, pxs[i], pconj ? xconj<FL>(scale) : scale);
+                nonzero = true;
+            }
+            if (opf->seq->mode == SeqTypes::Simple)
+                opf->seq->simple_perform();
+            if (nonzero) {
+                bmat->data = basis->data + (size_t)k * basis->size;
+                if (g.side == 1)
+                    tp(g.conj, bmat, tmp);
+                else
+                    tp(g.conj, tmp, bmat);
+                if (opf->seq->mode == SeqTypes::Simple)
+                    opf->seq->simple_perform();
+            }
+            tmp->deallocate();
+        }
+        for (size_t i = n; i > 0; i--)
+            if (built[i - 1])
+                pxs[i - 1]->deallocate();
+    }
     // vmat = expr x cmat
     void tensor_product_multiply(const shared_ptr<OpExpr<S>> &expr,
                                  const shared_ptr<OpExpr<S>> &xexpr,
@@ -303,7 +590,18 @@ struct DelayedTensorFunctions : TensorFunctions<S, FL> {
         case OpTypes::Sum: {
             shared_ptr<OpSum<S, FL>> op =
                 dynamic_pointer_cast<OpSum<S, FL>>(expr);
-            for (auto &x : op->strings)
+            vector<shared_ptr<OpProduct<S, FL>>> others;
+            vector<LowRankGroup> groups =
+                low_rank_groups(op->strings, lopt->ops, ropt->ops, others);
+            for (auto &g : groups)
+                low_rank_tensor_product(
+                    g, lopt->ops, ropt->ops,
+                    [&](uint8_t conj, const shared_ptr<SparseMatrix<S, FL>> &a,
+                        const shared_ptr<SparseMatrix<S, FL>> &b) {
+                        opf->tensor_product_multiply(conj, a, b, cmat, vmat,
+                                                     opdq, 1.0);
+                    });
+            for (auto &x : others)
                 tensor_product_multiply(x, xexpr, lopt, ropt, cmat, vmat, opdq,
                                         false);
         } break;
@@ -473,7 +771,17 @@ struct DelayedTensorFunctions : TensorFunctions<S, FL> {
         case OpTypes::Sum: {
             shared_ptr<OpSum<S, FL>> op =
                 dynamic_pointer_cast<OpSum<S, FL>>(expr);
-            for (auto &x : op->strings)
+            vector<shared_ptr<OpProduct<S, FL>>> others;
+            vector<LowRankGroup> groups =
+                low_rank_groups(op->strings, lop, rop, others);
+            for (auto &g : groups)
+                low_rank_tensor_product(
+                    g, lop, rop,
+                    [&](uint8_t conj, const shared_ptr<SparseMatrix<S, FL>> &a,
+                        const shared_ptr<SparseMatrix<S, FL>> &b) {
+                        opf->tensor_product(conj, a, b, mat, 1.0);
+                    });
+            for (auto &x : others)
                 tensor_product(x, lop, rop, mat);
         } break;
         case OpTypes::Zero:
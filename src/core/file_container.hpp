@@ -0,0 +1,396 @@
+
+/*
+ * block2: Efficient MPO implementation of quantum chemistry DMRG
+ * Copyright (C) 2020-2021 Huanchen Zhai <hczhai@caltech.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/** Single-file indexed container for scratch records. */
+
+#pragma once
+
+#include "utils.hpp"
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace block2 {
+
+/** A single file holding many named binary records.
+ * Records are stored in aligned extents. Rewriting a record that fits in its
+ * extent is done in place, removed extents are coalesced and reused (best
+ * fit), and new extents are appended at the end. The name -> extent index is
+ * kept in memory and written behind the data on flush, with its position
+ * recorded in the file header. Records can be hard-linked (shared extent,
+ * copy on write). All methods are thread-safe.
+ */
+struct FileContainer {
+    struct Extent {
+        uint64_t capacity, size; //!< Reserved and used bytes.
+        int nref;                //!< Number of names referring to this extent.
+    };
+    static const uint64_t magic = 0x31524E544E433242ULL; //!< "B2CNTNR1"
+    string filename;                         //!< Path of the container file.
+    uint64_t alignment;                      //!< Extent alignment in bytes.
+    map<string, uint64_t> index;             //!< Record name -> extent offset.
+    map<uint64_t, Extent> extents;           //!< Extent offset -> extent.
+    map<uint64_t, uint64_t> free_extents;    //!< Free offset -> capacity.
+    multimap<uint64_t, uint64_t> free_sizes; //!< Free capacity -> offset.
+    uint64_t end_offset;                     //!< End of the data region.
+    size_t n_in_place = 0, //!< Number of in-place overwrites.
+        n_reused = 0,      //!< Number of writes into reused free space.
+        n_appended = 0;    //!< Number of writes appended at the end.
+    mutable fstream fs;
+    mutable recursive_mutex mtx;
+    /** Constructor.
+     * @param filename Path of the container file.
+     * @param truncate If false and the file exists, its index is loaded.
+     * @param alignment Extent alignment in bytes.
+     */
+    FileContainer(const string &filename, bool truncate = false,
+                  uint64_t alignment = 4096)
+        : filename(filename), alignment(alignment), end_offset(alignment) {
+        if (!truncate && Parsing::file_exists(filename)) {
+            fs.open(filename.c_str(), ios::binary | ios::in | ios::out);
+            if (!fs.good())
+                throw runtime_error("FileContainer on '" + filename +
+                                    "' failed.");
+            load_index();
+        } else {
+            fs.open(filename.c_str(),
+                    ios::binary | ios::in | ios::out | ios::trunc);
+            if (!fs.good())
+                throw runtime_error("FileContainer on '" + filename +
+                                    "' failed.");
+            write_header(fs, 0, 0);
+        }
+    }
+    virtual ~FileContainer() {
+        if (fs.is_open()) {
+            flush();
+            fs.close();
+        }
+    }
+    static uint64_t read_u64(istream &ifs) {
+        uint64_t x = 0;
+        ifs.read((char *)&x, sizeof(x));
+        return x;
+    }
+    static void write_u64(ostream &ofs, uint64_t x) {
+        ofs.write((const char *)&x, sizeof(x));
+    }
+    static void write_header(ostream &ofs, uint64_t idx_offset,
+                             uint64_t idx_size) {
+        ofs.seekp(0);
+        write_u64(ofs, magic);
+        write_u64(ofs, idx_offset);
+        write_u64(ofs, idx_size);
+    }
+    uint64_t round_up(uint64_t x) const {
+        return max((x + alignment - 1) / alignment, (uint64_t)1) * alignment;
+    }
+    void load_index() {
+        fs.seekg(0);
+        uint64_t mg = read_u64(fs), idx_offset = read_u64(fs);
+        read_u64(fs);
+        if (fs.fail() || mg != magic)
+            throw runtime_error("FileContainer: '" + filename +
+                                "' is not a container file.");
+        if (idx_offset == 0)
+            return;
+        fs.seekg(idx_offset);
+        alignment = read_u64(fs);
+        uint64_t n_ext = read_u64(fs);
+        for (uint64_t i = 0; i < n_ext; i++) {
+            uint64_t off = read_u64(fs), cap = read_u64(fs), sz = read_u64(fs);
+            extents[off] = Extent{cap, sz, 0};
+        }
+        uint64_t n_names = read_u64(fs);
+        for (uint64_t i = 0; i < n_names; i++) {
+            string name(read_u64(fs), '\0');
+            fs.read(&name[0], name.size());
+            uint64_t off = read_u64(fs);
+            index[name] = off;
+            extents.at(off).nref++;
+        }
+        if (fs.fail())
+            throw runtime_error("FileContainer: index of '" + filename +
+                                "' is corrupted.");
+        // gaps between live extents become free space
+        end_offset = alignment;
+        for (const auto &ext : extents) {
+            if (ext.first > end_offset)
+                add_free(end_offset, ext.first - end_offset);
+            end_offset = ext.first + ext.second.capacity;
+        }
+    }
+    void add_free(uint64_t offset, uint64_t capacity) {
+        free_extents[offset] = capacity;
+        free_sizes.insert(make_pair(capacity, offset));
+    }
+    void erase_free(map<uint64_t, uint64_t>::iterator it) {
+        auto rg = free_sizes.equal_range(it->second);
+        for (auto jt = rg.first; jt != rg.second; jt++)
+            if (jt->second == it->first) {
+                free_sizes.erase(jt);
+                break;
+            }
+        free_extents.erase(it);
+    }
+    // return an extent to the free lists, merging with its neighbours
+    void release_extent(uint64_t offset) {
+        auto ext = extents.find(offset);
+        if (--ext->second.nref != 0)
+            return;
+        uint64_t cap = ext->second.capacity;
+        extents.erase(ext);
+        auto it = free_extents.lower_bound(offset);
+        if (it != free_extents.end() && it->first == offset + cap)
+            cap += it->second, erase_free(it++);
+        if (it != free_extents.begin()) {
+            auto pt = prev(it);
+            if (pt->first + pt->second == offset)
+                offset = pt->first, cap += pt->second, erase_free(pt);
+        }
+        if (offset + cap == end_offset)
+            end_offset = offset;
+        else
+            add_free(offset, cap);
+    }
+    uint64_t allocate_extent(uint64_t size) {
+        uint64_t cap = round_up(size), offset;
+        auto it = free_sizes.lower_bound(cap);
+        if (it != free_sizes.end()) {
+            offset = it->second;
+            uint64_t fcap = it->first;
+            erase_free(free_extents.find(offset));
+            if (fcap > cap)
+                add_free(offset + cap, fcap - cap);
+            n_reused++;
+        } else {
+            offset = end_offset;
+            end_offset += cap;
+            n_appended++;
+        }
+        extents[offset] = Extent{cap, size, 1};
+        return offset;
+    }
+    /** Write (or overwrite) one record.
+     * @param name The record name.
+     * @param data Pointer to the record data.
+     * @param size Number of bytes.
+     */
+    void write(const string &name, const char *data, uint64_t size) {
+        lock_guard<recursive_mutex> lock(mtx);
+        uint64_t offset;
+        auto it = index.find(name);
+        if (it != index.end() && extents.at(it->second).nref == 1 &&
+            extents.at(it->second).capacity >= size) {
+            offset = it->second;
+            extents.at(offset).size = size;
+            n_in_place++;
+        } else {
+            if (it != index.end())
+                release_extent(it->second);
+            offset = index[name] = allocate_extent(size);
+        }
+        fs.clear();
+        fs.seekp(offset);
+        fs.write(data, size);
+        if (!fs.good())
+            throw runtime_error("FileContainer::write '" + name + "' to '" +
+                                filename + "' failed.");
+    }
+    void write(const string &name, const string &data) {
+        write(name, data.data(), data.size());
+    }
+    /** Read one record through a callback.
+     * The callback is invoked under the container lock with the file stream
+     * positioned at the start of the record.
+     * @param name The record name.
+     * @param f Reader of the record content.
+     */
+    void read(const string &name, const function<void(istream &)> &f) const {
+        lock_guard<recursive_mutex> lock(mtx);
+        auto it = index.find(name);
+        if (it == index.end())
+            throw runtime_error("FileContainer::read '" + name +
+                                "' not found in '" + filename + "'.");
+        fs.clear();
+        fs.seekg(it->second);
+        f(fs);
+        if (fs.fail() || fs.bad())
+            throw runtime_error("FileContainer::read '" + name + "' from '" +
+                                filename + "' failed.");
+    }
+    string read(const string &name) const {
+        string r;
+        read(name, [&r, &name, this](istream &ifs) {
+            r.resize(extents.at(index.at(name)).size);
+            ifs.read(&r[0], r.size());
+        });
+        return r;
+    }
+    bool exists(const string &name) const {
+        lock_guard<recursive_mutex> lock(mtx);
+        return index.count(name) != 0;
+    }
+    /** Size of one record in bytes. */
+    uint64_t size(const string &name) const {
+        lock_guard<recursive_mutex> lock(mtx);
+        auto it = index.find(name);
+        return it == index.end() ? 0 : extents.at(it->second).size;
+    }
+    bool remove(const string &name) {
+        lock_guard<recursive_mutex> lock(mtx);
+        auto it = index.find(name);
+        if (it == index.end())
+            return false;
+        release_extent(it->second);
+        index.erase(it);
+        return true;
+    }
+    bool rename(const string &old_name, const string &new_name) {
+        lock_guard<recursive_mutex> lock(mtx);
+        auto it = index.find(old_name);
+        if (it == index.end())
+            return false;
+        if (old_name == new_name)
+            return true;
+        uint64_t offset = it->second;
+        index.erase(it);
+        remove(new_name);
+        index[new_name] = offset;
+        return true;
+    }
+    /** Make ``name`` refer to the same data as ``source``. A later write to
+     * either name leaves the other one unchanged. */
+    bool link(const string &source, const string &name) {
+        lock_guard<recursive_mutex> lock(mtx);
+        auto it = index.find(source);
+        if (it == index.end())
+            return false;
+        if (source == name ||
+            (index.count(name) && index.at(name) == it->second))
+            return true;
+        remove(name);
+        index[name] = it->second;
+        extents.at(it->second).nref++;
+        return true;
+    }
+    vector<string> names() const {
+        lock_guard<recursive_mutex> lock(mtx);
+        vector<string> r;
+        r.reserve(index.size());
+        for (const auto &x : index)
+            r.push_back(x.first);
+        return r;
+    }
+    size_t n_records() const {
+        lock_guard<recursive_mutex> lock(mtx);
+        return index.size();
+    }
+    /** Bytes held by the data region (live and free extents). */
+    uint64_t data_size() const {
+        lock_guard<recursive_mutex> lock(mtx);
+        return end_offset;
+    }
+    /** Bytes of free extents available for reuse. */
+    uint64_t free_size() const {
+        lock_guard<recursive_mutex> lock(mtx);
+        uint64_t r = 0;
+        for (const auto &x : free_extents)
+            r += x.second;
+        return r;
+    }
+    void write_index(ostream &ofs,
+                     const map<uint64_t, uint64_t> &remap = {}) const {
+        uint64_t idx_offset = ofs.tellp();
+        write_u64(ofs, alignment);
+        write_u64(ofs, extents.size());
+        for (const auto &ext : extents) {
+            write_u64(ofs, remap.size() ? remap.at(ext.first) : ext.first);
+            write_u64(ofs, ext.second.capacity);
+            write_u64(ofs, ext.second.size);
+        }
+        write_u64(ofs, index.size());
+        for (const auto &x : index) {
+            write_u64(ofs, x.first.size());
+            ofs.write(x.first.data(), x.first.size());
+            write_u64(ofs, remap.size() ? remap.at(x.second) : x.second);
+        }
+        uint64_t idx_size = (uint64_t)ofs.tellp() - idx_offset;
+        write_header(ofs, idx_offset, idx_size);
+    }
+    /** Write the index behind the data region and flush the file. */
+    void flush() {
+        lock_guard<recursive_mutex> lock(mtx);
+        fs.clear();
+        fs.seekp(end_offset);
+        write_index(fs);
+        fs.flush();
+        if (!fs.good())
+            throw runtime_error("FileContainer::flush '" + filename +
+                                "' failed.");
+    }
+    /** Write a compacted copy of the container. The copy is written to a
+     * temporary file and then renamed, so ``target`` is either the old or the
+     * complete new snapshot.
+     * @param target Path of the snapshot file.
+     */
+    void snapshot(const string &target) const {
+        lock_guard<recursive_mutex> lock(mtx);
+        const string tmp = target + ".tmp";
+        ofstream ofs(tmp.c_str(), ios::binary);
+        if (!ofs.good())
+            throw runtime_error("FileContainer::snapshot to '" + tmp +
+                                "' failed.");
+        write_header(ofs, 0, 0);
+        map<uint64_t, uint64_t> remap;
+        uint64_t offset = alignment;
+        vector<char> buf;
+        fs.clear();
+        for (const auto &ext : extents) {
+            remap[ext.first] = offset;
+            buf.resize(ext.second.size);
+            fs.seekg(ext.first);
+            fs.read(buf.data(), buf.size());
+            ofs.seekp(offset);
+            ofs.write(buf.data(), buf.size());
+            offset += ext.second.capacity;
+        }
+        if (fs.fail() || fs.bad())
+            throw runtime_error("FileContainer::snapshot reading '" +
+                                filename + "' failed.");
+        ofs.seekp(offset);
+        write_index(ofs, remap);
+        if (!ofs.good())
+            throw runtime_error("FileContainer::snapshot to '" + tmp +
+                                "' failed.");
+        ofs.close();
+        if (!Parsing::rename_file(tmp, target))
+            throw runtime_error("FileContainer::snapshot renaming '" + tmp +
+                                "' to '" + target + "' failed.");
+    }
+};
+
+} // namespace block2
@@ -121,6 +121,134 @@ struct Flow {
     }
 };
 
+// Maximum matching and minimum vertex cover of bipartite graph with unit
+// capacity (Hopcroft-Karp, O(m sqrt(n))), with edges in CSR format.
+// Same vertex cover as Flow::mvc, since the vertices reachable from the
+// unmatched left vertices do not depend on the maximum matching
+struct BipartiteMatching {
+    int nl, nr;
+    // edges of left vertex i: adj[ptr[i]:ptr[i + 1]]
+    vector<int> ptr, adj;
+    vector<int> match_l, match_r, dist, it;
+    BipartiteMatching(int nl, int nr) : nl(nl), nr(nr) {
+        ptr.resize(nl + 1, 0);
+    }
+    // edges[k].first = (left vertex, right vertex)
+    template <typename T>
+    void init_edges(const vector<pair<pair<int, int>, T>> &edges) {
+        memset(ptr.data(), 0, (nl + 1) * sizeof(int));
+        for (const auto &e : edges)
+            ptr[e.first.first + 1]++;
+        for (int i = 0; i < nl; i++)
+            ptr[i + 1] += ptr[i];
+        adj.resize(edges.size());
+        vector<int> p(ptr.begin(), ptr.end() - 1);
+        for (const auto &e : edges)
+            adj[p[e.first.first]++] = e.first.second;
+    }
+    // greedy initial matching
+    int greedy() {
+        int r = 0;
+        match_l.assign(nl, -1);
+        match_r.assign(nr, -1);
+        for (int i = 0; i < nl; i++)
+            for (int k = ptr[i]; k < ptr[i + 1]; k++)
+                if (match_r[adj[k]] == -1) {
+                    match_l[i] = adj[k], match_r[adj[k]] = i, r++;
+                    break;
+                }
+        return r;
+    }
+    // layers of left vertices from unmatched left vertices
+    bool hk_bfs() {
+        const int inf = numeric_limits<int>::max();
+        vector<int> q;
+        q.reserve(nl);
+        for (int i = 0; i < nl; i++)
+            if (match_l[i] == -1)
+                dist[i] = 0, q.push_back(i);
+            else
+                dist[i] = inf;
+        bool found = false;
+        for (size_t h = 0; h < q.size(); h++) {
+            const int x = q[h];
+            for (int k = ptr[x]; k < ptr[x + 1]; k++) {
+                const int y = match_r[adj[k]];
+                if (y == -1)
+                    found = true;
+                else if (dist[y] == inf)
+                    dist[y] = dist[x] + 1, q.push_back(y);
+            }
+        }
+        return found;
+    }
+    // augmenting path from left vertex x (non-recursive dfs)
+    bool hk_dfs(int x, vector<int> &stk) {
+        const int inf = numeric_limits<int>::max();
+        stk.clear();
+        stk.push_back(x);
+        while (!stk.empty()) {
+            const int u = stk.back();
+            if (it[u] == ptr[u + 1]) {
+                dist[u] = inf, stk.pop_back();
+                if (!stk.empty())
+                    it[stk.back()]++;
+                continue;
+            }
+            const int w = match_r[adj[it[u]]];
+            if (w == -1) {
+                for (int v : stk)
+                    match_l[v] = adj[it[v]], match_r[adj[it[v]]] = v;
+                return true;
+            } else if (dist[w] == dist[u] + 1)
+                stk.push_back(w);
+            else
+                it[u]++;
+        }
+        return false;
+    }
+    // size of maximum matching
+    int hopcroft_karp() {
+        int r = greedy();
+        dist.resize(nl);
+        it.resize(nl);
+        vector<int> stk;
+        while (hk_bfs()) {
+            memcpy(it.data(), ptr.data(), nl * sizeof(int));
+            for (int i = 0; i < nl; i++)
+                if (match_l[i] == -1 && hk_dfs(i, stk))
+                    r++;
+        }
+        return r;
+    }
+    // Minimum Vertex Cover (Konig's theorem)
+    int mvc(vector<int> &vx, vector<int> &vy) {
+        int r = hopcroft_karp();
+        vector<uint8_t> visl(nl, 0), visr(nr, 0);
+        vector<int> q;
+        q.reserve(nl);
+        for (int i = 0; i < nl; i++)
+            if (match_l[i] == -1)
+                visl[i] = 1, q.push_back(i);
+        for (size_t h = 0; h < q.size(); h++)
+            for (int k = ptr[q[h]]; k < ptr[q[h] + 1]; k++)
+                if (!visr[adj[k]]) {
+                    const int y = match_r[adj[k]];
+                    visr[adj[k]] = 1;
+                    if (y != -1 && !visl[y])
+                        visl[y] = 1, q.push_back(y);
+                }
+        vx.reserve(vx.size() + r);
+        for (int i = 0; i < nl; i++)
+            if (match_l[i] != -1 && !visl[i])
+                vx.push_back(i);
+        for (int i = 0; i < nr; i++)
+            if (visr[i])
+                vy.push_back(i);
+        return r;
+    }
+};
+
 // Min cost max flow (SAP & SPFA)
 struct CostFlow {
     typedef unordered_map<int, pair<int, int>>::const_iterator mci;
@@ -23,11 +23,15 @@
 #pragma once
 
 #include "threading.hpp"
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <cstdint>
+#include <cstring>
 #include <iostream>
 #include <sstream>
 #include <string>
+#include <type_traits>
 #include <vector>
 
 using namespace std;
@@ -145,6 +149,17 @@ template <typename T, typename U> struct BitsCodec {
 };
 
 /** Codec for compressing/decompressing array of floating-point numbers.
+ *
+ * Two chunk formats are supported. When block_size is zero, each element is
+ * written bit-serially with a variable-width exponent and mantissa (the
+ * original format, with magic "fpc" in streams). When block_size is nonzero,
+ * the chunk is split into blocks of block_size elements, each element is
+ * rounded to an integer multiple of the largest power of two not above prec,
+ * and the integers of one block are packed with a shared fixed bit width
+ * (magic "fpb" in streams). The block format has no data-dependent branches
+ * in the inner loops and is much faster, at the cost of a lower compression
+ * ratio for data with large dynamic range. In both formats the absolute
+ * error of each element is bounded by prec.
  * @tparam T Floating type to implement.
  * @tparam U The corresponding integer type.
  * @tparam mbits Number of bits in significand.
@@ -160,6 +175,8 @@ struct FPCodec {
     static const U e = U(1) << mbits; //!< Exponent least significant bit mask.
     static const U s = e << ebits;    //!< Sign bit mask.
     static const U x = ~(e + s - 1);  //!< Exponent mask.
+    static const int ubits = sizeof(U) * 8; //!< Number of bits in U.
+    typedef typename make_signed<U>::type SU; //!< Signed integer type.
     T prec;                           //!< Precision for compression.
     U prec_u; //!< Integer representation of the precision.
     mutable size_t
@@ -172,6 +189,9 @@ struct FPCodec {
                               //!< processed at one time.
     size_t n_parallel_chunks =
         4096; //!< Number of chunks to be processed in the same batch.
+    size_t block_size = 0; //!< Number of elements sharing one bit width in
+                           //!< the block format (zero for the bit-serial
+                           //!< format).
     /** Default constructor. */
     FPCodec() : prec(0), prec_u(0) {}
     /** Constructor.
@@ -185,6 +205,16 @@ struct FPCodec {
      */
     FPCodec(T prec, size_t chunk_size)
         : prec(prec), prec_u((U &)prec & x), chunk_size(chunk_size) {}
+    /** Constructor.
+     * @param prec Floating-point number precision.
+     * @param chunk_size Length of the array elements that should be processed
+     * at one time.
+     * @param block_size Number of elements sharing one bit width in the block
+     * format (typically 32 to 256). Zero for the bit-serial format.
+     */
+    FPCodec(T prec, size_t chunk_size, size_t block_size)
+        : prec(prec), prec_u((U &)prec & x), chunk_size(chunk_size),
+          block_size(block_size) {}
     /** Decode data.
      * @param ip_data The compressed floating-point array.
      * @param len Length of the original floating-point array.
@@ -193,6 +223,29 @@ struct FPCodec {
      * @return Length of the array for the compressed data.
      */
     size_t decode(T *ip_data, size_t len, T *op_data) const {
+        return block_size == 0
+                   ? decode_serial(ip_data, len, op_data)
+                   : decode_block(ip_data, len, op_data, block_size);
+    }
+    /** Encode data.
+     * @param ip_data The original floating-point array.
+     * @param len Length of the original floating-point array.
+     * @param op_data Output array for storing compressed data. Memory should be
+     * pre-allocated with length >= len + 1.
+     * @return Length of the array for the compressed data.
+     */
+    size_t encode(T *ip_data, size_t len, T *op_data) const {
+        return block_size == 0 ? encode_serial(ip_data, len, op_data)
+                               : encode_block(ip_data, len, op_data);
+    }
+    /** Decode data in the bit-serial format.
+     * @param ip_data The compressed floating-point array.
+     * @param len Length of the original floating-point array.
+     * @param op_data Output array for storing original data. Memory should be
+     * pre-allocated with length = len.
+     * @return Length of the array for the compressed data.
+     */
+    size_t decode_serial(T *ip_data, size_t len, T *op_data) const {
         BitsCodec<T, U> enc(ip_data);
         enc.begin_decode();
         U min_u, prec_ud;
@@ -218,14 +271,14 @@ struct FPCodec {
         }
         return enc.d_offset;
     }
-    /** Encode data.
+    /** Encode data in the bit-serial format.
      * @param ip_data The original floating-point array.
      * @param len Length of the original floating-point array.
      * @param op_data Output array for storing compressed data. Memory should be
      * pre-allocated with length >= len + 1.
      * @return Length of the array for the compressed data.
      */
-    size_t encode(T *ip_data, size_t len, T *op_data) const {
+    size_t encode_serial(T *ip_data, size_t len, T *op_data) const {
         U max_u = 0, min_u = x, prec_ud = prec_u >> mbits;
         for (size_t i = 0; i < len; i++) {
             max_u = max(max_u, (U &)ip_data[i] & x);
@@ -255,15 +308,159 @@ struct FPCodec {
         }
         return enc.finish_encode();
     }
+    /** Decode data in the block format.
+     * @param ip_data The compressed floating-point array.
+     * @param len Length of the original floating-point array.
+     * @param op_data Output array for storing original data. Memory should be
+     * pre-allocated with length = len.
+     * @param bsize Number of elements in each block used in encoding.
+     * @return Length of the array for the compressed data.
+     */
+    size_t decode_block(T *ip_data, size_t len, T *op_data,
+                        size_t bsize) const {
+        const U *pu = (const U *)ip_data;
+        // zero leading word marks a chunk stored without compression
+        if (pu[0] == 0) {
+            memcpy(op_data, ip_data + 1, sizeof(T) * len);
+            return len + 1;
+        }
+        U q_u = pu[0] << mbits;
+        const T q = (T &)q_u;
+        T mg = (T)(U(3) << (mbits - 1));
+        const U mg_u = (U &)mg;
+        vector<U> zs(min(bsize, len));
+        size_t d = 1;
+        for (size_t ib = 0; ib < len; ib += bsize) {
+            const size_t n = min(bsize, len - ib);
+            const int w = (int)pu[d++];
+            T *pv = op_data + ib;
+            if (w == ubits) {
+                memcpy(pv, pu + d, sizeof(T) * n);
+                d += n;
+                continue;
+            } else if (w == 0) {
+                memset(pv, 0, sizeof(T) * n);
+                continue;
+            }
+            const size_t nw = (n * w + ubits - 1) / ubits;
+            const U *pb = pu + d, mask = (U(1) << w) - 1;
+            // fixed-width unpacking
+            int off = 0;
+            for (size_t i = 0; i < n; i++) {
+                U z = *pb >> off;
+                off += w;
+                if (off >= ubits) {
+                    pb++;
+                    off -= ubits;
+                    if (off != 0)
+                        z |= *pb << (w - off);
+                }
+                zs[i] = z & mask;
+            }
+            // offset binary to floating-point (vectorizable)
+            const U zoff = mg_u - (U(1) << (w - 1));
+            for (size_t i = 0; i < n; i++) {
+                U y = zs[i] + zoff;
+                pv[i] = ((T &)y - mg) * q;
+            }
+            d += nw;
+        }
+        return d;
+    }
+    /** Encode data in the block format. Each element is rounded to the
+     * nearest multiple of the largest power of two not above prec, and the
+     * integers in each block are stored as offset binary numbers with the
+     * same width. The rounding uses the floating-point addition of a magic
+     * number, so blocks with integers larger than 2^(mbits - 1) (or with
+     * NaN/Inf) are stored without compression.
+     * @param ip_data The original floating-point array.
+     * @param len Length of the original floating-point array.
+     * @param op_data Output array for storing compressed data. Memory should be
+     * pre-allocated with length >= len + 1.
+     * @return Length of the array for the compressed data.
+     */
+    size_t encode_block(T *ip_data, size_t len, T *op_data) const {
+        U *pu = (U *)op_data;
+        // when prec is zero or not finite the chunk is stored as it is
+        if (prec_u == 0 || prec_u == x) {
+            pu[0] = 0;
+            memcpy(op_data + 1, ip_data, sizeof(T) * len);
+            return len + 1;
+        }
+        U q_u = prec_u;
+        const T q = (T &)q_u, qinv = (T)1.0 / q;
+        const T kmax = (T)(U(1) << (mbits - 1));
+        T mg = (T)(U(3) << (mbits - 1));
+        const U mg_u = (U &)mg;
+        pu[0] = prec_u >> mbits;
+        vector<U> zs(min(block_size, len));
+        size_t d = 1;
+        for (size_t ib = 0; ib < len; ib += block_size) {
+            const size_t n = min(block_size, len - ib);
+            const T *pv = ip_data + ib;
+            T amax = 0;
+            bool has_nan = false;
+            for (size_t i = 0; i < n; i++) {
+                const T av = abs(pv[i]);
+                amax = av > amax ? av : amax;
+                has_nan |= av != av;
+            }
+            int w = ubits;
+            if (!has_nan && amax * qinv < kmax) {
+                // bits of 2 * |k|, so that k + 2^(w - 1) fits in w bits
+                T ka = amax * qinv + mg;
+                const U zmax = ((U &)ka - mg_u) << 1;
+                for (w = 0; (zmax >> w) != 0; w++)
+                    ;
+            }
+            const size_t nw = w == ubits ? n : (n * w + ubits - 1) / ubits;
+            if (d + 1 + nw > len + 1) {
+                // compressed form is not shorter than the original data
+                pu[0] = 0;
+                memcpy(op_data + 1, ip_data, sizeof(T) * len);
+                return len + 1;
+            }
+            pu[d++] = (U)w;
+            U *pb = pu + d;
+            if (w == ubits)
+                memcpy(pb, pv, sizeof(T) * n);
+            else if (w != 0) {
+                // rounding to offset binary integers (vectorizable)
+                const U zoff = mg_u - (U(1) << (w - 1));
+                for (size_t i = 0; i < n; i++) {
+                    T r = pv[i] * qinv + mg;
+                    zs[i] = (U &)r - zoff;
+                }
+                // fixed-width packing
+                U acc = 0;
+                int used = 0;
+                for (size_t i = 0; i < n; i++) {
+                    acc |= zs[i] << used;
+                    used += w;
+                    if (used >= ubits) {
+                        *pb++ = acc;
+                        used -= ubits;
+                        acc = zs[i] >> (w - used);
+                    }
+                }
+                if (used != 0)
+                    *pb = acc;
+            }
+            d += nw;
+        }
+        return d;
+    }
     /** Compress array of floating-point data and write into file stream.
      * @param ofs Output stream.
      * @param data The original floating-point array.
      * @param len The length of the original floating-point array.
      */
     void write_array(ostream &ofs, T *data, size_t len) const {
-        const string magic = "fpc", tail = "end";
+        const string magic = block_size == 0 ? "fpc" : "fpb", tail = "end";
         ofs.write((char *)magic.c_str(), 4);
         ofs.write((char *)&chunk_size, sizeof(chunk_size));
+        if (block_size != 0)
+            ofs.write((char *)&block_size, sizeof(block_size));
         ndata += len;
         size_t nchunk = (size_t)(len / chunk_size + !!(len % chunk_size));
         size_t nbatch = (size_t)(nchunk / n_parallel_chunks +
@@ -306,10 +503,12 @@ struct FPCodec {
      */
     void read_array(istream &ifs, T *data, size_t len) const {
         string magic = "???";
-        size_t chunk_size;
+        size_t chunk_size, block_size = 0;
         ifs.read((char *)magic.c_str(), 4);
-        assert(magic == "fpc");
+        assert(magic == "fpc" || magic == "fpb");
         ifs.read((char *)&chunk_size, sizeof(chunk_size));
+        if (magic == "fpb")
+            ifs.read((char *)&block_size, sizeof(block_size));
         size_t nchunk = (size_t)(len / chunk_size + !!(len % chunk_size));
         size_t nbatch = (size_t)(nchunk / n_parallel_chunks +
                                  !!(nchunk % n_parallel_chunks));
@@ -335,7 +534,11 @@ struct FPCodec {
                     (ic + ib * n_parallel_chunks) * chunk_size;
                 size_t cklen = min(chunk_size, len - batch_offset);
                 size_t dclen =
-                    decode(pdata + offset + ic, cklen, data + batch_offset);
+                    block_size == 0
+                        ? decode_serial(pdata + offset + ic, cklen,
+                                        data + batch_offset)
+                        : decode_block(pdata + offset + ic, cklen,
+                                       data + batch_offset, block_size);
                 assert(dclen == cplens[ic]);
             }
         }
@@ -344,7 +547,8 @@ struct FPCodec {
         ifs.read((char *)magic.c_str(), 4);
         assert(magic == "end");
     }
-    /** Read from file stream (but not decompress the data).
+    /** Read from file stream (but not decompress the data). The chunk format
+     * of this codec is set to the one used in the stream.
      * @param ifs Input stream.
      * @param len The length of the original floating-point array.
      * @param chunks For storing chunks of the compressed data.
@@ -352,11 +556,14 @@ struct FPCodec {
      * (output).
      */
     void read_chunks(istream &ifs, size_t len, vector<vector<T>> &chunks,
-                     size_t &chunk_size) const {
+                     size_t &chunk_size) {
         string magic = "???";
         ifs.read((char *)magic.c_str(), 4);
-        assert(magic == "fpc");
+        assert(magic == "fpc" || magic == "fpb");
         ifs.read((char *)&chunk_size, sizeof(chunk_size));
+        block_size = 0;
+        if (magic == "fpb")
+            ifs.read((char *)&block_size, sizeof(block_size));
         size_t nchunk = (size_t)(len / chunk_size + !!(len % chunk_size));
         chunks.resize(nchunk);
         for (size_t ic = 0; ic < nchunk; ic++) {
@@ -451,7 +658,7 @@ template <typename T> struct CompressedVector {
     /** Write all cached data into compressed form. */
     void finalize() {
         if (!cache_dirty.empty()) {
-            for (int ic = 0; ic < ncache; ic++)
+            for (int ic = 0; ic < (int)cache_dirty.size(); ic++)
                 if (cache_dirty[ic]) {
                     size_t dchunk = cache_data[ic].first;
                     size_t alen =
@@ -528,6 +735,44 @@ template <typename T> struct CompressedVector {
         icache = (icache + 1) % ncache;
         return cache_data[old_icache].second[k];
     }
+    /** Decompress one chunk without changing the cache. Cached chunks may
+     * hold data not yet compressed, so they are copied from the cache. Like
+     * operator[], this is not thread-safe (see CompressedVectorMT).
+     * @param ichunk Chunk index.
+     * @param op_data Output array with at least chunk_size elements.
+     * @return Number of array elements in the chunk.
+     */
+    virtual size_t decode_chunk(size_t ichunk, T *op_data) const {
+        size_t alen = min(chunk_size, arr_len - ichunk * chunk_size);
+        for (size_t j = 0; j < cache_data.size(); j++)
+            if (cache_data[j].first == ichunk) {
+                memcpy(op_data, cache_data[j].second.data(), sizeof(T) * alen);
+                return alen;
+            }
+        fpc.decode(cp_data[ichunk].data(), alen, op_data);
+        return alen;
+    }
+    /** Read a set of array elements in the order of chunks. Each chunk is
+     * decompressed at most once. Thread-safe if decode_chunk is.
+     * @param idxs Array indices.
+     * @param len Number of array indices.
+     * @param op_data Output array with len elements.
+     */
+    void read_indices(const size_t *idxs, size_t len, T *op_data) const {
+        vector<size_t> ord(len);
+        for (size_t i = 0; i < len; i++)
+            ord[i] = i;
+        sort(ord.begin(), ord.end(),
+             [idxs](size_t i, size_t j) { return idxs[i] < idxs[j]; });
+        vector<T> buf(chunk_size);
+        size_t ichunk = arr_len;
+        for (size_t i = 0; i < len; i++) {
+            size_t ix = idxs[ord[i]], jchunk = ix / chunk_size;
+            if (jchunk != ichunk)
+                decode_chunk(ichunk = jchunk, buf.data());
+            op_data[ord[i]] = buf[ix % chunk_size];
+        }
+    }
     /** Get the size of the array. */
     size_t size() const { return arr_len; }
 };
@@ -556,6 +801,7 @@ template <typename T> struct CompressedVectorMT : CompressedVector<T> {
           CompressedVector<T>(ref_cv->arr_len, ref_cv->fpc.prec,
                               ref_cv->chunk_size, ref_cv->ncache) {
         ref_cv->finalize();
+        fpc.block_size = ref_cv->fpc.block_size;
         cache_datas.resize(ntg);
         icaches.resize(ntg);
     }
@@ -591,6 +837,23 @@ template <typename T> struct CompressedVectorMT : CompressedVector<T> {
         icache = (icache + 1) % ncache;
         return cache_data[old_icache].second[k];
     }
+    /** Decompress one chunk, using only the cache of the calling thread.
+     * @param ichunk Chunk index.
+     * @param op_data Output array with at least chunk_size elements.
+     * @return Number of array elements in the chunk.
+     */
+    size_t decode_chunk(size_t ichunk, T *op_data) const override {
+        size_t alen = min(chunk_size, arr_len - ichunk * chunk_size);
+        const vector<pair<size_t, vector<T>>> &cache_data =
+            cache_datas[threading->get_thread_id()];
+        for (size_t j = 0; j < cache_data.size(); j++)
+            if (cache_data[j].first == ichunk) {
+                memcpy(op_data, cache_data[j].second.data(), sizeof(T) * alen);
+                return alen;
+            }
+        fpc.decode(ref_cv->cp_data[ichunk].data(), alen, op_data);
+        return alen;
+    }
     /** Get the size of the array. */
     size_t size() const { return arr_len; }
 };
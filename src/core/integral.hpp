@@ -1475,6 +1475,27 @@ template <typename FL> struct FCIDUMP {
         } else
             return general ? vgs[0](i, j, k, l) : vs[0](i, j, k, l);
     }
+    // Tile of two-electron integral elements (SU(2))
+    // r[a * len + b] = v(idx) with idx[pa] = start + a, idx[pb] = start + b
+    virtual void v_tile(array<uint16_t, 4> idx, uint8_t pa, uint8_t pb,
+                        uint16_t start, uint16_t len, FL *r) const {
+        for (uint16_t a = 0; a < len; a++)
+            for (uint16_t b = 0; b < len; b++) {
+                idx[pa] = start + a, idx[pb] = start + b;
+                r[(size_t)a * len + b] = v(idx[0], idx[1], idx[2], idx[3]);
+            }
+    }
+    // Tile of two-electron integral elements (SZ)
+    virtual void v_tile(uint8_t sl, uint8_t sr, array<uint16_t, 4> idx,
+                        uint8_t pa, uint8_t pb, uint16_t start, uint16_t len,
+                        FL *r) const {
+        for (uint16_t a = 0; a < len; a++)
+            for (uint16_t b = 0; b < len; b++) {
+                idx[pa] = start + a, idx[pb] = start + b;
+                r[(size_t)a * len + b] =
+                    v(sl, sr, idx[0], idx[1], idx[2], idx[3]);
+            }
+    }
     virtual typename const_fl_type<FL>::FL e() const { return const_e; }
     virtual void deallocate() {
         assert(total_memory != 0);
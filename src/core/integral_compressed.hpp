@@ -127,6 +127,9 @@ struct CompressedV1Int<FL,
     shared_ptr<CompressedVector<FL>> cps_data;
     CompressedV1Int(uint32_t n)
         : n(n), m((size_t)n * n * n * n), cps_data(nullptr) {}
+    size_t find_index(uint16_t i, uint16_t j, uint16_t k, uint16_t l) const {
+        return (((size_t)i * n + j) * n + k) * n + l;
+    }
     size_t size() const { return m; }
     void clear() { cps_data->clear(); }
     FL &operator()(uint16_t i, uint16_t j, uint16_t k, uint16_t l) {
@@ -167,6 +170,9 @@ struct CompressedV1Int<FL, typename enable_if<is_complex<FL>::value>::type> {
     shared_ptr<CompressedVector<FP>> cps_data;
     CompressedV1Int(uint32_t n)
         : n(n), m((size_t)n * n * n * n), cps_data(nullptr) {}
+    size_t find_index(uint16_t i, uint16_t j, uint16_t k, uint16_t l) const {
+        return (((size_t)i * n + j) * n + k) * n + l;
+    }
     size_t size() const { return m; }
     void clear() { cps_data->clear(); }
     FL &operator()(uint16_t i, uint16_t j, uint16_t k, uint16_t l) {
@@ -914,6 +920,51 @@ template <typename FL> struct CompressedFCIDUMP : FCIDUMP<FL> {
         } else
             return general ? cps_vgs[0](i, j, k, l) : cps_vs[0](i, j, k, l);
     }
+    // Read all elements of a tile from the compressed array at once
+    template <typename VInt>
+    static void read_tile(const VInt &x, array<uint16_t, 4> idx, uint8_t pa,
+                          uint8_t pb, uint16_t start, uint16_t len, FL *r) {
+        vector<size_t> idxs((size_t)len * len * cpx_sz);
+        size_t p = 0;
+        for (uint16_t a = 0; a < len; a++)
+            for (uint16_t b = 0; b < len; b++) {
+                idx[pa] = start + a, idx[pb] = start + b;
+                const size_t ix =
+                    x.find_index(idx[0], idx[1], idx[2], idx[3]) * cpx_sz;
+                for (int c = 0; c < cpx_sz; c++)
+                    idxs[p++] = ix + c;
+            }
+        x.cps_data->read_indices(idxs.data(), idxs.size(), (FP *)r);
+    }
+    // Tile of two-electron integral elements (SU(2))
+    void v_tile(array<uint16_t, 4> idx, uint8_t pa, uint8_t pb,
+                uint16_t start, uint16_t len, FL *r) const override {
+        if (general)
+            read_tile(cps_vgs[0], idx, pa, pb, start, len, r);
+        else
+            read_tile(cps_vs[0], idx, pa, pb, start, len, r);
+    }
+    // Tile of two-electron integral elements (SZ)
+    void v_tile(uint8_t sl, uint8_t sr, array<uint16_t, 4> idx, uint8_t pa,
+                uint8_t pb, uint16_t start, uint16_t len,
+                FL *r) const override {
+        if (!uhf || sl == sr) {
+            const uint8_t s = uhf ? sl : 0;
+            if (general)
+                read_tile(cps_vgs[s], idx, pa, pb, start, len, r);
+            else
+                read_tile(cps_vs[s], idx, pa, pb, start, len, r);
+        } else {
+            // v(1, 0, i, j, k, l) is stored as v(0, 1, k, l, i, j)
+            if (sl == 1)
+                idx = array<uint16_t, 4>{idx[2], idx[3], idx[0], idx[1]},
+                pa ^= 2, pb ^= 2;
+            if (general)
+                read_tile(cps_vgs[2], idx, pa, pb, start, len, r);
+            else
+                read_tile(cps_vabs[0], idx, pa, pb, start, len, r);
+        }
+    }
     void freeze() {
         int ntg = threading->activate_global();
         for (auto &cs : cps_ts)
@@ -70,16 +70,18 @@ template <typename FL> struct GeneralFCIDUMP {
             auto *idx = &r->indices.back();
             auto *dt = &r->data.back();
             array<uint16_t, 4> arr;
+            vector<FL> vt((size_t)n * n);
             for (arr[0] = 0; arr[0] < n; arr[0]++)
-                for (arr[1] = 0; arr[1] < n; arr[1]++)
+                for (arr[1] = 0; arr[1] < n; arr[1]++) {
+                    fcidump->v_tile({arr[0], 0, arr[1], 0}, 3, 1, 0, n,
+                                    vt.data());
                     for (arr[2] = 0; arr[2] < n; arr[2]++)
                         for (arr[3] = 0; arr[3] < n; arr[3]++)
-                            if (abs(fcidump->v(arr[0], arr[3], arr[1],
-                                               arr[2])) > cutoff) {
+                            if (abs(vt[arr[2] * n + arr[3]]) > cutoff) {
                                 idx->insert(idx->end(), arr.begin(), arr.end());
-                                dt->push_back(
-                                    fcidump->v(arr[0], arr[3], arr[1], arr[2]));
+                                dt->push_back(vt[arr[2] * n + arr[3]]);
                             }
+                }
             r->exprs.push_back("(C+D)0");
             r->indices.push_back(vector<uint16_t>());
             r->data.push_back(vector<FL>());
@@ -102,20 +104,21 @@ template <typename FL> struct GeneralFCIDUMP {
                     auto *idx = &r->indices.back();
                     auto *dt = &r->data.back();
                     array<uint16_t, 4> arr;
+                    vector<FL> vt((size_t)n * n);
                     for (arr[0] = 0; arr[0] < n; arr[0]++)
-                        for (arr[1] = 0; arr[1] < n; arr[1]++)
+                        for (arr[1] = 0; arr[1] < n; arr[1]++) {
+                            fcidump->v_tile(si, sj, {arr[0], 0, arr[1], 0}, 3,
+                                            1, 0, n, vt.data());
                             for (arr[2] = 0; arr[2] < n; arr[2]++)
                                 for (arr[3] = 0; arr[3] < n; arr[3]++)
-                                    if (abs(fcidump->v(si, sj, arr[0], arr[3],
-                                                       arr[1], arr[2])) >
+                                    if (abs(vt[arr[2] * n + arr[3]]) >
                                         cutoff) {
                                         idx->insert(idx->end(), arr.begin(),
                                                     arr.end());
                                         dt->push_back((FL)0.5 *
-                                                      fcidump->v(si, sj, arr[0],
-                                                                 arr[3], arr[1],
-                                                                 arr[2]));
+                                                      vt[arr[2] * n + arr[3]]);
                                     }
+                        }
                 }
             r->exprs.push_back("cd");
             r->exprs.push_back("CD");
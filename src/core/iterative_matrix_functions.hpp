@@ -1171,6 +1171,184 @@ template <typename FL> struct IterativeMatrixFunctions : GMatrixFunctions<FL> {
         ndav = xiter;
         return eigvals;
     }
+    // Davidson for the lowest eigenpair of [a + shift b], for a sequence of
+    // shifts where only the scalar shift changes between the solutions.
+    // [a] x and [b] x of the subspace vectors are kept across the shift
+    // updates, so a new shift only needs a re-projection in the subspace,
+    // and the subspace is extended only when the residual is not converged.
+    // aa, ab: diag elements of a and b (for precondition)
+    // v, shift: input/output vector and shift
+    // shift_update(ener, ndav, shift): called with the converged eigenvalue
+    //   of the current shift; updates shift and returns true when finished
+    // ndav: number of [a] x (and [b] x) products
+    template <typename MatMulA, typename MatMulB, typename ShiftUpdate,
+              typename PComm>
+    static FP shift_davidson(MatMulA &opa, MatMulB &opb,
+                             const GDiagonalMatrix<FL> &aa,
+                             const GDiagonalMatrix<FL> &ab, GMatrix<FL> &v,
+                             FP &shift, ShiftUpdate &shift_update, int &ndav,
+                             bool iprint = false, const PComm &pcomm = nullptr,
+                             FP conv_thrd = 5E-6, FP rel_conv_thrd = 0.0,
+                             int max_iter = 5000, int soft_max_iter = -1,
+                             int deflation_min_size = 2,
+                             int deflation_max_size = 50) {
+        shared_ptr<VectorAllocator<FL>> d_alloc =
+            make_shared<VectorAllocator<FL>>();
+        shared_ptr<VectorAllocator<FP>> x_alloc =
+            make_shared<VectorAllocator<FP>>();
+        const bool is_root = pcomm == nullptr || pcomm->root == pcomm->rank;
+        if (deflation_min_size < 1)
+            deflation_min_size = 1;
+        if (deflation_max_size < deflation_min_size + 1)
+            deflation_max_size = deflation_min_size + 1;
+        const int dmx = deflation_max_size;
+        const size_t vsz = v.size();
+        FL *pbs = d_alloc->allocate(dmx * vsz);
+        FL *psa = d_alloc->allocate(dmx * vsz);
+        FL *psb = d_alloc->allocate(dmx * vsz);
+        vector<GMatrix<FL>> bs(dmx, GMatrix<FL>(nullptr, v.m, v.n));
+        vector<GMatrix<FL>> sas = bs, sbs = bs;
+        for (int i = 0; i < dmx; i++) {
+            bs[i].data = pbs + vsz * i;
+            sas[i].data = psa + vsz * i;
+            sbs[i].data = psb + vsz * i;
+        }
+        copy(bs[0], v);
+        iscale(bs[0], (FP)1.0 / norm(bs[0]));
+        // projections of a and b in the subspace
+        GMatrix<FL> pa(nullptr, dmx, dmx), pb(nullptr, dmx, dmx);
+        GMatrix<FL> x(nullptr, v.m, v.n), q(nullptr, v.m, v.n);
+        GDiagonalMatrix<FL> ad(nullptr, aa.n);
+        if (is_root) {
+            pa.allocate(x_alloc), pb.allocate(x_alloc);
+            x.allocate(x_alloc), q.allocate(x_alloc), ad.allocate(x_alloc);
+        }
+        int m = 1, msig = 0, mproj = 0, xiter = 0, siter = 0;
+        FP shift_ad = shift, ener = 0, qq = 0;
+        bool done = false;
+        ndav = 0;
+        if (is_root)
+            for (MKL_INT i = 0; i < ad.n; i++)
+                ad.data[i] = aa.data[i] + shift * ab.data[i];
+        if (iprint)
+            cout << endl;
+        while (!done) {
+            xiter++;
+            if (pcomm != nullptr && msig != m && xiter != 1)
+                pcomm->broadcast(pbs + vsz * msig, vsz * (m - msig),
+                                 pcomm->root);
+            for (int i = msig; i < m; i++, msig++, ndav++) {
+                sas[i].clear(), sbs[i].clear();
+                opa(bs[i], sas[i]);
+                opb(bs[i], sbs[i]);
+            }
+            if (is_root) {
+                for (int i = mproj; i < m; i++, mproj++)
+                    for (int j = 0; j <= i; j++) {
+                        pa(i, j) = complex_dot(bs[i], sas[j]);
+                        pb(i, j) = complex_dot(bs[i], sbs[j]);
+                        pa(j, i) = xconj<FL>(pa(i, j));
+                        pb(j, i) = xconj<FL>(pb(i, j));
+                    }
+                GMatrix<FL> alpha(nullptr, m, m);
+                GDiagonalMatrix<FP> ld(nullptr, m);
+                alpha.allocate(x_alloc), ld.allocate(x_alloc);
+                for (int i = 0; i < m; i++)
+                    for (int j = 0; j < m; j++)
+                        alpha(i, j) = pa(i, j) + shift * pb(i, j);
+                eigs(alpha, ld);
+                // ritz vector and residual of the lowest eigenpair
+                x.clear(), q.clear();
+                for (int i = 0; i < m; i++) {
+                    iadd(x, bs[i], alpha(0, i));
+                    iadd(q, sas[i], alpha(0, i));
+                    iadd(q, sbs[i], alpha(0, i) * shift);
+                }
+                ener = ld.data[0];
+                iadd(q, x, -ener);
+                qq = abs(complex_dot(q, q));
+                if (iprint)
+                    cout << setw(6) << xiter << setw(6) << m << fixed
+                         << setw(15) << setprecision(8) << ener << scientific
+                         << setw(13) << setprecision(2) << qq << setw(13)
+                         << setprecision(5) << shift << endl;
+                if (qq >= conv_thrd + ener * ener * rel_conv_thrd *
+                                          rel_conv_thrd &&
+                    siter != soft_max_iter) {
+                    if (shift_ad != shift) {
+                        for (MKL_INT i = 0; i < ad.n; i++)
+                            ad.data[i] = aa.data[i] + shift * ab.data[i];
+                        shift_ad = shift;
+                    }
+                    olsen_precondition(q, x, ener, ad);
+                    // restart from the lowest ritz vectors
+                    if (m >= dmx) {
+                        const int mr = deflation_min_size;
+                        vector<GMatrix<FL>> tmp(
+                            m, GMatrix<FL>(nullptr, v.m, v.n));
+                        for (int i = 0; i < m; i++)
+                            tmp[i].allocate(x_alloc);
+                        for (vector<GMatrix<FL>> *xs : {&bs, &sas, &sbs}) {
+                            for (int i = 0; i < m; i++)
+                                copy(tmp[i], (*xs)[i]);
+                            for (int j = 0; j < mr; j++) {
+                                (*xs)[j].clear();
+                                for (int i = 0; i < m; i++)
+                                    iadd((*xs)[j], tmp[i], alpha(j, i));
+                            }
+                        }
+                        for (int i = m - 1; i >= 0; i--)
+                            tmp[i].deallocate(x_alloc);
+                        m = msig = mr, mproj = 0;
+                        for (int i = 0; i < m; i++, mproj++)
+                            for (int j = 0; j <= i; j++) {
+                                pa(i, j) = complex_dot(bs[i], sas[j]);
+                                pb(i, j) = complex_dot(bs[i], sbs[j]);
+                                pa(j, i) = xconj<FL>(pa(i, j));
+                                pb(j, i) = xconj<FL>(pb(i, j));
+                            }
+                    }
+                    for (int j = 0; j < m; j++)
+                        iadd(q, bs[j], -complex_dot(bs[j], q));
+                    iscale(q, (FP)1.0 / norm(q));
+                    copy(bs[m], q);
+                }
+                ld.deallocate(x_alloc), alpha.deallocate(x_alloc);
+            }
+            if (pcomm != nullptr) {
+                pcomm->broadcast(&qq, 1, pcomm->root);
+                pcomm->broadcast(&ener, 1, pcomm->root);
+                pcomm->broadcast(&m, 1, pcomm->root);
+                pcomm->broadcast(&msig, 1, pcomm->root);
+            }
+            if (qq < conv_thrd + ener * ener * rel_conv_thrd * rel_conv_thrd ||
+                siter == soft_max_iter) {
+                // only a re-projection is needed for the new shift
+                done = shift_update(ener, ndav, shift);
+                siter = 0;
+            } else {
+                if (siter >= max_iter) {
+                    cout << "Error : shift davidson not converged!" << endl;
+                    assert(false);
+                    break;
+                }
+                m++, siter++;
+            }
+        }
+        if (is_root)
+            copy(v, x);
+        if (pcomm != nullptr)
+            pcomm->broadcast(v.data, v.size(), pcomm->root);
+        if (is_root) {
+            ad.deallocate(x_alloc), q.deallocate(x_alloc);
+            x.deallocate(x_alloc), pb.deallocate(x_alloc);
+            pa.deallocate(x_alloc);
+        }
+        d_alloc->deallocate(psb, dmx * vsz);
+        d_alloc->deallocate(psa, dmx * vsz);
+        d_alloc->deallocate(pbs, dmx * vsz);
+        return ener;
+    }
     // Harmonic Davidson algorithm
     // aa: diag elements of a (for precondition)
     // bs: input/output vector
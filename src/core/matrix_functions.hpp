@@ -121,6 +121,12 @@ extern VRETT LFNAME(ssyev)(const char *jobz, const char *uplo, const MKL_INT *n,
                            float *a, const MKL_INT *lda, float *w, float *work,
                            const MKL_INT *lwork, MKL_INT *info);
 
+extern VRETT LFNAME(ssyevd)(const char *jobz, const char *uplo,
+                            const MKL_INT *n, float *a, const MKL_INT *lda,
+                            float *w, float *work, const MKL_INT *lwork,
+                            MKL_INT *iwork, const MKL_INT *liwork,
+                            MKL_INT *info);
+
 extern VRETT LFNAME(sgeev)(const char *jobvl, const char *jobvr,
                            const MKL_INT *n, float *a, const MKL_INT *lda,
                            float *wr, float *wi, float *vl, const MKL_INT *ldvl,
@@ -147,6 +153,14 @@ extern VRETT LFNAME(sgesvd)(const char *jobu, const char *jobvt,
                             const MKL_INT *ldu, float *vt, const MKL_INT *ldvt,
                             float *work, const MKL_INT *lwork, MKL_INT *info);
 
+// SVD (divide-and-conquer)
+extern VRETT LFNAME(sgesdd)(const char *jobz, const MKL_INT *m,
+                            const MKL_INT *n, float *a, const MKL_INT *lda,
+                            float *s, float *u, const MKL_INT *ldu, float *vt,
+                            const MKL_INT *ldvt, float *work,
+                            const MKL_INT *lwork, MKL_INT *iwork,
+                            MKL_INT *info);
+
 // least squares problem a * x = b
 extern VRETT LFNAME(sgels)(const char *trans, const MKL_INT *m,
                            const MKL_INT *n, const MKL_INT *nrhs, float *a,
@@ -243,6 +257,12 @@ extern VRETT LFNAME(dsyev)(const char *jobz, const char *uplo, const MKL_INT *n,
                            double *a, const MKL_INT *lda, double *w,
                            double *work, const MKL_INT *lwork, MKL_INT *info);
 
+extern VRETT LFNAME(dsyevd)(const char *jobz, const char *uplo,
+                            const MKL_INT *n, double *a, const MKL_INT *lda,
+                            double *w, double *work, const MKL_INT *lwork,
+                            MKL_INT *iwork, const MKL_INT *liwork,
+                            MKL_INT *info);
+
 extern VRETT LFNAME(dgeev)(const char *jobvl, const char *jobvr,
                            const MKL_INT *n, double *a, const MKL_INT *lda,
                            double *wr, double *wi, double *vl,
@@ -263,6 +283,14 @@ extern VRETT LFNAME(dgesvd)(const char *jobu, const char *jobvt,
                             const MKL_INT *ldu, double *vt, const MKL_INT *ldvt,
                             double *work, const MKL_INT *lwork, MKL_INT *info);
 
+// SVD (divide-and-conquer)
+extern VRETT LFNAME(dgesdd)(const char *jobz, const MKL_INT *m,
+                            const MKL_INT *n, double *a, const MKL_INT *lda,
+                            double *s, double *u, const MKL_INT *ldu,
+                            double *vt, const MKL_INT *ldvt, double *work,
+                            const MKL_INT *lwork, MKL_INT *iwork,
+                            MKL_INT *info);
+
 // least squares problem a * x = b
 extern VRETT LFNAME(dgels)(const char *trans, const MKL_INT *m,
                            const MKL_INT *n, const MKL_INT *nrhs, double *a,
@@ -669,6 +697,30 @@ inline void xgesvd<float>(const char *jobu, const char *jobvt, const MKL_INT *m,
     (jobu, jobvt, m, n, a, lda, s, u, ldu, vt, ldvt, work, lwork, info);
 }
 
+template <typename FL>
+inline void xgesdd(const char *jobz, const MKL_INT *m, const MKL_INT *n, FL *a,
+                   const MKL_INT *lda, typename GMatrix<FL>::FP *s, FL *u,
+                   const MKL_INT *ldu, FL *vt, const MKL_INT *ldvt, FL *work,
+                   const MKL_INT *lwork, MKL_INT *iwork, MKL_INT *info);
+template <>
+inline void xgesdd<double>(const char *jobz, const MKL_INT *m, const MKL_INT *n,
+                           double *a, const MKL_INT *lda, double *s, double *u,
+                           const MKL_INT *ldu, double *vt, const MKL_INT *ldvt,
+                           double *work, const MKL_INT *lwork, MKL_INT *iwork,
+                           MKL_INT *info) {
+    LFNAME(dgesdd)
+    (jobz, m, n, a, lda, s, u, ldu, vt, ldvt, work, lwork, iwork, info);
+}
+template <>
+inline void xgesdd<float>(const char *jobz, const MKL_INT *m, const MKL_INT *n,
+                          float *a, const MKL_INT *lda, float *s, float *u,
+                          const MKL_INT *ldu, float *vt, const MKL_INT *ldvt,
+                          float *work, const MKL_INT *lwork, MKL_INT *iwork,
+                          MKL_INT *info) {
+    LFNAME(sgesdd)
+    (jobz, m, n, a, lda, s, u, ldu, vt, ldvt, work, lwork, iwork, info);
+}
+
 template <typename FL>
 inline void xsyev(const char *jobz, const char *uplo, const MKL_INT *n, FL *a,
                   const MKL_INT *lda, FL *w, FL *work, const MKL_INT *lwork,
@@ -688,6 +740,29 @@ inline void xsyev<float>(const char *jobz, const char *uplo, const MKL_INT *n,
     LFNAME(ssyev)(jobz, uplo, n, a, lda, w, work, lwork, info);
 }
 
+template <typename FL>
+inline void xsyevd(const char *jobz, const char *uplo, const MKL_INT *n, FL *a,
+                   const MKL_INT *lda, FL *w, FL *work, const MKL_INT *lwork,
+                   MKL_INT *iwork, const MKL_INT *liwork, MKL_INT *info);
+
+template <>
+inline void xsyevd<double>(const char *jobz, const char *uplo, const MKL_INT *n,
+                           double *a, const MKL_INT *lda, double *w,
+                           double *work, const MKL_INT *lwork, MKL_INT *iwork,
+                           const MKL_INT *liwork, MKL_INT *info) {
+    LFNAME(dsyevd)
+    (jobz, uplo, n, a, lda, w, work, lwork, iwork, liwork, info);
+}
+
+template <>
+inline void xsyevd<float>(const char *jobz, const char *uplo, const MKL_INT *n,
+                          float *a, const MKL_INT *lda, float *w, float *work,
+                          const MKL_INT *lwork, MKL_INT *iwork,
+                          const MKL_INT *liwork, MKL_INT *info) {
+    LFNAME(ssyevd)
+    (jobz, uplo, n, a, lda, w, work, lwork, iwork, liwork, info);
+}
+
 template <typename FL>
 inline void xsygv(const MKL_INT *itype, const char *jobz, const char *uplo,
                   const MKL_INT *n, FL *a, const MKL_INT *lda, FL *b,
@@ -740,6 +815,13 @@ inline void xheev(const char *jobz, const char *uplo, const MKL_INT *n, FL *a,
                   const MKL_INT *lwork, typename GMatrix<FL>::FP *rwork,
                   MKL_INT *info);
 
+template <typename FL>
+inline void xheevd(const char *jobz, const char *uplo, const MKL_INT *n, FL *a,
+                   const MKL_INT *lda, typename GMatrix<FL>::FP *w, FL *work,
+                   const MKL_INT *lwork, typename GMatrix<FL>::FP *rwork,
+                   const MKL_INT *lrwork, MKL_INT *iwork,
+                   const MKL_INT *liwork, MKL_INT *info);
+
 template <typename FL>
 inline void xhegv(const MKL_INT *itype, const char *jobz, const char *uplo,
                   const MKL_INT *n, FL *a, const MKL_INT *lda, FL *b,
@@ -1413,6 +1495,29 @@ struct GMatrixFunctions<
         assert(info == 0);
         d_alloc->deallocate(work, lwork);
     }
+    // SVD using divide-and-conquer driver (faster for large matrices and
+    // scales better with threaded LAPACK); original matrix will be destroyed
+    static void svd_dc(const GMatrix<FL> &a, const GMatrix<FL> &l,
+                       const GMatrix<FL> &s, const GMatrix<FL> &r) {
+        shared_ptr<VectorAllocator<FL>> d_alloc =
+            make_shared<VectorAllocator<FL>>();
+        shared_ptr<VectorAllocator<MKL_INT>> i_alloc =
+            make_shared<VectorAllocator<MKL_INT>>();
+        MKL_INT k = min(a.m, a.n), info = 0, lwork = -1;
+        FL twork;
+        assert(a.m == l.m && a.n == r.n && l.n >= k && r.m == k && s.n == k);
+        MKL_INT *iwork = i_alloc->allocate(8 * k);
+        xgesdd<FL>("S", &a.n, &a.m, a.data, &a.n, s.data, r.data, &a.n,
+                   l.data, &l.n, &twork, &lwork, iwork, &info);
+        assert(info == 0);
+        lwork = (MKL_INT)twork;
+        FL *work = d_alloc->allocate(lwork);
+        xgesdd<FL>("S", &a.n, &a.m, a.data, &a.n, s.data, r.data, &a.n,
+                   l.data, &l.n, work, &lwork, iwork, &info);
+        assert(info == 0);
+        d_alloc->deallocate(work, lwork);
+        i_alloc->deallocate(iwork, 8 * k);
+    }
     // Rank revealing QR; original matrix will be destroyed
     static void rrqr(const GMatrix<FL> &a, const GMatrix<FL> &l,
                      const GMatrix<FL> &s, const GMatrix<FL> &r) {
@@ -1686,6 +1791,28 @@ struct GMatrixFunctions<
         // assert(info == 0);
         d_alloc->deallocate(work, lwork);
     }
+    // eigenvectors are row vectors (divide-and-conquer driver)
+    static void eigs_dc(const GMatrix<FL> &a, const GDiagonalMatrix<FL> &w) {
+        shared_ptr<VectorAllocator<FL>> d_alloc =
+            make_shared<VectorAllocator<FL>>();
+        shared_ptr<VectorAllocator<MKL_INT>> i_alloc =
+            make_shared<VectorAllocator<MKL_INT>>();
+        assert(a.m == a.n && w.n == a.n);
+        MKL_INT lwork = -1, liwork = -1, info, tiwork;
+        FL twork;
+        xsyevd<FL>("V", "U", &a.n, a.data, &a.n, w.data, &twork, &lwork,
+                   &tiwork, &liwork, &info);
+        assert(info == 0);
+        lwork = (MKL_INT)twork, liwork = tiwork;
+        FL *work = d_alloc->allocate(lwork);
+        MKL_INT *iwork = i_alloc->allocate(liwork);
+        xsyevd<FL>("V", "U", &a.n, a.data, &a.n, w.data, work, &lwork, iwork,
+                   &liwork, &info);
+        if (info != 0)
+            cout << "ATTENTION: xsyevd info = " << info << "\n";
+        i_alloc->deallocate(iwork, liwork);
+        d_alloc->deallocate(work, lwork);
+    }
     // eigenvectors for non-symmetric matrices
     // if any eigenvalue is complex, eigenvectors are stored in separate real
     // and imag part form
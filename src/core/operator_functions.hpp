@@ -70,6 +70,10 @@ template <typename S, typename FL> struct OperatorFunctions {
     typedef typename GMatrix<FL>::FP FP;
     shared_ptr<CG<S>> cg;
     shared_ptr<BatchGEMMSeq<FL>> seq = nullptr;
+    // if second != -1, only blocks [first, second) of the result of
+    // tensor_product (and of the source of tensor_rotate) are touched,
+    // and they are stored contiguously from the data pointer
+    pair<int, int> block_window = make_pair(0, -1);
     OperatorFunctions(const shared_ptr<CG<S>> &cg) : cg(cg) {
         seq = make_shared<BatchGEMMSeq<FL>>(0, threading->seq_type);
     }
@@ -83,6 +87,20 @@ template <typename S, typename FL> struct OperatorFunctions {
         opf->seq = this->seq->copy();
         return opf;
     }
+    // block i of a, taking block_window into account
+    GMatrix<FL> window_block(const shared_ptr<SparseMatrix<S, FL>> &a,
+                             int i) const {
+        if (block_window.second == -1)
+            return (*a)[i];
+        return GMatrix<FL>(a->data + (a->info->block_shifts[i] -
+                                      a->info->block_shifts[block_window.first]),
+                           (int)a->info->n_states_bra[i],
+                           (int)a->info->n_states_ket[i]);
+    }
+    bool in_block_window(int i) const {
+        return block_window.second == -1 ||
+               (i >= block_window.first && i < block_window.second);
+    }
     virtual void
     parallel_reduce(const vector<shared_ptr<SparseMatrix<S, FL>>> &mats, int i,
                     int j) const {
@@ -193,17 +211,21 @@ template <typename S, typename FL> struct OperatorFunctions {
         for (int ic = 0, ia = 0; ic < c->info->n; ia++, ic++) {
             while (a->info->quanta[ia] != c->info->quanta[ic])
                 ia++;
+            if (block_window.second != -1 && ia >= block_window.second)
+                break;
+            if (!in_block_window(ia))
+                continue;
             S cq = c->info->quanta[ic].get_bra(cdq);
             S cqprime = c->info->quanta[ic].get_ket();
             int ibra = rot_bra->info->find_state(cq);
             int iket = rot_ket->info->find_state(cqprime);
             if (seq->mode != SeqTypes::None && seq->mode != SeqTypes::Tasked)
-                seq->rotate((*a)[ia], (*c)[ic], (*rot_bra)[ibra],
+                seq->rotate(window_block(a, ia), (*c)[ic], (*rot_bra)[ibra],
                             (int)!trans | 2, (*rot_ket)[iket], trans, scale);
             else
-                GMatrixFunctions<FL>::rotate((*a)[ia], (*c)[ic],
-                                             (*rot_bra)[ibra], (int)!trans | 2,
-                                             (*rot_ket)[iket], trans, scale);
+                GMatrixFunctions<FL>::rotate(
+                    window_block(a, ia), (*c)[ic], (*rot_bra)[ibra],
+                    (int)!trans | 2, (*rot_ket)[iket], trans, scale);
         }
         if (seq->mode & SeqTypes::Simple)
             seq->simple_perform();
@@ -497,6 +519,10 @@ template <typename S, typename FL> struct OperatorFunctions {
         assert(ik < cinfo->n[conj + 1]);
         int ixa = cinfo->idx[ik];
         int ixb = ik == cinfo->n[4] - 1 ? cinfo->nc : cinfo->idx[ik + 1];
+        // sparsity screening is only possible when data is present
+        const bool screen =
+            seq->screen_thrd != 0 && tt == TraceTypes::None &&
+            (seq->mode == SeqTypes::None || seq->mode == SeqTypes::Simple);
         for (int il = ixa; il < ixb; il++) {
             int ia = cinfo->ia[il], ib = cinfo->ib[il], ic = cinfo->ic[il],
                 iv = (int)cinfo->stride[il];
@@ -504,6 +530,12 @@ template <typename S, typename FL> struct OperatorFunctions {
                 iv <= (int)cinfo->stride[il - 1])
                 seq->simple_perform();
             double factor = cinfo->factor[il];
+            if (screen &&
+                seq->screen(abs(scale * (FP)factor) *
+                            GMatrixFunctions<FL>::norm((*a)[ia]) *
+                            GMatrixFunctions<FL>::norm((*b)[ib]) *
+                            GMatrixFunctions<FL>::norm((*c)[ic])))
+                continue;
             switch (tt) {
             case TraceTypes::None:
                 if (seq->mode != SeqTypes::None)
@@ -693,18 +725,28 @@ template <typename S, typename FL> struct OperatorFunctions {
         assert(ik < cinfo->n[conj + 1]);
         int ixa = cinfo->idx[ik];
         int ixb = ik == cinfo->n[4] - 1 ? cinfo->nc : cinfo->idx[ik + 1];
+        // entries are ordered by the block of c
+        if (block_window.second != -1) {
+            const uint32_t *pic = cinfo->ic;
+            ixa = (int)(lower_bound(pic + ixa, pic + ixb,
+                                    (uint32_t)block_window.first) -
+                        pic);
+            ixb = (int)(lower_bound(pic + ixa, pic + ixb,
+                                    (uint32_t)block_window.second) -
+                        pic);
+        }
         for (int il = ixa; il < ixb; il++) {
             int ia = cinfo->ia[il], ib = cinfo->ib[il], ic = cinfo->ic[il];
             uint64_t stride = cinfo->stride[il];
             double factor = cinfo->factor[il];
             if (seq->mode != SeqTypes::None && seq->mode != SeqTypes::Tasked)
                 seq->tensor_product((*a)[ia], conj & 1, (*b)[ib],
-                                    (conj & 2) >> 1, (*c)[ic],
+                                    (conj & 2) >> 1, window_block(c, ic),
                                     scale * (FP)factor, stride);
             else
                 GMatrixFunctions<FL>::tensor_product(
-                    (*a)[ia], conj & 1, (*b)[ib], (conj & 2) >> 1, (*c)[ic],
-                    scale * (FP)factor, stride);
+                    (*a)[ia], conj & 1, (*b)[ib], (conj & 2) >> 1,
+                    window_block(c, ic), scale * (FP)factor, stride);
         }
         if (seq->mode & SeqTypes::Simple)
             seq->simple_perform();
@@ -45,8 +45,20 @@ template <typename S, typename FL> struct OperatorTensor {
     shared_ptr<Symbolic<S>> lmat, rmat;
     // SparseMatrix representation of symbols
     unordered_map<shared_ptr<OpExpr<S>>, shared_ptr<SparseMatrix<S, FL>>> ops;
+    // stored type of low-rank delayed operators; other operators are
+    // stored with get_type(), so files without them keep the old layout
+    static const uint8_t low_rank_tag =
+        0x80 | (uint8_t)SparseMatrixTypes::Delayed;
     OperatorTensor() : lmat(nullptr), rmat(nullptr) {}
     virtual ~OperatorTensor() = default;
+    static void write_type(ostream &ofs,
+                           const shared_ptr<SparseMatrix<S, FL>> &mat) {
+        uint8_t tp = (uint8_t)mat->get_type();
+        if (dynamic_pointer_cast<DelayedSparseMatrix<S, FL, LowRankBasis<FL>>>(
+                mat) != nullptr)
+            tp = low_rank_tag;
+        ofs.write((char *)&tp, sizeof(tp));
+    }
     virtual OperatorTensorTypes get_type() const {
         return OperatorTensorTypes::Normal;
     }
@@ -96,6 +108,22 @@ template <typename S, typename FL> struct OperatorTensor {
             make_shared<VectorAllocator<FP>>();
         shared_ptr<VectorAllocator<uint32_t>> i_alloc =
             make_shared<VectorAllocator<uint32_t>>();
+        // compact layout: shared info records and one data slab
+        const bool compact = sz == -1;
+        vector<shared_ptr<SparseMatrixInfo<S>>> infos;
+        vector<shared_ptr<SparseMatrix<S, FL>>> slab_mats;
+        if (compact) {
+            ifs.read((char *)&sz, sizeof(sz));
+            int ninfo;
+            ifs.read((char *)&ninfo, sizeof(ninfo));
+            infos.resize(ninfo);
+            for (int i = 0; i < ninfo; i++) {
+                infos[i] = make_shared<SparseMatrixInfo<S>>(i_alloc);
+                if (pointer_only)
+                    infos[i]->alloc = ialloc;
+                infos[i]->load_data(ifs, pointer_only);
+            }
+        }
         ops.reserve(sz);
         for (int i = 0; i < sz; i++) {
             shared_ptr<OpExpr<S>> expr = load_expr<S, FL>(ifs);
@@ -109,15 +137,84 @@ template <typename S, typename FL> struct OperatorTensor {
             else if (tp == SparseMatrixTypes::Delayed)
                 mat = make_shared<DelayedSparseMatrix<S, FL, OpExpr<S>>>(
                     0, nullptr, nullptr);
-            else
+            else if ((uint8_t)tp == low_rank_tag) {
+                mat = make_shared<
+                    DelayedSparseMatrix<S, FL, LowRankBasis<FL>>>();
+                mat->alloc = d_alloc;
+            } else
                 assert(false);
-            mat->info = make_shared<SparseMatrixInfo<S>>(i_alloc);
             if (pointer_only)
-                mat->alloc = dalloc_<FP>(), mat->info->alloc = ialloc;
-            mat->info->load_data(ifs, pointer_only);
-            mat->load_data(ifs, pointer_only);
+                mat->alloc = dalloc_<FP>();
+            if (compact) {
+                int iinfo;
+                uint8_t in_slab;
+                ifs.read((char *)&iinfo, sizeof(iinfo));
+                ifs.read((char *)&in_slab, sizeof(in_slab));
+                mat->info = infos[iinfo];
+                if (in_slab) {
+                    ifs.read((char *)&mat->factor, sizeof(mat->factor));
+                    ifs.read((char *)&mat->total_memory,
+                             sizeof(mat->total_memory));
+                    slab_mats.push_back(mat);
+                } else
+                    mat->load_data(ifs, pointer_only);
+            } else {
+                mat->info = make_shared<SparseMatrixInfo<S>>(i_alloc);
+                if (pointer_only)
+                    mat->info->alloc = ialloc;
+                mat->info->load_data(ifs, pointer_only);
+                mat->load_data(ifs, pointer_only);
+            }
             ops[expr] = mat;
         }
+        if (compact)
+            load_slab(ifs, slab_mats);
+    }
+    // read the data of all slab operators in one contiguous read
+    static void
+    load_slab(istream &ifs,
+              const vector<shared_ptr<SparseMatrix<S, FL>>> &slab_mats) {
+        const int cpx_sz = SparseMatrix<S, FL>::cpx_sz;
+        uint32_t xalign;
+        size_t slab_size;
+        ifs.read((char *)&xalign, sizeof(xalign));
+        ifs.read((char *)&slab_size, sizeof(slab_size));
+        if (slab_mats.size() == 0)
+            return;
+        const uint32_t cur_xalign =
+            threading->align_type != AlignTypes::None
+                ? (uint8_t)threading->align_type / sizeof(FP)
+                : 1;
+        shared_ptr<SlabAllocator<FP>> slab =
+            make_shared<SlabAllocator<FP>>(slab_size);
+        if (xalign == cur_xalign) {
+            ifs.read((char *)slab->data, sizeof(FP) * slab_size);
+            for (auto &mat : slab_mats) {
+                mat->alloc = slab;
+                mat->data =
+                    (FL *)slab->allocate(mat->total_memory * cpx_sz);
+            }
+        } else {
+            // alignment changed since saving: relayout the slab
+            vector<FP> tmp(slab_size);
+            ifs.read((char *)tmp.data(), sizeof(FP) * slab_size);
+            size_t new_size = 0;
+            for (auto &mat : slab_mats)
+                new_size = (new_size + cur_xalign - 1) / cur_xalign *
+                               cur_xalign +
+                           mat->total_memory * cpx_sz;
+            slab = make_shared<SlabAllocator<FP>>(new_size);
+            size_t offset = 0;
+            for (auto &mat : slab_mats) {
+                offset = (offset + xalign - 1) / xalign * xalign;
+                mat->alloc = slab;
+                mat->data =
+                    (FL *)slab->allocate(mat->total_memory * cpx_sz);
+                memcpy(mat->data, tmp.data() + offset,
+                       sizeof(FL) * mat->total_memory);
+                offset += mat->total_memory * cpx_sz;
+            }
+        }
     }
     void save_data(ostream &ofs, bool pointer_only = false) const {
         uint8_t lr = lmat == rmat
@@ -132,6 +229,10 @@ template <typename S, typename FL> struct OperatorTensor {
             save_symbolic(lmat, ofs);
             save_symbolic(rmat, ofs);
         }
+        if (frame_<FP>()->compact_operator_storage) {
+            save_compact_data(ofs, pointer_only);
+            return;
+        }
         int sz = (int)ops.size();
         ofs.write((char *)&sz, sizeof(sz));
         for (auto &op : ops) {
@@ -141,11 +242,75 @@ template <typename S, typename FL> struct OperatorTensor {
             assert(tp == SparseMatrixTypes::Normal ||
                    tp == SparseMatrixTypes::CSR ||
                    tp == SparseMatrixTypes::Delayed);
-            ofs.write((char *)&tp, sizeof(tp));
+            write_type(ofs, op.second);
             op.second->info->save_data(ofs, pointer_only);
             op.second->save_data(ofs, pointer_only);
         }
     }
+    // ops with the same info share one record; data of normal ops
+    // (if not pointer_only or compressed) is written as one slab at the end
+    void save_compact_data(ostream &ofs, bool pointer_only) const {
+        const int cpx_sz = SparseMatrix<S, FL>::cpx_sz;
+        int sz = -1;
+        ofs.write((char *)&sz, sizeof(sz));
+        sz = (int)ops.size();
+        ofs.write((char *)&sz, sizeof(sz));
+        unordered_map<SparseMatrixInfo<S> *, int> info_idx;
+        vector<SparseMatrixInfo<S> *> infos;
+        for (auto &op : ops) {
+            assert(op.second != nullptr && op.second->info != nullptr);
+            if (!info_idx.count(op.second->info.get())) {
+                info_idx[op.second->info.get()] = (int)infos.size();
+                infos.push_back(op.second->info.get());
+            }
+        }
+        int ninfo = (int)infos.size();
+        ofs.write((char *)&ninfo, sizeof(ninfo));
+        for (auto &info : infos)
+            info->save_data(ofs, pointer_only);
+        const uint32_t xalign =
+            threading->align_type != AlignTypes::None
+                ? (uint8_t)threading->align_type / sizeof(FP)
+                : 1;
+        vector<shared_ptr<SparseMatrix<S, FL>>> slab_mats;
+        size_t slab_size = 0;
+        for (auto &op : ops) {
+            save_expr(op.first, ofs);
+            SparseMatrixTypes tp = op.second->get_type();
+            assert(tp == SparseMatrixTypes::Normal ||
+                   tp == SparseMatrixTypes::CSR ||
+                   tp == SparseMatrixTypes::Delayed);
+            write_type(ofs, op.second);
+            int iinfo = info_idx.at(op.second->info.get());
+            ofs.write((char *)&iinfo, sizeof(iinfo));
+            uint8_t in_slab = tp == SparseMatrixTypes::Normal &&
+                              !pointer_only &&
+                              !frame_<FP>()->compressed_sparse_tensor_storage &&
+                              op.second->total_memory != 0;
+            ofs.write((char *)&in_slab, sizeof(in_slab));
+            if (in_slab) {
+                ofs.write((char *)&op.second->factor,
+                          sizeof(op.second->factor));
+                ofs.write((char *)&op.second->total_memory,
+                          sizeof(op.second->total_memory));
+                slab_mats.push_back(op.second);
+                slab_size = (slab_size + xalign - 1) / xalign * xalign +
+                            op.second->total_memory * cpx_sz;
+            } else
+                op.second->save_data(ofs, pointer_only);
+        }
+        ofs.write((char *)&xalign, sizeof(xalign));
+        ofs.write((char *)&slab_size, sizeof(slab_size));
+        const FP zero[64] = {0};
+        size_t offset = 0;
+        for (auto &mat : slab_mats) {
+            size_t pad = (offset + xalign - 1) / xalign * xalign - offset;
+            ofs.write((char *)zero, sizeof(FP) * pad);
+            ofs.write((char *)mat->data, sizeof(FL) * mat->total_memory);
+            offset += pad + mat->total_memory * cpx_sz;
+        }
+        assert(offset == slab_size);
+    }
     shared_ptr<OperatorTensor> copy() const {
         shared_ptr<OperatorTensor> r = make_shared<OperatorTensor>();
         r->lmat = lmat, r->rmat = rmat;
@@ -157,7 +322,7 @@ template <typename S, typename FL> struct OperatorTensor {
               const shared_ptr<Allocator<FP>> &ref_alloc = nullptr) const {
         shared_ptr<OperatorTensor> r = make_shared<OperatorTensor>();
         r->lmat = lmat, r->rmat = rmat;
-        vector<shared_ptr<OpExpr<S>>> op_keys;
+        vector<shared_ptr<OpExpr<S>>> op_keys, low_rank_keys;
         r->ops.reserve(ops.size());
         op_keys.reserve(ops.size());
         for (auto &p : ops) {
@@ -187,13 +352,38 @@ template <typename S, typename FL> struct OperatorTensor {
                 mat->factor = pmat->factor;
                 mat->sparse_type = pmat->sparse_type;
                 r->ops[p.first] = mat;
-            } else if (p.second->get_type() == SparseMatrixTypes::Delayed)
+            } else if (p.second->get_type() == SparseMatrixTypes::Delayed) {
                 r->ops[p.first] =
                     dynamic_pointer_cast<DelayedSparseMatrix<S, FL>>(p.second)
                         ->copy();
-            else
+                if (dynamic_pointer_cast<
+                        DelayedSparseMatrix<S, FL, LowRankBasis<FL>>>(
+                        p.second) != nullptr)
+                    low_rank_keys.push_back(p.first);
+            } else
                 assert(false);
         }
+        // low-rank basis is copied once by its owner and then shared
+        unordered_map<LowRankBasis<FL> *, shared_ptr<LowRankBasis<FL>>>
+            low_rank_mp;
+        for (auto &k : low_rank_keys) {
+            shared_ptr<DelayedSparseMatrix<S, FL, LowRankBasis<FL>>> pmat =
+                dynamic_pointer_cast<
+                    DelayedSparseMatrix<S, FL, LowRankBasis<FL>>>(ops.at(k));
+            if (pmat->owner && pmat->alloc == ref_alloc) {
+                shared_ptr<DelayedSparseMatrix<S, FL, LowRankBasis<FL>>> mat =
+                    pmat->copy_with_basis(alloc);
+                low_rank_mp[pmat->basis.get()] = mat->basis;
+                r->ops.at(k) = mat;
+            }
+        }
+        for (auto &k : low_rank_keys) {
+            shared_ptr<DelayedSparseMatrix<S, FL, LowRankBasis<FL>>> mat =
+                dynamic_pointer_cast<
+                    DelayedSparseMatrix<S, FL, LowRankBasis<FL>>>(r->ops.at(k));
+            if (low_rank_mp.count(mat->basis.get()))
+                mat->basis = low_rank_mp.at(mat->basis.get());
+        }
         int ntg = threading->activate_global();
 #pragma omp parallel for schedule(static, 20) num_threads(ntg)
         for (int i = 0; i < (int)op_keys.size(); i++)
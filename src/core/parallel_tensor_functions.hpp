@@ -52,6 +52,10 @@ struct ParallelTensorFunctions : TensorFunctions<S, FL> {
                     FL scale = (FL)1.0) override {
         opf->seq->operator()(b, c, scale);
         rule->comm->allreduce_sum(c.data, c.size());
+        if (opf->seq->screen_thrd != 0) {
+            rule->comm->allreduce_sum(&opf->seq->screen_error, 1);
+            opf->seq->screen_end();
+        }
     }
     // c = a
     void left_assign(const shared_ptr<OperatorTensor<S, FL>> &a,
@@ -826,8 +830,12 @@ struct ParallelTensorFunctions : TensorFunctions<S, FL> {
             } else
                 TensorFunctions<S, FL>::tensor_product_multiply(
                     op->op, xexpr, lopt, ropt, cmat, vmat, opdq, false);
-            if (all_reduce)
+            if (all_reduce) {
                 rule->comm->allreduce_sum(vmat);
+                // skipped contributions of all ranks
+                if (opf->seq->screen_thrd != 0)
+                    rule->comm->allreduce_sum(&opf->seq->screen_error, 1);
+            }
         } else
             TensorFunctions<S, FL>::tensor_product_multiply(
                 expr, xexpr, lopt, ropt, cmat, vmat, opdq, false);
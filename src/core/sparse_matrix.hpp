@@ -1053,7 +1053,7 @@ template <typename S, typename FL> struct SparseMatrix {
         FL *ptr = (FL *)alloc->reallocate((FP *)data, total_memory * cpx_sz,
                                           length * cpx_sz);
         if (ptr != data && length != 0)
-            memmove(ptr, data, length * sizeof(FL));
+            memmove(ptr, data, min(length, total_memory) * sizeof(FL));
         total_memory = length;
         data = length == 0 ? nullptr : ptr;
     }
@@ -1317,9 +1317,11 @@ template <typename S, typename FL> struct SparseMatrix {
         vector<shared_ptr<GTensor<FL>>> merged_l(nr);
         r.resize(nr);
         s.resize(nr);
-        int ntg = threading->activate_global();
-#pragma omp parallel for schedule(dynamic) num_threads(ntg)
-        for (int ir = 0; ir < nr; ir++) {
+        vector<pair<size_t, size_t>> dims(nr);
+        for (int ir = 0; ir < nr; ir++)
+            dims[ir] = make_pair((size_t)sz[ir],
+                                 (size_t)((tmp[ir + 1] - tmp[ir]) / sz[ir]));
+        threading->parallel_decompose(dims, [&](int ir, bool large) {
             MKL_INT nxr = sz[ir], nxl = (tmp[ir + 1] - tmp[ir]) / nxr;
             assert((tmp[ir + 1] - tmp[ir]) % nxr == 0);
             MKL_INT nxk = min(nxl, nxr);
@@ -1333,6 +1335,10 @@ template <typename S, typename FL> struct SparseMatrix {
                 GMatrixFunctions<FL>::accurate_svd(
                     GMatrix<FL>(dt + tmp[ir], nxl, nxr), tsl->ref(),
                     tss->ref().flip_dims(), tsr->ref(), svd_eps);
+            else if (large)
+                GMatrixFunctions<FL>::svd_dc(
+                    GMatrix<FL>(dt + tmp[ir], nxl, nxr), tsl->ref(),
+                    tss->ref().flip_dims(), tsr->ref());
             else
                 GMatrixFunctions<FL>::svd(GMatrix<FL>(dt + tmp[ir], nxl, nxr),
                                           tsl->ref(), tss->ref().flip_dims(),
@@ -1340,7 +1346,7 @@ template <typename S, typename FL> struct SparseMatrix {
             merged_l[ir] = tsl;
             s[ir] = tss;
             r[ir] = tsr;
-        }
+        });
         threading->activate_normal();
         vector<FP> svals;
         for (int ir = 0; ir < nr; ir++)
@@ -1413,9 +1419,11 @@ template <typename S, typename FL> struct SparseMatrix {
         vector<shared_ptr<GTensor<FL>>> merged_r(nl);
         l.resize(nl);
         s.resize(nl);
-        int ntg = threading->activate_global();
-#pragma omp parallel for schedule(dynamic) num_threads(ntg)
-        for (int il = 0; il < nl; il++) {
+        vector<pair<size_t, size_t>> dims(nl);
+        for (int il = 0; il < nl; il++)
+            dims[il] = make_pair((size_t)sz[il],
+                                 (size_t)((tmp[il + 1] - tmp[il]) / sz[il]));
+        threading->parallel_decompose(dims, [&](int il, bool large) {
             MKL_INT nxl = sz[il], nxr = (tmp[il + 1] - tmp[il]) / nxl;
             assert((tmp[il + 1] - tmp[il]) % nxl == 0);
             MKL_INT nxk = min(nxl, nxr);
@@ -1429,6 +1437,10 @@ template <typename S, typename FL> struct SparseMatrix {
                 GMatrixFunctions<FL>::accurate_svd(
                     GMatrix<FL>(dt + tmp[il], nxl, nxr), tsl->ref(),
                     tss->ref().flip_dims(), tsr->ref(), svd_eps);
+            else if (large)
+                GMatrixFunctions<FL>::svd_dc(
+                    GMatrix<FL>(dt + tmp[il], nxl, nxr), tsl->ref(),
+                    tss->ref().flip_dims(), tsr->ref());
             else
                 GMatrixFunctions<FL>::svd(GMatrix<FL>(dt + tmp[il], nxl, nxr),
                                           tsl->ref(), tss->ref().flip_dims(),
@@ -1436,7 +1448,7 @@ template <typename S, typename FL> struct SparseMatrix {
             l[il] = tsl;
             s[il] = tss;
             merged_r[il] = tsr;
-        }
+        });
         threading->activate_normal();
         vector<FP> svals;
         for (int il = 0; il < nl; il++)
@@ -1473,97 +1485,133 @@ template <typename S, typename FL> struct SparseMatrix {
             assert(it[il] == merged_r[il]->shape[1]);
         dalloc_<FP>()->deallocate(dt, tmp[nl] * cpx_sz);
     }
-    void left_canonicalize(const shared_ptr<SparseMatrix> &rmat) {
-        int nr = rmat->info->n, n = info->n;
-        vector<MKL_INT> tmp(nr + 1, 0);
+    // blocks sharing the same ket (left = true) or bra (left = false)
+    // quantum number with xmat, grouped as sectors of xmat
+    // sec_blocks[sec_shifts[ix] : sec_shifts[ix + 1]] are in original order
+    void canonicalize_sectors(const shared_ptr<SparseMatrix> &xmat, bool left,
+                              vector<int> &sec_shifts,
+                              vector<int> &sec_blocks) const {
+        int nx = xmat->info->n, n = info->n;
+        vector<int> bsec(n);
+        sec_shifts.assign(nx + 1, 0);
         for (int i = 0; i < n; i++) {
-            int ir = rmat->info->find_state(info->quanta[i].get_ket());
-            assert(ir != -1);
-            tmp[ir + 1] +=
-                (MKL_INT)info->n_states_bra[i] * info->n_states_ket[i];
-        }
-        for (int ir = 0; ir < nr; ir++)
-            tmp[ir + 1] += tmp[ir];
-        FL *dt = (FL *)dalloc_<FP>()->allocate(tmp[nr] * cpx_sz);
-        vector<MKL_INT> it(nr, 0);
-        for (int i = 0; i < n; i++) {
-            int ir = rmat->info->find_state(info->quanta[i].get_ket());
-            MKL_INT n_states =
-                (MKL_INT)info->n_states_bra[i] * info->n_states_ket[i];
-            memcpy(dt + (tmp[ir] + it[ir]), data + info->block_shifts[i],
-                   n_states * sizeof(FL));
-            it[ir] += n_states;
-        }
-        for (int ir = 0; ir < nr; ir++)
-            assert(it[ir] == tmp[ir + 1] - tmp[ir]);
+            bsec[i] = xmat->info->find_state(
+                left ? info->quanta[i].get_ket()
+                     : info->quanta[i].get_bra(info->delta_quantum));
+            assert(bsec[i] != -1);
+            sec_shifts[bsec[i] + 1]++;
+        }
+        for (int ix = 0; ix < nx; ix++)
+            sec_shifts[ix + 1] += sec_shifts[ix];
+        vector<int> it(sec_shifts.begin(), sec_shifts.end() - 1);
+        sec_blocks.resize(n);
+        for (int i = 0; i < n; i++)
+            sec_blocks[it[bsec[i]]++] = i;
+    }
+    // this = Q * rmat, one QR per ket sector (sectors in parallel)
+    // sectors with a single block are factorized in place
+    void left_canonicalize(const shared_ptr<SparseMatrix> &rmat) {
+        int nr = rmat->info->n;
+        vector<int> sec_shifts, sec_blocks;
+        canonicalize_sectors(rmat, true, sec_shifts, sec_blocks);
+        vector<pair<size_t, size_t>> dims(nr);
         for (int ir = 0; ir < nr; ir++) {
-            MKL_INT nxr = rmat->info->n_states_ket[ir],
-                    nxl = (tmp[ir + 1] - tmp[ir]) / nxr;
-            assert((tmp[ir + 1] - tmp[ir]) % nxr == 0 && nxl >= nxr);
-            GMatrixFunctions<FL>::qr(GMatrix<FL>(dt + tmp[ir], nxl, nxr),
-                                     GMatrix<FL>(dt + tmp[ir], nxl, nxr),
-                                     (*rmat)[ir]);
-        }
-        memset(it.data(), 0, sizeof(MKL_INT) * nr);
-        for (int i = 0; i < n; i++) {
-            int ir = rmat->info->find_state(info->quanta[i].get_ket());
-            MKL_INT n_states =
-                (MKL_INT)info->n_states_bra[i] * info->n_states_ket[i];
-            memcpy(data + info->block_shifts[i], dt + (tmp[ir] + it[ir]),
-                   n_states * sizeof(FL));
-            it[ir] += n_states;
-        }
-        dalloc_<FP>()->deallocate(dt, tmp[nr] * cpx_sz);
+            dims[ir] =
+                make_pair((size_t)0, (size_t)rmat->info->n_states_ket[ir]);
+            for (int k = sec_shifts[ir]; k < sec_shifts[ir + 1]; k++)
+                dims[ir].first += info->n_states_bra[sec_blocks[k]];
+        }
+        threading->parallel_decompose(dims, [&](int ir, bool large) {
+            MKL_INT nxl = (MKL_INT)dims[ir].first,
+                    nxr = (MKL_INT)dims[ir].second;
+            if (sec_shifts[ir + 1] == sec_shifts[ir])
+                return;
+            assert(nxl >= nxr);
+            if (sec_shifts[ir + 1] - sec_shifts[ir] == 1) {
+                FL *pd = data + info->block_shifts[sec_blocks[sec_shifts[ir]]];
+                GMatrixFunctions<FL>::qr(GMatrix<FL>(pd, nxl, nxr),
+                                         GMatrix<FL>(pd, nxl, nxr),
+                                         (*rmat)[ir]);
+                return;
+            }
+            shared_ptr<VectorAllocator<FP>> d_alloc =
+                make_shared<VectorAllocator<FP>>();
+            FL *dt = (FL *)d_alloc->allocate((size_t)nxl * nxr * cpx_sz);
+            MKL_INT p = 0;
+            for (int k = sec_shifts[ir]; k < sec_shifts[ir + 1]; k++) {
+                const int i = sec_blocks[k];
+                MKL_INT n_states = (MKL_INT)info->n_states_bra[i] * nxr;
+                memcpy(dt + p, data + info->block_shifts[i],
+                       n_states * sizeof(FL));
+                p += n_states;
+            }
+            GMatrixFunctions<FL>::qr(GMatrix<FL>(dt, nxl, nxr),
+                                     GMatrix<FL>(dt, nxl, nxr), (*rmat)[ir]);
+            p = 0;
+            for (int k = sec_shifts[ir]; k < sec_shifts[ir + 1]; k++) {
+                const int i = sec_blocks[k];
+                MKL_INT n_states = (MKL_INT)info->n_states_bra[i] * nxr;
+                memcpy(data + info->block_shifts[i], dt + p,
+                       n_states * sizeof(FL));
+                p += n_states;
+            }
+            d_alloc->deallocate(dt, (size_t)nxl * nxr * cpx_sz);
+        });
+        threading->activate_normal();
     }
+    // this = lmat * Q, one LQ per bra sector (sectors in parallel)
+    // sectors with a single block are factorized in place
     void right_canonicalize(const shared_ptr<SparseMatrix> &lmat) {
-        int nl = lmat->info->n, n = info->n;
-        vector<MKL_INT> tmp(nl + 1, 0);
-        for (int i = 0; i < n; i++) {
-            int il = lmat->info->find_state(
-                info->quanta[i].get_bra(info->delta_quantum));
-            assert(il != -1);
-            tmp[il + 1] +=
-                (MKL_INT)info->n_states_bra[i] * info->n_states_ket[i];
-        }
-        for (int il = 0; il < nl; il++)
-            tmp[il + 1] += tmp[il];
-        FL *dt = (FL *)dalloc_<FP>()->allocate(tmp[nl] * cpx_sz);
-        vector<MKL_INT> it(nl, 0);
-        for (int i = 0; i < n; i++) {
-            int il = lmat->info->find_state(
-                info->quanta[i].get_bra(info->delta_quantum));
-            MKL_INT nxl = info->n_states_bra[i],
-                    nxr = (tmp[il + 1] - tmp[il]) / nxl;
-            MKL_INT inr = info->n_states_ket[i];
-            for (MKL_INT k = 0; k < nxl; k++)
-                memcpy(dt + (tmp[il] + it[il] + k * nxr),
-                       data + info->block_shifts[i] + k * inr,
-                       inr * sizeof(FL));
-            it[il] += inr * nxl;
-        }
-        for (int il = 0; il < nl; il++)
-            assert(it[il] == tmp[il + 1] - tmp[il]);
+        int nl = lmat->info->n;
+        vector<int> sec_shifts, sec_blocks;
+        canonicalize_sectors(lmat, false, sec_shifts, sec_blocks);
+        vector<pair<size_t, size_t>> dims(nl);
         for (int il = 0; il < nl; il++) {
-            MKL_INT nxl = lmat->info->n_states_bra[il],
-                    nxr = (tmp[il + 1] - tmp[il]) / nxl;
-            assert((tmp[il + 1] - tmp[il]) % nxl == 0 && nxr >= nxl);
-            GMatrixFunctions<FL>::lq(GMatrix<FL>(dt + tmp[il], nxl, nxr),
-                                     (*lmat)[il],
-                                     GMatrix<FL>(dt + tmp[il], nxl, nxr));
-        }
-        memset(it.data(), 0, sizeof(MKL_INT) * nl);
-        for (int i = 0; i < n; i++) {
-            int il = lmat->info->find_state(
-                info->quanta[i].get_bra(info->delta_quantum));
-            MKL_INT nxl = info->n_states_bra[i],
-                    nxr = (tmp[il + 1] - tmp[il]) / nxl;
-            MKL_INT inr = info->n_states_ket[i];
-            for (MKL_INT k = 0; k < nxl; k++)
-                memcpy(data + info->block_shifts[i] + k * inr,
-                       dt + (tmp[il] + it[il] + k * nxr), inr * sizeof(FL));
-            it[il] += inr * nxl;
-        }
-        dalloc_<FP>()->deallocate(dt, tmp[nl] * cpx_sz);
+            dims[il] =
+                make_pair((size_t)lmat->info->n_states_bra[il], (size_t)0);
+            for (int k = sec_shifts[il]; k < sec_shifts[il + 1]; k++)
+                dims[il].second += info->n_states_ket[sec_blocks[k]];
+        }
+        threading->parallel_decompose(dims, [&](int il, bool large) {
+            MKL_INT nxl = (MKL_INT)dims[il].first,
+                    nxr = (MKL_INT)dims[il].second;
+            if (sec_shifts[il + 1] == sec_shifts[il])
+                return;
+            assert(nxr >= nxl);
+            if (sec_shifts[il + 1] - sec_shifts[il] == 1) {
+                FL *pd = data + info->block_shifts[sec_blocks[sec_shifts[il]]];
+                GMatrixFunctions<FL>::lq(GMatrix<FL>(pd, nxl, nxr),
+                                         (*lmat)[il],
+                                         GMatrix<FL>(pd, nxl, nxr));
+                return;
+            }
+            shared_ptr<VectorAllocator<FP>> d_alloc =
+                make_shared<VectorAllocator<FP>>();
+            FL *dt = (FL *)d_alloc->allocate((size_t)nxl * nxr * cpx_sz);
+            MKL_INT p = 0;
+            for (int k = sec_shifts[il]; k < sec_shifts[il + 1]; k++) {
+                const int i = sec_blocks[k];
+                MKL_INT inr = info->n_states_ket[i];
+                for (MKL_INT j = 0; j < nxl; j++)
+                    memcpy(dt + (p + j * nxr),
+                           data + info->block_shifts[i] + j * inr,
+                           inr * sizeof(FL));
+                p += inr;
+            }
+            GMatrixFunctions<FL>::lq(GMatrix<FL>(dt, nxl, nxr), (*lmat)[il],
+                                     GMatrix<FL>(dt, nxl, nxr));
+            p = 0;
+            for (int k = sec_shifts[il]; k < sec_shifts[il + 1]; k++) {
+                const int i = sec_blocks[k];
+                MKL_INT inr = info->n_states_ket[i];
+                for (MKL_INT j = 0; j < nxl; j++)
+                    memcpy(data + info->block_shifts[i] + j * inr,
+                           dt + (p + j * nxr), inr * sizeof(FL));
+                p += inr;
+            }
+            d_alloc->deallocate(dt, (size_t)nxl * nxr * cpx_sz);
+        });
+        threading->activate_normal();
     }
     shared_ptr<SparseMatrix>
     left_multiply(const shared_ptr<SparseMatrix> &lmat, const StateInfo<S> &l,
@@ -1696,6 +1744,9 @@ template <typename S, typename FL> struct SparseMatrix {
             threading->align_type != AlignTypes::None
                 ? (uint8_t)threading->align_type / sizeof(FL)
                 : 1;
+        // blocks are independent (in parallel)
+        int ntg = threading->activate_global();
+#pragma omp parallel for schedule(dynamic) num_threads(ntg)
         for (int i = 0; i < info->n; i++) {
             S bra = info->quanta[i].get_bra(info->delta_quantum);
             S ket = info->is_wavefunction ? -info->quanta[i].get_ket()
@@ -1704,6 +1755,7 @@ template <typename S, typename FL> struct SparseMatrix {
             int ik = r.find_state(ket);
             int bbed = old_fused_cinfo->acc_n_states[ib + 1];
             MKL_INT p = info->block_shifts[i];
+            vector<FL> tmp_data;
             for (int bb = old_fused_cinfo->acc_n_states[ib]; bb < bbed; bb++) {
                 uint32_t ibba = old_fused_cinfo->ij_indices[bb].first,
                          ibbb = old_fused_cinfo->ij_indices[bb].second;
@@ -1713,14 +1765,13 @@ template <typename S, typename FL> struct SparseMatrix {
                     assert(lmat->info->n_states_bra[il] ==
                            lmat->info->n_states_ket[il]);
                     assert(lmat->info->n_states_bra[il] == l.n_states[ibba]);
-                    GMatrix<FL> tmp(nullptr, l.n_states[ibba], lp);
-                    tmp.allocate();
+                    tmp_data.resize((size_t)l.n_states[ibba] * lp);
+                    GMatrix<FL> tmp(tmp_data.data(), l.n_states[ibba], lp);
                     GMatrixFunctions<FL>::multiply(
                         (*lmat)[il], false,
                         GMatrix<FL>(data + p, l.n_states[ibba], lp), false, tmp,
                         lmat->factor, 0.0);
                     memcpy(data + p, tmp.data, sizeof(FL) * tmp.size());
-                    tmp.deallocate();
                 }
                 p += l.n_states[ibba] * lp;
             }
@@ -1728,6 +1779,7 @@ template <typename S, typename FL> struct SparseMatrix {
             assert(p == (i != info->n - 1 ? info->block_shifts[i + 1]
                                           : total_memory));
         }
+        threading->activate_normal();
     }
     // rmat must be square-block diagonal
     void right_multiply_inplace(
@@ -1736,6 +1788,9 @@ template <typename S, typename FL> struct SparseMatrix {
         const StateInfo<S> &old_fused,
         const shared_ptr<typename StateInfo<S>::ConnectionInfo>
             &old_fused_cinfo) const {
+        // blocks are independent (in parallel)
+        int ntg = threading->activate_global();
+#pragma omp parallel for schedule(dynamic) num_threads(ntg)
         for (int i = 0; i < info->n; i++) {
             S bra = info->quanta[i].get_bra(info->delta_quantum);
             S ket = info->is_wavefunction ? -info->quanta[i].get_ket()
@@ -1744,6 +1799,7 @@ template <typename S, typename FL> struct SparseMatrix {
             int ik = old_fused.find_state(ket);
             int kked = old_fused_cinfo->acc_n_states[ik + 1];
             MKL_INT p = info->block_shifts[i];
+            vector<FL> tmp_data;
             for (int kk = old_fused_cinfo->acc_n_states[ik]; kk < kked; kk++) {
                 uint32_t ikka = old_fused_cinfo->ij_indices[kk].first,
                          ikkb = old_fused_cinfo->ij_indices[kk].second;
@@ -1753,9 +1809,10 @@ template <typename S, typename FL> struct SparseMatrix {
                     assert(rmat->info->n_states_bra[ir] ==
                            rmat->info->n_states_ket[ir]);
                     assert(rmat->info->n_states_bra[ir] == r.n_states[ikkb]);
-                    GMatrix<FL> tmp(nullptr, m.n_states[ikka],
+                    tmp_data.resize((size_t)m.n_states[ikka] *
+                                    r.n_states[ikkb]);
+                    GMatrix<FL> tmp(tmp_data.data(), m.n_states[ikka],
                                     r.n_states[ikkb]);
-                    tmp.allocate();
                     for (ubond_t j = 0; j < l.n_states[ib]; j++) {
                         GMatrixFunctions<FL>::multiply(
                             GMatrix<FL>(data + p + j * old_fused.n_states[ik],
@@ -1764,11 +1821,11 @@ template <typename S, typename FL> struct SparseMatrix {
                         memcpy(data + p + j * old_fused.n_states[ik], tmp.data,
                                sizeof(FL) * tmp.size());
                     }
-                    tmp.deallocate();
                 }
                 p += lp;
             }
         }
+        threading->activate_normal();
     }
     void randomize(FP a = 0.0, FP b = 1.0) const {
         Random::fill<FP>((FP *)data, total_memory * cpx_sz, a, b);
@@ -2251,9 +2308,11 @@ template <typename S, typename FL> struct SparseMatrixGroup {
         vector<shared_ptr<GTensor<FL>>> merged_l(nr);
         r.resize(nr);
         s.resize(nr);
-        int ntg = threading->activate_global();
-#pragma omp parallel for schedule(dynamic) num_threads(ntg)
-        for (int ir = 0; ir < nr; ir++) {
+        vector<pair<size_t, size_t>> dims(nr);
+        for (int ir = 0; ir < nr; ir++)
+            dims[ir] = make_pair((size_t)sz[ir],
+                                 (size_t)((tmp[ir + 1] - tmp[ir]) / sz[ir]));
+        threading->parallel_decompose(dims, [&](int ir, bool large) {
             MKL_INT nxr = (MKL_INT)sz[ir],
                     nxl = (MKL_INT)((tmp[ir + 1] - tmp[ir]) / nxr);
             assert((tmp[ir + 1] - tmp[ir]) % nxr == 0);
@@ -2264,13 +2323,18 @@ template <typename S, typename FL> struct SparseMatrixGroup {
                 make_shared<GTensor<FP>>(vector<MKL_INT>{nxk});
             shared_ptr<GTensor<FL>> tsr =
                 make_shared<GTensor<FL>>(vector<MKL_INT>{nxk, nxr});
-            GMatrixFunctions<FL>::svd(GMatrix<FL>(dt + tmp[ir], nxl, nxr),
-                                      tsl->ref(), tss->ref().flip_dims(),
-                                      tsr->ref());
+            if (large)
+                GMatrixFunctions<FL>::svd_dc(
+                    GMatrix<FL>(dt + tmp[ir], nxl, nxr), tsl->ref(),
+                    tss->ref().flip_dims(), tsr->ref());
+            else
+                GMatrixFunctions<FL>::svd(GMatrix<FL>(dt + tmp[ir], nxl, nxr),
+                                          tsl->ref(), tss->ref().flip_dims(),
+                                          tsr->ref());
             merged_l[ir] = tsl;
             s[ir] = tss;
             r[ir] = tsr;
-        }
+        });
         threading->activate_normal();
         memset(it.data(), 0, sizeof(size_t) * nr);
         l.resize(xinfos.size());
@@ -2366,9 +2430,11 @@ template <typename S, typename FL> struct SparseMatrixGroup {
         vector<shared_ptr<GTensor<FL>>> merged_r(nl);
         l.resize(nl);
         s.resize(nl);
-        int ntg = threading->activate_global();
-#pragma omp parallel for schedule(dynamic) num_threads(ntg)
-        for (int il = 0; il < nl; il++) {
+        vector<pair<size_t, size_t>> dims(nl);
+        for (int il = 0; il < nl; il++)
+            dims[il] = make_pair((size_t)sz[il],
+                                 (size_t)((tmp[il + 1] - tmp[il]) / sz[il]));
+        threading->parallel_decompose(dims, [&](int il, bool large) {
             MKL_INT nxl = (MKL_INT)sz[il],
                     nxr = (MKL_INT)((tmp[il + 1] - tmp[il]) / nxl);
             assert((tmp[il + 1] - tmp[il]) % nxl == 0);
@@ -2379,13 +2445,18 @@ template <typename S, typename FL> struct SparseMatrixGroup {
                 make_shared<GTensor<FP>>(vector<MKL_INT>{nxk});
             shared_ptr<GTensor<FL>> tsr =
                 make_shared<GTensor<FL>>(vector<MKL_INT>{nxk, nxr});
-            GMatrixFunctions<FL>::svd(GMatrix<FL>(dt + tmp[il], nxl, nxr),
-                                      tsl->ref(), tss->ref().flip_dims(),
-                                      tsr->ref());
+            if (large)
+                GMatrixFunctions<FL>::svd_dc(
+                    GMatrix<FL>(dt + tmp[il], nxl, nxr), tsl->ref(),
+                    tss->ref().flip_dims(), tsr->ref());
+            else
+                GMatrixFunctions<FL>::svd(GMatrix<FL>(dt + tmp[il], nxl, nxr),
+                                          tsl->ref(), tss->ref().flip_dims(),
+                                          tsr->ref());
             l[il] = tsl;
             s[il] = tss;
             merged_r[il] = tsr;
-        }
+        });
         threading->activate_normal();
         memset(it.data(), 0, sizeof(size_t) * nl);
         r.resize(xinfos.size());
@@ -25,11 +25,15 @@
 #include "clebsch_gordan.hpp"
 #include "matrix_functions.hpp"
 #include "threading.hpp"
+#include "utils.hpp"
 #include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <map>
@@ -1292,18 +1296,28 @@ struct SpinPermScheme {
     static SpinPermScheme
     initialize_sz(int nn, const string &spin_str, bool is_fermion = true,
                   const vector<uint16_t> &mask = vector<uint16_t>(),
-                  int max_n_sites = 0) {
+                  int max_n_sites = 0, const string &cache_dir = "") {
         using T = SpinPermTensor;
         using R = SpinPermRecoupling;
+        if (cache_dir != "") {
+            SpinPermScheme r;
+            const string key = cache_key(
+                "SZ", nn, spin_str, is_fermion ? "F" : "B", mask, max_n_sites);
+            if (!r.load_cache(cache_dir, key)) {
+                r = initialize_sz(nn, spin_str, is_fermion, mask, max_n_sites);
+                r.save_cache(cache_dir, key);
+            }
+            return r;
+        }
         SpinPermPattern spat(nn, mask, max_n_sites);
-        vector<double> mptr;
         SpinPermScheme r;
         r.index_patterns.resize(spat.count());
         r.data.resize(spat.count());
-        size_t k = 0;
-        for (size_t i = 0; i < spat.count(); i++) {
+        int ntg = threading->activate_global();
+#pragma omp parallel for schedule(dynamic) num_threads(ntg)
+        for (int i = 0; i < (int)spat.count(); i++) {
             vector<uint16_t> irr = spat[i];
-            r.index_patterns[k] = irr;
+            r.index_patterns[i] = irr;
             vector<uint16_t> rr = SpinPermPattern::all_reordering(irr, mask);
             int nj = irr.size() == 0 ? 1 : (int)(rr.size() / irr.size());
             for (int jj = 0; jj < nj; jj++) {
@@ -1311,16 +1325,15 @@ struct SpinPermScheme {
                                          rr.begin() + (jj + 1) * irr.size());
                 vector<uint16_t> perm =
                     SpinPermTensor::find_pattern_perm(indices);
-                r.data[k][perm] = vector<pair<double, string>>();
-                vector<pair<double, string>> &rec_formula = r.data[k].at(perm);
+                r.data[i][perm] = vector<pair<double, string>>();
+                vector<pair<double, string>> &rec_formula = r.data[i].at(perm);
                 auto pis = SpinPermTensor::auto_sort_string(indices, spin_str);
                 rec_formula.push_back(make_pair(
                     is_fermion ? (double)pis.second : 1.0, pis.first));
             }
-            k += nj != 0;
         }
-        r.index_patterns.resize(k);
-        r.data.resize(k);
+        threading->activate_normal();
+        r.remove_empty_patterns();
         r.is_su2 = false;
         r.left_vacuum = 0;
         r.mask = mask;
@@ -1330,18 +1343,29 @@ struct SpinPermScheme {
     initialize_sany(int nn, const string &spin_str,
                     const string &fermionic_ops = "cdCD",
                     const vector<uint16_t> &mask = vector<uint16_t>(),
-                    int max_n_sites = 0) {
+                    int max_n_sites = 0, const string &cache_dir = "") {
         using T = SpinPermTensor;
         using R = SpinPermRecoupling;
+        if (cache_dir != "") {
+            SpinPermScheme r;
+            const string key = cache_key("SANY", nn, spin_str, fermionic_ops,
+                                         mask, max_n_sites);
+            if (!r.load_cache(cache_dir, key)) {
+                r = initialize_sany(nn, spin_str, fermionic_ops, mask,
+                                    max_n_sites);
+                r.save_cache(cache_dir, key);
+            }
+            return r;
+        }
         SpinPermPattern spat(nn, mask, max_n_sites);
-        vector<double> mptr;
         SpinPermScheme r;
         r.index_patterns.resize(spat.count());
         r.data.resize(spat.count());
-        size_t k = 0;
-        for (size_t i = 0; i < spat.count(); i++) {
+        int ntg = threading->activate_global();
+#pragma omp parallel for schedule(dynamic) num_threads(ntg)
+        for (int i = 0; i < (int)spat.count(); i++) {
             vector<uint16_t> irr = spat[i];
-            r.index_patterns[k] = irr;
+            r.index_patterns[i] = irr;
             vector<uint16_t> rr = SpinPermPattern::all_reordering(irr, mask);
             int nj = irr.size() == 0 ? 1 : (int)(rr.size() / irr.size());
             for (int jj = 0; jj < nj; jj++) {
@@ -1349,16 +1373,15 @@ struct SpinPermScheme {
                                          rr.begin() + (jj + 1) * irr.size());
                 vector<uint16_t> perm =
                     SpinPermTensor::find_pattern_perm(indices);
-                r.data[k][perm] = vector<pair<double, string>>();
-                vector<pair<double, string>> &rec_formula = r.data[k].at(perm);
+                r.data[i][perm] = vector<pair<double, string>>();
+                vector<pair<double, string>> &rec_formula = r.data[i].at(perm);
                 auto pis = SpinPermTensor::auto_sort_string(indices, spin_str,
                                                             fermionic_ops);
                 rec_formula.push_back(make_pair((double)pis.second, pis.first));
             }
-            k += nj != 0;
         }
-        r.index_patterns.resize(k);
-        r.data.resize(k);
+        threading->activate_normal();
+        r.remove_empty_patterns();
         r.is_su2 = false;
         r.left_vacuum = 0;
         r.mask = mask;
@@ -1553,9 +1576,22 @@ struct SpinPermScheme {
     initialize_su2(int nn, const string &spin_str, bool is_npdm = false,
                    bool is_drt = false,
                    const vector<uint16_t> &mask = vector<uint16_t>(),
-                   int max_n_sites = 0) {
+                   int max_n_sites = 0, const string &cache_dir = "") {
         using T = SpinPermTensor;
         using R = SpinPermRecoupling;
+        if (cache_dir != "") {
+            SpinPermScheme r;
+            const string key =
+                cache_key("SU2", nn, spin_str,
+                          string(is_npdm ? "N" : "-") + (is_drt ? "D" : "-"),
+                          mask, max_n_sites);
+            if (!r.load_cache(cache_dir, key)) {
+                r = initialize_su2(nn, spin_str, is_npdm, is_drt, mask,
+                                   max_n_sites);
+                r.save_cache(cache_dir, key);
+            }
+            return r;
+        }
         SU2CG cg;
         vector<uint8_t> cds;
         if (spin_str.find('T') != string::npos)
@@ -1565,46 +1601,76 @@ struct SpinPermScheme {
         int target_twos = R::get_target_twos(spin_pat_str);
         SpinPermPattern spat(nn, mask, max_n_sites);
         SpinPermScheme r;
-        r.index_patterns.resize(spat.count());
-        r.data.resize(spat.count());
+        const int n_pats = (int)spat.count();
+        r.index_patterns.resize(n_pats);
+        r.data.resize(n_pats);
+        vector<vector<uint16_t>> rrs(n_pats);
+        vector<vector<map<string, double>>> ps(n_pats);
+        for (int i = 0; i < n_pats; i++) {
+            r.index_patterns[i] = spat[i];
+            rrs[i] = SpinPermPattern::all_reordering(spat[i], mask);
+            const size_t nx = r.index_patterns[i].size();
+            ps[i].resize(nx == 0 ? 1 : rrs[i].size() / nx);
+        }
         int ntg = threading->activate_global();
         map<vector<uint16_t>, map<string, double>> ref_ps;
         map<string, double> p = map<string, double>{make_pair(spin_str, 1.0)};
-        for (int i = (int)spat.count() - 1; i >= 0; i--) {
-            vector<uint16_t> irr = spat[i];
-            r.index_patterns[i] = irr;
-            vector<uint16_t> rr = SpinPermPattern::all_reordering(irr, mask);
-            int nj = irr.size() == 0 ? 1 : (int)(rr.size() / irr.size());
-            int iq = is_npdm ? spat.get_split_index(i) : (is_drt ? -2 : -1);
-            vector<map<string, double>> ps(nj);
-#pragma omp parallel for schedule(static, 20) num_threads(ntg)
-            for (int jj = 0; jj < nj; jj++) {
+        // ip = 0 : the last pattern (all indices distinct) is sorted directly
+        // ip = 1 : all other patterns are recoupled from the last pattern
+        // tasks are (index pattern, reordering) pairs
+        vector<pair<int, int>> tasks;
+        for (int ip = 0; ip < 2 && n_pats != 0; ip++) {
+            tasks.clear();
+            for (int i = (ip == 0 ? n_pats - 1 : 0);
+                 i < (ip == 0 ? n_pats : n_pats - 1); i++)
+                for (int jj = 0; jj < (int)ps[i].size(); jj++)
+                    tasks.push_back(make_pair(i, jj));
+#pragma omp parallel for schedule(dynamic, 20) num_threads(ntg)
+            for (int it = 0; it < (int)tasks.size(); it++) {
+                const int ii = tasks[it].first, jj = tasks[it].second;
+                const vector<uint16_t> &irr = r.index_patterns[ii];
+                const vector<uint16_t> &rr = rrs[ii];
+                int iq =
+                    is_npdm ? spat.get_split_index(ii) : (is_drt ? -2 : -1);
                 vector<uint16_t> indices(rr.begin() + jj * irr.size(),
                                          rr.begin() + (jj + 1) * irr.size());
                 vector<uint16_t> perm =
                     SpinPermTensor::find_pattern_perm(indices);
-                ps[jj] = SpinRecoupling::recouple_split(
+                ps[ii][jj] = SpinRecoupling::recouple_split(
                     ref_ps.count(perm)
                         ? ref_ps.at(perm)
                         : SpinRecoupling::sort_indices(p, indices, cg, heis),
                     irr, iq, cg, heis);
             }
-            for (int jj = 0; jj < nj; jj++) {
-                vector<uint16_t> indices(rr.begin() + jj * irr.size(),
-                                         rr.begin() + (jj + 1) * irr.size());
+            if (ip != 0)
+                continue;
+            const int i = n_pats - 1;
+            const vector<uint16_t> &irr = r.index_patterns[i];
+            for (int jj = 0; jj < (int)ps[i].size(); jj++) {
+                vector<uint16_t> indices(rrs[i].begin() + jj * irr.size(),
+                                         rrs[i].begin() +
+                                             (jj + 1) * irr.size());
+                ref_ps[SpinPermTensor::find_pattern_perm(indices)] = ps[i][jj];
+            }
+        }
+        threading->activate_normal();
+        for (int i = 0; i < n_pats; i++) {
+            const vector<uint16_t> &irr = r.index_patterns[i];
+            for (int jj = 0; jj < (int)ps[i].size(); jj++) {
+                vector<uint16_t> indices(rrs[i].begin() + jj * irr.size(),
+                                         rrs[i].begin() +
+                                             (jj + 1) * irr.size());
                 vector<uint16_t> perm =
                     SpinPermTensor::find_pattern_perm(indices);
                 r.data[i][perm] = vector<pair<double, string>>();
                 vector<pair<double, string>> &udq = r.data[i].at(perm);
-                udq.reserve(ps[jj].size());
-                for (auto &mr : ps[jj])
+                udq.reserve(ps[i][jj].size());
+                for (auto &mr : ps[i][jj])
                     udq.push_back(make_pair(mr.second, mr.first));
                 assert(udq.size() != 0);
-                if (i == spat.count() - 1)
-                    ref_ps[perm] = ps[jj];
             }
+            ps[i].clear();
         }
-        threading->activate_normal();
         r.is_su2 = true;
         r.left_vacuum = (int8_t)target_twos;
         r.mask = mask;
@@ -1756,6 +1822,190 @@ struct SpinPermScheme {
         r.mask = mask;
         return r;
     }
+    // remove index patterns without any valid reordering under mask
+    void remove_empty_patterns() {
+        size_t k = 0;
+        for (size_t i = 0; i < data.size(); i++)
+            if (data[i].size() != 0) {
+                if (k != i)
+                    index_patterns[k] = index_patterns[i],
+                    data[k] = move(data[i]);
+                k++;
+            }
+        index_patterns.resize(k);
+        data.resize(k);
+    }
+    // on-disk format version, must be increased when the generated
+    // content of the scheme is changed
+    static const uint32_t cache_version = 1;
+    static string cache_key(const string &symm, int nn, const string &spin_str,
+                            const string &options,
+                            const vector<uint16_t> &mask, int max_n_sites) {
+        stringstream ss;
+        ss << "V" << cache_version << ":" << symm << ":" << nn << ":"
+           << spin_str << ":" << options << ":" << max_n_sites << ":";
+        for (size_t i = 0; i < mask.size(); i++)
+            ss << (i == 0 ? "" : ",") << mask[i];
+        return ss.str();
+    }
+    static string cache_filename(const string &cache_dir, const string &key) {
+        stringstream ss;
+        ss << cache_dir << "/SPS-" << hex << setw(16) << setfill('0')
+           << (uint64_t)std::hash<string>()(key) << ".bin";
+        return ss.str();
+    }
+    // the key is stored in the file to resolve hash collisions
+    bool load_cache(const string &cache_dir, const string &key) {
+        const string filename = cache_filename(cache_dir, key);
+        if (!Parsing::file_exists(filename))
+            return false;
+        ifstream ifs(filename.c_str(), ios::binary);
+        if (!ifs.good())
+            return false;
+        int lkey = 0;
+        ifs.read((char *)&lkey, sizeof(lkey));
+        if (ifs.fail() || lkey != (int)key.length())
+            return false;
+        string fkey(lkey, ' ');
+        ifs.read((char *)&fkey[0], sizeof(char) * lkey);
+        if (ifs.fail() || fkey != key)
+            return false;
+        load_data(ifs);
+        if (ifs.fail() || ifs.bad())
+            throw runtime_error("SpinPermScheme:load_cache on '" + filename +
+                                "' failed.");
+        ifs.close();
+        return true;
+    }
+    // written to a temporary file first so that concurrent jobs
+    // sharing the same cache_dir never see a partial file
+    void save_cache(const string &cache_dir, const string &key) const {
+        if (!Parsing::path_exists(cache_dir))
+            Parsing::mkdir(cache_dir);
+        const string filename = cache_filename(cache_dir, key);
+        stringstream ss;
+        ss << filename << ".tmp." << hex
+           << (uint64_t)chrono::high_resolution_clock::now()
+                  .time_since_epoch()
+                  .count()
+           << "." << (uint64_t)(size_t)this;
+        const string tmp_filename = ss.str();
+        ofstream ofs(tmp_filename.c_str(), ios::binary);
+        if (!ofs.good())
+            throw runtime_error("SpinPermScheme:save_cache on '" +
+                                tmp_filename + "' failed.");
+        int lkey = (int)key.length();
+        ofs.write((char *)&lkey, sizeof(lkey));
+        ofs.write((char *)&key[0], sizeof(char) * lkey);
+        save_data(ofs);
+        if (!ofs.good())
+            throw runtime_error("SpinPermScheme:save_cache on '" +
+                                tmp_filename + "' failed.");
+        ofs.close();
+        if (!Parsing::rename_file(tmp_filename, filename))
+            Parsing::remove_file(tmp_filename);
+    }
+    static void save_indices(ostream &ofs, const vector<uint16_t> &x) {
+        int lx = (int)x.size();
+        ofs.write((char *)&lx, sizeof(lx));
+        ofs.write((char *)x.data(), sizeof(uint16_t) * lx);
+    }
+    static void load_indices(istream &ifs, vector<uint16_t> &x) {
+        int lx = 0;
+        ifs.read((char *)&lx, sizeof(lx));
+        x.resize(lx);
+        ifs.read((char *)x.data(), sizeof(uint16_t) * lx);
+    }
+    void load_data(istream &ifs) {
+        uint32_t version = 0;
+        ifs.read((char *)&version, sizeof(version));
+        if (version != cache_version)
+            throw runtime_error("SpinPermScheme:load_data version mismatch.");
+        ifs.read((char *)&is_su2, sizeof(is_su2));
+        ifs.read((char *)&left_vacuum, sizeof(left_vacuum));
+        load_indices(ifs, mask);
+        int lidx = 0;
+        ifs.read((char *)&lidx, sizeof(lidx));
+        index_mask.resize(lidx);
+        for (int i = 0; i < lidx; i++)
+            load_indices(ifs, index_mask[i]);
+        int lpat = 0;
+        ifs.read((char *)&lpat, sizeof(lpat));
+        index_patterns.resize(lpat);
+        data.resize(lpat);
+        vector<uint16_t> perm;
+        for (int i = 0; i < lpat; i++) {
+            load_indices(ifs, index_patterns[i]);
+            int ldt = 0;
+            ifs.read((char *)&ldt, sizeof(ldt));
+            data[i].clear();
+            for (int j = 0; j < ldt; j++) {
+                load_indices(ifs, perm);
+                vector<pair<double, string>> &udq = data[i][perm];
+                int lu = 0;
+                ifs.read((char *)&lu, sizeof(lu));
+                udq.resize(lu);
+                for (int k = 0; k < lu; k++) {
+                    ifs.read((char *)&udq[k].first, sizeof(double));
+                    int ls = 0;
+                    ifs.read((char *)&ls, sizeof(ls));
+                    udq[k].second = string(ls, ' ');
+                    ifs.read((char *)&udq[k].second[0], sizeof(char) * ls);
+                }
+            }
+        }
+    }
+    void load_data(const string &filename) {
+        ifstream ifs(filename.c_str(), ios::binary);
+        if (!ifs.good())
+            throw runtime_error("SpinPermScheme:load_data on '" + filename +
+                                "' failed.");
+        load_data(ifs);
+        if (ifs.fail() || ifs.bad())
+            throw runtime_error("SpinPermScheme:load_data on '" + filename +
+                                "' failed.");
+        ifs.close();
+    }
+    void save_data(ostream &ofs) const {
+        uint32_t version = cache_version;
+        ofs.write((char *)&version, sizeof(version));
+        ofs.write((char *)&is_su2, sizeof(is_su2));
+        ofs.write((char *)&left_vacuum, sizeof(left_vacuum));
+        save_indices(ofs, mask);
+        int lidx = (int)index_mask.size();
+        ofs.write((char *)&lidx, sizeof(lidx));
+        for (int i = 0; i < lidx; i++)
+            save_indices(ofs, index_mask[i]);
+        int lpat = (int)index_patterns.size();
+        ofs.write((char *)&lpat, sizeof(lpat));
+        for (int i = 0; i < lpat; i++) {
+            save_indices(ofs, index_patterns[i]);
+            int ldt = (int)data[i].size();
+            ofs.write((char *)&ldt, sizeof(ldt));
+            for (auto &r : data[i]) {
+                save_indices(ofs, r.first);
+                int lu = (int)r.second.size();
+                ofs.write((char *)&lu, sizeof(lu));
+                for (auto &g : r.second) {
+                    ofs.write((char *)&g.first, sizeof(double));
+                    int ls = (int)g.second.length();
+                    ofs.write((char *)&ls, sizeof(ls));
+                    ofs.write((char *)&g.second[0], sizeof(char) * ls);
+                }
+            }
+        }
+    }
+    void save_data(const string &filename) const {
+        ofstream ofs(filename.c_str(), ios::binary);
+        if (!ofs.good())
+            throw runtime_error("SpinPermScheme:save_data on '" + filename +
+                                "' failed.");
+        save_data(ofs);
+        if (!ofs.good())
+            throw runtime_error("SpinPermScheme:save_data on '" + filename +
+                                "' failed.");
+        ofs.close();
+    }
     string to_str() const {
         stringstream ss;
         int cnt = (int)index_patterns.size();
@@ -59,6 +59,8 @@ template <typename S, typename FL> struct TensorFunctions {
     virtual void operator()(const GMatrix<FL> &b, const GMatrix<FL> &c,
                             FL scale = 1.0) {
         opf->seq->operator()(b, c, scale);
+        if (opf->seq->screen_thrd != 0)
+            opf->seq->screen_end();
     }
     template <typename T> void serial_for(size_t n, T op) const {
         shared_ptr<TensorFunctions> tf = make_shared<TensorFunctions>(*this);
@@ -103,6 +105,8 @@ template <typename S, typename FL> struct TensorFunctions {
                 opf->seq->batch[1]->nflop += tfs[i]->opf->seq->batch[1]->nflop;
                 opf->seq->cumulative_nflop +=
                     tfs[i]->opf->seq->cumulative_nflop;
+                if (opf->seq->screen_thrd != 0)
+                    opf->seq->screen_merge(*tfs[i]->opf->seq);
                 opf->seq->max_work =
                     max(opf->seq->max_work, tfs[i]->opf->seq->max_work);
             }
@@ -175,9 +179,12 @@ template <typename S, typename FL> struct TensorFunctions {
                     mats[tid] = nullptr;
                 }
             }
-            for (int i = 1; i < ntop; i++)
+            for (int i = 1; i < ntop; i++) {
                 opf->seq->cumulative_nflop +=
                     tfs[i]->opf->seq->cumulative_nflop;
+                if (opf->seq->screen_thrd != 0)
+                    opf->seq->screen_merge(*tfs[i]->opf->seq);
+            }
         }
         threading->activate_normal();
     }
@@ -3035,8 +3042,169 @@ template <typename S, typename FL> struct TensorFunctions {
                 opf->seq->auto_perform();
         }
     }
+    // expand expr into products (conj, lmat, rmat, factor), forming the
+    // OpSumProd intermediates not found in lop/rop (appended to tmps);
+    // returns false if expr has terms that cannot be expanded
+    bool expand_products(
+        const shared_ptr<OpExpr<S>> &expr,
+        const unordered_map<shared_ptr<OpExpr<S>>,
+                            shared_ptr<SparseMatrix<S, FL>>> &lop,
+        const unordered_map<shared_ptr<OpExpr<S>>,
+                            shared_ptr<SparseMatrix<S, FL>>> &rop,
+        vector<tuple<uint8_t, shared_ptr<SparseMatrix<S, FL>>,
+                     shared_ptr<SparseMatrix<S, FL>>, FL>> &terms,
+        vector<shared_ptr<SparseMatrix<S, FL>>> &tmps) const {
+        switch (expr->get_type()) {
+        case OpTypes::Elem: {
+            // for mpo singlet embedding
+            shared_ptr<OpElement<S, FL>> op =
+                dynamic_pointer_cast<OpElement<S, FL>>(expr);
+            assert((rop.count(op) != 0) ^ (lop.count(op) != 0));
+            shared_ptr<SparseMatrix<S, FL>> lmat =
+                lop.count(op) != 0 ? lop.at(op)
+                                   : lop.at(make_shared<OpExpr<S>>());
+            shared_ptr<SparseMatrix<S, FL>> rmat =
+                rop.count(op) != 0 ? rop.at(op)
+                                   : rop.at(make_shared<OpExpr<S>>());
+            terms.push_back(make_tuple((uint8_t)0, lmat, rmat, op->factor));
+        } break;
+        case OpTypes::Prod: {
+            shared_ptr<OpProduct<S, FL>> op =
+                dynamic_pointer_cast<OpProduct<S, FL>>(expr);
+            assert(op->b != nullptr);
+            assert(lop.count(op->a) != 0 && rop.count(op->b) != 0);
+            terms.push_back(make_tuple(op->conj, lop.at(op->a), rop.at(op->b),
+                                       op->factor));
+        } break;
+        case OpTypes::SumProd: {
+            shared_ptr<OpSumProd<S, FL>> op =
+                dynamic_pointer_cast<OpSumProd<S, FL>>(expr);
+            assert((op->a == nullptr) ^ (op->b == nullptr));
+            assert(op->ops.size() != 0);
+            shared_ptr<SparseMatrix<S, FL>> tmp;
+            if (op->c != nullptr && ((op->b == nullptr && rop.count(op->c)) ||
+                                     (op->a == nullptr && lop.count(op->c))))
+                tmp = op->b == nullptr && rop.count(op->c) ? rop.at(op->c)
+                                                           : lop.at(op->c);
+            else {
+                const auto &xop = op->b == nullptr ? rop : lop;
+                tmp = make_shared<SparseMatrix<S, FL>>(
+                    make_shared<VectorAllocator<FP>>());
+                tmp->allocate(
+                    xop.at(abs_value((shared_ptr<OpExpr<S>>)op->ops[0]))
+                        ->info);
+                for (size_t i = 0; i < op->ops.size(); i++) {
+                    opf->iadd(
+                        tmp,
+                        xop.at(abs_value((shared_ptr<OpExpr<S>>)op->ops[i])),
+                        op->ops[i]->factor, op->conjs[i]);
+                    if (opf->seq->mode & SeqTypes::Simple)
+                        opf->seq->simple_perform();
+                }
+                tmps.push_back(tmp);
+            }
+            if (op->b == nullptr)
+                terms.push_back(
+                    make_tuple(op->conj, lop.at(op->a), tmp, op->factor));
+            else
+                terms.push_back(
+                    make_tuple(op->conj, tmp, rop.at(op->b), op->factor));
+        } break;
+        case OpTypes::Sum: {
+            shared_ptr<OpSum<S, FL>> op =
+                dynamic_pointer_cast<OpSum<S, FL>>(expr);
+            for (auto &x : op->strings)
+                if (x->get_type() == OpTypes::Prod && x->b == nullptr) {
+                    if (!expand_products(x->get_op(), lop, rop, terms, tmps))
+                        return false;
+                } else if (!expand_products(x, lop, rop, terms, tmps))
+                    return false;
+        } break;
+        case OpTypes::Zero:
+            break;
+        default:
+            return false;
+        }
+        return true;
+    }
+    // c += mpst_bra x eval(expr) x mpst_ket, where eval(expr) has the info
+    // of ab; only a few blocks of eval(expr) are formed at a time
+    // (in a workspace not larger than c or the largest block of ab),
+    // and the blocks truncated by the rotation are never formed
+    void tensor_product_rotate(
+        const shared_ptr<OpExpr<S>> &expr,
+        const unordered_map<shared_ptr<OpExpr<S>>,
+                            shared_ptr<SparseMatrix<S, FL>>> &lop,
+        const unordered_map<shared_ptr<OpExpr<S>>,
+                            shared_ptr<SparseMatrix<S, FL>>> &rop,
+        const shared_ptr<SparseMatrix<S, FL>> &ab,
+        const shared_ptr<SparseMatrix<S, FL>> &c,
+        const shared_ptr<SparseMatrix<S, FL>> &mpst_bra,
+        const shared_ptr<SparseMatrix<S, FL>> &mpst_ket, bool trans) const {
+        const shared_ptr<SparseMatrixInfo<S>> &info = ab->info;
+        // archived and delayed operators are only resolved in their own
+        // tensor_product, so there eval(expr) is formed as a whole
+        vector<tuple<uint8_t, shared_ptr<SparseMatrix<S, FL>>,
+                     shared_ptr<SparseMatrix<S, FL>>, FL>>
+            terms;
+        vector<shared_ptr<SparseMatrix<S, FL>>> tmps;
+        bool expanded = opf->get_type() == SparseMatrixTypes::Normal &&
+                        get_type() != TensorFunctionsTypes::Archived &&
+                        get_type() != TensorFunctionsTypes::Delayed &&
+                        expand_products(expr, lop, rop, terms, tmps);
+        if (!expanded) {
+            for (int i = (int)tmps.size() - 1; i >= 0; i--)
+                tmps[i]->deallocate();
+            shared_ptr<SparseMatrix<S, FL>> mat =
+                make_shared<SparseMatrix<S, FL>>(
+                    make_shared<VectorAllocator<FP>>());
+            mat->allocate(info);
+            tensor_product(expr, lop, rop, mat);
+            opf->tensor_rotate(mat, c, mpst_bra, mpst_ket, trans);
+            mat->deallocate();
+            return;
+        }
+        const auto blk_size = [&info](int i) {
+            return (size_t)info->n_states_bra[i] * info->n_states_ket[i];
+        };
+        // blocks of ab surviving the rotation
+        vector<int> idx;
+        idx.reserve(c->info->n);
+        size_t max_work = c->total_memory;
+        for (int ic = 0, ia = 0; ic < c->info->n; ia++, ic++) {
+            while (info->quanta[ia] != c->info->quanta[ic])
+                ia++;
+            idx.push_back(ia);
+            max_work = max(max_work, blk_size(ia));
+        }
+        vector<FL> work(max_work);
+        shared_ptr<SparseMatrix<S, FL>> mat =
+            make_shared<SparseMatrix<S, FL>>();
+        mat->info = info, mat->data = work.data();
+        for (size_t k = 0, kk; k < idx.size(); k = kk) {
+            // consecutive blocks fitting in the workspace
+            const size_t sh = info->block_shifts[idx[k]];
+            kk = k + 1;
+            while (kk < idx.size() && idx[kk] == idx[kk - 1] + 1 &&
+                   info->block_shifts[idx[kk]] + blk_size(idx[kk]) - sh <=
+                       max_work)
+                kk++;
+            memset(work.data(), 0,
+                   sizeof(FL) * (info->block_shifts[idx[kk - 1]] - sh +
+                                 blk_size(idx[kk - 1])));
+            opf->block_window = make_pair(idx[k], idx[kk - 1] + 1);
+            for (auto &t : terms)
+                opf->tensor_product(get<0>(t), get<1>(t), get<2>(t), mat,
+                                    get<3>(t));
+            opf->tensor_rotate(mat, c, mpst_bra, mpst_ket, trans);
+        }
+        opf->block_window = make_pair(0, -1);
+        mat->data = nullptr;
+        for (int i = (int)tmps.size() - 1; i >= 0; i--)
+            tmps[i]->deallocate();
+    }
     // c = mpst_bra x [ a x b (dot) ] x mpst_ket
-    // without consuming large memory of blocking
+    // without forming the blocking operators a x b (dot)
     // need to make sure a and c are not in the same frame
     virtual void
     left_contract_rotate(const shared_ptr<OperatorTensor<S, FL>> &a,
@@ -3047,12 +3215,11 @@ template <typename S, typename FL> struct TensorFunctions {
                          shared_ptr<OperatorTensor<S, FL>> &c,
                          const shared_ptr<Symbolic<S>> &cexprs = nullptr,
                          OpNamesSet delayed = OpNamesSet()) const {
-        if (frame_<FP>()->use_main_stack)
+        // the site operators are small and the active frame is used by c
+        if (frame_<FP>()->use_main_stack && a == nullptr)
             for (auto &p : ab->ops) {
-                shared_ptr<OpElement<S, FL>> op =
-                    dynamic_pointer_cast<OpElement<S, FL>>(p.first);
-                if (a == nullptr || !delayed(op->name))
-                    ab->ops.at(op)->allocate(ab->ops.at(op)->info);
+                p.second->alloc = make_shared<VectorAllocator<FP>>();
+                p.second->allocate(p.second->info);
             }
         if (a == nullptr) {
             left_assign(b, ab);
@@ -3066,7 +3233,7 @@ template <typename S, typename FL> struct TensorFunctions {
             shared_ptr<Symbolic<S>> exprs =
                 cexprs == nullptr ? a->lmat * b->lmat : cexprs;
             assert(exprs->data.size() == ab->lmat->data.size());
-            // because of deallocation of the ab, we cannot use auto
+            // because of reuse of the workspace, we cannot use auto
             assert(opf->seq->mode != SeqTypes::Auto);
             parallel_for(
                 exprs->data.size(),
@@ -3079,26 +3246,21 @@ template <typename S, typename FL> struct TensorFunctions {
                     shared_ptr<OpExpr<S>> expr =
                         exprs->data[i] * ((FP)1.0 / cop->factor);
                     if (!delayed(cop->name)) {
-                        if (!frame_<FP>()->use_main_stack) {
-                            // skip cached part
-                            if (ab->ops.at(op)->alloc != nullptr)
-                                return;
-                            ab->ops.at(op)->alloc =
-                                make_shared<VectorAllocator<FP>>();
-                            ab->ops.at(op)->allocate(ab->ops.at(op)->info);
-                        }
-                        tf->tensor_product(expr, a->ops, b->ops,
-                                           ab->ops.at(op));
-                        tf->opf->tensor_rotate(ab->ops.at(op), c->ops.at(op),
-                                               mpst_bra, mpst_ket, false);
-                        if (!frame_<FP>()->use_main_stack)
-                            ab->ops.at(op)->deallocate();
+                        // cached part
+                        if (ab->ops.at(op)->data != nullptr)
+                            tf->opf->tensor_rotate(ab->ops.at(op),
+                                                   c->ops.at(op), mpst_bra,
+                                                   mpst_ket, false);
+                        else
+                            tf->tensor_product_rotate(
+                                expr, a->ops, b->ops, ab->ops.at(op),
+                                c->ops.at(op), mpst_bra, mpst_ket, false);
                     }
                 });
         }
     }
     // c = mpst_bra x [ b (dot) x a ] x mpst_ket
-    // without consuming large memory of blocking
+    // without forming the blocking operators b (dot) x a
     // need to make sure a and c are not in the same frame
     virtual void
     right_contract_rotate(const shared_ptr<OperatorTensor<S, FL>> &a,
@@ -3109,12 +3271,11 @@ template <typename S, typename FL> struct TensorFunctions {
                           shared_ptr<OperatorTensor<S, FL>> &c,
                           const shared_ptr<Symbolic<S>> &cexprs = nullptr,
                           OpNamesSet delayed = OpNamesSet()) const {
-        if (frame_<FP>()->use_main_stack)
+        // the site operators are small and the active frame is used by c
+        if (frame_<FP>()->use_main_stack && a == nullptr)
             for (auto &p : ab->ops) {
-                shared_ptr<OpElement<S, FL>> op =
-                    dynamic_pointer_cast<OpElement<S, FL>>(p.first);
-                if (a == nullptr || !delayed(op->name))
-                    ab->ops.at(op)->allocate(ab->ops.at(op)->info);
+                p.second->alloc = make_shared<VectorAllocator<FP>>();
+                p.second->allocate(p.second->info);
             }
         if (a == nullptr) {
             right_assign(b, ab);
@@ -3128,7 +3289,7 @@ template <typename S, typename FL> struct TensorFunctions {
             shared_ptr<Symbolic<S>> exprs =
                 cexprs == nullptr ? b->rmat * a->rmat : cexprs;
             assert(exprs->data.size() == ab->rmat->data.size());
-            // because of deallocation of the ab, we cannot use auto
+            // because of reuse of the workspace, we cannot use auto
             assert(opf->seq->mode != SeqTypes::Auto);
             parallel_for(
                 exprs->data.size(),
@@ -3141,20 +3302,15 @@ template <typename S, typename FL> struct TensorFunctions {
                     shared_ptr<OpExpr<S>> expr =
                         exprs->data[i] * ((FP)1.0 / cop->factor);
                     if (!delayed(cop->name)) {
-                        if (!frame_<FP>()->use_main_stack) {
-                            // skip cached part
-                            if (ab->ops.at(op)->alloc != nullptr)
-                                return;
-                            ab->ops.at(op)->alloc =
-                                make_shared<VectorAllocator<FP>>();
-                            ab->ops.at(op)->allocate(ab->ops.at(op)->info);
-                        }
-                        tf->tensor_product(expr, b->ops, a->ops,
-                                           ab->ops.at(op));
-                        tf->opf->tensor_rotate(ab->ops.at(op), c->ops.at(op),
-                                               mpst_bra, mpst_ket, true);
-                        if (!frame_<FP>()->use_main_stack)
-                            ab->ops.at(op)->deallocate();
+                        // cached part
+                        if (ab->ops.at(op)->data != nullptr)
+                            tf->opf->tensor_rotate(ab->ops.at(op),
+                                                   c->ops.at(op), mpst_bra,
+                                                   mpst_ket, true);
+                        else
+                            tf->tensor_product_rotate(
+                                expr, b->ops, a->ops, ab->ops.at(op),
+                                c->ops.at(op), mpst_bra, mpst_ket, true);
                     }
                 });
         }
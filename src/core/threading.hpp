@@ -40,7 +40,9 @@
 #define BLIS_DISABLE_BLAS_DEFS
 #include "blis/blis.h"
 #endif
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <cstdint>
 #include <cstring>
 #include <fstream>
@@ -171,6 +173,14 @@ struct Threading {
                               //!< dense matrix multiplications.
         n_threads_global = 0, //!< Number of threads for general tasks
         n_levels = 0;         //!< Number of nested threading layers
+    size_t decomp_large_dim = 512; //!< Minimal dimension of a dense block
+                                   //!< (in SVD or density matrix
+                                   //!< diagonalization) to be treated as a
+                                   //!< large block. Zero disables large blocks.
+    size_t n_decomp_large = 0, //!< Accumulated number of large blocks.
+        n_decomp_small = 0;    //!< Accumulated number of small blocks.
+    double tdecomp_large = 0, //!< Accumulated wall time for large blocks.
+        tdecomp_small = 0;    //!< Accumulated wall time for small blocks.
     /** Whether openmp compiler option is set. */
     bool openmp_available() const {
 #ifdef _OPENMP
@@ -387,6 +397,57 @@ struct Threading {
         return 1;
 #endif
     }
+    /** Size-aware scheduling of independent dense decompositions (one for
+     * each symmetry block). Blocks are sorted by cost ``m * n * min(m, n)``.
+     * A block is large if ``min(m, n) >= decomp_large_dim`` and its cost is
+     * at least the average share of one global thread. Large blocks are
+     * processed first, one at a time, with all global threads given to the
+     * math library. The remaining small blocks are then distributed over
+     * global openMP threads (largest first), with one math library thread
+     * each. Caller should invoke ``activate_normal`` afterwards.
+     * @param dims Matrix shape ``(m, n)`` of each block.
+     * @param f Function ``f(i, large)`` decomposing block ``i``. For large
+     *   blocks, a divide-and-conquer LAPACK driver should be used.
+     */
+    template <typename F>
+    void parallel_decompose(const vector<pair<size_t, size_t>> &dims, F &&f) {
+        const int n = (int)dims.size();
+        vector<double> costs(n);
+        double total = 0;
+        for (int i = 0; i < n; i++)
+            total += (costs[i] = (double)dims[i].first * dims[i].second *
+                                 min(dims[i].first, dims[i].second));
+        vector<int> idx(n);
+        for (int i = 0; i < n; i++)
+            idx[i] = i;
+        stable_sort(idx.begin(), idx.end(), [&costs](int i, int j) {
+            return costs[i] > costs[j];
+        });
+        const int ntg = n_threads_global != 0 ? n_threads_global : 1;
+        auto is_large = [&dims, &costs, total, ntg, this](int i) {
+            return decomp_large_dim != 0 &&
+                   min(dims[i].first, dims[i].second) >= decomp_large_dim &&
+                   costs[i] * ntg >= total;
+        };
+        const int nl =
+            (int)(stable_partition(idx.begin(), idx.end(), is_large) -
+                  idx.begin());
+        auto tx = chrono::steady_clock::now();
+        if (nl != 0) {
+            activate_global_mkl();
+            for (int k = 0; k < nl; k++)
+                f(idx[k], true);
+        }
+        auto ty = chrono::steady_clock::now();
+        int ntx = activate_global();
+#pragma omp parallel for schedule(dynamic) num_threads(ntx)
+        for (int k = nl; k < n; k++)
+            f(idx[k], false);
+        auto tz = chrono::steady_clock::now();
+        n_decomp_large += nl, n_decomp_small += n - nl;
+        tdecomp_large += chrono::duration<double>(ty - tx).count();
+        tdecomp_small += chrono::duration<double>(tz - ty).count();
+    }
     /** Default constructor.
      * Uses ``ThreadingTypes::Global | ThreadingTypes::BatchedGEMM``
      * with maximal available number of threads, and ``SeqTypes::None``
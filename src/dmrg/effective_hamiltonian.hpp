@@ -123,6 +123,15 @@ struct EffectiveHamiltonian<S, FL, MPS<S, FL>> {
     int npdm_n_sites = 0, npdm_center = -1, npdm_parallel_center = -1;
     shared_ptr<EffectiveKernel<FL>> eff_kernel = nullptr;
     string seq_filename = "";
+    // Sparsity screening in [H_eff] x [c] during Davidson (0 = off):
+    // rotations with norm bound below screen_thrd * |c| are skipped
+    FP screen_thrd = 0;
+    // worst relative bound of |H c - H_screened c| / |c| in last eigs
+    FP screen_error = 0;
+    size_t screen_nskip = 0, screen_ntotal = 0;
+    // whether the screened solution passed the exact residual check
+    // in last eigs (otherwise unscreened Davidson iterations followed)
+    bool screen_verified = false;
     EffectiveHamiltonian(
         const vector<pair<S, shared_ptr<SparseMatrixInfo<S>>>> &left_op_infos,
         const vector<pair<S, shared_ptr<SparseMatrixInfo<S>>>> &right_op_infos,
@@ -470,10 +479,29 @@ struct EffectiveHamiltonian<S, FL, MPS<S, FL>> {
                     operator_quanta.begin();
         assert(ic < operator_quanta.size() && wfn_infos[ic] != nullptr);
         cmat->info->cinfo = wfn_infos[ic];
+        const shared_ptr<BatchGEMMSeq<FL>> &seq = tf->opf->seq;
+        if (seq->screen_thrd != 0)
+            seq->screen_begin(abs(factor) * GMatrixFunctions<FL>::norm(b));
         tf->tensor_product_multiply(
             op->mat->data[idx],
             op->stacked_mat == nullptr ? nullptr : op->stacked_mat->data[0],
             op->lopt, op->ropt, cmat, vmat, idx_opdq, all_reduce);
+        if (seq->screen_thrd != 0)
+            seq->screen_end();
+    }
+    // Set up sparsity screening of [H_eff] x [c] for the blocks of ket
+    void screen_setup(FP thrd) const {
+        const shared_ptr<BatchGEMMSeq<FL>> &seq = tf->opf->seq;
+        seq->screen_thrd = thrd;
+        seq->screen_blocks.resize(ket->info->n);
+        for (int i = 0; i < ket->info->n; i++)
+            seq->screen_blocks[i] =
+                make_pair((size_t)ket->info->block_shifts[i],
+                          (size_t)ket->info->n_states_bra[i] *
+                              ket->info->n_states_ket[i]);
+        seq->screen_norms.clear(), seq->screen_idx.clear();
+        seq->screen_error = seq->screen_max_error = 0;
+        seq->screen_nskip = seq->screen_ntotal = 0;
     }
     // Find eigenvalues and eigenvectors of [H_eff]
     // energy, ndav, nflop, tdav
@@ -531,32 +559,91 @@ struct EffectiveHamiltonian<S, FL, MPS<S, FL>> {
                                                       (FL)1.0, b, b, (FL)0.0);
             };
         vector<FP> eners;
-        if (metric == nullptr)
-            eners = IterativeMatrixFunctions<FL>::harmonic_davidson(
-                g, aa, bs, shift, davidson_type, ndav, iprint,
-                para_rule == nullptr ? nullptr : para_rule->comm, conv_thrd,
-                rel_conv_thrd, max_iter, soft_max_iter, deflation_min_size,
-                deflation_max_size, ors, projection_weights);
-        else {
+        const function<void(const GMatrix<FL> &, const GMatrix<FL> &)> &mg =
+            [metric, &cmask](const GMatrix<FL> &a, const GMatrix<FL> &b) {
+                if (metric->tf->opf->seq->mode == SeqTypes::Auto ||
+                    (metric->tf->opf->seq->mode & SeqTypes::Tasked))
+                    metric->tf->operator()(a, b, (FL)1.0);
+                else
+                    (*metric)(a, b, 0, (FL)1.0);
+                if (cmask.data != nullptr)
+                    GMatrixFunctions<FL>::elementwise("*", (FL)1.0, cmask,
+                                                      (FL)1.0, b, b, (FL)0.0);
+            };
+        const auto &solve = [&](int &xndav) {
+            if (metric == nullptr)
+                eners = IterativeMatrixFunctions<FL>::harmonic_davidson(
+                    g, aa, bs, shift, davidson_type, xndav, iprint,
+                    para_rule == nullptr ? nullptr : para_rule->comm, conv_thrd,
+                    rel_conv_thrd, max_iter, soft_max_iter, deflation_min_size,
+                    deflation_max_size, ors, projection_weights);
+            else
+                eners = IterativeMatrixFunctions<FL>::davidson_generalized(
+                    g, mg, aa, bs, shift, davidson_type, xndav, iprint,
+                    para_rule == nullptr ? nullptr : para_rule->comm, conv_thrd,
+                    rel_conv_thrd, max_iter, soft_max_iter, deflation_min_size,
+                    deflation_max_size, ors, projection_weights);
+        };
+        if (metric != nullptr)
             metric->precompute();
-            const function<void(const GMatrix<FL> &, const GMatrix<FL> &)> &mg =
-                [metric, &cmask](const GMatrix<FL> &a, const GMatrix<FL> &b) {
-                    if (metric->tf->opf->seq->mode == SeqTypes::Auto ||
-                        (metric->tf->opf->seq->mode & SeqTypes::Tasked))
-                        metric->tf->operator()(a, b, (FL)1.0);
-                    else
-                        (*metric)(a, b, 0, (FL)1.0);
-                    if (cmask.data != nullptr)
-                        GMatrixFunctions<FL>::elementwise(
-                            "*", (FL)1.0, cmask, (FL)1.0, b, b, (FL)0.0);
-                };
-            eners = IterativeMatrixFunctions<FL>::davidson_generalized(
-                g, mg, aa, bs, shift, davidson_type, ndav, iprint,
-                para_rule == nullptr ? nullptr : para_rule->comm, conv_thrd,
-                rel_conv_thrd, max_iter, soft_max_iter, deflation_min_size,
-                deflation_max_size, ors, projection_weights);
+        // screening is not used for the conflict-resolving Auto mode
+        const bool screen =
+            screen_thrd != 0 && tf->opf->seq->mode != SeqTypes::Auto;
+        if (screen) {
+            screen_setup(screen_thrd);
+            solve(ndav);
+            screen_error = tf->opf->seq->screen_max_error;
+            screen_nskip = tf->opf->seq->screen_nskip;
+            screen_ntotal = tf->opf->seq->screen_ntotal;
+            screen_setup(0);
+            if (iprint) {
+                stringstream ss;
+                ss << scientific << setprecision(3) << screen_error;
+                cout << "screened davidson: skipped " << screen_nskip << " / "
+                     << screen_ntotal
+                     << " rotations, max rel error bound = " << ss.str()
+                     << endl;
+            }
+            // one exact [H_eff] x [c] to check the residual of the screened
+            // solution; unscreened iterations only when it is not converged
+            screen_verified = false;
+            if (metric == nullptr && ors.size() == 0 && bs.size() == 1 &&
+                !(davidson_type & DavidsonTypes::NonHermitian)) {
+                GMatrix<FL> hc(nullptr, bs[0].m, bs[0].n);
+                hc.allocate();
+                hc.clear();
+                g(bs[0], hc);
+                ndav++;
+                const FP cc =
+                    xreal<FL>(GMatrixFunctions<FL>::complex_dot(bs[0], bs[0]));
+                const FP ener = xreal<FL>(
+                    GMatrixFunctions<FL>::complex_dot(bs[0], hc) / (FL)cc);
+                GMatrixFunctions<FL>::iadd(hc, bs[0], (FL)(-ener));
+                const FP qq =
+                    xreal<FL>(GMatrixFunctions<FL>::complex_dot(hc, hc)) / cc;
+                hc.deallocate();
+                screen_verified = qq < conv_thrd + ener * ener *
+                                                       rel_conv_thrd *
+                                                       rel_conv_thrd;
+                if (screen_verified)
+                    eners[0] = ener;
+                if (iprint) {
+                    stringstream ss;
+                    ss << scientific << setprecision(3) << qq;
+                    cout << "screened davidson: exact residual = " << ss.str()
+                         << (screen_verified ? " (accepted)" : " (restart)")
+                         << endl;
+                }
+            }
+            if (!screen_verified) {
+                int xndav = 0;
+                solve(xndav);
+                ndav += xndav;
+            }
+        } else
+            solve(ndav);
+        if (metric != nullptr)
             metric->post_precompute();
-        }
         post_precompute();
         uint64_t nflop = tf->opf->seq->cumulative_nflop;
         if (para_rule != nullptr)
@@ -1245,6 +1332,66 @@ template <typename S, typename FL> struct LinearEffectiveHamiltonian {
         return make_tuple((typename const_fl_type<FP>::FL)eners[0], ndav,
                           (size_t)nflop, t.get_time());
     }
+    // Find the lowest eigenpair of [H_eff] + shift [D_eff] for a sequence of
+    // shifts, where shift_update(ener, ndav, shift) gives the next shift and
+    // returns true when finished (see IterativeMatrixFunctions::shift_davidson)
+    // energy, ndav, nflop, tdav
+    template <typename ShiftUpdate>
+    tuple<typename const_fl_type<FP>::FL, int, size_t, double>
+    shift_eigs(const shared_ptr<LinearEffectiveHamiltonian<S, FL>> &d_eff,
+               FP &shift, ShiftUpdate &shift_update, bool iprint = false,
+               FP conv_thrd = 5E-6, FP rel_conv_thrd = 0.0,
+               int max_iter = 5000, int soft_max_iter = -1,
+               int deflation_min_size = 2, int deflation_max_size = 50,
+               const shared_ptr<ParallelRule<S>> &para_rule = nullptr) {
+        int ndav = 0;
+        assert(h_effs.size() != 0 && d_eff->h_effs.size() != 0);
+        const shared_ptr<TensorFunctions<S, FL>> &tf = h_effs[0]->tf;
+        const MKL_INT n = (MKL_INT)h_effs[0]->diag->total_memory;
+        GDiagonalMatrix<FL> aa(nullptr, n), ab(nullptr, n);
+        aa.allocate();
+        ab.allocate();
+        aa.clear();
+        ab.clear();
+        for (size_t ih = 0; ih < h_effs.size(); ih++) {
+            assert(h_effs[ih]->compute_diag);
+            GMatrixFunctions<FL>::iadd(
+                GMatrix<FL>(aa.data, n, 1),
+                GMatrix<FL>(h_effs[ih]->diag->data, n, 1), coeffs[ih]);
+            h_effs[ih]->precompute();
+        }
+        for (size_t ih = 0; ih < d_eff->h_effs.size(); ih++) {
+            assert(d_eff->h_effs[ih]->compute_diag);
+            GMatrixFunctions<FL>::iadd(
+                GMatrix<FL>(ab.data, n, 1),
+                GMatrix<FL>(d_eff->h_effs[ih]->diag->data, n, 1),
+                d_eff->coeffs[ih]);
+            d_eff->h_effs[ih]->precompute();
+        }
+        GMatrix<FL> b(h_effs[0]->ket->data, n, 1);
+        frame_<FP>()->activate(0);
+        Timer t;
+        t.get_time();
+        tf->opf->seq->cumulative_nflop = 0;
+        FP ener = IterativeMatrixFunctions<FL>::shift_davidson(
+            *this, *d_eff, aa, ab, b, shift, shift_update, ndav, iprint,
+            para_rule == nullptr ? nullptr : para_rule->comm, conv_thrd,
+            rel_conv_thrd, max_iter, soft_max_iter, deflation_min_size,
+            deflation_max_size);
+        for (size_t ih = 0; ih < h_effs.size(); ih++)
+            h_effs[ih]->post_precompute();
+        for (size_t ih = 0; ih < d_eff->h_effs.size(); ih++)
+            d_eff->h_effs[ih]->post_precompute();
+        uint64_t nflop = tf->opf->seq->cumulative_nflop;
+        if (para_rule != nullptr)
+            para_rule->comm->reduce_sum_optional(&nflop, 1,
+                                                 para_rule->comm->root);
+        tf->opf->seq->cumulative_nflop = 0;
+        ab.deallocate();
+        aa.deallocate();
+        return make_tuple((typename const_fl_type<FP>::FL)ener, ndav,
+                          (size_t)nflop, t.get_time());
+    }
     void deallocate() {}
 };
 
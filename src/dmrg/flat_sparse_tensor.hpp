@@ -0,0 +1,245 @@
+
+/*
+ * block2: Efficient MPO implementation of quantum chemistry DMRG
+ * Copyright (C) 2020-2021 Huanchen Zhai <hczhai@caltech.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "../core/expr.hpp"
+#include "../core/matrix.hpp"
+#include "../core/matrix_functions.hpp"
+#include "../core/operator_tensor.hpp"
+#include "../core/sparse_matrix.hpp"
+#include "../core/symbolic.hpp"
+#include "mpo.hpp"
+#include "mps.hpp"
+#include "mps_unfused.hpp"
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+namespace block2 {
+
+// All blocks of one MPS or MPO site tensor in a single contiguous array,
+// for bulk transfer to other tensor formats (such as pyblock2.algebra).
+// Block k has quantum labels qs[k * rank + j], dims shapes[k * rank + j],
+// and its elements (C order) are data[offsets[k] : offsets[k + 1]].
+// MPS labels are (left, site, right), MPO labels are (left, bra, ket, right),
+// both in the left-to-right (unfused MPS) convention; the left index of
+// the first MPO site and the right index of the last MPO site are absent.
+template <typename S, typename FL> struct FlatSparseTensor {
+    int rank;
+    vector<S> qs;
+    vector<MKL_INT> shapes;
+    vector<size_t> offsets;
+    shared_ptr<vector<FL>> data;
+    FlatSparseTensor(int rank = 3)
+        : rank(rank), offsets(1, 0), data(make_shared<vector<FL>>()) {}
+    int n_blocks() const { return (int)offsets.size() - 1; }
+    size_t size() const { return offsets.back(); }
+    // Register a block; data is allocated for all blocks at once
+    int add_block(const S *q, const MKL_INT *shape) {
+        size_t sz = 1;
+        for (int j = 0; j < rank; j++)
+            qs.push_back(q[j]), shapes.push_back(shape[j]),
+                sz *= (size_t)shape[j];
+        offsets.push_back(offsets.back() + sz);
+        return n_blocks() - 1;
+    }
+    void allocate() { data->assign(size(), (FL)0.0); }
+    FL *block_data(int k) const { return data->data() + offsets[k]; }
+    static shared_ptr<FlatSparseTensor>
+    from_sparse_tensor(const shared_ptr<SparseTensor<S, FL>> &spt,
+                       const shared_ptr<StateInfo<S>> &basis) {
+        shared_ptr<FlatSparseTensor> r = make_shared<FlatSparseTensor>(3);
+        for (int im = 0; im < (int)spt->data.size(); im++)
+            for (auto &blk : spt->data[im]) {
+                assert(blk.second->shape.size() == 3);
+                S q[3] = {blk.first.first, basis->quanta[im],
+                          blk.first.second};
+                r->add_block(q, blk.second->shape.data());
+            }
+        r->allocate();
+        int k = 0;
+        for (int im = 0; im < (int)spt->data.size(); im++)
+            for (auto &blk : spt->data[im])
+                memcpy(r->block_data(k++), blk.second->data->data(),
+                       blk.second->size() * sizeof(FL));
+        return r;
+    }
+    shared_ptr<SparseTensor<S, FL>>
+    to_sparse_tensor(const shared_ptr<StateInfo<S>> &basis) const {
+        assert(rank == 3);
+        shared_ptr<SparseTensor<S, FL>> spt =
+            make_shared<SparseTensor<S, FL>>();
+        spt->data.resize(basis->n);
+        for (int k = 0; k < n_blocks(); k++) {
+            const int im = basis->find_state(qs[k * 3 + 1]);
+            if (im == -1)
+                throw runtime_error("FlatSparseTensor::to_sparse_tensor: "
+                                    "site quantum number not in basis!");
+            shared_ptr<GTensor<FL>> t = make_shared<GTensor<FL>>(
+                vector<MKL_INT>(shapes.begin() + k * 3,
+                                shapes.begin() + k * 3 + 3));
+            memcpy(t->data->data(), block_data(k), t->size() * sizeof(FL));
+            spt->data[im].push_back(
+                make_pair(make_pair(qs[k * 3], qs[k * 3 + 2]), t));
+        }
+        return spt;
+    }
+    // Site i of a (non-multi) MPS, read from disk and released again,
+    // so that a whole MPS can be streamed site by site
+    static shared_ptr<FlatSparseTensor>
+    from_mps_tensor(int i, const shared_ptr<MPS<S, FL>> &mps) {
+        return from_sparse_tensor(
+            UnfusedMPS<S, FL>::forward_mps_tensor(i, mps),
+            mps->info->basis[i]);
+    }
+    // Site i of an (unsimplified) MPO; MPO bond indices with the same
+    // quantum number are merged into one block index, in the order of
+    // the left operator names
+    static shared_ptr<FlatSparseTensor>
+    from_mpo_tensor(int i, const shared_ptr<MPO<S, FL>> &mpo) {
+        const int n = mpo->n_sites;
+        assert(mpo->schemer == nullptr && n >= 2);
+        const bool has_l = i != 0, has_r = i != n - 1;
+        // position of each bond index within its quantum number group
+        vector<S> bq[2];
+        vector<int> bidx[2];
+        map<S, int> bsize[2];
+        for (int ib = 0; ib < 2; ib++) {
+            if (!(ib == 0 ? has_l : has_r))
+                continue;
+            const int k = ib == 0 ? i - 1 : i;
+            mpo->load_left_operators(k);
+            for (auto &x : mpo->left_operator_names[k]->data) {
+                S q = dynamic_pointer_cast<OpElement<S, FL>>(x)->q_label;
+                bq[ib].push_back(q);
+                bidx[ib].push_back(bsize[ib][q]++);
+            }
+            mpo->unload_left_operators(k);
+        }
+        mpo->load_tensor(i);
+        shared_ptr<OperatorTensor<S, FL>> opt = mpo->tensors[i];
+        assert(opt->lmat == opt->rmat);
+        shared_ptr<Symbolic<S>> mat = opt->lmat;
+        auto get_index = [&mat](int k) -> pair<int, int> {
+            if (mat->get_type() == SymTypes::RVec)
+                return make_pair(0, k);
+            else if (mat->get_type() == SymTypes::CVec)
+                return make_pair(k, 0);
+            else
+                return dynamic_pointer_cast<SymbolicMatrix<S>>(mat)
+                    ->indices[k];
+        };
+        // (left, right, sparse matrix, factor) for all non-zero terms
+        vector<tuple<int, int, shared_ptr<SparseMatrix<S, FL>>, FL>> terms;
+        for (int k = 0; k < (int)mat->data.size(); k++) {
+            const shared_ptr<OpExpr<S>> &expr = mat->data[k];
+            pair<int, int> jk = get_index(k);
+            vector<pair<shared_ptr<OpExpr<S>>, FL>> elems;
+            if (expr->get_type() == OpTypes::Zero)
+                continue;
+            else if (expr->get_type() == OpTypes::Elem)
+                elems.push_back(make_pair(
+                    abs_value(expr),
+                    dynamic_pointer_cast<OpElement<S, FL>>(expr)->factor));
+            else if (expr->get_type() == OpTypes::Sum && has_l && has_r)
+                for (auto &x :
+                     dynamic_pointer_cast<OpSum<S, FL>>(expr)->strings) {
+                    assert(x->b == nullptr);
+                    elems.push_back(make_pair(
+                        (shared_ptr<OpExpr<S>>)x->a, x->factor));
+                }
+            else
+                throw runtime_error("FlatSparseTensor::from_mpo_tensor: "
+                                    "unsupported MPO expression!");
+            for (auto &e : elems) {
+                shared_ptr<SparseMatrix<S, FL>> spmat = opt->ops.at(e.first);
+                if (spmat->factor == (FL)0.0 || spmat->info->n == 0)
+                    continue;
+                terms.push_back(make_tuple(jk.first, jk.second, spmat,
+                                           e.second * spmat->factor));
+            }
+        }
+        // labels and dims of all blocks, sorted by labels
+        const int rank = 2 + has_l + has_r;
+        map<vector<S>, vector<MKL_INT>> blk_shapes;
+        for (auto &t : terms) {
+            shared_ptr<SparseMatrixInfo<S>> info = get<2>(t)->info;
+            for (int p = 0; p < info->n; p++) {
+                if (has_l && has_r &&
+                    GMatrixFunctions<FL>::norm((*get<2>(t))[p]) == (FL)0.0)
+                    continue;
+                vector<S> q;
+                vector<MKL_INT> sh;
+                if (has_l)
+                    q.push_back(bq[0][get<0>(t)]),
+                        sh.push_back(bsize[0][bq[0][get<0>(t)]]);
+                q.push_back(info->quanta[p].get_bra(info->delta_quantum));
+                sh.push_back(info->n_states_bra[p]);
+                q.push_back(info->quanta[p].get_ket());
+                sh.push_back(info->n_states_ket[p]);
+                if (has_r)
+                    q.push_back(bq[1][get<1>(t)]),
+                        sh.push_back(bsize[1][bq[1][get<1>(t)]]);
+                blk_shapes[q] = sh;
+            }
+        }
+        shared_ptr<FlatSparseTensor> r = make_shared<FlatSparseTensor>(rank);
+        map<vector<S>, int> blk_idx;
+        for (auto &b : blk_shapes)
+            blk_idx[b.first] = r->add_block(b.first.data(), b.second.data());
+        r->allocate();
+        // accumulate all terms into the dense blocks
+        for (auto &t : terms) {
+            shared_ptr<SparseMatrixInfo<S>> info = get<2>(t)->info;
+            const int il = has_l ? bidx[0][get<0>(t)] : 0;
+            const int ir = has_r ? bidx[1][get<1>(t)] : 0;
+            for (int p = 0; p < info->n; p++) {
+                GMatrix<FL> spm = (*get<2>(t))[p];
+                if (has_l && has_r &&
+                    GMatrixFunctions<FL>::norm(spm) == (FL)0.0)
+                    continue;
+                vector<S> q;
+                if (has_l)
+                    q.push_back(bq[0][get<0>(t)]);
+                q.push_back(info->quanta[p].get_bra(info->delta_quantum));
+                q.push_back(info->quanta[p].get_ket());
+                if (has_r)
+                    q.push_back(bq[1][get<1>(t)]);
+                const int k = blk_idx.at(q);
+                const MKL_INT *sh = r->shapes.data() + k * rank;
+                const size_t nr = has_r ? sh[rank - 1] : 1;
+                FL *pd = r->block_data(k) +
+                         (size_t)il * spm.m * spm.n * nr + ir;
+                for (MKL_INT a = 0; a < spm.m; a++)
+                    for (MKL_INT b = 0; b < spm.n; b++)
+                        pd[(a * spm.n + b) * nr] += get<3>(t) * spm(a, b);
+            }
+        }
+        mpo->unload_tensor(i);
+        return r;
+    }
+};
+
+} // namespace block2
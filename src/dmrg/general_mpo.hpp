@@ -679,6 +679,20 @@ template <typename S, typename FL> struct GeneralMPO : MPO<S, FL> {
             int s_kept_total = 0, nr_total = 0;
             FP res_s_sum = 0, res_factor = 1;
             size_t res_s_count = 0;
+            // independent bipartite graphs for all quantum numbers
+            if (algo_type & MPOAlgorithmTypes::Bipartite) {
+                _t2.get_time();
+                int ntg = threading->activate_global();
+#pragma omp parallel for schedule(dynamic) num_threads(ntg)
+                for (int iq = 0; iq < (int)mvcs.size(); iq++) {
+                    BipartiteMatching bm((int)nms[iq].first,
+                                         (int)nms[iq].second);
+                    bm.init_edges(mats[iq]);
+                    bm.mvc(mvcs[iq][0], mvcs[iq][1]);
+                }
+                threading->activate_normal();
+                tsvd += _t2.get_time();
+            }
             for (auto &mq : q_map) {
                 int iq = mq.second;
                 auto &matvs = mats[iq];
@@ -704,22 +718,12 @@ template <typename S, typename FL> struct GeneralMPO : MPO<S, FL> {
                 }
                 int s_kept = 0;
                 if (algo_type & MPOAlgorithmTypes::Bipartite) { // bipartite
-                    _t2.get_time();
-                    Flow flow(szl + szr);
-                    for (auto &lrv : matvs)
-                        flow.resi[lrv.first.first][lrv.first.second + szl] = 1;
-                    for (int i = 0; i < szl; i++)
-                        flow.resi[szl + szr][i] = 1;
-                    for (int i = 0; i < szr; i++)
-                        flow.resi[szl + i][szl + szr + 1] = 1;
-                    flow.mvc(0, szl, szl, szr, mvcs[iq][0], mvcs[iq][1]);
                     if (ii == n_sites - 1) {
                         assert(szr == 1);
                         mvcs[iq][0].resize(0);
                         mvcs[iq][1].resize(1);
                         mvcs[iq][1][0] = 0;
                     }
-                    tsvd += _t2.get_time();
                     // delayed I * O(K^4) term must be of NC type
                     if (delayed_term != -1 && iq == 0) {
                         if ((mvcs[iq][0].size() == 0 || mvcs[iq][0][0] != 0))
@@ -0,0 +1,265 @@
+/*
+ * block2: Efficient MPO implementation of quantum chemistry DMRG
+ * Copyright (C) 2020-2021 Huanchen Zhai <hczhai@caltech.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/** Per-site selection of memory-saving modes under a memory ceiling. */
+
+#pragma once
+
+#include "../core/allocator.hpp"
+#include "../core/utils.hpp"
+#include "moving_environment.hpp"
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace block2 {
+
+/** Memory modes, ordered from the fastest to the most memory-saving one.
+ * Each mode includes all savings of the preceding modes. */
+enum struct MemoryModeTypes : uint8_t {
+    Cached = 0,              //!< cached contraction + load/save buffering
+    Buffered = 1,            //!< load/save buffering, no cached contraction
+    Unbuffered = 2,          //!< no buffering of scratch files
+    FusedRotation = 3,       //!< + fused rotation and low-mem transform
+    FusedMultiplication = 4, //!< + fused contraction multiplication
+};
+
+inline ostream &operator<<(ostream &os, MemoryModeTypes c) {
+    const static string repr[] = {"CACHED", "BUFFERED", "UNBUFFERED",
+                                  "FUSED-ROT", "FUSED-MULT"};
+    os << repr[(uint8_t)c];
+    return os;
+}
+
+/** Memory usage (in Bytes) measured at one site in one memory mode. */
+struct MemoryBudgetRecord {
+    size_t stack = 0;   //!< peak used stack memory
+    size_t eff_ham = 0; //!< effective hamiltonian (contracted operators)
+    size_t block = 0;   //!< cached environment block (0 if not formed)
+    size_t buffer = 0;  //!< load/save buffers (0 if not buffered)
+    size_t frame = 0;   //!< used stack memory after the site
+    bool valid = false;
+    // memory allocated outside the stacks
+    size_t heap(bool main_stack) const {
+        return (main_stack ? 0 : eff_ham) + block + buffer;
+    }
+};
+
+/** One logged decision of the memory budget manager. */
+struct MemoryBudgetDecision {
+    int site;
+    bool forward;
+    MemoryModeTypes mode;
+    size_t estimated; //!< estimated memory for the chosen mode
+    size_t observed;  //!< memory measured at the site (stack + heap)
+    size_t heap;      //!< heap part of the observed memory
+};
+
+/** Memory budget manager. Before each site, the fastest memory mode whose
+ * estimated memory (stack peak + heap) fits into ``max_memory`` is applied
+ * to the MovingEnvironment and DataFrame. The estimate is built from the
+ * memory measured at the same site and sweep direction in previous sweeps
+ * (or at the most recent site, when there is no such record). The stack peak
+ * of a mode that was not measured at the site is scaled from a measured mode
+ * by ``stack_ratio``, which is refined whenever one site is measured in two
+ * modes. */
+template <typename S, typename FL, typename FLS> struct MemoryBudget {
+    typedef typename GMatrix<FLS>::FP FPS;
+    size_t max_memory;
+    MemoryModeTypes min_mode = MemoryModeTypes::Cached;
+    MemoryModeTypes max_mode = MemoryModeTypes::FusedMultiplication;
+    // peak stack memory of each mode relative to the cached mode;
+    // initial values are the mean ratios of the peaks measured for N2
+    // (cc-pVDZ CAS(10, 26), M = 250, SU2, no main stack)
+    vector<double> stack_ratio =
+        vector<double>{1.0, 1.0, 1.06, 1.04, 1.04};
+    // number of measurements averaged into each stack ratio
+    vector<int> n_stack_ratio = vector<int>(5, 1);
+    // records at (site, forward), one per memory mode
+    map<pair<int, bool>, vector<MemoryBudgetRecord>> history;
+    pair<int, bool> last_site = make_pair(-1, false);
+    // most recent measured cached block and buffer sizes
+    size_t last_block = 0, last_buffer = 0;
+    vector<MemoryBudgetDecision> decisions;
+    uint8_t iprint = 1;
+    // peak used memory before the current site (restored after the site)
+    vector<size_t> outer_peak;
+    MemoryBudget(size_t max_memory) : max_memory(max_memory) {}
+    virtual ~MemoryBudget() = default;
+    // estimated memory for running a site with the given mode,
+    // from the records measured at that site
+    size_t estimate(const vector<MemoryBudgetRecord> &recs,
+                    MemoryModeTypes mode) const {
+        const bool main_stack = frame_<FPS>()->use_main_stack;
+        const uint8_t m = (uint8_t)mode;
+        size_t stack = 0, eff_ham = 0, block = 0, buffer = 0, frame = 0;
+        if (recs[m].valid)
+            stack = recs[m].stack;
+        for (uint8_t k = 0; k < (uint8_t)recs.size(); k++) {
+            if (!recs[k].valid)
+                continue;
+            if (!recs[m].valid)
+                stack = max(stack, (size_t)(recs[k].stack * stack_ratio[m] /
+                                            stack_ratio[k]));
+            eff_ham = max(eff_ham, recs[k].eff_ham);
+            block = max(block, recs[k].block);
+            buffer = max(buffer, recs[k].buffer);
+            frame = max(frame, recs[k].frame);
+        }
+        size_t r = stack + (main_stack ? 0 : eff_ham);
+        // cached block is kept alive until the next site; before any
+        // block is measured, it is assumed to be as large as eff ham
+        if (mode == MemoryModeTypes::Cached && !main_stack)
+            r += block != 0 ? block
+                            : (last_block != 0 ? last_block : eff_ham);
+        // before any buffer is measured, assume that every frame has
+        // one copy in the load buffer and one in the save buffer
+        if (mode <= MemoryModeTypes::Buffered)
+            r += buffer != 0 ? buffer
+                             : (last_buffer != 0 ? last_buffer : frame * 2);
+        return r;
+    }
+    // fused multiplication cannot be combined with delayed contraction
+    // or tasked sequential gemm
+    MemoryModeTypes max_allowed_mode(
+        const shared_ptr<MovingEnvironment<S, FL, FLS>> &me) const {
+        if (max_mode == MemoryModeTypes::FusedMultiplication &&
+            (!me->delayed_contraction.empty() ||
+             (threading->seq_type & SeqTypes::Tasked)))
+            return MemoryModeTypes::FusedRotation;
+        return max_mode;
+    }
+    // choose and apply the memory mode for the next site
+    MemoryModeTypes
+    begin_site(int i, bool forward,
+               const shared_ptr<MovingEnvironment<S, FL, FLS>> &me) {
+        auto it = history.find(make_pair(i, forward));
+        if (it == history.end())
+            it = history.find(last_site);
+        const MemoryModeTypes mx_mode = max_allowed_mode(me);
+        MemoryModeTypes mode = min(min_mode, mx_mode);
+        size_t est = 0;
+        if (it == history.end())
+            mode = mx_mode;
+        else
+            for (; mode < mx_mode; mode = (MemoryModeTypes)((uint8_t)mode + 1))
+                if ((est = estimate(it->second, mode)) <= max_memory)
+                    break;
+        if (mode == MemoryModeTypes::Cached && frame_<FPS>()->use_main_stack &&
+            mx_mode != MemoryModeTypes::Cached)
+            mode = MemoryModeTypes::Buffered;
+        if (it != history.end())
+            est = estimate(it->second, mode);
+        apply(mode, me);
+        decisions.push_back(MemoryBudgetDecision{i, forward, mode, est, 0, 0});
+        // measure the peak memory of this site only
+        const shared_ptr<DataFrame<FPS>> &frame = frame_<FPS>();
+        outer_peak = frame->peak_used_memory;
+        frame->reset_peak_used_memory();
+        return mode;
+    }
+    // record the memory used by the site and log the decision
+    void end_site(int i, bool forward,
+                  const shared_ptr<MovingEnvironment<S, FL, FLS>> &me,
+                  size_t eff_ham_size) {
+        const shared_ptr<DataFrame<FPS>> &frame = frame_<FPS>();
+        frame->update_peak_used_memory();
+        MemoryBudgetDecision &d = decisions.back();
+        MemoryBudgetRecord rec;
+        for (size_t k = 0; k < frame->peak_used_memory.size(); k++)
+            rec.stack += frame->peak_used_memory[k];
+        for (size_t k = 0; k < outer_peak.size(); k++)
+            frame->peak_used_memory[k] =
+                max(frame->peak_used_memory[k], outer_peak[k]);
+        rec.eff_ham = eff_ham_size * sizeof(FL);
+        rec.frame = frame->memory_used();
+        if (me->cached_opt != nullptr &&
+            me->cached_info.first != OpCachingTypes::None)
+            last_block = rec.block =
+                me->cached_opt->get_total_memory() * sizeof(FL);
+        if (frame->load_buffering || frame->save_buffering)
+            last_buffer = rec.buffer = frame->buffer_memory_used();
+        rec.valid = true;
+        vector<MemoryBudgetRecord> &recs = history[make_pair(i, forward)];
+        recs.resize(stack_ratio.size());
+        const uint8_t m = (uint8_t)d.mode;
+        // refine the ratio of the more memory-saving mode of each pair
+        for (uint8_t k = 0; k < (uint8_t)recs.size(); k++) {
+            if (k == m || !recs[k].valid || recs[k].stack == 0 ||
+                rec.stack == 0)
+                continue;
+            const uint8_t lo = min(k, m), hi = max(k, m);
+            const double x = stack_ratio[lo] *
+                             (double)(hi == m ? rec.stack : recs[k].stack) /
+                             (double)(hi == m ? recs[k].stack : rec.stack);
+            stack_ratio[hi] = (stack_ratio[hi] * n_stack_ratio[hi] + x) /
+                              (n_stack_ratio[hi] + 1);
+            n_stack_ratio[hi]++;
+        }
+        recs[m] = rec;
+        last_site = make_pair(i, forward);
+        d.heap = rec.heap(frame->use_main_stack);
+        d.observed = rec.stack + d.heap;
+        if (iprint >= 1) {
+            stringstream ss;
+            ss << " MEM-BUDGET | Site = " << setw(4) << i << " "
+               << (forward ? "-->" : "<--") << " | Mode = " << setw(10)
+               << d.mode << " | Est = "
+               << (d.estimated == 0 ? string("--")
+                                    : Parsing::to_size_string(d.estimated))
+               << " | Obs = " << Parsing::to_size_string(d.observed)
+               << " (Heap = " << Parsing::to_size_string(d.heap) << ")"
+               << " | Limit = " << Parsing::to_size_string(max_memory);
+            if (d.observed > max_memory)
+                ss << " (EXCEEDED)";
+            cout << ss.str() << endl;
+        }
+    }
+    // set the flags in MovingEnvironment and DataFrame for one mode
+    static void apply(MemoryModeTypes mode,
+                      const shared_ptr<MovingEnvironment<S, FL, FLS>> &me) {
+        const shared_ptr<DataFrame<FPS>> &frame = frame_<FPS>();
+        const bool cached = mode == MemoryModeTypes::Cached;
+        if (!cached && me->cached_contraction) {
+            // drop the cached block so that it will not be reused
+            me->cached_opt = nullptr;
+            me->cached_info = make_pair(OpCachingTypes::None, -1);
+        }
+        me->cached_contraction = cached && !frame->use_main_stack;
+        const bool buffered = mode <= MemoryModeTypes::Buffered;
+        if (!buffered && (frame->load_buffering || frame->save_buffering))
+            // wait for async saving and release the buffers
+            for (int k = 0; k < frame->n_frames; k++)
+                frame->reset_buffer(k);
+        frame->load_buffering = frame->save_buffering = buffered;
+        me->fused_contraction_rotation = me->lowmem_numerical_transform =
+            mode >= MemoryModeTypes::FusedRotation;
+        me->fused_contraction_multiplication =
+            mode >= MemoryModeTypes::FusedMultiplication;
+    }
+};
+
+} // namespace block2
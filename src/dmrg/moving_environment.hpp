@@ -21,6 +21,7 @@
 #pragma once
 
 #include "../core/archived_tensor_functions.hpp"
+#include "../core/delayed_tensor_functions.hpp"
 #include "../core/parallel_rule.hpp"
 #include "../core/tensor_functions.hpp"
 #include "determinant.hpp"
@@ -172,8 +173,10 @@ template <typename S, typename FL, typename FLS> struct MovingEnvironment {
     // !frame_<FP>()->use_main_stack)
     bool cached_contraction = false;
     // whether contraction and rotation should be done within one-step, without
-    // using large memory for blocking (only saving memory when no explicit
-    // left/right_contact is invoked, which is the case for zero-dot expt)
+    // using large memory for blocking (each blocking operator is formed only
+    // a few symmetry blocks at a time, in a workspace of the size of the
+    // rotated operator; together with fused_contraction_multiplication
+    // no blocking operator is formed in sweeps)
     // fused_contraction_rotation = T conflicts with cached_contraction = T
     bool fused_contraction_rotation = false;
     // whether contraction and wavefunction multiplication should be done
@@ -187,6 +190,9 @@ template <typename S, typename FL, typename FLS> struct MovingEnvironment {
     bool iprint = false;
     bool save_partition_info = false;
     OpNamesSet delayed_contraction = OpNamesSet();
+    // (original size, compressed size, discarded squared norm) of the
+    // low-rank factorized left/right renormalized operators at each site
+    vector<tuple<size_t, size_t, FP>> left_low_rank_info, right_low_rank_info;
     int fuse_center;
     // Set this to false for non-propagate expectation
     bool save_environments = true;
@@ -370,7 +376,8 @@ template <typename S, typename FL, typename FLS> struct MovingEnvironment {
             mpo->unload_left_operators(i - 1);
             stacked_mpo->unload_tensor(i - 1);
             stacked_mpo->unload_left_operators(i - 1);
-            copied_left = nullptr;
+            if (!frame_<FP>()->use_main_stack)
+                copied_left = nullptr;
         } else {
             mpo->tf->left_contract_rotate(copied_left, mpo->tensors[i - 1], fbt,
                                           fkt, new_left, envs[i]->left,
@@ -379,7 +386,8 @@ template <typename S, typename FL, typename FLS> struct MovingEnvironment {
                                               : nullptr);
             mpo->unload_tensor(i - 1);
             mpo->unload_left_operators(i - 1);
-            copied_left = nullptr;
+            if (!frame_<FP>()->use_main_stack)
+                copied_left = nullptr;
         }
         size_t blocking_mem = new_left->get_total_memory() + copied_mem;
         size_t renormal_mem = envs[i]->left->get_total_memory();
@@ -417,11 +425,23 @@ template <typename S, typename FL, typename FLS> struct MovingEnvironment {
                                    true);
             mpo->unload_left_operators(i);
         }
+        if (mpo->tf->get_type() == TensorFunctionsTypes::Delayed &&
+            dynamic_pointer_cast<DelayedTensorFunctions<S, FL>>(mpo->tf)
+                    ->low_rank_cutoff > 0) {
+            if ((int)left_low_rank_info.size() < n_sites)
+                left_low_rank_info.resize(n_sites, make_tuple(0, 0, (FP)0.0));
+            left_low_rank_info[i] =
+                dynamic_pointer_cast<DelayedTensorFunctions<S, FL>>(mpo->tf)
+                    ->low_rank_compress(envs[i]->left);
+            renormal_mem = get<1>(left_low_rank_info[i]);
+        }
         tint += _t.get_time();
         frame_<FP>()->activate(0);
         if (bra != ket)
             ket->unload_tensor(i - 1);
         bra->unload_tensor(i - 1);
+        if (copied_left != nullptr)
+            copied_left->deallocate();
         if (frame_<FP>()->use_main_stack)
             new_left->deallocate();
         Partition<S, FL>::deallocate_op_infos_notrunc(left_op_infos_notrunc);
@@ -595,7 +615,8 @@ template <typename S, typename FL, typename FLS> struct MovingEnvironment {
             mpo->unload_right_operators(i + dot);
             stacked_mpo->unload_tensor(i + dot);
             stacked_mpo->unload_right_operators(i + dot);
-            copied_right = nullptr;
+            if (!frame_<FP>()->use_main_stack)
+                copied_right = nullptr;
         } else {
             mpo->tf->right_contract_rotate(
                 copied_right, mpo->tensors[i + dot], fbt, fkt, new_right,
@@ -605,7 +626,8 @@ template <typename S, typename FL, typename FLS> struct MovingEnvironment {
                     : nullptr);
             mpo->unload_tensor(i + dot);
             mpo->unload_right_operators(i + dot);
-            copied_right = nullptr;
+            if (!frame_<FP>()->use_main_stack)
+                copied_right = nullptr;
         }
         size_t blocking_mem = new_right->get_total_memory() + copied_mem;
         size_t renormal_mem = envs[i]->right->get_total_memory();
@@ -646,11 +668,24 @@ template <typename S, typename FL, typename FLS> struct MovingEnvironment {
                                    envs[i]->right, false);
             mpo->unload_right_operators(i + dot - 1);
         }
+        if (mpo->tf->get_type() == TensorFunctionsTypes::Delayed &&
+            dynamic_pointer_cast<DelayedTensorFunctions<S, FL>>(mpo->tf)
+                    ->low_rank_cutoff > 0) {
+            if ((int)right_low_rank_info.size() < n_sites)
+                right_low_rank_info.resize(n_sites,
+                                           make_tuple(0, 0, (FP)0.0));
+            right_low_rank_info[i] =
+                dynamic_pointer_cast<DelayedTensorFunctions<S, FL>>(mpo->tf)
+                    ->low_rank_compress(envs[i]->right);
+            renormal_mem = get<1>(right_low_rank_info[i]);
+        }
         tint += _t.get_time();
         frame_<FP>()->activate(0);
         if (bra != ket)
             ket->unload_tensor(i + dot);
         bra->unload_tensor(i + dot);
+        if (copied_right != nullptr)
+            copied_right->deallocate();
         if (frame_<FP>()->use_main_stack)
             new_right->deallocate();
         Partition<S, FL>::deallocate_op_infos_notrunc(right_op_infos_notrunc);
@@ -893,8 +928,8 @@ template <typename S, typename FL, typename FLS> struct MovingEnvironment {
             me->envs[i]->left_op_infos = envs[i]->left_op_infos;
             me->envs[i]->right_op_infos = envs[i]->right_op_infos;
             if (envs[i]->left != nullptr) {
-                Parsing::link_file(get_left_partition_filename(i),
-                                   me->get_left_partition_filename(i));
+                frame_<FP>()->link_data(get_left_partition_filename(i),
+                                        me->get_left_partition_filename(i));
                 if (left_part_files.count(i)) {
                     const string partition_filename =
                         me->get_left_partition_filename(i);
@@ -903,8 +938,8 @@ template <typename S, typename FL, typename FLS> struct MovingEnvironment {
                 }
             }
             if (envs[i]->right != nullptr) {
-                Parsing::link_file(get_right_partition_filename(i),
-                                   me->get_right_partition_filename(i));
+                frame_<FP>()->link_data(get_right_partition_filename(i),
+                                        me->get_right_partition_filename(i));
                 if (right_part_files.count(i)) {
                     const string partition_filename =
                         me->get_right_partition_filename(i);
@@ -1366,6 +1401,9 @@ template <typename S, typename FL, typename FLS> struct MovingEnvironment {
                          << Parsing::to_size_string(pbr.first * sizeof(FL));
                     cout << " Rmem = " << setw(7)
                          << Parsing::to_size_string(pbr.second * sizeof(FL));
+                    if ((int)left_low_rank_info.size() > i)
+                        cout << " LRdw = " << scientific << setprecision(2)
+                             << get<2>(left_low_rank_info[i]);
                     cout << " T = " << setw(4) << fixed << setprecision(2)
                          << _t2.get_time() << endl;
                 }
@@ -1385,6 +1423,9 @@ template <typename S, typename FL, typename FLS> struct MovingEnvironment {
                          << Parsing::to_size_string(pbr.first * sizeof(FL));
                     cout << " Rmem = " << setw(7)
                          << Parsing::to_size_string(pbr.second * sizeof(FL));
+                    if ((int)right_low_rank_info.size() > i)
+                        cout << " LRdw = " << scientific << setprecision(2)
+                             << get<2>(right_low_rank_info[i]);
                     cout << " T = " << setw(4) << fixed << setprecision(2)
                          << _t2.get_time() << endl;
                 }
@@ -1527,13 +1568,11 @@ template <typename S, typename FL, typename FLS> struct MovingEnvironment {
         for (int i = 0; i < n_sites; i++)
             for (int info = 0; info < 2; info++) {
                 string left_data_name = get_left_partition_filename(i, info);
-                if (Parsing::file_exists(left_data_name))
-                    Parsing::remove_file(left_data_name);
+                frame_<FP>()->remove_data(left_data_name);
                 if (info == 0 && left_part_files.count(i))
                     left_part_files.erase(i);
                 string right_data_name = get_right_partition_filename(i, info);
-                if (Parsing::file_exists(right_data_name))
-                    Parsing::remove_file(right_data_name);
+                frame_<FP>()->remove_data(right_data_name);
                 if (info == 0 && right_part_files.count(i))
                     right_part_files.erase(i);
             }
@@ -1564,8 +1603,7 @@ template <typename S, typename FL, typename FLS> struct MovingEnvironment {
             if (frame_<FP>()->minimal_disk_usage && !preserve_data &&
                 envs[center - 1]->right != nullptr) {
                 string old_data_name = get_right_partition_filename(center - 1);
-                if (Parsing::file_exists(old_data_name))
-                    Parsing::remove_file(old_data_name);
+                frame_<FP>()->remove_data(old_data_name);
                 if (right_part_files.count(center - 1))
                     right_part_files.erase(center - 1);
             }
@@ -1582,8 +1620,7 @@ template <typename S, typename FL, typename FLS> struct MovingEnvironment {
             if (frame_<FP>()->minimal_disk_usage && !preserve_data &&
                 envs[center + 1]->left != nullptr) {
                 string old_data_name = get_left_partition_filename(center + 1);
-                if (Parsing::file_exists(old_data_name))
-                    Parsing::remove_file(old_data_name);
+                frame_<FP>()->remove_data(old_data_name);
                 if (left_part_files.count(center + 1))
                     left_part_files.erase(center + 1);
             }
@@ -3722,15 +3759,20 @@ template <typename S, typename FL, typename FLS> struct MovingEnvironment {
             dm->info->n, GDiagonalMatrix<FPS>(nullptr, 0));
         vector<GMatrix<FPS>> eigen_values_reduced(dm->info->n,
                                                   GMatrix<FPS>(nullptr, 0, 0));
-        int ntg = threading->activate_global();
-#pragma omp parallel for schedule(dynamic) num_threads(ntg)
-        for (int i = 0; i < dm->info->n; i++) {
+        vector<pair<size_t, size_t>> dims(dm->info->n);
+        for (int i = 0; i < dm->info->n; i++)
+            dims[i] = make_pair((size_t)dm->info->n_states_bra[i],
+                                (size_t)dm->info->n_states_ket[i]);
+        threading->parallel_decompose(dims, [&](int i, bool large) {
             d_allocs[i] = make_shared<VectorAllocator<FPS>>();
             GDiagonalMatrix<FPS> w(nullptr, dm->info->n_states_bra[i]);
             w.allocate(d_allocs[i]);
             if (trunc_type & TruncationTypes::RealDensityMatrix)
                 GMatrixFunctions<FLS>::keep_real((*dm)[i]);
-            GMatrixFunctions<FLS>::eigs((*dm)[i], w);
+            if (large)
+                GMatrixFunctions<FLS>::eigs_dc((*dm)[i], w);
+            else
+                GMatrixFunctions<FLS>::eigs((*dm)[i], w);
             GMatrix<FPS> wr(nullptr, w.n, 1);
             wr.allocate(d_allocs[i]);
             GMatrixFunctions<FPS>::copy(wr, GMatrix<FPS>(w.data, w.n, 1));
@@ -3742,7 +3784,7 @@ template <typename S, typename FL, typename FLS> struct MovingEnvironment {
                     wr, dm->info->quanta[i].multiplicity());
             eigen_values[i] = w;
             eigen_values_reduced[i] = wr;
-        }
+        });
         threading->activate_normal();
         int k_total = 0, k_total_multi = 0;
         for (int i = 0; i < dm->info->n; i++) {
@@ -314,6 +314,68 @@ template <typename S, typename FL> struct MPO {
         }
         return r;
     }
+    // Recompute the site operators from the current integrals in hamil,
+    // keeping the symbolic part of the MPO. Only valid when the changed
+    // values neither enter the symbolic coefficients nor the screening of
+    // zero site operators done when the MPO was built
+    virtual void refresh_site_ops() {
+        if (hamil == nullptr || hamil->n_sites != n_sites)
+            throw runtime_error(
+                "MPO::refresh_site_ops: site operators are not from hamil.");
+        for (int m = 0; m < n_sites; m++)
+            if (sparse_form[m] != 'N')
+                throw runtime_error(
+                    "MPO::refresh_site_ops: only normal sparse form.");
+        SeqTypes seqt = hamil->opf->seq->mode;
+        hamil->opf->seq->mode = SeqTypes::None;
+        int ntg = threading->activate_global();
+        int ntgb = frame_<FP>()->minimal_memory_usage ? 1 : ntg;
+#pragma omp parallel for schedule(dynamic) num_threads(ntgb)
+        for (int m = 0; m < n_sites; m++) {
+            load_tensor(m);
+            shared_ptr<OperatorTensor<S, FL>> opt = tensors[m];
+            unordered_map<shared_ptr<OpExpr<S>>,
+                          shared_ptr<SparseMatrix<S, FL>>>
+                ops;
+            ops.reserve(opt->ops.size());
+            for (auto &p : opt->ops)
+                ops[p.first] = nullptr;
+            hamil->get_site_ops((uint16_t)m, ops);
+            shared_ptr<VectorAllocator<FP>> d_alloc =
+                make_shared<VectorAllocator<FP>>();
+            for (auto &p : opt->ops) {
+                shared_ptr<SparseMatrix<S, FL>> &mat = p.second;
+                const shared_ptr<SparseMatrix<S, FL>> &xmat = ops.at(p.first);
+                if (xmat == mat)
+                    continue;
+                else if (mat->get_type() != SparseMatrixTypes::Normal ||
+                         xmat->get_type() != SparseMatrixTypes::Normal)
+                    mat = xmat;
+                else if (xmat->factor == (FL)0.0 || xmat->info == nullptr ||
+                         xmat->info->n == 0) {
+                    // operator becomes zero, but is still in the symbolic
+                    if (mat->alloc == nullptr) {
+                        shared_ptr<SparseMatrixInfo<S>> info = mat->info;
+                        mat = make_shared<SparseMatrix<S, FL>>(d_alloc);
+                        mat->allocate(info);
+                    }
+                    mat->factor = 1.0;
+                    mat->clear();
+                } else if (mat->alloc != nullptr &&
+                           mat->info->n == xmat->info->n &&
+                           mat->total_memory == xmat->total_memory) {
+                    // keep the storage of operators (e.g. loaded from disk)
+                    mat->copy_data_from(xmat);
+                    mat->factor = xmat->factor;
+                } else
+                    mat = xmat;
+            }
+            save_tensor(m);
+            unload_tensor(m);
+        }
+        threading->activate_normal();
+        hamil->opf->seq->mode = seqt;
+    }
     string get_filename(int i, int ixtag, const string &dir = "") const {
         const static string xtag[] = {"TENSOR", "LEFT.OP", "RIGHT.OP",
                                       "MIDDLE.OP"};
@@ -2269,11 +2269,30 @@ template <typename S, typename FL> struct MPS {
             left->deallocate();
         }
     }
-    void canonicalize() {
+    // QR (LQ) of each site tensor left (right) to the center,
+    // with R (L) multiplied in place into the next site tensor
+    // iprint: print per-site timing and throughput
+    void canonicalize(bool iprint = false) {
         shared_ptr<VectorAllocator<uint32_t>> i_alloc =
             make_shared<VectorAllocator<uint32_t>>();
         shared_ptr<VectorAllocator<FP>> d_alloc =
             make_shared<VectorAllocator<FP>>();
+        Timer t, tt;
+        tt.get_time();
+        size_t tmem = 0;
+        auto print_site = [&t, &tmem, iprint](int i, char dir, size_t mem) {
+            double tx = t.get_time();
+            tmem += mem;
+            if (iprint)
+                cout << "CANON | Site = " << setw(4) << i << " | " << dir
+                     << " | Mem = " << setw(10) << fixed << setprecision(3)
+                     << mem * sizeof(FL) / 1E6 << " MB | T = " << setw(8)
+                     << setprecision(3) << tx << " | "
+                     << setprecision(1) << setw(10)
+                     << mem * sizeof(FL) / 1E6 / max(tx, 1E-9) << " MB/s"
+                     << endl;
+        };
+        t.get_time();
         for (int i = 0; i < center; i++) {
             assert(tensors[i] != nullptr);
             shared_ptr<SparseMatrix<S, FL>> tmat =
@@ -2305,6 +2324,7 @@ template <typename S, typename FL> struct MPS {
             lm.deallocate();
             tmat_info->deallocate();
             tmat->deallocate();
+            print_site(i, 'L', tensors[i]->total_memory);
         }
         for (int i = n_sites - 1; i >= center + dot; i--) {
             assert(tensors[i] != nullptr);
@@ -2350,6 +2370,14 @@ template <typename S, typename FL> struct MPS {
             }
             tmat_info->deallocate();
             tmat->deallocate();
+            print_site(i, 'R', tensors[i]->total_memory);
+        }
+        if (iprint) {
+            double ttot = tt.get_time();
+            cout << "CANON | Total Mem = " << fixed << setprecision(3)
+                 << tmem * sizeof(FL) / 1E6 << " MB | T = " << ttot << " | "
+                 << setprecision(1) << tmem * sizeof(FL) / 1E6 / max(ttot, 1E-9)
+                 << " MB/s" << endl;
         }
     }
     void random_canonicalize_tensor(int i) {
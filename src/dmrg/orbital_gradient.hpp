@@ -0,0 +1,280 @@
+/*
+ * block2: Efficient MPO implementation of quantum chemistry DMRG
+ * Copyright (C) 2020-2021 Huanchen Zhai <hczhai@caltech.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "../core/expr.hpp"
+#include "../core/integral.hpp"
+#include "../core/matrix_functions.hpp"
+#include "../core/threading.hpp"
+#include "sweep_algorithm.hpp"
+#include <cassert>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+namespace block2 {
+
+// Weight of one PDM2 expectation (from PDM2MPOQC) in the spin-traced 2PDM
+//   dm2[i, j, k, l] = sum_{st} < a^dagger_{is} a^dagger_{jt} a_{kt} a_{ls} >
+template <typename, typename = void> struct PDM2SpatialWeight;
+
+template <typename S> struct PDM2SpatialWeight<S, typename S::is_sz_t> {
+    static double get(const SiteIndex &si) {
+        return si.s(0) == si.s(3) && si.s(1) == si.s(2) ? 1.0 : 0.0;
+    }
+};
+
+// -[pqrs][0] + sqrt(3) * [pqrs][1]
+template <typename S> struct PDM2SpatialWeight<S, typename S::is_su2_t> {
+    static double get(const SiteIndex &si) {
+        return si.ss() == 0 ? -1.0 : sqrt(3.0);
+    }
+};
+
+// Active-space generalized Fock matrix, orbital gradient and orbital
+// Hessian-vector products for DMRG-SCF. The PDM2 expectations are contracted
+// site by site as the Expect sweep produces them (as its consumer), so that
+// neither the 2PDM nor the list of its elements is ever stored; only n x n
+// accumulators are kept. 1PDM is recovered from the 2PDM by partial trace.
+// With spin-traced 1PDM dm1[p, q] = <p^dagger q> and dm2 above,
+//   F[p, q] = sum_r h[p, r] dm1[q, r] + sum_{rst} (pr|st) dm2[q, s, t, r]
+//   grad[p, q] = 2 (F[p, q] - F[q, p])
+// where grad is the derivative of energy with respect to kappa[p, q] (p > q)
+// for orbital rotation U = exp(kappa). All matrices are row-major.
+// If hessian is true, the 2PDM contracted with the integrals is also
+// accumulated in one n^4 intermediate (the size of the integrals), after
+// which Hessian-vector products cost O(n^4) each for any kappa.
+template <typename S, typename FL>
+struct OrbitalGradientQC : ExpectationConsumer<S, FL> {
+    typedef typename GMatrix<FL>::FP FP;
+    typedef vector<pair<shared_ptr<OpExpr<S>>, FL>> SiteExpectations;
+    typedef vector<SiteExpectations> Expectations;
+    shared_ptr<FCIDUMP<FL>> fcidump;
+    uint16_t n_sites;
+    uint16_t n_elec;
+    // whether to accumulate the intermediate for hessian_vector
+    bool hessian = false;
+    // h[p, r]
+    vector<FL> hint;
+    // (pr|st) stored as [r, s, t, p]
+    vector<FL> gint;
+    // accumulated sum_{rst} (pr|st) dm2[q, s, t, r] as [q, p]
+    vector<FL> f2;
+    // accumulated (n_elec - 1) dm1[q, r] as [q, r]
+    vector<FL> d2;
+    // accumulated two-electron part of F~[p, q] (see hessian_vector)
+    // excluding the transform of the last index of integral, as
+    //   F~2[p, q] = sum_{mx} kappa[m, x] zint[q, m, x, p]
+    vector<FL> zint;
+    OrbitalGradientQC(const shared_ptr<FCIDUMP<FL>> &fcidump)
+        : fcidump(fcidump), n_sites(fcidump->n_sites()),
+          n_elec(fcidump->n_elec()) {
+        if (fcidump->uhf || fcidump->general)
+            throw runtime_error("OrbitalGradientQC: only spin-restricted "
+                                "integrals are supported!");
+        if (n_elec < 2)
+            throw runtime_error(
+                "OrbitalGradientQC: at least two electrons required!");
+        const size_t n = n_sites;
+        hint.resize(n * n);
+        gint.resize(n * n * n * n);
+        int ntg = threading->activate_global();
+#pragma omp parallel for schedule(static) num_threads(ntg)
+        for (int p = 0; p < (int)n; p++) {
+            for (uint16_t r = 0; r < n; r++)
+                hint[p * n + r] = fcidump->t(p, r);
+            for (uint16_t r = 0; r < n; r++)
+                for (uint16_t s = 0; s < n; s++)
+                    for (uint16_t t = 0; t < n; t++)
+                        gint[((r * n + s) * n + t) * n + p] =
+                            fcidump->v(p, r, s, t);
+        }
+        threading->activate_normal();
+        reset();
+    }
+    virtual ~OrbitalGradientQC() = default;
+    // Clear accumulated expectations
+    void reset() {
+        const size_t nn = (size_t)n_sites * n_sites;
+        f2.assign(nn, (FL)0.0);
+        d2.assign(nn, (FL)0.0);
+        zint.assign(hessian ? nn * nn : 0, (FL)0.0);
+    }
+    // Accumulate the PDM2 expectations of one site
+    void consume(int i, const SiteExpectations &expectations) override {
+        const size_t n = n_sites, nn = n * n;
+        if (hessian != (zint.size() != 0))
+            throw runtime_error("OrbitalGradientQC: hessian changed after "
+                                "reset!");
+        // weighted elements grouped by the first index q, with (s, t, r)
+        // packed, so that each thread only writes the rows of its own q
+        vector<vector<pair<size_t, FL>>> xq(n);
+        for (size_t iv = 0; iv < expectations.size(); iv++) {
+            shared_ptr<OpElement<S, FL>> op =
+                dynamic_pointer_cast<OpElement<S, FL>>(
+                    expectations[iv].first);
+            if (op == nullptr || op->name != OpNames::PDM2)
+                continue;
+            const FL v =
+                (FL)(FP)PDM2SpatialWeight<S>::get(op->site_index) *
+                expectations[iv].second;
+            if (v == (FL)0.0)
+                continue;
+            const size_t s = op->site_index[1], t = op->site_index[2];
+            const size_t r = op->site_index[3];
+            xq[op->site_index[0]].push_back(
+                make_pair((s * n + t) * n + r, v));
+        }
+        int ntg = threading->activate_global();
+#pragma omp parallel for schedule(dynamic) num_threads(ntg)
+        for (int q = 0; q < (int)n; q++) {
+            FL *pf = f2.data() + q * n, *pd = d2.data() + q * n;
+            for (const auto &x : xq[q]) {
+                const size_t r = x.first % n, t = x.first / n % n;
+                const size_t s = x.first / nn;
+                const FL v = x.second;
+                const FL *pg = gint.data() + ((r * n + s) * n + t) * n;
+                for (size_t p = 0; p < n; p++)
+                    pf[p] += v * pg[p];
+                if (s == t)
+                    pd[r] += v;
+                if (!hessian)
+                    continue;
+                // one-index transform of the first three indices of (pr|st)
+                for (size_t m = 0; m < n; m++) {
+                    FL *pz = zint.data() + (q * n + m) * nn;
+                    FL *zr = pz + r * n, *zs = pz + s * n, *zt = pz + t * n;
+                    const FL *gr = gint.data() + ((m * n + s) * n + t) * n;
+                    const FL *gs = gint.data() + ((r * n + m) * n + t) * n;
+                    const FL *gt = gint.data() + ((r * n + s) * n + m) * n;
+                    for (size_t p = 0; p < n; p++)
+                        zr[p] += v * gr[p], zs[p] += v * gs[p],
+                            zt[p] += v * gt[p];
+                }
+            }
+        }
+        threading->activate_normal();
+    }
+    // Accumulate stored expectations (from Expect without consumer)
+    // for one-dot, last expectations repeat those of previous site
+    void accumulate(const Expectations &expectations, int dot = 2) {
+        const size_t nx = expectations.size() - (dot == 1 ? 1 : 0);
+        for (size_t i = 0; i < nx; i++)
+            consume((int)i, expectations[i]);
+    }
+    // 1PDM from partial trace of accumulated 2PDM
+    vector<FL> get_1pdm() const {
+        vector<FL> d = d2;
+        for (size_t k = 0; k < d.size(); k++)
+            d[k] /= (FL)(FP)(n_elec - 1);
+        return d;
+    }
+    // F[p, q] = f[q, p] + sum_k h[p, k] dm1[q, k]
+    vector<FL> fock_from_parts(const vector<FL> &f, const vector<FL> &h,
+                               const vector<FL> &dm1) const {
+        const size_t n = n_sites;
+        vector<FL> r(n * n);
+        for (size_t p = 0; p < n; p++)
+            for (size_t q = 0; q < n; q++) {
+                FL x = f[q * n + p];
+                for (size_t k = 0; k < n; k++)
+                    x += h[p * n + k] * dm1[q * n + k];
+                r[p * n + q] = x;
+            }
+        return r;
+    }
+    // Generalized Fock matrix from accumulated expectations
+    vector<FL> fock() const { return fock_from_parts(f2, hint, get_1pdm()); }
+    // Energy (including core energy) from the generalized Fock matrix
+    FL energy() const {
+        const size_t n = n_sites;
+        vector<FL> dm1 = get_1pdm();
+        vector<FL> f = fock_from_parts(f2, hint, dm1);
+        FL e = (FL)fcidump->const_e;
+        for (size_t p = 0; p < n; p++) {
+            e += (FL)0.5 * f[p * n + p];
+            for (size_t q = 0; q < n; q++)
+                e += (FL)0.5 * hint[p * n + q] * dm1[p * n + q];
+        }
+        return e;
+    }
+    static vector<FL> gradient_from_fock(const vector<FL> &f, uint16_t n) {
+        vector<FL> g((size_t)n * n);
+        for (size_t p = 0; p < n; p++)
+            for (size_t q = 0; q < n; q++)
+                g[p * n + q] = (FL)2.0 * (f[p * n + q] - f[q * n + p]);
+        return g;
+    }
+    // Orbital gradient (antisymmetric n x n matrix)
+    vector<FL> gradient() const {
+        return gradient_from_fock(fock(), n_sites);
+    }
+    // Orbital Hessian-vector product for antisymmetric kappa (n x n).
+    // This is the Hessian of E(exp(kappa)), which is symmetric:
+    //   H kappa = 2 (F~ - F~^T) + (kappa grad - grad kappa) / 2
+    // where F~ is the generalized Fock matrix with one-index transformed
+    // integrals h~ = h kappa - kappa h, (pq|rs)~ = sum_m kappa[m, p] (mq|rs)
+    //   + kappa[m, q] (pm|rs) + kappa[m, r] (pq|ms) + kappa[m, s] (pq|rm)
+    vector<FL> hessian_vector(const vector<FL> &kappa) const {
+        const size_t n = n_sites, nn = n * n;
+        if (zint.size() != nn * nn)
+            throw runtime_error("OrbitalGradientQC: hessian intermediate "
+                                "is not accumulated!");
+        if (kappa.size() != nn)
+            throw runtime_error("OrbitalGradientQC: wrong kappa size!");
+        vector<FL> h(nn, (FL)0.0), f(nn, (FL)0.0);
+        for (size_t p = 0; p < n; p++)
+            for (size_t q = 0; q < n; q++)
+                for (size_t m = 0; m < n; m++)
+                    h[p * n + q] += hint[p * n + m] * kappa[m * n + q] -
+                                    kappa[p * n + m] * hint[m * n + q];
+        int ntg = threading->activate_global();
+#pragma omp parallel for schedule(static) num_threads(ntg)
+        for (int q = 0; q < (int)n; q++) {
+            FL *pf = f.data() + q * n;
+            const FL *pz = zint.data() + q * nn * n;
+            for (size_t k = 0; k < nn; k++)
+                if (kappa[k] != (FL)0.0)
+                    for (size_t p = 0; p < n; p++)
+                        pf[p] += kappa[k] * pz[k * n + p];
+            // transform of the last index: f[q, p] += kappa[m, p] f2[q, m]
+            for (size_t m = 0; m < n; m++)
+                for (size_t p = 0; p < n; p++)
+                    pf[p] += kappa[m * n + p] * f2[q * n + m];
+        }
+        threading->activate_normal();
+        vector<FL> gx =
+            gradient_from_fock(fock_from_parts(f, h, get_1pdm()), n_sites);
+        vector<FL> g0 = gradient();
+        for (size_t p = 0; p < n; p++)
+            for (size_t q = 0; q < n; q++) {
+                FL x = 0;
+                for (size_t m = 0; m < n; m++)
+                    x += kappa[p * n + m] * g0[m * n + q] -
+                         g0[p * n + m] * kappa[m * n + q];
+                gx[p * n + q] += (FL)0.5 * x;
+            }
+        return gx;
+    }
+};
+
+} // namespace block2
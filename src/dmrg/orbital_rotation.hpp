@@ -0,0 +1,690 @@
+/*
+ * block2: Efficient MPO implementation of quantum chemistry DMRG
+ * Copyright (C) 2020-2021 Huanchen Zhai <hczhai@caltech.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "../core/clebsch_gordan.hpp"
+#include "../core/iterative_matrix_functions.hpp"
+#include "../core/sparse_matrix.hpp"
+#include "../core/threading.hpp"
+#include "moving_environment.hpp"
+#include "mps.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace block2 {
+
+// Elementary site operators a^dagger_sigma and a_sigma
+// in the site basis of HamiltonianQC
+template <typename, typename = void> struct GivensSiteOperators;
+
+// Sites are spatial orbitals: |0>, |alpha>, |beta>, |alpha beta>
+template <typename S> struct GivensSiteOperators<S, typename S::is_sz_t> {
+    static int n_spins() { return 2; }
+    static S delta_quantum(bool cre, int s) {
+        return cre ? S(1, s ? -1 : 1, 0) : S(-1, s ? 1 : -1, 0);
+    }
+    // <bra|op|ket>
+    static double element(bool cre, int s, S bra, S ket) {
+        const int sz = s ? -1 : 1;
+        if (!cre)
+            swap(bra, ket);
+        if (bra.n() != ket.n() + 1)
+            return 0.0;
+        else if (ket.n() == 0)
+            return bra.twos() == sz ? 1.0 : 0.0;
+        else if (ket.n() == 1 && ket.twos() == -sz)
+            return s ? -1.0 : 1.0;
+        else
+            return 0.0;
+    }
+};
+
+// Sites are spatial orbitals: |0>, |1/2>, |2>
+// elements are reduced matrix elements
+template <typename S> struct GivensSiteOperators<S, typename S::is_su2_t> {
+    static int n_spins() { return 1; }
+    static S delta_quantum(bool cre, int s) {
+        return cre ? S(1, 1, 0) : S(-1, 1, 0);
+    }
+    static double element(bool cre, int s, S bra, S ket) {
+        if (cre && bra.n() == ket.n() + 1)
+            return ket.n() == 0 ? 1.0 : -sqrt(2.0);
+        else if (!cre && bra.n() + 1 == ket.n())
+            return ket.n() == 1 ? sqrt(2.0) : 1.0;
+        else
+            return 0.0;
+    }
+};
+
+// Sites are spin orbitals: |0>, |1>
+template <typename S> struct GivensSiteOperators<S, typename S::is_sg_t> {
+    static int n_spins() { return 1; }
+    static S delta_quantum(bool cre, int s) { return S(cre ? 1 : -1, 0); }
+    static double element(bool cre, int s, S bra, S ket) {
+        return (cre ? bra.n() == ket.n() + 1 : bra.n() + 1 == ket.n()) ? 1.0
+                                                                        : 0.0;
+    }
+};
+
+// Orbital rotation of MPS using nearest-neighbour Givens rotation gates
+// The rotation matrix U is decomposed into two-site gates
+//   exp[theta (E_{i,i+1} - E_{i+1,i})]
+// (QR-style elimination), which are applied to the two-site wavefunction
+// during sweeps, followed by truncation. Gates acting on the same bond in the
+// same sweep are merged. Orbitals are spatial for SZ/SU2 and spin orbitals
+// for SGF. The MPS is transformed as |psi> -> U^|psi>, where
+//   U^ a^dagger_j U^dagger = sum_i a^dagger_i U[i, j]
+// namely, the input MPS in orbitals phi_j = sum_i phi'_i U[i, j]
+// is transformed into the same state in orbitals phi'.
+template <typename S, typename FL> struct OrbitalRotation {
+    typedef typename GMatrix<FL>::FP FP;
+    struct GivensGate {
+        int bond;
+        FP theta;
+        // sign flip of the orbitals at bond and bond + 1 (after rotation)
+        bool flip[2];
+        GivensGate(int bond, FP theta, bool flip_a = false,
+                   bool flip_b = false)
+            : bond(bond), theta(theta) {
+            flip[0] = flip_a, flip[1] = flip_b;
+        }
+    };
+    shared_ptr<MPS<S, FL>> mps;
+    shared_ptr<CG<S>> cg;
+    ubond_t bond_dim;
+    FP cutoff = 1E-14;
+    TruncationTypes trunc_type = TruncationTypes::Physical;
+    bool normalize_mps = false;
+    uint8_t iprint = 2;
+    // max discarded weight in each sweep
+    vector<FP> discarded_weights;
+    vector<FP> wfn_spectra;
+    double tgate = 0, tsplit = 0;
+    Timer _t;
+    OrbitalRotation(const shared_ptr<MPS<S, FL>> &mps, ubond_t bond_dim,
+                    const shared_ptr<CG<S>> &cg = nullptr)
+        : mps(mps), cg(cg), bond_dim(bond_dim) {
+        if (this->cg == nullptr)
+            this->cg = make_shared<CG<S>>();
+    }
+    // Decompose orthogonal matrix rot (row-major, n x n) into
+    // nearest-neighbour Givens rotations, in the order of application
+    static vector<GivensGate> givens_decompose(const vector<FP> &rot, int n) {
+        assert((int)rot.size() == n * n);
+        vector<FP> a = rot;
+        vector<GivensGate> elim, gates;
+        // a <- g^T a, zeroing the lower triangle column by column
+        for (int j = 0; j < n - 1; j++)
+            for (int i = n - 1; i > j; i--) {
+                FP x = a[(i - 1) * n + j], y = a[i * n + j];
+                if (abs(y) < (FP)1E-14)
+                    continue;
+                FP rho = sqrt(x * x + y * y), c = x / rho, s = -y / rho;
+                for (int k = 0; k < n; k++) {
+                    FP p = a[(i - 1) * n + k], q = a[i * n + k];
+                    a[(i - 1) * n + k] = c * p - s * q;
+                    a[i * n + k] = s * p + c * q;
+                }
+                elim.push_back(GivensGate(i - 1, atan2(s, c)));
+            }
+        // remaining diagonal part (+1 or -1) is applied first
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++)
+                if (abs(a[i * n + j] - (FP)(i == j ? 1 : 0)) > (FP)1E-8 &&
+                    abs(a[i * n + j] + (FP)(i == j ? 1 : 0)) > (FP)1E-8)
+                    throw runtime_error("OrbitalRotation::givens_decompose: "
+                                        "rotation matrix is not orthogonal!");
+            if (a[i * n + i] < 0) {
+                if (n == 1)
+                    throw runtime_error("OrbitalRotation::givens_decompose: "
+                                        "at least two orbitals required!");
+                const int ib = min(i, n - 2);
+                gates.push_back(GivensGate(ib, 0, i == ib, i != ib));
+            }
+        }
+        gates.insert(gates.end(), elim.rbegin(), elim.rend());
+        return gates;
+    }
+    // Point group irrep of each site, taken from the one-electron states
+    // of the site basis
+    vector<int> site_irreps() const {
+        vector<int> orb_sym(mps->n_sites, 0);
+        for (int i = 0; i < mps->n_sites; i++) {
+            const StateInfo<S> &b = *mps->info->basis[i];
+            for (int k = 0; k < b.n; k++)
+                if (b.quanta[k].n() == 1) {
+                    orb_sym[i] = b.quanta[k].pg();
+                    break;
+                }
+        }
+        return orb_sym;
+    }
+    // Givens gates only act between neighbouring sites of the same irrep
+    // (other gates would break the MPS symmetry), so the rotation must not
+    // couple different irreps, and coupled sites of the same irrep must be
+    // contiguous in the site order
+    static void check_rotation(const vector<FP> &rot,
+                               const vector<int> &orb_sym,
+                               FP thrd = (FP)1E-12) {
+        const int n = (int)orb_sym.size();
+        assert((int)rot.size() == n * n);
+        for (int i = 0; i < n; i++)
+            for (int k = i + 1; k < n; k++) {
+                if (abs(rot[i * n + k]) < thrd && abs(rot[k * n + i]) < thrd)
+                    continue;
+                if (orb_sym[k] != orb_sym[i])
+                    throw runtime_error("OrbitalRotation: rotation couples "
+                                        "orbitals of different irreps!");
+                for (int j = i + 1; j < k; j++)
+                    if (orb_sym[j] != orb_sym[i])
+                        throw runtime_error(
+                            "OrbitalRotation: rotated orbitals of the same "
+                            "irrep must be contiguous in the site order!");
+            }
+    }
+    static bool is_coupled(S a, S b, S c) {
+        S ab = a + b;
+        for (int k = 0; k < ab.count(); k++)
+            if (ab[k] == c)
+                return true;
+        return false;
+    }
+    // Coupled two-site states (site a index, site b index, coupled quantum)
+    static vector<pair<pair<int, int>, S>>
+    two_site_states(const StateInfo<S> &a, const StateInfo<S> &b) {
+        vector<pair<pair<int, int>, S>> tss;
+        for (int ia = 0; ia < a.n; ia++)
+            for (int ib = 0; ib < b.n; ib++) {
+                S q = a.quanta[ia] + b.quanta[ib];
+                for (int k = 0; k < q.count(); k++)
+                    tss.push_back(make_pair(make_pair(ia, ib), q[k]));
+            }
+        return tss;
+    }
+    // Matrix of E_{ab} - E_{ba} in the coupled two-site basis (row-major)
+    vector<FP> generator(const StateInfo<S> &a, const StateInfo<S> &b,
+                         const vector<pair<pair<int, int>, S>> &tss) const {
+        typedef GivensSiteOperators<S> SO;
+        const int nt = (int)tss.size();
+        const S vacuum = a.quanta[0] - a.quanta[0];
+        vector<FP> e(nt * nt, 0), k(nt * nt);
+        for (int ix = 0; ix < nt; ix++)
+            for (int jx = 0; jx < nt; jx++) {
+                if (tss[ix].second != tss[jx].second)
+                    continue;
+                const S aq = a.quanta[tss[ix].first.first],
+                        bq = b.quanta[tss[ix].first.second];
+                const S aqp = a.quanta[tss[jx].first.first],
+                        bqp = b.quanta[tss[jx].first.second];
+                const S cq = tss[ix].second, cqp = tss[jx].second;
+                for (int s = 0; s < SO::n_spins(); s++) {
+                    FP x = (FP)SO::element(true, s, aq, aqp) *
+                           (FP)SO::element(false, s, bq, bqp);
+                    if (x == (FP)0.0)
+                        continue;
+                    x *= (FP)(sqrt(cqp.multiplicity() * aq.multiplicity() *
+                                   bq.multiplicity()) *
+                              cg->wigner_9j(aqp, bqp, cqp,
+                                            SO::delta_quantum(true, s),
+                                            SO::delta_quantum(false, s),
+                                            vacuum, aq, bq, cq));
+                    e[ix * nt + jx] += aqp.is_fermion() ? -x : x;
+                }
+            }
+        // normalization from the one-particle sector: E_{ab} |0 1> = |1 0>
+        FP norm = 0;
+        for (int ix = 0; ix < nt && norm == (FP)0.0; ix++)
+            for (int jx = 0; jx < nt && norm == (FP)0.0; jx++) {
+                const S aq = a.quanta[tss[ix].first.first],
+                        bq = b.quanta[tss[ix].first.second];
+                const S aqp = a.quanta[tss[jx].first.first],
+                        bqp = b.quanta[tss[jx].first.second];
+                if (aq.n() == 1 && bq.n() == 0 && aqp.n() == 0 &&
+                    bqp.n() == 1 && aq.twos() == bqp.twos() &&
+                    abs(e[ix * nt + jx]) > (FP)TINY)
+                    norm = (FP)1.0 / e[ix * nt + jx];
+            }
+        if (norm == (FP)0.0)
+            throw runtime_error(
+                "OrbitalRotation::generator: invalid site basis!");
+        for (int ix = 0; ix < nt; ix++)
+            for (int jx = 0; jx < nt; jx++)
+                k[ix * nt + jx] = norm * (e[ix * nt + jx] - e[jx * nt + ix]);
+        return k;
+    }
+    // Product of gates (in the order of application) in the coupled
+    // two-site basis (row-major)
+    vector<FP> local_gate(const StateInfo<S> &a, const StateInfo<S> &b,
+                          const vector<pair<pair<int, int>, S>> &tss,
+                          const vector<GivensGate> &gates) const {
+        const int nt = (int)tss.size();
+        vector<FP> r(nt * nt, 0), g(nt * nt), x(nt * nt), k;
+        for (int ix = 0; ix < nt; ix++)
+            r[ix * nt + ix] = 1;
+        for (auto &gt : gates) {
+            memset(g.data(), 0, sizeof(FP) * nt * nt);
+            if (gt.theta != (FP)0.0) {
+                if (k.size() == 0)
+                    k = generator(a, b, tss);
+                const int ideg = 6;
+                vector<FP> work(4 * nt * nt + ideg + 1);
+                pair<MKL_INT, MKL_INT> pp =
+                    IterativeMatrixFunctions<FP>::expo_pade(
+                        ideg, nt, k.data(), nt, gt.theta, work.data());
+                memcpy(g.data(), work.data() + pp.first,
+                       sizeof(FP) * nt * nt);
+            } else
+                for (int ix = 0; ix < nt; ix++)
+                    g[ix * nt + ix] = 1;
+            for (int ix = 0; ix < nt; ix++)
+                if ((gt.flip[0] && (a.quanta[tss[ix].first.first].n() & 1)) ^
+                    (gt.flip[1] && (b.quanta[tss[ix].first.second].n() & 1)))
+                    for (int jx = 0; jx < nt; jx++)
+                        g[ix * nt + jx] = -g[ix * nt + jx];
+            for (int ix = 0; ix < nt; ix++)
+                for (int jx = 0; jx < nt; jx++) {
+                    x[ix * nt + jx] = 0;
+                    for (int kx = 0; kx < nt; kx++)
+                        x[ix * nt + jx] += g[ix * nt + kx] * r[kx * nt + jx];
+                }
+            r.swap(x);
+        }
+        return r;
+    }
+    // Apply gates (in the order of application) to the two-site wavefunction
+    // at sites (i, i + 1) with full (non-reduced) SparseMatrixInfo
+    void apply_gates(int i, const shared_ptr<SparseMatrix<S, FL>> &wfn,
+                     const vector<GivensGate> &gates) const {
+        frame_<FP>()->activate(1);
+        mps->info->load_left_dims(i);
+        mps->info->load_right_dims(i + 2);
+        StateInfo<S> l = *mps->info->left_dims[i], ma = *mps->info->basis[i],
+                     mb = *mps->info->basis[i + 1],
+                     r = *mps->info->right_dims[i + 2];
+        StateInfo<S> ll = StateInfo<S>::tensor_product(
+            l, ma, *mps->info->left_dims_fci[i + 1]);
+        StateInfo<S> rr = StateInfo<S>::tensor_product(
+            mb, r, *mps->info->right_dims_fci[i + 1]);
+        shared_ptr<typename StateInfo<S>::ConnectionInfo> llc =
+            StateInfo<S>::get_connection_info(l, ma, ll);
+        shared_ptr<typename StateInfo<S>::ConnectionInfo> rrc =
+            StateInfo<S>::get_connection_info(mb, r, rr);
+        for (int k = 0; k < ma.n; k++)
+            if (ma.n_states[k] != 1)
+                throw runtime_error("OrbitalRotation::apply_gates: site basis "
+                                    "with multiple states per quantum number "
+                                    "is not supported!");
+        for (int k = 0; k < mb.n; k++)
+            if (mb.n_states[k] != 1)
+                throw runtime_error("OrbitalRotation::apply_gates: site basis "
+                                    "with multiple states per quantum number "
+                                    "is not supported!");
+        const vector<pair<pair<int, int>, S>> tss = two_site_states(ma, mb);
+        const vector<FP> gmat = local_gate(ma, mb, tss, gates);
+        const int nt = (int)tss.size();
+        // gin[ia' * mb.n + ib'] -> (ia, ib) with nonzero gate elements
+        vector<vector<pair<int, int>>> gin(ma.n * mb.n);
+        for (int ix = 0; ix < nt; ix++)
+            for (int jx = 0; jx < nt; jx++)
+                if (abs(gmat[ix * nt + jx]) > (FP)TINY) {
+                    vector<pair<int, int>> &v =
+                        gin[tss[ix].first.first * mb.n + tss[ix].first.second];
+                    if (find(v.begin(), v.end(), tss[jx].first) == v.end())
+                        v.push_back(tss[jx].first);
+                }
+        // (l, ma) -> (index in ll, row shift)
+        vector<vector<pair<int, MKL_INT>>> lsub(l.n * ma.n);
+        for (int ib = 0; ib < ll.n; ib++) {
+            MKL_INT p = 0;
+            for (uint32_t kk = llc->acc_n_states[ib];
+                 kk < llc->acc_n_states[ib + 1]; kk++) {
+                const pair<uint32_t, uint32_t> &ij = llc->ij_indices[kk];
+                lsub[ij.first * ma.n + ij.second].push_back(make_pair(ib, p));
+                p += (MKL_INT)l.n_states[ij.first] * ma.n_states[ij.second];
+            }
+        }
+        // (mb, r) -> (index in rr, column shift)
+        vector<vector<pair<int, MKL_INT>>> rsub(mb.n * r.n);
+        for (int ik = 0; ik < rr.n; ik++) {
+            MKL_INT p = 0;
+            for (uint32_t kk = rrc->acc_n_states[ik];
+                 kk < rrc->acc_n_states[ik + 1]; kk++) {
+                const pair<uint32_t, uint32_t> &ij = rrc->ij_indices[kk];
+                rsub[ij.first * r.n + ij.second].push_back(make_pair(ik, p));
+                p += (MKL_INT)mb.n_states[ij.first] * r.n_states[ij.second];
+            }
+        }
+        shared_ptr<SparseMatrixInfo<S>> info = wfn->info;
+        const S dq = info->delta_quantum;
+        vector<int> blk((size_t)ll.n * rr.n, -1);
+        vector<pair<int, int>> blk_lr(info->n);
+        for (int iw = 0; iw < info->n; iw++) {
+            const int ib = ll.find_state(info->quanta[iw].get_bra(dq));
+            const int ik = rr.find_state(-info->quanta[iw].get_ket());
+            assert(ib != -1 && ik != -1);
+            blk[(size_t)ib * rr.n + ik] = iw;
+            blk_lr[iw] = make_pair(ib, ik);
+        }
+        shared_ptr<VectorAllocator<FP>> d_alloc =
+            make_shared<VectorAllocator<FP>>();
+        shared_ptr<SparseMatrix<S, FL>> xwfn =
+            make_shared<SparseMatrix<S, FL>>(d_alloc);
+        xwfn->allocate(info);
+        xwfn->clear();
+        // recoupling coefficient of the two-site gate
+        auto coeff = [&](S ql, S qr, int iap, int ibp, S qlap, S qbrp, int ia,
+                         int ib, S qla, S qbr) -> FP {
+            const S qap = ma.quanta[iap], qbp = mb.quanta[ibp];
+            const S qa = ma.quanta[ia], qb = mb.quanta[ib];
+            FP x = 0;
+            S qlabs = qla + qb;
+            for (int k = 0; k < qlabs.count(); k++) {
+                const S qlab = qlabs[k];
+                if (!is_coupled(qlap, qbp, qlab) || !is_coupled(qlab, qr, dq))
+                    continue;
+                const FP ra =
+                    (FP)(cg->racah(qla, qb, dq, qr, qlab, qbr) *
+                         sqrt(qlab.multiplicity() * qbr.multiplicity()));
+                const FP rap =
+                    (FP)(cg->racah(qlap, qbp, dq, qr, qlab, qbrp) *
+                         sqrt(qlab.multiplicity() * qbrp.multiplicity()));
+                for (int ix = 0; ix < nt; ix++) {
+                    if (tss[ix].first != make_pair(iap, ibp) ||
+                        !is_coupled(ql, tss[ix].second, qlab))
+                        continue;
+                    const S qab = tss[ix].second;
+                    for (int jx = 0; jx < nt; jx++) {
+                        if (tss[jx].first != make_pair(ia, ib) ||
+                            tss[jx].second != qab ||
+                            gmat[ix * nt + jx] == (FP)0.0)
+                            continue;
+                        const FP rb =
+                            (FP)(cg->racah(ql, qa, qlab, qb, qla, qab) *
+                                 sqrt(qla.multiplicity() * qab.multiplicity()));
+                        const FP rbp = (FP)(
+                            cg->racah(ql, qap, qlab, qbp, qlap, qab) *
+                            sqrt(qlap.multiplicity() * qab.multiplicity()));
+                        x += rap * rbp * gmat[ix * nt + jx] * rb * ra;
+                    }
+                }
+            }
+            return x;
+        };
+        int ntg = threading->activate_global();
+#pragma omp parallel for schedule(dynamic) num_threads(ntg)
+        for (int iw = 0; iw < info->n; iw++) {
+            const int ibx = blk_lr[iw].first, ikx = blk_lr[iw].second;
+            GMatrix<FL> xmat = (*xwfn)[iw];
+            MKL_INT pl = 0;
+            for (uint32_t kb = llc->acc_n_states[ibx];
+                 kb < llc->acc_n_states[ibx + 1]; kb++) {
+                const int il = llc->ij_indices[kb].first,
+                          iap = llc->ij_indices[kb].second;
+                const MKL_INT nl = l.n_states[il];
+                MKL_INT pr = 0;
+                for (uint32_t kk = rrc->acc_n_states[ikx];
+                     kk < rrc->acc_n_states[ikx + 1]; kk++) {
+                    const int ibp = rrc->ij_indices[kk].first,
+                              ir = rrc->ij_indices[kk].second;
+                    const MKL_INT nr = r.n_states[ir];
+                    for (auto &g : gin[iap * mb.n + ibp])
+                        for (auto &ls : lsub[il * ma.n + g.first])
+                            for (auto &rs : rsub[g.second * r.n + ir]) {
+                                const int jw =
+                                    blk[(size_t)ls.first * rr.n + rs.first];
+                                if (jw == -1)
+                                    continue;
+                                const FP f = coeff(
+                                    l.quanta[il], r.quanta[ir], iap, ibp,
+                                    ll.quanta[ibx], rr.quanta[ikx], g.first,
+                                    g.second, ll.quanta[ls.first],
+                                    rr.quanta[rs.first]);
+                                if (abs(f) < (FP)TINY)
+                                    continue;
+                                GMatrix<FL> wmat = (*wfn)[jw];
+                                for (MKL_INT j = 0; j < nl; j++)
+                                    GMatrixFunctions<FL>::iadd(
+                                        GMatrix<FL>(&xmat(pl + j, pr), nr, 1),
+                                        GMatrix<FL>(
+                                            &wmat(ls.second + j, rs.second),
+                                            nr, 1),
+                                        (FL)f);
+                            }
+                    pr += nr;
+                }
+                pl += nl;
+            }
+        }
+        threading->activate_normal();
+        wfn->copy_data_from(xwfn);
+        xwfn->deallocate();
+        rr.deallocate();
+        ll.deallocate();
+        r.deallocate();
+        l.deallocate();
+        frame_<FP>()->activate(0);
+    }
+    // Two-site wavefunction with full SparseMatrixInfo at sites (i, i + 1)
+    void prepare_two_dot(int i) {
+        if (mps->tensors[i] != nullptr && mps->tensors[i + 1] != nullptr) {
+            MovingEnvironment<S, FL, FL>::contract_two_dot(i, mps, false);
+            return;
+        }
+        mps->load_tensor(i);
+        mps->tensors[i + 1] = nullptr;
+        shared_ptr<SparseMatrix<S, FL>> old_wfn = mps->tensors[i];
+        shared_ptr<SparseMatrixInfo<S>> wfn_info =
+            make_shared<SparseMatrixInfo<S>>();
+        frame_<FP>()->activate(1);
+        mps->info->load_left_dims(i);
+        mps->info->load_right_dims(i + 2);
+        StateInfo<S> l = *mps->info->left_dims[i], ma = *mps->info->basis[i],
+                     mb = *mps->info->basis[i + 1],
+                     r = *mps->info->right_dims[i + 2];
+        StateInfo<S> ll = StateInfo<S>::tensor_product(
+            l, ma, *mps->info->left_dims_fci[i + 1]);
+        StateInfo<S> rr = StateInfo<S>::tensor_product(
+            mb, r, *mps->info->right_dims_fci[i + 1]);
+        frame_<FP>()->activate(0);
+        wfn_info->initialize(ll, rr, mps->info->target, false, true);
+        frame_<FP>()->activate(1);
+        rr.deallocate();
+        ll.deallocate();
+        r.deallocate();
+        l.deallocate();
+        frame_<FP>()->activate(0);
+        shared_ptr<SparseMatrix<S, FL>> wfn =
+            make_shared<SparseMatrix<S, FL>>();
+        wfn->allocate(wfn_info);
+        for (int iw = 0; iw < old_wfn->info->n; iw++) {
+            const int jw = wfn_info->find_state(old_wfn->info->quanta[iw]);
+            assert(jw != -1 &&
+                   wfn_info->n_states_bra[jw] ==
+                       old_wfn->info->n_states_bra[iw] &&
+                   wfn_info->n_states_ket[jw] ==
+                       old_wfn->info->n_states_ket[iw]);
+            memcpy((*wfn)[jw].data, (*old_wfn)[iw].data,
+                   sizeof(FL) * (*old_wfn)[iw].size());
+        }
+        wfn->factor = old_wfn->factor;
+        mps->unload_tensor(i);
+        mps->tensors[i] = wfn;
+    }
+    // Apply gates at sites (i, i + 1), truncate and move canonical center
+    FP update_two_dot(int i, bool forward, const vector<GivensGate> &gates) {
+        frame_<FP>()->activate(0);
+        mps->center = i;
+        prepare_two_dot(i);
+        shared_ptr<SparseMatrix<S, FL>> old_wfn = mps->tensors[i];
+        _t.get_time();
+        if (gates.size() != 0)
+            apply_gates(i, old_wfn, gates);
+        tgate += _t.get_time();
+        shared_ptr<SparseMatrix<S, FL>> dm =
+            MovingEnvironment<S, FL, FL>::density_matrix(
+                mps->info->vacuum, old_wfn, forward, 0.0, NoiseTypes::None);
+        FP error = MovingEnvironment<S, FL, FL>::split_density_matrix(
+            dm, old_wfn, (int)bond_dim, forward, normalize_mps,
+            mps->tensors[i], mps->tensors[i + 1], cutoff, false, wfn_spectra,
+            trunc_type);
+        shared_ptr<StateInfo<S>> info = nullptr;
+        if (forward) {
+            info = mps->tensors[i]->info->extract_state_info(forward);
+            mps->info->left_dims[i + 1] = info;
+            mps->info->save_left_dims(i + 1);
+            mps->canonical_form[i] = 'L';
+            mps->canonical_form[i + 1] = 'C';
+        } else {
+            info = mps->tensors[i + 1]->info->extract_state_info(forward);
+            mps->info->right_dims[i + 1] = info;
+            mps->info->save_right_dims(i + 1);
+            mps->canonical_form[i] = 'C';
+            mps->canonical_form[i + 1] = 'R';
+        }
+        info->deallocate();
+        mps->save_tensor(i + 1);
+        mps->save_tensor(i);
+        mps->unload_tensor(i + 1);
+        mps->unload_tensor(i);
+        dm->info->deallocate();
+        dm->deallocate();
+        old_wfn->info->deallocate();
+        old_wfn->deallocate();
+        MovingEnvironment<S, FL, FL>::propagate_wfn(i, 0, mps->n_sites, mps,
+                                                    forward, cg);
+        mps->save_data();
+        tsplit += _t.get_time();
+        return error;
+    }
+    // Apply orbital rotation rot (row-major, n_sites x n_sites)
+    // Returns the max discarded weight
+    FP solve(const vector<FP> &rot) {
+        const int n_sites = mps->n_sites;
+        if (mps->dot != 2)
+            throw runtime_error(
+                "OrbitalRotation::solve: only two-site MPS is supported!");
+        if (n_sites < 2 || (int)rot.size() != n_sites * n_sites)
+            throw runtime_error(
+                "OrbitalRotation::solve: invalid rotation matrix size!");
+        if (mps->center != 0 && mps->center != n_sites - 2)
+            throw runtime_error("OrbitalRotation::solve: canonical center "
+                                "must be at the first or last bond!");
+        Timer start, current;
+        start.get_time();
+        tgate = tsplit = 0;
+        check_rotation(rot, site_irreps());
+        vector<GivensGate> gates = givens_decompose(rot, n_sites);
+        // only the last earlier gate on each overlapping bond is a dependency
+        vector<int> last(n_sites - 1, -1);
+        vector<vector<int>> deps(gates.size());
+        vector<vector<int>> queues(n_sites - 1);
+        for (int ig = 0; ig < (int)gates.size(); ig++) {
+            const int ib = gates[ig].bond;
+            for (int jb = max(ib - 1, 0); jb <= min(ib + 1, n_sites - 2); jb++)
+                if (last[jb] != -1)
+                    deps[ig].push_back(last[jb]);
+            last[ib] = ig;
+            queues[ib].push_back(ig);
+        }
+        vector<size_t> qheads(n_sites - 1, 0);
+        vector<uint8_t> applied(gates.size(), 0);
+        size_t n_applied = 0;
+        bool forward = mps->center == 0;
+        FP max_error = 0;
+        discarded_weights.clear();
+        if (iprint >= 1)
+            cout << endl
+                 << "Orbital Rotation | Ngates = " << setw(8) << gates.size()
+                 << " | Bond dimension = " << setw(4) << (uint32_t)bond_dim
+                 << endl;
+        for (int isw = 0; n_applied < gates.size(); isw++) {
+            vector<int> sweep_range;
+            if (forward)
+                for (int it = mps->center; it < n_sites - 1; it++)
+                    sweep_range.push_back(it);
+            else
+                for (int it = mps->center; it >= 0; it--)
+                    sweep_range.push_back(it);
+            FP sweep_error = 0;
+            size_t sweep_n_gates = 0;
+            Timer t;
+            for (auto i : sweep_range) {
+                check_signal_()();
+                vector<GivensGate> xgates;
+                for (; qheads[i] < queues[i].size(); qheads[i]++) {
+                    const int ig = queues[i][qheads[i]];
+                    bool ready = true;
+                    for (auto &jg : deps[ig])
+                        ready = ready && applied[jg];
+                    if (!ready)
+                        break;
+                    applied[ig] = 1;
+                    xgates.push_back(gates[ig]);
+                }
+                n_applied += xgates.size();
+                sweep_n_gates += xgates.size();
+                if (iprint >= 2) {
+                    cout << " " << (forward ? "-->" : "<--")
+                         << " Site = " << setw(4) << i << "-" << setw(4)
+                         << i + 1 << " .. ";
+                    cout.flush();
+                }
+                t.get_time();
+                FP error = update_two_dot(i, forward, xgates);
+                sweep_error = max(sweep_error, error);
+                if (iprint >= 2)
+                    cout << "Ngates = " << setw(4) << xgates.size()
+                         << " Error = " << scientific << setw(8)
+                         << setprecision(2) << error << " T = " << fixed
+                         << setw(4) << setprecision(2) << t.get_time()
+                         << endl;
+            }
+            discarded_weights.push_back(sweep_error);
+            max_error = max(max_error, sweep_error);
+            forward = !forward;
+            current.get_time();
+            if (iprint >= 1)
+                cout << "Sweep = " << setw(4) << isw
+                     << " | Direction = " << setw(8)
+                     << (!forward ? "forward" : "backward")
+                     << " | Ngates = " << setw(6) << sweep_n_gates
+                     << " | DW = " << scientific << setw(8) << setprecision(2)
+                     << sweep_error << " | Time = " << fixed << setw(10)
+                     << setprecision(3) << current.current - start.current
+                     << endl;
+        }
+        if (mps->info->bond_dim < bond_dim)
+            mps->info->bond_dim = bond_dim;
+        if (iprint >= 1)
+            cout << "Time gate = " << fixed << setw(10) << setprecision(3)
+                 << tgate << " | Time split = " << setw(10) << tsplit << endl;
+        return max_error;
+    }
+};
+
+} // namespace block2
@@ -79,6 +79,12 @@ template <typename S, typename FL> struct Partition {
         }
     }
     void load_data(bool left_part, const string &filename) {
+        if (frame_<FP>()->partition_container != nullptr) {
+            frame_<FP>()->partition_container->read(
+                filename,
+                [this, left_part](istream &ifs) { load_data(ifs, left_part); });
+            return;
+        }
         ifstream ifs(filename.c_str(), ios::binary);
         if (!ifs.good())
             throw runtime_error("Partition:load_data on '" + filename +
@@ -107,6 +113,12 @@ template <typename S, typename FL> struct Partition {
     void save_data(bool left_part, const string &filename) const {
         if (!frame_<FP>()->partition_can_write)
             return;
+        if (frame_<FP>()->partition_container != nullptr) {
+            stringstream ss;
+            save_data(ss, left_part);
+            frame_<FP>()->partition_container->write(filename, ss.str());
+            return;
+        }
         ofstream ofs(filename.c_str(), ios::binary);
         if (!ofs.good())
             throw runtime_error("Partition:save_data on '" + filename +
@@ -618,6 +618,12 @@ struct HamiltonianQC<S, FL, typename S::is_sz_t> : Hamiltonian<S, FL> {
          uint16_t l) const {
         return fcidump->v(sl, sr, i, j, k, l);
     }
+    // r[a * len + b] = v(sl, sr, idx), idx[pa] = start + a, idx[pb] = start + b
+    void v_tile(uint8_t sl, uint8_t sr, const array<uint16_t, 4> &idx,
+                uint8_t pa, uint8_t pb, uint16_t start, uint16_t len,
+                FL *r) const {
+        fcidump->v_tile(sl, sr, idx, pa, pb, start, len, r);
+    }
     FL t(uint8_t s, uint16_t i, uint16_t j) const {
         return i == j ? fcidump->t(s, i, i) - mu : fcidump->t(s, i, j);
     }
@@ -1048,6 +1054,11 @@ struct HamiltonianQC<S, FL, typename S::is_su2_t> : Hamiltonian<S, FL> {
     FL v(uint16_t i, uint16_t j, uint16_t k, uint16_t l) const {
         return fcidump->v(i, j, k, l);
     }
+    // r[a * len + b] = v(idx), idx[pa] = start + a, idx[pb] = start + b
+    void v_tile(const array<uint16_t, 4> &idx, uint8_t pa, uint8_t pb,
+                uint16_t start, uint16_t len, FL *r) const {
+        fcidump->v_tile(idx, pa, pb, start, len, r);
+    }
     FL t(uint16_t i, uint16_t j) const {
         return i == j ? fcidump->t(i, i) - mu : fcidump->t(i, j);
     }
@@ -1003,10 +1003,23 @@ struct MPOQC<S, FL, typename S::is_sz_t> : MPO<S, FL> {
                         p += m + 1;
                     }
                     // RD
+                    vector<FL> vx[2], vy[2], vz[2];
+                    for (uint8_t sp = 0; sp < 2; sp++)
+                        vx[sp].resize((size_t)m * m),
+                            vy[sp].resize((size_t)m * m),
+                            vz[sp].resize((size_t)m * m);
                     for (uint8_t s = 0; s < 2; s++) {
                         for (uint16_t i = m + 1; i < n_orbs; i++) {
                             mat[{prd[s] + i, p + i - (m + 1)}] = i_op;
                             mat[{pi, p + i - (m + 1)}] = rd_op[i][s];
+                            for (uint8_t sp = 0; sp < 2; sp++) {
+                                hamil->v_tile(s, sp, {0, i, 0, m}, 0, 2, 0, m,
+                                              vx[sp].data());
+                                hamil->v_tile(s, sp, {m, i, 0, 0}, 2, 3, 0, m,
+                                              vy[sp].data());
+                                hamil->v_tile(s, sp, {0, i, m, 0}, 0, 3, 0, m,
+                                              vz[sp].data());
+                            }
                             for (uint8_t sp = 0; sp < 2; sp++)
                                 for (uint16_t k = 0; k < m; k++) {
                                     mat[{pd[sp] + k, p + i - (m + 1)}] =
@@ -1018,7 +1031,7 @@ struct MPOQC<S, FL, typename S::is_sz_t> : MPO<S, FL> {
                                 for (uint8_t sp = 0; sp < 2; sp++)
                                     for (uint16_t j = 0; j < m; j++)
                                         for (uint16_t l = 0; l < m; l++) {
-                                            FL f = hamil->v(s, sp, j, i, l, m);
+                                            FL f = vx[sp][j * m + l];
                                             mat[{pa[s | (sp << 1)] + j * m + l,
                                                  p + i - (m + 1)}] =
                                                 f * d_op[m][sp];
@@ -1027,10 +1040,8 @@ struct MPOQC<S, FL, typename S::is_sz_t> : MPO<S, FL> {
                                 for (uint8_t sp = 0; sp < 2; sp++)
                                     for (uint16_t j = 0; j < m; j++)
                                         for (uint16_t l = 0; l < m; l++) {
-                                            FL f0 = (FL)0.5 *
-                                                    hamil->v(s, sp, j, i, l, m),
-                                               f1 = (FL)-0.5 *
-                                                    hamil->v(s, sp, l, i, j, m);
+                                            FL f0 = (FL)0.5 * vx[sp][j * m + l],
+                                               f1 = (FL)-0.5 * vx[sp][l * m + j];
                                             mat[{pa[s | (sp << 1)] + j * m + l,
                                                  p + i - (m + 1)}] +=
                                                 f0 * d_op[m][sp];
@@ -1041,15 +1052,14 @@ struct MPOQC<S, FL, typename S::is_sz_t> : MPO<S, FL> {
                             for (uint8_t sp = 0; sp < 2; sp++)
                                 for (uint16_t k = 0; k < m; k++)
                                     for (uint16_t l = 0; l < m; l++) {
-                                        FL f = hamil->v(s, sp, m, i, l, k);
+                                        FL f = vy[sp][l * m + k];
                                         mat[{pb[sp | (sp << 1)] + l * m + k,
                                              p + i - (m + 1)}] = f * c_op[m][s];
                                     }
                             for (uint8_t sp = 0; sp < 2; sp++)
                                 for (uint16_t j = 0; j < m; j++)
                                     for (uint16_t k = 0; k < m; k++) {
-                                        FL f = (FL)-1.0 *
-                                               hamil->v(s, sp, j, i, m, k);
+                                        FL f = (FL)-1.0 * vz[sp][j * m + k];
                                         mat[{pb[s | (sp << 1)] + j * m + k,
                                              p + i - (m + 1)}] +=
                                             f * c_op[m][sp];
@@ -1062,6 +1072,14 @@ struct MPOQC<S, FL, typename S::is_sz_t> : MPO<S, FL> {
                         for (uint16_t i = m + 1; i < n_orbs; i++) {
                             mat[{pr[s] + i, p + i - (m + 1)}] = i_op;
                             mat[{pi, p + i - (m + 1)}] = mr_op[i][s];
+                            for (uint8_t sp = 0; sp < 2; sp++) {
+                                hamil->v_tile(s, sp, {i, 0, m, 0}, 1, 3, 0, m,
+                                              vx[sp].data());
+                                hamil->v_tile(s, sp, {i, m, 0, 0}, 2, 3, 0, m,
+                                              vy[sp].data());
+                                hamil->v_tile(s, sp, {i, 0, 0, m}, 1, 2, 0, m,
+                                              vz[sp].data());
+                            }
                             for (uint8_t sp = 0; sp < 2; sp++)
                                 for (uint16_t k = 0; k < m; k++) {
                                     mat[{pc[sp] + k, p + i - (m + 1)}] =
@@ -1073,8 +1091,7 @@ struct MPOQC<S, FL, typename S::is_sz_t> : MPO<S, FL> {
                                 for (uint8_t sp = 0; sp < 2; sp++)
                                     for (uint16_t j = 0; j < m; j++)
                                         for (uint16_t l = 0; l < m; l++) {
-                                            FL f = (FL)-1.0 *
-                                                   hamil->v(s, sp, i, j, m, l);
+                                            FL f = (FL)-1.0 * vx[sp][j * m + l];
                                             mat[{pad[s | (sp << 1)] + j * m + l,
                                                  p + i - (m + 1)}] =
                                                 f * c_op[m][sp];
@@ -1083,10 +1100,9 @@ struct MPOQC<S, FL, typename S::is_sz_t> : MPO<S, FL> {
                                 for (uint8_t sp = 0; sp < 2; sp++)
                                     for (uint16_t j = 0; j < m; j++)
                                         for (uint16_t l = 0; l < m; l++) {
-                                            FL f0 = (FL)-0.5 *
-                                                    hamil->v(s, sp, i, j, m, l),
-                                               f1 = (FL)0.5 *
-                                                    hamil->v(s, sp, i, l, m, j);
+                                            FL f0 =
+                                                   (FL)-0.5 * vx[sp][j * m + l],
+                                               f1 = (FL)0.5 * vx[sp][l * m + j];
                                             mat[{pad[s | (sp << 1)] + j * m + l,
                                                  p + i - (m + 1)}] +=
                                                 f0 * c_op[m][sp];
@@ -1097,8 +1113,7 @@ struct MPOQC<S, FL, typename S::is_sz_t> : MPO<S, FL> {
                             for (uint8_t sp = 0; sp < 2; sp++)
                                 for (uint16_t k = 0; k < m; k++)
                                     for (uint16_t l = 0; l < m; l++) {
-                                        FL f = (FL)-1.0 *
-                                               hamil->v(s, sp, i, m, k, l);
+                                        FL f = (FL)-1.0 * vy[sp][k * m + l];
                                         mat[{pb[sp | (sp << 1)] + k * m + l,
                                              p + i - (m + 1)}] = f * d_op[m][s];
                                     }
@@ -1106,7 +1121,7 @@ struct MPOQC<S, FL, typename S::is_sz_t> : MPO<S, FL> {
                                 for (uint16_t j = 0; j < m; j++)
                                     for (uint16_t k = 0; k < m; k++) {
                                         FL f = (FL)(-1.0) * (FL)(-1.0) *
-                                               hamil->v(s, sp, i, j, k, m);
+                                               vz[sp][j * m + k];
                                         mat[{pb[sp | (s << 1)] + k * m + j,
                                              p + i - (m + 1)}] =
                                             f * d_op[m][sp];
@@ -1255,16 +1270,30 @@ struct MPOQC<S, FL, typename S::is_sz_t> : MPO<S, FL> {
                                  2 + n_orbs * 4 + mm * mm * 10,
                                  2 + n_orbs * 4 + mm * mm * 11};
                     // R
+                    vector<FL> vx[2], vy[2], vz[2];
+                    for (uint8_t sp = 0; sp < 2; sp++)
+                        vx[sp].resize((size_t)mm * mm),
+                            vy[sp].resize((size_t)mm * mm),
+                            vz[sp].resize((size_t)mm * mm);
                     for (uint8_t s = 0; s < 2; s++) {
                         for (uint16_t i = 0; i < m; i++) {
                             mat[{p + i, pi}] = r_op[i][s];
                             mat[{p + i, pr[s] + i}] = i_op;
+                            for (uint8_t sp = 0; sp < 2; sp++) {
+                                hamil->v_tile(s, sp, {i, 0, m, 0}, 1, 3, m + 1,
+                                              mm, vx[sp].data());
+                                hamil->v_tile(s, sp, {i, m, 0, 0}, 2, 3, m + 1,
+                                              mm, vy[sp].data());
+                                hamil->v_tile(s, sp, {i, 0, 0, m}, 1, 2, m + 1,
+                                              mm, vz[sp].data());
+                            }
                             if (!symmetrized_p)
                                 for (uint8_t sp = 0; sp < 2; sp++)
                                     for (uint16_t j = m + 1; j < n_orbs; j++)
                                         for (uint16_t l = m + 1; l < n_orbs;
                                              l++) {
-                                            FL f = hamil->v(s, sp, i, j, m, l);
+                                            FL f = vx[sp][(j - m - 1) * mm + l -
+                                                          m - 1];
                                             mat[{p + i, pad[s | (sp << 1)] +
                                                             (j - m - 1) * mm +
                                                             l - m - 1}] =
@@ -1276,9 +1305,11 @@ struct MPOQC<S, FL, typename S::is_sz_t> : MPO<S, FL> {
                                         for (uint16_t l = m + 1; l < n_orbs;
                                              l++) {
                                             FL f0 = (FL)0.5 *
-                                                    hamil->v(s, sp, i, j, m, l);
+                                                    vx[sp][(j - m - 1) * mm +
+                                                           l - m - 1];
                                             FL f1 = (FL)-0.5 *
-                                                    hamil->v(s, sp, i, l, m, j);
+                                                    vx[sp][(l - m - 1) * mm +
+                                                           j - m - 1];
                                             mat[{p + i, pad[s | (sp << 1)] +
                                                             (j - m - 1) * mm +
                                                             l - m - 1}] +=
@@ -1291,7 +1322,8 @@ struct MPOQC<S, FL, typename S::is_sz_t> : MPO<S, FL> {
                             for (uint8_t sp = 0; sp < 2; sp++)
                                 for (uint16_t k = m + 1; k < n_orbs; k++)
                                     for (uint16_t l = m + 1; l < n_orbs; l++) {
-                                        FL f = hamil->v(s, sp, i, m, k, l);
+                                        FL f = vy[sp][(k - m - 1) * mm + l -
+                                                      m - 1];
                                         mat[{p + i, pb[sp | (sp << 1)] +
                                                         (k - m - 1) * mm + l -
                                                         m - 1}] =
@@ -1301,7 +1333,8 @@ struct MPOQC<S, FL, typename S::is_sz_t> : MPO<S, FL> {
                                 for (uint16_t j = m + 1; j < n_orbs; j++)
                                     for (uint16_t k = m + 1; k < n_orbs; k++) {
                                         FL f = (FL)(-1.0) *
-                                               hamil->v(s, sp, i, j, k, m);
+                                               vz[sp][(j - m - 1) * mm + k -
+                                                      m - 1];
                                         mat[{p + i, pb[sp | (s << 1)] +
                                                         (k - m - 1) * mm + j -
                                                         m - 1}] =
@@ -1322,13 +1355,22 @@ struct MPOQC<S, FL, typename S::is_sz_t> : MPO<S, FL> {
                         for (uint16_t i = 0; i < m; i++) {
                             mat[{p + i, pi}] = mrd_op[i][s];
                             mat[{p + i, prd[s] + i}] = i_op;
+                            for (uint8_t sp = 0; sp < 2; sp++) {
+                                hamil->v_tile(s, sp, {0, i, 0, m}, 0, 2, m + 1,
+                                              mm, vx[sp].data());
+                                hamil->v_tile(s, sp, {m, i, 0, 0}, 2, 3, m + 1,
+                                              mm, vy[sp].data());
+                                hamil->v_tile(s, sp, {0, i, m, 0}, 0, 3, m + 1,
+                                              mm, vz[sp].data());
+                            }
                             if (!symmetrized_p)
                                 for (uint8_t sp = 0; sp < 2; sp++)
                                     for (uint16_t j = m + 1; j < n_orbs; j++)
                                         for (uint16_t l = m + 1; l < n_orbs;
                                              l++) {
                                             FL f = (FL)-1.0 *
-                                                   hamil->v(s, sp, j, i, l, m);
+                                                   vx[sp][(j - m - 1) * mm + l -
+                                                          m - 1];
                                             mat[{p + i, pa[s | (sp << 1)] +
                                                             (j - m - 1) * mm +
                                                             l - m - 1}] =
@@ -1340,9 +1382,11 @@ struct MPOQC<S, FL, typename S::is_sz_t> : MPO<S, FL> {
                                         for (uint16_t l = m + 1; l < n_orbs;
                                              l++) {
                                             FL f0 = (FL)-0.5 *
-                                                    hamil->v(s, sp, j, i, l, m);
+                                                    vx[sp][(j - m - 1) * mm +
+                                                           l - m - 1];
                                             FL f1 = (FL)0.5 *
-                                                    hamil->v(s, sp, l, i, j, m);
+                                                    vx[sp][(l - m - 1) * mm +
+                                                           j - m - 1];
                                             mat[{p + i, pa[s | (sp << 1)] +
                                                             (j - m - 1) * mm +
                                                             l - m - 1}] +=
@@ -1356,7 +1400,8 @@ struct MPOQC<S, FL, typename S::is_sz_t> : MPO<S, FL> {
                                 for (uint16_t k = m + 1; k < n_orbs; k++)
                                     for (uint16_t l = m + 1; l < n_orbs; l++) {
                                         FL f = (FL)-1.0 *
-                                               hamil->v(s, sp, m, i, l, k);
+                                               vy[sp][(l - m - 1) * mm + k -
+                                                      m - 1];
                                         mat[{p + i, pb[sp | (sp << 1)] +
                                                         (l - m - 1) * mm + k -
                                                         m - 1}] =
@@ -1365,7 +1410,8 @@ struct MPOQC<S, FL, typename S::is_sz_t> : MPO<S, FL> {
                             for (uint8_t sp = 0; sp < 2; sp++)
                                 for (uint16_t j = m + 1; j < n_orbs; j++)
                                     for (uint16_t k = m + 1; k < n_orbs; k++) {
-                                        FL f = hamil->v(s, sp, j, i, m, k);
+                                        FL f = vz[sp][(j - m - 1) * mm + k -
+                                                      m - 1];
                                         mat[{p + i, pb[s | (sp << 1)] +
                                                         (j - m - 1) * mm + k -
                                                         m - 1}] =
@@ -1714,18 +1760,28 @@ struct MPOQC<S, FL, typename S::is_sz_t> : MPO<S, FL> {
                 for (uint16_t j = m + 1; j < n_orbs; j++) {
 #endif
                 vector<shared_ptr<OpExpr<S>>> exprs;
+                const uint16_t g0 = 0, nt = m + 1;
+                vector<FL> vg((size_t)nt * nt), vh((size_t)nt * nt), vk[2];
+                vk[0].resize((size_t)nt * nt), vk[1].resize((size_t)nt * nt);
                 exprs.reserve((m + 1) * (m + 1));
                 for (uint16_t k = m + 1; k < n_orbs; k++) {
                     int p = (k - m - 1) + (j - m - 1) * (n_orbs - m - 1) +
                             s * (n_orbs - m - 1) * (n_orbs - m - 1);
                     exprs.clear();
                     p += 2 + 4 * n_orbs;
+                    hamil->v_tile(s & 1, s >> 1, {j, 0, k, 0}, 1, 3, g0, nt,
+                                  vg.data());
+                    hamil->v_tile(s & 1, s >> 1, {j, 0, 0, k}, 2, 1, g0, nt,
+                                  vh.data());
+                    if ((s & 1) == (s >> 1))
+                        for (uint8_t sp = 0; sp < 2; sp++)
+                            hamil->v_tile(s & 1, sp, {j, k, 0, 0}, 2, 3, g0,
+                                          nt, vk[sp].data());
                     for (uint16_t g = 0; g < m + 1; g++)
                         for (uint16_t h = 0; h < m + 1; h++)
-                            if (abs(hamil->v(s & 1, s >> 1, j, g, k, h)) > TINY)
+                            if (abs(vg[(g - g0) * nt + h - g0]) > TINY)
                                 exprs.push_back(
-                                    ((FL)0.5 *
-                                     hamil->v(s & 1, s >> 1, j, g, k, h)) *
+                                    ((FL)0.5 * vg[(g - g0) * nt + h - g0]) *
                                     ad_op[g][h][s]);
                     lop[p] = (FL)0.5 * p_op[j][k][s];
                     lexpr[p] = sum(exprs);
@@ -1733,10 +1789,9 @@ struct MPOQC<S, FL, typename S::is_sz_t> : MPO<S, FL> {
                     p += 4 * (n_orbs - m - 1) * (n_orbs - m - 1);
                     for (uint16_t g = 0; g < m + 1; g++)
                         for (uint16_t h = 0; h < m + 1; h++)
-                            if (abs(hamil->v(s & 1, s >> 1, j, g, k, h)) > TINY)
+                            if (abs(vg[(g - g0) * nt + h - g0]) > TINY)
                                 exprs.push_back(
-                                    ((FL)0.5 *
-                                     hamil->v(s & 1, s >> 1, j, g, k, h)) *
+                                    ((FL)0.5 * vg[(g - g0) * nt + h - g0]) *
                                     a_op[g][h][s]);
                     lop[p] = (FL)0.5 * pd_op[j][k][s];
                     lexpr[p] = sum(exprs);
@@ -1744,16 +1799,16 @@ struct MPOQC<S, FL, typename S::is_sz_t> : MPO<S, FL> {
                     p += 4 * (n_orbs - m - 1) * (n_orbs - m - 1);
                     for (uint16_t g = 0; g < m + 1; g++)
                         for (uint16_t h = 0; h < m + 1; h++) {
-                            if (abs(hamil->v(s & 1, s >> 1, j, h, g, k)) > TINY)
+                            const size_t gh = (size_t)(g - g0) * nt + h - g0;
+                            if (abs(vh[gh]) > TINY)
                                 exprs.push_back(
-                                    -hamil->v(s & 1, s >> 1, j, h, g, k) *
+                                    -vh[gh] *
                                     b_op[g][h][((s & 1) << 1) | (s >> 1)]);
                             if ((s & 1) == (s >> 1))
                                 for (uint8_t sp = 0; sp < 2; sp++)
-                                    if (abs(hamil->v(s & 1, sp, j, k, g, h)) >
-                                        TINY)
+                                    if (abs(vk[sp][gh]) > TINY)
                                         exprs.push_back(
-                                            hamil->v(s & 1, sp, j, k, g, h) *
+                                            vk[sp][gh] *
                                             b_op[g][h][(sp << 1) | sp]);
                         }
                     lop[p] = q_op[j][k][s];
@@ -1789,17 +1844,27 @@ struct MPOQC<S, FL, typename S::is_sz_t> : MPO<S, FL> {
                 for (uint16_t j = 0; j < m + 1; j++) {
 #endif
                 vector<shared_ptr<OpExpr<S>>> exprs;
+                const uint16_t g0 = m + 1, nt = n_orbs - m - 1;
+                vector<FL> vg((size_t)nt * nt), vh((size_t)nt * nt), vk[2];
+                vk[0].resize((size_t)nt * nt), vk[1].resize((size_t)nt * nt);
                 exprs.reserve((n_orbs - m - 1) * (n_orbs - m - 1));
                 for (uint16_t k = 0; k < m + 1; k++) {
                     int p = k + j * (m + 1) + s * (m + 1) * (m + 1);
                     exprs.clear();
                     p += 2 + 4 * n_orbs;
+                    hamil->v_tile(s & 1, s >> 1, {j, 0, k, 0}, 1, 3, g0, nt,
+                                  vg.data());
+                    hamil->v_tile(s & 1, s >> 1, {j, 0, 0, k}, 2, 1, g0, nt,
+                                  vh.data());
+                    if ((s & 1) == (s >> 1))
+                        for (uint8_t sp = 0; sp < 2; sp++)
+                            hamil->v_tile(s & 1, sp, {j, k, 0, 0}, 2, 3, g0,
+                                          nt, vk[sp].data());
                     for (uint16_t g = m + 1; g < n_orbs; g++)
                         for (uint16_t h = m + 1; h < n_orbs; h++)
-                            if (abs(hamil->v(s & 1, s >> 1, j, g, k, h)) > TINY)
+                            if (abs(vg[(g - g0) * nt + h - g0]) > TINY)
                                 exprs.push_back(
-                                    ((FL)0.5 *
-                                     hamil->v(s & 1, s >> 1, j, g, k, h)) *
+                                    ((FL)0.5 * vg[(g - g0) * nt + h - g0]) *
                                     ad_op[g][h][s]);
                     rop[p] = (FL)0.5 * p_op[j][k][s];
                     rexpr[p] = sum(exprs);
@@ -1807,10 +1872,9 @@ struct MPOQC<S, FL, typename S::is_sz_t> : MPO<S, FL> {
                     p += 4 * (m + 1) * (m + 1);
                     for (uint16_t g = m + 1; g < n_orbs; g++)
                         for (uint16_t h = m + 1; h < n_orbs; h++)
-                            if (abs(hamil->v(s & 1, s >> 1, j, g, k, h)) > TINY)
+                            if (abs(vg[(g - g0) * nt + h - g0]) > TINY)
                                 exprs.push_back(
-                                    ((FL)0.5 *
-                                     hamil->v(s & 1, s >> 1, j, g, k, h)) *
+                                    ((FL)0.5 * vg[(g - g0) * nt + h - g0]) *
                                     a_op[g][h][s]);
                     rop[p] = (FL)0.5 * pd_op[j][k][s];
                     rexpr[p] = sum(exprs);
@@ -1818,16 +1882,16 @@ struct MPOQC<S, FL, typename S::is_sz_t> : MPO<S, FL> {
                     p += 4 * (m + 1) * (m + 1);
                     for (uint16_t g = m + 1; g < n_orbs; g++)
                         for (uint16_t h = m + 1; h < n_orbs; h++) {
-                            if (abs(hamil->v(s & 1, s >> 1, j, h, g, k)) > TINY)
+                            const size_t gh = (size_t)(g - g0) * nt + h - g0;
+                            if (abs(vh[gh]) > TINY)
                                 exprs.push_back(
-                                    -hamil->v(s & 1, s >> 1, j, h, g, k) *
+                                    -vh[gh] *
                                     b_op[g][h][((s & 1) << 1) | (s >> 1)]);
                             if ((s & 1) == (s >> 1))
                                 for (uint8_t sp = 0; sp < 2; sp++)
-                                    if (abs(hamil->v(s & 1, sp, j, k, g, h)) >
-                                        TINY)
+                                    if (abs(vk[sp][gh]) > TINY)
                                         exprs.push_back(
-                                            hamil->v(s & 1, sp, j, k, g, h) *
+                                            vk[sp][gh] *
                                             b_op[g][h][(sp << 1) | sp]);
                         }
                     rop[p] = q_op[j][k][s];
@@ -2149,9 +2213,14 @@ struct MPOQC<S, FL, typename S::is_su2_t> : MPO<S, FL> {
                     mat[{pi, p + m}] = d_op[m];
                     p += m + 1;
                     // RD
+                    vector<FL> vx((size_t)m * m), vy((size_t)m * m),
+                        vz((size_t)m * m);
                     for (uint16_t i = m + 1; i < n_orbs; i++) {
                         mat[{prd + i, p + i - (m + 1)}] = i_op;
                         mat[{pi, p + i - (m + 1)}] = trd_op[i];
+                        hamil->v_tile({0, i, 0, m}, 0, 2, 0, m, vx.data());
+                        hamil->v_tile({m, i, 0, 0}, 2, 3, 0, m, vy.data());
+                        hamil->v_tile({0, i, m, 0}, 0, 3, 0, m, vz.data());
                         for (uint16_t k = 0; k < m; k++) {
                             mat[{pd + k, p + i - (m + 1)}] =
                                 (FL)2.0 *
@@ -2164,10 +2233,8 @@ struct MPOQC<S, FL, typename S::is_su2_t> : MPO<S, FL> {
                         }
                         for (uint16_t j = 0; j < m; j++)
                             for (uint16_t l = 0; l < m; l++) {
-                                FL f0 =
-                                    hamil->v(j, i, l, m) + hamil->v(l, i, j, m);
-                                FL f1 =
-                                    hamil->v(j, i, l, m) - hamil->v(l, i, j, m);
+                                FL f0 = vx[j * m + l] + vx[l * m + j];
+                                FL f1 = vx[j * m + l] - vx[l * m + j];
                                 mat[{pa0 + j * m + l, p + i - (m + 1)}] =
                                     f0 * (FL)(-0.5) * d_op[m];
                                 mat[{pa1 + j * m + l, p + i - (m + 1)}] =
@@ -2175,14 +2242,14 @@ struct MPOQC<S, FL, typename S::is_su2_t> : MPO<S, FL> {
                             }
                         for (uint16_t k = 0; k < m; k++)
                             for (uint16_t l = 0; l < m; l++) {
-                                FL f = (FL)2.0 * hamil->v(m, i, l, k) -
-                                       hamil->v(l, i, m, k);
+                                FL f =
+                                    (FL)2.0 * vy[l * m + k] - vz[l * m + k];
                                 mat[{pb0 + l * m + k, p + i - (m + 1)}] =
                                     f * c_op[m];
                             }
                         for (uint16_t j = 0; j < m; j++)
                             for (uint16_t k = 0; k < m; k++) {
-                                FL f = hamil->v(j, i, m, k) * (FL)sqrt(3);
+                                FL f = vz[j * m + k] * (FL)sqrt(3);
                                 mat[{pb1 + j * m + k, p + i - (m + 1)}] =
                                     f * c_op[m];
                             }
@@ -2192,6 +2259,9 @@ struct MPOQC<S, FL, typename S::is_su2_t> : MPO<S, FL> {
                     for (uint16_t i = m + 1; i < n_orbs; i++) {
                         mat[{pr + i, p + i - (m + 1)}] = i_op;
                         mat[{pi, p + i - (m + 1)}] = tr_op[i];
+                        hamil->v_tile({i, 0, m, 0}, 1, 3, 0, m, vx.data());
+                        hamil->v_tile({i, m, 0, 0}, 2, 3, 0, m, vy.data());
+                        hamil->v_tile({i, 0, 0, m}, 1, 2, 0, m, vz.data());
                         for (uint16_t k = 0; k < m; k++) {
                             mat[{pc + k, p + i - (m + 1)}] =
                                 (FL)2.0 *
@@ -2203,10 +2273,8 @@ struct MPOQC<S, FL, typename S::is_su2_t> : MPO<S, FL> {
                         }
                         for (uint16_t j = 0; j < m; j++)
                             for (uint16_t l = 0; l < m; l++) {
-                                FL f0 =
-                                    hamil->v(i, j, m, l) + hamil->v(i, l, m, j);
-                                FL f1 =
-                                    hamil->v(i, j, m, l) - hamil->v(i, l, m, j);
+                                FL f0 = vx[j * m + l] + vx[l * m + j];
+                                FL f1 = vx[j * m + l] - vx[l * m + j];
                                 mat[{pad0 + j * m + l, p + i - (m + 1)}] =
                                     f0 * (FL)(-0.5) * c_op[m];
                                 mat[{pad1 + j * m + l, p + i - (m + 1)}] =
@@ -2214,15 +2282,14 @@ struct MPOQC<S, FL, typename S::is_su2_t> : MPO<S, FL> {
                             }
                         for (uint16_t k = 0; k < m; k++)
                             for (uint16_t l = 0; l < m; l++) {
-                                FL f = (FL)2.0 * hamil->v(i, m, k, l) -
-                                       hamil->v(i, l, k, m);
+                                FL f =
+                                    (FL)2.0 * vy[k * m + l] - vz[l * m + k];
                                 mat[{pb0 + k * m + l, p + i - (m + 1)}] =
                                     f * d_op[m];
                             }
                         for (uint16_t j = 0; j < m; j++)
                             for (uint16_t k = 0; k < m; k++) {
-                                FL f = (FL)(-1.0) * hamil->v(i, j, k, m) *
-                                       (FL)sqrt(3);
+                                FL f = (FL)(-1.0) * vz[j * m + k] * (FL)sqrt(3);
                                 mat[{pb1 + k * m + j, p + i - (m + 1)}] =
                                     f * d_op[m];
                             }
@@ -2354,15 +2421,19 @@ struct MPOQC<S, FL, typename S::is_su2_t> : MPO<S, FL> {
                     int pb0 = 2 + (n_orbs << 1) + mm * mm * 4;
                     int pb1 = 2 + (n_orbs << 1) + mm * mm * 5;
                     // R
+                    vector<FL> vx((size_t)mm * mm), vy((size_t)mm * mm),
+                        vz((size_t)mm * mm);
                     for (uint16_t i = 0; i < m; i++) {
                         mat[{p + i, pi}] = tr_op[i];
                         mat[{p + i, pr + i}] = i_op;
+                        hamil->v_tile({i, 0, m, 0}, 1, 3, m + 1, mm, vx.data());
+                        hamil->v_tile({i, m, 0, 0}, 2, 3, m + 1, mm, vy.data());
+                        hamil->v_tile({i, 0, 0, m}, 1, 2, m + 1, mm, vz.data());
                         for (uint16_t j = m + 1; j < n_orbs; j++)
                             for (uint16_t l = m + 1; l < n_orbs; l++) {
-                                FL f0 =
-                                    hamil->v(i, j, m, l) + hamil->v(i, l, m, j);
-                                FL f1 =
-                                    hamil->v(i, j, m, l) - hamil->v(i, l, m, j);
+                                const FL vjl = vx[(j - m - 1) * mm + l - m - 1],
+                                         vlj = vx[(l - m - 1) * mm + j - m - 1];
+                                FL f0 = vjl + vlj, f1 = vjl - vlj;
                                 mat[{p + i, pad0 + (j - m - 1) * mm + l - m -
                                                 1}] = f0 * (FL)(-0.5) * c_op[m];
                                 mat[{p + i,
@@ -2371,14 +2442,16 @@ struct MPOQC<S, FL, typename S::is_su2_t> : MPO<S, FL> {
                             }
                         for (uint16_t k = m + 1; k < n_orbs; k++)
                             for (uint16_t l = m + 1; l < n_orbs; l++) {
-                                FL f = (FL)2.0 * hamil->v(i, m, k, l) -
-                                       hamil->v(i, l, k, m);
+                                FL f =
+                                    (FL)2.0 * vy[(k - m - 1) * mm + l - m - 1] -
+                                    vz[(l - m - 1) * mm + k - m - 1];
                                 mat[{p + i, pb0 + (k - m - 1) * mm + l - m -
                                                 1}] = f * d_op[m];
                             }
                         for (uint16_t j = m + 1; j < n_orbs; j++)
                             for (uint16_t k = m + 1; k < n_orbs; k++) {
-                                FL f = hamil->v(i, j, k, m) * (FL)sqrt(3);
+                                FL f = vz[(j - m - 1) * mm + k - m - 1] *
+                                       (FL)sqrt(3);
                                 mat[{p + i, pb1 + (k - m - 1) * mm + j - m -
                                                 1}] = f * d_op[m];
                             }
@@ -2398,12 +2471,14 @@ struct MPOQC<S, FL, typename S::is_su2_t> : MPO<S, FL> {
                     for (uint16_t i = 0; i < m; i++) {
                         mat[{p + i, pi}] = trd_op[i];
                         mat[{p + i, prd + i}] = i_op;
+                        hamil->v_tile({0, i, 0, m}, 0, 2, m + 1, mm, vx.data());
+                        hamil->v_tile({m, i, 0, 0}, 2, 3, m + 1, mm, vy.data());
+                        hamil->v_tile({0, i, m, 0}, 0, 3, m + 1, mm, vz.data());
                         for (uint16_t j = m + 1; j < n_orbs; j++)
                             for (uint16_t l = m + 1; l < n_orbs; l++) {
-                                FL f0 =
-                                    hamil->v(j, i, l, m) + hamil->v(l, i, j, m);
-                                FL f1 =
-                                    hamil->v(j, i, l, m) - hamil->v(l, i, j, m);
+                                const FL vjl = vx[(j - m - 1) * mm + l - m - 1],
+                                         vlj = vx[(l - m - 1) * mm + j - m - 1];
+                                FL f0 = vjl + vlj, f1 = vjl - vlj;
                                 mat[{p + i, pa0 + (j - m - 1) * mm + l - m -
                                                 1}] = f0 * (FL)(-0.5) * d_op[m];
                                 mat[{p + i,
@@ -2412,14 +2487,16 @@ struct MPOQC<S, FL, typename S::is_su2_t> : MPO<S, FL> {
                             }
                         for (uint16_t k = m + 1; k < n_orbs; k++)
                             for (uint16_t l = m + 1; l < n_orbs; l++) {
-                                FL f = (FL)2.0 * hamil->v(m, i, l, k) -
-                                       hamil->v(l, i, m, k);
+                                FL f =
+                                    (FL)2.0 * vy[(l - m - 1) * mm + k - m - 1] -
+                                    vz[(l - m - 1) * mm + k - m - 1];
                                 mat[{p + i, pb0 + (l - m - 1) * mm + k - m -
                                                 1}] = f * c_op[m];
                             }
                         for (uint16_t j = m + 1; j < n_orbs; j++)
                             for (uint16_t k = m + 1; k < n_orbs; k++) {
-                                FL f = (FL)(-1.0) * hamil->v(j, i, m, k) *
+                                FL f = (FL)(-1.0) *
+                                       vz[(j - m - 1) * mm + k - m - 1] *
                                        (FL)sqrt(3);
                                 mat[{p + i, pb1 + (j - m - 1) * mm + k - m -
                                                 1}] = f * c_op[m];
@@ -2755,17 +2832,24 @@ struct MPOQC<S, FL, typename S::is_su2_t> : MPO<S, FL> {
                 for (uint16_t j = m + 1; j < n_orbs; j++) {
 #endif
                 vector<shared_ptr<OpExpr<S>>> exprs;
+                const uint16_t g0 = 0, nt = m + 1;
+                vector<FL> vg((size_t)nt * nt), vk((size_t)nt * nt),
+                    vh((size_t)nt * nt);
                 exprs.reserve((m + 1) * (m + 1));
                 for (uint16_t k = m + 1; k < n_orbs; k++) {
                     int p = (k - m - 1) + (j - m - 1) * (n_orbs - m - 1) +
                             s * (n_orbs - m - 1) * (n_orbs - m - 1);
                     exprs.clear();
                     p += 2 + 2 * n_orbs;
+                    hamil->v_tile({j, 0, k, 0}, 1, 3, g0, nt, vg.data());
+                    hamil->v_tile({j, k, 0, 0}, 2, 3, g0, nt, vk.data());
+                    hamil->v_tile({j, 0, 0, k}, 2, 1, g0, nt, vh.data());
                     for (uint16_t g = 0; g < m + 1; g++)
                         for (uint16_t h = 0; h < m + 1; h++)
-                            if (abs(hamil->v(j, g, k, h)) > TINY)
+                            if (abs(vg[(g - g0) * nt + h - g0]) > TINY)
                                 exprs.push_back(
-                                    (su2_factor_p[s] * hamil->v(j, g, k, h) *
+                                    (su2_factor_p[s] *
+                                     vg[(g - g0) * nt + h - g0] *
                                      (FL)(s ? -1.0 : 1.0)) *
                                     ad_op[g][h][s]);
                     lop[p] = su2_factor_p[s] * p_op[j][k][s];
@@ -2774,9 +2858,10 @@ struct MPOQC<S, FL, typename S::is_su2_t> : MPO<S, FL> {
                     p += 2 * (n_orbs - m - 1) * (n_orbs - m - 1);
                     for (uint16_t g = 0; g < m + 1; g++)
                         for (uint16_t h = 0; h < m + 1; h++)
-                            if (abs(hamil->v(j, g, k, h)) > TINY)
+                            if (abs(vg[(g - g0) * nt + h - g0]) > TINY)
                                 exprs.push_back(
-                                    (su2_factor_p[s] * hamil->v(j, g, k, h) *
+                                    (su2_factor_p[s] *
+                                     vg[(g - g0) * nt + h - g0] *
                                      (FL)(s ? -1.0 : 1.0)) *
                                     a_op[g][h][s]);
                     lop[p] = su2_factor_p[s] * pd_op[j][k][s];
@@ -2785,21 +2870,22 @@ struct MPOQC<S, FL, typename S::is_su2_t> : MPO<S, FL> {
                     p += 2 * (n_orbs - m - 1) * (n_orbs - m - 1);
                     if (s == 0) {
                         for (uint16_t g = 0; g < m + 1; g++)
-                            for (uint16_t h = 0; h < m + 1; h++)
-                                if (abs((FL)2.0 * hamil->v(j, k, g, h) -
-                                        hamil->v(j, h, g, k)) > TINY)
-                                    exprs.push_back(
-                                        (su2_factor_q[0] *
-                                         ((FL)2.0 * hamil->v(j, k, g, h) -
-                                          hamil->v(j, h, g, k))) *
-                                        b_op[g][h][0]);
+                            for (uint16_t h = 0; h < m + 1; h++) {
+                                const FL f =
+                                    (FL)2.0 * vk[(g - g0) * nt + h - g0] -
+                                    vh[(g - g0) * nt + h - g0];
+                                if (abs(f) > TINY)
+                                    exprs.push_back((su2_factor_q[0] * f) *
+                                                    b_op[g][h][0]);
+                            }
                     } else {
                         for (uint16_t g = 0; g < m + 1; g++)
                             for (uint16_t h = 0; h < m + 1; h++)
-                                if (abs(hamil->v(j, h, g, k)) > TINY)
-                                    exprs.push_back((su2_factor_q[1] *
-                                                     hamil->v(j, h, g, k)) *
-                                                    b_op[g][h][1]);
+                                if (abs(vh[(g - g0) * nt + h - g0]) > TINY)
+                                    exprs.push_back(
+                                        (su2_factor_q[1] *
+                                         vh[(g - g0) * nt + h - g0]) *
+                                        b_op[g][h][1]);
                     }
                     lop[p] = su2_factor_q[s] * q_op[j][k][s];
                     lexpr[p] = sum(exprs);
@@ -2834,16 +2920,23 @@ struct MPOQC<S, FL, typename S::is_su2_t> : MPO<S, FL> {
                 for (uint16_t j = 0; j < m + 1; j++) {
 #endif
                 vector<shared_ptr<OpExpr<S>>> exprs;
+                const uint16_t g0 = m + 1, nt = n_orbs - m - 1;
+                vector<FL> vg((size_t)nt * nt), vk((size_t)nt * nt),
+                    vh((size_t)nt * nt);
                 exprs.reserve((n_orbs - m - 1) * (n_orbs - m - 1));
                 for (uint16_t k = 0; k < m + 1; k++) {
                     int p = k + j * (m + 1) + s * (m + 1) * (m + 1);
                     exprs.clear();
                     p += 2 + 2 * n_orbs;
+                    hamil->v_tile({j, 0, k, 0}, 1, 3, g0, nt, vg.data());
+                    hamil->v_tile({j, k, 0, 0}, 2, 3, g0, nt, vk.data());
+                    hamil->v_tile({j, 0, 0, k}, 2, 1, g0, nt, vh.data());
                     for (uint16_t g = m + 1; g < n_orbs; g++)
                         for (uint16_t h = m + 1; h < n_orbs; h++)
-                            if (abs(hamil->v(j, g, k, h)) > TINY)
+                            if (abs(vg[(g - g0) * nt + h - g0]) > TINY)
                                 exprs.push_back(
-                                    (su2_factor_p[s] * hamil->v(j, g, k, h) *
+                                    (su2_factor_p[s] *
+                                     vg[(g - g0) * nt + h - g0] *
                                      (FL)(s ? -1.0 : 1.0)) *
                                     ad_op[g][h][s]);
                     rop[p] = su2_factor_p[s] * p_op[j][k][s];
@@ -2852,9 +2945,10 @@ struct MPOQC<S, FL, typename S::is_su2_t> : MPO<S, FL> {
                     p += 2 * (m + 1) * (m + 1);
                     for (uint16_t g = m + 1; g < n_orbs; g++)
                         for (uint16_t h = m + 1; h < n_orbs; h++)
-                            if (abs(hamil->v(j, g, k, h)) > TINY)
+                            if (abs(vg[(g - g0) * nt + h - g0]) > TINY)
                                 exprs.push_back(
-                                    (su2_factor_p[s] * hamil->v(j, g, k, h) *
+                                    (su2_factor_p[s] *
+                                     vg[(g - g0) * nt + h - g0] *
                                      (FL)(s ? -1.0 : 1.0)) *
                                     a_op[g][h][s]);
                     rop[p] = su2_factor_p[s] * pd_op[j][k][s];
@@ -2863,21 +2957,22 @@ struct MPOQC<S, FL, typename S::is_su2_t> : MPO<S, FL> {
                     p += 2 * (m + 1) * (m + 1);
                     if (s == 0) {
                         for (uint16_t g = m + 1; g < n_orbs; g++)
-                            for (uint16_t h = m + 1; h < n_orbs; h++)
-                                if (abs((FL)2.0 * hamil->v(j, k, g, h) -
-                                        hamil->v(j, h, g, k)) > TINY)
-                                    exprs.push_back(
-                                        (su2_factor_q[0] *
-                                         ((FL)2.0 * hamil->v(j, k, g, h) -
-                                          hamil->v(j, h, g, k))) *
-                                        b_op[g][h][0]);
+                            for (uint16_t h = m + 1; h < n_orbs; h++) {
+                                const FL f =
+                                    (FL)2.0 * vk[(g - g0) * nt + h - g0] -
+                                    vh[(g - g0) * nt + h - g0];
+                                if (abs(f) > TINY)
+                                    exprs.push_back((su2_factor_q[0] * f) *
+                                                    b_op[g][h][0]);
+                            }
                     } else {
                         for (uint16_t g = m + 1; g < n_orbs; g++)
                             for (uint16_t h = m + 1; h < n_orbs; h++)
-                                if (abs(hamil->v(j, h, g, k)) > TINY)
-                                    exprs.push_back((su2_factor_q[1] *
-                                                     hamil->v(j, h, g, k)) *
-                                                    b_op[g][h][1]);
+                                if (abs(vh[(g - g0) * nt + h - g0]) > TINY)
+                                    exprs.push_back(
+                                        (su2_factor_q[1] *
+                                         vh[(g - g0) * nt + h - g0]) *
+                                        b_op[g][h][1]);
                     }
                     rop[p] = su2_factor_q[s] * q_op[j][k][s];
                     rexpr[p] = sum(exprs);
@@ -3798,4 +3893,114 @@ struct MPOQC<S, FL, typename S::is_sany_t> : MPO<S, FL> {
     }
 };
 
+// In-place update of MPO built from MPOQC (also after SimplifiedMPO) for new
+// one-electron integrals and core energy only. In MPOQC these only enter the
+// site operators (R, RD and H) and const_e, so e.g. a time-dependent external
+// field can be set without building and simplifying the MPO again.
+// The two-electron integrals also enter the coefficients in the symbolic part
+// and decide which terms are screened out. Since the symbolic part is not
+// parameterized, changes of them (bond-stretch scans, DMRG-SCF) are rejected
+// and need a rebuild, as do MPOs from GeneralMPO or FusedMPO.
+// Environments are not updated: H changes on every site, so all environments
+// built with the old MPO have to be initialized again.
+template <typename S, typename FL> struct MPOQCOneBodyRefresh {
+    typedef typename GMatrix<FL>::FP FP;
+    // Empty string if the MPO built with hamil can be refreshed for fcidump,
+    // otherwise the reason why the MPO has to be rebuilt
+    static string check(const shared_ptr<HamiltonianQC<S, FL>> &hamil,
+                        const shared_ptr<FCIDUMP<FL>> &fcidump) {
+        const shared_ptr<FCIDUMP<FL>> &ref = hamil->fcidump;
+        if (ref == fcidump)
+            return "";
+        const uint16_t n = ref->n_sites();
+        const uint8_t ns = ref->uhf ? 2 : 1;
+        if (fcidump->n_sites() != n || fcidump->uhf != ref->uhf ||
+            fcidump->general != ref->general)
+            return "different orbital space or type of integrals";
+        // two-electron integrals
+        bool same_layout = ref->vs.size() == fcidump->vs.size() &&
+                           ref->vabs.size() == fcidump->vabs.size() &&
+                           ref->vgs.size() == fcidump->vgs.size() &&
+                           ref->vs.size() + ref->vabs.size() +
+                                   ref->vgs.size() !=
+                               0;
+        for (size_t i = 0; same_layout && i < ref->vs.size(); i++)
+            same_layout = ref->vs[i].size() == fcidump->vs[i].size();
+        for (size_t i = 0; same_layout && i < ref->vabs.size(); i++)
+            same_layout = ref->vabs[i].size() == fcidump->vabs[i].size();
+        for (size_t i = 0; same_layout && i < ref->vgs.size(); i++)
+            same_layout = ref->vgs[i].size() == fcidump->vgs[i].size();
+        bool same_v = true;
+        if (same_layout) {
+            for (size_t i = 0; same_v && i < ref->vs.size(); i++)
+                same_v = memcmp(ref->vs[i].data, fcidump->vs[i].data,
+                                sizeof(FL) * ref->vs[i].size()) == 0;
+            for (size_t i = 0; same_v && i < ref->vabs.size(); i++)
+                same_v = memcmp(ref->vabs[i].data, fcidump->vabs[i].data,
+                                sizeof(FL) * ref->vabs[i].size()) == 0;
+            for (size_t i = 0; same_v && i < ref->vgs.size(); i++)
+                same_v = memcmp(ref->vgs[i].data, fcidump->vgs[i].data,
+                                sizeof(FL) * ref->vgs[i].size()) == 0;
+        } else
+            for (uint8_t sl = 0; same_v && sl < ns; sl++)
+                for (uint8_t sr = 0; same_v && sr < ns; sr++)
+                    for (uint16_t i = 0; same_v && i < n; i++)
+                        for (uint16_t j = 0; same_v && j < n; j++)
+                            for (uint16_t k = 0; same_v && k < n; k++)
+                                for (uint16_t l = 0; same_v && l < n; l++)
+                                    same_v = ref->v(sl, sr, i, j, k, l) ==
+                                             fcidump->v(sl, sr, i, j, k, l);
+        if (!same_v)
+            return "two-electron integrals are changed";
+        // site operators R / RD screened out when building the MPO
+        const vector<typename S::pg_t> &orb_sym = hamil->orb_sym;
+        const bool has_pg = orb_sym.size() == (size_t)n;
+        for (uint8_t s = 0; s < ns; s++)
+            for (uint16_t m = 0; m < n; m++)
+                for (uint16_t i = 0; i < n; i++) {
+                    if (i == m ||
+                        (has_pg &&
+                         !S::pg_equal(0, S::pg_mul(orb_sym[i],
+                                                   S::pg_inv(orb_sym[m])))))
+                        continue;
+                    if ((abs(ref->t(s, i, m)) < TINY &&
+                         abs(ref->v(s, 0, i, m, m, m)) < TINY &&
+                         abs(ref->v(s, 1, i, m, m, m)) < TINY &&
+                         abs(fcidump->t(s, i, m)) >= TINY) ||
+                        (abs(ref->t(s, m, i)) < TINY &&
+                         abs(ref->v(s, 0, m, i, m, m)) < TINY &&
+                         abs(ref->v(s, 1, m, i, m, m)) < TINY &&
+                         abs(fcidump->t(s, m, i)) >= TINY))
+                        return "one-electron integral t(" + to_string(i) +
+                               ", " + to_string(m) +
+                               ") was screened out when building the MPO";
+                }
+        return "";
+    }
+    // Set fcidump as the integrals of the hamiltonian of mpo and update the
+    // site operators and const_e of mpo. Other MPOs sharing the same
+    // hamiltonian have to be refreshed as well. The integrals should be a
+    // new FCIDUMP object (e.g. from deep_copy), so that they can be checked
+    static void refresh(const shared_ptr<MPO<S, FL>> &mpo,
+                        const shared_ptr<FCIDUMP<FL>> &fcidump) {
+        shared_ptr<HamiltonianQC<S, FL>> hamil =
+            dynamic_pointer_cast<HamiltonianQC<S, FL>>(mpo->hamil);
+        if (hamil == nullptr)
+            throw runtime_error("MPOQCOneBodyRefresh::refresh: MPO is not "
+                                "built from HamiltonianQC.");
+        // e.g. FusedMPO, where site operators are products of the operators
+        // of several orbitals
+        if (mpo->n_sites != hamil->n_sites)
+            throw runtime_error("MPOQCOneBodyRefresh::refresh: MPO sites are "
+                                "not orbital sites.");
+        const string reason = check(hamil, fcidump);
+        if (reason != "")
+            throw runtime_error("MPOQCOneBodyRefresh::refresh: " + reason +
+                                ".");
+        hamil->fcidump = fcidump;
+        mpo->const_e = hamil->e();
+        mpo->refresh_site_ops();
+    }
+};
+
 } // namespace block2
@@ -25,6 +25,7 @@
 #include "../core/sparse_matrix.hpp"
 #include "../core/spin_permutation.hpp"
 #include "effective_functions.hpp"
+#include "memory_budget.hpp"
 #include "moving_environment.hpp"
 #include "parallel_mps.hpp"
 #include "qc_ncorr.hpp"
@@ -98,6 +99,8 @@ template <typename S, typename FL, typename FLS> struct DMRG {
     int davidson_soft_max_iter = -1;
     FPS davidson_shift = 0.0;
     DavidsonTypes davidson_type = DavidsonTypes::Normal;
+    // sparsity screening threshold in Davidson H x c (0 = off)
+    FPS davidson_screen_thrd = 0.0;
     int conn_adjust_step = 2;
     bool forward;
     uint8_t iprint = 2;
@@ -120,6 +123,8 @@ template <typename S, typename FL, typename FLS> struct DMRG {
     int davidson_def_max_size = 50;
     double tprt = 0, teig = 0, teff = 0, tmve = 0, tblk = 0, tdm = 0, tsplt = 0,
            tsvd = 0, torth = 0;
+    // wall time for large/small blocks in dense decompositions
+    double tdecl = 0, tdecs = 0;
     double accumulated_elapsed_time = 0;
     bool print_connection_time = false;
     // store all wfn singular values (for analysis) at each site
@@ -130,6 +135,8 @@ template <typename S, typename FL, typename FLS> struct DMRG {
     vector<FPS> wfn_spectra;
     int sweep_start_site = 0;
     int sweep_end_site = -1;
+    // when set, memory modes of me and the DataFrame are chosen per site
+    shared_ptr<MemoryBudget<S, FL, FLS>> mem_budget = nullptr;
     Timer _t, _t2;
     DMRG(const shared_ptr<MovingEnvironment<S, FL, FLS>> &me,
          const vector<ubond_t> &bond_dims, const vector<FPS> &noises)
@@ -759,6 +766,7 @@ template <typename S, typename FL, typename FLS> struct DMRG {
             fuse_left ? FuseTypes::FuseL : FuseTypes::FuseR, forward, true,
             me->bra->tensors[i], me->ket->tensors[i]);
         h_eff->eff_kernel = eff_kernel;
+        h_eff->screen_thrd = davidson_screen_thrd;
         if (context_ket != nullptr)
             h_eff->context_mask =
                 MovingEnvironment<S, FL, FLS>::symm_context_convert(
@@ -1215,6 +1223,7 @@ template <typename S, typename FL, typename FLS> struct DMRG {
             me->eff_ham(FuseTypes::FuseLR, forward, true, me->bra->tensors[i],
                         me->ket->tensors[i]);
         h_eff->eff_kernel = eff_kernel;
+        h_eff->screen_thrd = davidson_screen_thrd;
         if (context_ket != nullptr)
             h_eff->context_mask =
                 MovingEnvironment<S, FL, FLS>::symm_context_convert(
@@ -2555,6 +2564,7 @@ template <typename S, typename FL, typename FLS> struct DMRG {
     virtual tuple<vector<FPLS>, FPS, vector<vector<pair<S, FPS>>>>
     sweep(bool forward, ubond_t bond_dim, FPS noise, FPS davidson_conv_thrd) {
         teff = teig = tprt = tblk = tmve = tdm = tsplt = tsvd = torth = 0;
+        tdecl = tdecs = 0;
         me->mpo->tread = me->mpo->twrite = 0;
         frame_<FPS>()->twrite = frame_<FPS>()->tread = frame_<FPS>()->tasync =
             0;
@@ -2604,13 +2614,37 @@ template <typename S, typename FL, typename FLS> struct DMRG {
                          << " Site = " << setw(4) << i << " .. ";
                 cout.flush();
             }
+            const double tdecl0 = threading->tdecomp_large,
+                         tdecs0 = threading->tdecomp_small;
+            const size_t ndecl0 = threading->n_decomp_large,
+                         ndecs0 = threading->n_decomp_small;
+            const size_t eff_ham_size0 = sweep_max_eff_ham_size;
+            if (mem_budget != nullptr) {
+                mem_budget->begin_site(i, forward, me);
+                sweep_max_eff_ham_size = 0;
+            }
             t.get_time();
             Iteration r =
                 blocking(i, forward, bond_dim, noise, davidson_conv_thrd);
             sweep_cumulative_nflop += r.nflop;
-            if (iprint >= 2)
+            tdecl += threading->tdecomp_large - tdecl0;
+            tdecs += threading->tdecomp_small - tdecs0;
+            if (iprint >= 2) {
                 cout << r << " T = " << setw(4) << fixed << setprecision(2)
-                     << t.get_time() << endl;
+                     << t.get_time();
+                if (iprint >= 3)
+                    cout << " Tdec = " << fixed << setprecision(3)
+                         << threading->tdecomp_large - tdecl0 << "/"
+                         << threading->tdecomp_small - tdecs0
+                         << " (L/S = " << threading->n_decomp_large - ndecl0
+                         << "/" << threading->n_decomp_small - ndecs0 << ")";
+                cout << endl;
+            }
+            if (mem_budget != nullptr) {
+                mem_budget->end_site(i, forward, me, sweep_max_eff_ham_size);
+                sweep_max_eff_ham_size =
+                    max(sweep_max_eff_ham_size, eff_ham_size0);
+            }
             sweep_energies.push_back(r.energies);
             sweep_discarded_weights.push_back(r.error);
             sweep_quanta.push_back(r.quanta);
@@ -2672,6 +2706,8 @@ template <typename S, typename FL, typename FLS> struct DMRG {
                 Parsing::mkdir(frame_<FPS>()->restart_dir);
             me->ket->info->copy_mutable(frame_<FPS>()->restart_dir);
             me->ket->copy_data(frame_<FPS>()->restart_dir);
+            frame_<FP>()->snapshot_partition_container(
+                frame_<FPS>()->restart_dir);
             if (me->bra != me->ket) {
                 me->bra->info->copy_mutable(frame_<FPS>()->restart_dir);
                 me->bra->copy_data(frame_<FPS>()->restart_dir);
@@ -2746,11 +2782,15 @@ template <typename S, typename FL, typename FLS> struct DMRG {
                      << " .. ";
             else
                 sout << " Site = " << setw(4) << i << " .. ";
+            const double tdecl0 = threading->tdecomp_large,
+                         tdecs0 = threading->tdecomp_small;
             t.get_time();
             Iteration r =
                 blocking(i, forward, bond_dim, noise, davidson_conv_thrd);
             sweep_cumulative_nflop += r.nflop;
             sweep_time[i] = t.get_time();
+            tdecl += threading->tdecomp_large - tdecl0;
+            tdecs += threading->tdecomp_small - tdecs0;
             sout << r << " T = " << setw(4) << fixed << setprecision(2)
                  << sweep_time[i] << endl;
             if (iprint >= 2)
@@ -2859,6 +2899,7 @@ template <typename S, typename FL, typename FLS> struct DMRG {
         shared_ptr<ParallelMPS<S, FLS>> para_mps =
             dynamic_pointer_cast<ParallelMPS<S, FLS>>(me->ket);
         teff = teig = tprt = tblk = tmve = tdm = tsplt = tsvd = torth = 0;
+        tdecl = tdecs = 0;
         me->mpo->tread = me->mpo->twrite = 0;
         frame_<FPS>()->twrite = frame_<FPS>()->tread = frame_<FPS>()->tasync =
             0;
@@ -2967,7 +3008,8 @@ template <typename S, typename FL, typename FLS> struct DMRG {
                  << " | Teig = " << teig << " | Tblk = " << tblk
                  << " | Tmve = " << tmve << " | Tdm = " << tdm
                  << " | Tsplt = " << tsplt << " | Tsvd = " << tsvd
-                 << " | Torth = " << torth;
+                 << " | Torth = " << torth
+                 << " | Tdecl = " << tdecl << " | Tdecs = " << tdecs;
             sout << endl;
             cout << sout.rdbuf();
         }
@@ -3017,6 +3059,8 @@ template <typename S, typename FL, typename FLS> struct DMRG {
                 Parsing::mkdir(frame_<FPS>()->restart_dir);
             para_mps->info->copy_mutable(frame_<FPS>()->restart_dir);
             para_mps->copy_data(frame_<FPS>()->restart_dir);
+            frame_<FP>()->snapshot_partition_container(
+                frame_<FPS>()->restart_dir);
         }
         if (frame_<FPS>()->restart_dir_per_sweep != "" &&
             (para_mps->rule == nullptr || para_mps->rule->comm->group == 0) &&
@@ -3219,7 +3263,8 @@ template <typename S, typename FL, typename FLS> struct DMRG {
                          << " | Teig = " << teig << " | Tblk = " << tblk
                          << " | Tmve = " << tmve << " | Tdm = " << tdm
                          << " | Tsplt = " << tsplt << " | Tsvd = " << tsvd
-                         << " | Torth = " << torth;
+                         << " | Torth = " << torth
+                         << " | Tdecl = " << tdecl << " | Tdecs = " << tdecs;
                     sout << endl;
                     cout << sout.rdbuf();
                     if (para_mps != nullptr && para_mps->rule != nullptr) {
@@ -5354,6 +5399,15 @@ struct PartitionWeights<FL, typename enable_if<is_complex<FL>::value>::type> {
     }
 };
 
+// Receiver of the expectations of each site in the Expect sweep,
+// so that they can be contracted on the fly instead of being stored
+template <typename S, typename FLX> struct ExpectationConsumer {
+    virtual ~ExpectationConsumer() = default;
+    virtual void
+    consume(int i,
+            const vector<pair<shared_ptr<OpExpr<S>>, FLX>> &expectations) = 0;
+};
+
 // Expectation value
 template <typename S, typename FL, typename FLS, typename FLX = double>
 struct Expect {
@@ -5361,6 +5415,9 @@ struct Expect {
     shared_ptr<MovingEnvironment<S, FL, FLS>> me;
     ubond_t bra_bond_dim, ket_bond_dim;
     vector<vector<pair<shared_ptr<OpExpr<S>>, FLX>>> expectations;
+    // if not nullptr, expectations of each site are passed to consumer
+    // and not kept in expectations
+    shared_ptr<ExpectationConsumer<S, FLX>> consumer = nullptr;
     bool forward;
     TruncationTypes trunc_type = TruncationTypes::Physical;
     ExpectationAlgorithmTypes algo_type = ExpectationAlgorithmTypes::Automatic;
@@ -6512,7 +6569,12 @@ struct Expect {
             if (iprint >= 2)
                 cout << r << " T = " << setw(4) << fixed << setprecision(2)
                      << t.get_time() << endl;
-            expectations[i] = r.expectations;
+            // for one-dot, last expectations repeat those of previous site
+            if (consumer != nullptr) {
+                if (zero_dot_algo || me->dot != 1 || i != me->n_sites - 1)
+                    consumer->consume(i, r.expectations);
+            } else
+                expectations[i] = r.expectations;
         }
     }
     FLX solve(bool propagate, bool forward = true) {
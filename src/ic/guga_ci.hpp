@@ -0,0 +1,563 @@
+/*
+ * block2: Efficient MPO implementation of quantum chemistry DMRG
+ * Copyright (C) 2021 Huanchen Zhai <hczhai@caltech.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/** Direct CI in the space of configuration state functions (CSF)
+ * using the Graphical Unitary Group Approach (GUGA).
+ *
+ * The one-body coupling coefficients <m|E_ij|n> are products of
+ * segment values along the loop between orbitals i and j in the
+ * DistinctRowTable. The two-body part of the sigma vector is
+ * evaluated through the resolution of the identity
+ *     E_ij E_kl = sum_m E_ij |m><m| E_kl,
+ * so that the four-index contraction becomes a single GEMM.
+ */
+
+#pragma once
+
+#include "../core/clebsch_gordan.hpp"
+#include "../core/integral.hpp"
+#include "../core/iterative_matrix_functions.hpp"
+#include "../core/matrix_functions.hpp"
+#include "../core/parallel_rule.hpp"
+#include "../core/symmetry.hpp"
+#include "../core/threading.hpp"
+#include "../core/utils.hpp"
+#include "guga_drt.hpp"
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace std;
+
+namespace block2 {
+
+// Segment values of the spin-free one-body generator E_ij.
+// The generator is written as E = -sqrt(2) [T(low) x U(high)]^(0), with
+// T / U the creation (a+) or the rank-1/2 annihilation (a~) operator.
+// Segment values are recoupling factors of the partial operator in the
+// sequentially coupled CSF basis (bra = d', ket = d).
+struct GUGASegmentTable {
+    enum SegTypes : uint8_t { Bottom = 0, Middle = 1, Top = 2 };
+    int tbmax = 0;
+    vector<double> data;
+    GUGASegmentTable() {}
+    GUGASegmentTable(int tbmax) : tbmax(tbmax) {
+        SU2CG cg(max(tbmax + 10, 20));
+        data.resize(3 * 2 * 4 * 4 * (tbmax + 1) * 3);
+        for (uint8_t st = 0; st < 3; st++)
+            for (uint8_t op = 0; op < 2; op++)
+                for (uint8_t dp = 0; dp < 4; dp++)
+                    for (uint8_t d = 0; d < 4; d++)
+                        for (int tb = 0; tb <= tbmax; tb++)
+                            for (int db = -1; db <= 1; db++)
+                                data[index(st, op, dp, d, tb, db)] =
+                                    compute(cg, st, op, dp, d, tb, tb + db);
+    }
+    static int occ(uint8_t d) { return d == 0 ? 0 : (d == 3 ? 2 : 1); }
+    // twice spin of upper row from twice spin of lower row
+    static int upper_twos(int tb, uint8_t d) {
+        return d == 1 ? tb + 1 : (d == 2 ? tb - 1 : tb);
+    }
+    // reduced matrix element of a+ (op = 0) or a~ (op = 1) in one orbital
+    static double reduced(uint8_t op, int occp, int occ) {
+        if (op == 0 && occp == 1 && occ == 0)
+            return sqrt(2.0);
+        else if (op == 0 && occp == 2 && occ == 1)
+            return -sqrt(2.0);
+        else if (op == 1 && occp == 0 && occ == 1)
+            return -sqrt(2.0);
+        else if (op == 1 && occp == 1 && occ == 2)
+            return -sqrt(2.0);
+        return 0.0;
+    }
+    // tb / tbp : twice spin of the lower row of ket / bra
+    static double compute(const SU2CG &cg, uint8_t st, uint8_t op, uint8_t dp,
+                          uint8_t d, int tb, int tbp) {
+        const int tj2 = occ(d) == 1, tj2p = occ(dp) == 1;
+        const int tjx = upper_twos(tb, d), tjxp = upper_twos(tbp, dp);
+        if (tb < 0 || tbp < 0 || tjx < 0 || tjxp < 0)
+            return 0.0;
+        if (st == Bottom) {
+            // operator on the orbital, lower part unchanged
+            if (tb != tbp)
+                return 0.0;
+            return (1 - ((tb + tj2 + tjxp + 1) & 2)) *
+                   sqrt((tjx + 1.0) * (tjxp + 1.0)) *
+                   (double)cg.wigner_6j(tj2p, tjxp, tb, tjx, tj2, 1) *
+                   reduced(op, occ(dp), occ(d));
+        } else if (st == Middle) {
+            // operator on the lower part, passing one orbital
+            if (occ(d) != occ(dp))
+                return 0.0;
+            return (1 - ((occ(d) & 1) << 1)) *
+                   (1 - ((tbp + tj2 + tjx + 1) & 2)) *
+                   sqrt((tjx + 1.0) * (tjxp + 1.0)) *
+                   (double)cg.wigner_6j(tbp, tjxp, tj2, tjx, tb, 1);
+        } else {
+            // operators on the lower part and the orbital coupled to zero
+            if (tjx != tjxp)
+                return 0.0;
+            return (1 - ((occ(dp) & 1) << 1)) *
+                   (double)cg.wigner_9j(tbp, tb, 1, tj2p, tj2, 1, tjxp, tjx,
+                                        0) *
+                   sqrt(tjx + 1.0) * reduced(op, occ(dp), occ(d));
+        }
+    }
+    size_t index(uint8_t st, uint8_t op, uint8_t dp, uint8_t d, int tb,
+                 int db) const {
+        return ((((size_t)st * 2 + op) * 4 + dp) * 4 + d) * (tbmax + 1) * 3 +
+               (size_t)tb * 3 + (db + 1);
+    }
+    double operator()(uint8_t st, uint8_t op, uint8_t dp, uint8_t d, int tb,
+                      int tbp) const {
+        if (tb > tbmax || tbp - tb > 1 || tb - tbp > 1)
+            return 0.0;
+        return data[index(st, op, dp, d, tb, tbp - tb)];
+    }
+};
+
+// Coupling coefficients <bra|E_ij|ket> stored as CSR over bra
+struct GUGACouplingList {
+    typedef long long LL;
+    vector<size_t> offsets;
+    vector<LL> kets;
+    vector<uint32_t> pairs;
+    vector<double> values;
+    GUGACouplingList() {}
+    size_t size() const { return values.size(); }
+    void build(vector<vector<pair<LL, pair<uint32_t, double>>>> &elems) {
+        const LL nb = (LL)elems.size();
+        offsets.resize(nb + 1);
+        offsets[0] = 0;
+        for (LL ib = 0; ib < nb; ib++)
+            offsets[ib + 1] = offsets[ib] + elems[ib].size();
+        kets.resize(offsets[nb]);
+        pairs.resize(offsets[nb]);
+        values.resize(offsets[nb]);
+        for (LL ib = 0; ib < nb; ib++) {
+            for (size_t ie = 0; ie < elems[ib].size(); ie++) {
+                kets[offsets[ib] + ie] = elems[ib][ie].first;
+                pairs[offsets[ib] + ie] = elems[ib][ie].second.first;
+                values[offsets[ib] + ie] = elems[ib][ie].second.second;
+            }
+            vector<pair<LL, pair<uint32_t, double>>>().swap(elems[ib]);
+        }
+    }
+};
+
+// Direct CI solver in the CSF space of a DistinctRowTable
+// H = sum_ij h_ij E_ij + 1/2 sum_ijkl (ij|kl) (E_ij E_kl - delta_jk E_il)
+// The intermediate states |m> of the two-body part are single excitations
+// of the CSFs, living in the unrestricted DRT built by ri_table.
+template <typename FL> struct GUGADirectCI {
+    typedef long long LL;
+    typedef typename GMatrix<FL>::FP FP;
+    shared_ptr<DistinctRowTable<void>> drt, ridrt;
+    int n_sites = 0;
+    LL n_csf = 0, n_ri = 0;
+    GUGASegmentTable segs;
+    // <csf|E_ij|m> (CSR over csf) and <m|E_ij|csf> (CSR over m)
+    GUGACouplingList cpl, ricpl;
+    // csf index to intermediate index
+    vector<LL> ri_index;
+    // k_ij = h_ij - 1/2 sum_k (ik|kj) and (ij|kl)
+    vector<FL> kmat, eri;
+    typename const_fl_type<FL>::FL const_e = 0;
+    // <m|E_kl|b> and its contraction with (ij|kl), kept between sigma calls
+    vector<FL> dbuf, gbuf;
+    int iprint = 0;
+    double tcoupling = 0, tsigma = 0;
+    GUGADirectCI(const shared_ptr<DistinctRowTable<void>> &drt) : drt(drt) {
+        n_sites = drt->abc[0][0] + drt->abc[0][1] + drt->abc[0][2];
+        n_csf = drt->xs[0][3];
+    }
+    bool same_space() const { return ridrt == drt; }
+    const GUGACouplingList &ri_couplings() const {
+        return same_space() ? cpl : ricpl;
+    }
+    // DRT (without point group or excitation restrictions) containing all
+    // walks E_kl|csf>: outside the loop of E_kl the rows are those of the
+    // csf, inside they have one electron and one unit of 2S more or less
+    static shared_ptr<DistinctRowTable<void>>
+    ri_table(const shared_ptr<DistinctRowTable<void>> &drt) {
+        typedef array<int16_t, 3> R;
+        // rows ordered by level, then by a and b (descending)
+        const auto cmp = [](const R &p, const R &q) {
+            return p[0] + p[1] + p[2] != q[0] + q[1] + q[2]
+                       ? p[0] + p[1] + p[2] > q[0] + q[1] + q[2]
+                       : (p[0] != q[0] ? p[0] > q[0] : p[1] > q[1]);
+        };
+        const int16_t da[5] = {0, 0, 1, -1, 0}, db[5] = {0, 1, -1, 1, -1};
+        vector<R> rows;
+        rows.reserve(drt->abc.size() * 5);
+        for (auto &r : drt->abc)
+            for (int x = 0; x < 5; x++) {
+                // (a, b, c) with N = 2a + b and level k = a + b + c kept
+                const R p = R{(int16_t)(r[0] + da[x]), (int16_t)(r[1] + db[x]),
+                              (int16_t)(r[2] - da[x] - db[x])};
+                if (p[0] >= 0 && p[1] >= 0 && p[2] >= 0)
+                    rows.push_back(p);
+            }
+        sort(rows.begin(), rows.end(), cmp);
+        rows.resize(unique(rows.begin(), rows.end()) - rows.begin());
+        const int n = (int)rows.size();
+        vector<array<int, 4>> jd(n, array<int, 4>{0, 0, 0, 0});
+        for (int i = 0; i < n; i++)
+            for (int16_t dk = 0; dk < 4; dk++) {
+                const R p = rows[i];
+                const R q = R{(int16_t)(p[0] - (dk >> 1)),
+                              (int16_t)(p[1] - (dk & 1) + (dk >> 1)),
+                              (int16_t)(p[2] - !(dk & 1))};
+                if (q[0] < 0 || q[1] < 0 || q[2] < 0)
+                    continue;
+                auto it = lower_bound(rows.begin() + i + 1, rows.end(), q, cmp);
+                if (it != rows.end() && *it == q)
+                    jd[i][dk] = (int)(it - rows.begin());
+            }
+        // keep rows between the top row and the bottom row
+        const int top = (int)(find(rows.begin(), rows.end(), drt->abc[0]) -
+                              rows.begin());
+        vector<uint8_t> up(n, 0), down(n, 0);
+        up[top] = 1;
+        for (int i = 0; i < n; i++)
+            for (int16_t dk = 0; dk < 4; dk++)
+                if (up[i] && jd[i][dk] != 0)
+                    up[jd[i][dk]] = 1;
+        for (int i = n - 1; i >= 0; i--) {
+            down[i] = rows[i] == R{0, 0, 0};
+            for (int16_t dk = 0; dk < 4; dk++)
+                if (jd[i][dk] != 0 && down[jd[i][dk]])
+                    down[i] = 1;
+        }
+        shared_ptr<DistinctRowTable<void>> r =
+            make_shared<DistinctRowTable<void>>();
+        vector<int> idx(n, 0);
+        for (int i = 0; i < n; i++)
+            if (up[i] && down[i]) {
+                idx[i] = (int)r->abc.size();
+                r->abc.push_back(rows[i]);
+            }
+        const int nr = (int)r->abc.size();
+        r->jd.resize(nr);
+        for (int i = 0; i < n; i++)
+            if (up[i] && down[i])
+                for (int16_t dk = 0; dk < 4; dk++)
+                    r->jd[idx[i]][dk] =
+                        jd[i][dk] != 0 && down[jd[i][dk]] ? idx[jd[i][dk]] : 0;
+        r->xs.resize(nr);
+        for (int i = nr - 1; i >= 0; i--) {
+            r->xs[i] = array<LL, 4>{0, 0, 0, 0};
+            for (int16_t dk = 0; dk < 4; dk++)
+                if (r->jd[i][dk] != 0)
+                    r->xs[i][dk] = r->xs[r->jd[i][dk]][3];
+            for (int16_t dk = 1; dk < 4; dk++)
+                r->xs[i][dk] += r->xs[i][dk - 1];
+            if (r->abc[i] == R{0, 0, 0})
+                r->xs[i][3] = 1;
+        }
+        return r;
+    }
+    // precompute segment tables and coupling coefficients of all
+    // single-excitation loops (parallel over bra walks)
+    void initialize() {
+        Timer t;
+        t.get_time();
+        ridrt = ri_table(drt);
+        if (ridrt->xs[0][3] == n_csf)
+            ridrt = drt;
+        n_ri = ridrt->xs[0][3];
+        int tbmax = 0;
+        for (auto &r : ridrt->abc)
+            tbmax = max(tbmax, (int)r[1]);
+        segs = GUGASegmentTable(tbmax + 1);
+        ri_index.resize(n_csf);
+        vector<vector<pair<LL, pair<uint32_t, double>>>> elems(n_csf);
+        int ntg = threading->activate_global();
+#pragma omp parallel for schedule(dynamic, 16) num_threads(ntg)
+        for (LL ib = 0; ib < n_csf; ib++) {
+            const vector<uint8_t> ds = drt->step_vector_of_index(ib);
+            ri_index[ib] = ridrt->index_of_step_vector(ds);
+            generators(ri_index[ib], ds, elems[ib]);
+        }
+        threading->activate_normal();
+        cpl.build(elems);
+        if (!same_space()) {
+            vector<LL> ci_index(n_ri, -1);
+            for (LL ib = 0; ib < n_csf; ib++)
+                ci_index[ri_index[ib]] = ib;
+            elems.resize(n_ri);
+            ntg = threading->activate_global();
+#pragma omp parallel for schedule(dynamic, 16) num_threads(ntg)
+            for (LL ir = 0; ir < n_ri; ir++) {
+                generators(ir, ridrt->step_vector_of_index(ir), elems[ir]);
+                size_t ix = 0;
+                for (auto &x : elems[ir])
+                    if (ci_index[x.first] != -1)
+                        elems[ir][ix++] =
+                            make_pair(ci_index[x.first], x.second);
+                elems[ir].resize(ix);
+            }
+            threading->activate_normal();
+            ricpl.build(elems);
+        }
+        tcoupling = t.get_time();
+        if (iprint)
+            cout << "GUGADirectCI: n_sites = " << n_sites
+                 << " n_csf = " << n_csf << " n_ri = " << n_ri
+                 << " n_coupling = " << cpl.size() + ricpl.size()
+                 << " T = " << fixed << setprecision(3) << tcoupling << endl;
+    }
+    // all <bra|E_ij|ket> != 0 for a bra walk in ridrt (sorted by ket)
+    void generators(LL ib, const vector<uint8_t> &ds,
+                    vector<pair<LL, pair<uint32_t, double>>> &ex) const {
+        const int n = n_sites;
+        vector<int> rows(n + 1);
+        rows[n] = 0;
+        for (int k = n - 1; k >= 0; k--)
+            rows[k] = ridrt->jd[rows[k + 1]][ds[k]];
+        ex.clear();
+        for (int i = 0; i < n; i++) {
+            const int oi = GUGASegmentTable::occ(ds[i]);
+            if (oi == 0)
+                continue;
+            ex.push_back(make_pair(ib, make_pair(i * n + i, (double)oi)));
+            for (int j = 0; j < n; j++)
+                if (j != i && GUGASegmentTable::occ(ds[j]) != 2)
+                    loops(ib, i, j, ds, rows, ex);
+        }
+        sort(ex.begin(), ex.end());
+    }
+    // all kets |m> with <bra|E_ij|m> != 0 (i != j)
+    void loops(LL ib, int i, int j, const vector<uint8_t> &ds,
+               const vector<int> &rows,
+               vector<pair<LL, pair<uint32_t, double>>> &ex) const {
+        const int low = min(i, j), high = max(i, j);
+        // op at low / high (0 = a+, 1 = a~) and ket occupancy change
+        const uint8_t op_low = i < j ? 0 : 1, op_high = 1 - op_low;
+        const int docc_low = i < j ? -1 : 1, docc_high = -docc_low;
+        const int occ_low = GUGASegmentTable::occ(ds[low]) + docc_low;
+        const int occ_high = GUGASegmentTable::occ(ds[high]) + docc_high;
+        if (occ_low < 0 || occ_low > 2 || occ_high < 0 || occ_high > 2)
+            return;
+        LL bra_w = 0;
+        for (int k = low; k <= high; k++)
+            bra_w += ds[k] == 0 ? 0 : ridrt->xs[rows[k + 1]][ds[k] - 1];
+        const uint32_t ij = (uint32_t)(i * n_sites + j);
+        const auto &abc = ridrt->abc;
+        // depth first search from the top of the loop
+        struct Frame {
+            int k, row;
+            LL w;
+            double v;
+        };
+        vector<Frame> stack;
+        stack.push_back(Frame{high, rows[high + 1], 0, -sqrt(2.0)});
+        while (!stack.empty()) {
+            Frame f = stack.back();
+            stack.pop_back();
+            const int k = f.k;
+            const int tbp = abc[rows[k]][1];
+            for (uint8_t d = 0; d < 4; d++) {
+                const int rl = ridrt->jd[f.row][d];
+                if (rl == 0)
+                    continue;
+                const int oc = GUGASegmentTable::occ(d);
+                double v;
+                if (k == high) {
+                    if (oc != occ_high)
+                        continue;
+                    v = segs(GUGASegmentTable::Top, op_high, ds[k], d,
+                             abc[rl][1], tbp);
+                } else if (k == low) {
+                    if (oc != occ_low || rl != rows[k])
+                        continue;
+                    v = segs(GUGASegmentTable::Bottom, op_low, ds[k], d,
+                             abc[rl][1], tbp);
+                } else
+                    v = segs(GUGASegmentTable::Middle, 0, ds[k], d,
+                             abc[rl][1], tbp);
+                if (v == 0.0)
+                    continue;
+                const LL w = f.w + (d == 0 ? 0 : ridrt->xs[f.row][d - 1]);
+                if (k == low)
+                    ex.push_back(
+                        make_pair(ib - bra_w + w, make_pair(ij, f.v * v)));
+                else
+                    stack.push_back(Frame{k - 1, rl, w, f.v * v});
+            }
+        }
+    }
+    void set_integrals(const shared_ptr<FCIDUMP<FL>> &fcidump) {
+        const int n = n_sites;
+        assert(fcidump->n_sites() == n);
+        const size_t n2 = (size_t)n * n;
+        kmat.resize(n2);
+        eri.resize(n2 * n2);
+        for (int i = 0; i < n; i++)
+            for (int j = 0; j < n; j++) {
+                kmat[i * n + j] = fcidump->t(i, j);
+                for (int k = 0; k < n; k++) {
+                    kmat[i * n + j] -= (FP)0.5 * fcidump->v(i, k, k, j);
+                    for (int l = 0; l < n; l++)
+                        eri[(i * n + j) * n2 + k * n + l] =
+                            fcidump->v(i, j, k, l);
+                }
+            }
+        const_e = fcidump->e();
+    }
+    // d[m][kl] = <m|E_kl|c> (n_ri x n_sites^2)
+    void apply_generators(const FL *c, FL *d) const {
+        const size_t n2 = (size_t)n_sites * n_sites;
+        const GUGACouplingList &rc = ri_couplings();
+        int ntg = threading->activate_global();
+#pragma omp parallel for schedule(dynamic, 64) num_threads(ntg)
+        for (LL ir = 0; ir < n_ri; ir++) {
+            FL *__restrict__ dd = d + ir * n2;
+            memset(dd, 0, sizeof(FL) * n2);
+            for (size_t ie = rc.offsets[ir]; ie < rc.offsets[ir + 1]; ie++)
+                dd[rc.pairs[ie]] += (FP)rc.values[ie] * c[rc.kets[ie]];
+        }
+        threading->activate_normal();
+    }
+    // c += H b
+    void operator()(const GMatrix<FL> &b, const GMatrix<FL> &c) {
+        Timer t;
+        t.get_time();
+        const size_t n2 = (size_t)n_sites * n_sites;
+        dbuf.resize(n_ri * n2), gbuf.resize(n_ri * n2);
+        const FL *__restrict__ d = dbuf.data(), *__restrict__ g = gbuf.data();
+        apply_generators(b.data, dbuf.data());
+        GMatrix<FL> md(dbuf.data(), (MKL_INT)n_ri, (MKL_INT)n2);
+        GMatrix<FL> mg(gbuf.data(), (MKL_INT)n_ri, (MKL_INT)n2);
+        GMatrix<FL> meri((FL *)eri.data(), (MKL_INT)n2, (MKL_INT)n2);
+        threading->activate_global_mkl();
+        GMatrixFunctions<FL>::multiply(md, false, meri, false, mg, 0.5, 0.0);
+        threading->activate_normal();
+        int ntg = threading->activate_global();
+#pragma omp parallel for schedule(dynamic, 64) num_threads(ntg)
+        for (LL ib = 0; ib < n_csf; ib++) {
+            FL r = (FL)const_e * b.data[ib];
+            const FL *__restrict__ dd = d + ri_index[ib] * n2;
+            for (size_t ij = 0; ij < n2; ij++)
+                r += kmat[ij] * dd[ij];
+            for (size_t ie = cpl.offsets[ib]; ie < cpl.offsets[ib + 1]; ie++)
+                r += (FP)cpl.values[ie] * g[cpl.kets[ie] * n2 + cpl.pairs[ie]];
+            c.data[ib] += r;
+        }
+        threading->activate_normal();
+        tsigma += t.get_time();
+    }
+    // diagonal elements <m|H|m>
+    void diag(const GDiagonalMatrix<FL> &aa) const {
+        const size_t n2 = (size_t)n_sites * n_sites;
+        const int n = n_sites;
+        int ntg = threading->activate_global();
+#pragma omp parallel for schedule(dynamic, 64) num_threads(ntg)
+        for (LL ib = 0; ib < n_csf; ib++) {
+            FL r = (FL)const_e;
+            // <m|E_ij E_kl|m> = sum_x <m|E_ij|x> <m|E_lk|x>
+            for (size_t ie = cpl.offsets[ib], je; ie < cpl.offsets[ib + 1];
+                 ie = je) {
+                for (je = ie;
+                     je < cpl.offsets[ib + 1] && cpl.kets[je] == cpl.kets[ie];)
+                    je++;
+                for (size_t p = ie; p < je; p++) {
+                    const int i = cpl.pairs[p] / n, j = cpl.pairs[p] % n;
+                    if (i == j)
+                        r += kmat[cpl.pairs[p]] * (FP)cpl.values[p];
+                    for (size_t q = ie; q < je; q++) {
+                        const int l = cpl.pairs[q] / n, k = cpl.pairs[q] % n;
+                        r += (FP)0.5 * eri[(i * n + j) * n2 + k * n + l] *
+                             (FP)(cpl.values[p] * cpl.values[q]);
+                    }
+                }
+            }
+            aa.data[ib] = r;
+        }
+        threading->activate_normal();
+    }
+    // lowest eigenvalues and CSF coefficients of the hamiltonian
+    vector<FP> davidson(vector<GMatrix<FL>> &vs, FP conv_thrd = 5E-6,
+                        int max_iter = 5000, int deflation_max_size = 50) {
+        vector<FL> adata(n_csf);
+        GDiagonalMatrix<FL> aa(adata.data(), (MKL_INT)n_csf);
+        diag(aa);
+        // initial guess from the lowest diagonal elements
+        vector<LL> idx(n_csf);
+        for (LL i = 0; i < n_csf; i++)
+            idx[i] = i;
+        const int nroots = (int)vs.size();
+        partial_sort(idx.begin(), idx.begin() + min((LL)nroots, n_csf),
+                     idx.end(), [&aa](LL i, LL j) {
+                         return xreal<FL>(aa.data[i]) < xreal<FL>(aa.data[j]);
+                     });
+        for (int i = 0; i < nroots; i++) {
+            FP norm = GMatrixFunctions<FL>::norm(vs[i]);
+            if (norm == 0.0)
+                vs[i].data[idx[i]] = 1.0;
+        }
+        int ndav = 0;
+        vector<FP> r = IterativeMatrixFunctions<FL>::davidson(
+            *this, aa, vs, 0, DavidsonTypes::Normal, ndav, iprint >= 2,
+            (shared_ptr<ParallelCommunicator<SZ>>)nullptr, conv_thrd, 0.0,
+            max_iter, -1, max(2, nroots), max(deflation_max_size, nroots + 10));
+        if (iprint)
+            cout << "GUGADirectCI: n_roots = " << nroots << " n_mult = " << ndav
+                 << " E = " << fixed << setprecision(12) << r[0]
+                 << " Tsigma = " << setprecision(3) << tsigma << endl;
+        return r;
+    }
+    // dm1[i, j] = <bra|E_ij|ket>
+    vector<FL> make_rdm1(const GMatrix<FL> &bra, const GMatrix<FL> &ket) const {
+        const size_t n2 = (size_t)n_sites * n_sites;
+        vector<FL> d(n_ri * n2), r(n2, 0.0);
+        apply_generators(ket.data, d.data());
+        for (LL ib = 0; ib < n_csf; ib++)
+            for (size_t ij = 0; ij < n2; ij++)
+                r[ij] += xconj<FL>(bra.data[ib]) * d[ri_index[ib] * n2 + ij];
+        return r;
+    }
+    // dm2[i, j, k, l] = <bra|E_ij E_kl|ket> - delta_jk <bra|E_il|ket>
+    vector<FL> make_rdm2(const GMatrix<FL> &bra, const GMatrix<FL> &ket) const {
+        const int n = n_sites;
+        const size_t n2 = (size_t)n * n;
+        vector<FL> dk(n_ri * n2), db(n_ri * n2), p(n2 * n2), r(n2 * n2);
+        apply_generators(ket.data, dk.data());
+        apply_generators(bra.data, db.data());
+        GMatrix<FL> mdk(dk.data(), (MKL_INT)n_ri, (MKL_INT)n2);
+        GMatrix<FL> mdb(db.data(), (MKL_INT)n_ri, (MKL_INT)n2);
+        GMatrix<FL> mp(p.data(), (MKL_INT)n2, (MKL_INT)n2);
+        // p[ji, kl] = sum_m conj(<m|E_ji|bra>) <m|E_kl|ket>
+        threading->activate_global_mkl();
+        GMatrixFunctions<FL>::multiply(mdb, 3, mdk, false, mp, 1.0, 0.0);
+        threading->activate_normal();
+        vector<FL> dm1 = make_rdm1(bra, ket);
+        for (int i = 0; i < n; i++)
+            for (int j = 0; j < n; j++)
+                for (int k = 0; k < n; k++)
+                    for (int l = 0; l < n; l++)
+                        r[((i * n + j) * n + k) * n + l] =
+                            p[(j * n + i) * n2 + k * n + l] -
+                            (j == k ? dm1[i * n + l] : (FL)0.0);
+        return r;
+    }
+};
+
+} // namespace block2
@@ -283,6 +283,20 @@ struct DistinctRowTable<S, typename enable_if<is_void<S>::value>::type>
         }
         return r;
     }
+    // inverse of index_of_step_vector
+    vector<uint8_t> step_vector_of_index(LL idx) const {
+        const int n = abc[0][0] + abc[0][1] + abc[0][2];
+        vector<uint8_t> ds(n);
+        for (int i = n - 1, x = 0; i >= 0; i--) {
+            int16_t dk = 3;
+            while (dk > 0 && (jd[x][dk] == 0 || idx < xs[x][dk - 1]))
+                dk--;
+            idx -= dk == 0 ? 0 : xs[x][dk - 1];
+            ds[i] = (uint8_t)dk;
+            x = jd[x][dk];
+        }
+        return ds;
+    }
 };
 
 template <typename S>
@@ -0,0 +1,779 @@
+/*
+ * block2: Efficient MPO implementation of quantum chemistry DMRG
+ * Copyright (C) 2021 Huanchen Zhai <hczhai@caltech.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/** Native execution of WickGraph equations on NDArray tensors. */
+
+#pragma once
+
+#include "../core/threading.hpp"
+#include "../core/utils.hpp"
+#include "nd_array.hpp"
+#include "wick.hpp"
+#include <algorithm>
+#include <cassert>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace block2 {
+
+// Tensor with consecutive groups of fully antisymmetric axes stored
+// as permutation-unique (strictly increasing) index tuples.
+// For example, t[ijab] with groups = {2, 2} only keeps i < j and a < b.
+struct WickPackedTensor {
+    vector<MKL_INT> shape;
+    vector<int> groups;
+    vector<double> data;
+    // first axis, number of tuples, tuples (lexicographic order),
+    // permutations and their signs of each group
+    vector<int> gstart;
+    vector<size_t> gsize;
+    vector<vector<MKL_INT>> gtuples;
+    vector<vector<int>> gperms;
+    vector<vector<int8_t>> gsigns;
+    WickPackedTensor() {}
+    WickPackedTensor(const vector<MKL_INT> &shape, const vector<int> &groups)
+        : shape(shape), groups(groups) {
+        int k = 0;
+        for (auto &g : groups) {
+            if (g <= 0 || k + g > (int)shape.size())
+                throw runtime_error("WickPackedTensor: invalid groups!");
+            for (int j = 1; j < g; j++)
+                if (shape[k + j] != shape[k])
+                    throw runtime_error(
+                        "WickPackedTensor: axes in one group must have the "
+                        "same dimension!");
+            gstart.push_back(k);
+            k += g;
+        }
+        if (k != (int)shape.size())
+            throw runtime_error("WickPackedTensor: groups do not match ndim!");
+        const int ng = (int)groups.size();
+        gsize.resize(ng), gtuples.resize(ng);
+        gperms.resize(ng), gsigns.resize(ng);
+        size_t sz = 1;
+        for (int ig = 0; ig < ng; ig++) {
+            const int kg = groups[ig];
+            const MKL_INT n = shape[gstart[ig]];
+            vector<MKL_INT> x(kg);
+            for (int j = 0; j < kg; j++)
+                x[j] = j;
+            gsize[ig] = 0;
+            while (kg <= n) {
+                gtuples[ig].insert(gtuples[ig].end(), x.begin(), x.end());
+                gsize[ig]++;
+                int j = kg - 1;
+                while (j >= 0 && x[j] == n - kg + j)
+                    j--;
+                if (j < 0)
+                    break;
+                x[j]++;
+                for (int jj = j + 1; jj < kg; jj++)
+                    x[jj] = x[jj - 1] + 1;
+            }
+            vector<int> p(kg);
+            for (int j = 0; j < kg; j++)
+                p[j] = j;
+            do {
+                int ninv = 0;
+                for (int i = 0; i < kg; i++)
+                    for (int j = i + 1; j < kg; j++)
+                        ninv += p[i] > p[j];
+                gperms[ig].insert(gperms[ig].end(), p.begin(), p.end());
+                gsigns[ig].push_back((ninv & 1) ? -1 : 1);
+            } while (next_permutation(p.begin(), p.end()));
+            sz *= gsize[ig];
+        }
+        data.resize(sz, 0.0);
+    }
+    int ndim() const { return (int)shape.size(); }
+    size_t size() const { return data.size(); }
+    size_t dense_size() const {
+        return accumulate(shape.cbegin(), shape.cend(), (size_t)1,
+                          multiplies<size_t>());
+    }
+    // sorted dense index of packed element p
+    void decompose_index(size_t p, vector<MKL_INT> &idx) const {
+        idx.resize(shape.size());
+        for (int ig = (int)groups.size() - 1; ig >= 0; ig--) {
+            const size_t r = p % gsize[ig];
+            p /= gsize[ig];
+            for (int j = 0; j < groups[ig]; j++)
+                idx[gstart[ig] + j] = gtuples[ig][r * groups[ig] + j];
+        }
+    }
+    static WickPackedTensor pack(const NDArray &a, const vector<int> &groups) {
+        WickPackedTensor r(a.shape, groups);
+        r.pack_add(a, 1.0);
+        return r;
+    }
+    NDArray unpack() const { return unpack_range(full_range()); }
+    // [0, n) for every axis
+    vector<pair<MKL_INT, MKL_INT>> full_range() const {
+        vector<pair<MKL_INT, MKL_INT>> r(shape.size());
+        for (int i = 0; i < (int)shape.size(); i++)
+            r[i] = make_pair((MKL_INT)0, shape[i]);
+        return r;
+    }
+    // dense sub-array with axis restricted to [start, stop)
+    // (axis = -1 for the full array)
+    NDArray unpack_slab(int axis, MKL_INT start, MKL_INT stop) const {
+        vector<pair<MKL_INT, MKL_INT>> ranges = full_range();
+        if (axis != -1)
+            ranges[axis] = make_pair(start, stop);
+        return unpack_range(ranges);
+    }
+    // dense sub-array with each axis restricted to [first, second)
+    NDArray unpack_range(const vector<pair<MKL_INT, MKL_INT>> &ranges) const {
+        assert(ranges.size() == shape.size());
+        vector<MKL_INT> xshape(shape.size());
+        for (int i = 0; i < (int)shape.size(); i++)
+            xshape[i] = ranges[i].second - ranges[i].first;
+        NDArray r(xshape);
+        const int ng = (int)groups.size();
+        const size_t sz = data.size();
+        int ntg = threading->activate_global();
+#pragma omp parallel num_threads(ntg)
+        {
+            vector<vector<pair<ssize_t, int8_t>>> offs(ng);
+            vector<size_t> ix(ng);
+#pragma omp for schedule(static)
+            for (size_t p = 0; p < sz; p++) {
+                if (data[p] == 0.0)
+                    continue;
+                size_t px = p;
+                bool ok = true;
+                for (int ig = ng - 1; ig >= 0 && ok; ig--) {
+                    const int kg = groups[ig];
+                    const MKL_INT *tp = &gtuples[ig][(px % gsize[ig]) * kg];
+                    px /= gsize[ig];
+                    offs[ig].clear();
+                    for (size_t ip = 0; ip < gsigns[ig].size(); ip++) {
+                        ssize_t off = 0;
+                        bool valid = true;
+                        for (int j = 0; j < kg && valid; j++) {
+                            const int ax = gstart[ig] + j;
+                            const MKL_INT v = tp[gperms[ig][ip * kg + j]];
+                            valid = v >= ranges[ax].first &&
+                                    v < ranges[ax].second;
+                            off += (v - ranges[ax].first) * r.strides[ax];
+                        }
+                        if (valid)
+                            offs[ig].push_back(
+                                make_pair(off, gsigns[ig][ip]));
+                    }
+                    ok = offs[ig].size() != 0;
+                }
+                if (!ok)
+                    continue;
+                // all combinations of permutations of each group
+                memset(ix.data(), 0, sizeof(size_t) * ng);
+                for (bool more = true; more;) {
+                    ssize_t off = 0;
+                    int sgn = 1;
+                    for (int ig = 0; ig < ng; ig++)
+                        off += offs[ig][ix[ig]].first,
+                            sgn *= offs[ig][ix[ig]].second;
+                    r.data[off] = sgn * data[p];
+                    more = false;
+                    for (int ig = ng - 1; ig >= 0 && !more; ig--)
+                        if (++ix[ig] == offs[ig].size())
+                            ix[ig] = 0;
+                        else
+                            more = true;
+                }
+            }
+        }
+        threading->activate_normal();
+        return r;
+    }
+    // data += alpha * (sorted elements of a), where a is the dense
+    // sub-array with axis restricted to [start, stop)
+    void pack_add(const NDArray &a, double alpha, int axis = -1,
+                  MKL_INT start = 0, MKL_INT stop = 0) {
+        vector<pair<MKL_INT, MKL_INT>> ranges = full_range();
+        if (axis != -1)
+            ranges[axis] = make_pair(start, stop);
+        vector<int> perm(shape.size());
+        for (int i = 0; i < (int)perm.size(); i++)
+            perm[i] = i;
+        pack_add_range(a, alpha, ranges, vector<vector<int>>{perm},
+                       vector<double>{1.0});
+    }
+    // data += alpha * sum_k coeffs[k] * (sorted elements of
+    // a.transpose(perms[k])), where a is the dense sub-array with each axis
+    // restricted to ranges, and elements outside a are taken as zero
+    void pack_add_range(const NDArray &a, double alpha,
+                        const vector<pair<MKL_INT, MKL_INT>> &ranges,
+                        const vector<vector<int>> &perms,
+                        const vector<double> &coeffs) {
+        assert(a.ndim() == ndim() && ranges.size() == shape.size());
+        assert(perms.size() == coeffs.size());
+        const int nd = ndim();
+        const size_t sz = data.size();
+        int ntg = threading->activate_global();
+#pragma omp parallel num_threads(ntg)
+        {
+            vector<MKL_INT> idx;
+#pragma omp for schedule(static)
+            for (size_t p = 0; p < sz; p++) {
+                decompose_index(p, idx);
+                double x = 0;
+                for (size_t k = 0; k < perms.size(); k++) {
+                    ssize_t off = 0;
+                    bool valid = true;
+                    for (int j = 0; j < nd && valid; j++) {
+                        const int ax = perms[k][j];
+                        valid = idx[j] >= ranges[ax].first &&
+                                idx[j] < ranges[ax].second;
+                        off += (idx[j] - ranges[ax].first) * a.strides[ax];
+                    }
+                    if (valid)
+                        x += coeffs[k] * a.data[off];
+                }
+                data[p] += alpha * x;
+            }
+        }
+        threading->activate_normal();
+    }
+    void scale(double d) {
+        for (auto &x : data)
+            x *= d;
+    }
+    // sign of this tensor under transpose(perm), or zero if perm mixes groups
+    int permutation_sign(const vector<int> &perm) const {
+        int sgn = 1;
+        for (int ig = 0; ig < (int)groups.size(); ig++)
+            for (int i = gstart[ig]; i < gstart[ig] + groups[ig]; i++) {
+                if (perm[i] < gstart[ig] || perm[i] >= gstart[ig] + groups[ig])
+                    return 0;
+                for (int j = i + 1; j < gstart[ig] + groups[ig]; j++)
+                    sgn *= perm[i] > perm[j] ? -1 : 1;
+            }
+        return sgn;
+    }
+};
+
+// Profile of one term executed by WickGraphExecutor
+struct WickTermProfile {
+    int istat, iterm;
+    string left, script;
+    double flops, time;
+    // largest dense slab made for packed operands or a packed left
+    size_t dense_size;
+    WickTermProfile() : istat(0), iterm(0), flops(0), time(0), dense_size(0) {}
+};
+
+// Execute the equations in a WickGraph (same semantics as the python code
+// generated by WickGraph::to_einsum) on bound dense or packed tensors.
+// Input tensors are named as in to_einsum, e.g. "vIIEE" / "tIE",
+// output tensors (left) are named without index type suffix.
+// Packed operands are unpacked slab by slab along one or more indices, and
+// contributions to a packed output (including index permutations) are
+// added to the packed data slab by slab, so that the dense copy of a packed
+// tensor does not exceed max_slab_size (or one row, if that is larger).
+// Independent statements are executed in parallel.
+struct WickGraphExecutor {
+    WickGraph graph;
+    map<string, NDArray> dense;
+    map<string, shared_ptr<WickPackedTensor>> packed;
+    map<WickIndexTypes, MKL_INT> type_dims;
+    vector<WickTermProfile> profile;
+    size_t max_slab_size = (size_t)1 << 24;
+    bool parallel_statements = true;
+    int iprint = 0;
+    WickGraphExecutor(const WickGraph &graph) : graph(graph) {}
+    bool is_intermediate(const string &name) const {
+        return name.substr(0, graph.intermediate_name.length()) ==
+               graph.intermediate_name;
+    }
+    // name of the bound tensor for an operand of a term
+    string tensor_key(const WickTensor &wt) const {
+        if (is_intermediate(wt.name))
+            return wt.name;
+        if (wt.type != WickTensorTypes::KroneckerDelta &&
+            wt.type != WickTensorTypes::Tensor)
+            throw runtime_error("WickGraphExecutor: operator " + wt.name +
+                                " cannot be evaluated!");
+        string r = wt.name;
+        for (auto &wi : wt.indices)
+            r += to_str(wi.types);
+        return r;
+    }
+    // names of all tensors required to be bound before execution
+    set<string> input_names() const {
+        set<string> r, lefts;
+        for (auto &wt : graph.left)
+            lefts.insert(wt.name);
+        for (auto &expr : graph.right)
+            for (auto &term : expr.terms)
+                for (auto &wt : term.tensors)
+                    if (wt.type != WickTensorTypes::KroneckerDelta &&
+                        !is_intermediate(wt.name)) {
+                        string key = tensor_key(wt);
+                        if (!lefts.count(key))
+                            r.insert(key);
+                    }
+        return r;
+    }
+    vector<MKL_INT> tensor_shape(const string &key) const {
+        if (dense.count(key))
+            return dense.at(key).shape;
+        else if (packed.count(key))
+            return packed.at(key)->shape;
+        throw runtime_error("WickGraphExecutor: tensor " + key +
+                            " is not bound!");
+    }
+    void register_dims(const WickTensor &wt, const vector<MKL_INT> &shape) {
+        if (shape.size() != wt.indices.size())
+            throw runtime_error("WickGraphExecutor: tensor " + wt.name +
+                                " has wrong number of dimensions!");
+        for (int i = 0; i < (int)shape.size(); i++) {
+            const WickIndexTypes t = wt.indices[i].types;
+            if (type_dims.count(t) && type_dims.at(t) != shape[i])
+                throw runtime_error("WickGraphExecutor: inconsistent "
+                                    "dimension for index type " +
+                                    to_str(t) + " in " + wt.name);
+            type_dims[t] = shape[i];
+        }
+    }
+    MKL_INT index_dim(const WickIndex &wi) const {
+        if (!type_dims.count(wi.types))
+            throw runtime_error(
+                "WickGraphExecutor: unknown dimension for index type " +
+                to_str(wi.types));
+        return type_dims.at(wi.types);
+    }
+    vector<MKL_INT> index_shape(const vector<WickIndex> &idxs) const {
+        vector<MKL_INT> r;
+        for (auto &wi : idxs)
+            r.push_back(index_dim(wi));
+        return r;
+    }
+    static string ones_key(WickIndexTypes t) { return "#ones" + to_str(t); }
+    // bind tensors and allocate outputs / intermediates for one statement
+    // (must be called serially)
+    void prepare(int ix) {
+        for (auto &term : graph.right[ix].terms)
+            for (auto &wt : term.tensors) {
+                const string key = tensor_key(wt);
+                if (dense.count(key) || packed.count(key))
+                    register_dims(wt, tensor_shape(key));
+            }
+        for (auto &term : graph.right[ix].terms)
+            for (auto &wt : term.tensors) {
+                const string key = tensor_key(wt);
+                if (dense.count(key) || packed.count(key))
+                    continue;
+                if (wt.type == WickTensorTypes::KroneckerDelta &&
+                    wt.indices.size() == 2) {
+                    NDArray r(index_shape(wt.indices));
+                    if (wt.indices[0].types == wt.indices[1].types)
+                        for (MKL_INT i = 0; i < r.shape[0]; i++)
+                            r.data[i * r.strides[0] + i * r.strides[1]] = 1.0;
+                    dense[key] = r;
+                } else
+                    throw runtime_error("WickGraphExecutor: tensor " + key +
+                                        " is not bound!");
+            }
+        const WickTensor &lt = graph.left[ix];
+        if (dense.count(lt.name) || packed.count(lt.name))
+            register_dims(lt, tensor_shape(lt.name));
+        else
+            dense[lt.name] = NDArray(index_shape(lt.indices));
+        for (auto &term : graph.right[ix].terms) {
+            set<WickIndex> idxs;
+            for (auto &wt : term.tensors)
+                idxs.insert(wt.indices.begin(), wt.indices.end());
+            for (auto &wi : lt.indices)
+                if (!idxs.count(wi) && !dense.count(ones_key(wi.types))) {
+                    NDArray r(vector<MKL_INT>{index_dim(wi)});
+                    for (MKL_INT i = 0; i < r.shape[0]; i++)
+                        r.data[i] = 1.0;
+                    dense[ones_key(wi.types)] = r;
+                }
+        }
+    }
+    // b += alpha * a
+    static void add_to(const NDArray &a, NDArray &b, double alpha) {
+        assert(a.shape == b.shape);
+        vector<int> idx;
+        if (b.ndim() == 0)
+            b.data[0] += alpha * a.data[0];
+        else if (b.size() == 0)
+            return;
+        else if (b.reorder_c(idx).is_c_order())
+            NDArray::transpose(a, b, {}, alpha, 1.0);
+        else {
+            const size_t sz = b.size();
+            for (size_t i = 0; i < sz; i++)
+                b.data[b.linear_index(i)] += alpha * a.data[a.linear_index(i)];
+        }
+    }
+    // a with the axes of blocked index chars restricted to their slabs
+    static NDArray slice_axes(const NDArray &a, const string &script,
+                              const map<char, pair<MKL_INT, MKL_INT>> &slabs) {
+        vector<NDArraySlice> sl(a.ndim());
+        bool sliced = false;
+        for (int i = 0; i < a.ndim(); i++)
+            if (slabs.count(script[i])) {
+                const pair<MKL_INT, MKL_INT> &r = slabs.at(script[i]);
+                sl[i] = NDArraySlice(r.first, r.second, 1), sliced = true;
+            }
+        return sliced ? a.slice(sl) : a;
+    }
+    // ranges of the axes of a packed tensor restricted to the slabs
+    static vector<pair<MKL_INT, MKL_INT>>
+    slab_ranges(const WickPackedTensor &pt, const string &script,
+                const map<char, pair<MKL_INT, MKL_INT>> &slabs) {
+        vector<pair<MKL_INT, MKL_INT>> r = pt.full_range();
+        for (int i = 0; i < (int)script.size(); i++)
+            if (slabs.count(script[i]))
+                r[i] = slabs.at(script[i]);
+        return r;
+    }
+    // execute one statement (can be called in parallel for
+    // independent statements)
+    void execute_statement(int ix, int iprof) {
+        const WickTensor &lt = graph.left[ix];
+        const bool lpk = packed.count(lt.name);
+        const bool has_maps = graph.index_maps[ix].size() != 1;
+        shared_ptr<WickPackedTensor> lpt =
+            lpk ? packed.at(lt.name) : nullptr;
+        NDArray ldense = lpk ? NDArray() : dense.at(lt.name);
+        const vector<MKL_INT> lshape =
+            lpk ? lpt->shape : ldense.shape;
+        vector<vector<int>> trs;
+        vector<double> tfs;
+        if (has_maps) {
+            const auto &imaps = graph.index_maps[ix];
+            map<string, int> lidx_map;
+            for (int i = 0; i < (int)lt.indices.size(); i++)
+                lidx_map[lt.indices[i].name] = i;
+            trs.resize(imaps.size());
+            for (int ii = 0; ii < (int)imaps.size(); ii++) {
+                trs[ii].resize(lt.indices.size());
+                for (int i = 0; i < (int)lt.indices.size(); i++)
+                    trs[ii][i] = i;
+                for (auto &mr : imaps[ii].second)
+                    trs[ii][lidx_map.at(mr.second)] = lidx_map.at(mr.first);
+                tfs.push_back(imaps[ii].first);
+            }
+        } else if (lpk) {
+            trs.push_back(vector<int>(lshape.size()));
+            for (int i = 0; i < (int)lshape.size(); i++)
+                trs[0][i] = i;
+            tfs.push_back(1.0);
+        }
+        // for a packed left, the permutations are applied to each slab of
+        // contributions directly; the previous content is antisymmetric
+        // in each packed group and only changes by a factor
+        if (lpk && has_maps) {
+            double sc = 0;
+            for (int ii = 0; ii < (int)trs.size(); ii++) {
+                const int sgn = lpt->permutation_sign(trs[ii]);
+                if (sgn == 0)
+                    throw runtime_error(
+                        "WickGraphExecutor: index permutation of " + lt.name +
+                        " is incompatible with packed groups!");
+                sc += sgn * tfs[ii];
+            }
+            lpt->scale(sc);
+        }
+        const string chars =
+            "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+        for (int it = 0; it < (int)graph.right[ix].terms.size();
+             it++, iprof++) {
+            Timer t;
+            t.get_time();
+            const WickString &term = graph.right[ix].terms[it];
+            WickTermProfile &prof = profile[iprof];
+            prof.istat = ix, prof.iterm = it, prof.left = lt.name;
+            double factor = term.factor;
+            vector<const WickTensor *> eff;
+            for (auto &wt : term.tensors)
+                if (wt.indices.size() == 0)
+                    factor *= dense.at(tensor_key(wt)).item();
+                else
+                    eff.push_back(&wt);
+            if (eff.size() == 0) {
+                if (lpk)
+                    throw runtime_error("WickGraphExecutor: constant term "
+                                        "cannot be added to packed " +
+                                        lt.name);
+                NDArray one(ldense.shape);
+                for (size_t i = 0; i < one.size(); i++)
+                    one.data[i] = 1.0;
+                add_to(one, ldense, factor);
+                prof.time = t.get_time();
+                continue;
+            }
+            // einsum script
+            map<WickIndex, char> cmap;
+            auto get_char = [&cmap, &chars](const WickIndex &wi) -> char {
+                if (!cmap.count(wi)) {
+                    if (cmap.size() >= chars.length())
+                        throw runtime_error(
+                            "WickGraphExecutor: too many indices!");
+                    const char c = chars[cmap.size()];
+                    cmap[wi] = c;
+                }
+                return cmap.at(wi);
+            };
+            vector<string> scripts;
+            vector<string> keys;
+            for (auto &pwt : eff) {
+                string s;
+                for (auto &wi : pwt->indices)
+                    s.push_back(get_char(wi));
+                scripts.push_back(s), keys.push_back(tensor_key(*pwt));
+            }
+            string lscript;
+            for (auto &wi : lt.indices) {
+                if (!cmap.count(wi)) {
+                    scripts.push_back(string(1, get_char(wi)));
+                    keys.push_back(ones_key(wi.types));
+                }
+                lscript.push_back(cmap.at(wi));
+            }
+            stringstream ss;
+            for (int i = 0; i < (int)scripts.size(); i++)
+                ss << scripts[i] << (i == (int)scripts.size() - 1 ? "" : ",");
+            ss << "->" << lscript;
+            prof.script = ss.str();
+            map<char, MKL_INT> cdims;
+            for (auto &mc : cmap)
+                cdims[mc.second] = index_dim(mc.first);
+            // estimated flops of pairwise contractions from left to right
+            set<char> cur(scripts[0].begin(), scripts[0].end());
+            for (int i = 1; i < (int)scripts.size(); i++) {
+                cur.insert(scripts[i].begin(), scripts[i].end());
+                double f = 2.0;
+                for (auto &c : cur)
+                    f *= cdims.at(c);
+                prof.flops += f;
+                set<char> rem(lscript.begin(), lscript.end());
+                for (int j = i + 1; j < (int)scripts.size(); j++)
+                    rem.insert(scripts[j].begin(), scripts[j].end());
+                for (auto c = cur.begin(); c != cur.end();)
+                    c = rem.count(*c) ? next(c) : cur.erase(c);
+            }
+            // blocking indices: one index of the packed left and of each
+            // packed operand, so that no packed tensor is fully unpacked
+            auto can_block = [&scripts](char c) {
+                for (auto &s : scripts)
+                    if (count(s.begin(), s.end(), c) > 1)
+                        return false;
+                return true;
+            };
+            auto find_block = [&can_block](const string &s) -> char {
+                for (auto &c : s)
+                    if (can_block(c))
+                        return c;
+                return 0;
+            };
+            vector<char> bcs;
+            vector<int> ipks;
+            for (int i = 0; i < (int)keys.size(); i++)
+                if (packed.count(keys[i]))
+                    ipks.push_back(i);
+            sort(ipks.begin(), ipks.end(), [this, &keys](int i, int j) {
+                return packed.at(keys[i])->dense_size() >
+                       packed.at(keys[j])->dense_size();
+            });
+            if (lpk && find_block(lscript) != 0)
+                bcs.push_back(find_block(lscript));
+            for (auto &i : ipks) {
+                bool found = false;
+                for (auto &c : bcs)
+                    found = found || scripts[i].find(c) != string::npos;
+                if (!found && find_block(scripts[i]) != 0)
+                    bcs.push_back(find_block(scripts[i]));
+            }
+            // slab size of each blocking index, such that one dense slab
+            // of a packed tensor does not exceed max_slab_size
+            const int nbc = (int)bcs.size();
+            vector<MKL_INT> bsz(nbc), bdim(nbc);
+            for (int ib = 0; ib < nbc; ib++) {
+                const char c = bcs[ib];
+                bdim[ib] = cdims.at(c);
+                const size_t xdim = max(bdim[ib], (MKL_INT)1);
+                size_t row_size = 1;
+                if (lpk && lscript.find(c) != string::npos)
+                    row_size = lpt->dense_size() / xdim;
+                for (auto &i : ipks)
+                    if (scripts[i].find(c) != string::npos)
+                        row_size = max(row_size,
+                                       packed.at(keys[i])->dense_size() / xdim);
+                bsz[ib] = max((MKL_INT)1, (MKL_INT)(max_slab_size / row_size));
+            }
+            // unpacked slab of each packed operand, reused while the slabs
+            // of its blocking indices are unchanged
+            map<int, pair<vector<pair<MKL_INT, MKL_INT>>, NDArray>> unpacked;
+            vector<MKL_INT> bst(nbc, 0);
+            for (bool more = true; more;) {
+                map<char, pair<MKL_INT, MKL_INT>> slabs;
+                for (int ib = 0; ib < nbc; ib++)
+                    slabs[bcs[ib]] =
+                        make_pair(bst[ib], min(bst[ib] + bsz[ib], bdim[ib]));
+                vector<NDArray> arrs;
+                for (int i = 0; i < (int)keys.size(); i++)
+                    if (packed.count(keys[i])) {
+                        const WickPackedTensor &pt = *packed.at(keys[i]);
+                        vector<pair<MKL_INT, MKL_INT>> ranges =
+                            slab_ranges(pt, scripts[i], slabs);
+                        if (!unpacked.count(i) ||
+                            unpacked.at(i).first != ranges) {
+                            unpacked.erase(i);
+                            NDArray x = pt.unpack_range(ranges);
+                            prof.dense_size = max(prof.dense_size, x.size());
+                            unpacked[i] = make_pair(ranges, x);
+                        }
+                        arrs.push_back(unpacked.at(i).second);
+                    } else
+                        arrs.push_back(
+                            slice_axes(dense.at(keys[i]), scripts[i], slabs));
+                NDArray r = NDArray::einsum(prof.script, arrs);
+                if (lpk) {
+                    prof.dense_size = max(prof.dense_size, r.size());
+                    lpt->pack_add_range(r, factor,
+                                        slab_ranges(*lpt, lscript, slabs),
+                                        trs, tfs);
+                } else {
+                    NDArray lx = slice_axes(ldense, lscript, slabs);
+                    add_to(r, lx, factor);
+                }
+                more = false;
+                for (int ib = nbc - 1; ib >= 0 && !more; ib--)
+                    if ((bst[ib] += bsz[ib]) >= bdim[ib])
+                        bst[ib] = 0;
+                    else
+                        more = true;
+            }
+            prof.time = t.get_time();
+        }
+        // handle permutations
+        if (has_maps && !lpk) {
+            NDArray x(ldense.shape);
+            NDArray::transpose(ldense, x);
+            for (int ii = 0; ii < (int)trs.size(); ii++)
+                NDArray::transpose(x, ldense, trs[ii], tfs[ii],
+                                   ii == 0 ? 0.0 : 1.0);
+        }
+    }
+    // execute all statements, statements without read / write conflicts
+    // are grouped into levels and executed in parallel
+    void execute() {
+        const int nst = graph.n_terms();
+        vector<set<string>> reads(nst), writes(nst);
+        vector<int> levels(nst, 0), iprofs(nst + 1, 0);
+        for (int ix = 0; ix < nst; ix++) {
+            for (auto &term : graph.right[ix].terms)
+                for (auto &wt : term.tensors)
+                    reads[ix].insert(tensor_key(wt));
+            writes[ix].insert(graph.left[ix].name);
+            iprofs[ix + 1] = iprofs[ix] + (int)graph.right[ix].terms.size();
+            for (int j = 0; j < ix; j++) {
+                bool dep = false;
+                for (auto &w : writes[j])
+                    dep = dep || reads[ix].count(w) || writes[ix].count(w);
+                for (auto &w : writes[ix])
+                    dep = dep || reads[j].count(w);
+                if (dep)
+                    levels[ix] = max(levels[ix], levels[j] + 1);
+            }
+        }
+        // last level using each intermediate
+        map<string, int> xdes;
+        for (int ix = 0; ix < nst; ix++)
+            for (auto &r : reads[ix])
+                if (is_intermediate(r))
+                    xdes[r] = max(xdes.count(r) ? xdes.at(r) : 0, levels[ix]);
+        const int nlevels =
+            nst == 0 ? 0 : *max_element(levels.begin(), levels.end()) + 1;
+        profile.clear();
+        profile.resize(iprofs[nst]);
+        Timer t;
+        t.get_time();
+        for (int il = 0; il < nlevels; il++) {
+            vector<int> ixs;
+            for (int ix = 0; ix < nst; ix++)
+                if (levels[ix] == il)
+                    ixs.push_back(ix), prepare(ix);
+            const int nx = (int)ixs.size();
+            if (parallel_statements && nx > 1) {
+                // the thread counts are process-wide states: they are set
+                // once here, and kernels called inside the parallel region
+                // use a serial copy so that they only write the same values
+                const int ntg = threading->activate_global();
+                shared_ptr<Threading> th = threading;
+                threading = make_shared<Threading>(*th);
+                threading->n_threads_global = threading->n_threads_op = 1;
+                threading->n_threads_mkl = threading->n_threads_quanta = 1;
+                threading->activate_normal();
+                vector<string> errors(nx);
+#pragma omp parallel for schedule(dynamic) num_threads(ntg)
+                for (int i = 0; i < nx; i++) {
+                    try {
+                        execute_statement(ixs[i], iprofs[ixs[i]]);
+                    } catch (const exception &e) {
+                        errors[i] = e.what();
+                    }
+                }
+                threading = th;
+                threading->activate_normal();
+                for (auto &e : errors)
+                    if (e != "")
+                        throw runtime_error(e);
+            } else
+                for (auto &ix : ixs)
+                    execute_statement(ix, iprofs[ix]);
+            // release temp memory
+            for (auto &mx : xdes)
+                if (mx.second == il)
+                    dense.erase(mx.first);
+        }
+        if (iprint) {
+            double tflops = 0, ttime = 0;
+            for (auto &p : profile)
+                tflops += p.flops, ttime += p.time;
+            if (iprint >= 2)
+                for (auto &p : profile)
+                    cout << setw(6) << p.istat << setw(4) << p.iterm << " "
+                         << setw(12) << p.left << " = " << setw(32) << p.script
+                         << " FLOP = " << scientific << setprecision(3)
+                         << p.flops << " T = " << fixed << setprecision(3)
+                         << p.time << endl;
+            cout << "WickGraphExecutor: " << nst << " statements in "
+                 << nlevels << " levels; " << profile.size() << " terms;"
+                 << " FLOP = " << scientific << setprecision(3) << tflops
+                 << " Tterm = " << fixed << setprecision(3) << ttime
+                 << " Twall = " << t.get_time() << endl;
+        }
+    }
+};
+
+} // namespace block2
@@ -29,12 +29,15 @@
 #include "../dmrg/general_hamiltonian.hpp"
 #include "../dmrg/general_mpo.hpp"
 #include "../dmrg/general_npdm.hpp"
+#include "../dmrg/geometry_continuation.hpp"
 #include "../dmrg/moving_environment.hpp"
 #include "../dmrg/mpo.hpp"
 #include "../dmrg/mpo_fusing.hpp"
 #include "../dmrg/mpo_simplification.hpp"
 #include "../dmrg/mps.hpp"
 #include "../dmrg/mps_unfused.hpp"
+#include "../dmrg/orbital_gradient.hpp"
+#include "../dmrg/orbital_rotation.hpp"
 #include "../dmrg/parallel_mpo.hpp"
 #include "../dmrg/parallel_mps.hpp"
 #include "../dmrg/parallel_simple.hpp"
@@ -157,6 +160,18 @@ extern template struct block2::UnfusedMPS<block2::SZ, double>;
 extern template struct block2::SparseTensor<block2::SU2, double>;
 extern template struct block2::UnfusedMPS<block2::SU2, double>;
 
+// orbital_gradient.hpp
+extern template struct block2::OrbitalGradientQC<block2::SZ, double>;
+extern template struct block2::OrbitalGradientQC<block2::SU2, double>;
+
+// orbital_rotation.hpp
+extern template struct block2::OrbitalRotation<block2::SZ, double>;
+extern template struct block2::OrbitalRotation<block2::SU2, double>;
+
+// geometry_continuation.hpp
+extern template struct block2::GeometryContinuation<block2::SZ, double>;
+extern template struct block2::GeometryContinuation<block2::SU2, double>;
+
 // parallel_mpo.hpp
 extern template struct block2::ClassicParallelMPO<block2::SZ, double>;
 extern template struct block2::ParallelMPO<block2::SZ, double>;
@@ -189,10 +204,12 @@ extern template struct block2::HamiltonianQC<block2::SU2, double>;
 extern template struct block2::IdentityMPO<block2::SZ, double>;
 extern template struct block2::SiteMPO<block2::SZ, double>;
 extern template struct block2::MPOQC<block2::SZ, double>;
+extern template struct block2::MPOQCOneBodyRefresh<block2::SZ, double>;
 
 extern template struct block2::IdentityMPO<block2::SU2, double>;
 extern template struct block2::SiteMPO<block2::SU2, double>;
 extern template struct block2::MPOQC<block2::SU2, double>;
+extern template struct block2::MPOQCOneBodyRefresh<block2::SU2, double>;
 
 // qc_ncorr.hpp
 extern template struct block2::NPC1MPOQC<block2::SZ, double>;
@@ -569,6 +586,12 @@ extern template struct block2::UnfusedMPS<block2::SGF, double>;
 extern template struct block2::SparseTensor<block2::SGB, double>;
 extern template struct block2::UnfusedMPS<block2::SGB, double>;
 
+// orbital_rotation.hpp
+extern template struct block2::OrbitalRotation<block2::SGF, double>;
+
+// geometry_continuation.hpp
+extern template struct block2::GeometryContinuation<block2::SGF, double>;
+
 // parallel_mpo.hpp
 extern template struct block2::ClassicParallelMPO<block2::SGF, double>;
 extern template struct block2::ParallelMPO<block2::SGF, double>;
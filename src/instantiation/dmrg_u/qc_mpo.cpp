@@ -23,7 +23,9 @@
 template struct block2::IdentityMPO<block2::SZ, double>;
 template struct block2::SiteMPO<block2::SZ, double>;
 template struct block2::MPOQC<block2::SZ, double>;
+template struct block2::MPOQCOneBodyRefresh<block2::SZ, double>;
 
 template struct block2::IdentityMPO<block2::SU2, double>;
 template struct block2::SiteMPO<block2::SU2, double>;
 template struct block2::MPOQC<block2::SU2, double>;
+template struct block2::MPOQCOneBodyRefresh<block2::SU2, double>;
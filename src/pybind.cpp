@@ -18,6 +18,18 @@
  *
  */
 
+/** Python module ``block2``.
+ *
+ * The bindings are organized in groups, one for each directory suffix in
+ * ``src/pybind`` (``u`` for SU2/SZ, ``uz`` for complex SU2/SZ, ...) plus
+ * the feature groups ``ic`` and ``sci``. In the default build all groups
+ * are bound in the single module ``block2``. With ``-D_SPLIT_PYMODULES``
+ * this file is compiled once for ``block2`` (symmetry-independent part)
+ * and once for each group (``-D_PY_MODULE_GROUP=u`` gives the extension
+ * module ``_block2_u``); the groups are imported on first access of the
+ * corresponding submodule (such as ``block2.su2``).
+ */
+
 #include "pybind/pybind_core.hpp"
 
 #ifdef _USE_DMRG
@@ -43,7 +55,17 @@
 #endif
 #endif
 
-PYBIND11_MODULE(block2, m) {
+// Submodule of block2 with dotted path (such as "cpx.su2")
+static py::module block2_submodule(const py::module &m, const string &path) {
+    py::module r = m;
+    for (auto &x : Parsing::split(path, ".", true))
+        r = r.attr(x.c_str()).cast<py::module>();
+    return r;
+}
+
+#ifndef _PY_MODULE_GROUP
+
+static void bind_module_base(py::module &m) {
 
     m.doc() = "python interface for block2.";
 
@@ -57,203 +79,230 @@ PYBIND11_MODULE(block2, m) {
     bind_fl_data<double>(m, "");
 
 #ifdef _USE_SU2SZ
-    py::module m_su2 = m.def_submodule("su2", "Spin-adapted.");
-    py::module m_sz = m.def_submodule("sz", "Non-spin-adapted.");
+    m.def_submodule("su2", "Spin-adapted.");
+    m.def_submodule("sz", "Non-spin-adapted.");
 #endif
 
 #ifdef _USE_COMPLEX
     py::module m_cpx = m.def_submodule("cpx", "Complex numbers.");
 #ifdef _USE_SU2SZ
-    py::module m_su2_cpx =
-        m_cpx.def_submodule("su2", "Spin-adapted (complex).");
-    py::module m_sz_cpx =
-        m_cpx.def_submodule("sz", "Non-spin-adapted (complex).");
+    m_cpx.def_submodule("su2", "Spin-adapted (complex).");
+    m_cpx.def_submodule("sz", "Non-spin-adapted (complex).");
 #endif
 #endif
 
 #ifdef _USE_SINGLE_PREC
     py::module m_sp = m.def_submodule("sp", "Single precision.");
 #ifdef _USE_SU2SZ
-    py::module m_su2_sp =
-        m_sp.def_submodule("su2", "Spin-adapted (single precision).");
-    py::module m_sz_sp =
-        m_sp.def_submodule("sz", "Non-spin-adapted (single precision).");
+    m_sp.def_submodule("su2", "Spin-adapted (single precision).");
+    m_sp.def_submodule("sz", "Non-spin-adapted (single precision).");
 #endif
 
 #ifdef _USE_COMPLEX
     py::module m_cpx_sp =
         m_sp.def_submodule("cpx", "Complex single precision.");
 #ifdef _USE_SU2SZ
-    py::module m_su2_cpx_sp = m_cpx_sp.def_submodule(
-        "su2", "Spin-adapted (complex single precision).");
-    py::module m_sz_cpx_sp = m_cpx_sp.def_submodule(
-        "sz", "Non-spin-adapted (complex single precision).");
-#endif
+    m_cpx_sp.def_submodule("su2", "Spin-adapted (complex single precision).");
+    m_cpx_sp.def_submodule("sz",
+                           "Non-spin-adapted (complex single precision).");
 #endif
-
 #endif
 
-#ifdef _USE_CORE
-    bind_types<>(m);
-    bind_io<>(m);
-    bind_fl_io<double>(m, "Double");
-    bind_matrix<double>(m);
-    bind_symmetry<>(m);
-    bind_fl_matrix<double>(m);
-    bind_post_matrix<>(m);
-    bind_general_fcidump<double>(m);
-
-#ifdef _USE_SU2SZ
-    bind_core<SU2, double>(m_su2, "SU2", "Double");
-    bind_core<SZ, double>(m_sz, "SZ", "Double");
-    bind_trans_state_info<SU2, SZ>(m_su2, "sz");
-    bind_trans_state_info<SZ, SU2>(m_sz, "su2");
-    bind_trans_state_info_spin_specific<SU2, SZ>(m_su2, "sz");
-#endif
-#ifdef _USE_COMPLEX
-    bind_fl_matrix<complex<double>>(m_cpx);
-    bind_general_fcidump<complex<double>>(m_cpx);
-#ifdef _USE_SU2SZ
-    bind_core<SU2, complex<double>>(m_su2_cpx, "SU2", "Double");
-    bind_core<SZ, complex<double>>(m_sz_cpx, "SZ", "Double");
-#endif
 #endif
 
 #ifdef _USE_KSYMM
-    py::module m_su2k =
-        m.def_submodule("su2k", "Spin-adapted with k symmetry.");
-    py::module m_szk =
-        m.def_submodule("szk", "Non-spin-adapted with k symmetry.");
-    bind_core<SU2K, double>(m_su2k, "SU2K", "Double");
-    bind_core<SZK, double>(m_szk, "SZK", "Double");
-    bind_trans_state_info<SU2K, SZK>(m_su2k, "szk");
-    bind_trans_state_info<SZK, SU2K>(m_szk, "su2k");
-    bind_trans_state_info_spin_specific<SU2K, SZK>(m_su2k, "szk");
+    m.def_submodule("su2k", "Spin-adapted with k symmetry.");
+    m.def_submodule("szk", "Non-spin-adapted with k symmetry.");
 #ifdef _USE_COMPLEX
-    py::module m_su2k_cpx =
-        m_cpx.def_submodule("su2k", "Spin-adapted with k symmetry (complex).");
-    py::module m_szk_cpx = m_cpx.def_submodule(
-        "szk", "Non-spin-adapted with k symmetry (complex).");
-    bind_core<SU2K, complex<double>>(m_su2k_cpx, "SU2K", "Double");
-    bind_core<SZK, complex<double>>(m_szk_cpx, "SZK", "Double");
+    m_cpx.def_submodule("su2k", "Spin-adapted with k symmetry (complex).");
+    m_cpx.def_submodule("szk", "Non-spin-adapted with k symmetry (complex).");
 #endif
 #endif
 
 #ifdef _USE_SG
-    py::module m_sgf = m.def_submodule("sgf", "General spin (fermionic).");
-    py::module m_sgb = m.def_submodule("sgb", "General spin (bosonic).");
-    bind_core<SGF, double>(m_sgf, "SGF", "Double");
-    bind_core<SGB, double>(m_sgb, "SGB", "Double");
-
-#ifdef _USE_SU2SZ
-    bind_trans_state_info<SZ, SGF>(m_sz, "sgf");
-    bind_trans_state_info<SGF, SZ>(m_sgf, "sz");
-    bind_trans_state_info_spin_specific<SZ, SGF>(m_sz, "sgf");
+    m.def_submodule("sgf", "General spin (fermionic).");
+    m.def_submodule("sgb", "General spin (bosonic).");
+#ifdef _USE_COMPLEX
+    m_cpx.def_submodule("sgf", "General spin (fermionic, complex).");
+    m_cpx.def_submodule("sgb", "General spin (bosonic, complex).");
 #endif
+#ifdef _USE_SINGLE_PREC
+    m_sp.def_submodule("sgf", "General spin (fermionic single precision).");
+    m_sp.def_submodule("sgb", "General spin (bosonic single precision).");
 #ifdef _USE_COMPLEX
-    py::module m_sgf_cpx =
-        m_cpx.def_submodule("sgf", "General spin (fermionic, complex).");
-    py::module m_sgb_cpx =
-        m_cpx.def_submodule("sgb", "General spin (bosonic, complex).");
-    bind_core<SGF, complex<double>>(m_sgf_cpx, "SGF", "Double");
-    bind_core<SGB, complex<double>>(m_sgb_cpx, "SGB", "Double");
+    m_cpx_sp.def_submodule(
+        "sgf", "General spin (fermionic, complex single precision).");
+    m_cpx_sp.def_submodule(
+        "sgb", "General spin (bosonic, complex single precision).");
+#endif
 #endif
 #endif
 
 #ifdef _USE_SANY
-    py::module m_sany = m.def_submodule("sany", "Any symmetry.");
-    bind_core<SAny, double>(m_sany, "SAny", "Double");
+    m.def_submodule("sany", "Any symmetry.");
 #ifdef _USE_COMPLEX
-    py::module m_sany_cpx =
-        m_cpx.def_submodule("sany", "Any symmetry (complex).");
-    bind_core<SAny, complex<double>>(m_sany_cpx, "SAny", "Double");
+    m_cpx.def_submodule("sany", "Any symmetry (complex).");
 #endif
 #endif
 
-#ifdef _USE_SINGLE_PREC
+#ifdef _USE_CORE
+    bind_types<>(m);
+    bind_io<>(m);
+    bind_fl_io<double>(m, "Double");
+    bind_matrix<double>(m);
+    bind_symmetry<>(m);
+    bind_fl_matrix<double>(m);
+    bind_post_matrix<>(m);
+    bind_general_fcidump<double>(m);
+#endif
+}
+
+// The symmetry-independent bindings are split by number type, such that
+// the default build can bind them at the same positions relative to the
+// symmetry groups as before the split (z: complex, s: single precision,
+// c: complex single precision)
+
+static void bind_core_base_z(py::module &m) {
+#if defined(_USE_CORE) && defined(_USE_COMPLEX)
+    py::module m_cpx = block2_submodule(m, "cpx");
+    bind_fl_matrix<complex<double>>(m_cpx);
+    bind_general_fcidump<complex<double>>(m_cpx);
+#endif
+}
 
+static void bind_core_base_s(py::module &m) {
+#if defined(_USE_CORE) && defined(_USE_SINGLE_PREC)
+    py::module m_sp = block2_submodule(m, "sp");
     bind_fl_io<float>(m, "Float");
     bind_matrix<float>(m_sp);
     bind_fl_matrix<float>(m_sp);
     bind_general_fcidump<float>(m_sp);
-
-#ifdef _USE_SU2SZ
-    bind_core<SU2, float>(m_su2_sp, "SU2", "Float");
-    bind_core<SZ, float>(m_sz_sp, "SZ", "Float");
-
-    bind_trans_sparse_matrix<SU2, float, double>(m_su2_sp, "double");
-    bind_trans_sparse_matrix<SU2, double, float>(m_su2, "float");
-    bind_trans_sparse_matrix<SZ, float, double>(m_sz_sp, "double");
-    bind_trans_sparse_matrix<SZ, double, float>(m_sz, "float");
 #endif
-#ifdef _USE_COMPLEX
+}
+
+static void bind_core_base_c(py::module &m) {
+#if defined(_USE_CORE) && defined(_USE_SINGLE_PREC) && defined(_USE_COMPLEX)
+    py::module m_cpx_sp = block2_submodule(m, "sp.cpx");
     bind_fl_matrix<complex<float>>(m_cpx_sp);
     bind_general_fcidump<complex<float>>(m_cpx_sp);
-#ifdef _USE_SU2SZ
-    bind_core<SU2, complex<float>>(m_su2_cpx_sp, "SU2", "Float");
-    bind_core<SZ, complex<float>>(m_sz_cpx_sp, "SZ", "Float");
-
-    bind_trans_sparse_matrix<SU2, complex<float>, complex<double>>(m_su2_cpx_sp,
-                                                                   "double");
-    bind_trans_sparse_matrix<SU2, complex<double>, complex<float>>(m_su2_cpx,
-                                                                   "float");
-    bind_trans_sparse_matrix<SZ, complex<float>, complex<double>>(m_sz_cpx_sp,
-                                                                  "double");
-    bind_trans_sparse_matrix<SZ, complex<double>, complex<float>>(m_sz_cpx,
-                                                                  "float");
 #endif
+}
+
+static void bind_dmrg_base(py::module &m) {
+#ifdef _USE_DMRG
+    bind_dmrg_types<>(m);
+    bind_dmrg_io<>(m);
+    bind_partition_weights<double>(m);
+    bind_fl_dmrg<double>(m);
 #endif
+}
 
-#ifdef _USE_SG
-    py::module m_sgf_sp =
-        m_sp.def_submodule("sgf", "General spin (fermionic single precision).");
-    py::module m_sgb_sp =
-        m_sp.def_submodule("sgb", "General spin (bosonic single precision).");
-    bind_core<SGF, float>(m_sgf_sp, "SGF", "Float");
-    bind_core<SGB, float>(m_sgb_sp, "SGB", "Float");
+static void bind_dmrg_base_z(py::module &m) {
+#if defined(_USE_DMRG) && defined(_USE_COMPLEX)
+    py::module m_cpx = block2_submodule(m, "cpx");
+    bind_fl_dmrg<complex<double>>(m_cpx);
+#endif
+}
 
-    bind_trans_sparse_matrix<SGF, float, double>(m_sgf_sp, "double");
-    bind_trans_sparse_matrix<SGF, double, float>(m_sgf, "float");
-    bind_trans_sparse_matrix<SGB, float, double>(m_sgb_sp, "double");
-    bind_trans_sparse_matrix<SGB, double, float>(m_sgb, "float");
+static void bind_dmrg_base_s(py::module &m) {
+#if defined(_USE_DMRG) && defined(_USE_SINGLE_PREC)
+    py::module m_sp = block2_submodule(m, "sp");
+    bind_partition_weights<float>(m_sp);
+    bind_fl_dmrg<float>(m_sp);
 #ifdef _USE_COMPLEX
-    py::module m_sgf_cpx_sp = m_cpx_sp.def_submodule(
-        "sgf", "General spin (fermionic, complex single precision).");
-    py::module m_sgb_cpx_sp = m_cpx_sp.def_submodule(
-        "sgb", "General spin (bosonic, complex single precision).");
-    bind_core<SGF, complex<float>>(m_sgf_cpx_sp, "SGF", "Float");
-    bind_core<SGB, complex<float>>(m_sgb_cpx_sp, "SGB", "Float");
-
-    bind_trans_sparse_matrix<SGF, complex<float>, complex<double>>(m_sgf_cpx_sp,
-                                                                   "double");
-    bind_trans_sparse_matrix<SGF, complex<double>, complex<float>>(m_sgf_cpx,
-                                                                   "float");
-    bind_trans_sparse_matrix<SGB, complex<float>, complex<double>>(m_sgb_cpx_sp,
-                                                                   "double");
-    bind_trans_sparse_matrix<SGB, complex<double>, complex<float>>(m_sgb_cpx,
-                                                                   "float");
+    py::module m_cpx_sp = block2_submodule(m, "sp.cpx");
+    bind_fl_dmrg<complex<float>>(m_cpx_sp);
 #endif
 #endif
+}
 
 #endif
 
+#if defined(_USE_SU2SZ) && \
+    (!defined(_SPLIT_PYMODULES) || defined(_PY_MODULE_GROUP_U))
+
+static void bind_core_u(py::module &m) {
+#ifdef _USE_CORE
+    py::module m_su2 = block2_submodule(m, "su2");
+    py::module m_sz = block2_submodule(m, "sz");
+    bind_core<SU2, double>(m_su2, "SU2", "Double");
+    bind_core<SZ, double>(m_sz, "SZ", "Double");
+    bind_fl_block_sparse<SZ, double>(m_sz);
+    bind_trans_state_info<SU2, SZ>(m_su2, "sz");
+    bind_trans_state_info<SZ, SU2>(m_sz, "su2");
+    bind_trans_state_info_spin_specific<SU2, SZ>(m_su2, "sz");
 #endif
+}
 
+static void bind_dmrg_u(py::module &m) {
 #ifdef _USE_DMRG
-    bind_dmrg_types<>(m);
-    bind_dmrg_io<>(m);
-    bind_partition_weights<double>(m);
-    bind_fl_dmrg<double>(m);
-#ifdef _USE_SU2SZ
+    py::module m_su2 = block2_submodule(m, "su2");
+    py::module m_sz = block2_submodule(m, "sz");
     bind_dmrg<SU2, double>(m_su2, "SU2");
     bind_dmrg<SZ, double>(m_sz, "SZ");
     bind_trans_mps<SU2, SZ>(m_su2, "sz");
     bind_trans_mps<SZ, SU2>(m_sz, "su2");
     bind_fl_trans_mps_spin_specific<SU2, SZ, double>(m_su2, "sz");
 #endif
-#ifdef _USE_COMPLEX
-    bind_fl_dmrg<complex<double>>(m_cpx);
-#ifdef _USE_SU2SZ
+}
+
+static void bind_extra_u(py::module &m) {
+    py::module m_su2 = block2_submodule(m, "su2");
+    py::module m_sz = block2_submodule(m, "sz");
+#ifdef _USE_BIG_SITE
+    bind_fl_big_site<SU2, double>(m_su2);
+    bind_fl_hamiltonian_big_site<SU2, double>(m_su2);
+    bind_fl_dmrg_big_site<SU2, double, double>(m_su2);
+    bind_fl_big_site<SZ, double>(m_sz);
+    bind_fl_hamiltonian_big_site<SZ, double>(m_sz);
+    bind_fl_dmrg_big_site<SZ, double, double>(m_sz);
+
+    bind_fl_sci_big_site_fock<SZ, double>(m_sz);
+    bind_fl_csf_big_site<SU2, double>(m_su2);
+
+    bind_drt_big_site<SZ>(m_sz);
+    bind_drt_big_site<SU2>(m_su2);
+
+    bind_fl_drt_big_site<SZ, double>(m_sz);
+    bind_fl_drt_big_site<SU2, double>(m_su2);
+#endif
+#ifdef _USE_SP_DMRG
+    bind_fl_sp_dmrg<SU2, double>(m_su2);
+    bind_fl_sp_dmrg<SZ, double>(m_sz);
+#endif
+}
+
+#ifdef _PY_MODULE_GROUP
+
+static void bind_group_u(py::module &m) {
+    bind_core_u(m);
+    bind_dmrg_u(m);
+    bind_extra_u(m);
+}
+
+#endif
+
+#endif
+
+#if defined(_USE_SU2SZ) && defined(_USE_COMPLEX) && \
+    (!defined(_SPLIT_PYMODULES) || defined(_PY_MODULE_GROUP_UZ))
+
+static void bind_core_uz(py::module &m) {
+#ifdef _USE_CORE
+    py::module m_su2_cpx = block2_submodule(m, "cpx.su2");
+    py::module m_sz_cpx = block2_submodule(m, "cpx.sz");
+    bind_core<SU2, complex<double>>(m_su2_cpx, "SU2", "Double");
+    bind_core<SZ, complex<double>>(m_sz_cpx, "SZ", "Double");
+    bind_fl_block_sparse<SZ, complex<double>>(m_sz_cpx);
+#endif
+}
+
+static void bind_dmrg_uz(py::module &m) {
+#ifdef _USE_DMRG
+    py::module m_su2 = block2_submodule(m, "su2");
+    py::module m_sz = block2_submodule(m, "sz");
+    py::module m_su2_cpx = block2_submodule(m, "cpx.su2");
+    py::module m_sz_cpx = block2_submodule(m, "cpx.sz");
     bind_dmrg<SU2, complex<double>>(m_su2_cpx, "SU2");
     bind_dmrg<SZ, complex<double>>(m_sz_cpx, "SZ");
     bind_fl_trans_mps_spin_specific<SU2, SZ, complex<double>>(m_su2_cpx, "sz");
@@ -263,65 +312,44 @@ PYBIND11_MODULE(block2, m) {
     bind_fl_trans_mps<SZ, complex<double>, double>(m_sz_cpx, "real");
     bind_fl_trans_mps<SZ, double, complex<double>>(m_sz, "complex");
 #endif
-#endif
+}
 
-#ifdef _USE_KSYMM
-    bind_dmrg<SU2K, double>(m_su2k, "SU2K");
-    bind_dmrg<SZK, double>(m_szk, "SZK");
-    bind_trans_mps<SU2K, SZK>(m_su2k, "szk");
-    bind_trans_mps<SZK, SU2K>(m_szk, "su2k");
-    bind_fl_trans_mps_spin_specific<SU2K, SZK, double>(m_su2k, "szk");
-#ifdef _USE_COMPLEX
-    bind_dmrg<SU2K, complex<double>>(m_su2k_cpx, "SU2K");
-    bind_dmrg<SZK, complex<double>>(m_szk_cpx, "SZK");
-    bind_fl_trans_mps_spin_specific<SU2K, SZK, complex<double>>(m_su2k_cpx,
-                                                                "szk");
-#endif
-#endif
+#ifdef _PY_MODULE_GROUP
 
-#ifdef _USE_SG
-    bind_dmrg<SGF, double>(m_sgf, "SGF");
-    bind_dmrg<SGB, double>(m_sgb, "SGB");
-#ifdef _USE_SU2SZ
-    bind_trans_mps<SZ, SGF>(m_sz, "sgf");
-    bind_trans_mps<SGF, SZ>(m_sgf, "sz");
-    bind_fl_trans_mps_spin_specific<SZ, SGF, double>(m_sz, "sgf");
-#endif
-#ifdef _USE_COMPLEX
-    bind_dmrg<SGF, complex<double>>(m_sgf_cpx, "SGF");
-    bind_dmrg<SGB, complex<double>>(m_sgb_cpx, "SGB");
-#ifdef _USE_SU2SZ
-    bind_fl_trans_mps_spin_specific<SZ, SGF, complex<double>>(m_sz_cpx, "sgf");
+static void bind_group_uz(py::module &m) {
+    bind_core_uz(m);
+    bind_dmrg_uz(m);
+}
 
-    bind_fl_trans_mps<SGF, complex<double>, double>(m_su2_cpx, "real");
-    bind_fl_trans_mps<SGF, double, complex<double>>(m_su2, "complex");
-    bind_fl_trans_mps<SGB, complex<double>, double>(m_sz_cpx, "real");
-    bind_fl_trans_mps<SGB, double, complex<double>>(m_sz, "complex");
-#endif
-#endif
 #endif
 
-#ifdef _USE_SANY
-    bind_dmrg<SAny, double>(m_sany, "SAny");
-    bind_trans_mps<SAny, SAny>(m_sany, "sany");
-    bind_trans_multi_mps<SAny, SAny>(m_sany, "sany");
-    bind_fl_trans_mps_spin_specific<SAny, SAny, double>(m_sany, "sany");
-    bind_fl_trans_mpo<SAny, SAny, double>(m_sany, "sany");
-#ifdef _USE_COMPLEX
-    bind_dmrg<SAny, complex<double>>(m_sany_cpx, "SAny");
-    bind_fl_trans_mps_spin_specific<SAny, SAny, complex<double>>(m_sany_cpx,
-                                                                 "sany");
-    bind_fl_trans_mpo<SAny, SAny, complex<double>>(m_sany_cpx, "sany");
-#endif
 #endif
 
-#ifdef _USE_SINGLE_PREC
-    bind_partition_weights<float>(m_sp);
-    bind_fl_dmrg<float>(m_sp);
-#ifdef _USE_COMPLEX
-    bind_fl_dmrg<complex<float>>(m_cpx_sp);
+#if defined(_USE_SU2SZ) && defined(_USE_SINGLE_PREC) && \
+    (!defined(_SPLIT_PYMODULES) || defined(_PY_MODULE_GROUP_US))
+
+static void bind_core_us(py::module &m) {
+#ifdef _USE_CORE
+    py::module m_su2 = block2_submodule(m, "su2");
+    py::module m_sz = block2_submodule(m, "sz");
+    py::module m_su2_sp = block2_submodule(m, "sp.su2");
+    py::module m_sz_sp = block2_submodule(m, "sp.sz");
+    bind_core<SU2, float>(m_su2_sp, "SU2", "Float");
+    bind_core<SZ, float>(m_sz_sp, "SZ", "Float");
+
+    bind_trans_sparse_matrix<SU2, float, double>(m_su2_sp, "double");
+    bind_trans_sparse_matrix<SU2, double, float>(m_su2, "float");
+    bind_trans_sparse_matrix<SZ, float, double>(m_sz_sp, "double");
+    bind_trans_sparse_matrix<SZ, double, float>(m_sz, "float");
 #endif
-#ifdef _USE_SU2SZ
+}
+
+static void bind_dmrg_us(py::module &m) {
+#ifdef _USE_DMRG
+    py::module m_su2 = block2_submodule(m, "su2");
+    py::module m_sz = block2_submodule(m, "sz");
+    py::module m_su2_sp = block2_submodule(m, "sp.su2");
+    py::module m_sz_sp = block2_submodule(m, "sp.sz");
     bind_dmrg<SU2, float>(m_su2_sp, "SU2");
     bind_dmrg<SZ, float>(m_sz_sp, "SZ");
     bind_fl_trans_mps_spin_specific<SU2, SZ, float>(m_su2_sp, "sz");
@@ -330,8 +358,53 @@ PYBIND11_MODULE(block2, m) {
     bind_fl_trans_mps<SU2, double, float>(m_su2, "float");
     bind_fl_trans_mps<SZ, float, double>(m_sz_sp, "double");
     bind_fl_trans_mps<SZ, double, float>(m_sz, "float");
-#ifdef _USE_COMPLEX
-    bind_dmrg<SU2, complex<float>>(m_su2_cpx_sp, "SU2");
+#endif
+}
+
+#ifdef _PY_MODULE_GROUP
+
+static void bind_group_us(py::module &m) {
+    bind_core_us(m);
+    bind_dmrg_us(m);
+}
+
+#endif
+
+#endif
+
+#if defined(_USE_SU2SZ) && defined(_USE_SINGLE_PREC) && \
+    defined(_USE_COMPLEX) && \
+    (!defined(_SPLIT_PYMODULES) || defined(_PY_MODULE_GROUP_UC))
+
+static void bind_core_uc(py::module &m) {
+#ifdef _USE_CORE
+    py::module m_su2_cpx = block2_submodule(m, "cpx.su2");
+    py::module m_sz_cpx = block2_submodule(m, "cpx.sz");
+    py::module m_su2_cpx_sp = block2_submodule(m, "sp.cpx.su2");
+    py::module m_sz_cpx_sp = block2_submodule(m, "sp.cpx.sz");
+    bind_core<SU2, complex<float>>(m_su2_cpx_sp, "SU2", "Float");
+    bind_core<SZ, complex<float>>(m_sz_cpx_sp, "SZ", "Float");
+
+    bind_trans_sparse_matrix<SU2, complex<float>, complex<double>>(m_su2_cpx_sp,
+                                                                   "double");
+    bind_trans_sparse_matrix<SU2, complex<double>, complex<float>>(m_su2_cpx,
+                                                                   "float");
+    bind_trans_sparse_matrix<SZ, complex<float>, complex<double>>(m_sz_cpx_sp,
+                                                                  "double");
+    bind_trans_sparse_matrix<SZ, complex<double>, complex<float>>(m_sz_cpx,
+                                                                  "float");
+#endif
+}
+
+static void bind_dmrg_uc(py::module &m) {
+#ifdef _USE_DMRG
+    py::module m_su2_sp = block2_submodule(m, "sp.su2");
+    py::module m_sz_sp = block2_submodule(m, "sp.sz");
+    py::module m_su2_cpx = block2_submodule(m, "cpx.su2");
+    py::module m_sz_cpx = block2_submodule(m, "cpx.sz");
+    py::module m_su2_cpx_sp = block2_submodule(m, "sp.cpx.su2");
+    py::module m_sz_cpx_sp = block2_submodule(m, "sp.cpx.sz");
+    bind_dmrg<SU2, complex<float>>(m_su2_cpx_sp, "SU2");
     bind_dmrg<SZ, complex<float>>(m_sz_cpx_sp, "SZ");
     bind_fl_trans_mps_spin_specific<SU2, SZ, complex<float>>(m_su2_cpx_sp,
                                                              "sz");
@@ -348,13 +421,220 @@ PYBIND11_MODULE(block2, m) {
     bind_fl_trans_mps<SZ, complex<float>, float>(m_sz_cpx_sp, "real");
     bind_fl_trans_mps<SZ, float, complex<float>>(m_sz_sp, "complex");
 #endif
+}
+
+#ifdef _PY_MODULE_GROUP
+
+static void bind_group_uc(py::module &m) {
+    bind_core_uc(m);
+    bind_dmrg_uc(m);
+}
+
+#endif
+
 #endif
 
-#ifdef _USE_SG
+#if defined(_USE_KSYMM) && \
+    (!defined(_SPLIT_PYMODULES) || defined(_PY_MODULE_GROUP_K))
+
+static void bind_core_k(py::module &m) {
+#ifdef _USE_CORE
+    py::module m_su2k = block2_submodule(m, "su2k");
+    py::module m_szk = block2_submodule(m, "szk");
+    bind_core<SU2K, double>(m_su2k, "SU2K", "Double");
+    bind_core<SZK, double>(m_szk, "SZK", "Double");
+    bind_trans_state_info<SU2K, SZK>(m_su2k, "szk");
+    bind_trans_state_info<SZK, SU2K>(m_szk, "su2k");
+    bind_trans_state_info_spin_specific<SU2K, SZK>(m_su2k, "szk");
+#endif
+}
+
+static void bind_dmrg_k(py::module &m) {
+#ifdef _USE_DMRG
+    py::module m_su2k = block2_submodule(m, "su2k");
+    py::module m_szk = block2_submodule(m, "szk");
+    bind_dmrg<SU2K, double>(m_su2k, "SU2K");
+    bind_dmrg<SZK, double>(m_szk, "SZK");
+    bind_trans_mps<SU2K, SZK>(m_su2k, "szk");
+    bind_trans_mps<SZK, SU2K>(m_szk, "su2k");
+    bind_fl_trans_mps_spin_specific<SU2K, SZK, double>(m_su2k, "szk");
+#endif
+}
+
+static void bind_extra_k(py::module &m) {
+#if defined(_USE_SP_DMRG) && defined(_USE_SU2SZ)
+    py::module m_su2k = block2_submodule(m, "su2k");
+    py::module m_szk = block2_submodule(m, "szk");
+    bind_fl_sp_dmrg<SU2K, double>(m_su2k);
+    bind_fl_sp_dmrg<SZK, double>(m_szk);
+#endif
+}
+
+#ifdef _PY_MODULE_GROUP
+
+static void bind_group_k(py::module &m) {
+    bind_core_k(m);
+    bind_dmrg_k(m);
+    bind_extra_k(m);
+}
+
+#endif
+
+#endif
+
+#if defined(_USE_KSYMM) && defined(_USE_COMPLEX) && \
+    (!defined(_SPLIT_PYMODULES) || defined(_PY_MODULE_GROUP_KZ))
+
+static void bind_core_kz(py::module &m) {
+#ifdef _USE_CORE
+    py::module m_su2k_cpx = block2_submodule(m, "cpx.su2k");
+    py::module m_szk_cpx = block2_submodule(m, "cpx.szk");
+    bind_core<SU2K, complex<double>>(m_su2k_cpx, "SU2K", "Double");
+    bind_core<SZK, complex<double>>(m_szk_cpx, "SZK", "Double");
+#endif
+}
+
+static void bind_dmrg_kz(py::module &m) {
+#ifdef _USE_DMRG
+    py::module m_su2k_cpx = block2_submodule(m, "cpx.su2k");
+    py::module m_szk_cpx = block2_submodule(m, "cpx.szk");
+    bind_dmrg<SU2K, complex<double>>(m_su2k_cpx, "SU2K");
+    bind_dmrg<SZK, complex<double>>(m_szk_cpx, "SZK");
+    bind_fl_trans_mps_spin_specific<SU2K, SZK, complex<double>>(m_su2k_cpx,
+                                                                "szk");
+#endif
+}
+
+#ifdef _PY_MODULE_GROUP
+
+static void bind_group_kz(py::module &m) {
+    bind_core_kz(m);
+    bind_dmrg_kz(m);
+}
+
+#endif
+
+#endif
+
+#if defined(_USE_SG) && \
+    (!defined(_SPLIT_PYMODULES) || defined(_PY_MODULE_GROUP_G))
+
+static void bind_core_g(py::module &m) {
+#ifdef _USE_CORE
+    py::module m_sgf = block2_submodule(m, "sgf");
+    py::module m_sgb = block2_submodule(m, "sgb");
+    bind_core<SGF, double>(m_sgf, "SGF", "Double");
+    bind_core<SGB, double>(m_sgb, "SGB", "Double");
+
+#ifdef _USE_SU2SZ
+    py::module m_sz = block2_submodule(m, "sz");
+    bind_trans_state_info<SZ, SGF>(m_sz, "sgf");
+    bind_trans_state_info<SGF, SZ>(m_sgf, "sz");
+    bind_trans_state_info_spin_specific<SZ, SGF>(m_sz, "sgf");
+#endif
+#endif
+}
+
+static void bind_dmrg_g(py::module &m) {
+#ifdef _USE_DMRG
+    py::module m_sgf = block2_submodule(m, "sgf");
+    py::module m_sgb = block2_submodule(m, "sgb");
+    bind_dmrg<SGF, double>(m_sgf, "SGF");
+    bind_dmrg<SGB, double>(m_sgb, "SGB");
+#ifdef _USE_SU2SZ
+    py::module m_sz = block2_submodule(m, "sz");
+    bind_trans_mps<SZ, SGF>(m_sz, "sgf");
+    bind_trans_mps<SGF, SZ>(m_sgf, "sz");
+    bind_fl_trans_mps_spin_specific<SZ, SGF, double>(m_sz, "sgf");
+#endif
+#endif
+}
+
+#ifdef _PY_MODULE_GROUP
+
+static void bind_group_g(py::module &m) {
+    bind_core_g(m);
+    bind_dmrg_g(m);
+}
+
+#endif
+
+#endif
+
+#if defined(_USE_SG) && defined(_USE_COMPLEX) && \
+    (!defined(_SPLIT_PYMODULES) || defined(_PY_MODULE_GROUP_GZ))
+
+static void bind_core_gz(py::module &m) {
+#ifdef _USE_CORE
+    py::module m_sgf_cpx = block2_submodule(m, "cpx.sgf");
+    py::module m_sgb_cpx = block2_submodule(m, "cpx.sgb");
+    bind_core<SGF, complex<double>>(m_sgf_cpx, "SGF", "Double");
+    bind_core<SGB, complex<double>>(m_sgb_cpx, "SGB", "Double");
+#endif
+}
+
+static void bind_dmrg_gz(py::module &m) {
+#ifdef _USE_DMRG
+    py::module m_sgf_cpx = block2_submodule(m, "cpx.sgf");
+    py::module m_sgb_cpx = block2_submodule(m, "cpx.sgb");
+    bind_dmrg<SGF, complex<double>>(m_sgf_cpx, "SGF");
+    bind_dmrg<SGB, complex<double>>(m_sgb_cpx, "SGB");
+#ifdef _USE_SU2SZ
+    py::module m_su2 = block2_submodule(m, "su2");
+    py::module m_sz = block2_submodule(m, "sz");
+    py::module m_su2_cpx = block2_submodule(m, "cpx.su2");
+    py::module m_sz_cpx = block2_submodule(m, "cpx.sz");
+    bind_fl_trans_mps_spin_specific<SZ, SGF, complex<double>>(m_sz_cpx, "sgf");
+
+    bind_fl_trans_mps<SGF, complex<double>, double>(m_su2_cpx, "real");
+    bind_fl_trans_mps<SGF, double, complex<double>>(m_su2, "complex");
+    bind_fl_trans_mps<SGB, complex<double>, double>(m_sz_cpx, "real");
+    bind_fl_trans_mps<SGB, double, complex<double>>(m_sz, "complex");
+#endif
+#endif
+}
+
+#ifdef _PY_MODULE_GROUP
+
+static void bind_group_gz(py::module &m) {
+    bind_core_gz(m);
+    bind_dmrg_gz(m);
+}
+
+#endif
+
+#endif
+
+#if defined(_USE_SG) && defined(_USE_SINGLE_PREC) && \
+    (!defined(_SPLIT_PYMODULES) || defined(_PY_MODULE_GROUP_GS))
+
+static void bind_core_gs(py::module &m) {
+#ifdef _USE_CORE
+    py::module m_sgf = block2_submodule(m, "sgf");
+    py::module m_sgb = block2_submodule(m, "sgb");
+    py::module m_sgf_sp = block2_submodule(m, "sp.sgf");
+    py::module m_sgb_sp = block2_submodule(m, "sp.sgb");
+    bind_core<SGF, float>(m_sgf_sp, "SGF", "Float");
+    bind_core<SGB, float>(m_sgb_sp, "SGB", "Float");
+
+    bind_trans_sparse_matrix<SGF, float, double>(m_sgf_sp, "double");
+    bind_trans_sparse_matrix<SGF, double, float>(m_sgf, "float");
+    bind_trans_sparse_matrix<SGB, float, double>(m_sgb_sp, "double");
+    bind_trans_sparse_matrix<SGB, double, float>(m_sgb, "float");
+#endif
+}
+
+static void bind_dmrg_gs(py::module &m) {
+#ifdef _USE_DMRG
+    py::module m_sgf = block2_submodule(m, "sgf");
+    py::module m_sgb = block2_submodule(m, "sgb");
+    py::module m_sgf_sp = block2_submodule(m, "sp.sgf");
+    py::module m_sgb_sp = block2_submodule(m, "sp.sgb");
     bind_dmrg<SGF, float>(m_sgf_sp, "SGF");
     bind_dmrg<SGB, float>(m_sgb_sp, "SGB");
 
 #ifdef _USE_SU2SZ
+    py::module m_sz_sp = block2_submodule(m, "sp.sz");
     bind_fl_trans_mps_spin_specific<SZ, SGF, float>(m_sz_sp, "sgf");
 #endif
 
@@ -362,10 +642,58 @@ PYBIND11_MODULE(block2, m) {
     bind_fl_trans_mps<SGF, double, float>(m_sgf, "float");
     bind_fl_trans_mps<SGB, float, double>(m_sgb_sp, "double");
     bind_fl_trans_mps<SGB, double, float>(m_sgb, "float");
-#ifdef _USE_COMPLEX
+#endif
+}
+
+#ifdef _PY_MODULE_GROUP
+
+static void bind_group_gs(py::module &m) {
+    bind_core_gs(m);
+    bind_dmrg_gs(m);
+}
+
+#endif
+
+#endif
+
+#if defined(_USE_SG) && defined(_USE_SINGLE_PREC) && \
+    defined(_USE_COMPLEX) && \
+    (!defined(_SPLIT_PYMODULES) || defined(_PY_MODULE_GROUP_GC))
+
+static void bind_core_gc(py::module &m) {
+#ifdef _USE_CORE
+    py::module m_sgf_cpx = block2_submodule(m, "cpx.sgf");
+    py::module m_sgb_cpx = block2_submodule(m, "cpx.sgb");
+    py::module m_sgf_cpx_sp = block2_submodule(m, "sp.cpx.sgf");
+    py::module m_sgb_cpx_sp = block2_submodule(m, "sp.cpx.sgb");
+    bind_core<SGF, complex<float>>(m_sgf_cpx_sp, "SGF", "Float");
+    bind_core<SGB, complex<float>>(m_sgb_cpx_sp, "SGB", "Float");
+
+    bind_trans_sparse_matrix<SGF, complex<float>, complex<double>>(m_sgf_cpx_sp,
+                                                                   "double");
+    bind_trans_sparse_matrix<SGF, complex<double>, complex<float>>(m_sgf_cpx,
+                                                                   "float");
+    bind_trans_sparse_matrix<SGB, complex<float>, complex<double>>(m_sgb_cpx_sp,
+                                                                   "double");
+    bind_trans_sparse_matrix<SGB, complex<double>, complex<float>>(m_sgb_cpx,
+                                                                   "float");
+#endif
+}
+
+static void bind_dmrg_gc(py::module &m) {
+#ifdef _USE_DMRG
+    py::module m_sgf_cpx = block2_submodule(m, "cpx.sgf");
+    py::module m_sgb_cpx = block2_submodule(m, "cpx.sgb");
+    py::module m_sgf_cpx_sp = block2_submodule(m, "sp.cpx.sgf");
+    py::module m_sgb_cpx_sp = block2_submodule(m, "sp.cpx.sgb");
     bind_dmrg<SGF, complex<float>>(m_sgf_cpx_sp, "SGF");
     bind_dmrg<SGB, complex<float>>(m_sgb_cpx_sp, "SGB");
+
 #ifdef _USE_SU2SZ
+    py::module m_su2_sp = block2_submodule(m, "sp.su2");
+    py::module m_sz_sp = block2_submodule(m, "sp.sz");
+    py::module m_su2_cpx_sp = block2_submodule(m, "sp.cpx.su2");
+    py::module m_sz_cpx_sp = block2_submodule(m, "sp.cpx.sz");
     bind_fl_trans_mps_spin_specific<SZ, SGF, complex<float>>(m_sz_cpx_sp,
                                                              "sgf");
 #endif
@@ -377,60 +705,111 @@ PYBIND11_MODULE(block2, m) {
                                                             "double");
     bind_fl_trans_mps<SGB, complex<double>, complex<float>>(m_sgb_cpx, "float");
 
+#ifdef _USE_SU2SZ
     bind_fl_trans_mps<SGF, complex<float>, float>(m_su2_cpx_sp, "real");
     bind_fl_trans_mps<SGF, float, complex<float>>(m_su2_sp, "complex");
     bind_fl_trans_mps<SGB, complex<float>, float>(m_sz_cpx_sp, "real");
     bind_fl_trans_mps<SGB, float, complex<float>>(m_sz_sp, "complex");
 #endif
 #endif
+}
+
+#ifdef _PY_MODULE_GROUP
+
+static void bind_group_gc(py::module &m) {
+    bind_core_gc(m);
+    bind_dmrg_gc(m);
+}
 
 #endif
 
 #endif
 
-#ifdef _USE_BIG_SITE
-#ifdef _USE_SU2SZ
-    bind_fl_big_site<SU2, double>(m_su2);
-    bind_fl_hamiltonian_big_site<SU2, double>(m_su2);
-    bind_fl_dmrg_big_site<SU2, double, double>(m_su2);
-    bind_fl_big_site<SZ, double>(m_sz);
-    bind_fl_hamiltonian_big_site<SZ, double>(m_sz);
-    bind_fl_dmrg_big_site<SZ, double, double>(m_sz);
+#if defined(_USE_SANY) && \
+    (!defined(_SPLIT_PYMODULES) || defined(_PY_MODULE_GROUP_A))
 
-    bind_fl_sci_big_site_fock<SZ, double>(m_sz);
-    bind_fl_csf_big_site<SU2, double>(m_su2);
+static void bind_core_a(py::module &m) {
+#ifdef _USE_CORE
+    py::module m_sany = block2_submodule(m, "sany");
+    bind_core<SAny, double>(m_sany, "SAny", "Double");
+#endif
+}
 
-    bind_drt_big_site<SZ>(m_sz);
-    bind_drt_big_site<SU2>(m_su2);
+static void bind_dmrg_a(py::module &m) {
+#ifdef _USE_DMRG
+    py::module m_sany = block2_submodule(m, "sany");
+    bind_dmrg<SAny, double>(m_sany, "SAny");
+    bind_trans_mps<SAny, SAny>(m_sany, "sany");
+    bind_trans_multi_mps<SAny, SAny>(m_sany, "sany");
+    bind_fl_trans_mps_spin_specific<SAny, SAny, double>(m_sany, "sany");
+    bind_fl_trans_mpo<SAny, SAny, double>(m_sany, "sany");
+#endif
+}
+
+#ifdef _PY_MODULE_GROUP
+
+static void bind_group_a(py::module &m) {
+    bind_core_a(m);
+    bind_dmrg_a(m);
+}
 
-    bind_fl_drt_big_site<SZ, double>(m_sz);
-    bind_fl_drt_big_site<SU2, double>(m_su2);
 #endif
+
 #endif
 
-#ifdef _USE_SP_DMRG
-#ifdef _USE_SU2SZ
-    bind_fl_sp_dmrg<SU2, double>(m_su2);
-    bind_fl_sp_dmrg<SZ, double>(m_sz);
-#ifdef _USE_KSYMM
-    bind_fl_sp_dmrg<SU2K, double>(m_su2k);
-    bind_fl_sp_dmrg<SZK, double>(m_szk);
+#if defined(_USE_SANY) && defined(_USE_COMPLEX) && \
+    (!defined(_SPLIT_PYMODULES) || defined(_PY_MODULE_GROUP_AZ))
+
+static void bind_core_az(py::module &m) {
+#ifdef _USE_CORE
+    py::module m_sany_cpx = block2_submodule(m, "cpx.sany");
+    bind_core<SAny, complex<double>>(m_sany_cpx, "SAny", "Double");
+#endif
+}
+
+static void bind_dmrg_az(py::module &m) {
+#ifdef _USE_DMRG
+    py::module m_sany_cpx = block2_submodule(m, "cpx.sany");
+    bind_dmrg<SAny, complex<double>>(m_sany_cpx, "SAny");
+    bind_fl_trans_mps_spin_specific<SAny, SAny, complex<double>>(m_sany_cpx,
+                                                                 "sany");
+    bind_fl_trans_mpo<SAny, SAny, complex<double>>(m_sany_cpx, "sany");
 #endif
+}
+
+#ifdef _PY_MODULE_GROUP
+
+static void bind_group_az(py::module &m) {
+    bind_core_az(m);
+    bind_dmrg_az(m);
+}
+
 #endif
+
 #endif
 
-#ifdef _USE_IC
+#if defined(_USE_IC) && \
+    (!defined(_SPLIT_PYMODULES) || defined(_PY_MODULE_GROUP_IC))
+
+static void bind_group_ic(py::module &m) {
     bind_wick<>(m);
     bind_nd_array<>(m);
     bind_guga<>(m);
 #ifdef _USE_SU2SZ
+    py::module m_su2 = block2_submodule(m, "su2");
     bind_guga<SU2>(m_su2);
 #endif
+}
+
 #endif
 
-#ifdef _USE_SCI
+#if defined(_USE_SCI) && \
+    (!defined(_SPLIT_PYMODULES) || defined(_PY_MODULE_GROUP_SCI))
+
+static void bind_group_sci(py::module &m) {
     bind_types_sci<>(m);
 #ifdef _USE_SU2SZ
+    py::module m_sz = block2_submodule(m, "sz");
     bind_sci_wrapper<SZ>(m_sz);
 #ifdef _SCI_WRAPPER2
     bind_sci_wrapper2<SZ>(m_sz);
@@ -438,5 +817,315 @@ PYBIND11_MODULE(block2, m) {
     bind_hamiltonian_sci<SZ>(m_sz);
     bind_mpo_sci<SZ>(m_sz);
 #endif
+}
+
+#endif
+
+#if !defined(_SPLIT_PYMODULES)
+
+PYBIND11_MODULE(block2, m) {
+
+    bind_module_base(m);
+
+    // same order as the monolithic module before the split into groups
+#ifdef _USE_SU2SZ
+    bind_core_u(m);
+#endif
+#ifdef _USE_COMPLEX
+    bind_core_base_z(m);
+#ifdef _USE_SU2SZ
+    bind_core_uz(m);
+#endif
+#endif
+#ifdef _USE_KSYMM
+    bind_core_k(m);
+#ifdef _USE_COMPLEX
+    bind_core_kz(m);
+#endif
+#endif
+#ifdef _USE_SG
+    bind_core_g(m);
+#ifdef _USE_COMPLEX
+    bind_core_gz(m);
+#endif
+#endif
+#ifdef _USE_SANY
+    bind_core_a(m);
+#ifdef _USE_COMPLEX
+    bind_core_az(m);
+#endif
+#endif
+#ifdef _USE_SINGLE_PREC
+    bind_core_base_s(m);
+#ifdef _USE_SU2SZ
+    bind_core_us(m);
+#endif
+#ifdef _USE_COMPLEX
+    bind_core_base_c(m);
+#ifdef _USE_SU2SZ
+    bind_core_uc(m);
+#endif
+#endif
+#ifdef _USE_SG
+    bind_core_gs(m);
+#ifdef _USE_COMPLEX
+    bind_core_gc(m);
+#endif
+#endif
+#endif
+
+    bind_dmrg_base(m);
+#ifdef _USE_SU2SZ
+    bind_dmrg_u(m);
+#endif
+#ifdef _USE_COMPLEX
+    bind_dmrg_base_z(m);
+#ifdef _USE_SU2SZ
+    bind_dmrg_uz(m);
+#endif
+#endif
+#ifdef _USE_KSYMM
+    bind_dmrg_k(m);
+#ifdef _USE_COMPLEX
+    bind_dmrg_kz(m);
+#endif
+#endif
+#ifdef _USE_SG
+    bind_dmrg_g(m);
+#ifdef _USE_COMPLEX
+    bind_dmrg_gz(m);
+#endif
+#endif
+#ifdef _USE_SANY
+    bind_dmrg_a(m);
+#ifdef _USE_COMPLEX
+    bind_dmrg_az(m);
+#endif
+#endif
+#ifdef _USE_SINGLE_PREC
+    bind_dmrg_base_s(m);
+#ifdef _USE_SU2SZ
+    bind_dmrg_us(m);
+#ifdef _USE_COMPLEX
+    bind_dmrg_uc(m);
+#endif
+#endif
+#ifdef _USE_SG
+    bind_dmrg_gs(m);
+#ifdef _USE_COMPLEX
+    bind_dmrg_gc(m);
+#endif
+#endif
+#endif
+
+#ifdef _USE_SU2SZ
+    bind_extra_u(m);
+#endif
+#ifdef _USE_KSYMM
+    bind_extra_k(m);
+#endif
+
+#ifdef _USE_IC
+    bind_group_ic(m);
+#endif
+
+#ifdef _USE_SCI
+    bind_group_sci(m);
+#endif
+}
+
+#elif !defined(_PY_MODULE_GROUP)
+
+/** Extension module of a group of bindings. */
+struct PyModuleGroup {
+    string name;            //!< Group name (suffix of the module name).
+    vector<string> deps;    //!< Groups that must be imported first.
+    vector<string> paths;   //!< Submodules of ``block2`` owned by the group.
+    bool loaded = false;    //!< Whether the module has been imported.
+    PyModuleGroup(const string &name, const vector<string> &deps,
+                  const vector<string> &paths)
+        : name(name), deps(deps), paths(paths) {}
+};
+
+static vector<PyModuleGroup> &py_module_groups() {
+    static vector<PyModuleGroup> groups = []() {
+        vector<PyModuleGroup> r;
+#ifdef _USE_SU2SZ
+        r.push_back(PyModuleGroup("u", {}, {"su2", "sz"}));
+#ifdef _USE_COMPLEX
+        r.push_back(PyModuleGroup("uz", {"u"}, {"cpx.su2", "cpx.sz"}));
+#endif
+#ifdef _USE_SINGLE_PREC
+        r.push_back(PyModuleGroup("us", {"u"}, {"sp.su2", "sp.sz"}));
+#ifdef _USE_COMPLEX
+        r.push_back(
+            PyModuleGroup("uc", {"uz", "us"}, {"sp.cpx.su2", "sp.cpx.sz"}));
+#endif
+#endif
+#endif
+#ifdef _USE_KSYMM
+        r.push_back(PyModuleGroup("k", {}, {"su2k", "szk"}));
+#ifdef _USE_COMPLEX
+        r.push_back(PyModuleGroup("kz", {"k"}, {"cpx.su2k", "cpx.szk"}));
+#endif
+#endif
+#ifdef _USE_SG
+#ifdef _USE_SU2SZ
+        const vector<string> gu = {"u"}, gzu = {"g", "uz"}, gsu = {"g", "us"},
+                             gcu = {"gz", "gs", "uc"};
+#else
+        const vector<string> gu = {}, gzu = {"g"}, gsu = {"g"},
+                             gcu = {"gz", "gs"};
+#endif
+        r.push_back(PyModuleGroup("g", gu, {"sgf", "sgb"}));
+#ifdef _USE_COMPLEX
+        r.push_back(PyModuleGroup("gz", gzu, {"cpx.sgf", "cpx.sgb"}));
+#endif
+#ifdef _USE_SINGLE_PREC
+        r.push_back(PyModuleGroup("gs", gsu, {"sp.sgf", "sp.sgb"}));
+#ifdef _USE_COMPLEX
+        r.push_back(
+            PyModuleGroup("gc", gcu, {"sp.cpx.sgf", "sp.cpx.sgb"}));
+#endif
+#endif
+#endif
+#ifdef _USE_SANY
+        r.push_back(PyModuleGroup("a", {}, {"sany"}));
+#ifdef _USE_COMPLEX
+        r.push_back(PyModuleGroup("az", {"a"}, {"cpx.sany"}));
+#endif
+#endif
+        // feature groups binding into block2 itself
+#ifdef _USE_IC
+#ifdef _USE_SU2SZ
+        r.push_back(PyModuleGroup("ic", {"u"}, {}));
+#else
+        r.push_back(PyModuleGroup("ic", {}, {}));
+#endif
+#endif
+#ifdef _USE_SCI
+        r.push_back(PyModuleGroup("sci", {"u"}, {}));
 #endif
+        return r;
+    }();
+    return groups;
+}
+
+static void load_py_module_group(const string &name) {
+    for (auto &g : py_module_groups())
+        if (g.name == name) {
+            if (g.loaded)
+                return;
+            for (auto &d : g.deps)
+                load_py_module_group(d);
+            py::module::import(("_block2_" + name).c_str());
+            g.loaded = true;
+            return;
+        }
+    throw py::value_error("block2: unknown extension module '_block2_" +
+                          name + "'.");
+}
+
+static void load_all_py_module_groups() {
+    for (auto &g : py_module_groups())
+        load_py_module_group(g.name);
+}
+
+// Attribute lookup after importing the groups that may define it
+static py::object lazy_getattr(const string &path, const string &group,
+                               const string &name) {
+    const string full_name = path == "" ? "block2" : "block2." + path;
+    // special names (such as __path__) are probed by importlib and pickle
+    if (name.length() >= 2 && name.substr(0, 2) == "__")
+        throw py::attribute_error("module '" + full_name +
+                                  "' has no attribute '" + name + "'");
+    py::module sub = block2_submodule(py::module::import("block2"), path);
+    py::dict dict = sub.attr("__dict__").cast<py::dict>();
+    if (group != "") {
+        load_py_module_group(group);
+        if (dict.contains(name))
+            return dict[name.c_str()];
+    }
+    // helpers for conversion between symmetries live in other groups
+    load_all_py_module_groups();
+    if (dict.contains(name))
+        return dict[name.c_str()];
+    throw py::attribute_error("module '" + full_name + "' has no attribute '" +
+                              name + "'");
+}
+
+static void bind_lazy_loader(py::module &m) {
+    for (auto &g : py_module_groups())
+        for (auto &path : g.paths) {
+            const string group = g.name;
+            block2_submodule(m, path).attr("__getattr__") = py::cpp_function(
+                [path, group](const string &name) {
+                    return lazy_getattr(path, group, name);
+                },
+                py::arg("name"));
+        }
+    // unknown names in block2 itself are looked up in the feature groups;
+    // probing for submodules not compiled (such as hasattr(block2, "sgf"))
+    // does not trigger any import
+    m.attr("__getattr__") = py::cpp_function(
+        [](const string &name) -> py::object {
+            const set<string> sub_names = {"su2", "sz",  "su2k", "szk", "sgf",
+                                           "sgb", "sany", "cpx", "sp"};
+            if (sub_names.count(name) ||
+                (name.length() >= 2 && name.substr(0, 2) == "__"))
+                throw py::attribute_error(
+                    "module 'block2' has no attribute '" + name + "'");
+            return lazy_getattr("", "", name);
+        },
+        py::arg("name"));
+    m.def(
+        "load_module",
+        [](const py::object &sub) {
+            const string name = sub.attr("__name__").cast<string>();
+            const string path =
+                name == "block2" ? "" : name.substr(string("block2.").length());
+            for (auto &g : py_module_groups())
+                if (find(g.paths.begin(), g.paths.end(), path) !=
+                    g.paths.end())
+                    load_py_module_group(g.name);
+        },
+        py::arg("module"),
+        "Import the extension modules for the given submodule of block2 "
+        "(such as block2.su2).");
+    m.def(
+        "loaded_modules",
+        []() {
+            vector<string> r;
+            for (auto &g : py_module_groups())
+                if (g.loaded)
+                    r.push_back("_block2_" + g.name);
+            return r;
+        },
+        "Names of the extension modules imported so far.");
+}
+
+PYBIND11_MODULE(block2, m) {
+    bind_module_base(m);
+    bind_core_base_z(m);
+    bind_core_base_s(m);
+    bind_core_base_c(m);
+    bind_dmrg_base(m);
+    bind_dmrg_base_z(m);
+    bind_dmrg_base_s(m);
+    bind_lazy_loader(m);
 }
+
+#else
+
+#define PY_MODULE_CONCAT_(a, b) a##b
+#define PY_MODULE_CONCAT(a, b) PY_MODULE_CONCAT_(a, b)
+#define PY_MODULE_GROUP_NAME PY_MODULE_CONCAT(_block2_, _PY_MODULE_GROUP)
+#define PY_MODULE_GROUP_FUNC PY_MODULE_CONCAT(bind_group_, _PY_MODULE_GROUP)
+
+PYBIND11_MODULE(PY_MODULE_GROUP_NAME, m) {
+    m.doc() = "python interface for block2 (extension module).";
+    py::module b = py::module::import("block2");
+    PY_MODULE_GROUP_FUNC(b);
+}
+
+#endif
@@ -1241,7 +1241,13 @@ template <typename S, typename FL> void bind_fl_operator(py::module &m) {
     py::class_<DelayedTensorFunctions<S, FL>,
                shared_ptr<DelayedTensorFunctions<S, FL>>,
                TensorFunctions<S, FL>>(m, "DelayedTensorFunctions")
-        .def(py::init<const shared_ptr<OperatorFunctions<S, FL>> &>());
+        .def(py::init<const shared_ptr<OperatorFunctions<S, FL>> &>())
+        .def_readwrite("low_rank_cutoff",
+                       &DelayedTensorFunctions<S, FL>::low_rank_cutoff)
+        .def_readwrite("low_rank_ops",
+                       &DelayedTensorFunctions<S, FL>::low_rank_ops)
+        .def("low_rank_compress",
+             &DelayedTensorFunctions<S, FL>::low_rank_compress, py::arg("c"));
 }
 
 template <typename S, typename FL> void bind_fl_hamiltonian(py::module &m) {
@@ -1386,6 +1392,99 @@ template <typename S, typename FL> void bind_fl_rule(py::module &m) {
         .def(py::init<const shared_ptr<Rule<S, FL>> &>());
 }
 
+// None, int or sequence of int (for indices of BlockSparseTensor)
+inline vector<int> block_sparse_indices(const py::object &x) {
+    vector<int> r;
+    if (x.is_none())
+        return r;
+    else if (py::isinstance<py::int_>(x))
+        r.push_back(x.cast<int>());
+    else
+        for (auto h : x)
+            r.push_back(h.cast<int>());
+    return r;
+}
+
+template <typename S, typename FL>
+void bind_fl_block_sparse(py::module &m) {
+    typedef BlockSparseTensor<S, FL> BST;
+    typedef typename GMatrix<FL>::FP FP;
+    py::class_<BST, shared_ptr<BST>>(m, "BlockSparseTensor")
+        .def(py::init<>())
+        .def(py::init([](const py::list &q_labels, const py::list &arrs) {
+                 assert(q_labels.size() == arrs.size());
+                 shared_ptr<BST> r = make_shared<BST>();
+                 for (size_t ib = 0; ib < q_labels.size(); ib++) {
+                     vector<S> q;
+                     for (auto h : q_labels[ib])
+                         q.push_back(h.cast<S>());
+                     py::array_t<FL, py::array::c_style |
+                                         py::array::forcecast>
+                         arr(arrs[ib]);
+                     vector<MKL_INT> sh(arr.shape(), arr.shape() + arr.ndim());
+                     r->add_block(q, sh,
+                                  make_shared<vector<FL>>(
+                                      arr.data(), arr.data() + arr.size()));
+                 }
+                 return r;
+             }),
+             py::arg("q_labels"), py::arg("arrays"))
+        .def_property_readonly("rank", &BST::rank)
+        .def_property_readonly("n_blocks", &BST::n_blocks)
+        .def_property_readonly(
+            "blocks",
+            [](BST *self) {
+                py::list r;
+                for (size_t ib = 0; ib < self->n_blocks(); ib++) {
+                    py::tuple q(self->q_labels[ib].size());
+                    for (size_t i = 0; i < self->q_labels[ib].size(); i++)
+                        q[i] = py::cast(self->q_labels[ib][i]);
+                    // the array keeps a reference to the data
+                    shared_ptr<vector<FL>> *d =
+                        new shared_ptr<vector<FL>>(self->data[ib]);
+                    py::capsule base(d, [](void *p) {
+                        delete (shared_ptr<vector<FL>> *)p;
+                    });
+                    vector<ssize_t> sh(self->shapes[ib].begin(),
+                                       self->shapes[ib].end());
+                    r.append(py::make_tuple(
+                        q, py::array_t<FL>(sh, (*d)->data(), base)));
+                }
+                return r;
+            })
+        .def_static(
+            "contract",
+            [](const shared_ptr<BST> &a, const shared_ptr<BST> &b,
+               const py::object &idxa, const py::object &idxb,
+               const py::object &fidxa, const py::object &fidxb,
+               const py::object &out_trans) {
+                vector<int> ia = block_sparse_indices(idxa),
+                            ib = block_sparse_indices(idxb),
+                            fa = block_sparse_indices(fidxa),
+                            fb = block_sparse_indices(fidxb),
+                            ot = block_sparse_indices(out_trans);
+                py::gil_scoped_release release;
+                return BST::contract(a, b, ia, ib, fa, fb, ot);
+            },
+            py::arg("a"), py::arg("b"), py::arg("idxa"), py::arg("idxb"),
+            py::arg("fidxa") = py::none(), py::arg("fidxb") = py::none(),
+            py::arg("out_trans") = py::none())
+        .def("left_canonicalize", &BST::left_canonicalize,
+             py::call_guard<py::gil_scoped_release>())
+        .def("right_canonicalize", &BST::right_canonicalize,
+             py::call_guard<py::gil_scoped_release>())
+        .def("left_multiply", &BST::left_multiply, py::arg("mats"),
+             py::call_guard<py::gil_scoped_release>())
+        .def("right_multiply", &BST::right_multiply, py::arg("mats"),
+             py::call_guard<py::gil_scoped_release>())
+        .def("left_compress", &BST::left_compress, py::arg("k") = -1,
+             py::arg("cutoff") = (FP)0.0,
+             py::call_guard<py::gil_scoped_release>())
+        .def("right_compress", &BST::right_compress, py::arg("k") = -1,
+             py::arg("cutoff") = (FP)0.0, py::arg("sv_on_l") = true,
+             py::call_guard<py::gil_scoped_release>());
+}
+
 template <typename S, typename FL>
 void bind_core(py::module &m, const string &name, const string &fname) {
 
@@ -2083,6 +2182,11 @@ template <typename S = void> void bind_io(py::module &m) {
         .def_readwrite("n_threads_mkl", &Threading::n_threads_mkl)
         .def_readwrite("n_threads_global", &Threading::n_threads_global)
         .def_readwrite("n_levels", &Threading::n_levels)
+        .def_readwrite("decomp_large_dim", &Threading::decomp_large_dim)
+        .def_readwrite("n_decomp_large", &Threading::n_decomp_large)
+        .def_readwrite("n_decomp_small", &Threading::n_decomp_small)
+        .def_readwrite("tdecomp_large", &Threading::tdecomp_large)
+        .def_readwrite("tdecomp_small", &Threading::tdecomp_small)
         .def("openmp_available", &Threading::openmp_available)
         .def("mkl_available", &Threading::mkl_available)
         .def("tbb_available", &Threading::tbb_available)
@@ -2145,6 +2249,35 @@ template <typename S = void> void bind_io(py::module &m) {
         .def_static("to_size_string", &Parsing::to_size_string,
                     py::arg("i") = (size_t)0U, py::arg("suffix") = "B");
 
+    py::class_<FileContainer, shared_ptr<FileContainer>>(m, "FileContainer")
+        .def(py::init<const string &>())
+        .def(py::init<const string &, bool>())
+        .def(py::init<const string &, bool, uint64_t>())
+        .def_readonly("filename", &FileContainer::filename)
+        .def_readonly("alignment", &FileContainer::alignment)
+        .def_readonly("n_in_place", &FileContainer::n_in_place)
+        .def_readonly("n_reused", &FileContainer::n_reused)
+        .def_readonly("n_appended", &FileContainer::n_appended)
+        .def("write",
+             [](FileContainer *self, const string &name, py::bytes data) {
+                 self->write(name, (string)data);
+             })
+        .def("read",
+             [](FileContainer *self, const string &name) {
+                 return py::bytes(self->read(name));
+             })
+        .def("exists", &FileContainer::exists)
+        .def("size", &FileContainer::size)
+        .def("remove", &FileContainer::remove)
+        .def("rename", &FileContainer::rename)
+        .def("link", &FileContainer::link)
+        .def("names", &FileContainer::names)
+        .def("n_records", &FileContainer::n_records)
+        .def("data_size", &FileContainer::data_size)
+        .def("free_size", &FileContainer::free_size)
+        .def("flush", &FileContainer::flush)
+        .def("snapshot", &FileContainer::snapshot);
+
     py::class_<ParallelProperty, shared_ptr<ParallelProperty>>(
         m, "ParallelProperty")
         .def_readwrite("owner", &ParallelProperty::owner)
@@ -2382,11 +2515,13 @@ template <typename S = void> void bind_io(py::module &m) {
         .def_static(
             "initialize_sz", &SpinPermScheme::initialize_sz, py::arg("nn"),
             py::arg("spin_str"), py::arg("is_fermion") = true,
-            py::arg("mask") = vector<uint16_t>(), py::arg("max_n_sites") = 0)
+            py::arg("mask") = vector<uint16_t>(), py::arg("max_n_sites") = 0,
+            py::arg("cache_dir") = string(""))
         .def_static(
             "initialize_sany", &SpinPermScheme::initialize_sany, py::arg("nn"),
             py::arg("spin_str"), py::arg("fermionic_ops") = string("cdCD"),
-            py::arg("mask") = vector<uint16_t>(), py::arg("max_n_sites") = 0)
+            py::arg("mask") = vector<uint16_t>(), py::arg("max_n_sites") = 0,
+            py::arg("cache_dir") = string(""))
         .def_static("initialize_su2_old", &SpinPermScheme::initialize_su2_old,
                     py::arg("nn"), py::arg("spin_str"),
                     py::arg("is_npdm") = false)
@@ -2394,12 +2529,20 @@ template <typename S = void> void bind_io(py::module &m) {
                     py::arg("nn"), py::arg("spin_str"),
                     py::arg("is_npdm") = false, py::arg("is_drt") = false,
                     py::arg("mask") = vector<uint16_t>(),
-                    py::arg("max_n_sites") = 0)
+                    py::arg("max_n_sites") = 0,
+                    py::arg("cache_dir") = string(""))
         .def_static("initialize_su2_old2", &SpinPermScheme::initialize_su2_old2,
                     py::arg("nn"), py::arg("spin_str"),
                     py::arg("is_npdm") = false, py::arg("is_drt") = false,
                     py::arg("mask") = vector<uint16_t>(),
                     py::arg("max_n_sites") = 0)
+        .def_static("cache_key", &SpinPermScheme::cache_key)
+        .def("load_cache", &SpinPermScheme::load_cache)
+        .def("save_cache", &SpinPermScheme::save_cache)
+        .def("load_data", (void(SpinPermScheme::*)(const string &)) &
+                              SpinPermScheme::load_data)
+        .def("save_data", (void(SpinPermScheme::*)(const string &) const) &
+                              SpinPermScheme::save_data)
         .def("to_str", &SpinPermScheme::to_str);
 
     py::bind_vector<vector<shared_ptr<SpinPermScheme>>>(m,
@@ -2679,9 +2822,11 @@ template <typename FL> void bind_fl_io(py::module &m, const string &name) {
         .def(py::init<>())
         .def(py::init<FL>())
         .def(py::init<FL, size_t>())
+        .def(py::init<FL, size_t, size_t>())
         .def_readwrite("ndata", &FPCodec<FL>::ndata)
         .def_readwrite("ncpsd", &FPCodec<FL>::ncpsd)
         .def_readwrite("ncpsd_last", &FPCodec<FL>::ncpsd_last)
+        .def_readwrite("block_size", &FPCodec<FL>::block_size)
         .def("encode",
              [](FPCodec<FL> *self, py::array_t<FL> arr) {
                  FL *tmp = new FL[arr.size() + 2];
@@ -2802,7 +2947,13 @@ template <typename FL> void bind_fl_io(py::module &m, const string &name) {
                        &DataFrame<FL>::minimal_memory_usage)
         .def_readwrite("compressed_sparse_tensor_storage",
                        &DataFrame<FL>::compressed_sparse_tensor_storage)
+        .def_readwrite("compact_operator_storage",
+                       &DataFrame<FL>::compact_operator_storage)
         .def_readwrite("fp_codec", &DataFrame<FL>::fp_codec)
+        .def_readwrite("partition_container",
+                       &DataFrame<FL>::partition_container)
+        .def("snapshot_partition_container",
+             &DataFrame<FL>::snapshot_partition_container)
         .def("update_peak_used_memory", &DataFrame<FL>::update_peak_used_memory)
         .def("reset_peak_used_memory", &DataFrame<FL>::reset_peak_used_memory)
         .def("activate", &DataFrame<FL>::activate)
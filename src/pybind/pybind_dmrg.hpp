@@ -148,6 +148,102 @@ class checked_estream_redirect : public checked_ostream_redirect {
         : checked_ostream_redirect(costream, pyostream) {}
 };
 
+template <typename S, typename FL>
+void bind_fl_orbital_gradient(py::module &m) {
+
+    py::class_<ExpectationConsumer<S, FL>,
+               shared_ptr<ExpectationConsumer<S, FL>>>(m,
+                                                       "ExpectationConsumer")
+        .def("consume", &ExpectationConsumer<S, FL>::consume, py::arg("i"),
+             py::arg("expectations"));
+
+    py::class_<OrbitalGradientQC<S, FL>, shared_ptr<OrbitalGradientQC<S, FL>>,
+               ExpectationConsumer<S, FL>>(m, "OrbitalGradientQC")
+        .def(py::init<const shared_ptr<FCIDUMP<FL>> &>(), py::arg("fcidump"))
+        .def_readwrite("fcidump", &OrbitalGradientQC<S, FL>::fcidump)
+        .def_readwrite("n_sites", &OrbitalGradientQC<S, FL>::n_sites)
+        .def_readwrite("n_elec", &OrbitalGradientQC<S, FL>::n_elec)
+        .def_readwrite("hessian", &OrbitalGradientQC<S, FL>::hessian)
+        .def("reset", &OrbitalGradientQC<S, FL>::reset)
+        .def("accumulate", &OrbitalGradientQC<S, FL>::accumulate,
+             py::arg("expectations"), py::arg("dot") = 2)
+        .def("get_1pdm", &OrbitalGradientQC<S, FL>::get_1pdm)
+        .def("fock", &OrbitalGradientQC<S, FL>::fock)
+        .def("energy", &OrbitalGradientQC<S, FL>::energy)
+        .def("gradient", &OrbitalGradientQC<S, FL>::gradient)
+        .def("hessian_vector", &OrbitalGradientQC<S, FL>::hessian_vector,
+             py::arg("kappa"));
+}
+
+template <typename S, typename FL>
+void bind_fl_orbital_rotation(py::module &m) {
+
+    py::class_<OrbitalRotation<S, FL>, shared_ptr<OrbitalRotation<S, FL>>>(
+        m, "OrbitalRotation")
+        .def(py::init<const shared_ptr<MPS<S, FL>> &, ubond_t>(),
+             py::arg("mps"), py::arg("bond_dim"))
+        .def(py::init<const shared_ptr<MPS<S, FL>> &, ubond_t,
+                      const shared_ptr<CG<S>> &>(),
+             py::arg("mps"), py::arg("bond_dim"), py::arg("cg"))
+        .def_readwrite("mps", &OrbitalRotation<S, FL>::mps)
+        .def_readwrite("cg", &OrbitalRotation<S, FL>::cg)
+        .def_readwrite("bond_dim", &OrbitalRotation<S, FL>::bond_dim)
+        .def_readwrite("cutoff", &OrbitalRotation<S, FL>::cutoff)
+        .def_readwrite("trunc_type", &OrbitalRotation<S, FL>::trunc_type)
+        .def_readwrite("normalize_mps", &OrbitalRotation<S, FL>::normalize_mps)
+        .def_readwrite("iprint", &OrbitalRotation<S, FL>::iprint)
+        .def_readwrite("discarded_weights",
+                       &OrbitalRotation<S, FL>::discarded_weights)
+        .def_readwrite("tgate", &OrbitalRotation<S, FL>::tgate)
+        .def_readwrite("tsplit", &OrbitalRotation<S, FL>::tsplit)
+        .def_static("givens_decompose",
+                    [](const vector<typename OrbitalRotation<S, FL>::FP> &rot,
+                       int n) {
+                        vector<tuple<int, typename OrbitalRotation<S, FL>::FP,
+                                     bool, bool>>
+                            r;
+                        for (auto &g : OrbitalRotation<S, FL>::givens_decompose(
+                                 rot, n))
+                            r.push_back(make_tuple(g.bond, g.theta, g.flip[0],
+                                                   g.flip[1]));
+                        return r;
+                    })
+        .def("site_irreps", &OrbitalRotation<S, FL>::site_irreps)
+        .def_static("check_rotation", &OrbitalRotation<S, FL>::check_rotation,
+                    py::arg("rot"), py::arg("orb_sym"), py::arg("thrd") = 1E-12)
+        .def("solve", &OrbitalRotation<S, FL>::solve, py::arg("rot"));
+
+    py::class_<GeometryContinuation<S, FL>,
+               shared_ptr<GeometryContinuation<S, FL>>>(m,
+                                                        "GeometryContinuation")
+        .def(py::init<const vector<typename GeometryContinuation<S, FL>::FP> &,
+                      int>(),
+             py::arg("overlap"), py::arg("n_sites"))
+        .def(py::init<const vector<typename GeometryContinuation<S, FL>::FP> &,
+                      int, const vector<uint8_t> &, const vector<uint8_t> &>(),
+             py::arg("overlap"), py::arg("n_sites"), py::arg("old_orb_sym"),
+             py::arg("new_orb_sym"))
+        .def_readwrite("n_sites", &GeometryContinuation<S, FL>::n_sites)
+        .def_readwrite("reorder", &GeometryContinuation<S, FL>::reorder)
+        .def_readwrite("phases", &GeometryContinuation<S, FL>::phases)
+        .def_readwrite("rotation", &GeometryContinuation<S, FL>::rotation)
+        .def_readwrite("min_overlap", &GeometryContinuation<S, FL>::min_overlap)
+        .def_readwrite("max_rotation",
+                       &GeometryContinuation<S, FL>::max_rotation)
+        .def_readwrite("iprint", &GeometryContinuation<S, FL>::iprint)
+        .def_readwrite("orb_sym", &GeometryContinuation<S, FL>::orb_sym)
+        .def("n_permuted", &GeometryContinuation<S, FL>::n_permuted)
+        .def("check_rotation", &GeometryContinuation<S, FL>::check_rotation,
+             py::arg("thrd") = 1E-12)
+        .def("align_overlap", &GeometryContinuation<S, FL>::align_overlap,
+             py::arg("next_overlap"))
+        .def("align_fcidump", &GeometryContinuation<S, FL>::align_fcidump,
+             py::arg("fcidump"))
+        .def("rotate_mps", &GeometryContinuation<S, FL>::rotate_mps,
+             py::arg("mps"), py::arg("bond_dim"), py::arg("cutoff") = 1E-14,
+             py::arg("thrd") = 1E-12);
+}
+
 template <typename S, typename FL>
 auto bind_fl_spin_specific(py::module &m) -> decltype(typename S::is_su2_t()) {
 
@@ -160,6 +256,9 @@ auto bind_fl_spin_specific(py::module &m) -> decltype(typename S::is_su2_t()) {
         .def_static("get_matrix", &PDM2MPOQC<S, FL>::get_matrix)
         .def_static("get_matrix_spatial",
                     &PDM2MPOQC<S, FL>::get_matrix_spatial);
+
+    bind_fl_orbital_gradient<S, FL>(m);
+    bind_fl_orbital_rotation<S, FL>(m);
 }
 
 template <typename S, typename FL>
@@ -187,6 +286,9 @@ auto bind_fl_spin_specific(py::module &m) -> decltype(typename S::is_sz_t()) {
         .def(py::init<const shared_ptr<HamiltonianQC<S, FL>> &,
                       const vector<uint16_t> &>(),
              py::arg("hamil"), py::arg("pts"));
+
+    bind_fl_orbital_gradient<S, FL>(m);
+    bind_fl_orbital_rotation<S, FL>(m);
 }
 
 template <typename S, typename FL>
@@ -199,6 +301,8 @@ auto bind_fl_spin_specific(py::module &m) -> decltype(typename S::is_sg_t()) {
         .def_static("get_matrix", &PDM2MPOQC<S, FL>::get_matrix)
         .def_static("get_matrix_spatial",
                     &PDM2MPOQC<S, FL>::get_matrix_spatial);
+
+    bind_fl_orbital_rotation<S, FL>(m);
 }
 
 template <typename S, typename FL>
@@ -405,7 +509,8 @@ template <typename S, typename FL> void bind_fl_mps(py::module &m) {
         .def("initialize", &MPS<S, FL>::initialize, py::arg("info"),
              py::arg("init_left") = true, py::arg("init_right") = true)
         .def("fill_thermal_limit", &MPS<S, FL>::fill_thermal_limit)
-        .def("canonicalize", &MPS<S, FL>::canonicalize)
+        .def("canonicalize", &MPS<S, FL>::canonicalize,
+             py::arg("iprint") = false)
         .def("dynamic_canonicalize", &MPS<S, FL>::dynamic_canonicalize)
         .def("random_canonicalize", &MPS<S, FL>::random_canonicalize)
         .def("iscale", &MPS<S, FL>::iscale)
@@ -514,6 +619,93 @@ template <typename S, typename FL> void bind_fl_mps(py::module &m) {
         .def("resolve_singlet_embedding",
              &UnfusedMPS<S, FL>::resolve_singlet_embedding);
 
+    py::class_<FlatSparseTensor<S, FL>, shared_ptr<FlatSparseTensor<S, FL>>>(
+        m, "FlatSparseTensor")
+        .def(py::init<int>(), py::arg("rank") = 3)
+        .def(py::init([](int rank, const py::list &q_labels,
+                         const py::array_t<MKL_INT, py::array::c_style |
+                                                        py::array::forcecast>
+                             &shapes,
+                         const py::array_t<FL, py::array::c_style |
+                                                   py::array::forcecast>
+                             &data) {
+                 shared_ptr<FlatSparseTensor<S, FL>> r =
+                     make_shared<FlatSparseTensor<S, FL>>(rank);
+                 if ((size_t)shapes.size() != q_labels.size() * rank)
+                     throw runtime_error("FlatSparseTensor: number of shapes "
+                                         "does not match number of blocks!");
+                 vector<S> q(rank);
+                 for (size_t ib = 0; ib < q_labels.size(); ib++) {
+                     if (py::len(q_labels[ib]) != (size_t)rank)
+                         throw runtime_error("FlatSparseTensor: number of "
+                                             "quantum labels in block " +
+                                             Parsing::to_string(ib) +
+                                             " does not match rank!");
+                     int j = 0;
+                     for (auto h : q_labels[ib])
+                         q[j++] = h.cast<S>();
+                     r->add_block(q.data(), shapes.data() + ib * rank);
+                 }
+                 if ((size_t)data.size() != r->size())
+                     throw runtime_error("FlatSparseTensor: data size does "
+                                         "not match block shapes!");
+                 r->data->assign(data.data(), data.data() + data.size());
+                 return r;
+             }),
+             py::arg("rank"), py::arg("q_labels"), py::arg("shapes"),
+             py::arg("data"))
+        .def_readonly("rank", &FlatSparseTensor<S, FL>::rank)
+        .def_property_readonly("n_blocks", &FlatSparseTensor<S, FL>::n_blocks)
+        .def_property_readonly("size", &FlatSparseTensor<S, FL>::size)
+        .def_property_readonly(
+            "q_labels",
+            [](FlatSparseTensor<S, FL> *self) {
+                py::list r;
+                for (int k = 0; k < self->n_blocks(); k++) {
+                    py::tuple q(self->rank);
+                    for (int j = 0; j < self->rank; j++)
+                        q[j] = py::cast(self->qs[k * self->rank + j]);
+                    r.append(q);
+                }
+                return r;
+            })
+        .def_property_readonly(
+            "shapes",
+            [](FlatSparseTensor<S, FL> *self) {
+                return py::array_t<MKL_INT>(
+                    vector<ssize_t>{(ssize_t)self->n_blocks(), self->rank},
+                    self->shapes.data());
+            })
+        .def_property_readonly(
+            "offsets",
+            [](FlatSparseTensor<S, FL> *self) {
+                return py::array_t<size_t>((ssize_t)self->offsets.size(),
+                                           self->offsets.data());
+            })
+        .def_property_readonly(
+            "data",
+            [](FlatSparseTensor<S, FL> *self) {
+                // the array keeps a reference to the data
+                shared_ptr<vector<FL>> *d =
+                    new shared_ptr<vector<FL>>(self->data);
+                py::capsule base(d, [](void *p) {
+                    delete (shared_ptr<vector<FL>> *)p;
+                });
+                return py::array_t<FL>((ssize_t)(*d)->size(), (*d)->data(),
+                                       base);
+            })
+        .def_static("from_sparse_tensor",
+                    &FlatSparseTensor<S, FL>::from_sparse_tensor,
+                    py::arg("spt"), py::arg("basis"))
+        .def_static("from_mps_tensor",
+                    &FlatSparseTensor<S, FL>::from_mps_tensor, py::arg("i"),
+                    py::arg("mps"))
+        .def_static("from_mpo_tensor",
+                    &FlatSparseTensor<S, FL>::from_mpo_tensor, py::arg("i"),
+                    py::arg("mpo"))
+        .def("to_sparse_tensor", &FlatSparseTensor<S, FL>::to_sparse_tensor,
+             py::arg("basis"));
+
     py::class_<DeterminantTRIE<S, FL>, shared_ptr<DeterminantTRIE<S, FL>>>(
         m, "DeterminantTRIE")
         .def(py::init<int>(), py::arg("n_sites"))
@@ -627,6 +819,15 @@ template <typename S, typename FL> void bind_fl_partition(py::module &m) {
                        &EffectiveHamiltonian<S, FL>::npdm_n_sites)
         .def_readwrite("npdm_center", &EffectiveHamiltonian<S, FL>::npdm_center)
         .def_readwrite("eff_kernel", &EffectiveHamiltonian<S, FL>::eff_kernel)
+        .def_readwrite("screen_thrd", &EffectiveHamiltonian<S, FL>::screen_thrd)
+        .def_readwrite("screen_error",
+                       &EffectiveHamiltonian<S, FL>::screen_error)
+        .def_readwrite("screen_nskip",
+                       &EffectiveHamiltonian<S, FL>::screen_nskip)
+        .def_readwrite("screen_ntotal",
+                       &EffectiveHamiltonian<S, FL>::screen_ntotal)
+        .def_readwrite("screen_verified",
+                       &EffectiveHamiltonian<S, FL>::screen_verified)
         .def("__call__", &EffectiveHamiltonian<S, FL>::operator(), py::arg("b"),
              py::arg("c"), py::arg("idx") = 0, py::arg("factor") = 1.0,
              py::arg("all_reduce") = true)
@@ -794,6 +995,10 @@ void bind_fl_moving_environment(py::module &m, const string &name) {
         .def_readwrite("iprint", &MovingEnvironment<S, FL, FLS>::iprint)
         .def_readwrite("delayed_contraction",
                        &MovingEnvironment<S, FL, FLS>::delayed_contraction)
+        .def_readwrite("left_low_rank_info",
+                       &MovingEnvironment<S, FL, FLS>::left_low_rank_info)
+        .def_readwrite("right_low_rank_info",
+                       &MovingEnvironment<S, FL, FLS>::right_low_rank_info)
         .def_readwrite("fuse_center",
                        &MovingEnvironment<S, FL, FLS>::fuse_center)
         .def_readwrite("save_partition_info",
@@ -1231,6 +1436,7 @@ void bind_fl_expect(py::module &m, const string &name) {
         .def_readwrite("bra_bond_dim", &Expect<S, FL, FLS, FLX>::bra_bond_dim)
         .def_readwrite("ket_bond_dim", &Expect<S, FL, FLS, FLX>::ket_bond_dim)
         .def_readwrite("expectations", &Expect<S, FL, FLS, FLX>::expectations)
+        .def_readwrite("consumer", &Expect<S, FL, FLS, FLX>::consumer)
         .def_readwrite("forward", &Expect<S, FL, FLS, FLX>::forward)
         .def_readwrite("trunc_type", &Expect<S, FL, FLS, FLX>::trunc_type)
         .def_readwrite("ex_type", &Expect<S, FL, FLS, FLX>::ex_type)
@@ -1295,6 +1501,18 @@ void bind_fl_dmrg(py::module &m) {
             return ss.str();
         });
 
+    py::class_<MemoryBudget<S, FL, FLS>, shared_ptr<MemoryBudget<S, FL, FLS>>>(
+        m, "MemoryBudget")
+        .def(py::init<size_t>(), py::arg("max_memory"))
+        .def_readwrite("max_memory", &MemoryBudget<S, FL, FLS>::max_memory)
+        .def_readwrite("min_mode", &MemoryBudget<S, FL, FLS>::min_mode)
+        .def_readwrite("max_mode", &MemoryBudget<S, FL, FLS>::max_mode)
+        .def_readwrite("stack_ratio", &MemoryBudget<S, FL, FLS>::stack_ratio)
+        .def_readwrite("iprint", &MemoryBudget<S, FL, FLS>::iprint)
+        .def_readonly("decisions", &MemoryBudget<S, FL, FLS>::decisions)
+        .def_static("apply", &MemoryBudget<S, FL, FLS>::apply,
+                    py::arg("mode"), py::arg("me"));
+
     py::class_<DMRG<S, FL, FLS>, shared_ptr<DMRG<S, FL, FLS>>>(m, "DMRG")
         .def(py::init<const shared_ptr<MovingEnvironment<S, FL, FLS>> &,
                       const vector<ubond_t> &,
@@ -1328,6 +1546,8 @@ void bind_fl_dmrg(py::module &m) {
                        &DMRG<S, FL, FLS>::davidson_def_max_size)
         .def_readwrite("davidson_shift", &DMRG<S, FL, FLS>::davidson_shift)
         .def_readwrite("davidson_type", &DMRG<S, FL, FLS>::davidson_type)
+        .def_readwrite("davidson_screen_thrd",
+                       &DMRG<S, FL, FLS>::davidson_screen_thrd)
         .def_readwrite("conn_adjust_step", &DMRG<S, FL, FLS>::conn_adjust_step)
         .def_readwrite("energies", &DMRG<S, FL, FLS>::energies)
         .def_readwrite("discarded_weights",
@@ -1365,6 +1585,7 @@ void bind_fl_dmrg(py::module &m) {
                        &DMRG<S, FL, FLS>::site_dependent_bond_dims)
         .def_readwrite("sweep_start_site", &DMRG<S, FL, FLS>::sweep_start_site)
         .def_readwrite("sweep_end_site", &DMRG<S, FL, FLS>::sweep_end_site)
+        .def_readwrite("mem_budget", &DMRG<S, FL, FLS>::mem_budget)
         .def("update_two_dot", &DMRG<S, FL, FLS>::update_two_dot)
         .def("update_one_dot", &DMRG<S, FL, FLS>::update_one_dot)
         .def("update_multi_two_dot", &DMRG<S, FL, FLS>::update_multi_two_dot)
@@ -1869,6 +2090,7 @@ template <typename S, typename FL> void bind_fl_mpo(py::module &m) {
              py::arg("dot"))
         .def("deallocate", &MPO<S, FL>::deallocate)
         .def("deep_copy", &MPO<S, FL>::deep_copy)
+        .def("refresh_site_ops", &MPO<S, FL>::refresh_site_ops)
         .def("build", &MPO<S, FL>::build,
              py::call_guard<checked_ostream_redirect,
                             checked_estream_redirect>())
@@ -2006,6 +2228,13 @@ template <typename S, typename FL> void bind_fl_mpo(py::module &m) {
         .def(py::init<const shared_ptr<HamiltonianQC<S, FL>> &, QCTypes,
                       const string &, int, int>());
 
+    py::class_<MPOQCOneBodyRefresh<S, FL>,
+               shared_ptr<MPOQCOneBodyRefresh<S, FL>>>(m, "MPOQCOneBodyRefresh")
+        .def_static("check", &MPOQCOneBodyRefresh<S, FL>::check,
+                    py::arg("hamil"), py::arg("fcidump"))
+        .def_static("refresh", &MPOQCOneBodyRefresh<S, FL>::refresh,
+                    py::arg("mpo"), py::arg("fcidump"));
+
     py::class_<PDM1MPOQC<S, FL>, shared_ptr<PDM1MPOQC<S, FL>>, MPO<S, FL>>(
         m, "PDM1MPOQC")
         .def(py::init<const shared_ptr<Hamiltonian<S, FL>> &>())
@@ -2416,6 +2645,22 @@ template <typename S = void> void bind_dmrg_types(py::module &m) {
         .value("LeftCopy", OpCachingTypes::LeftCopy)
         .value("RightCopy", OpCachingTypes::RightCopy);
 
+    py::enum_<MemoryModeTypes>(m, "MemoryModeTypes", py::arithmetic())
+        .value("Cached", MemoryModeTypes::Cached)
+        .value("Buffered", MemoryModeTypes::Buffered)
+        .value("Unbuffered", MemoryModeTypes::Unbuffered)
+        .value("FusedRotation", MemoryModeTypes::FusedRotation)
+        .value("FusedMultiplication", MemoryModeTypes::FusedMultiplication);
+
+    py::class_<MemoryBudgetDecision, shared_ptr<MemoryBudgetDecision>>(
+        m, "MemoryBudgetDecision")
+        .def_readonly("site", &MemoryBudgetDecision::site)
+        .def_readonly("forward", &MemoryBudgetDecision::forward)
+        .def_readonly("mode", &MemoryBudgetDecision::mode)
+        .def_readonly("estimated", &MemoryBudgetDecision::estimated)
+        .def_readonly("observed", &MemoryBudgetDecision::observed)
+        .def_readonly("heap", &MemoryBudgetDecision::heap);
+
     py::enum_<ParallelSimpleTypes>(m, "ParallelSimpleTypes", py::arithmetic())
         .value("Nothing", ParallelSimpleTypes::None)
         .value("I", ParallelSimpleTypes::I)
@@ -116,6 +116,10 @@ PYBIND11_MAKE_OPAQUE(map<WickIndexTypes, std::set<WickIndex>>);
 PYBIND11_MAKE_OPAQUE(map<string, pair<WickTensor, vector<WickString>>>);
 PYBIND11_MAKE_OPAQUE(map<pair<string, int>, vector<WickPermutation>>);
 PYBIND11_MAKE_OPAQUE(map<string, pair<WickTensor, WickExpr>>);
+PYBIND11_MAKE_OPAQUE(map<string, NDArray>);
+PYBIND11_MAKE_OPAQUE(map<string, shared_ptr<WickPackedTensor>>);
+PYBIND11_MAKE_OPAQUE(map<WickIndexTypes, MKL_INT>);
+PYBIND11_MAKE_OPAQUE(vector<WickTermProfile>);
 
 template <typename S = void> void bind_nd_array(py::module &m) {
     py::class_<NDArray, shared_ptr<NDArray>>(m, "NDArray",
@@ -689,6 +693,75 @@ template <typename S = void> void bind_wick(py::module &m) {
             ss << *self;
             return ss.str();
         });
+
+    py::class_<WickPackedTensor, shared_ptr<WickPackedTensor>>(
+        m, "WickPackedTensor")
+        .def(py::init<>())
+        .def(py::init<const vector<MKL_INT> &, const vector<int> &>())
+        .def_readwrite("shape", &WickPackedTensor::shape)
+        .def_readwrite("groups", &WickPackedTensor::groups)
+        .def_property_readonly("ndim", &WickPackedTensor::ndim)
+        .def_property_readonly("size", &WickPackedTensor::size)
+        .def_property_readonly("dense_size", &WickPackedTensor::dense_size)
+        .def_property_readonly(
+            "data",
+            [](py::object self) {
+                // a view of the packed data keeping the tensor alive
+                WickPackedTensor *pt = self.cast<WickPackedTensor *>();
+                return py::array_t<double>(pt->data.size(), pt->data.data(),
+                                           self);
+            })
+        .def_static("pack", &WickPackedTensor::pack)
+        .def("unpack", &WickPackedTensor::unpack)
+        .def("full_range", &WickPackedTensor::full_range)
+        .def("unpack_slab", &WickPackedTensor::unpack_slab)
+        .def("unpack_range", &WickPackedTensor::unpack_range)
+        .def("pack_add", &WickPackedTensor::pack_add, py::arg("a"),
+             py::arg("alpha"), py::arg("axis") = -1, py::arg("start") = 0,
+             py::arg("stop") = 0)
+        .def("pack_add_range", &WickPackedTensor::pack_add_range,
+             py::arg("a"), py::arg("alpha"), py::arg("ranges"),
+             py::arg("perms"), py::arg("coeffs"))
+        .def("scale", &WickPackedTensor::scale)
+        .def("permutation_sign", &WickPackedTensor::permutation_sign);
+
+    py::bind_map<map<string, NDArray>>(m, "MapStrNDArray");
+    py::bind_map<map<string, shared_ptr<WickPackedTensor>>>(
+        m, "MapStrWickPackedTensor");
+
+    py::class_<WickTermProfile, shared_ptr<WickTermProfile>>(m,
+                                                             "WickTermProfile")
+        .def(py::init<>())
+        .def_readwrite("istat", &WickTermProfile::istat)
+        .def_readwrite("iterm", &WickTermProfile::iterm)
+        .def_readwrite("left", &WickTermProfile::left)
+        .def_readwrite("script", &WickTermProfile::script)
+        .def_readwrite("flops", &WickTermProfile::flops)
+        .def_readwrite("time", &WickTermProfile::time)
+        .def_readwrite("dense_size", &WickTermProfile::dense_size);
+
+    py::bind_vector<vector<WickTermProfile>>(m, "VectorWickTermProfile");
+    py::bind_map<map<WickIndexTypes, MKL_INT>>(m, "MapWickIndexTypesInt");
+
+    py::class_<WickGraphExecutor, shared_ptr<WickGraphExecutor>>(
+        m, "WickGraphExecutor")
+        .def(py::init<const WickGraph &>())
+        .def_readwrite("graph", &WickGraphExecutor::graph)
+        .def_readwrite("dense", &WickGraphExecutor::dense)
+        .def_readwrite("packed", &WickGraphExecutor::packed)
+        .def_readwrite("type_dims", &WickGraphExecutor::type_dims)
+        .def_readwrite("profile", &WickGraphExecutor::profile)
+        .def_readwrite("max_slab_size", &WickGraphExecutor::max_slab_size)
+        .def_readwrite("parallel_statements",
+                       &WickGraphExecutor::parallel_statements)
+        .def_readwrite("iprint", &WickGraphExecutor::iprint)
+        .def("tensor_key", &WickGraphExecutor::tensor_key)
+        .def("input_names",
+             [](WickGraphExecutor *self) {
+                 set<string> r = self->input_names();
+                 return vector<string>(r.begin(), r.end());
+             })
+        .def("execute", &WickGraphExecutor::execute);
 }
 
 template <typename S = void>
@@ -721,7 +794,9 @@ auto bind_guga(py::module &m)
         .def("initialize", &DistinctRowTable<S>::initialize)
         .def("step_vector_to_arc", &DistinctRowTable<S>::step_vector_to_arc)
         .def("index_of_step_vector",
-             &DistinctRowTable<S>::index_of_step_vector);
+             &DistinctRowTable<S>::index_of_step_vector)
+        .def("step_vector_of_index",
+             &DistinctRowTable<S>::step_vector_of_index);
 
     py::class_<MRCIDistinctRowTable<S>, shared_ptr<MRCIDistinctRowTable<S>>,
                DistinctRowTable<S>>(m, "MRCIDistinctRowTable")
@@ -734,6 +809,81 @@ auto bind_guga(py::module &m)
         .def_readwrite("ts", &MRCIDistinctRowTable<S>::ts)
         .def_readwrite("refs", &MRCIDistinctRowTable<S>::refs)
         .def("initialize_mrci", &MRCIDistinctRowTable<S>::initialize_mrci);
+
+    py::class_<GUGADirectCI<double>, shared_ptr<GUGADirectCI<double>>>(
+        m, "GUGADirectCI")
+        .def(py::init<const shared_ptr<DistinctRowTable<void>> &>())
+        .def_readwrite("drt", &GUGADirectCI<double>::drt)
+        .def_readwrite("ridrt", &GUGADirectCI<double>::ridrt)
+        .def_readonly("n_sites", &GUGADirectCI<double>::n_sites)
+        .def_readonly("n_csf", &GUGADirectCI<double>::n_csf)
+        .def_readonly("n_ri", &GUGADirectCI<double>::n_ri)
+        .def_readwrite("const_e", &GUGADirectCI<double>::const_e)
+        .def_readwrite("iprint", &GUGADirectCI<double>::iprint)
+        .def_readonly("tcoupling", &GUGADirectCI<double>::tcoupling)
+        .def_readonly("tsigma", &GUGADirectCI<double>::tsigma)
+        .def("initialize", &GUGADirectCI<double>::initialize)
+        .def("set_integrals", &GUGADirectCI<double>::set_integrals)
+        .def("diag",
+             [](GUGADirectCI<double> *self) {
+                 py::array_t<double> arx = py::array_t<double>(self->n_csf);
+                 self->diag(DiagonalMatrix(arx.mutable_data(),
+                                           (MKL_INT)self->n_csf));
+                 return arx;
+             })
+        .def("matmul",
+             [](GUGADirectCI<double> *self, const py::array_t<double> &arr) {
+                 py::array_t<double> arx = py::array_t<double>(self->n_csf);
+                 memset(arx.mutable_data(), 0, sizeof(double) * arx.size());
+                 (*self)(MatrixRef((double *)arr.data(), (MKL_INT)arr.size(),
+                                   1),
+                         MatrixRef(arx.mutable_data(), (MKL_INT)arx.size(), 1));
+                 return arx;
+             })
+        .def(
+            "davidson",
+            [](GUGADirectCI<double> *self, int nroots, double conv_thrd,
+               int max_iter) {
+                py::array_t<double> arx =
+                    py::array_t<double>(
+                    vector<ssize_t>{nroots, (ssize_t)self->n_csf});
+                memset(arx.mutable_data(), 0, sizeof(double) * arx.size());
+                vector<MatrixRef> vs;
+                for (int i = 0; i < nroots; i++)
+                    vs.push_back(MatrixRef(arx.mutable_data() + i * self->n_csf,
+                                           (MKL_INT)self->n_csf, 1));
+                vector<double> eners =
+                    self->davidson(vs, conv_thrd, max_iter);
+                return make_pair(eners, arx);
+            },
+            py::arg("nroots") = 1, py::arg("conv_thrd") = 5E-6,
+            py::arg("max_iter") = 5000)
+        .def("make_rdm1",
+             [](GUGADirectCI<double> *self, const py::array_t<double> &bra,
+                const py::array_t<double> &ket) {
+                 vector<double> r = self->make_rdm1(
+                     MatrixRef((double *)bra.data(), (MKL_INT)bra.size(), 1),
+                     MatrixRef((double *)ket.data(), (MKL_INT)ket.size(), 1));
+                 ssize_t n = self->n_sites;
+                 py::array_t<double> arx =
+                     py::array_t<double>(vector<ssize_t>{n, n});
+                 memcpy(arx.mutable_data(), r.data(),
+                        sizeof(double) * r.size());
+                 return arx;
+             })
+        .def("make_rdm2",
+             [](GUGADirectCI<double> *self, const py::array_t<double> &bra,
+                const py::array_t<double> &ket) {
+                 vector<double> r = self->make_rdm2(
+                     MatrixRef((double *)bra.data(), (MKL_INT)bra.size(), 1),
+                     MatrixRef((double *)ket.data(), (MKL_INT)ket.size(), 1));
+                 ssize_t n = self->n_sites;
+                 py::array_t<double> arx =
+                     py::array_t<double>(vector<ssize_t>{n, n, n, n});
+                 memcpy(arx.mutable_data(), r.data(),
+                        sizeof(double) * r.size());
+                 return arx;
+             });
 }
 
 template <typename S = void>
@@ -197,7 +197,10 @@ template <typename S> void bind_mpo_sci(py::module &m) {
         .def_readwrite("ACPF2_mode", &DMRGSCIAQCC<S>::ACPF2_mode)
         .def_readwrite("RAS_mode", &DMRGSCIAQCC<S>::RAS_mode)
         .def_readwrite("delta_e", &DMRGSCIAQCC<S>::delta_e)
-        .def_readwrite("ref_energy", &DMRGSCIAQCC<S>::ref_energy);
+        .def_readwrite("ref_energy", &DMRGSCIAQCC<S>::ref_energy)
+        .def_readwrite("shift_continuation",
+                       &DMRGSCIAQCC<S>::shift_continuation)
+        .def_readwrite("aqcc_ndav", &DMRGSCIAQCC<S>::aqcc_ndav);
 
     py::class_<MPOQCSCI<S>, shared_ptr<MPOQCSCI<S>>, MPO<S, double>>(m, "MPOQCSCI")
         .def_readwrite("mode", &MPOQCSCI<S>::mode)
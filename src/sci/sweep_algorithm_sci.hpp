@@ -37,6 +37,7 @@ template <typename S> struct DMRGSCI : DMRG<S, double, double> {
     using DMRG<S, double, double>::noise_type;
     using DMRG<S, double, double>::decomp_type;
     using typename DMRG<S, double, double>::Iteration;
+    typedef typename DMRG<S, double, double>::FPLS FPLS;
     bool last_site_svd = false;
     bool last_site_1site = false; // ATTENTION: only use in two site algorithm
     DMRGSCI(const shared_ptr<MovingEnvironment<S, double, double>> &me,
@@ -288,12 +289,15 @@ template <typename S> struct LinearSCI : Linear<S, double, double> {
 };
 
 template <typename S> struct DMRGSCIAQCC : DMRGSCI<S> {
+    typedef typename DMRGSCI<S>::FPLS FPLS;
     using DMRGSCI<S>::iprint;
     using DMRGSCI<S>::me;
     using DMRGSCI<S>::ext_mes;
     using DMRGSCI<S>::davidson_soft_max_iter;
     using DMRGSCI<S>::davidson_max_iter;
     using DMRGSCI<S>::davidson_rel_conv_thrd;
+    using DMRGSCI<S>::davidson_def_min_size;
+    using DMRGSCI<S>::davidson_def_max_size;
     using DMRGSCI<S>::noise_type;
     using DMRGSCI<S>::decomp_type;
     using DMRGSCI<S>::energies;
@@ -318,6 +322,9 @@ template <typename S> struct DMRGSCIAQCC : DMRGSCI<S> {
                            // be fully converged as we do sweeps anyways.
     double smallest_energy =
         numeric_limits<double>::max(); // Smallest energy during sweep
+    bool shift_continuation = true; // Keep H x and D x of the Davidson
+                                    // subspace across AQCC shift iterations
+    int aqcc_ndav = 0; // Davidson iterations spent in the AQCC shift loops
 
     /** Frozen/CAS mode: Only one big site at the end
      * => ME + S * SME  **/
@@ -430,11 +437,40 @@ template <typename S> struct DMRGSCIAQCC : DMRGSCI<S> {
         return aqcc_eff;
     }
 
-    tuple<double, int, size_t, double> two_dot_eigs_and_perturb(
+    /** Non-reference part D of the AQCC operator H + delta_e * D **/
+    shared_ptr<LinearEffectiveHamiltonian<S, double>>
+    get_aqcc_shift_eff(shared_ptr<EffectiveHamiltonian<S, double>> h_eff,
+                       shared_ptr<EffectiveHamiltonian<S, double>> d_eff1,
+                       shared_ptr<EffectiveHamiltonian<S, double>> d_eff2,
+                       shared_ptr<EffectiveHamiltonian<S, double>> d_eff3,
+                       shared_ptr<EffectiveHamiltonian<S, double>> d_eff4) {
+        const auto fac = 1. - g_factor;
+        const auto fac2 = 1. - g_factor2;
+        shared_ptr<LinearEffectiveHamiltonian<S, double>> shift_eff;
+        if (not RAS_mode) {
+            if (ACPF2_mode) {
+                shift_eff = fac * d_eff1 + fac2 * d_eff2;
+            } else {
+                shift_eff = fac * d_eff1;
+            }
+        } else {
+            if (ACPF2_mode) {
+                shift_eff = fac * (d_eff1 - d_eff2) + fac2 * (d_eff3 - d_eff4);
+            } else {
+                shift_eff = fac * (d_eff1 - d_eff2);
+            }
+        }
+        sweep_max_eff_ham_size =
+            max(sweep_max_eff_ham_size, h_eff->op->get_total_memory() +
+                                            shift_eff->get_op_total_memory());
+        return shift_eff;
+    }
+
+    tuple<FPLS, int, size_t, double> two_dot_eigs_and_perturb(
         const bool forward, const int i, const double davidson_conv_thrd,
         const double noise,
         shared_ptr<SparseMatrixGroup<S, double>> &pket) override {
-        tuple<double, int, size_t, double> pdi;
+        tuple<FPLS, int, size_t, double> pdi;
         _t.get_time();
         shared_ptr<EffectiveHamiltonian<S, double>> d_eff1, d_eff2, d_eff3,
             d_eff4;
@@ -464,7 +500,8 @@ template <typename S> struct DMRGSCIAQCC : DMRGSCI<S> {
         //       for the first site as well.
         pdi = aqcc_eff->eigs(iprint >= 3, davidson_conv_thrd,
                              davidson_rel_conv_thrd, davidson_max_iter,
-                             davidson_soft_max_iter, DavidsonTypes::Normal, 0.0,
+                             davidson_soft_max_iter, davidson_def_min_size,
+                             davidson_def_max_size, DavidsonTypes::Normal, 0.0,
                              me->para_rule);
         teig += _t.get_time();
         if ((noise_type & NoiseTypes::Perturbative) && noise != 0)
@@ -479,15 +516,15 @@ template <typename S> struct DMRGSCIAQCC : DMRGSCI<S> {
             }
         }
         const auto energy = std::get<0>(pdi) + me->mpo->const_e;
-        smallest_energy = min(energy, smallest_energy);
+        smallest_energy = min((double)energy, smallest_energy);
         delta_e = smallest_energy - ref_energy;
         return pdi;
     }
-    tuple<double, int, size_t, double> one_dot_eigs_and_perturb(
+    tuple<FPLS, int, size_t, double> one_dot_eigs_and_perturb(
         const bool forward, const bool fuse_left, const int i_site,
         const double davidson_conv_thrd, const double noise,
         shared_ptr<SparseMatrixGroup<S, double>> &pket) override {
-        tuple<double, int, size_t, double> pdi{0., 0, 0,
+        tuple<FPLS, int, size_t, double> pdi{0., 0, 0,
                                                0.}; // energy, ndav, nflop, tdav
         _t.get_time();
         const auto doAQCC = (i_site == me->n_sites - 1 or i_site == 0) and
@@ -524,39 +561,23 @@ template <typename S> struct DMRGSCIAQCC : DMRGSCI<S> {
                 size_t idx =
                     min_element(
                         sweep_energies.begin(), sweep_energies.end(),
-                        [](const vector<double> &x, const vector<double> &y) {
+                        [](const vector<FPLS> &x, const vector<FPLS> &y) {
                             return x[0] < y[0];
                         }) -
                     sweep_energies.begin();
                 smallest_energy =
-                    min(sweep_energies[idx].at(0), smallest_energy);
+                    min((double)sweep_energies[idx].at(0), smallest_energy);
                 delta_e = smallest_energy - ref_energy;
             }
             double last_delta_e = delta_e;
             if (iprint >= 2) {
                 cout << endl;
             }
-            for (int itAQCC = 0; itAQCC < max_aqcc_iter; ++itAQCC) {
-                //
-                // Shift non-reference ops
-                //
-                auto aqcc_eff =
-                    get_aqcc_eff(h_eff, d_eff1, d_eff2, d_eff3, d_eff4);
-                //
-                // EIG and conv check
-                //
-                // TODO The best would be to do the adaption of the diagonal
-                // directly in eigs
-                const auto pdi2 = aqcc_eff->eigs(
-                    iprint >= 3, davidson_conv_thrd, davidson_rel_conv_thrd,
-                    davidson_max_iter, davidson_soft_max_iter,
-                    DavidsonTypes::Normal, 0.0, me->para_rule);
-                const auto energy = std::get<0>(pdi2) + me->mpo->const_e;
-                const auto ndav = std::get<1>(pdi2);
-                std::get<0>(pdi) = std::get<0>(pdi2);
-                std::get<1>(pdi) += std::get<1>(pdi2); // ndav
-                std::get<2>(pdi) += std::get<2>(pdi2); // nflop
-                std::get<3>(pdi) += std::get<3>(pdi2); // tdav
+            int itAQCC = 0, last_ndav = 0;
+            // called with the eigenvalue for the current delta_e
+            auto aqcc_update = [&](double ener, int ndav,
+                                   double &shift) -> bool {
+                const auto energy = ener + me->mpo->const_e;
                 auto converged = smallest_energy < energy;
                 if (not converged) {
                     smallest_energy = energy;
@@ -569,7 +590,7 @@ template <typename S> struct DMRGSCIAQCC : DMRGSCI<S> {
                     cout << "\tAQCC: " << setw(2) << itAQCC << " E=" << fixed
                          << setw(17) << setprecision(10) << energy
                          << " Delta=" << fixed << setw(17) << setprecision(10)
-                         << delta_e << " nDav=" << setw(3) << ndav
+                         << delta_e << " nDav=" << setw(3) << ndav - last_ndav
                          << " conv=" << (converged ? "T" : "F");
                     if (itAQCC == 0) {
                         cout << "; init Delta=" << fixed << setw(17)
@@ -579,10 +600,49 @@ template <typename S> struct DMRGSCIAQCC : DMRGSCI<S> {
                     }
                 }
                 last_delta_e = delta_e;
-                if (converged) {
-                    break;
-                }
+                last_ndav = ndav;
+                shift = delta_e;
+                return converged or ++itAQCC >= max_aqcc_iter;
+            };
+            if (shift_continuation) {
+                //
+                // H x and D x are kept for all shifts of the non-reference
+                // ops, so that only the projected problem is re-solved
+                //
+                double shift = delta_e;
+                auto aqcc_h_eff =
+                    LinearEffectiveHamiltonian<S, double>::linearize(h_eff);
+                auto aqcc_shift_eff =
+                    get_aqcc_shift_eff(h_eff, d_eff1, d_eff2, d_eff3, d_eff4);
+                pdi = aqcc_h_eff->shift_eigs(
+                    aqcc_shift_eff, shift, aqcc_update, iprint >= 3,
+                    davidson_conv_thrd, davidson_rel_conv_thrd,
+                    davidson_max_iter, davidson_soft_max_iter,
+                    davidson_def_min_size, davidson_def_max_size,
+                    me->para_rule);
+            }
+            for (bool done = shift_continuation; !done;) {
+                //
+                // Shift non-reference ops
+                //
+                auto aqcc_eff =
+                    get_aqcc_eff(h_eff, d_eff1, d_eff2, d_eff3, d_eff4);
+                //
+                // EIG and conv check
+                //
+                const auto pdi2 = aqcc_eff->eigs(
+                    iprint >= 3, davidson_conv_thrd, davidson_rel_conv_thrd,
+                    davidson_max_iter, davidson_soft_max_iter,
+                    davidson_def_min_size, davidson_def_max_size,
+                    DavidsonTypes::Normal, 0.0, me->para_rule);
+                std::get<0>(pdi) = std::get<0>(pdi2);
+                std::get<1>(pdi) += std::get<1>(pdi2); // ndav
+                std::get<2>(pdi) += std::get<2>(pdi2); // nflop
+                std::get<3>(pdi) += std::get<3>(pdi2); // tdav
+                double shift;
+                done = aqcc_update(std::get<0>(pdi2), std::get<1>(pdi), shift);
             }
+            aqcc_ndav += std::get<1>(pdi);
             // vv restore printing
             if (iprint >= 2) {
                 if (last_site_1site) {
@@ -598,10 +658,11 @@ template <typename S> struct DMRGSCIAQCC : DMRGSCI<S> {
             auto aqcc_eff = get_aqcc_eff(h_eff, d_eff1, d_eff2, d_eff3, d_eff4);
             pdi = aqcc_eff->eigs(iprint >= 3, davidson_conv_thrd,
                                  davidson_rel_conv_thrd, davidson_max_iter,
-                                 davidson_soft_max_iter, DavidsonTypes::Normal,
+                                 davidson_soft_max_iter, davidson_def_min_size,
+                                 davidson_def_max_size, DavidsonTypes::Normal,
                                  0.0, me->para_rule);
             const auto energy = std::get<0>(pdi) + me->mpo->const_e;
-            smallest_energy = min(energy, smallest_energy);
+            smallest_energy = min((double)energy, smallest_energy);
             delta_e = smallest_energy - ref_energy;
         }
         teig += _t.get_time();
@@ -624,11 +685,14 @@ template <typename S> struct DMRGSCIAQCC : DMRGSCI<S> {
 
 // hrl: DMRG-CI-AQCC and related methods
 template <typename S> struct DMRGSCIAQCCOLD : DMRGSCI<S> {
+    typedef typename DMRGSCI<S>::FPLS FPLS;
     using DMRGSCI<S>::iprint;
     using DMRGSCI<S>::me;
     using DMRGSCI<S>::davidson_soft_max_iter;
     using DMRGSCI<S>::davidson_max_iter;
     using DMRGSCI<S>::davidson_rel_conv_thrd;
+    using DMRGSCI<S>::davidson_def_min_size;
+    using DMRGSCI<S>::davidson_def_max_size;
     using DMRGSCI<S>::noise_type;
     using DMRGSCI<S>::decomp_type;
     using DMRGSCI<S>::energies;
@@ -661,11 +725,11 @@ template <typename S> struct DMRGSCIAQCCOLD : DMRGSCI<S> {
         modify_mpo_mats(true, 0.0); // Save diagonals
     }
 
-    tuple<double, int, size_t, double> one_dot_eigs_and_perturb(
+    tuple<FPLS, int, size_t, double> one_dot_eigs_and_perturb(
         const bool forward, const bool fuse_left, const int i_site,
         const double davidson_conv_thrd, const double noise,
         shared_ptr<SparseMatrixGroup<S, double>> &pket) override {
-        tuple<double, int, size_t, double> pdi{0., 0, 0,
+        tuple<FPLS, int, size_t, double> pdi{0., 0, 0,
                                                0.}; // energy, ndav, nflop, tdav
         _t.get_time();
         const auto doAQCC =
@@ -685,7 +749,7 @@ template <typename S> struct DMRGSCIAQCCOLD : DMRGSCI<S> {
                 size_t idx =
                     min_element(
                         sweep_energies.begin(), sweep_energies.end(),
-                        [](const vector<double> &x, const vector<double> &y) {
+                        [](const vector<FPLS> &x, const vector<FPLS> &y) {
                             return x[0] < y[0];
                         }) -
                     sweep_energies.begin();
@@ -728,8 +792,12 @@ template <typename S> struct DMRGSCIAQCCOLD : DMRGSCI<S> {
                         h_eff->tf->opf->cg);
                     h_eff->diag->info->cinfo = diag_info;
                     h_eff->tf->tensor_product_diagonal(
-                        h_eff->op->mat->data[0], h_eff->op->lopt,
-                        h_eff->op->ropt, h_eff->diag, h_eff->opdq);
+                        h_eff->op->mat->data[0],
+                        h_eff->op->stacked_mat == nullptr
+                            ? nullptr
+                            : h_eff->op->stacked_mat->data[0],
+                        h_eff->op->lopt, h_eff->op->ropt, h_eff->diag,
+                        h_eff->opdq);
                     if (h_eff->tf->opf->seq->mode == SeqTypes::Auto)
                         h_eff->tf->opf->seq->auto_perform();
                     h_eff->compute_diag = true;
@@ -737,8 +805,12 @@ template <typename S> struct DMRGSCIAQCCOLD : DMRGSCI<S> {
                     h_eff->diag->clear();
                     h_eff->diag->info->cinfo = diag_info;
                     h_eff->tf->tensor_product_diagonal(
-                        h_eff->op->mat->data[0], h_eff->op->lopt,
-                        h_eff->op->ropt, h_eff->diag, h_eff->opdq);
+                        h_eff->op->mat->data[0],
+                        h_eff->op->stacked_mat == nullptr
+                            ? nullptr
+                            : h_eff->op->stacked_mat->data[0],
+                        h_eff->op->lopt, h_eff->op->ropt, h_eff->diag,
+                        h_eff->opdq);
                 }
                 //
                 // EIG and conv check
@@ -749,7 +821,8 @@ template <typename S> struct DMRGSCIAQCCOLD : DMRGSCI<S> {
                 const auto pdi2 =
                     h_eff->eigs(nullptr, iprint >= 3, davidson_conv_thrd,
                                 davidson_rel_conv_thrd, davidson_max_iter,
-                                davidson_soft_max_iter, DavidsonTypes::Normal,
+                                davidson_soft_max_iter, davidson_def_min_size,
+                                davidson_def_max_size, DavidsonTypes::Normal,
                                 0.0, me->para_rule);
                 const auto energy = std::get<0>(pdi2) + me->mpo->const_e;
                 const auto ndav = std::get<1>(pdi2);
@@ -802,7 +875,8 @@ template <typename S> struct DMRGSCIAQCCOLD : DMRGSCI<S> {
         } else {
             pdi = h_eff->eigs(nullptr, iprint >= 3, davidson_conv_thrd,
                               davidson_rel_conv_thrd, davidson_max_iter,
-                              davidson_soft_max_iter, DavidsonTypes::Normal,
+                              davidson_soft_max_iter, davidson_def_min_size,
+                              davidson_def_max_size, DavidsonTypes::Normal,
                               0.0, me->para_rule);
         }
         teig += _t.get_time();
@@ -0,0 +1,101 @@
+
+/*
+ * block2: Efficient MPO implementation of quantum chemistry DMRG
+ * Copyright (C) 2020-2021 Huanchen Zhai <hczhai@caltech.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/** Minimal harness for the performance regression benchmarks. */
+
+#pragma once
+
+#include "block2_core.hpp"
+#include <algorithm>
+#include <functional>
+#include <map>
+#include <numeric>
+#include <string>
+#include <tuple>
+#include <vector>
+
+using namespace std;
+using namespace block2;
+
+namespace block2 {
+
+/** Timing state of one benchmark. A benchmark function sets up its data,
+ * calls ``run`` with the kernel to be timed, and optionally records the
+ * number of floating-point operations and extra parameters. */
+struct BenchState {
+    int warmup = 1, repeat = 5;
+    // number of floating-point operations in one kernel call
+    double nflop = 0;
+    vector<double> times;
+    map<string, string> params;
+    template <typename F> void run(F &&f) {
+        Timer t;
+        for (int i = 0; i < warmup; i++)
+            f();
+        times.clear();
+        for (int i = 0; i < repeat; i++) {
+            t.get_time();
+            f();
+            times.push_back(t.get_time());
+        }
+    }
+    template <typename T> void set_param(const string &key, const T &val) {
+        stringstream ss;
+        ss << val;
+        params[key] = ss.str();
+    }
+    double t_min() const {
+        return times.size() == 0 ? 0 : *min_element(times.begin(), times.end());
+    }
+    double t_median() const {
+        if (times.size() == 0)
+            return 0;
+        vector<double> x = times;
+        sort(x.begin(), x.end());
+        return x.size() % 2 ? x[x.size() / 2]
+                            : (x[x.size() / 2 - 1] + x[x.size() / 2]) / 2;
+    }
+    double t_mean() const {
+        return times.size() == 0
+                   ? 0
+                   : accumulate(times.begin(), times.end(), 0.0) / times.size();
+    }
+};
+
+/** Global list of registered benchmarks (group, name, function). */
+struct BenchRegistry {
+    typedef function<void(BenchState &)> BenchFunc;
+    static vector<tuple<string, string, BenchFunc>> &entries() {
+        static vector<tuple<string, string, BenchFunc>> x;
+        return x;
+    }
+    static int add(const string &group, const string &name, BenchFunc f) {
+        entries().push_back(make_tuple(group, name, f));
+        return (int)entries().size();
+    }
+};
+
+} // namespace block2
+
+#define BLOCK2_BENCH(group, name)                                              \
+    static void bench_##group##_##name(BenchState &);                          \
+    static int bench_reg_##group##_##name =                                    \
+        BenchRegistry::add(#group, #name, bench_##group##_##name);             \
+    static void bench_##group##_##name(BenchState &st)
@@ -0,0 +1,165 @@
+
+#include "bench.hpp"
+
+using namespace block2;
+
+// batched independent GEMMs of one shape: c[i] = a[i] * b[i]
+static void bench_batch_gemm(BenchState &st, int m, int k, int n, int nbatch) {
+    shared_ptr<VectorAllocator<double>> d_alloc =
+        make_shared<VectorAllocator<double>>();
+    vector<double> a((size_t)m * k * nbatch), b((size_t)k * n * nbatch),
+        c((size_t)m * n * nbatch);
+    Random::fill<double>(a.data(), a.size());
+    Random::fill<double>(b.data(), b.size());
+    shared_ptr<BatchGEMMSeq<double>> seq =
+        make_shared<BatchGEMMSeq<double>>(1LL << 30, SeqTypes::Auto);
+    st.run([&]() {
+        for (int i = 0; i < nbatch; i++)
+            seq->multiply(MatrixRef(a.data() + (size_t)m * k * i, m, k), false,
+                          MatrixRef(b.data() + (size_t)k * n * i, k, n), false,
+                          MatrixRef(c.data() + (size_t)m * n * i, m, n), 1.0,
+                          0.0);
+        seq->auto_perform();
+    });
+    st.nflop = 2.0 * m * k * n * nbatch;
+    st.set_param("shape", to_string(m) + "x" + to_string(k) + "x" +
+                              to_string(n) + "x" + to_string(nbatch));
+}
+
+BLOCK2_BENCH(gemm, batch_16) { bench_batch_gemm(st, 16, 16, 16, 20000); }
+
+BLOCK2_BENCH(gemm, batch_64) { bench_batch_gemm(st, 64, 64, 64, 2000); }
+
+BLOCK2_BENCH(gemm, batch_256) { bench_batch_gemm(st, 256, 256, 256, 64); }
+
+BLOCK2_BENCH(gemm, batch_tall) { bench_batch_gemm(st, 1000, 32, 1000, 16); }
+
+// batched rotation c += l^T a r, as used in operator renormalization
+BLOCK2_BENCH(gemm, rotate_64) {
+    const int ma = 128, mc = 64, nbatch = 500;
+    vector<double> a((size_t)ma * ma * nbatch), c((size_t)mc * mc * nbatch),
+        l((size_t)ma * mc), r((size_t)ma * mc);
+    Random::fill<double>(a.data(), a.size());
+    Random::fill<double>(l.data(), l.size());
+    Random::fill<double>(r.data(), r.size());
+    shared_ptr<BatchGEMMSeq<double>> seq =
+        make_shared<BatchGEMMSeq<double>>(1LL << 30, SeqTypes::Auto);
+    st.run([&]() {
+        for (int i = 0; i < nbatch; i++)
+            seq->rotate(MatrixRef(a.data() + (size_t)ma * ma * i, ma, ma),
+                        MatrixRef(c.data() + (size_t)mc * mc * i, mc, mc),
+                        MatrixRef(l.data(), ma, mc), true,
+                        MatrixRef(r.data(), ma, mc), false, 1.0);
+        seq->auto_perform();
+    });
+    st.nflop = 2.0 * ((double)ma * ma * mc + (double)ma * mc * mc) * nbatch;
+}
+
+static void bench_fcidump_read(BenchState &st, const string &filename) {
+    st.repeat = min(st.repeat, 3);
+    st.run([&]() {
+        shared_ptr<FCIDUMP<double>> fcidump = make_shared<FCIDUMP<double>>();
+        fcidump->read(filename);
+        fcidump->deallocate();
+    });
+    st.set_param("file", filename);
+}
+
+BLOCK2_BENCH(fcidump, read_n2_pvdz) {
+    bench_fcidump_read(st, "data/N2.CAS.PVDZ.T0.FCIDUMP");
+}
+
+BLOCK2_BENCH(fcidump, read_h2o_tzvp) {
+    bench_fcidump_read(st, "data/H2O.TZVP.FCIDUMP");
+}
+
+static void bench_fp_codec(BenchState &st, bool write) {
+    const size_t n = 1LL << 24;
+    vector<double> arr(n), arx(n);
+    Random::fill<double>(arr.data(), n, -1, 1);
+    FPCodec<double> fpc(1E-8, 1024);
+    stringstream ss;
+    fpc.write_array(ss, arr.data(), n);
+    st.run([&]() {
+        if (write) {
+            stringstream sx;
+            fpc.write_array(sx, arr.data(), n);
+        } else {
+            ss.clear();
+            ss.seekg(0);
+            fpc.read_array(ss, arx.data(), n);
+        }
+    });
+    st.set_param("size", Parsing::to_size_string(n * sizeof(double)));
+    st.set_param("ratio", (double)fpc.ncpsd / fpc.ndata);
+}
+
+BLOCK2_BENCH(fpcodec, write) { bench_fp_codec(st, true); }
+
+BLOCK2_BENCH(fpcodec, read) { bench_fp_codec(st, false); }
+
+// dense svd of one (m x n) block, as in the decomposition of one sector
+static void bench_svd(BenchState &st, int m, int n) {
+    const int k = min(m, n);
+    vector<double> a((size_t)m * n), x((size_t)m * n), l((size_t)m * k),
+        s(k), r((size_t)k * n);
+    Random::fill<double>(a.data(), a.size());
+    st.run([&]() {
+        x = a;
+        MatrixFunctions::svd(MatrixRef(x.data(), m, n), MatrixRef(l.data(), m, k),
+                             MatrixRef(s.data(), 1, k),
+                             MatrixRef(r.data(), k, n));
+    });
+    st.set_param("shape", to_string(m) + "x" + to_string(n));
+}
+
+BLOCK2_BENCH(svd, dense_500) { bench_svd(st, 500, 500); }
+
+BLOCK2_BENCH(svd, dense_2000x250) { bench_svd(st, 2000, 250); }
+
+// MPS site tensor (left, physical, right) with SZ labels, in the layout of
+// pyblock2.algebra: bond labels up to n_max electrons, m states per label
+static shared_ptr<BlockSparseTensor<SZ, double>>
+bench_mps_tensor(int n_max, MKL_INT m) {
+    const SZ phys[4] = {SZ(0, 0, 0), SZ(1, 1, 0), SZ(1, -1, 0), SZ(2, 0, 0)};
+    set<SZ> bond;
+    for (int n = 0; n <= n_max; n++)
+        for (int twos = -n; twos <= n; twos += 2)
+            bond.insert(SZ(n, twos, 0));
+    shared_ptr<BlockSparseTensor<SZ, double>> r =
+        make_shared<BlockSparseTensor<SZ, double>>();
+    for (auto &ql : bond)
+        for (auto &qp : phys)
+            if (bond.count(ql + qp)) {
+                r->add_block(vector<SZ>{ql, qp, ql + qp},
+                             vector<MKL_INT>{m, 1, m});
+                Random::fill<double>(r->data.back()->data(),
+                                     r->data.back()->size(), -1, 1);
+            }
+    return r;
+}
+
+// two-site tensor from two MPS site tensors, as in Tensor.contract
+BLOCK2_BENCH(block_sparse, contract_two_site) {
+    shared_ptr<BlockSparseTensor<SZ, double>> a = bench_mps_tensor(6, 24),
+                                              b = bench_mps_tensor(6, 24);
+    size_t n_blocks = 0;
+    st.run([&]() {
+        n_blocks = BlockSparseTensor<SZ, double>::contract(
+                       a, b, vector<int>{2}, vector<int>{0})
+                       ->n_blocks();
+    });
+    st.set_param("n_blocks", n_blocks);
+}
+
+BLOCK2_BENCH(block_sparse, left_canonicalize) {
+    shared_ptr<BlockSparseTensor<SZ, double>> a = bench_mps_tensor(6, 24);
+    st.run([&]() { a->left_canonicalize(); });
+    st.set_param("n_blocks", a->n_blocks());
+}
+
+BLOCK2_BENCH(block_sparse, left_compress) {
+    shared_ptr<BlockSparseTensor<SZ, double>> a = bench_mps_tensor(6, 24);
+    st.run([&]() { a->left_compress(200); });
+    st.set_param("n_blocks", a->n_blocks());
+}
@@ -0,0 +1,655 @@
+
+#include "bench.hpp"
+#include "block2_dmrg.hpp"
+#include <dirent.h>
+
+using namespace block2;
+
+static shared_ptr<HamiltonianQC<SU2, double>>
+bench_hamil(const string &filename, PGTypes pg, bool compressed = false) {
+    shared_ptr<FCIDUMP<double>> fcidump =
+        compressed ? make_shared<CompressedFCIDUMP<double>>(1E-13)
+                   : make_shared<FCIDUMP<double>>();
+    fcidump->read(filename);
+    vector<uint8_t> orbsym = fcidump->template orb_sym<uint8_t>();
+    transform(orbsym.begin(), orbsym.end(), orbsym.begin(),
+              [pg](uint8_t x) { return (uint8_t)PointGroup::swap_pg(pg)(x); });
+    return make_shared<HamiltonianQC<SU2, double>>(SU2(0), fcidump->n_sites(),
+                                                   orbsym, fcidump);
+}
+
+static void bench_free_hamil(const shared_ptr<HamiltonianQC<SU2, double>> &h) {
+    shared_ptr<FCIDUMP<double>> fcidump = h->fcidump;
+    h->deallocate();
+    fcidump->deallocate();
+}
+
+static shared_ptr<MPO<SU2, double>>
+bench_mpo(const shared_ptr<HamiltonianQC<SU2, double>> &hamil) {
+    shared_ptr<MPO<SU2, double>> mpo = make_shared<MPOQC<SU2, double>>(
+        hamil, QCTypes::Conventional, "HQC");
+    mpo->basis = hamil->basis;
+    return make_shared<SimplifiedMPO<SU2, double>>(
+        mpo, make_shared<RuleQC<SU2, double>>(), true, true,
+        OpNamesSet({OpNames::R, OpNames::RD}));
+}
+
+// DMRG with fixed bond dimension and sweeps; one sweep per timed call
+static void bench_dmrg_sweeps(BenchState &st, const string &filename,
+                              PGTypes pg, ubond_t bond_dim, int n_sweeps) {
+    shared_ptr<HamiltonianQC<SU2, double>> hamil = bench_hamil(filename, pg);
+    shared_ptr<MPO<SU2, double>> mpo = bench_mpo(hamil);
+    SU2 target(hamil->fcidump->n_elec(), hamil->fcidump->twos(),
+               PointGroup::swap_pg(pg)(hamil->fcidump->isym()));
+    shared_ptr<MPSInfo<SU2>> mps_info = make_shared<MPSInfo<SU2>>(
+        mpo->n_sites, hamil->vacuum, target, mpo->basis);
+    mps_info->set_bond_dimension(bond_dim);
+    shared_ptr<MPS<SU2, double>> mps =
+        make_shared<MPS<SU2, double>>(mpo->n_sites, 0, 2);
+    mps->initialize(mps_info);
+    mps->random_canonicalize();
+    mps->save_mutable();
+    mps->deallocate();
+    mps_info->save_mutable();
+    mps_info->deallocate_mutable();
+    shared_ptr<MovingEnvironment<SU2, double, double>> me =
+        make_shared<MovingEnvironment<SU2, double, double>>(mpo, mps, mps,
+                                                            "DMRG");
+    me->init_environments(false);
+    me->delayed_contraction = OpNamesSet::normal_ops();
+    me->cached_contraction = true;
+    shared_ptr<DMRG<SU2, double, double>> dmrg =
+        make_shared<DMRG<SU2, double, double>>(
+            me, vector<ubond_t>{bond_dim}, vector<double>{1E-6});
+    dmrg->iprint = 0;
+    dmrg->davidson_soft_max_iter = 50;
+    st.warmup = 0, st.repeat = n_sweeps;
+    int isw = 0;
+    bool forward = mps->center == 0;
+    double nflop = 0, teig = 0, tblk = 0;
+    double energy = 0;
+    st.run([&]() {
+        energy = (double)dmrg->solve(isw + 1, forward, 0, isw);
+        nflop += (double)dmrg->sweep_cumulative_nflop;
+        teig += dmrg->teig, tblk += dmrg->tblk;
+        forward = !forward, isw++;
+    });
+    st.nflop = nflop / n_sweeps;
+    st.set_param("n_sites", mpo->n_sites);
+    st.set_param("bond_dim", (uint32_t)bond_dim);
+    st.set_param("energy", to_string(energy));
+    st.set_param("teig", teig);
+    st.set_param("tblk", tblk);
+    mps_info->deallocate();
+    me->remove_partition_files();
+    mpo->deallocate();
+    bench_free_hamil(hamil);
+}
+
+BLOCK2_BENCH(macro, dmrg_n2_pvdz_m250) {
+    bench_dmrg_sweeps(st, "data/N2.CAS.PVDZ.T0.FCIDUMP", PGTypes::D2H, 250, 4);
+}
+
+BLOCK2_BENCH(macro, dmrg_hubbard_l16_m250) {
+    bench_dmrg_sweeps(st, "data/HUBBARD-L16.FCIDUMP", PGTypes::C1, 250, 4);
+}
+
+static void bench_build_mpo(BenchState &st, bool compressed) {
+    shared_ptr<HamiltonianQC<SU2, double>> hamil =
+        bench_hamil("data/N2.CAS.PVDZ.T0.FCIDUMP", PGTypes::D2H, compressed);
+    st.repeat = min(st.repeat, 3);
+    st.run([&]() {
+        shared_ptr<MPO<SU2, double>> mpo = bench_mpo(hamil);
+        mpo->deallocate();
+    });
+    st.set_param("n_sites", hamil->n_sites);
+    bench_free_hamil(hamil);
+}
+
+BLOCK2_BENCH(mpo, build_n2_pvdz) { bench_build_mpo(st, false); }
+
+// same MPO with integrals stored in compressed form
+BLOCK2_BENCH(mpo, build_n2_pvdz_compressed) { bench_build_mpo(st, true); }
+
+// GeneralMPO with the bipartite algorithm for random integrals without
+// point group symmetry, where the largest bipartite graphs are O(K^2) x O(K^2)
+static void bench_general_mpo(BenchState &st, uint16_t n_sites) {
+    shared_ptr<FCIDUMP<double>> fcidump = make_shared<FCIDUMP<double>>();
+    vector<double> t(TInt<double>(n_sites).size()),
+        v(V8Int<double>(n_sites).size());
+    Random::rand_seed(1234);
+    Random::fill<double>(t.data(), t.size());
+    Random::fill<double>(v.data(), v.size());
+    fcidump->initialize_su2(n_sites, n_sites, 0, 1, 0.0, t.data(), t.size(),
+                            v.data(), v.size());
+    shared_ptr<GeneralFCIDUMP<double>> gfd =
+        GeneralFCIDUMP<double>::initialize_from_qc(fcidump, ElemOpTypes::SU2)
+            ->adjust_order();
+    fcidump->deallocate();
+    shared_ptr<GeneralHamiltonian<SU2, double>> gham =
+        make_shared<GeneralHamiltonian<SU2, double>>(
+            SU2(0), n_sites, vector<typename SU2::pg_t>(n_sites, 0));
+    st.warmup = 0, st.repeat = min(st.repeat, 1);
+    int bond_dim = 0;
+    st.run([&]() {
+        shared_ptr<MPO<SU2, double>> mpo =
+            make_shared<GeneralMPO<SU2, double>>(
+                gham, gfd, MPOAlgorithmTypes::FastBipartite, 0.0, -1, 0);
+        mpo->build();
+        for (int i = 0; i < mpo->n_sites - 1; i++)
+            bond_dim = max(bond_dim,
+                           (int)mpo->right_operator_names[i]->data.size());
+        mpo->deallocate();
+    });
+    st.set_param("n_sites", n_sites);
+    st.set_param("n_terms", gfd->data[0].size() + gfd->data[1].size());
+    st.set_param("bond_dim", bond_dim);
+    gham->deallocate();
+}
+
+BLOCK2_BENCH(mpo, general_bipartite_k50) { bench_general_mpo(st, 50); }
+
+BLOCK2_BENCH(mpo, general_bipartite_k100) { bench_general_mpo(st, 100); }
+
+// effective hamiltonian multiplication (tensor_product_multiply over all
+// terms) or wavefunction splitting at the middle of a random N2 MPS
+static void bench_middle_site(BenchState &st, bool split) {
+    shared_ptr<HamiltonianQC<SU2, double>> hamil =
+        bench_hamil("data/N2.CAS.PVDZ.T0.FCIDUMP", PGTypes::D2H);
+    shared_ptr<MPO<SU2, double>> mpo = bench_mpo(hamil);
+    const ubond_t bond_dim = 500;
+    const int i = mpo->n_sites / 2 - 1;
+    SU2 target(hamil->fcidump->n_elec(), 0, 0);
+    shared_ptr<MPSInfo<SU2>> mps_info = make_shared<MPSInfo<SU2>>(
+        mpo->n_sites, hamil->vacuum, target, mpo->basis);
+    mps_info->set_bond_dimension(bond_dim);
+    shared_ptr<MPS<SU2, double>> mps =
+        make_shared<MPS<SU2, double>>(mpo->n_sites, i, 2);
+    mps->initialize(mps_info);
+    mps->random_canonicalize();
+    mps->save_mutable();
+    mps->deallocate();
+    mps_info->save_mutable();
+    mps_info->deallocate_mutable();
+    shared_ptr<MovingEnvironment<SU2, double, double>> me =
+        make_shared<MovingEnvironment<SU2, double, double>>(mpo, mps, mps,
+                                                            "DMRG");
+    me->init_environments(false);
+    me->move_to(i);
+    frame_<double>()->activate(0);
+    mps->load_tensor(i);
+    shared_ptr<SparseMatrix<SU2, double>> wfn = mps->tensors[i];
+    if (!split) {
+        shared_ptr<EffectiveHamiltonian<SU2, double>> h_eff =
+            me->eff_ham(FuseTypes::FuseLR, true, false, wfn, wfn);
+        MatrixRef b(wfn->data, (MKL_INT)wfn->total_memory, 1);
+        MatrixRef c(nullptr, (MKL_INT)wfn->total_memory, 1);
+        c.allocate();
+        h_eff->precompute();
+        size_t nflop = 0;
+        st.run([&]() {
+            c.clear();
+            h_eff->tf->opf->seq->cumulative_nflop = 0;
+            if (h_eff->tf->opf->seq->mode == SeqTypes::Auto ||
+                (h_eff->tf->opf->seq->mode & SeqTypes::Tasked))
+                h_eff->tf->operator()(b, c, 1.0);
+            else
+                (*h_eff)(b, c, 0, 1.0);
+            nflop = h_eff->tf->opf->seq->cumulative_nflop;
+        });
+        h_eff->post_precompute();
+        st.nflop = (double)nflop;
+        c.deallocate();
+        h_eff->deallocate();
+    } else {
+        vector<double> spectra;
+        st.run([&]() {
+            shared_ptr<SparseMatrix<SU2, double>> left, right;
+            MovingEnvironment<SU2, double, double>::split_wavefunction_svd(
+                mps->info->target, wfn, (int)bond_dim, true, true, left, right,
+                1E-14, false, spectra);
+            right->deallocate();
+            left->deallocate();
+            right->info->deallocate();
+            left->info->deallocate();
+        });
+    }
+    st.set_param("wfn_size", wfn->total_memory);
+    mps->unload_tensor(i);
+    mps_info->deallocate();
+    me->remove_partition_files();
+    mpo->deallocate();
+    bench_free_hamil(hamil);
+}
+
+BLOCK2_BENCH(dmrg, eff_ham_multiply) { bench_middle_site(st, false); }
+
+BLOCK2_BENCH(dmrg, split_wavefunction_svd) { bench_middle_site(st, true); }
+
+// save and load of the whole MPO in memory, per-operator or compact layout
+static void bench_mpo_io(BenchState &st, bool compact) {
+    shared_ptr<HamiltonianQC<SU2, double>> hamil =
+        bench_hamil("data/N2.CAS.PVDZ.T0.FCIDUMP", PGTypes::D2H);
+    shared_ptr<MPO<SU2, double>> mpo = bench_mpo(hamil);
+    frame_<double>()->compact_operator_storage = compact;
+    size_t nbytes = 0;
+    st.run([&]() {
+        stringstream ss;
+        mpo->save_data(ss);
+        nbytes = ss.str().length();
+        shared_ptr<MPO<SU2, double>> rmpo =
+            make_shared<MPO<SU2, double>>(0, mpo->tag);
+        rmpo->load_data(ss);
+        rmpo->deallocate();
+    });
+    frame_<double>()->compact_operator_storage = false;
+    st.set_param("size", Parsing::to_size_string(nbytes));
+    mpo->deallocate();
+    bench_free_hamil(hamil);
+}
+
+BLOCK2_BENCH(io, mpo_save_load) { bench_mpo_io(st, false); }
+
+BLOCK2_BENCH(io, mpo_save_load_compact) { bench_mpo_io(st, true); }
+
+// one-electron field on the diagonal, keeping the point group symmetry
+template <typename FL>
+static shared_ptr<FCIDUMP<FL>>
+bench_field_fcidump(const shared_ptr<FCIDUMP<FL>> &fcidump, double field) {
+    shared_ptr<FCIDUMP<FL>> fd = fcidump->deep_copy();
+    const uint16_t n = fd->n_sites();
+    for (uint16_t i = 0; i < n; i++)
+        fd->ts[0](i, i) += (FL)(field * ((double)i - n / 2) / n);
+    return fd;
+}
+
+// 20-point scan of the field strength, with the MPO refreshed in place for
+// the new one-electron integrals or rebuilt at every point
+static void bench_field_scan(BenchState &st, bool refresh) {
+    shared_ptr<HamiltonianQC<SU2, double>> hamil =
+        bench_hamil("data/N2.CAS.PVDZ.T0.FCIDUMP", PGTypes::D2H);
+    shared_ptr<FCIDUMP<double>> fcidump = hamil->fcidump;
+    vector<shared_ptr<FCIDUMP<double>>> fds;
+    for (int k = 0; k < 20; k++)
+        fds.push_back(bench_field_fcidump(fcidump, 0.01 * (k + 1)));
+    shared_ptr<MPO<SU2, double>> mpo = refresh ? bench_mpo(hamil) : nullptr;
+    st.repeat = min(st.repeat, 3);
+    st.run([&]() {
+        for (auto &fd : fds)
+            if (refresh)
+                MPOQCOneBodyRefresh<SU2, double>::refresh(mpo, fd);
+            else {
+                hamil->fcidump = fd;
+                shared_ptr<MPO<SU2, double>> xmpo = bench_mpo(hamil);
+                xmpo->deallocate();
+            }
+    });
+    st.set_param("n_sites", hamil->n_sites);
+    st.set_param("n_points", fds.size());
+    if (mpo != nullptr)
+        mpo->deallocate();
+    hamil->fcidump = fcidump;
+    bench_free_hamil(hamil);
+}
+
+BLOCK2_BENCH(mpo, field_scan_rebuild) { bench_field_scan(st, false); }
+
+BLOCK2_BENCH(mpo, field_scan_refresh) { bench_field_scan(st, true); }
+
+// real-time TDDMRG (tangent space) in a time-dependent one-body field
+// E(t) = E0 sin(w t); the MPO is refreshed or rebuilt at every time step,
+// followed by a new initialization of the environments
+static void bench_td_field(BenchState &st, bool refresh) {
+    typedef complex<double> FL;
+    PGTypes pg = PGTypes::D2H;
+    shared_ptr<FCIDUMP<FL>> fcidump = make_shared<FCIDUMP<FL>>();
+    fcidump->read("data/N2.CAS.PVDZ.T0.FCIDUMP");
+    vector<uint8_t> orbsym = fcidump->template orb_sym<uint8_t>();
+    transform(orbsym.begin(), orbsym.end(), orbsym.begin(),
+              [pg](uint8_t x) { return (uint8_t)PointGroup::swap_pg(pg)(x); });
+    const double dt = 0.05, e0 = 0.05, w = 2.0;
+    const int n_steps = 2;
+    const ubond_t bond_dim = 40;
+    shared_ptr<HamiltonianQC<SU2, FL>> hamil =
+        make_shared<HamiltonianQC<SU2, FL>>(SU2(0), fcidump->n_sites(), orbsym,
+                                            bench_field_fcidump(fcidump, 0.0));
+    const auto &get_mpo = [&hamil]() {
+        shared_ptr<MPO<SU2, FL>> mpo = make_shared<MPOQC<SU2, FL>>(
+            hamil, QCTypes::Conventional, "HQC");
+        mpo->basis = hamil->basis;
+        return (shared_ptr<MPO<SU2, FL>>)make_shared<SimplifiedMPO<SU2, FL>>(
+            mpo, make_shared<RuleQC<SU2, FL>>(), true, true,
+            OpNamesSet({OpNames::R, OpNames::RD}));
+    };
+    shared_ptr<MPO<SU2, FL>> mpo = get_mpo();
+    SU2 target(fcidump->n_elec(), 0, 0);
+    shared_ptr<MPSInfo<SU2>> mps_info = make_shared<MPSInfo<SU2>>(
+        mpo->n_sites, hamil->vacuum, target, mpo->basis);
+    mps_info->set_bond_dimension(bond_dim);
+    shared_ptr<MPS<SU2, FL>> mps =
+        make_shared<MPS<SU2, FL>>(mpo->n_sites, 0, 2);
+    mps->initialize(mps_info);
+    mps->random_canonicalize();
+    mps->save_mutable();
+    mps->deallocate();
+    mps_info->save_mutable();
+    mps_info->deallocate_mutable();
+    shared_ptr<MovingEnvironment<SU2, FL, FL>> me =
+        make_shared<MovingEnvironment<SU2, FL, FL>>(mpo, mps, mps, "TD");
+    me->init_environments(false);
+    me->delayed_contraction = OpNamesSet::normal_ops();
+    shared_ptr<TimeEvolution<SU2, FL, FL>> te =
+        make_shared<TimeEvolution<SU2, FL, FL>>(me, vector<ubond_t>{bond_dim},
+                                                TETypes::TangentSpace);
+    te->iprint = 0;
+    st.warmup = 0, st.repeat = 1;
+    int it = 0;
+    double tmpo = 0, tenv = 0;
+    Timer t;
+    st.run([&]() {
+        for (int k = 0; k < n_steps; k++, it++) {
+            t.get_time();
+            shared_ptr<FCIDUMP<FL>> fd =
+                bench_field_fcidump(fcidump, e0 * sin(w * dt * it));
+            if (refresh)
+                MPOQCOneBodyRefresh<SU2, FL>::refresh(mpo, fd);
+            else {
+                hamil->fcidump = fd;
+                mpo->deallocate();
+                mpo = get_mpo();
+                me->mpo = mpo;
+            }
+            tmpo += t.get_time();
+            me->init_environments(false);
+            tenv += t.get_time();
+            te->solve(2, FL(0.0, dt / 2), me->ket->center == 0);
+        }
+    });
+    st.set_param("n_sites", mpo->n_sites);
+    st.set_param("bond_dim", (uint32_t)bond_dim);
+    st.set_param("n_steps", n_steps);
+    st.set_param("tmpo", tmpo);
+    st.set_param("tenv", tenv);
+    mps_info->deallocate();
+    me->remove_partition_files();
+    mpo->deallocate();
+    hamil->deallocate();
+}
+
+BLOCK2_BENCH(td, field_rebuild) { bench_td_field(st, false); }
+
+BLOCK2_BENCH(td, field_refresh) { bench_td_field(st, true); }
+
+static size_t bench_count_files(const string &dir) {
+    size_t r = 0;
+    DIR *d = opendir(dir.c_str());
+    if (d == nullptr)
+        return r;
+    for (struct dirent *e = readdir(d); e != nullptr; e = readdir(d))
+        r += e->d_name[0] != '.';
+    closedir(d);
+    return r;
+}
+
+// one sweep of a 60-site SU2 Hubbard chain with restart_dir, storing the
+// environments as one file per partition or in a single container file
+static void bench_env_files(BenchState &st, bool container) {
+    shared_ptr<FCIDUMP<double>> fcidump = make_shared<HubbardFCIDUMP>(60);
+    shared_ptr<HamiltonianQC<SU2, double>> hamil =
+        make_shared<HamiltonianQC<SU2, double>>(
+            SU2(0), fcidump->n_sites(), vector<uint8_t>(fcidump->n_sites(), 0),
+            fcidump);
+    shared_ptr<MPO<SU2, double>> mpo = bench_mpo(hamil);
+    shared_ptr<DataFrame<double>> frame = frame_<double>();
+    const string save_dir = frame->save_dir;
+    frame->save_dir = save_dir + (container ? "/env.ct" : "/env.fs");
+    frame->restart_dir = frame->save_dir + ".restart";
+    for (const string &dir : {frame->save_dir, frame->restart_dir})
+        if (!Parsing::path_exists(dir))
+            Parsing::mkdir(dir);
+    if (container)
+        frame->partition_container = make_shared<FileContainer>(
+            frame->save_dir + "/" + frame->prefix_distri + ".PART.bin", true);
+    const ubond_t bond_dim = 100;
+    SU2 target(fcidump->n_sites(), 0, 0);
+    shared_ptr<MPSInfo<SU2>> mps_info = make_shared<MPSInfo<SU2>>(
+        mpo->n_sites, hamil->vacuum, target, mpo->basis);
+    mps_info->set_bond_dimension(bond_dim);
+    shared_ptr<MPS<SU2, double>> mps =
+        make_shared<MPS<SU2, double>>(mpo->n_sites, 0, 2);
+    mps->initialize(mps_info);
+    mps->random_canonicalize();
+    mps->save_mutable();
+    mps->deallocate();
+    mps_info->save_mutable();
+    mps_info->deallocate_mutable();
+    shared_ptr<MovingEnvironment<SU2, double, double>> me =
+        make_shared<MovingEnvironment<SU2, double, double>>(mpo, mps, mps,
+                                                            "DMRG");
+    me->save_partition_info = true;
+    st.warmup = 0, st.repeat = 1;
+    double energy = 0;
+    st.run([&]() {
+        me->init_environments(false);
+        shared_ptr<DMRG<SU2, double, double>> dmrg =
+            make_shared<DMRG<SU2, double, double>>(
+                me, vector<ubond_t>{bond_dim}, vector<double>{1E-6});
+        dmrg->iprint = 0;
+        dmrg->davidson_soft_max_iter = 50;
+        energy = (double)dmrg->solve(1, mps->center == 0, 0);
+        frame->reset_buffer(1);
+    });
+    st.set_param("n_sites", mpo->n_sites);
+    st.set_param("bond_dim", (uint32_t)bond_dim);
+    st.set_param("energy", to_string(energy));
+    st.set_param("save_files", bench_count_files(frame->save_dir));
+    st.set_param("restart_files", bench_count_files(frame->restart_dir));
+    mps_info->deallocate();
+    me->remove_partition_files();
+    frame->partition_container = nullptr;
+    frame->save_dir = save_dir, frame->restart_dir = "";
+    mpo->deallocate();
+    hamil->deallocate();
+}
+
+BLOCK2_BENCH(io, env_files_hubbard_l60) { bench_env_files(st, false); }
+
+BLOCK2_BENCH(io, env_container_hubbard_l60) { bench_env_files(st, true); }
+
+// four-point scan on the bundled N2 CAS(10e, 26o)/cc-pVDZ integrals (D2H),
+// converged from random MPS at every point (cold) or from the MPS of the
+// previous point after orbital alignment and a short schedule (warm).
+// No AO overlaps are bundled; the orbitals of consecutive points are taken
+// to correspond in order, so the alignment is trivial and the warm start
+// reuses the MPS as is. rotate_mps (the Givens rotation of the MPS) is not
+// exercised here.
+static void bench_pes_scan(BenchState &st, bool warm) {
+    const PGTypes pg = PGTypes::D2H;
+    const int n_points = 4;
+    const ubond_t bond_dim = 100;
+    const double tol = 1E-6;
+    vector<shared_ptr<HamiltonianQC<SU2, double>>> hamils;
+    vector<shared_ptr<MPO<SU2, double>>> mpos;
+    vector<vector<uint8_t>> orbsyms;
+    for (int k = 0; k < n_points; k++) {
+        hamils.push_back(bench_hamil(
+            "data/N2.CAS.PVDZ.T" + to_string(k) + ".FCIDUMP", pg));
+        mpos.push_back(bench_mpo(hamils.back()));
+        orbsyms.push_back(hamils.back()->fcidump->template orb_sym<uint8_t>());
+    }
+    shared_ptr<FCIDUMP<double>> fcidump = hamils[0]->fcidump;
+    const int n = fcidump->n_sites();
+    vector<double> overlap(n * n, 0);
+    for (int i = 0; i < n; i++)
+        overlap[i * n + i] = 1;
+    vector<shared_ptr<GeometryContinuation<SU2, double>>> gcs(n_points);
+    for (int k = 1; k < n_points; k++) {
+        gcs[k] = make_shared<GeometryContinuation<SU2, double>>(
+            overlap, n, orbsyms[k - 1], orbsyms[k]);
+        gcs[k]->iprint = 0;
+    }
+    SU2 vacuum(0), target(fcidump->n_elec(), fcidump->twos(),
+                          PointGroup::swap_pg(pg)(fcidump->isym()));
+    st.warmup = 0, st.repeat = 1;
+    int n_sweeps = 0;
+    double max_dw = 0;
+    vector<double> energies;
+    st.run([&]() {
+        shared_ptr<MPSInfo<SU2>> mps_info = nullptr;
+        shared_ptr<MPS<SU2, double>> mps = nullptr;
+        for (int k = 0; k < n_points; k++) {
+            vector<double> noises = {1E-4, 1E-4, 1E-5, 1E-5, 0};
+            if (warm && k != 0) {
+                max_dw = max(max_dw,
+                             (double)gcs[k]->rotate_mps(mps, 2 * bond_dim));
+                noises = vector<double>{1E-5, 0};
+            } else {
+                if (mps_info != nullptr)
+                    mps_info->deallocate();
+                mps_info = make_shared<MPSInfo<SU2>>(n, vacuum, target,
+                                                     mpos[k]->basis);
+                mps_info->set_bond_dimension(bond_dim);
+                Random::rand_seed(1234);
+                mps = make_shared<MPS<SU2, double>>(n, 0, 2);
+                mps->initialize(mps_info);
+                mps->random_canonicalize();
+                mps->save_mutable();
+                mps->deallocate();
+                mps_info->save_mutable();
+                mps_info->deallocate_mutable();
+            }
+            shared_ptr<MovingEnvironment<SU2, double, double>> me =
+                make_shared<MovingEnvironment<SU2, double, double>>(
+                    mpos[k], mps, mps, "DMRG");
+            me->init_environments(false);
+            shared_ptr<DMRG<SU2, double, double>> dmrg =
+                make_shared<DMRG<SU2, double, double>>(
+                    me, vector<ubond_t>{bond_dim}, noises);
+            dmrg->iprint = 0;
+            dmrg->davidson_soft_max_iter = 50;
+            energies.push_back(
+                (double)dmrg->solve(20, mps->center == 0, tol));
+            n_sweeps += (int)dmrg->energies.size();
+            me->remove_partition_files();
+        }
+        mps_info->deallocate();
+    });
+    int n_permuted = 0;
+    for (int k = 1; k < n_points; k++)
+        n_permuted += gcs[k]->n_permuted();
+    st.set_param("n_sites", n);
+    st.set_param("n_points", n_points);
+    st.set_param("bond_dim", (uint32_t)bond_dim);
+    st.set_param("n_sweeps", n_sweeps);
+    st.set_param("n_permuted", n_permuted);
+    st.set_param("max_discarded_weight", max_dw);
+    for (int k = 0; k < n_points; k++) {
+        stringstream ss;
+        ss << fixed << setprecision(10) << energies[k];
+        st.set_param("energy_" + to_string(k), ss.str());
+    }
+    for (int k = n_points - 1; k >= 0; k--) {
+        mpos[k]->deallocate();
+        bench_free_hamil(hamils[k]);
+    }
+}
+
+BLOCK2_BENCH(pes, n2_scan_cold) { bench_pes_scan(st, false); }
+
+BLOCK2_BENCH(pes, n2_scan_warm) { bench_pes_scan(st, true); }
+
+static shared_ptr<MovingEnvironment<SU2, double, double>>
+bench_ss_me(const shared_ptr<MPO<SU2, double>> &mpo, SU2 vacuum, SU2 target,
+            ubond_t bond_dim, int center, int iroot) {
+    shared_ptr<MPSInfo<SU2>> mps_info = make_shared<MPSInfo<SU2>>(
+        mpo->n_sites, vacuum, target, mpo->basis);
+    mps_info->set_bond_dimension(bond_dim);
+    mps_info->tag = "KET" + Parsing::to_string(iroot);
+    Random::rand_seed(1234 + iroot);
+    shared_ptr<MPS<SU2, double>> mps =
+        make_shared<MPS<SU2, double>>(mpo->n_sites, center, 2);
+    mps->initialize(mps_info);
+    mps->random_canonicalize();
+    mps->save_mutable();
+    mps->deallocate();
+    mps_info->save_mutable();
+    mps_info->deallocate_mutable();
+    shared_ptr<MovingEnvironment<SU2, double, double>> me =
+        make_shared<MovingEnvironment<SU2, double, double>>(
+            mpo, mps, mps, "DMRG" + Parsing::to_string(iroot));
+    me->init_environments(false);
+    me->delayed_contraction = OpNamesSet::normal_ops();
+    return me;
+}
+
+// lowest states from state-specific DMRG, optimized one root after
+// another (each projected against the converged lower roots)
+static void bench_state_specific(BenchState &st) {
+    const PGTypes pg = PGTypes::D2H;
+    shared_ptr<HamiltonianQC<SU2, double>> hamil =
+        bench_hamil("data/N2.CAS.6-31G.FCIDUMP", pg);
+    shared_ptr<MPO<SU2, double>> mpo = bench_mpo(hamil);
+    shared_ptr<MPO<SU2, double>> impo =
+        make_shared<IdentityMPO<SU2, double>>(hamil);
+    impo = make_shared<SimplifiedMPO<SU2, double>>(
+        impo, make_shared<Rule<SU2, double>>());
+    SU2 target(hamil->fcidump->n_elec(), hamil->fcidump->twos(),
+               PointGroup::swap_pg(pg)(hamil->fcidump->isym()));
+    const ubond_t bond_dim = 100;
+    const int n_roots = 3, n_sweeps = 30;
+    const double tol = 1E-6;
+    const vector<double> noises = {1E-5, 1E-5, 1E-6, 1E-6, 0.0};
+    st.warmup = 0, st.repeat = 1;
+    vector<double> energies(n_roots);
+    int n_total_sweeps = 0;
+    st.run([&]() {
+        vector<shared_ptr<MovingEnvironment<SU2, double, double>>> mes;
+        vector<shared_ptr<MovingEnvironment<SU2, double, double>>> xmes;
+        n_total_sweeps = 0;
+        for (int ir = 0; ir < n_roots; ir++) {
+            const int center = ir == 0 ? 0 : mes[ir - 1]->ket->center;
+            mes.push_back(bench_ss_me(mpo, hamil->vacuum, target, bond_dim,
+                                      center, ir));
+            shared_ptr<DMRG<SU2, double, double>> dmrg =
+                make_shared<DMRG<SU2, double, double>>(
+                    mes[ir], vector<ubond_t>{bond_dim}, noises);
+            for (int j = 0; j < ir; j++) {
+                shared_ptr<MovingEnvironment<SU2, double, double>> xme =
+                    make_shared<MovingEnvironment<SU2, double, double>>(
+                        impo, mes[ir]->ket, mes[j]->ket,
+                        "PJ" + mes[j]->ket->info->tag);
+                xme->delayed_contraction = OpNamesSet::normal_ops();
+                xme->init_environments(false);
+                dmrg->ext_mpss.push_back(mes[j]->ket);
+                dmrg->ext_mes.push_back(xme);
+                xmes.push_back(xme);
+            }
+            dmrg->projection_weights = vector<double>(ir, 5.0);
+            dmrg->noise_type = NoiseTypes::ReducedPerturbativeCollected;
+            dmrg->iprint = 0;
+            energies[ir] = (double)dmrg->solve(
+                n_sweeps, mes[ir]->ket->center == 0, tol);
+            n_total_sweeps += (int)dmrg->energies.size();
+        }
+        for (auto &xme : xmes)
+            xme->remove_partition_files();
+        for (auto &me : mes)
+            me->remove_partition_files();
+        for (int ir = n_roots - 1; ir >= 0; ir--)
+            mes[ir]->ket->info->deallocate();
+    });
+    st.set_param("n_sites", mpo->n_sites);
+    st.set_param("bond_dim", (uint32_t)bond_dim);
+    st.set_param("n_roots", n_roots);
+    st.set_param("n_sweeps", n_total_sweeps);
+    for (int ir = 0; ir < n_roots; ir++) {
+        stringstream ss;
+        ss << fixed << setprecision(10) << energies[ir];
+        st.set_param("energy_" + Parsing::to_string(ir), ss.str());
+    }
+    impo->deallocate();
+    mpo->deallocate();
+    bench_free_hamil(hamil);
+}
+
+BLOCK2_BENCH(excited, n2_631g_sequential) { bench_state_specific(st); }
@@ -0,0 +1,133 @@
+
+/*
+ * block2: Efficient MPO implementation of quantum chemistry DMRG
+ * Copyright (C) 2020-2021 Huanchen Zhai <hczhai@caltech.edu>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ *
+ */
+
+/** Driver of the performance regression benchmarks.
+ *
+ *   block2_bench [--filter <substring>] [--repeat <n>] [--threads <n>]
+ *                [--json <file>] [--list]
+ *
+ * The timings are written as JSON, which can be compared against a stored
+ * baseline using unit_test/bench/compare_bench.py.
+ */
+
+#include "bench.hpp"
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+using namespace std;
+using namespace block2;
+
+static string json_escape(const string &s) {
+    string r;
+    for (char c : s)
+        if (c == '"' || c == '\\')
+            r += '\\', r += c;
+        else
+            r += c;
+    return r;
+}
+
+int main(int argc, char *argv[]) {
+    string filter = "", json_file = "";
+    int repeat = 0, n_threads = 4;
+    bool list_only = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--filter") == 0 && i + 1 < argc)
+            filter = argv[++i];
+        else if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+            json_file = argv[++i];
+        else if (strcmp(argv[i], "--repeat") == 0 && i + 1 < argc)
+            repeat = Parsing::to_int(argv[++i]);
+        else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            n_threads = Parsing::to_int(argv[++i]);
+        else if (strcmp(argv[i], "--list") == 0)
+            list_only = true;
+        else {
+            cerr << "usage: " << argv[0]
+                 << " [--filter <substring>] [--repeat <n>] [--threads <n>]"
+                    " [--json <file>] [--list]"
+                 << endl;
+            return 1;
+        }
+    }
+    frame_<double>() =
+        make_shared<DataFrame<double>>(1LL << 28, 1LL << 30, "nodex");
+    frame_<double>()->use_main_stack = false;
+    frame_<double>()->minimal_disk_usage = true;
+    stringstream json;
+    json << "{" << endl;
+    json << "  \"threads\": " << n_threads << "," << endl;
+    json << "  \"benchmarks\": [";
+    int nb = 0;
+    for (auto &b : BenchRegistry::entries()) {
+        const string name = get<0>(b) + "/" + get<1>(b);
+        if (filter != "" && name.find(filter) == string::npos)
+            continue;
+        if (list_only) {
+            cout << name << endl;
+            continue;
+        }
+        // every benchmark starts from the same threading and random state
+        threading_() = make_shared<Threading>(
+            ThreadingTypes::OperatorBatchedGEMM | ThreadingTypes::Global,
+            n_threads, n_threads, 1);
+        threading_()->seq_type = SeqTypes::Tasked;
+        Random::rand_seed(1234);
+        BenchState st;
+        if (repeat != 0)
+            st.repeat = repeat;
+        cout << setw(40) << left << name << right;
+        cout.flush();
+        get<2>(b)(st);
+        frame_<double>()->activate(0);
+        assert(ialloc_()->used == 0 && dalloc_<double>()->used == 0);
+        const double tmed = st.t_median();
+        const double gflops = tmed == 0 ? 0 : st.nflop / tmed * 1E-9;
+        cout << " T(median) = " << fixed << setprecision(6) << setw(12) << tmed
+             << " T(min) = " << setw(12) << st.t_min()
+             << " GFLOP/s = " << setprecision(3) << setw(9) << gflops << endl;
+        json << (nb++ == 0 ? "" : ",") << endl;
+        json << "    {\"name\": \"" << json_escape(name) << "\", \"group\": \""
+             << json_escape(get<0>(b)) << "\", \"repeat\": " << st.times.size()
+             << scientific << setprecision(8)
+             << ", \"time_median\": " << tmed
+             << ", \"time_min\": " << st.t_min()
+             << ", \"time_mean\": " << st.t_mean()
+             << ", \"nflop\": " << st.nflop << ", \"gflops\": " << gflops
+             << ", \"params\": {";
+        int np = 0;
+        for (auto &p : st.params)
+            json << (np++ == 0 ? "" : ", ") << "\"" << json_escape(p.first)
+                 << "\": \"" << json_escape(p.second) << "\"";
+        json << "}}";
+    }
+    json << endl << "  ]" << endl << "}" << endl;
+    if (json_file != "" && !list_only) {
+        ofstream ofs(json_file.c_str());
+        if (!ofs.good())
+            throw runtime_error("cannot write '" + json_file + "'.");
+        ofs << json.str();
+        ofs.close();
+    }
+    frame_<double>() = nullptr;
+    return 0;
+}
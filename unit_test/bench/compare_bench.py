@@ -0,0 +1,86 @@
+#!/usr/bin/env python3
+#  block2: Efficient MPO implementation of quantum chemistry DMRG
+#  Copyright (C) 2020-2021 Huanchen Zhai <hczhai@caltech.edu>
+#
+#  This program is free software: you can redistribute it and/or modify
+#  it under the terms of the GNU General Public License as published by
+#  the Free Software Foundation, either version 3 of the License, or
+#  (at your option) any later version.
+#
+#  This program is distributed in the hope that it will be useful,
+#  but WITHOUT ANY WARRANTY; without even the implied warranty of
+#  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+#  GNU General Public License for more details.
+#
+#  You should have received a copy of the GNU General Public License
+#  along with this program. If not, see <https://www.gnu.org/licenses/>.
+#
+#
+
+"""
+Compare the JSON output of block2_bench against a stored baseline.
+
+    python3 compare_bench.py baseline.json current.json [--threshold 0.10]
+        [--min-time 0.005]
+
+A benchmark is flagged as a regression when its median time is slower than
+the baseline by more than ``threshold`` (relative) and ``min-time`` seconds
+(absolute). The exit code is 1 if any regression is found.
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(fn):
+    with open(fn) as f:
+        data = json.load(f)
+    return data, {b["name"]: b for b in data["benchmarks"]}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n\n")[1])
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=0.10)
+    parser.add_argument("--min-time", type=float, default=0.005)
+    args = parser.parse_args()
+
+    base_data, base = load(args.baseline)
+    curr_data, curr = load(args.current)
+    if base_data.get("threads") != curr_data.get("threads"):
+        print(
+            "WARNING: thread counts differ (%s vs %s)"
+            % (base_data.get("threads"), curr_data.get("threads"))
+        )
+
+    n_reg = 0
+    print("%-40s %12s %12s %8s  %s" % ("NAME", "BASE(s)", "CURR(s)", "RATIO", ""))
+    for name in sorted(set(base) | set(curr)):
+        if name not in curr:
+            tb = base[name]["time_median"]
+            print("%-40s %12.6f %12s %8s  MISSING" % (name, tb, "--", "--"))
+            continue
+        if name not in base:
+            tc = curr[name]["time_median"]
+            print("%-40s %12s %12.6f %8s  NEW" % (name, "--", tc, "--"))
+            continue
+        tb, tc = base[name]["time_median"], curr[name]["time_median"]
+        ratio = tc / tb if tb != 0 else float("inf")
+        mark = ""
+        if tc - tb > args.min_time and ratio > 1 + args.threshold:
+            mark = "REGRESSION"
+            n_reg += 1
+        elif tb - tc > args.min_time and ratio < 1 / (1 + args.threshold):
+            mark = "faster"
+        print("%-40s %12.6f %12.6f %8.3f  %s" % (name, tb, tc, ratio, mark))
+
+    if n_reg != 0:
+        print("%d regression(s) found." % n_reg)
+        sys.exit(1)
+    print("No regressions.")
+
+
+if __name__ == "__main__":
+    main()
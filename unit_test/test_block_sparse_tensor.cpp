@@ -0,0 +1,346 @@
+
+#include "block2_core.hpp"
+#include <gtest/gtest.h>
+
+using namespace block2;
+
+class TestBlockSparseTensor : public ::testing::Test {
+  protected:
+    static const int n_tests = 100;
+    void SetUp() override {
+        Random::rand_seed(0);
+        threading_() = make_shared<Threading>(
+            ThreadingTypes::OperatorBatchedGEMM | ThreadingTypes::Global, 2, 2,
+            1);
+    }
+    void TearDown() override {}
+};
+
+typedef vector<pair<SZ, int>> Bond;
+
+inline void fill_random(double *data, size_t n) {
+    Random::fill<double>(data, n, -1, 1);
+}
+
+inline void fill_random(complex<double> *data, size_t n) {
+    Random::complex_fill<double>(data, n, -1, 1);
+}
+
+template <typename FL>
+shared_ptr<BlockSparseTensor<SZ, FL>>
+conj_tensor(const shared_ptr<BlockSparseTensor<SZ, FL>> &t) {
+    shared_ptr<BlockSparseTensor<SZ, FL>> r =
+        make_shared<BlockSparseTensor<SZ, FL>>();
+    for (size_t ib = 0; ib < t->n_blocks(); ib++) {
+        r->add_block(t->q_labels[ib], t->shapes[ib]);
+        for (size_t i = 0; i < t->size(ib); i++)
+            (*r->data[ib])[i] = xconj<FL>((*t->data[ib])[i]);
+    }
+    return r;
+}
+
+// random bond with at most nq labels of dim in [0, 4)
+inline Bond random_bond(int nq) {
+    Bond r;
+    for (int i = 0; i < nq; i++) {
+        SZ q(Random::rand_int(0, 4), Random::rand_int(-2, 3), 0);
+        bool found = false;
+        for (auto &x : r)
+            found = found || x.first == q;
+        if (!found)
+            r.push_back(make_pair(q, Random::rand_int(0, 4)));
+    }
+    return r;
+}
+
+// random tensor with a random subset of all label combinations
+template <typename FL>
+shared_ptr<BlockSparseTensor<SZ, FL>> random_tensor(const vector<Bond> &bonds) {
+    shared_ptr<BlockSparseTensor<SZ, FL>> r =
+        make_shared<BlockSparseTensor<SZ, FL>>();
+    vector<int> idx(bonds.size(), 0);
+    for (auto &b : bonds)
+        if (b.size() == 0)
+            return r;
+    for (;;) {
+        if (Random::rand_int(0, 3) != 0) {
+            vector<SZ> q;
+            vector<MKL_INT> sh;
+            for (size_t i = 0; i < bonds.size(); i++)
+                q.push_back(bonds[i][idx[i]].first),
+                    sh.push_back(bonds[i][idx[i]].second);
+            r->add_block(q, sh);
+            fill_random(r->data.back()->data(), r->data.back()->size());
+        }
+        int i = (int)bonds.size() - 1;
+        for (; i >= 0 && ++idx[i] == (int)bonds[i].size(); i--)
+            idx[i] = 0;
+        if (i < 0)
+            break;
+    }
+    return r;
+}
+
+// dense array and the label of each dense index
+template <typename FL> struct DenseTensor {
+    vector<size_t> shape;
+    vector<vector<SZ>> labels;
+    vector<FL> data;
+    DenseTensor(const vector<Bond> &bonds) {
+        size_t n = 1;
+        for (auto &b : bonds) {
+            labels.push_back(vector<SZ>());
+            for (auto &x : b)
+                for (int j = 0; j < x.second; j++)
+                    labels.back().push_back(x.first);
+            shape.push_back(labels.back().size()), n *= shape.back();
+        }
+        data.resize(n, 0.0);
+    }
+    size_t offset(const vector<size_t> &idx) const {
+        size_t r = 0;
+        for (size_t i = 0; i < shape.size(); i++)
+            r = r * shape[i] + idx[i];
+        return r;
+    }
+    // iterate over all multi-indices
+    static bool next(vector<size_t> &idx, const vector<size_t> &shape) {
+        int i = (int)shape.size() - 1;
+        for (; i >= 0 && ++idx[i] == shape[i]; i--)
+            idx[i] = 0;
+        return i >= 0;
+    }
+    static size_t bond_offset(const Bond &b, SZ q) {
+        size_t r = 0;
+        for (auto &x : b)
+            if (x.first == q)
+                return r;
+            else
+                r += x.second;
+        assert(false);
+        return r;
+    }
+    DenseTensor(const vector<Bond> &bonds,
+                const shared_ptr<BlockSparseTensor<SZ, FL>> &t)
+        : DenseTensor(bonds) {
+        for (size_t ib = 0; ib < t->n_blocks(); ib++) {
+            vector<size_t> st, idx(bonds.size(), 0), sh;
+            for (size_t i = 0; i < bonds.size(); i++) {
+                st.push_back(bond_offset(bonds[i], t->q_labels[ib][i]));
+                sh.push_back(t->shapes[ib][i]);
+            }
+            if (t->size(ib) == 0)
+                continue;
+            size_t k = 0;
+            do {
+                vector<size_t> gidx(idx);
+                for (size_t i = 0; i < bonds.size(); i++)
+                    gidx[i] += st[i];
+                data[offset(gidx)] += (*t->data[ib])[k++];
+            } while (next(idx, sh));
+        }
+    }
+};
+
+// reference contraction with fermionic phase
+template <typename FL>
+DenseTensor<FL> dense_contract(const DenseTensor<FL> &a,
+                               const DenseTensor<FL> &b,
+                               const vector<Bond> &bonds,
+                               const vector<int> &idxa,
+                               const vector<int> &idxb,
+                               const vector<int> &fidxa,
+                               const vector<int> &fidxb,
+                               const vector<int> &out_trans) {
+    vector<int> outa, outb;
+    for (int i = 0; i < (int)a.shape.size(); i++)
+        if (find(idxa.begin(), idxa.end(), i) == idxa.end())
+            outa.push_back(i);
+    for (int i = 0; i < (int)b.shape.size(); i++)
+        if (find(idxb.begin(), idxb.end(), i) == idxb.end())
+            outb.push_back(i);
+    DenseTensor<FL> c(bonds);
+    if (a.data.size() == 0 || b.data.size() == 0)
+        return c;
+    vector<size_t> ia(a.shape.size(), 0), ib(b.shape.size(), 0);
+    do {
+        fill(ib.begin(), ib.end(), 0);
+        do {
+            bool ok = true;
+            for (size_t i = 0; i < idxa.size() && ok; i++)
+                ok = ia[idxa[i]] == ib[idxb[i]] &&
+                     a.labels[idxa[i]][ia[idxa[i]]] ==
+                         b.labels[idxb[i]][ib[idxb[i]]];
+            if (!ok)
+                continue;
+            vector<SZ> qa, qb;
+            for (size_t i = 0; i < ia.size(); i++)
+                qa.push_back(a.labels[i][ia[i]]);
+            for (size_t i = 0; i < ib.size(); i++)
+                qb.push_back(b.labels[i][ib[i]]);
+            FL x = a.data[a.offset(ia)] * b.data[b.offset(ib)];
+            if (BlockSparseTensor<SZ, FL>::fermion_phase(qa, qb, idxa, fidxa,
+                                                        fidxb))
+                x = -x;
+            vector<size_t> ic;
+            for (int i : outa)
+                ic.push_back(ia[i]);
+            for (int i : outb)
+                ic.push_back(ib[i]);
+            vector<size_t> icx(ic);
+            for (size_t i = 0; i < out_trans.size(); i++)
+                icx[i] = ic[out_trans[i]];
+            c.data[c.offset(icx)] += x;
+        } while (ib.size() != 0 && DenseTensor<FL>::next(ib, b.shape));
+    } while (ia.size() != 0 && DenseTensor<FL>::next(ia, a.shape));
+    return c;
+}
+
+template <typename FL>
+void check_dense(const DenseTensor<FL> &a, const DenseTensor<FL> &b,
+                 double eps = 1E-12) {
+    ASSERT_EQ(a.data.size(), b.data.size());
+    for (size_t i = 0; i < a.data.size(); i++)
+        EXPECT_LT(abs(a.data[i] - b.data[i]), eps);
+}
+
+template <typename FL> void test_contract(int n_tests) {
+    typedef BlockSparseTensor<SZ, FL> BST;
+    for (int it = 0; it < n_tests; it++) {
+        // state x state, operator x one-site state (with phase),
+        // operator x operator (with phase)
+        const int mode = it % 3;
+        Bond bl = random_bond(4), bm = random_bond(3), br = random_bond(4);
+        Bond bn = random_bond(3), bx = random_bond(3), by = random_bond(4);
+        vector<Bond> ba, bb, bc;
+        vector<int> idxa, idxb, fidxa, fidxb, out_trans;
+        if (mode == 0) {
+            ba = vector<Bond>{bl, bm, br}, bb = vector<Bond>{br, bn, bx};
+            idxa = vector<int>{-1}, idxb = vector<int>{0};
+            bc = vector<Bond>{bl, bm, bn, bx};
+        } else if (mode == 1) {
+            // op [l, bra, ket, r] x st [x, ket, y]
+            ba = vector<Bond>{bl, bm, bn, br}, bb = vector<Bond>{bx, bn, by};
+            idxa = vector<int>{2}, idxb = vector<int>{1};
+            fidxa = vector<int>{1}, fidxb = vector<int>{0};
+            out_trans = vector<int>{0, 3, 1, 2, 4};
+            bc = vector<Bond>{bl, bx, bm, br, by};
+        } else {
+            // op [l, bra, ket, r] x op [x, ket, y, z]
+            ba = vector<Bond>{bl, bm, bn, br},
+            bb = vector<Bond>{bx, bn, by, bm};
+            idxa = vector<int>{2}, idxb = vector<int>{1};
+            fidxa = vector<int>{1}, fidxb = vector<int>{1, 2};
+            bc = vector<Bond>{bl, bm, br, bx, by, bm};
+        }
+        shared_ptr<BST> a = random_tensor<FL>(ba), b = random_tensor<FL>(bb);
+        shared_ptr<BST> c =
+            BST::contract(a, b, idxa, idxb, fidxa, fidxb, out_trans);
+        for (auto &x : idxa)
+            x = x < 0 ? (int)ba.size() + x : x;
+        DenseTensor<FL> da(ba, a), db(bb, b), dc(bc, c);
+        DenseTensor<FL> dx = dense_contract<FL>(da, db, bc, idxa, idxb, fidxa,
+                                                fidxb, out_trans);
+        check_dense(dc, dx);
+    }
+}
+
+template <typename FL> void test_full_contract(int n_tests) {
+    typedef BlockSparseTensor<SZ, FL> BST;
+    for (int it = 0; it < n_tests; it++) {
+        Bond bl = random_bond(3), bm = random_bond(3);
+        vector<Bond> ba = vector<Bond>{bl, bm};
+        shared_ptr<BST> a = random_tensor<FL>(ba), b = random_tensor<FL>(ba);
+        shared_ptr<BST> c =
+            BST::contract(a, b, vector<int>{0, 1}, vector<int>{0, 1});
+        DenseTensor<FL> da(ba, a), db(ba, b);
+        FL x = 0.0;
+        for (size_t i = 0; i < da.data.size(); i++)
+            x += da.data[i] * db.data[i];
+        ASSERT_LE(c->n_blocks(), 1);
+        FL y = c->n_blocks() == 0 ? (FL)0.0 : (*c->data[0])[0];
+        EXPECT_EQ(c->rank(), 0);
+        EXPECT_LT(abs(x - y), 1E-12);
+    }
+}
+
+template <typename FL> void test_canonicalize(int n_tests) {
+    typedef BlockSparseTensor<SZ, FL> BST;
+    for (int it = 0; it < n_tests; it++) {
+        const bool left = it % 2;
+        Bond bl = random_bond(4), bm = random_bond(3), br = random_bond(4);
+        vector<Bond> ba = vector<Bond>{bl, bm, br};
+        shared_ptr<BST> a = random_tensor<FL>(ba);
+        pair<shared_ptr<BST>, shared_ptr<BST>> qr =
+            left ? a->left_canonicalize() : a->right_canonicalize();
+        ASSERT_EQ(qr.first->n_blocks(), a->n_blocks());
+        // q is an isometry
+        vector<int> cidx = left ? vector<int>{0, 1} : vector<int>{1, 2};
+        shared_ptr<BST> qq =
+            BST::contract(conj_tensor<FL>(qr.first), qr.first, cidx, cidx);
+        for (size_t ib = 0; ib < qq->n_blocks(); ib++) {
+            if (qq->q_labels[ib][0] != qq->q_labels[ib][1])
+                continue;
+            const MKL_INT k = qq->shapes[ib][0];
+            for (MKL_INT i = 0; i < k; i++)
+                for (MKL_INT j = 0; j < k; j++)
+                    EXPECT_LT(abs((*qq->data[ib])[i * k + j] -
+                                  (FL)(i == j ? 1.0 : 0.0)),
+                              1E-12);
+        }
+        // q * r == a
+        shared_ptr<BST> x = left ? qr.first->right_multiply(qr.second)
+                                 : qr.first->left_multiply(qr.second);
+        check_dense(DenseTensor<FL>(ba, x), DenseTensor<FL>(ba, a));
+    }
+}
+
+template <typename FL> void test_compress(int n_tests) {
+    typedef BlockSparseTensor<SZ, FL> BST;
+    for (int it = 0; it < n_tests; it++) {
+        const bool left = it % 2, sv_on_l = (it / 2) % 2;
+        const int k = (it / 4) % 2 ? -1 : Random::rand_int(0, 8);
+        Bond bl = random_bond(4), bm = random_bond(3), br = random_bond(4);
+        vector<Bond> ba = vector<Bond>{bl, bm, br};
+        shared_ptr<BST> a = random_tensor<FL>(ba);
+        shared_ptr<BST> r, mats;
+        double error;
+        tie(r, mats, error) = left ? a->left_compress(k, 0.0)
+                                   : a->right_compress(k, 0.0, sv_on_l);
+        shared_ptr<BST> x =
+            left ? r->right_multiply(mats) : r->left_multiply(mats);
+        DenseTensor<FL> da(ba, a), dx(ba, x);
+        double norm = 0.0;
+        for (size_t i = 0; i < da.data.size(); i++)
+            norm += pow(abs(da.data[i] - dx.data[i]), 2);
+        EXPECT_LT(abs(sqrt(norm) - error), 1E-10);
+        if (k == -1)
+            EXPECT_LT(error, 1E-12);
+        else {
+            int nk = 0;
+            for (size_t ib = 0; ib < mats->n_blocks(); ib++)
+                nk += (int)mats->shapes[ib][left ? 0 : 1];
+            EXPECT_LE(nk, k);
+        }
+    }
+}
+
+TEST_F(TestBlockSparseTensor, TestContract) {
+    test_contract<double>(n_tests);
+    test_full_contract<double>(n_tests);
+}
+
+TEST_F(TestBlockSparseTensor, TestComplexContract) {
+    test_contract<complex<double>>(n_tests);
+    test_full_contract<complex<double>>(n_tests);
+}
+
+TEST_F(TestBlockSparseTensor, TestCanonicalize) {
+    test_canonicalize<double>(n_tests);
+    test_canonicalize<complex<double>>(n_tests);
+}
+
+TEST_F(TestBlockSparseTensor, TestCompress) {
+    test_compress<double>(n_tests);
+    test_compress<complex<double>>(n_tests);
+}
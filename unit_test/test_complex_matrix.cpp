@@ -1109,7 +1109,10 @@ TYPED_TEST(TestComplexMatrix, TestEigs) {
             a(ki, ki) = real(a(ki, ki));
         }
         GMatrixFunctions<FL>::copy(ap, a);
-        GMatrixFunctions<FL>::eigs(a, w);
+        if (Random::rand_int(0, 2))
+            GMatrixFunctions<FL>::eigs_dc(a, w);
+        else
+            GMatrixFunctions<FL>::eigs(a, w);
         GMatrixFunctions<FL>::multiply(a, false, ap, true, ag, 1.0, 0.0);
         for (MKL_INT k = 0; k < m; k++)
             for (MKL_INT j = 0; j < m; j++)
@@ -1189,9 +1192,13 @@ TYPED_TEST(TestComplexMatrix, TestSVD) {
             make_shared<GTensor<FL>>(vector<MKL_INT>{n, n});
         Random::complex_fill<FP>(a->data->data(), a->size());
         GMatrixFunctions<FL>::copy(aa->ref(), a->ref());
-        if (Random::rand_int(0, 2))
+        const int svd_type = Random::rand_int(0, 3);
+        if (svd_type == 0)
             GMatrixFunctions<FL>::accurate_svd(
                 a->ref(), l->ref(), s->ref().flip_dims(), r->ref(), 1E-1);
+        else if (svd_type == 1)
+            GMatrixFunctions<FL>::svd_dc(a->ref(), l->ref(),
+                                         s->ref().flip_dims(), r->ref());
         else
             GMatrixFunctions<FL>::svd(a->ref(), l->ref(), s->ref().flip_dims(),
                                       r->ref());
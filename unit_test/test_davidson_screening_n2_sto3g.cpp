@@ -0,0 +1,192 @@
+
+#include "block2_core.hpp"
+#include "block2_dmrg.hpp"
+#include <gtest/gtest.h>
+
+using namespace block2;
+
+class TestDavidsonScreeningN2STO3G : public ::testing::Test {
+  protected:
+    size_t isize = 1LL << 24;
+    size_t dsize = 1LL << 30;
+    void SetUp() override {
+        Random::rand_seed(0);
+        frame_<double>() =
+            make_shared<DataFrame<double>>(isize, dsize, "nodex");
+        frame_<double>()->use_main_stack = false;
+        frame_<double>()->minimal_disk_usage = true;
+        threading_() = make_shared<Threading>(
+            ThreadingTypes::OperatorBatchedGEMM | ThreadingTypes::Global, 2, 2,
+            1);
+    }
+    void TearDown() override {
+        frame_<double>()->activate(0);
+        assert(ialloc_()->used == 0 && dalloc_<double>()->used == 0);
+        frame_<double>() = nullptr;
+    }
+    shared_ptr<MPO<SU2, double>>
+    get_mpo(const shared_ptr<HamiltonianQC<SU2, double>> &hamil) {
+        shared_ptr<MPO<SU2, double>> mpo = make_shared<MPOQC<SU2, double>>(
+            hamil, QCTypes::Conventional, "HQC");
+        mpo->basis = hamil->basis;
+        return make_shared<SimplifiedMPO<SU2, double>>(
+            mpo, make_shared<RuleQC<SU2, double>>(), true, true,
+            OpNamesSet({OpNames::R, OpNames::RD}));
+    }
+    shared_ptr<MPS<SU2, double>>
+    get_mps(const shared_ptr<HamiltonianQC<SU2, double>> &hamil,
+            const shared_ptr<MPO<SU2, double>> &mpo, int center) {
+        SU2 target(hamil->fcidump->n_elec(), 0, 0);
+        shared_ptr<MPSInfo<SU2>> mps_info = make_shared<MPSInfo<SU2>>(
+            mpo->n_sites, hamil->vacuum, target, mpo->basis);
+        mps_info->set_bond_dimension(200);
+        Random::rand_seed(1234);
+        shared_ptr<MPS<SU2, double>> mps =
+            make_shared<MPS<SU2, double>>(mpo->n_sites, center, 2);
+        mps->initialize(mps_info);
+        mps->random_canonicalize();
+        mps->save_mutable();
+        mps->deallocate();
+        mps_info->save_mutable();
+        mps_info->deallocate_mutable();
+        return mps;
+    }
+    double run_dmrg(const shared_ptr<HamiltonianQC<SU2, double>> &hamil,
+                    double screen_thrd) {
+        shared_ptr<MPO<SU2, double>> mpo = get_mpo(hamil);
+        shared_ptr<MPS<SU2, double>> mps = get_mps(hamil, mpo, 0);
+        shared_ptr<MovingEnvironment<SU2, double, double>> me =
+            make_shared<MovingEnvironment<SU2, double, double>>(mpo, mps, mps,
+                                                                "DMRG");
+        me->init_environments(false);
+        me->delayed_contraction = OpNamesSet::normal_ops();
+        shared_ptr<DMRG<SU2, double, double>> dmrg =
+            make_shared<DMRG<SU2, double, double>>(
+                me, vector<ubond_t>{200}, vector<double>{1E-8, 1E-9, 0.0});
+        dmrg->iprint = 0;
+        dmrg->davidson_screen_thrd = screen_thrd;
+        double energy = (double)dmrg->solve(10, mps->center == 0, 1E-8);
+        mps->info->deallocate();
+        me->remove_partition_files();
+        mpo->deallocate();
+        return energy;
+    }
+    // screened H x c at the middle site, compared with the exact one
+    void check_multiply(const shared_ptr<HamiltonianQC<SU2, double>> &hamil,
+                        double screen_thrd) {
+        shared_ptr<MPO<SU2, double>> mpo = get_mpo(hamil);
+        const int i = mpo->n_sites / 2 - 1;
+        shared_ptr<MPS<SU2, double>> mps = get_mps(hamil, mpo, i);
+        shared_ptr<MovingEnvironment<SU2, double, double>> me =
+            make_shared<MovingEnvironment<SU2, double, double>>(mpo, mps, mps,
+                                                                "DMRG");
+        me->init_environments(false);
+        me->move_to(i);
+        frame_<double>()->activate(0);
+        mps->load_tensor(i);
+        shared_ptr<SparseMatrix<SU2, double>> wfn = mps->tensors[i];
+        shared_ptr<EffectiveHamiltonian<SU2, double>> h_eff =
+            me->eff_ham(FuseTypes::FuseLR, true, false, wfn, wfn);
+        MKL_INT n = (MKL_INT)wfn->total_memory;
+        MatrixRef b(wfn->data, n, 1), cx(nullptr, n, 1), cs(nullptr, n, 1);
+        cx.allocate(), cs.allocate();
+        cx.clear(), cs.clear();
+        const shared_ptr<BatchGEMMSeq<double>> &seq = h_eff->tf->opf->seq;
+        const bool precomputed = seq->mode & SeqTypes::Tasked;
+        h_eff->precompute();
+        const auto &mult = [&h_eff, &precomputed](const MatrixRef &x,
+                                                  const MatrixRef &y) {
+            if (precomputed)
+                h_eff->tf->operator()(x, y, 1.0);
+            else
+                (*h_eff)(x, y, 0, 1.0);
+        };
+        mult(b, cx);
+        // the bound must include the skipped rotations of all threads
+        const int ntop = threading_()->n_threads_op;
+        double bound = 0;
+        for (int nt = 1; nt <= 2; nt++) {
+            threading_()->n_threads_op = nt;
+            cs.clear();
+            h_eff->screen_setup(screen_thrd);
+            mult(b, cs);
+            EXPECT_GT(seq->screen_nskip, (size_t)0);
+            EXPECT_LT(seq->screen_nskip, seq->screen_ntotal);
+            if (nt == 1)
+                bound = seq->screen_max_error;
+            else
+                EXPECT_LT(abs(seq->screen_max_error - bound), 1E-12 * bound);
+            h_eff->screen_setup(0);
+        }
+        threading_()->n_threads_op = ntop;
+        h_eff->post_precompute();
+        MatrixFunctions::iadd(cs, cx, -1.0);
+        const double err = MatrixFunctions::norm(cs) / MatrixFunctions::norm(b);
+        EXPECT_GT(err, 0.0);
+        EXPECT_LE(err, bound * (1 + 1E-10));
+        cs.deallocate(), cx.deallocate();
+        h_eff->deallocate();
+        mps->unload_tensor(i);
+        mps->info->deallocate();
+        me->remove_partition_files();
+        mpo->deallocate();
+    }
+    // a screened solution with small residual is accepted after one exact
+    // [H] x [c], without unscreened Davidson iterations
+    void check_eigs(const shared_ptr<HamiltonianQC<SU2, double>> &hamil,
+                    double screen_thrd) {
+        shared_ptr<MPO<SU2, double>> mpo = get_mpo(hamil);
+        const int i = mpo->n_sites / 2 - 1;
+        shared_ptr<MPS<SU2, double>> mps = get_mps(hamil, mpo, i);
+        shared_ptr<MovingEnvironment<SU2, double, double>> me =
+            make_shared<MovingEnvironment<SU2, double, double>>(mpo, mps, mps,
+                                                                "DMRG");
+        me->init_environments(false);
+        me->move_to(i);
+        frame_<double>()->activate(0);
+        mps->load_tensor(i);
+        shared_ptr<SparseMatrix<SU2, double>> wfn = mps->tensors[i];
+        vector<double> guess(wfn->data, wfn->data + wfn->total_memory);
+        double eners[2];
+        for (int k = 0; k < 2; k++) {
+            memcpy(wfn->data, guess.data(), sizeof(double) * guess.size());
+            shared_ptr<EffectiveHamiltonian<SU2, double>> h_eff =
+                me->eff_ham(FuseTypes::FuseLR, true, true, wfn, wfn);
+            h_eff->screen_thrd = k == 0 ? 0 : screen_thrd;
+            auto r = h_eff->eigs(nullptr, false, 1E-6);
+            eners[k] = (double)get<0>(r);
+            if (k == 1)
+                EXPECT_TRUE(h_eff->screen_verified);
+            h_eff->deallocate();
+        }
+        EXPECT_LT(abs(eners[1] - eners[0]), 1E-6);
+        mps->unload_tensor(i);
+        mps->info->deallocate();
+        me->remove_partition_files();
+        mpo->deallocate();
+    }
+};
+
+TEST_F(TestDavidsonScreeningN2STO3G, TestSU2) {
+    shared_ptr<FCIDUMP<double>> fcidump = make_shared<FCIDUMP<double>>();
+    PGTypes pg = PGTypes::D2H;
+    fcidump->read("data/N2.STO3G.FCIDUMP");
+    vector<uint8_t> orbsym = fcidump->template orb_sym<uint8_t>();
+    transform(orbsym.begin(), orbsym.end(), orbsym.begin(),
+              [pg](uint8_t x) { return (uint8_t)PointGroup::swap_pg(pg)(x); });
+    const double ener_ref = -107.654122447525;
+
+    for (SeqTypes seq_type : {SeqTypes::Tasked, SeqTypes::None}) {
+        threading_()->seq_type = seq_type;
+        shared_ptr<HamiltonianQC<SU2, double>> hamil =
+            make_shared<HamiltonianQC<SU2, double>>(
+                SU2(0), fcidump->n_sites(), orbsym, fcidump);
+        check_multiply(hamil, 1E-2);
+        check_eigs(hamil, 1E-6);
+        // the unscreened restart recovers the exact energy
+        EXPECT_LT(abs(run_dmrg(hamil, 1E-3) - ener_ref), 1E-7);
+        hamil->deallocate();
+    }
+
+    fcidump->deallocate();
+}
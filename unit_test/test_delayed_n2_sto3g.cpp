@@ -16,7 +16,8 @@ template <typename FL> class TestDelayedN2STO3G : public ::testing::Test {
     void test_dmrg(const vector<vector<S>> &targets,
                    const vector<vector<FLL>> &energies,
                    const shared_ptr<HamiltonianQC<S, FL>> &hamil,
-                   const string &name, DecompositionTypes dt, NoiseTypes nt);
+                   const string &name, DecompositionTypes dt, NoiseTypes nt,
+                   FP low_rank_cutoff = 0, bool one_dot = false);
     void SetUp() override {
         Random::rand_seed(0);
         frame_<FP>() = make_shared<DataFrame<FP>>(isize, dsize, "nodex");
@@ -38,7 +39,8 @@ template <typename S>
 void TestDelayedN2STO3G<FL>::test_dmrg(
     const vector<vector<S>> &targets, const vector<vector<FLL>> &energies,
     const shared_ptr<HamiltonianQC<S, FL>> &hamil, const string &name,
-    DecompositionTypes dt, NoiseTypes nt) {
+    DecompositionTypes dt, NoiseTypes nt, FP low_rank_cutoff,
+    bool one_dot) {
 
     hamil->delayed = DelayedOpNames::H | DelayedOpNames::Normal |
                      DelayedOpNames::P | DelayedOpNames::PD |
@@ -58,6 +60,9 @@ void TestDelayedN2STO3G<FL>::test_dmrg(
                                             true);
     cout << "MPO simplification end .. T = " << t.get_time() << endl;
 
+    dynamic_pointer_cast<DelayedTensorFunctions<S, FL>>(mpo->tf)
+        ->low_rank_cutoff = low_rank_cutoff;
+
     ubond_t bond_dim = 200;
     vector<ubond_t> bdims = {bond_dim};
     vector<FP> noises = {1E-8, 1E-9, 0.0};
@@ -101,6 +106,12 @@ void TestDelayedN2STO3G<FL>::test_dmrg(
             dmrg->noise_type = nt;
             dmrg->davidson_soft_max_iter = 4000;
             FLL energy = dmrg->solve(10, mps->center == 0, 1E-8);
+            // low-rank renormalized operators are used directly
+            // in the one-dot effective Hamiltonian
+            if (one_dot) {
+                me->dot = 1;
+                energy = dmrg->solve(4, mps->center == 0, 1E-8);
+            }
 
             // deallocate persistent stack memory
             mps_info->deallocate();
@@ -119,6 +130,17 @@ void TestDelayedN2STO3G<FL>::test_dmrg(
 
             EXPECT_LT(abs(energy - energies[i][j]), 1E-7);
 
+            if (low_rank_cutoff != 0) {
+                size_t org_mem = 0, lr_mem = 0;
+                for (auto &x : me->left_low_rank_info)
+                    org_mem += get<0>(x), lr_mem += get<1>(x);
+                for (auto &x : me->right_low_rank_info)
+                    org_mem += get<0>(x), lr_mem += get<1>(x);
+                cout << "low-rank renormalized operators = " << lr_mem
+                     << " / " << org_mem << endl;
+                EXPECT_LT(lr_mem, org_mem);
+            }
+
             k = 0;
         }
 
@@ -181,6 +203,13 @@ TYPED_TEST(TestDelayedN2STO3G, TestSU2) {
     this->template test_dmrg<SU2>(targets, energies, hamil, "SU2 SVD",
                                   DecompositionTypes::SVD,
                                   NoiseTypes::Wavefunction);
+    this->template test_dmrg<SU2>(targets, energies, hamil, "SU2 LOWRANK",
+                                  DecompositionTypes::DensityMatrix,
+                                  NoiseTypes::DensityMatrix, 1E-14);
+    this->template test_dmrg<SU2>(targets, energies, hamil,
+                                  "SU2 LOWRANK 1DOT",
+                                  DecompositionTypes::DensityMatrix,
+                                  NoiseTypes::DensityMatrix, 1E-14, true);
 
     hamil->deallocate();
     fcidump->deallocate();
@@ -242,6 +271,12 @@ TYPED_TEST(TestDelayedN2STO3G, TestSZ) {
     this->template test_dmrg<SZ>(targets, energies, hamil, "SZ SVD",
                                  DecompositionTypes::SVD,
                                  NoiseTypes::Wavefunction);
+    this->template test_dmrg<SZ>(targets, energies, hamil, "SZ LOWRANK",
+                                 DecompositionTypes::DensityMatrix,
+                                 NoiseTypes::DensityMatrix, 1E-14);
+    this->template test_dmrg<SZ>(targets, energies, hamil, "SZ LOWRANK 1DOT",
+                                 DecompositionTypes::DensityMatrix,
+                                 NoiseTypes::DensityMatrix, 1E-14, true);
 
     hamil->deallocate();
     fcidump->deallocate();
@@ -0,0 +1,277 @@
+#include "block2_core.hpp"
+#include "block2_dmrg.hpp"
+#include "sci/sweep_algorithm_sci.hpp"
+#include <gtest/gtest.h>
+
+using namespace block2;
+
+class TestDMRGSCIAQCCN2STO3G : public ::testing::Test {
+  protected:
+    size_t isize = 1LL << 24;
+    size_t dsize = 1LL << 30;
+    void SetUp() override {
+        Random::rand_seed(0);
+        frame_<double>() =
+            make_shared<DataFrame<double>>(isize, dsize, "nodex");
+        frame_<double>()->minimal_disk_usage = true;
+        threading_() = make_shared<Threading>(
+            ThreadingTypes::OperatorBatchedGEMM | ThreadingTypes::Global, 2, 2,
+            1);
+        threading_()->seq_type = SeqTypes::Tasked;
+    }
+    void TearDown() override {
+        frame_<double>()->activate(0);
+        assert(ialloc_()->used == 0 && dalloc_<double>()->used == 0);
+        frame_<double>() = nullptr;
+    }
+    // sum_A coef(|A|) prod_{i in A} n_i over subsets A of the spin orbitals
+    // of the external orbitals; P(N_ext = k) has coef(m) = C(m, k)(-1)^(m-k)
+    static void add_ext_projector(const shared_ptr<GeneralFCIDUMP<double>> &gfd,
+                                  const vector<uint16_t> &ext,
+                                  const function<double(int)> &coef) {
+        const int nso = (int)ext.size() * 2;
+        map<string, size_t> mp;
+        for (uint32_t x = 1; x < (1U << nso); x++) {
+            const double v = coef(__builtin_popcount(x));
+            if (v == 0.0)
+                continue;
+            string expr;
+            vector<uint16_t> idx;
+            for (int i = 0; i < nso; i++)
+                if ((x >> i) & 1) {
+                    expr += (i & 1) ? "CD" : "cd";
+                    idx.push_back(ext[i >> 1]), idx.push_back(ext[i >> 1]);
+                }
+            if (!mp.count(expr)) {
+                mp[expr] = gfd->exprs.size();
+                gfd->exprs.push_back(expr);
+                gfd->indices.push_back(vector<uint16_t>());
+                gfd->data.push_back(vector<double>());
+            }
+            const size_t ix = mp.at(expr);
+            gfd->indices[ix].insert(gfd->indices[ix].end(), idx.begin(),
+                                    idx.end());
+            gfd->data[ix].push_back(v);
+        }
+    }
+    static shared_ptr<MPO<SZ, double>>
+    get_mpo(const shared_ptr<GeneralHamiltonian<SZ, double>> &gham,
+            shared_ptr<GeneralFCIDUMP<double>> gfd, bool qc,
+            const string &tag) {
+        gfd = gfd->adjust_order();
+        shared_ptr<MPO<SZ, double>> mpo = make_shared<GeneralMPO<SZ, double>>(
+            gham, gfd, MPOAlgorithmTypes::FastBipartite, 1E-14, -1, 0, tag);
+        mpo->build();
+        if (qc)
+            return make_shared<SimplifiedMPO<SZ, double>>(
+                mpo, make_shared<RuleQC<SZ, double>>(), true, false);
+        return make_shared<SimplifiedMPO<SZ, double>>(
+            mpo, make_shared<Rule<SZ, double>>(), false, false);
+    }
+};
+
+// With the identity as shift operator the AQCC eigenvalue problem
+// H x = (E - (1 - g) (E - E_ref)) x has the fixed point
+// E = (E_0 - (1 - g) E_ref) / g, where E_0 is the ground state of H.
+TEST_F(TestDMRGSCIAQCCN2STO3G, TestSZ) {
+    shared_ptr<FCIDUMP<double>> fcidump = make_shared<FCIDUMP<double>>();
+    PGTypes pg = PGTypes::D2H;
+    fcidump->read("data/N2.STO3G.FCIDUMP");
+    vector<uint8_t> orbsym = fcidump->template orb_sym<uint8_t>();
+    transform(orbsym.begin(), orbsym.end(), orbsym.begin(),
+              [pg](uint8_t x) { return (uint8_t)PointGroup::swap_pg(pg)(x); });
+    const double ener_ref = -107.654122447525;
+    const double g_factor = 0.5, ref_energy = ener_ref + 0.1;
+    const double ener_aqcc =
+        (ener_ref - (1 - g_factor) * ref_energy) / g_factor;
+    shared_ptr<HamiltonianQC<SZ, double>> hamil =
+        make_shared<HamiltonianQC<SZ, double>>(SZ(0, 0, 0), fcidump->n_sites(),
+                                               orbsym, fcidump);
+    shared_ptr<MPO<SZ, double>> mpo = make_shared<MPOQC<SZ, double>>(
+        hamil, QCTypes::Conventional, "HQC");
+    mpo = make_shared<SimplifiedMPO<SZ, double>>(
+        mpo, make_shared<RuleQC<SZ, double>>(), true, true,
+        OpNamesSet({OpNames::R, OpNames::RD}));
+    shared_ptr<MPO<SZ, double>> impo =
+        make_shared<IdentityMPO<SZ, double>>(hamil);
+    impo = make_shared<SimplifiedMPO<SZ, double>>(
+        impo, make_shared<Rule<SZ, double>>());
+    SZ target(fcidump->n_elec(), fcidump->twos(),
+              PointGroup::swap_pg(pg)(fcidump->isym()));
+    for (bool shift_continuation : {false, true}) {
+        shared_ptr<MPSInfo<SZ>> mps_info = make_shared<MPSInfo<SZ>>(
+            mpo->n_sites, hamil->vacuum, target, hamil->basis);
+        mps_info->set_bond_dimension(200);
+        Random::rand_seed(0);
+        shared_ptr<MPS<SZ, double>> mps =
+            make_shared<MPS<SZ, double>>(mpo->n_sites, 0, 2);
+        mps->initialize(mps_info);
+        mps->random_canonicalize();
+        mps->save_mutable();
+        mps->deallocate();
+        mps_info->save_mutable();
+        mps_info->deallocate_mutable();
+        shared_ptr<MovingEnvironment<SZ, double, double>> me =
+            make_shared<MovingEnvironment<SZ, double, double>>(mpo, mps, mps,
+                                                               "DMRG");
+        me->init_environments(false);
+        shared_ptr<MovingEnvironment<SZ, double, double>> sme =
+            make_shared<MovingEnvironment<SZ, double, double>>(impo, mps, mps,
+                                                               "SHIFT");
+        sme->init_environments(false);
+        shared_ptr<DMRGSCIAQCC<SZ>> dmrg = make_shared<DMRGSCIAQCC<SZ>>(
+            me, g_factor, sme, vector<ubond_t>{50, 100, 200},
+            vector<double>{1E-4, 1E-4, 1E-5, 1E-5, 1E-6, 0.0}, ref_energy);
+        dmrg->iprint = 0;
+        dmrg->shift_continuation = shift_continuation;
+        double energy = (double)dmrg->solve(30, true, 1E-8);
+        EXPECT_LT(abs(energy - ener_aqcc), 1E-6);
+        EXPECT_LT(abs(dmrg->delta_e - (ener_aqcc - ref_energy)), 1E-6);
+        mps_info->deallocate();
+        sme->remove_partition_files();
+        me->remove_partition_files();
+    }
+    impo->deallocate();
+    mpo->deallocate();
+    hamil->deallocate();
+    fcidump->deallocate();
+}
+
+// AQCC, ACPF and ACPF2 with the projectors onto the configurations with
+// electrons in the external (virtual pi_g*) orbitals
+TEST_F(TestDMRGSCIAQCCN2STO3G, TestProjectorSZ) {
+    shared_ptr<FCIDUMP<double>> fcidump = make_shared<FCIDUMP<double>>();
+    PGTypes pg = PGTypes::D2H;
+    fcidump->read("data/N2.STO3G.FCIDUMP");
+    vector<uint8_t> orbsym = fcidump->template orb_sym<uint8_t>();
+    transform(orbsym.begin(), orbsym.end(), orbsym.begin(),
+              [pg](uint8_t x) { return (uint8_t)PointGroup::swap_pg(pg)(x); });
+    const int n = fcidump->n_sites(), n_elec = fcidump->n_elec();
+    // the pi_g* orbitals (B2g and B3g)
+    const vector<uint16_t> ext = {(uint16_t)(n - 3), (uint16_t)(n - 1)};
+    fcidump->symmetrize(orbsym);
+    shared_ptr<GeneralHamiltonian<SZ, double>> gham =
+        make_shared<GeneralHamiltonian<SZ, double>>(SZ(0, 0, 0), n, orbsym);
+    shared_ptr<GeneralFCIDUMP<double>> hfd =
+        GeneralFCIDUMP<double>::initialize_from_qc(fcidump, ElemOpTypes::SZ);
+    shared_ptr<MPO<SZ, double>> mpo = get_mpo(gham, hfd, true, "HQC");
+    // D: all non-reference, D1: N_ext = 1, D2: N_ext >= 2
+    const auto sgn = [](int m) { return (m & 1) ? -1.0 : 1.0; };
+    shared_ptr<GeneralFCIDUMP<double>> dfd =
+        make_shared<GeneralFCIDUMP<double>>(ElemOpTypes::SZ);
+    shared_ptr<GeneralFCIDUMP<double>> d1fd =
+        make_shared<GeneralFCIDUMP<double>>(ElemOpTypes::SZ);
+    shared_ptr<GeneralFCIDUMP<double>> d2fd =
+        make_shared<GeneralFCIDUMP<double>>(ElemOpTypes::SZ);
+    add_ext_projector(dfd, ext, [&sgn](int m) { return -sgn(m); });
+    add_ext_projector(d1fd, ext, [&sgn](int m) { return -m * sgn(m); });
+    add_ext_projector(d2fd, ext, [&sgn](int m) { return (m - 1) * sgn(m); });
+    shared_ptr<MPO<SZ, double>> dmpo = get_mpo(gham, dfd, false, "D");
+    shared_ptr<MPO<SZ, double>> d1mpo = get_mpo(gham, d1fd, false, "D1");
+    shared_ptr<MPO<SZ, double>> d2mpo = get_mpo(gham, d2fd, false, "D2");
+    // reference (CAS) energy from H + 10 D
+    for (size_t ix = 0; ix < dfd->exprs.size(); ix++) {
+        hfd->exprs.push_back(dfd->exprs[ix]);
+        hfd->indices.push_back(dfd->indices[ix]);
+        hfd->data.push_back(dfd->data[ix]);
+        for (auto &x : hfd->data.back())
+            x *= 10.0;
+    }
+    shared_ptr<MPO<SZ, double>> rmpo = get_mpo(gham, hfd, true, "HREF");
+    SZ target(n_elec, fcidump->twos(),
+              PointGroup::swap_pg(pg)(fcidump->isym()));
+    const auto get_mps = [&](const string &tag) {
+        shared_ptr<MPSInfo<SZ>> mps_info = make_shared<MPSInfo<SZ>>(
+            n, gham->vacuum, target, gham->basis);
+        mps_info->tag = tag;
+        mps_info->set_bond_dimension(200);
+        Random::rand_seed(1234);
+        shared_ptr<MPS<SZ, double>> mps =
+            make_shared<MPS<SZ, double>>(n, 0, 2);
+        mps->initialize(mps_info);
+        mps->random_canonicalize();
+        mps->save_mutable();
+        mps->deallocate();
+        mps_info->save_mutable();
+        mps_info->deallocate_mutable();
+        return mps;
+    };
+    const auto get_me = [](const shared_ptr<MPO<SZ, double>> &xmpo,
+                           const shared_ptr<MPS<SZ, double>> &mps,
+                           const string &tag) {
+        shared_ptr<MovingEnvironment<SZ, double, double>> me =
+            make_shared<MovingEnvironment<SZ, double, double>>(xmpo, mps, mps,
+                                                               tag);
+        me->init_environments(false);
+        return me;
+    };
+    double ref_energy;
+    {
+        shared_ptr<MPS<SZ, double>> mps = get_mps("REF");
+        shared_ptr<MovingEnvironment<SZ, double, double>> me =
+            get_me(rmpo, mps, "REF");
+        shared_ptr<DMRG<SZ, double, double>> dmrg =
+            make_shared<DMRG<SZ, double, double>>(
+                me, vector<ubond_t>{200},
+                vector<double>{1E-5, 1E-6, 1E-7, 0.0});
+        dmrg->iprint = 0;
+        ref_energy = (double)dmrg->solve(20, true, 1E-10);
+        me->remove_partition_files();
+        mps->info->deallocate();
+    }
+    EXPECT_GT(ref_energy, -107.654122447525);
+    const double g_acpf = 2.0 / n_elec;
+    const double g_aqcc =
+        1.0 - (n_elec - 3.0) * (n_elec - 2.0) / (n_elec * (n_elec - 1.0));
+    for (int method = 0; method < 3; method++) {
+        double eners[2];
+        int ndavs[2];
+        for (bool shift_continuation : {false, true}) {
+            shared_ptr<MPS<SZ, double>> mps = get_mps("KET");
+            shared_ptr<MovingEnvironment<SZ, double, double>> me =
+                get_me(mpo, mps, "DMRG");
+            shared_ptr<DMRGSCIAQCC<SZ>> dmrg;
+            const vector<ubond_t> bdims = {50, 100, 200};
+            const vector<double> noises = {1E-4, 1E-4, 1E-5, 1E-5, 1E-6, 0.0};
+            shared_ptr<MovingEnvironment<SZ, double, double>> sme, sme2;
+            if (method == 2) {
+                // ACPF2: ACPF shift on the singles, AQCC on the doubles
+                sme = get_me(d1mpo, mps, "SHIFT1");
+                sme2 = get_me(d2mpo, mps, "SHIFT2");
+                dmrg = make_shared<DMRGSCIAQCC<SZ>>(me, g_acpf, sme, g_aqcc,
+                                                    sme2, bdims, noises,
+                                                    ref_energy);
+            } else {
+                sme = get_me(dmpo, mps, "SHIFT");
+                dmrg = make_shared<DMRGSCIAQCC<SZ>>(
+                    me, method == 0 ? g_aqcc : g_acpf, sme, bdims, noises,
+                    ref_energy);
+            }
+            dmrg->iprint = 0;
+            dmrg->max_aqcc_iter = 20;
+            dmrg->shift_continuation = shift_continuation;
+            eners[shift_continuation] = (double)dmrg->solve(30, true, 1E-8);
+            ndavs[shift_continuation] = dmrg->aqcc_ndav;
+            EXPECT_LT(eners[shift_continuation], ref_energy);
+            if (sme2 != nullptr)
+                sme2->remove_partition_files();
+            sme->remove_partition_files();
+            me->remove_partition_files();
+            mps->info->deallocate();
+        }
+        stringstream ss;
+        ss << (method == 0 ? "AQCC " : (method == 1 ? "ACPF " : "ACPF2"))
+           << " E(restart) = " << fixed << setprecision(10) << eners[0]
+           << " E(continuation) = " << eners[1] << " Ndav(last site) = "
+           << ndavs[0] << " / " << ndavs[1];
+        cout << ss.str() << endl;
+        EXPECT_LT(abs(eners[1] - eners[0]), 1E-8);
+        EXPECT_LE(ndavs[1], ndavs[0]);
+    }
+    rmpo->deallocate();
+    d2mpo->deallocate();
+    d1mpo->deallocate();
+    dmpo->deallocate();
+    mpo->deallocate();
+    fcidump->deallocate();
+}
@@ -132,3 +132,95 @@ TEST_F(TestFCIDUMP, TestCompressedComplexRead) {
     EXPECT_EQ(fcidump.cps_vs[0](0, 2, 1, 1), fcidump.cps_vs[0](1, 1, 2, 0));
     fcidump.deallocate();
 }
+
+template <typename FL>
+static void check_compressed_tiles(const string &filename) {
+    CompressedFCIDUMP<FL> fcidump(5E-16, 5, 64);
+    fcidump.read(filename);
+    const uint16_t n = fcidump.n_sites();
+    vector<FL> r((size_t)n * n);
+    for (uint8_t pa = 0; pa < 4; pa++)
+        for (uint8_t pb = 0; pb < 4; pb++) {
+            if (pa == pb)
+                continue;
+            const uint16_t start = (pa + pb) % 3, len = n - start - pa;
+            array<uint16_t, 4> idx;
+            for (int k = 0; k < 4; k++)
+                idx[k] = (uint16_t)Random::rand_int(0, n);
+            for (uint8_t s = 0; s < 4; s++) {
+                if (s == 0)
+                    fcidump.v_tile(idx, pa, pb, start, len, r.data());
+                else
+                    fcidump.v_tile(s & 1, s >> 1, idx, pa, pb, start, len,
+                                   r.data());
+                for (uint16_t a = 0; a < len; a++)
+                    for (uint16_t b = 0; b < len; b++) {
+                        idx[pa] = start + a, idx[pb] = start + b;
+                        const FL x = r[(size_t)a * len + b],
+                                 y = s == 0
+                                         ? fcidump.v(idx[0], idx[1], idx[2],
+                                                     idx[3])
+                                         : fcidump.v(s & 1, s >> 1, idx[0],
+                                                     idx[1], idx[2], idx[3]);
+                        ASSERT_EQ(x, y);
+                    }
+            }
+        }
+    fcidump.deallocate();
+}
+
+TEST_F(TestFCIDUMP, TestCompressedTile) {
+    // unrestricted integrals with 8-fold and 4-fold symmetric arrays
+    const uint16_t n = 9;
+    FCIDUMP<double> fd;
+    vector<double> t(TInt<double>(n).size() * 2),
+        v(V8Int<double>(n).size() * 2), vab(V4Int<double>(n).size());
+    Random::fill<double>(t.data(), t.size());
+    Random::fill<double>(v.data(), v.size());
+    Random::fill<double>(vab.data(), vab.size());
+    fd.initialize_sz(n, 6, 0, 1, 0.0, t.data(), t.size() / 2,
+                     t.data() + t.size() / 2, t.size() / 2, v.data(),
+                     v.size() / 2, v.data() + v.size() / 2, v.size() / 2,
+                     vab.data(), vab.size());
+    fd.set_orb_sym(vector<uint8_t>(n, 0));
+    fd.write("nodex/UHF.TILE.FCIDUMP");
+    fd.deallocate();
+    check_compressed_tiles<double>("nodex/UHF.TILE.FCIDUMP");
+    check_compressed_tiles<double>("data/N2.STO3G.FCIDUMP");
+    check_compressed_tiles<double>("data/N2.STO3G.UHF.FCIDUMP");
+    check_compressed_tiles<double>("data/N2.STO3G.FCIDUMP.C1");
+    check_compressed_tiles<complex<double>>("data/N2.STO3G.UHF.FCIDUMP");
+}
+
+TEST_F(TestFCIDUMP, TestCompressedTileThreads) {
+    // tiles and single elements read concurrently from the frozen arrays
+    FCIDUMP<double> fd;
+    fd.read("data/N2.CAS.PVDZ.T0.FCIDUMP");
+    CompressedFCIDUMP<double> cfd(5E-16, 3, 64);
+    cfd.read("data/N2.CAS.PVDZ.T0.FCIDUMP");
+    const uint16_t n = fd.n_sites();
+    const int ntiles = 4 * n * n;
+    int nerr = 0;
+    const int ntg = threading->activate_global();
+#pragma omp parallel for schedule(dynamic) num_threads(ntg) reduction(+ : nerr)
+    for (int it = 0; it < ntiles; it++) {
+        const uint8_t pa = it % 4, pb = (pa + 1 + it / 4 % 3) % 4;
+        array<uint16_t, 4> idx;
+        for (int k = 0; k < 4; k++)
+            idx[k] = (uint16_t)((it * 7 + k * 5) % n);
+        vector<double> r((size_t)n * n);
+        cfd.v_tile(idx, pa, pb, 0, n, r.data());
+        for (uint16_t a = 0; a < n; a++)
+            for (uint16_t b = 0; b < n; b++) {
+                idx[pa] = a, idx[pb] = b;
+                nerr += abs(r[(size_t)a * n + b] -
+                            fd.v(idx[0], idx[1], idx[2], idx[3])) > 1E-12;
+                nerr += abs(cfd.v(idx[3], idx[2], idx[1], idx[0]) -
+                            fd.v(idx[3], idx[2], idx[1], idx[0])) > 1E-12;
+            }
+    }
+    threading->activate_normal();
+    EXPECT_EQ(nerr, 0);
+    cfd.deallocate();
+    fd.deallocate();
+}
@@ -0,0 +1,153 @@
+#include "block2_core.hpp"
+#include "block2_dmrg.hpp"
+#include <gtest/gtest.h>
+
+using namespace block2;
+
+class TestFileContainer : public ::testing::Test {
+  protected:
+    size_t isize = 1LL << 24;
+    size_t dsize = 1LL << 30;
+    void SetUp() override {
+        Random::rand_seed(0);
+        frame_<double>() =
+            make_shared<DataFrame<double>>(isize, dsize, "nodex");
+        frame_<double>()->use_main_stack = false;
+        threading_() = make_shared<Threading>(
+            ThreadingTypes::OperatorBatchedGEMM | ThreadingTypes::Global, 2, 2,
+            1);
+        threading_()->seq_type = SeqTypes::Tasked;
+    }
+    void TearDown() override {
+        frame_<double>()->activate(0);
+        assert(ialloc_()->used == 0 && dalloc_<double>()->used == 0);
+        frame_<double>() = nullptr;
+    }
+};
+
+TEST_F(TestFileContainer, TestRecords) {
+    const string fn = "nodex/test.container.bin";
+    shared_ptr<FileContainer> fc = make_shared<FileContainer>(fn, true, 64);
+    fc->write("a", string(100, 'a'));
+    fc->write("b", string(200, 'b'));
+    fc->write("c", string(10, 'c'));
+    EXPECT_EQ(fc->n_appended, 3u);
+    EXPECT_EQ(fc->data_size(), 64u + 128 + 256 + 64);
+    // same-size and smaller records are overwritten in place
+    fc->write("a", string(90, 'x'));
+    EXPECT_EQ(fc->n_in_place, 1u);
+    EXPECT_EQ(fc->read("a"), string(90, 'x'));
+    // removed space is coalesced and reused
+    fc->remove("a");
+    fc->remove("b");
+    EXPECT_EQ(fc->free_size(), 128u + 256);
+    fc->write("d", string(300, 'd'));
+    EXPECT_EQ(fc->n_reused, 1u);
+    EXPECT_EQ(fc->free_size(), 64u);
+    EXPECT_EQ(fc->data_size(), 64u + 128 + 256 + 64);
+    // linked records are copied on write
+    EXPECT_TRUE(fc->link("d", "e"));
+    EXPECT_EQ(fc->read("e"), string(300, 'd'));
+    fc->write("e", string(20, 'e'));
+    EXPECT_EQ(fc->read("d"), string(300, 'd'));
+    EXPECT_EQ(fc->read("e"), string(20, 'e'));
+    EXPECT_TRUE(fc->rename("e", "c"));
+    EXPECT_FALSE(fc->exists("e"));
+    EXPECT_EQ(fc->read("c"), string(20, 'e'));
+    EXPECT_EQ(fc->n_records(), 2u);
+    // removing the tail shrinks the data region
+    fc->remove("c");
+    EXPECT_EQ(fc->data_size(), 64u + 320);
+    EXPECT_THROW(fc->read("c"), runtime_error);
+    fc->link("d", "f");
+    // reopen from the index and from a compacted snapshot
+    fc->snapshot(fn + ".snap");
+    fc = nullptr;
+    for (const string &xfn : vector<string>{fn, fn + ".snap"}) {
+        fc = make_shared<FileContainer>(xfn);
+        EXPECT_EQ(fc->alignment, 64u);
+        EXPECT_EQ(fc->data_size(), 64u + 320);
+        EXPECT_EQ(fc->names(), (vector<string>{"d", "f"}));
+        EXPECT_EQ(fc->read("d"), string(300, 'd'));
+        EXPECT_EQ(fc->read("f"), string(300, 'd'));
+        fc->write("f", string(1, 'f'));
+        EXPECT_EQ(fc->read("d"), string(300, 'd'));
+        fc = nullptr;
+    }
+    Parsing::remove_file(fn);
+    Parsing::remove_file(fn + ".snap");
+}
+
+TEST_F(TestFileContainer, TestDMRGN2STO3G) {
+    shared_ptr<FCIDUMP<double>> fcidump = make_shared<FCIDUMP<double>>();
+    PGTypes pg = PGTypes::D2H;
+    fcidump->read("data/N2.STO3G.FCIDUMP");
+    vector<uint8_t> orbsym = fcidump->template orb_sym<uint8_t>();
+    transform(orbsym.begin(), orbsym.end(), orbsym.begin(),
+              [pg](uint8_t x) { return (uint8_t)PointGroup::swap_pg(pg)(x); });
+    const double ener_ref = -107.654122447525;
+
+    shared_ptr<HamiltonianQC<SU2, double>> hamil =
+        make_shared<HamiltonianQC<SU2, double>>(SU2(0), fcidump->n_sites(),
+                                                orbsym, fcidump);
+    shared_ptr<MPO<SU2, double>> mpo = make_shared<MPOQC<SU2, double>>(
+        hamil, QCTypes::Conventional, "HQC");
+    mpo->basis = hamil->basis;
+    mpo = make_shared<SimplifiedMPO<SU2, double>>(
+        mpo, make_shared<RuleQC<SU2, double>>(), true, true,
+        OpNamesSet({OpNames::R, OpNames::RD}));
+
+    const string fn = "nodex/F0.PART.bin", rdir = "nodex/restart";
+    for (int ib = 0; ib < 2; ib++) {
+        frame_<double>()->partition_container =
+            make_shared<FileContainer>(fn, true);
+        frame_<double>()->minimal_disk_usage = ib == 1;
+        frame_<double>()->save_buffering = ib == 1;
+        frame_<double>()->restart_dir = rdir;
+        SU2 target(fcidump->n_elec(), 0, 0);
+        shared_ptr<MPSInfo<SU2>> mps_info = make_shared<MPSInfo<SU2>>(
+            mpo->n_sites, hamil->vacuum, target, mpo->basis);
+        mps_info->set_bond_dimension(200);
+        shared_ptr<MPS<SU2, double>> mps =
+            make_shared<MPS<SU2, double>>(mpo->n_sites, 0, 2);
+        mps->initialize(mps_info);
+        mps->random_canonicalize();
+        mps->save_mutable();
+        mps->deallocate();
+        mps_info->save_mutable();
+        mps_info->deallocate_mutable();
+        shared_ptr<MovingEnvironment<SU2, double, double>> me =
+            make_shared<MovingEnvironment<SU2, double, double>>(mpo, mps, mps,
+                                                                "DMRG");
+        me->init_environments(false);
+        shared_ptr<DMRG<SU2, double, double>> dmrg =
+            make_shared<DMRG<SU2, double, double>>(
+                me, vector<ubond_t>{200}, vector<double>{1E-8, 1E-9, 0.0});
+        dmrg->iprint = 0;
+        double energy = (double)dmrg->solve(10, true, 1E-8);
+        EXPECT_LT(abs(energy - ener_ref), 1E-7);
+        // environments live in the container, not in per-site files
+        EXPECT_FALSE(
+            Parsing::file_exists(me->get_left_partition_filename(1)));
+        EXPECT_GT(frame_<double>()->partition_container->n_records(), 0u);
+        frame_<double>()->reset_buffer(1);
+        EXPECT_TRUE(Parsing::file_exists(rdir + "/F0.PART.bin"));
+        shared_ptr<FileContainer> snap =
+            make_shared<FileContainer>(rdir + "/F0.PART.bin");
+        EXPECT_GT(snap->n_records(), 0u);
+        snap = nullptr;
+        Parsing::remove_file(rdir + "/F0.PART.bin");
+        mps_info->deallocate();
+        me->remove_partition_files();
+        EXPECT_EQ(frame_<double>()->partition_container->n_records(), 0u);
+        frame_<double>()->partition_container = nullptr;
+        Parsing::remove_file(fn);
+    }
+    frame_<double>()->restart_dir = "";
+    frame_<double>()->minimal_disk_usage = false;
+    frame_<double>()->save_buffering = false;
+
+    mpo->deallocate();
+    hamil->deallocate();
+    fcidump->deallocate();
+}
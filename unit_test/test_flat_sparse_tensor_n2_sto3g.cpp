@@ -0,0 +1,156 @@
+
+#include "block2_core.hpp"
+#include "block2_dmrg.hpp"
+#include <gtest/gtest.h>
+
+using namespace block2;
+
+class TestFlatSparseTensorN2STO3G : public ::testing::Test {
+  protected:
+    size_t isize = 1LL << 24;
+    size_t dsize = 1LL << 30;
+    typedef double FP;
+    void SetUp() override {
+        Random::rand_seed(0);
+        frame_<FP>() = make_shared<DataFrame<FP>>(isize, dsize, "nodex");
+        threading_() = make_shared<Threading>(
+            ThreadingTypes::OperatorBatchedGEMM | ThreadingTypes::Global, 2, 2,
+            1);
+        threading_()->seq_type = SeqTypes::Tasked;
+    }
+    void TearDown() override {
+        frame_<FP>()->activate(0);
+        assert(ialloc_()->used == 0 && dalloc_<FP>()->used == 0);
+        frame_<FP>() = nullptr;
+    }
+};
+
+TEST_F(TestFlatSparseTensorN2STO3G, TestSZ) {
+    shared_ptr<FCIDUMP<FP>> fcidump = make_shared<FCIDUMP<FP>>();
+    PGTypes pg = PGTypes::D2H;
+    fcidump->read("data/N2.STO3G.FCIDUMP");
+    vector<uint8_t> orbsym = fcidump->template orb_sym<uint8_t>();
+    transform(orbsym.begin(), orbsym.end(), orbsym.begin(),
+              [pg](uint8_t x) { return (uint8_t)PointGroup::swap_pg(pg)(x); });
+    const double ener_ref = -107.654122447525;
+    SZ vacuum(0), target(fcidump->n_elec(), fcidump->twos(), 0);
+    const int n = fcidump->n_sites();
+    shared_ptr<HamiltonianQC<SZ, FP>> hamil =
+        make_shared<HamiltonianQC<SZ, FP>>(vacuum, n, orbsym, fcidump);
+
+    // unsimplified MPO: every block satisfies ql + (qu - qd) = qr
+    shared_ptr<MPO<SZ, FP>> mpo_nc =
+        make_shared<MPOQC<SZ, FP>>(hamil, QCTypes::NC);
+    size_t mpo_size = 0;
+    for (int i = 0; i < n; i++) {
+        shared_ptr<FlatSparseTensor<SZ, FP>> ft =
+            FlatSparseTensor<SZ, FP>::from_mpo_tensor(i, mpo_nc);
+        const int rank = ft->rank;
+        EXPECT_EQ(rank, i == 0 || i == n - 1 ? 3 : 4);
+        EXPECT_GT(ft->n_blocks(), 0);
+        for (int k = 0; k < ft->n_blocks(); k++) {
+            const SZ *q = ft->qs.data() + k * rank;
+            const int il = i != 0;
+            SZ ql = il ? q[0] : vacuum, qu = q[il], qd = q[il + 1];
+            SZ qr = i == n - 1 ? vacuum : q[rank - 1];
+            EXPECT_EQ(ql + qu - qd, qr);
+        }
+        mpo_size += ft->size();
+    }
+    EXPECT_GT(mpo_size, 0u);
+
+    shared_ptr<MPO<SZ, FP>> mpo =
+        make_shared<MPOQC<SZ, FP>>(hamil, QCTypes::Conventional);
+    mpo = make_shared<SimplifiedMPO<SZ, FP>>(
+        mpo, make_shared<RuleQC<SZ, FP>>(), true, true,
+        OpNamesSet({OpNames::R, OpNames::RD}));
+    shared_ptr<MPSInfo<SZ>> mps_info =
+        make_shared<MPSInfo<SZ>>(n, vacuum, target, hamil->basis);
+    mps_info->set_bond_dimension(200);
+    shared_ptr<MPS<SZ, FP>> mps = make_shared<MPS<SZ, FP>>(n, 0, 1);
+    mps->initialize(mps_info);
+    mps->random_canonicalize();
+    mps->save_mutable();
+    mps->deallocate();
+    mps_info->save_mutable();
+    mps_info->deallocate_mutable();
+    shared_ptr<MovingEnvironment<SZ, FP, FP>> me =
+        make_shared<MovingEnvironment<SZ, FP, FP>>(mpo, mps, mps, "DMRG");
+    me->init_environments(false);
+    shared_ptr<DMRG<SZ, FP, FP>> dmrg = make_shared<DMRG<SZ, FP, FP>>(
+        me, vector<ubond_t>{200}, vector<FP>{1E-6, 1E-8, 0});
+    dmrg->iprint = 0;
+    double energy = (double)dmrg->solve(20, true, 1E-10);
+    EXPECT_LT(abs(energy - ener_ref), 1E-7);
+
+    // site-by-site export matches the unfused MPS block by block
+    shared_ptr<UnfusedMPS<SZ, FP>> umps = make_shared<UnfusedMPS<SZ, FP>>(mps);
+    vector<shared_ptr<FlatSparseTensor<SZ, FP>>> fts(n);
+    for (int i = 0; i < n; i++) {
+        fts[i] = FlatSparseTensor<SZ, FP>::from_mps_tensor(i, mps);
+        int k = 0;
+        for (int im = 0; im < (int)umps->tensors[i]->data.size(); im++)
+            for (auto &blk : umps->tensors[i]->data[im]) {
+                EXPECT_EQ(fts[i]->qs[k * 3], blk.first.first);
+                EXPECT_EQ(fts[i]->qs[k * 3 + 1],
+                          mps_info->basis[i]->quanta[im]);
+                EXPECT_EQ(fts[i]->qs[k * 3 + 2], blk.first.second);
+                EXPECT_EQ(fts[i]->offsets[k + 1] - fts[i]->offsets[k],
+                          blk.second->size());
+                EXPECT_EQ(memcmp(fts[i]->block_data(k),
+                                 blk.second->data->data(),
+                                 blk.second->size() * sizeof(FP)),
+                          0);
+                k++;
+            }
+        EXPECT_EQ(k, fts[i]->n_blocks());
+    }
+
+    // the export is an MPS in the pyblock2.algebra convention: labels
+    // conserved on each site from the vacuum to the target, and unit norm
+    shared_ptr<BlockSparseTensor<SZ, FP>> env = nullptr;
+    for (int i = 0; i < n; i++) {
+        shared_ptr<BlockSparseTensor<SZ, FP>> ket =
+            make_shared<BlockSparseTensor<SZ, FP>>();
+        for (int k = 0; k < fts[i]->n_blocks(); k++) {
+            const SZ *q = fts[i]->qs.data() + k * 3;
+            EXPECT_EQ(q[0] + q[1], q[2]);
+            EXPECT_TRUE(i != 0 || q[0] == vacuum);
+            EXPECT_TRUE(i != n - 1 || q[2] == target);
+            ket->add_block(vector<SZ>(q, q + 3),
+                           vector<MKL_INT>(fts[i]->shapes.begin() + k * 3,
+                                           fts[i]->shapes.begin() + k * 3 + 3),
+                           make_shared<vector<FP>>(fts[i]->block_data(k),
+                                                   fts[i]->block_data(k + 1)));
+        }
+        shared_ptr<BlockSparseTensor<SZ, FP>> bra =
+            env == nullptr
+                ? ket
+                : BlockSparseTensor<SZ, FP>::contract(env, ket, {1}, {0});
+        env = BlockSparseTensor<SZ, FP>::contract(bra, ket, {0, 1}, {0, 1});
+    }
+    ASSERT_EQ(env->n_blocks(), 1u);
+    EXPECT_LT(abs((*env->data[0])[0] - 1.0), 1E-10);
+
+    // import back and rebuild the MPS
+    for (int i = 0; i < n; i++)
+        umps->tensors[i] = fts[i]->to_sparse_tensor(mps_info->basis[i]);
+    shared_ptr<MPS<SZ, FP>> xmps = umps->finalize();
+    for (int i = 0; i < n; i++) {
+        shared_ptr<FlatSparseTensor<SZ, FP>> ft =
+            FlatSparseTensor<SZ, FP>::from_mps_tensor(i, xmps);
+        EXPECT_EQ(ft->qs, fts[i]->qs);
+        EXPECT_EQ(*ft->data, *fts[i]->data);
+    }
+    me = make_shared<MovingEnvironment<SZ, FP, FP>>(mpo, xmps, xmps, "EX");
+    me->init_environments(false);
+    shared_ptr<Expect<SZ, FP, FP>> ex =
+        make_shared<Expect<SZ, FP, FP>>(me, 200, 200);
+    EXPECT_LT(abs(ex->solve(false) - energy), 1E-10);
+
+    mps_info->deallocate();
+    mpo->deallocate();
+    mpo_nc->deallocate();
+    hamil->deallocate();
+    fcidump->deallocate();
+}
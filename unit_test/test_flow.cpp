@@ -0,0 +1,48 @@
+
+#include "block2_core.hpp"
+#include <gtest/gtest.h>
+
+using namespace block2;
+
+class TestFlow : public ::testing::Test {
+  protected:
+    static const int n_tests = 200;
+    void SetUp() override { Random::rand_seed(0); }
+    void TearDown() override {}
+};
+
+TEST_F(TestFlow, TestBipartiteMVC) {
+    for (int i = 0; i < n_tests; i++) {
+        int nl = Random::rand_int(1, 300), nr = Random::rand_int(1, 300);
+        // sparse and dense graphs, with duplicated edges
+        int ne = Random::rand_int(0, i % 2 ? nl * nr : 3 * (nl + nr));
+        vector<pair<pair<int, int>, double>> edges(ne);
+        for (auto &e : edges)
+            e.first = make_pair(Random::rand_int(0, nl),
+                                Random::rand_int(0, nr)),
+            e.second = 1.0;
+        Flow flow(nl + nr);
+        for (auto &e : edges)
+            flow.resi[e.first.first][e.first.second + nl] = 1;
+        for (int k = 0; k < nl; k++)
+            flow.resi[nl + nr][k] = 1;
+        for (int k = 0; k < nr; k++)
+            flow.resi[nl + k][nl + nr + 1] = 1;
+        vector<int> fx, fy, bx, by;
+        flow.mvc(0, nl, nl, nr, fx, fy);
+        BipartiteMatching bm(nl, nr);
+        bm.init_edges(edges);
+        int nm = bm.mvc(bx, by);
+        EXPECT_EQ(nm, (int)(bx.size() + by.size()));
+        EXPECT_EQ(fx, bx);
+        EXPECT_EQ(fy, by);
+        // the cover covers all edges
+        vector<uint8_t> cl(nl, 0), cr(nr, 0);
+        for (int x : bx)
+            cl[x] = 1;
+        for (int y : by)
+            cr[y] = 1;
+        for (auto &e : edges)
+            EXPECT_TRUE(cl[e.first.first] || cr[e.first.second]);
+    }
+}
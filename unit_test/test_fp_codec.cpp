@@ -146,3 +146,108 @@ TEST_F(TestFPCodec, TestFloatCompressedVector) {
         }
     }
 }
+
+TEST_F(TestFPCodec, TestDoubleBlockFPCodec) {
+    for (int i = 0; i < n_tests; i++) {
+        int n;
+        if (i < n_tests * 10 / 100)
+            n = Random::rand_int(1, 12);
+        else if (i < n_tests * 40 / 100)
+            n = Random::rand_int(1, 10000);
+        else
+            n = Random::rand_int(1, 50000);
+        int chunk_size = Random::rand_int(1, 1 + n * 4 / 3);
+        int block_size = Random::rand_int(32, 257);
+        vector<double> arr(n), arx(n);
+        if (Random::rand_int(0, 10) != 0)
+            Random::fill<double>(arr.data(), n, -5, 5);
+        // blocks with large dynamic range are stored without compression
+        if (Random::rand_int(0, 4) == 0)
+            for (int j = 0; j < n / 100 + 1; j++)
+                arr[Random::rand_int(0, n)] = Random::rand_double(-1, 1) * 1E12;
+        FPCodec<double> fpc(1E-8, chunk_size, block_size);
+        stringstream ss;
+        fpc.write_array(ss, arr.data(), n);
+        ss.clear();
+        ss.seekg(0);
+        fpc.read_array(ss, arx.data(), n);
+        EXPECT_TRUE(MatrixFunctions::all_close(
+            MatrixRef(arr.data(), n, 1), MatrixRef(arx.data(), n, 1), 1E-8, 0));
+    }
+}
+
+TEST_F(TestFPCodec, TestFloatBlockCompressedVector) {
+    for (int i = 0; i < n_tests; i++) {
+        int n;
+        if (i < n_tests * 10 / 100)
+            n = Random::rand_int(1, 12);
+        else if (i < n_tests * 40 / 100)
+            n = Random::rand_int(1, 10000);
+        else
+            n = Random::rand_int(1, 50000);
+        int chunk_size = Random::rand_int(5, 100);
+        int block_size = Random::rand_int(32, 257);
+        vector<float> arr(n), arx(n);
+        if (Random::rand_int(0, 10) != 0)
+            Random::fill<float>(arr.data(), n, -5, 5);
+        float prec = (float)1E-4;
+        FPCodec<float> fpc(prec, chunk_size, block_size);
+        stringstream ss;
+        fpc.write_array(ss, arr.data(), n);
+        ss.clear();
+        ss.seekg(0);
+        CompressedVector<float> carr(ss, n, prec);
+        EXPECT_EQ(carr.fpc.block_size, (size_t)block_size);
+        const CompressedVector<float> &ccarr = carr;
+        for (int j = 0; j < n / 4 + 1; j++) {
+            int h = Random::rand_int(0, n);
+            if (Random::rand_int(0, 2))
+                EXPECT_LE(abs(ccarr[h] - arr[h]), 2 * prec);
+            else {
+                arr[h] = (float)Random::rand_double(-5, 5);
+                carr[h] = arr[h];
+            }
+        }
+        const CompressedVectorMT<float> carr_mt(
+            make_shared<CompressedVector<float>>(carr), 1);
+        for (int j = 0; j < n / 4 + 1; j++) {
+            int h = Random::rand_int(0, n);
+            EXPECT_LE(abs(carr_mt[h] - arr[h]), 2 * prec);
+        }
+    }
+}
+
+TEST_F(TestFPCodec, TestFPCodecThroughput) {
+    const size_t n = 1 << 22, chunk_size = 4096;
+    vector<double> arr(n), arx(n), cps(n + n / chunk_size);
+    // magnitudes spanning several orders, as in renormalized operators
+    for (size_t i = 0; i < n; i++)
+        arr[i] = Random::rand_double(-1, 1) *
+                 pow(10.0, -8.0 * (double)Random::rand_double(0, 1));
+    for (size_t block_size : vector<size_t>{0, 32, 64, 128, 256}) {
+        FPCodec<double> fpc(1E-12, chunk_size, block_size);
+        vector<size_t> cplens(n / chunk_size);
+        Timer t;
+        t.get_time();
+        for (size_t ic = 0; ic < n / chunk_size; ic++)
+            cplens[ic] = fpc.encode(arr.data() + ic * chunk_size, chunk_size,
+                                    cps.data() + ic * (chunk_size + 1));
+        double tenc = t.get_time();
+        for (size_t ic = 0; ic < n / chunk_size; ic++)
+            EXPECT_EQ(fpc.decode(cps.data() + ic * (chunk_size + 1),
+                                 chunk_size, arx.data() + ic * chunk_size),
+                      cplens[ic]);
+        double tdec = t.get_time();
+        size_t ncpsd = 0;
+        for (auto &cplen : cplens)
+            ncpsd += cplen;
+        double gb = (double)(n * sizeof(double)) / 1E9;
+        cout << "block size = " << setw(4) << block_size << " ratio = " << fixed
+             << setprecision(3) << (double)n / ncpsd << " encode = " << setw(7)
+             << gb / tenc << " GB/s"
+             << " decode = " << setw(7) << gb / tdec << " GB/s" << endl;
+        EXPECT_TRUE(MatrixFunctions::all_close(MatrixRef(arr.data(), n, 1),
+                                               MatrixRef(arx.data(), n, 1),
+                                               2E-12, 0));
+    }
+}
@@ -0,0 +1,136 @@
+
+#include "block2_core.hpp"
+#include "block2_dmrg.hpp"
+#include <gtest/gtest.h>
+
+using namespace block2;
+
+class TestFusedRotationN2STO3G : public ::testing::Test {
+  protected:
+    size_t isize = 1LL << 24;
+    size_t dsize = 1LL << 30;
+    void SetUp() override {
+        Random::rand_seed(0);
+        frame_<double>() =
+            make_shared<DataFrame<double>>(isize, dsize, "nodex");
+        frame_<double>()->minimal_disk_usage = true;
+        threading_() = make_shared<Threading>(
+            ThreadingTypes::OperatorBatchedGEMM | ThreadingTypes::Global, 2, 2,
+            1);
+    }
+    void TearDown() override {
+        frame_<double>()->activate(0);
+        assert(ialloc_()->used == 0 && dalloc_<double>()->used == 0);
+        frame_<double>() = nullptr;
+    }
+    shared_ptr<MPO<SU2, double>>
+    get_mpo(const shared_ptr<HamiltonianQC<SU2, double>> &hamil) {
+        shared_ptr<MPO<SU2, double>> mpo = make_shared<MPOQC<SU2, double>>(
+            hamil, QCTypes::Conventional, "HQC");
+        mpo->basis = hamil->basis;
+        return make_shared<SimplifiedMPO<SU2, double>>(
+            mpo, make_shared<RuleQC<SU2, double>>(), true, true,
+            OpNamesSet({OpNames::R, OpNames::RD}));
+    }
+    shared_ptr<MPS<SU2, double>>
+    get_mps(const shared_ptr<HamiltonianQC<SU2, double>> &hamil,
+            const shared_ptr<MPO<SU2, double>> &mpo, const string &tag) {
+        SU2 target(hamil->fcidump->n_elec(), 0, 0);
+        shared_ptr<MPSInfo<SU2>> mps_info = make_shared<MPSInfo<SU2>>(
+            mpo->n_sites, hamil->vacuum, target, mpo->basis);
+        mps_info->tag = tag;
+        mps_info->set_bond_dimension(200);
+        shared_ptr<MPS<SU2, double>> mps =
+            make_shared<MPS<SU2, double>>(mpo->n_sites, 0, 2);
+        mps->initialize(mps_info);
+        mps->random_canonicalize();
+        mps->save_mutable();
+        mps->deallocate();
+        mps_info->save_mutable();
+        mps_info->deallocate_mutable();
+        return mps;
+    }
+    shared_ptr<MovingEnvironment<SU2, double, double>>
+    get_me(const shared_ptr<MPO<SU2, double>> &mpo,
+           const shared_ptr<MPS<SU2, double>> &mps, const string &tag,
+           bool fused) {
+        shared_ptr<MovingEnvironment<SU2, double, double>> me =
+            make_shared<MovingEnvironment<SU2, double, double>>(mpo, mps, mps,
+                                                                tag);
+        me->fused_contraction_rotation = fused;
+        me->init_environments(false);
+        me->delayed_contraction = OpNamesSet::normal_ops();
+        return me;
+    }
+    // data of the right renormalized operators at site i
+    map<string, vector<double>>
+    get_right_env(const shared_ptr<MovingEnvironment<SU2, double, double>> &me,
+                  int i) {
+        map<string, vector<double>> r;
+        frame_<double>()->load_data(1, me->right_part_files.at(i).first);
+        for (auto &p : me->envs[i]->right->ops)
+            r[Parsing::to_string(p.first)] =
+                vector<double>(p.second->data,
+                               p.second->data + p.second->total_memory);
+        return r;
+    }
+    double run_dmrg(const shared_ptr<MovingEnvironment<SU2, double, double>> &me) {
+        shared_ptr<DMRG<SU2, double, double>> dmrg =
+            make_shared<DMRG<SU2, double, double>>(
+                me, vector<ubond_t>{200}, vector<double>{1E-8, 1E-9, 0.0});
+        dmrg->iprint = 0;
+        return (double)dmrg->solve(10, me->ket->center == 0, 1E-8);
+    }
+};
+
+TEST_F(TestFusedRotationN2STO3G, TestSU2) {
+    shared_ptr<FCIDUMP<double>> fcidump = make_shared<FCIDUMP<double>>();
+    PGTypes pg = PGTypes::D2H;
+    fcidump->read("data/N2.STO3G.FCIDUMP");
+    vector<uint8_t> orbsym = fcidump->template orb_sym<uint8_t>();
+    transform(orbsym.begin(), orbsym.end(), orbsym.begin(),
+              [pg](uint8_t x) { return (uint8_t)PointGroup::swap_pg(pg)(x); });
+    const double ener_ref = -107.654122447525;
+
+    for (SeqTypes seq_type : {SeqTypes::Tasked, SeqTypes::None}) {
+        threading_()->seq_type = seq_type;
+        shared_ptr<HamiltonianQC<SU2, double>> hamil =
+            make_shared<HamiltonianQC<SU2, double>>(
+                SU2(0), fcidump->n_sites(), orbsym, fcidump);
+        for (bool main_stack : {true, false}) {
+            frame_<double>()->use_main_stack = main_stack;
+            shared_ptr<MPO<SU2, double>> mpo = get_mpo(hamil);
+            shared_ptr<MPS<SU2, double>> mps = get_mps(hamil, mpo, "KET");
+            shared_ptr<MovingEnvironment<SU2, double, double>> me_ref =
+                get_me(mpo, mps, "REF", false);
+            shared_ptr<MovingEnvironment<SU2, double, double>> me_fused =
+                get_me(mpo, mps, "FUSED", true);
+            // renormalized operators are the same with the blocked path
+            EXPECT_GT(me_ref->right_part_files.size(), (size_t)0);
+            for (auto &pf : me_ref->right_part_files) {
+                map<string, vector<double>> xref =
+                    get_right_env(me_ref, pf.first);
+                map<string, vector<double>> xfused =
+                    get_right_env(me_fused, pf.first);
+                ASSERT_EQ(xref.size(), xfused.size());
+                for (auto &p : xref) {
+                    ASSERT_TRUE(xfused.count(p.first));
+                    const vector<double> &x = p.second, &y = xfused[p.first];
+                    ASSERT_EQ(x.size(), y.size());
+                    for (size_t k = 0; k < x.size(); k++)
+                        EXPECT_NEAR(x[k], y[k], 1E-12);
+                }
+            }
+            frame_<double>()->activate(0);
+            me_ref->remove_partition_files();
+            // fused contraction and rotation in all sweeps
+            EXPECT_LT(abs(run_dmrg(me_fused) - ener_ref), 1E-7);
+            me_fused->remove_partition_files();
+            mps->info->deallocate();
+            mpo->deallocate();
+        }
+        hamil->deallocate();
+    }
+
+    fcidump->deallocate();
+}
@@ -0,0 +1,181 @@
+
+#include "block2_core.hpp"
+#include "block2_dmrg.hpp"
+#include <gtest/gtest.h>
+
+using namespace block2;
+
+class TestGeometryContinuationN2STO3G : public ::testing::Test {
+  protected:
+    size_t isize = 1LL << 24;
+    size_t dsize = 1LL << 30;
+    typedef double FP;
+    void SetUp() override {
+        Random::rand_seed(0);
+        frame_<FP>() = make_shared<DataFrame<FP>>(isize, dsize, "nodex");
+        frame_<FP>()->minimal_disk_usage = true;
+        threading_() = make_shared<Threading>(
+            ThreadingTypes::OperatorBatchedGEMM | ThreadingTypes::Global, 2, 2,
+            1);
+        threading_()->seq_type = SeqTypes::Tasked;
+    }
+    void TearDown() override {
+        frame_<FP>()->activate(0);
+        assert(ialloc_()->used == 0 && dalloc_<FP>()->used == 0);
+        frame_<FP>() = nullptr;
+    }
+};
+
+TEST_F(TestGeometryContinuationN2STO3G, TestAlignment) {
+    const int n = 4;
+    // new orbitals 0 and 1 are swapped, new orbital 3 has flipped sign,
+    // with a small leakage between irreps
+    vector<FP> ov = {0.1, 0.99, 0.05, 0.0, 0.99, 0.1, 0.0, 0.0,
+                     0.05, 0.0, 0.99, 0.0, 0.0, 0.0, 0.0, -1.0};
+    vector<uint8_t> sym = {0, 0, 1, 1};
+    GeometryContinuation<SU2, FP> gc(ov, n, sym, sym);
+    EXPECT_EQ(gc.reorder, (vector<uint16_t>{1, 0, 2, 3}));
+    EXPECT_EQ(gc.phases, (vector<FP>{1, 1, 1, -1}));
+    EXPECT_EQ(gc.n_permuted(), 3);
+    // residual rotation is orthogonal
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++) {
+            FP x = 0;
+            for (int k = 0; k < n; k++)
+                x += gc.rotation[k * n + i] * gc.rotation[k * n + j];
+            EXPECT_LT(abs(x - (FP)(i == j)), 1E-12);
+        }
+    EXPECT_GT(gc.min_overlap, 0.8);
+    // the largest overlap is never matched across irreps
+    vector<FP> ovx = {0.1, 0.0, 0.99, 0.0, 0.99, 0.1, 0.0, 0.0,
+                      0.0,  0.99, 0.1, 0.0, 0.0, 0.0, 0.0, 1.0};
+    GeometryContinuation<SU2, FP> gcx(ovx, n, sym, sym);
+    EXPECT_EQ(gcx.reorder, (vector<uint16_t>{1, 0, 2, 3}));
+    const vector<uint8_t> symx = {0, 1, 1, 1};
+    typedef GeometryContinuation<SU2, FP> GC;
+    EXPECT_THROW(GC(ov, n, sym, symx), runtime_error);
+    // the leakage between irreps is not part of the residual rotation
+    for (int i = 0; i < n; i++)
+        for (int k = 0; k < n; k++)
+            if (sym[i] != sym[k])
+                EXPECT_EQ(gc.rotation[i * n + k], 0.0);
+    gc.check_rotation();
+    // a rotation within an irrep whose sites are not contiguous
+    const vector<uint8_t> syms = {0, 1, 0, 1};
+    vector<FP> ovs = {0.99, 0.0, 0.1, 0.0, 0.0, 1.0, 0.0, 0.0,
+                      -0.1, 0.0, 0.99, 0.0, 0.0, 0.0, 0.0, 1.0};
+    GeometryContinuation<SU2, FP> gcs(ovs, n, syms, syms);
+    EXPECT_EQ(gcs.n_permuted(), 0);
+    EXPECT_GT(gcs.max_rotation, 0.05);
+    EXPECT_THROW(gcs.check_rotation(), runtime_error);
+    // without rotation the irreps need not be contiguous
+    vector<FP> ovi(n * n, 0);
+    for (int i = 0; i < n; i++)
+        ovi[i * n + i] = 1;
+    GeometryContinuation<SU2, FP> gci(ovi, n, syms, syms);
+    EXPECT_LT(gci.max_rotation, 1E-12);
+    gci.check_rotation();
+}
+
+TEST_F(TestGeometryContinuationN2STO3G, TestWarmStartSU2) {
+    shared_ptr<FCIDUMP<FP>> fcidump = make_shared<FCIDUMP<FP>>();
+    fcidump->read("data/N2.STO3G.FCIDUMP");
+    const double ener_ref = -107.654122447525;
+    const int n = fcidump->n_sites();
+    // without point group symmetry, so that any rotation is allowed
+    vector<uint8_t> orbsym(n, 0);
+    SU2 vacuum(0), target(fcidump->n_elec(), fcidump->twos(), 0);
+
+    auto build_mpo = [&](const shared_ptr<HamiltonianQC<SU2, FP>> &hamil) {
+        shared_ptr<MPO<SU2, FP>> mpo =
+            make_shared<MPOQC<SU2, FP>>(hamil, QCTypes::Conventional);
+        mpo = make_shared<SimplifiedMPO<SU2, FP>>(
+            mpo, make_shared<RuleQC<SU2, FP>>(), true);
+        return mpo;
+    };
+
+    shared_ptr<HamiltonianQC<SU2, FP>> hamil =
+        make_shared<HamiltonianQC<SU2, FP>>(vacuum, n, orbsym, fcidump);
+    shared_ptr<MPO<SU2, FP>> mpo = build_mpo(hamil);
+    shared_ptr<MPSInfo<SU2>> mps_info =
+        make_shared<MPSInfo<SU2>>(n, vacuum, target, hamil->basis);
+    mps_info->set_bond_dimension(200);
+    mps_info->tag = "KET";
+    shared_ptr<MPS<SU2, FP>> mps = make_shared<MPS<SU2, FP>>(n, 0, 2);
+    mps->initialize(mps_info);
+    mps->random_canonicalize();
+    mps->save_mutable();
+    mps->deallocate();
+    mps_info->save_mutable();
+    mps_info->deallocate_mutable();
+    shared_ptr<MovingEnvironment<SU2, FP, FP>> me =
+        make_shared<MovingEnvironment<SU2, FP, FP>>(mpo, mps, mps, "DMRG");
+    me->init_environments(false);
+    shared_ptr<DMRG<SU2, FP, FP>> dmrg = make_shared<DMRG<SU2, FP, FP>>(
+        me, vector<ubond_t>{200}, vector<FP>{1E-6, 1E-8, 0});
+    dmrg->iprint = 0;
+    double energy = (double)dmrg->solve(20, true, 1E-10);
+    EXPECT_LT(abs(energy - ener_ref), 1E-7);
+    const int cold_sweeps = (int)dmrg->energies.size();
+
+    // orbitals at the "next geometry": a small rotation exp(kappa) of the
+    // converged orbitals, shuffled and with some signs flipped
+    const int ideg = 6;
+    vector<FP> kappa(n * n, 0), work(4 * n * n + ideg + 1);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < i; j++) {
+            kappa[i * n + j] = 0.02 * Random::rand_double(-1, 1);
+            kappa[j * n + i] = -kappa[i * n + j];
+        }
+    pair<MKL_INT, MKL_INT> pp = IterativeMatrixFunctions<FP>::expo_pade(
+        ideg, n, kappa.data(), n, 1.0, work.data());
+    vector<FP> rot(work.begin() + pp.first, work.begin() + pp.first + n * n);
+    vector<int> perm = {3, 0, 1, 2, 4, 5, 9, 7, 8, 6};
+    vector<FP> sign = {1, -1, 1, 1, -1, 1, 1, 1, -1, 1};
+    // overlap[i * n + j] = <old i | new j>
+    vector<FP> overlap(n * n);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            overlap[i * n + j] = rot[i * n + perm[j]] * sign[j];
+    shared_ptr<FCIDUMP<FP>> fcidump_new = fcidump->deep_copy();
+    fcidump_new->rotate(overlap);
+
+    GeometryContinuation<SU2, FP> gc(overlap, n);
+    gc.iprint = 0;
+    for (int j = 0; j < n; j++) {
+        EXPECT_EQ(gc.reorder[perm[j]], j);
+        EXPECT_EQ(gc.phases[perm[j]], sign[j]);
+    }
+    EXPECT_GT(gc.max_rotation, 1E-3);
+    FP dw = gc.rotate_mps(mps, 500);
+    EXPECT_LT(dw, 1E-7);
+
+    // the rotated MPS is already the ground state in the aligned orbitals
+    shared_ptr<HamiltonianQC<SU2, FP>> hamil_new =
+        make_shared<HamiltonianQC<SU2, FP>>(vacuum, n, orbsym,
+                                            gc.align_fcidump(fcidump_new));
+    shared_ptr<MPO<SU2, FP>> mpo_new = build_mpo(hamil_new);
+    shared_ptr<MovingEnvironment<SU2, FP, FP>> me_new =
+        make_shared<MovingEnvironment<SU2, FP, FP>>(mpo_new, mps, mps, "DMRG");
+    me_new->init_environments(false);
+    shared_ptr<Expect<SU2, FP, FP>> ex =
+        make_shared<Expect<SU2, FP, FP>>(me_new, 500, 500);
+    double ener_rot = ex->solve(false);
+    EXPECT_LT(abs(ener_rot - ener_ref), 1E-6);
+
+    // short schedule from the warm start
+    me_new->init_environments(false);
+    dmrg = make_shared<DMRG<SU2, FP, FP>>(me_new, vector<ubond_t>{200},
+                                          vector<FP>{0});
+    dmrg->iprint = 0;
+    energy = (double)dmrg->solve(10, mps->center == 0, 1E-10);
+    EXPECT_LT(abs(energy - ener_ref), 1E-7);
+    EXPECT_LT((int)dmrg->energies.size(), cold_sweeps);
+
+    mpo_new->deallocate();
+    hamil_new->deallocate();
+    mps_info->deallocate();
+    mpo->deallocate();
+    hamil->deallocate();
+    fcidump->deallocate();
+}
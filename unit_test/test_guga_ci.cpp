@@ -0,0 +1,233 @@
+#include "block2_core.hpp"
+#include "ic/guga_ci.hpp"
+#include <gtest/gtest.h>
+
+using namespace block2;
+
+class TestGUGADirectCI : public ::testing::Test {
+  protected:
+    size_t isize = 1LL << 24;
+    size_t dsize = 1LL << 28;
+    void SetUp() override {
+        Random::rand_seed(0);
+        frame_<double>() =
+            make_shared<DataFrame<double>>(isize, dsize, "nodex");
+        threading_() = make_shared<Threading>(
+            ThreadingTypes::OperatorBatchedGEMM | ThreadingTypes::Global, 4, 4,
+            1);
+        threading_()->seq_type = SeqTypes::Tasked;
+    }
+    void TearDown() override {
+        frame_<double>()->activate(0);
+        assert(ialloc_()->used == 0 && dalloc_<double>()->used == 0);
+        frame_<double>() = nullptr;
+    }
+    // H in the Sz = 0 determinant space using second quantization
+    static vector<double> det_spectrum(const shared_ptr<FCIDUMP<double>> &fd,
+                                       int n_elec) {
+        const int n = fd->n_sites();
+        vector<uint32_t> dets;
+        for (uint32_t x = 0; x < (1U << (n + n)); x++)
+            if (__builtin_popcount(x & ((1U << n) - 1)) == n_elec / 2 &&
+                __builtin_popcount(x >> n) == n_elec / 2)
+                dets.push_back(x);
+        const int nd = (int)dets.size();
+        // apply a_p (cre = false) or a+_p (cre = true) with fermion sign
+        auto apply = [](uint32_t &x, int p, bool cre) -> int {
+            if (((x >> p) & 1) == (uint32_t)cre)
+                return 0;
+            int sign = (__builtin_popcount(x & ((1U << p) - 1)) & 1) ? -1 : 1;
+            x ^= 1U << p;
+            return sign;
+        };
+        MatrixRef h(nullptr, nd, nd);
+        h.allocate();
+        h.clear();
+        for (int ik = 0; ik < nd; ik++) {
+            h(ik, ik) += fd->e();
+            for (int p = 0; p < n + n; p++)
+                for (int q = 0; q < n + n; q++) {
+                    if (p / n != q / n)
+                        continue;
+                    uint32_t x = dets[ik];
+                    int s = apply(x, q, false);
+                    s *= s == 0 ? 0 : apply(x, p, true);
+                    if (s == 0)
+                        continue;
+                    int ib = (int)(lower_bound(dets.begin(), dets.end(), x) -
+                                   dets.begin());
+                    h(ib, ik) += s * fd->t(p % n, q % n);
+                }
+            for (int p = 0; p < n + n; p++)
+                for (int q = 0; q < n + n; q++)
+                    for (int r = 0; r < n + n; r++)
+                        for (int t = 0; t < n + n; t++) {
+                            if (p / n != t / n || q / n != r / n)
+                                continue;
+                            uint32_t x = dets[ik];
+                            int s = apply(x, t, false);
+                            s *= s == 0 ? 0 : apply(x, r, false);
+                            s *= s == 0 ? 0 : apply(x, q, true);
+                            s *= s == 0 ? 0 : apply(x, p, true);
+                            if (s == 0)
+                                continue;
+                            int ib = (int)(lower_bound(dets.begin(),
+                                                       dets.end(), x) -
+                                           dets.begin());
+                            h(ib, ik) += 0.5 * s *
+                                         fd->v(p % n, t % n, q % n, r % n);
+                        }
+        }
+        DiagonalMatrix w(nullptr, nd);
+        w.allocate();
+        MatrixFunctions::eigs(h, w);
+        vector<double> r(w.data, w.data + nd);
+        w.deallocate();
+        h.deallocate();
+        return r;
+    }
+};
+
+TEST_F(TestGUGADirectCI, TestH4Spectrum) {
+    shared_ptr<FCIDUMP<double>> fcidump = make_shared<FCIDUMP<double>>();
+    fcidump->read("data/H4.STO6G.R1.8.FCIDUMP");
+    const int n = fcidump->n_sites(), n_elec = fcidump->n_elec();
+    vector<double> ref = det_spectrum(fcidump, n_elec);
+    vector<double> csf_eners;
+    for (int twos = 0; twos <= n_elec; twos += 2) {
+        const int16_t a = (int16_t)((n_elec - twos) / 2);
+        shared_ptr<DistinctRowTable<void>> drt =
+            make_shared<DistinctRowTable<void>>(a, (int16_t)twos,
+                                                (int16_t)(n - a - twos));
+        drt->initialize();
+        for (long long i = 0; i < drt->xs[0][3]; i++)
+            EXPECT_EQ(drt->index_of_step_vector(drt->step_vector_of_index(i)),
+                      i);
+        GUGADirectCI<double> ci(drt);
+        ci.initialize();
+        ci.set_integrals(fcidump);
+        const int nc = (int)ci.n_csf;
+        // explicit hamiltonian from sigma vectors
+        MatrixRef h(nullptr, nc, nc), c(nullptr, nc, 1), s(nullptr, nc, 1);
+        h.allocate(), c.allocate(), s.allocate();
+        DiagonalMatrix aa(nullptr, nc);
+        aa.allocate();
+        ci.diag(aa);
+        for (int i = 0; i < nc; i++) {
+            c.clear(), s.clear();
+            c.data[i] = 1.0;
+            ci(c, s);
+            for (int j = 0; j < nc; j++)
+                h(j, i) = s.data[j];
+            EXPECT_LT(abs(aa.data[i] - s.data[i]), 1E-10);
+        }
+        for (int i = 0; i < nc; i++)
+            for (int j = 0; j < i; j++)
+                EXPECT_LT(abs(h(i, j) - h(j, i)), 1E-10);
+        DiagonalMatrix w(nullptr, nc);
+        w.allocate();
+        MatrixFunctions::eigs(h, w);
+        csf_eners.insert(csf_eners.end(), w.data, w.data + nc);
+        w.deallocate();
+        aa.deallocate();
+        s.deallocate(), c.deallocate(), h.deallocate();
+    }
+    // each spin multiplet appears once in the Sz = 0 determinant space
+    sort(csf_eners.begin(), csf_eners.end());
+    ASSERT_EQ(csf_eners.size(), ref.size());
+    for (size_t i = 0; i < ref.size(); i++)
+        EXPECT_LT(abs(csf_eners[i] - ref[i]), 1E-10);
+}
+
+TEST_F(TestGUGADirectCI, TestN2STO3G) {
+    shared_ptr<FCIDUMP<double>> fcidump = make_shared<FCIDUMP<double>>();
+    PGTypes pg = PGTypes::D2H;
+    fcidump->read("data/N2.STO3G.FCIDUMP");
+    vector<uint8_t> orbsym = fcidump->template orb_sym<uint8_t>();
+    transform(orbsym.begin(), orbsym.end(), orbsym.begin(),
+              [pg](uint8_t x) { return (uint8_t)PointGroup::swap_pg(pg)(x); });
+    const int n = fcidump->n_sites(), n_elec = fcidump->n_elec();
+    shared_ptr<DistinctRowTable<SU2>> drt = make_shared<DistinctRowTable<SU2>>(
+        (int16_t)(n_elec / 2), 0, (int16_t)(n - n_elec / 2), 0, orbsym);
+    drt->initialize();
+    GUGADirectCI<double> ci(drt);
+    ci.initialize();
+    ci.set_integrals(fcidump);
+    MatrixRef c(nullptr, (MKL_INT)ci.n_csf, 1);
+    c.allocate();
+    c.clear();
+    vector<MatrixRef> cs = {c};
+    vector<double> eners = ci.davidson(cs, 1E-10);
+    EXPECT_LT(abs(eners[0] - (-107.654122447525)), 1E-8);
+    // energy from spin-free reduced density matrices
+    vector<double> dm1 = ci.make_rdm1(c, c), dm2 = ci.make_rdm2(c, c);
+    double ener = fcidump->e();
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++) {
+            ener += fcidump->t(i, j) * dm1[i * n + j];
+            for (int k = 0; k < n; k++)
+                for (int l = 0; l < n; l++)
+                    ener += 0.5 * fcidump->v(i, j, k, l) *
+                            dm2[((i * n + j) * n + k) * n + l];
+        }
+    EXPECT_LT(abs(ener - eners[0]), 1E-8);
+    double tr = 0;
+    for (int i = 0; i < n; i++)
+        tr += dm1[i * n + i];
+    EXPECT_LT(abs(tr - n_elec), 1E-10);
+    c.deallocate();
+}
+
+TEST_F(TestGUGADirectCI, TestN2STO3GMRCI) {
+    shared_ptr<FCIDUMP<double>> fcidump = make_shared<FCIDUMP<double>>();
+    fcidump->read("data/N2.STO3G.FCIDUMP");
+    const int n = fcidump->n_sites(), n_elec = fcidump->n_elec();
+    const int16_t a = (int16_t)(n_elec / 2), c = (int16_t)(n - a);
+    shared_ptr<DistinctRowTable<void>> fdrt =
+        make_shared<DistinctRowTable<void>>(a, 0, c);
+    fdrt->initialize();
+    GUGADirectCI<double> fci(fdrt);
+    fci.initialize();
+    fci.set_integrals(fcidump);
+    EXPECT_TRUE(fci.same_space());
+    vector<uint8_t> ref(n, 0);
+    for (int i = 0; i < a; i++)
+        ref[i] = 3;
+    Random::rand_seed(1234);
+    for (int ci_order = 1; ci_order <= 2; ci_order++) {
+        shared_ptr<MRCIDistinctRowTable<void>> drt =
+            make_shared<MRCIDistinctRowTable<void>>(a, 0, c);
+        drt->initialize_mrci(ci_order, vector<vector<uint8_t>>{ref});
+        GUGADirectCI<double> ci(drt);
+        ci.initialize();
+        ci.set_integrals(fcidump);
+        // intermediates restricted to single excitations of the MRCI space
+        EXPECT_LT(ci.n_csf, ci.n_ri);
+        EXPECT_LT(ci.n_ri, fci.n_ri);
+        const int nc = (int)ci.n_csf, nf = (int)fci.n_csf;
+        vector<long long> mp(nc);
+        for (int i = 0; i < nc; i++)
+            mp[i] = fdrt->index_of_step_vector(drt->step_vector_of_index(i));
+        // H in the MRCI space is the projection of the FCI hamiltonian
+        MatrixRef x(nullptr, nc, 1), s(nullptr, nc, 1);
+        MatrixRef fx(nullptr, nf, 1), fs(nullptr, nf, 1);
+        x.allocate(), s.allocate(), fx.allocate(), fs.allocate();
+        for (int it = 0; it < 3; it++) {
+            Random::fill<double>(x.data, nc, -1.0, 1.0);
+            s.clear(), fx.clear(), fs.clear();
+            for (int i = 0; i < nc; i++)
+                fx.data[mp[i]] = x.data[i];
+            ci(x, s);
+            fci(fx, fs);
+            for (int i = 0; i < nc; i++)
+                EXPECT_LT(abs(s.data[i] - fs.data[mp[i]]), 1E-10);
+        }
+        DiagonalMatrix aa(nullptr, nc), faa(nullptr, nf);
+        aa.allocate(), faa.allocate();
+        ci.diag(aa), fci.diag(faa);
+        for (int i = 0; i < nc; i++)
+            EXPECT_LT(abs(aa.data[i] - faa.data[mp[i]]), 1E-10);
+        faa.deallocate(), aa.deallocate();
+        fs.deallocate(), fx.deallocate(), s.deallocate(), x.deallocate();
+    }
+}
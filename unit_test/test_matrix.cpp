@@ -816,6 +816,102 @@ TYPED_TEST(TestMatrix, TestDavidson) {
     }
 }
 
+TYPED_TEST(TestMatrix, TestShiftDavidson) {
+    using FL = TypeParam;
+    const int sz = is_same<FL, double>::value ? 200 : 120;
+    const FL conv = is_same<FL, double>::value ? 1E-12 : 1E-8;
+    const FL thrd = is_same<FL, double>::value ? 1E-6 : 5E-3;
+    const FL thrd2 = is_same<FL, double>::value ? 1E-3 : 1E-1;
+    const FL g_factor = 0.5;
+    using MatMul = typename TestMatrix<FL>::MatMul;
+    int ndav_shift = 0, ndav_restart = 0;
+    for (int i = 0; i < this->n_tests; i++) {
+        MKL_INT n = Random::rand_int(2, sz);
+        MKL_INT nref = Random::rand_int(1, n);
+        GMatrix<FL> a(dalloc_<FL>()->allocate(n * n), n, n);
+        GMatrix<FL> b(dalloc_<FL>()->allocate(n * n), n, n);
+        GMatrix<FL> c(dalloc_<FL>()->allocate(n * n), n, n);
+        GDiagonalMatrix<FL> aa(dalloc_<FL>()->allocate(n), n);
+        GDiagonalMatrix<FL> ab(dalloc_<FL>()->allocate(n), n);
+        GDiagonalMatrix<FL> ww(dalloc_<FL>()->allocate(n), n);
+        GMatrix<FL> v(dalloc_<FL>()->allocate(n), n, 1);
+        Random::fill<FL>(a.data, a.size());
+        b.clear();
+        for (MKL_INT ki = 0; ki < n; ki++) {
+            for (MKL_INT kj = 0; kj < ki; kj++)
+                a(kj, ki) = a(ki, kj) = (FL)0.1 * a(ki, kj);
+            a(ki, ki) = (FL)0.1 * a(ki, ki) + (FL)ki / n;
+            // projector onto the non-reference space
+            b(ki, ki) = ki >= nref;
+            aa(ki, ki) = a(ki, ki), ab(ki, ki) = b(ki, ki);
+        }
+        // self-consistent shift (1 - g) * (E - E0) as in AQCC
+        const FL e0 = a(0, 0);
+        MatMul mopa(a), mopb(b);
+        v.clear();
+        v.data[0] = 1;
+        FL shift = 0;
+        int nupd = 0, ndav = 0;
+        auto shift_update = [&](FL ener, int, FL &xshift) {
+            const FL new_shift = (1 - g_factor) * (ener - e0);
+            const bool done = abs(new_shift - xshift) < thrd * 1E-2;
+            xshift = new_shift, nupd++;
+            return done || nupd == 50;
+        };
+        FL ener = IterativeMatrixFunctions<FL>::shift_davidson(
+            mopa, mopb, aa, ab, v, shift, shift_update, ndav, false,
+            (shared_ptr<ParallelCommunicator<SZ>>)nullptr, conv, 0.0,
+            n * 10, -1, 2, 50);
+        ASSERT_LT(nupd, 50);
+        ndav_shift += ndav;
+        // the same with restarted davidson for each shift
+        GMatrix<FL> sa(dalloc_<FL>()->allocate(n * n), n, n);
+        FL rshift = 0;
+        vector<GMatrix<FL>> bs(1, GMatrix<FL>(nullptr, n, 1));
+        bs[0].allocate();
+        bs[0].clear();
+        bs[0].data[0] = 1;
+        for (int it = 0; it < 50; it++) {
+            GMatrixFunctions<FL>::copy(sa, a);
+            GMatrixFunctions<FL>::iadd(sa, b, rshift);
+            for (MKL_INT ki = 0; ki < n; ki++)
+                ww(ki, ki) = sa(ki, ki);
+            MatMul mops(sa);
+            int xndav = 0;
+            FL rener = IterativeMatrixFunctions<FL>::davidson(
+                mops, ww, bs, 0, DavidsonTypes::Normal, xndav, false,
+                (shared_ptr<ParallelCommunicator<SZ>>)nullptr, conv, 0.0,
+                n * 10, -1, 2, 50)[0];
+            ndav_restart += xndav;
+            if (shift_update(rener, 0, rshift))
+                break;
+        }
+        bs[0].deallocate();
+        sa.deallocate();
+        // eigenvalue of the final shifted matrix
+        GMatrixFunctions<FL>::copy(c, a);
+        GMatrixFunctions<FL>::iadd(c, b, shift);
+        GMatrixFunctions<FL>::eigs(c, ww);
+        ASSERT_LT(abs(ener - ww(0, 0)), thrd);
+        ASSERT_LT(abs((1 - g_factor) * (ener - e0) - shift), thrd);
+        ASSERT_TRUE(
+            GMatrixFunctions<FL>::all_close(v, GMatrix<FL>(c.data, n, 1),
+                                            thrd2, thrd2) ||
+            GMatrixFunctions<FL>::all_close(v, GMatrix<FL>(c.data, n, 1),
+                                            thrd2, thrd2, -1.0));
+        v.deallocate();
+        ww.deallocate();
+        ab.deallocate();
+        aa.deallocate();
+        c.deallocate();
+        b.deallocate();
+        a.deallocate();
+    }
+    cout << "ndav shift = " << ndav_shift << " restart = " << ndav_restart
+         << endl;
+    EXPECT_LT(ndav_shift, ndav_restart);
+}
+
 TYPED_TEST(TestMatrix, TestLinear) {
     using FL = TypeParam;
     const int sz = is_same<FL, double>::value ? 200 : 75;
@@ -1005,7 +1101,10 @@ TYPED_TEST(TestMatrix, TestEigs) {
         for (MKL_INT ki = 0; ki < m; ki++)
             for (MKL_INT kj = 0; kj <= ki; kj++)
                 ap(ki, kj) = ap(kj, ki) = a(ki, kj);
-        GMatrixFunctions<FL>::eigs(a, w);
+        if (Random::rand_int(0, 2))
+            GMatrixFunctions<FL>::eigs_dc(a, w);
+        else
+            GMatrixFunctions<FL>::eigs(a, w);
         GMatrixFunctions<FL>::multiply(a, false, ap, true, ag, 1.0, 0.0);
         for (MKL_INT k = 0; k < m; k++)
             for (MKL_INT j = 0; j < m; j++)
@@ -1343,9 +1442,13 @@ TYPED_TEST(TestMatrix, TestSVD) {
             make_shared<GTensor<FL>>(vector<MKL_INT>{n, n});
         Random::fill<FL>(a->data->data(), a->size());
         GMatrixFunctions<FL>::copy(aa->ref(), a->ref());
-        if (Random::rand_int(0, 2))
+        const int svd_type = Random::rand_int(0, 3);
+        if (svd_type == 0)
             GMatrixFunctions<FL>::accurate_svd(
                 a->ref(), l->ref(), s->ref().flip_dims(), r->ref(), 1E-1);
+        else if (svd_type == 1)
+            GMatrixFunctions<FL>::svd_dc(a->ref(), l->ref(),
+                                         s->ref().flip_dims(), r->ref());
         else
             GMatrixFunctions<FL>::svd(a->ref(), l->ref(), s->ref().flip_dims(),
                                       r->ref());
@@ -1450,6 +1553,62 @@ TYPED_TEST(TestMatrix, TestDisjointSVD) {
     }
 }
 
+TYPED_TEST(TestMatrix, TestParallelDecompose) {
+    using FL = TypeParam;
+    const int sz = is_same<FL, double>::value ? 200 : 75;
+    const FL thrd = is_same<FL, double>::value ? 1E-11 : 1E-3;
+    const size_t large_dim = threading->decomp_large_dim;
+    threading->decomp_large_dim = sz / 4;
+    for (int i = 0; i < this->n_tests / 10; i++) {
+        int nb = Random::rand_int(1, 12);
+        vector<pair<size_t, size_t>> dims(nb);
+        vector<shared_ptr<GTensor<FL>>> a(nb), aa(nb), l(nb), s(nb), r(nb);
+        for (int ib = 0; ib < nb; ib++) {
+            MKL_INT m = Random::rand_int(1, sz), n = Random::rand_int(1, sz);
+            MKL_INT k = min(m, n);
+            dims[ib] = make_pair((size_t)m, (size_t)n);
+            a[ib] = make_shared<GTensor<FL>>(vector<MKL_INT>{m, n});
+            aa[ib] = make_shared<GTensor<FL>>(vector<MKL_INT>{m, n});
+            l[ib] = make_shared<GTensor<FL>>(vector<MKL_INT>{m, k});
+            s[ib] = make_shared<GTensor<FL>>(vector<MKL_INT>{k});
+            r[ib] = make_shared<GTensor<FL>>(vector<MKL_INT>{k, n});
+            Random::fill<FL>(a[ib]->data->data(), a[ib]->size());
+            GMatrixFunctions<FL>::copy(aa[ib]->ref(), a[ib]->ref());
+        }
+        const size_t nl = threading->n_decomp_large,
+                     ns = threading->n_decomp_small;
+        vector<int> visited(nb, 0);
+        threading->parallel_decompose(dims, [&](int ib, bool large) {
+            visited[ib]++;
+            if (large)
+                GMatrixFunctions<FL>::svd_dc(a[ib]->ref(), l[ib]->ref(),
+                                             s[ib]->ref().flip_dims(),
+                                             r[ib]->ref());
+            else
+                GMatrixFunctions<FL>::svd(a[ib]->ref(), l[ib]->ref(),
+                                          s[ib]->ref().flip_dims(),
+                                          r[ib]->ref());
+        });
+        threading->activate_normal();
+        EXPECT_EQ(threading->n_decomp_large - nl +
+                      threading->n_decomp_small - ns,
+                  (size_t)nb);
+        for (int ib = 0; ib < nb; ib++) {
+            ASSERT_EQ(visited[ib], 1);
+            MKL_INT k = l[ib]->shape[1], n = r[ib]->shape[1];
+            GMatrix<FL> x(r[ib]->data->data(), 1, n);
+            for (MKL_INT j = 0; j < k; j++)
+                GMatrixFunctions<FL>::iscale(x.shift_ptr(j * n),
+                                             (*s[ib])({j}));
+            GMatrixFunctions<FL>::multiply(l[ib]->ref(), false, r[ib]->ref(),
+                                           false, a[ib]->ref(), 1.0, 0.0);
+            ASSERT_TRUE(GMatrixFunctions<FL>::all_close(
+                aa[ib]->ref(), a[ib]->ref(), thrd, thrd));
+        }
+    }
+    threading->decomp_large_dim = large_dim;
+}
+
 TYPED_TEST(TestMatrix, TestQR) {
     using FL = TypeParam;
     const int sz = is_same<FL, double>::value ? 200 : 120;
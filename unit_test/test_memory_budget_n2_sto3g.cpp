@@ -0,0 +1,123 @@
+
+#include "block2_core.hpp"
+#include "block2_dmrg.hpp"
+#include <gtest/gtest.h>
+
+using namespace block2;
+
+class TestMemoryBudgetN2STO3G : public ::testing::Test {
+  protected:
+    size_t isize = 1LL << 24;
+    size_t dsize = 1LL << 30;
+    void SetUp() override {
+        Random::rand_seed(0);
+        frame_<double>() =
+            make_shared<DataFrame<double>>(isize, dsize, "nodex");
+        frame_<double>()->use_main_stack = false;
+        frame_<double>()->minimal_disk_usage = true;
+        threading_() = make_shared<Threading>(
+            ThreadingTypes::OperatorBatchedGEMM | ThreadingTypes::Global, 2, 2,
+            1);
+        threading_()->seq_type = SeqTypes::Tasked;
+    }
+    void TearDown() override {
+        frame_<double>()->activate(0);
+        assert(ialloc_()->used == 0 && dalloc_<double>()->used == 0);
+        frame_<double>() = nullptr;
+    }
+    shared_ptr<MemoryBudget<SU2, double, double>>
+    run_dmrg(const shared_ptr<HamiltonianQC<SU2, double>> &hamil,
+             size_t max_memory, double &energy) {
+        shared_ptr<MPO<SU2, double>> mpo = make_shared<MPOQC<SU2, double>>(
+            hamil, QCTypes::Conventional, "HQC");
+        mpo->basis = hamil->basis;
+        mpo = make_shared<SimplifiedMPO<SU2, double>>(
+            mpo, make_shared<RuleQC<SU2, double>>(), true, true,
+            OpNamesSet({OpNames::R, OpNames::RD}));
+        SU2 target(hamil->fcidump->n_elec(), 0, 0);
+        shared_ptr<MPSInfo<SU2>> mps_info = make_shared<MPSInfo<SU2>>(
+            mpo->n_sites, hamil->vacuum, target, mpo->basis);
+        mps_info->set_bond_dimension(200);
+        Random::rand_seed(0);
+        shared_ptr<MPS<SU2, double>> mps =
+            make_shared<MPS<SU2, double>>(mpo->n_sites, 0, 2);
+        mps->initialize(mps_info);
+        mps->random_canonicalize();
+        mps->save_mutable();
+        mps->deallocate();
+        mps_info->save_mutable();
+        mps_info->deallocate_mutable();
+        shared_ptr<MovingEnvironment<SU2, double, double>> me =
+            make_shared<MovingEnvironment<SU2, double, double>>(mpo, mps, mps,
+                                                                "DMRG");
+        me->init_environments(false);
+        me->delayed_contraction = OpNamesSet::normal_ops();
+        shared_ptr<DMRG<SU2, double, double>> dmrg =
+            make_shared<DMRG<SU2, double, double>>(
+                me, vector<ubond_t>{200}, vector<double>{1E-8, 1E-9, 0.0});
+        dmrg->iprint = 0;
+        dmrg->mem_budget =
+            make_shared<MemoryBudget<SU2, double, double>>(max_memory);
+        dmrg->mem_budget->iprint = 0;
+        energy = (double)dmrg->solve(10, mps->center == 0, 1E-8);
+        mps_info->deallocate();
+        me->remove_partition_files();
+        mpo->deallocate();
+        return dmrg->mem_budget;
+    }
+};
+
+TEST_F(TestMemoryBudgetN2STO3G, TestSU2) {
+    shared_ptr<FCIDUMP<double>> fcidump = make_shared<FCIDUMP<double>>();
+    PGTypes pg = PGTypes::D2H;
+    fcidump->read("data/N2.STO3G.FCIDUMP");
+    vector<uint8_t> orbsym = fcidump->template orb_sym<uint8_t>();
+    transform(orbsym.begin(), orbsym.end(), orbsym.begin(),
+              [pg](uint8_t x) { return (uint8_t)PointGroup::swap_pg(pg)(x); });
+    shared_ptr<HamiltonianQC<SU2, double>> hamil =
+        make_shared<HamiltonianQC<SU2, double>>(SU2(0), fcidump->n_sites(),
+                                                orbsym, fcidump);
+    const double ener_ref = -107.654122447525;
+    double energy;
+
+    // unlimited memory: fastest mode after the first measured site
+    shared_ptr<MemoryBudget<SU2, double, double>> mb =
+        run_dmrg(hamil, numeric_limits<size_t>::max(), energy);
+    EXPECT_LT(abs(energy - ener_ref), 1E-7);
+    ASSERT_GT(mb->decisions.size(), (size_t)1);
+    EXPECT_EQ(mb->decisions[0].mode, MemoryModeTypes::FusedRotation);
+    size_t max_obs = 0;
+    for (size_t k = 1; k < mb->decisions.size(); k++) {
+        const MemoryBudgetDecision &d = mb->decisions[k];
+        EXPECT_EQ(d.mode, MemoryModeTypes::Cached);
+        // eff ham, cached block and buffers are not in the stacks
+        EXPECT_GT(d.heap, (size_t)0);
+        EXPECT_LT(d.heap, d.observed);
+        max_obs = max(max_obs, d.observed);
+    }
+    // a site measured in the same mode is estimated by its measurement
+    map<pair<int, bool>, size_t> prev_obs;
+    for (size_t k = 1; k < mb->decisions.size(); k++) {
+        const MemoryBudgetDecision &d = mb->decisions[k];
+        const pair<int, bool> key = make_pair(d.site, d.forward);
+        if (prev_obs.count(key))
+            EXPECT_EQ(d.estimated, prev_obs[key]);
+        prev_obs[key] = d.observed;
+    }
+
+    // no memory: most memory-saving mode everywhere
+    mb = run_dmrg(hamil, 0, energy);
+    EXPECT_LT(abs(energy - ener_ref), 1E-7);
+    for (auto &d : mb->decisions)
+        EXPECT_EQ(d.mode, MemoryModeTypes::FusedRotation);
+
+    // intermediate ceiling: modes are mixed, but the result is unchanged
+    mb = run_dmrg(hamil, max_obs / 2, energy);
+    EXPECT_LT(abs(energy - ener_ref), 1E-7);
+    for (size_t k = 1; k < mb->decisions.size(); k++)
+        if (mb->decisions[k].mode != MemoryModeTypes::FusedRotation)
+            EXPECT_LE(mb->decisions[k].estimated, max_obs / 2);
+
+    hamil->deallocate();
+    fcidump->deallocate();
+}
@@ -0,0 +1,144 @@
+
+#include "block2_core.hpp"
+#include "block2_dmrg.hpp"
+#include <gtest/gtest.h>
+
+using namespace block2;
+
+class TestMPORefreshN2STO3G : public ::testing::Test {
+  protected:
+    size_t isize = 1LL << 24;
+    size_t dsize = 1LL << 30;
+    void SetUp() override {
+        Random::rand_seed(0);
+        frame_<double>() =
+            make_shared<DataFrame<double>>(isize, dsize, "nodex");
+        frame_<double>()->use_main_stack = false;
+        frame_<double>()->minimal_disk_usage = true;
+        threading_() = make_shared<Threading>(
+            ThreadingTypes::OperatorBatchedGEMM | ThreadingTypes::Global, 2, 2,
+            1);
+        threading_()->seq_type = SeqTypes::Tasked;
+    }
+    void TearDown() override {
+        frame_<double>()->activate(0);
+        assert(ialloc_()->used == 0 && dalloc_<double>()->used == 0);
+        frame_<double>() = nullptr;
+    }
+    shared_ptr<MPO<SU2, double>>
+    get_mpo(const shared_ptr<HamiltonianQC<SU2, double>> &hamil) {
+        shared_ptr<MPO<SU2, double>> mpo = make_shared<MPOQC<SU2, double>>(
+            hamil, QCTypes::Conventional, "HQC");
+        mpo->basis = hamil->basis;
+        return make_shared<SimplifiedMPO<SU2, double>>(
+            mpo, make_shared<RuleQC<SU2, double>>(), true, true,
+            OpNamesSet({OpNames::R, OpNames::RD}));
+    }
+    double run_dmrg(const shared_ptr<HamiltonianQC<SU2, double>> &hamil,
+                    const shared_ptr<MPO<SU2, double>> &mpo) {
+        SU2 target(hamil->fcidump->n_elec(), 0, 0);
+        shared_ptr<MPSInfo<SU2>> mps_info = make_shared<MPSInfo<SU2>>(
+            mpo->n_sites, hamil->vacuum, target, mpo->basis);
+        mps_info->set_bond_dimension(200);
+        Random::rand_seed(0);
+        shared_ptr<MPS<SU2, double>> mps =
+            make_shared<MPS<SU2, double>>(mpo->n_sites, 0, 2);
+        mps->initialize(mps_info);
+        mps->random_canonicalize();
+        mps->save_mutable();
+        mps->deallocate();
+        mps_info->save_mutable();
+        mps_info->deallocate_mutable();
+        shared_ptr<MovingEnvironment<SU2, double, double>> me =
+            make_shared<MovingEnvironment<SU2, double, double>>(mpo, mps, mps,
+                                                                "DMRG");
+        me->init_environments(false);
+        me->delayed_contraction = OpNamesSet::normal_ops();
+        shared_ptr<DMRG<SU2, double, double>> dmrg =
+            make_shared<DMRG<SU2, double, double>>(
+                me, vector<ubond_t>{200}, vector<double>{1E-8, 1E-9, 0.0});
+        dmrg->iprint = 0;
+        double energy = (double)dmrg->solve(10, true, 1E-8);
+        mps_info->deallocate();
+        me->remove_partition_files();
+        return energy;
+    }
+    // site operators of the refreshed MPO and of the freshly built MPO
+    static void check_same(const shared_ptr<MPO<SU2, double>> &a,
+                           const shared_ptr<MPO<SU2, double>> &b) {
+        EXPECT_LT(abs(a->const_e - b->const_e), 1E-12);
+        ASSERT_EQ(a->n_sites, b->n_sites);
+        for (int m = 0; m < a->n_sites; m++) {
+            ASSERT_EQ(a->tensors[m]->ops.size(), b->tensors[m]->ops.size());
+            for (auto &op : a->tensors[m]->ops) {
+                ASSERT_TRUE(b->tensors[m]->ops.count(op.first));
+                shared_ptr<SparseMatrix<SU2, double>> x = op.second,
+                                                      y = b->tensors[m]
+                                                              ->ops.at(op.first);
+                ASSERT_EQ(x->total_memory, y->total_memory);
+                for (size_t i = 0; i < x->total_memory; i++)
+                    EXPECT_NEAR(x->factor * x->data[i], y->factor * y->data[i],
+                                1E-12);
+            }
+        }
+    }
+};
+
+TEST_F(TestMPORefreshN2STO3G, TestSU2) {
+    shared_ptr<FCIDUMP<double>> fcidump = make_shared<FCIDUMP<double>>();
+    PGTypes pg = PGTypes::D2H;
+    fcidump->read("data/N2.STO3G.FCIDUMP");
+    vector<uint8_t> orbsym = fcidump->template orb_sym<uint8_t>();
+    transform(orbsym.begin(), orbsym.end(), orbsym.begin(),
+              [pg](uint8_t x) { return (uint8_t)PointGroup::swap_pg(pg)(x); });
+    const uint16_t n = fcidump->n_sites();
+    typedef MPOQCOneBodyRefresh<SU2, double> XRefresh;
+
+    shared_ptr<HamiltonianQC<SU2, double>> hamil =
+        make_shared<HamiltonianQC<SU2, double>>(SU2(0), n, orbsym, fcidump);
+    shared_ptr<MPO<SU2, double>> mpo = get_mpo(hamil);
+
+    // one-electron field keeping the point group symmetry
+    shared_ptr<FCIDUMP<double>> fd_field = fcidump->deep_copy();
+    for (uint16_t i = 0; i < n; i++) {
+        fd_field->ts[0](i, i) += 0.05 * (i + 1);
+        for (uint16_t j = 0; j < i; j++)
+            fd_field->ts[0](i, j) *= 1.2;
+    }
+    fd_field->const_e += 0.5;
+    EXPECT_EQ(XRefresh::check(hamil, fd_field), "");
+    XRefresh::refresh(mpo, fd_field);
+    EXPECT_EQ(hamil->fcidump, fd_field);
+
+    shared_ptr<HamiltonianQC<SU2, double>> hamil_ref =
+        make_shared<HamiltonianQC<SU2, double>>(SU2(0), n, orbsym, fd_field);
+    shared_ptr<MPO<SU2, double>> mpo_ref = get_mpo(hamil_ref);
+    check_same(mpo, mpo_ref);
+    const double ener_ref = run_dmrg(hamil_ref, mpo_ref);
+    EXPECT_LT(abs(run_dmrg(hamil, mpo) - ener_ref), 1E-8);
+    mpo_ref->deallocate();
+    hamil_ref->deallocate();
+
+    // changes in the two-electron integrals require a rebuild
+    shared_ptr<FCIDUMP<double>> fd_two = fd_field->deep_copy();
+    fd_two->vs[0](0, 0, 0, 0) += 0.1;
+    EXPECT_NE(XRefresh::check(hamil, fd_two), "");
+    EXPECT_THROW(XRefresh::refresh(mpo, fd_two), runtime_error);
+    // one-electron integrals screened out in the MPO require a rebuild
+    ASSERT_EQ(orbsym[0], orbsym[1]);
+    shared_ptr<FCIDUMP<double>> fd_zero = fd_field->deep_copy();
+    fd_zero->ts[0](1, 0) = 0.0;
+    fd_zero->vs[0](1, 0, 0, 0) = fd_zero->vs[0](0, 1, 1, 1) = 0.0;
+    shared_ptr<HamiltonianQC<SU2, double>> hamil_zero =
+        make_shared<HamiltonianQC<SU2, double>>(SU2(0), n, orbsym, fd_zero);
+    shared_ptr<FCIDUMP<double>> fd_screened = fd_zero->deep_copy();
+    EXPECT_EQ(XRefresh::check(hamil_zero, fd_screened), "");
+    fd_screened->ts[0](1, 0) = 0.01;
+    EXPECT_NE(XRefresh::check(hamil_zero, fd_screened), "");
+    hamil_zero->deallocate();
+    EXPECT_EQ(hamil->fcidump, fd_field);
+
+    mpo->deallocate();
+    hamil->deallocate();
+    fcidump->deallocate();
+}
@@ -0,0 +1,164 @@
+
+#include "block2_core.hpp"
+#include "block2_dmrg.hpp"
+#include <gtest/gtest.h>
+
+using namespace block2;
+
+class TestOperatorTensorION2STO3G : public ::testing::Test {
+  protected:
+    size_t isize = 1LL << 24;
+    size_t dsize = 1LL << 30;
+    void SetUp() override {
+        Random::rand_seed(0);
+        frame_<double>() =
+            make_shared<DataFrame<double>>(isize, dsize, "nodex");
+        frame_<double>()->use_main_stack = false;
+        frame_<double>()->minimal_disk_usage = true;
+        threading_() = make_shared<Threading>(
+            ThreadingTypes::OperatorBatchedGEMM | ThreadingTypes::Global, 2, 2,
+            1);
+        threading_()->seq_type = SeqTypes::Tasked;
+    }
+    void TearDown() override {
+        frame_<double>()->activate(0);
+        assert(ialloc_()->used == 0 && dalloc_<double>()->used == 0);
+        frame_<double>() = nullptr;
+    }
+    shared_ptr<MPO<SU2, double>>
+    reload_mpo(const shared_ptr<MPO<SU2, double>> &mpo, bool compact,
+               size_t &nbytes, AlignTypes load_align = AlignTypes::None) {
+        frame_<double>()->compact_operator_storage = compact;
+        stringstream ss;
+        mpo->save_data(ss);
+        nbytes = ss.str().length();
+        threading_()->align_type = load_align;
+        shared_ptr<MPO<SU2, double>> rmpo =
+            make_shared<MPO<SU2, double>>(0, mpo->tag);
+        rmpo->load_data(ss);
+        threading_()->align_type = AlignTypes::None;
+        return rmpo;
+    }
+    // number of distinct SparseMatrixInfo objects among all operators
+    static size_t n_infos(const shared_ptr<MPO<SU2, double>> &mpo) {
+        size_t r = 0;
+        for (auto &tensor : mpo->tensors) {
+            set<SparseMatrixInfo<SU2> *> infos;
+            for (auto &op : tensor->ops)
+                infos.insert(op.second->info.get());
+            r += infos.size();
+        }
+        return r;
+    }
+    static void check_same(const shared_ptr<MPO<SU2, double>> &a,
+                           const shared_ptr<MPO<SU2, double>> &b) {
+        ASSERT_EQ(a->n_sites, b->n_sites);
+        for (int m = 0; m < a->n_sites; m++) {
+            ASSERT_EQ(a->tensors[m]->ops.size(), b->tensors[m]->ops.size());
+            for (auto &op : a->tensors[m]->ops) {
+                ASSERT_TRUE(b->tensors[m]->ops.count(op.first));
+                shared_ptr<SparseMatrix<SU2, double>> x = op.second,
+                                                      y = b->tensors[m]
+                                                              ->ops.at(op.first);
+                EXPECT_EQ(x->factor, y->factor);
+                ASSERT_EQ(x->total_memory, y->total_memory);
+                ASSERT_EQ(x->info->n, y->info->n);
+                EXPECT_EQ(x->info->delta_quantum, y->info->delta_quantum);
+                for (int i = 0; i < x->info->n; i++)
+                    EXPECT_EQ(x->info->quanta[i], y->info->quanta[i]);
+                for (size_t i = 0; i < x->total_memory; i++)
+                    EXPECT_EQ(x->data[i], y->data[i]);
+                if (x->total_memory != 0 &&
+                    threading_()->align_type != AlignTypes::None)
+                    EXPECT_EQ((uintptr_t)y->data %
+                                  (uint8_t)threading_()->align_type,
+                              (uintptr_t)0);
+            }
+        }
+    }
+};
+
+TEST_F(TestOperatorTensorION2STO3G, TestSU2) {
+    shared_ptr<FCIDUMP<double>> fcidump = make_shared<FCIDUMP<double>>();
+    PGTypes pg = PGTypes::D2H;
+    fcidump->read("data/N2.STO3G.FCIDUMP");
+    vector<uint8_t> orbsym = fcidump->template orb_sym<uint8_t>();
+    transform(orbsym.begin(), orbsym.end(), orbsym.begin(),
+              [pg](uint8_t x) { return (uint8_t)PointGroup::swap_pg(pg)(x); });
+    const double ener_ref = -107.654122447525;
+
+    shared_ptr<HamiltonianQC<SU2, double>> hamil =
+        make_shared<HamiltonianQC<SU2, double>>(SU2(0), fcidump->n_sites(),
+                                                orbsym, fcidump);
+    shared_ptr<MPO<SU2, double>> mpo = make_shared<MPOQC<SU2, double>>(
+        hamil, QCTypes::Conventional, "HQC");
+    mpo->basis = hamil->basis;
+    mpo = make_shared<SimplifiedMPO<SU2, double>>(
+        mpo, make_shared<RuleQC<SU2, double>>(), true, true,
+        OpNamesSet({OpNames::R, OpNames::RD}));
+
+    size_t nb_full, nb_compact;
+    shared_ptr<MPO<SU2, double>> mpo_full = reload_mpo(mpo, false, nb_full);
+    shared_ptr<MPO<SU2, double>> mpo_compact =
+        reload_mpo(mpo, true, nb_compact);
+    check_same(mpo, mpo_full);
+    check_same(mpo, mpo_compact);
+    // slab saved without alignment and loaded with alignment
+    size_t nb_aligned;
+    shared_ptr<MPO<SU2, double>> mpo_aligned =
+        reload_mpo(mpo, true, nb_aligned, AlignTypes::Aligned64B);
+    threading_()->align_type = AlignTypes::Aligned64B;
+    check_same(mpo, mpo_aligned);
+    threading_()->align_type = AlignTypes::None;
+    // operators loaded into a slab can still grow
+    for (auto &op : mpo_aligned->tensors[0]->ops) {
+        shared_ptr<SparseMatrix<SU2, double>> x = op.second;
+        const size_t n = x->total_memory;
+        if (n == 0)
+            continue;
+        vector<double> ref(x->data, x->data + n);
+        x->reallocate(n + 7);
+        for (size_t i = 0; i < n; i++)
+            EXPECT_EQ(x->data[i], ref[i]);
+        x->reallocate(n);
+    }
+    mpo_aligned->deallocate();
+    // infos are shared among operators of the same quantum number
+    EXPECT_EQ(n_infos(mpo_compact), n_infos(mpo));
+    EXPECT_LT(n_infos(mpo_compact), n_infos(mpo_full));
+    EXPECT_LT(nb_compact, nb_full);
+    mpo->deallocate();
+
+    // environments (pointer only) are also saved in the compact layout
+    SU2 target(fcidump->n_elec(), 0, 0);
+    shared_ptr<MPSInfo<SU2>> mps_info = make_shared<MPSInfo<SU2>>(
+        mpo_compact->n_sites, hamil->vacuum, target, mpo_compact->basis);
+    mps_info->set_bond_dimension(200);
+    shared_ptr<MPS<SU2, double>> mps =
+        make_shared<MPS<SU2, double>>(mpo_compact->n_sites, 0, 2);
+    mps->initialize(mps_info);
+    mps->random_canonicalize();
+    mps->save_mutable();
+    mps->deallocate();
+    mps_info->save_mutable();
+    mps_info->deallocate_mutable();
+    shared_ptr<MovingEnvironment<SU2, double, double>> me =
+        make_shared<MovingEnvironment<SU2, double, double>>(mpo_compact, mps,
+                                                            mps, "DMRG");
+    me->init_environments(false);
+    me->delayed_contraction = OpNamesSet::normal_ops();
+    shared_ptr<DMRG<SU2, double, double>> dmrg =
+        make_shared<DMRG<SU2, double, double>>(
+            me, vector<ubond_t>{200}, vector<double>{1E-8, 1E-9, 0.0});
+    dmrg->iprint = 0;
+    double energy = (double)dmrg->solve(10, true, 1E-8);
+    EXPECT_LT(abs(energy - ener_ref), 1E-7);
+    mps_info->deallocate();
+    me->remove_partition_files();
+
+    mpo_compact->deallocate();
+    mpo_full->deallocate();
+    frame_<double>()->compact_operator_storage = false;
+    hamil->deallocate();
+    fcidump->deallocate();
+}
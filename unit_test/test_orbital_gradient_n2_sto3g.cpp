@@ -0,0 +1,267 @@
+#include "block2_core.hpp"
+#include "block2_dmrg.hpp"
+#include <gtest/gtest.h>
+
+using namespace block2;
+
+class TestOrbitalGradientN2STO3G : public ::testing::Test {
+  protected:
+    size_t isize = 1LL << 24;
+    size_t dsize = 1LL << 30;
+    typedef double FP;
+
+    template <typename S, typename FL>
+    void test_orbital_gradient(S target,
+                               const shared_ptr<HamiltonianQC<S, FL>> &hamil,
+                               const string &filename, const string &name);
+    void SetUp() override {
+        Random::rand_seed(0);
+        frame_<FP>() = make_shared<DataFrame<FP>>(isize, dsize, "nodex");
+        frame_<FP>()->minimal_disk_usage = true;
+        threading_() = make_shared<Threading>(
+            ThreadingTypes::OperatorBatchedGEMM | ThreadingTypes::Global, 2, 2,
+            2);
+        threading_()->seq_type = SeqTypes::Simple;
+        cout << *threading_() << endl;
+    }
+    void TearDown() override {
+        frame_<FP>()->activate(0);
+        assert(ialloc_()->used == 0 && dalloc_<FP>()->used == 0);
+        frame_<FP>() = nullptr;
+    }
+};
+
+template <typename S, typename FL>
+void TestOrbitalGradientN2STO3G::test_orbital_gradient(
+    S target, const shared_ptr<HamiltonianQC<S, FL>> &hamil,
+    const string &filename, const string &name) {
+
+    const int n = hamil->n_sites;
+
+    // MPO construction
+    shared_ptr<MPO<S, FL>> mpo =
+        make_shared<MPOQC<S, FL>>(hamil, QCTypes::Conventional);
+    mpo = make_shared<SimplifiedMPO<S, FL>>(mpo, make_shared<RuleQC<S, FL>>(),
+                                            true);
+
+    // 1PDM and 2PDM MPO construction
+    shared_ptr<MPO<S, FL>> pmpo = make_shared<PDM1MPOQC<S, FL>>(hamil);
+    pmpo = make_shared<SimplifiedMPO<S, FL>>(
+        pmpo, make_shared<RuleQC<S, FL>>(), true, true,
+        OpNamesSet({OpNames::R, OpNames::RD}));
+    shared_ptr<MPO<S, FL>> p2mpo = make_shared<PDM2MPOQC<S, FL>>(hamil);
+    p2mpo = make_shared<SimplifiedMPO<S, FL>>(
+        p2mpo, make_shared<RuleQC<S, FL>>(), true, true,
+        OpNamesSet({OpNames::R, OpNames::RD}));
+
+    ubond_t bond_dim = 200;
+
+    shared_ptr<MPSInfo<S>> mps_info =
+        make_shared<MPSInfo<S>>(n, hamil->vacuum, target, hamil->basis);
+    mps_info->set_bond_dimension(bond_dim);
+
+    // MPS
+    Random::rand_seed(0);
+    shared_ptr<MPS<S, FL>> mps = make_shared<MPS<S, FL>>(n, 0, 2);
+    mps->initialize(mps_info);
+    mps->random_canonicalize();
+    mps->save_mutable();
+    mps->deallocate();
+    mps_info->save_mutable();
+    mps_info->deallocate_mutable();
+
+    // DMRG
+    shared_ptr<MovingEnvironment<S, FL, FL>> me =
+        make_shared<MovingEnvironment<S, FL, FL>>(mpo, mps, mps, "DMRG");
+    me->init_environments(false);
+    vector<ubond_t> bdims = {bond_dim};
+    vector<FP> noises = {1E-6, 0};
+    shared_ptr<DMRG<S, FL, FL>> dmrg =
+        make_shared<DMRG<S, FL, FL>>(me, bdims, noises);
+    dmrg->iprint = 0;
+    FL energy = dmrg->solve(10, mps->center == 0, 1E-12);
+
+    // 1PDM
+    shared_ptr<MovingEnvironment<S, FL, FL>> pme =
+        make_shared<MovingEnvironment<S, FL, FL>>(pmpo, mps, mps, "1PDM");
+    pme->init_environments(false);
+    shared_ptr<Expect<S, FL, FL>> expect =
+        make_shared<Expect<S, FL, FL>>(pme, bond_dim, bond_dim);
+    expect->solve(true, mps->center == 0);
+    GMatrix<FL> dm1 = expect->get_1pdm_spatial();
+
+    // 2PDM
+    shared_ptr<MovingEnvironment<S, FL, FL>> p2me =
+        make_shared<MovingEnvironment<S, FL, FL>>(p2mpo, mps, mps, "2PDM");
+    p2me->init_environments(false);
+    shared_ptr<Expect<S, FL, FL>> expect2 =
+        make_shared<Expect<S, FL, FL>>(p2me, bond_dim, bond_dim);
+    expect2->solve(true, mps->center == 0);
+    shared_ptr<GTensor<FL>> dm2 = expect2->get_2pdm_spatial();
+
+    vector<FL> kx(n * n, 0), ky(n * n, 0);
+    for (int p = 0; p < n; p++)
+        for (int q = 0; q < p; q++) {
+            kx[p * n + q] = Random::rand_double(-1, 1);
+            kx[q * n + p] = -kx[p * n + q];
+            ky[p * n + q] = Random::rand_double(-1, 1);
+            ky[q * n + p] = -ky[p * n + q];
+        }
+
+    // gradient and Hessian intermediate streamed from the 2PDM sweep
+    Timer t;
+    t.get_time();
+    shared_ptr<OrbitalGradientQC<S, FL>> og =
+        make_shared<OrbitalGradientQC<S, FL>>(hamil->fcidump);
+    og->hessian = true;
+    og->reset();
+    shared_ptr<Expect<S, FL, FL>> expect3 =
+        make_shared<Expect<S, FL, FL>>(p2me, bond_dim, bond_dim);
+    expect3->consumer = og;
+    expect3->iprint = 0;
+    expect3->solve(true, p2me->center == 0);
+    vector<FL> f = og->fock();
+    vector<FL> grad = og->gradient();
+    FL eog = og->energy();
+    double tog = t.get_time();
+    for (auto &x : expect3->expectations)
+        EXPECT_EQ(x.size(), 0);
+
+    cout << "== " << name << " ==" << setw(20) << target << " E = " << fixed
+         << setw(22) << setprecision(12) << energy << " E(GFOCK) = " << setw(22)
+         << eog << " T = " << fixed << setw(10) << setprecision(3) << tog
+         << endl;
+
+    EXPECT_LT(abs(eog - energy), 1E-7);
+
+    // reference from dense 1PDM and 2PDM
+    shared_ptr<FCIDUMP<FL>> fd = hamil->fcidump;
+    FP max_f_err = 0, max_g_err = 0;
+    for (int p = 0; p < n; p++)
+        for (int q = 0; q < n; q++) {
+            FL x = 0;
+            for (int r = 0; r < n; r++) {
+                x += fd->t(p, r) * dm1(q, r);
+                for (int s = 0; s < n; s++)
+                    for (int u = 0; u < n; u++)
+                        x += fd->v(p, r, s, u) * (*dm2)({q, s, u, r});
+            }
+            max_f_err = max(max_f_err, abs(x - f[p * n + q]));
+        }
+    for (int p = 0; p < n; p++)
+        for (int q = 0; q < n; q++)
+            max_g_err =
+                max(max_g_err, abs(grad[p * n + q] + grad[q * n + p]));
+    EXPECT_LT(max_f_err, 1E-6);
+    EXPECT_LT(max_g_err, 1E-12);
+
+    // energy functional with fixed PDMs under orbital rotation exp(kappa)
+    auto rotated_energy = [&](const vector<FL> &kappa, FP eps) -> FL {
+        const int ideg = 6;
+        vector<FL> k(n * n), work(4 * n * n + ideg + 1);
+        for (int i = 0; i < n * n; i++)
+            k[i] = eps * kappa[i];
+        pair<MKL_INT, MKL_INT> pp = IterativeMatrixFunctions<FL>::expo_pade(
+            ideg, n, k.data(), n, 1.0, work.data());
+        vector<FL> rot(work.begin() + pp.first,
+                       work.begin() + pp.first + n * n);
+        shared_ptr<FCIDUMP<FL>> fr = make_shared<FCIDUMP<FL>>();
+        fr->read(filename);
+        fr->rotate(rot);
+        OrbitalGradientQC<S, FL> ogr(fr);
+        ogr.accumulate(expect2->expectations);
+        FL e = ogr.energy();
+        fr->deallocate();
+        return e;
+    };
+
+    vector<FL> hx = og->hessian_vector(kx);
+    vector<FL> hy = og->hessian_vector(ky);
+    FL xg = 0, xhx = 0, xhy = 0, yhx = 0;
+    for (int p = 0; p < n; p++)
+        for (int q = 0; q < p; q++) {
+            xg += kx[p * n + q] * grad[p * n + q];
+            xhx += kx[p * n + q] * hx[p * n + q];
+            xhy += kx[p * n + q] * hy[p * n + q];
+            yhx += ky[p * n + q] * hx[p * n + q];
+        }
+    const FP eps = 1E-4;
+    FL ep = rotated_energy(kx, eps), em = rotated_energy(kx, -eps);
+    FL d1 = (ep - em) / (2 * eps), d2 = (ep + em - 2 * eog) / (eps * eps);
+    cout << "dE = " << setw(18) << setprecision(10) << xg << " (FD "
+         << setw(18) << d1 << ") d2E = " << setw(18) << xhx << " (FD "
+         << setw(18) << d2 << ")" << endl;
+
+    EXPECT_LT(abs(d1 - xg), 1E-5);
+    EXPECT_LT(abs(d2 - xhx), 1E-4 * max((FP)1.0, abs(xhx)));
+    EXPECT_LT(abs(xhy - yhx), 1E-8);
+
+    // one-dot sweep must give the same accumulated quantities
+    shared_ptr<OrbitalGradientQC<S, FL>> og1 =
+        make_shared<OrbitalGradientQC<S, FL>>(hamil->fcidump);
+    og1->hessian = true;
+    og1->reset();
+    p2me->dot = 1;
+    shared_ptr<Expect<S, FL, FL>> expect1 =
+        make_shared<Expect<S, FL, FL>>(p2me, bond_dim, bond_dim);
+    expect1->consumer = og1;
+    expect1->iprint = 0;
+    expect1->solve(true, p2me->center == 0);
+    vector<FL> f1 = og1->fock(), hx1 = og1->hessian_vector(kx);
+    FP max_f1_err = 0, max_h1_err = 0;
+    for (int k = 0; k < n * n; k++) {
+        max_f1_err = max(max_f1_err, abs(f1[k] - f[k]));
+        max_h1_err = max(max_h1_err, abs(hx1[k] - hx[k]));
+    }
+    EXPECT_LT(max_f1_err, 1E-6);
+    EXPECT_LT(max_h1_err, 1E-6);
+
+    dm2 = nullptr;
+    dm1.deallocate();
+    mps_info->deallocate();
+    p2mpo->deallocate();
+    pmpo->deallocate();
+    mpo->deallocate();
+}
+
+TEST_F(TestOrbitalGradientN2STO3G, TestSU2) {
+    shared_ptr<FCIDUMP<double>> fcidump = make_shared<FCIDUMP<double>>();
+    PGTypes pg = PGTypes::C1;
+    string filename = "data/N2.STO3G.FCIDUMP.C1";
+    fcidump->read(filename);
+    vector<uint8_t> orbsym = fcidump->orb_sym<uint8_t>();
+    transform(orbsym.begin(), orbsym.end(), orbsym.begin(),
+              [pg](uint8_t x) { return (uint8_t)PointGroup::swap_pg(pg)(x); });
+    SU2 vacuum(0);
+    SU2 target(fcidump->n_elec(), fcidump->twos(),
+               PointGroup::swap_pg(pg)(fcidump->isym()));
+    int norb = fcidump->n_sites();
+    shared_ptr<HamiltonianQC<SU2, double>> hamil =
+        make_shared<HamiltonianQC<SU2, double>>(vacuum, norb, orbsym, fcidump);
+
+    test_orbital_gradient<SU2, double>(target, hamil, filename, "SU2");
+
+    hamil->deallocate();
+    fcidump->deallocate();
+}
+
+TEST_F(TestOrbitalGradientN2STO3G, TestSZ) {
+    shared_ptr<FCIDUMP<double>> fcidump = make_shared<FCIDUMP<double>>();
+    PGTypes pg = PGTypes::C1;
+    string filename = "data/N2.STO3G.FCIDUMP.C1";
+    fcidump->read(filename);
+    vector<uint8_t> orbsym = fcidump->orb_sym<uint8_t>();
+    transform(orbsym.begin(), orbsym.end(), orbsym.begin(),
+              [pg](uint8_t x) { return (uint8_t)PointGroup::swap_pg(pg)(x); });
+    SZ vacuum(0);
+    SZ target(fcidump->n_elec(), fcidump->twos(),
+              PointGroup::swap_pg(pg)(fcidump->isym()));
+    int norb = fcidump->n_sites();
+    shared_ptr<HamiltonianQC<SZ, double>> hamil =
+        make_shared<HamiltonianQC<SZ, double>>(vacuum, norb, orbsym, fcidump);
+
+    test_orbital_gradient<SZ, double>(target, hamil, filename, "SZ");
+
+    hamil->deallocate();
+    fcidump->deallocate();
+}
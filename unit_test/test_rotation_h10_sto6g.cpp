@@ -16,6 +16,11 @@ class TestRotationH10STO6G : public ::testing::Test {
                    const shared_ptr<HamiltonianQC<S, FL>> &hamil_rot,
                    const shared_ptr<HamiltonianQC<S, FL>> &hamil_c1,
                    const string &name, int dot, TETypes te_type, double tol);
+    template <typename S, typename FL>
+    void test_givens(S target, const shared_ptr<HamiltonianQC<S, FL>> &hamil,
+                     const shared_ptr<FCIDUMP<FL>> &fcidump_rot,
+                     const shared_ptr<HamiltonianQC<S, FL>> &hamil_c1,
+                     const string &name, double tol);
     void SetUp() override {
         Random::rand_seed(0);
         frame_<FP>() = make_shared<DataFrame<FP>>(isize, dsize, "nodex");
@@ -172,6 +177,104 @@ void TestRotationH10STO6G::test_dmrg(
     mpo->deallocate();
 }
 
+template <typename S, typename FL>
+void TestRotationH10STO6G::test_givens(
+    S target, const shared_ptr<HamiltonianQC<S, FL>> &hamil,
+    const shared_ptr<FCIDUMP<FL>> &fcidump_rot,
+    const shared_ptr<HamiltonianQC<S, FL>> &hamil_c1, const string &name,
+    double tol) {
+
+    double energy_std = -5.424385375684663;
+
+    Timer t;
+    t.get_time();
+    // MPO construction
+    shared_ptr<MPO<S, FL>> mpo =
+        make_shared<MPOQC<S, FL>>(hamil, QCTypes::Conventional);
+    mpo = make_shared<SimplifiedMPO<S, FL>>(mpo, make_shared<RuleQC<S, FL>>(),
+                                            true);
+
+    ubond_t ket_bond_dim = 500, bra_bond_dim = 1000;
+    vector<ubond_t> ket_bdims = {ket_bond_dim};
+    vector<FL> noises = {1E-6, 1E-8, 1E-10, 0};
+
+    shared_ptr<MPSInfo<S>> mps_info = make_shared<MPSInfo<S>>(
+        hamil->n_sites, hamil->vacuum, target, hamil->basis);
+    mps_info->set_bond_dimension(ket_bond_dim);
+    mps_info->tag = "KET";
+
+    // MPS
+    Random::rand_seed(0);
+
+    shared_ptr<MPS<S, FL>> mps = make_shared<MPS<S, FL>>(hamil->n_sites, 0, 2);
+    mps->initialize(mps_info);
+    mps->random_canonicalize();
+
+    // MPS/MPSInfo save mutable
+    mps->save_mutable();
+    mps->deallocate();
+    mps_info->save_mutable();
+    mps_info->deallocate_mutable();
+
+    // DMRG
+    shared_ptr<MovingEnvironment<S, FL, FL>> me =
+        make_shared<MovingEnvironment<S, FL, FL>>(mpo, mps, mps, "DMRG");
+    me->init_environments(false);
+    shared_ptr<DMRG<S, FL, FL>> dmrg =
+        make_shared<DMRG<S, FL, FL>>(me, ket_bdims, noises);
+    dmrg->noise_type = NoiseTypes::ReducedPerturbative;
+    dmrg->decomp_type = DecompositionTypes::SVD;
+    long double energy = dmrg->solve(20, mps->center == 0, 1E-12);
+
+    EXPECT_LT(abs(energy - energy_std), 1E-7);
+
+    // U = exp(kappa)
+    const int n = hamil->n_sites, ideg = 6;
+    vector<FP> kappa(n * n), work(4 * n * n + ideg + 1);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            kappa[i * n + j] = fcidump_rot->t(i, j);
+    pair<MKL_INT, MKL_INT> pp = IterativeMatrixFunctions<FP>::expo_pade(
+        ideg, n, kappa.data(), n, 1.0, work.data());
+    vector<FP> rot(work.begin() + pp.first, work.begin() + pp.first + n * n);
+
+    t.get_time();
+    shared_ptr<OrbitalRotation<S, FL>> orot =
+        make_shared<OrbitalRotation<S, FL>>(mps, bra_bond_dim);
+    orot->iprint = 1;
+    FP dw = orot->solve(rot);
+    double trot = t.get_time();
+
+    EXPECT_LT(dw, 1E-7);
+
+    // MPO construction
+    shared_ptr<MPO<S, FL>> mpo_c1 =
+        make_shared<MPOQC<S, FL>>(hamil_c1, QCTypes::Conventional);
+    mpo_c1 = make_shared<SimplifiedMPO<S, FL>>(
+        mpo_c1, make_shared<RuleQC<S, FL>>(), true);
+
+    // ME
+    shared_ptr<MovingEnvironment<S, FL, FL>> me_c1 =
+        make_shared<MovingEnvironment<S, FL, FL>>(mpo_c1, mps, mps, "DMRG");
+    me_c1->init_environments(false);
+
+    shared_ptr<Expect<S, FL, FL>> ex =
+        make_shared<Expect<S, FL, FL>>(me_c1, bra_bond_dim, bra_bond_dim);
+    double ener_c1 = ex->solve(false);
+
+    cout << "== " << name << " (GIVENS) ==" << setw(20) << target
+         << " E = " << fixed << setw(22) << setprecision(12) << ener_c1
+         << " error = " << scientific << setprecision(3) << setw(10)
+         << (ener_c1 - energy_std) << " T = " << fixed << setw(10)
+         << setprecision(3) << trot << endl;
+
+    EXPECT_LT(abs(ener_c1 - energy_std), tol);
+
+    mpo_c1->deallocate();
+    mps_info->deallocate();
+    mpo->deallocate();
+}
+
 TEST_F(TestRotationH10STO6G, TestSU2) {
     shared_ptr<FCIDUMP<double>> fcidump = make_shared<FCIDUMP<double>>();
     PGTypes pg = PGTypes::C1;
@@ -258,3 +361,73 @@ TEST_F(TestRotationH10STO6G, TestSZ) {
     hamil->deallocate();
     fcidump->deallocate();
 }
+
+TEST_F(TestRotationH10STO6G, TestGivensSU2) {
+    shared_ptr<FCIDUMP<double>> fcidump = make_shared<FCIDUMP<double>>();
+    PGTypes pg = PGTypes::C1;
+    string filename = "data/H10.STO6G.R1.8.FCIDUMP.LOWDIN";
+    string filename_c1 = "data/H10.STO6G.R1.8.FCIDUMP.C1";
+    string filename_rot = "data/H10.STO6G.R1.8.ROTATION.LOWDIN";
+    fcidump->read(filename);
+    vector<uint8_t> orbsym = fcidump->orb_sym<uint8_t>();
+    transform(orbsym.begin(), orbsym.end(), orbsym.begin(),
+              [pg](uint8_t x) { return (uint8_t)PointGroup::swap_pg(pg)(x); });
+
+    SU2 vacuum(0);
+    SU2 target(fcidump->n_elec(), fcidump->twos(),
+               PointGroup::swap_pg(pg)(fcidump->isym()));
+
+    int norb = fcidump->n_sites();
+    shared_ptr<HamiltonianQC<SU2, double>> hamil =
+        make_shared<HamiltonianQC<SU2, double>>(vacuum, norb, orbsym, fcidump);
+
+    shared_ptr<FCIDUMP<double>> fcidump_rot = make_shared<FCIDUMP<double>>();
+    fcidump_rot->read(filename_rot);
+
+    shared_ptr<FCIDUMP<double>> fcidump_c1 = make_shared<FCIDUMP<double>>();
+    fcidump_c1->read(filename_c1);
+    shared_ptr<HamiltonianQC<SU2, double>> hamil_c1 =
+        make_shared<HamiltonianQC<SU2, double>>(vacuum, norb, orbsym,
+                                                fcidump_c1);
+
+    test_givens<SU2, double>(target, hamil, fcidump_rot, hamil_c1, "SU2/2-site",
+                             1E-7);
+
+    hamil->deallocate();
+    fcidump->deallocate();
+}
+
+TEST_F(TestRotationH10STO6G, TestGivensSZ) {
+    shared_ptr<FCIDUMP<double>> fcidump = make_shared<FCIDUMP<double>>();
+    PGTypes pg = PGTypes::C1;
+    string filename = "data/H10.STO6G.R1.8.FCIDUMP.LOWDIN";
+    string filename_c1 = "data/H10.STO6G.R1.8.FCIDUMP.C1";
+    string filename_rot = "data/H10.STO6G.R1.8.ROTATION.LOWDIN";
+    fcidump->read(filename);
+    vector<uint8_t> orbsym = fcidump->orb_sym<uint8_t>();
+    transform(orbsym.begin(), orbsym.end(), orbsym.begin(),
+              [pg](uint8_t x) { return (uint8_t)PointGroup::swap_pg(pg)(x); });
+
+    SZ vacuum(0);
+    SZ target(fcidump->n_elec(), fcidump->twos(),
+              PointGroup::swap_pg(pg)(fcidump->isym()));
+
+    int norb = fcidump->n_sites();
+    shared_ptr<HamiltonianQC<SZ, double>> hamil =
+        make_shared<HamiltonianQC<SZ, double>>(vacuum, norb, orbsym, fcidump);
+
+    shared_ptr<FCIDUMP<double>> fcidump_rot = make_shared<FCIDUMP<double>>();
+    fcidump_rot->read(filename_rot);
+
+    shared_ptr<FCIDUMP<double>> fcidump_c1 = make_shared<FCIDUMP<double>>();
+    fcidump_c1->read(filename_c1);
+    shared_ptr<HamiltonianQC<SZ, double>> hamil_c1 =
+        make_shared<HamiltonianQC<SZ, double>>(vacuum, norb, orbsym,
+                                               fcidump_c1);
+
+    test_givens<SZ, double>(target, hamil, fcidump_rot, hamil_c1, "SZ/2-site",
+                            1E-7);
+
+    hamil->deallocate();
+    fcidump->deallocate();
+}
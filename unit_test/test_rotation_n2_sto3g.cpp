@@ -0,0 +1,203 @@
+
+#include "block2_core.hpp"
+#include "block2_dmrg.hpp"
+#include <gtest/gtest.h>
+
+using namespace block2;
+
+class TestRotationN2STO3G : public ::testing::Test {
+  protected:
+    size_t isize = 1LL << 20;
+    size_t dsize = 1LL << 28;
+    typedef double FP;
+
+    template <typename S, typename FL>
+    void test_givens(S target, const shared_ptr<HamiltonianQC<S, FL>> &hamil,
+                     const shared_ptr<FCIDUMP<FL>> &fcidump,
+                     const vector<uint8_t> &orbsym, const string &name);
+    void SetUp() override {
+        Random::rand_seed(0);
+        frame_<FP>() = make_shared<DataFrame<FP>>(isize, dsize, "nodex");
+        frame_<FP>()->minimal_disk_usage = true;
+        threading_() = make_shared<Threading>(
+            ThreadingTypes::OperatorBatchedGEMM | ThreadingTypes::Global, 4, 4,
+            1);
+        threading_()->seq_type = SeqTypes::Simple;
+        cout << *threading_() << endl;
+    }
+    void TearDown() override {
+        frame_<FP>()->activate(0);
+        assert(ialloc_()->used == 0 && dalloc_<FP>()->used == 0);
+        frame_<FP>() = nullptr;
+    }
+};
+
+template <typename S, typename FL>
+void TestRotationN2STO3G::test_givens(
+    S target, const shared_ptr<HamiltonianQC<S, FL>> &hamil,
+    const shared_ptr<FCIDUMP<FL>> &fcidump, const vector<uint8_t> &orbsym,
+    const string &name) {
+
+    double energy_std = -107.654122447525;
+
+    shared_ptr<MPO<S, FL>> mpo =
+        make_shared<MPOQC<S, FL>>(hamil, QCTypes::Conventional);
+    mpo = make_shared<SimplifiedMPO<S, FL>>(mpo, make_shared<RuleQC<S, FL>>(),
+                                            true);
+
+    ubond_t bond_dim = 200;
+    vector<ubond_t> bdims = {bond_dim};
+    vector<FL> noises = {1E-6, 1E-8, 0};
+
+    shared_ptr<MPSInfo<S>> mps_info = make_shared<MPSInfo<S>>(
+        hamil->n_sites, hamil->vacuum, target, hamil->basis);
+    mps_info->set_bond_dimension(bond_dim);
+    mps_info->tag = "KET";
+
+    Random::rand_seed(1234);
+
+    shared_ptr<MPS<S, FL>> mps = make_shared<MPS<S, FL>>(hamil->n_sites, 0, 2);
+    mps->initialize(mps_info);
+    mps->random_canonicalize();
+
+    mps->save_mutable();
+    mps->deallocate();
+    mps_info->save_mutable();
+    mps_info->deallocate_mutable();
+
+    shared_ptr<MovingEnvironment<S, FL, FL>> me =
+        make_shared<MovingEnvironment<S, FL, FL>>(mpo, mps, mps, "DMRG");
+    me->init_environments(false);
+    shared_ptr<DMRG<S, FL, FL>> dmrg =
+        make_shared<DMRG<S, FL, FL>>(me, bdims, noises);
+    dmrg->iprint = 0;
+    dmrg->noise_type = NoiseTypes::ReducedPerturbative;
+    dmrg->decomp_type = DecompositionTypes::SVD;
+    long double energy = dmrg->solve(20, mps->center == 0, 1E-12);
+
+    EXPECT_LT(abs(energy - energy_std), 1E-7);
+
+    // rotation mixing the contiguous Ag (sites 0-2) and B1u (sites 3-5)
+    // orbitals, as a product of plane rotations (i, j, theta)
+    const int n = hamil->n_sites;
+    const int planes[6][2] = {{0, 1}, {1, 2}, {0, 2}, {3, 4}, {4, 5}, {3, 5}};
+    const FP thetas[6] = {0.3, -0.2, 0.5, 0.4, 0.25, -0.35};
+    vector<FP> rot(n * n, 0);
+    for (int i = 0; i < n; i++)
+        rot[i * n + i] = 1;
+    for (int ip = 0; ip < 6; ip++) {
+        const int i = planes[ip][0], j = planes[ip][1];
+        const FP c = cos(thetas[ip]), s = sin(thetas[ip]);
+        for (int k = 0; k < n; k++) {
+            FP p = rot[i * n + k], q = rot[j * n + k];
+            rot[i * n + k] = c * p - s * q, rot[j * n + k] = s * p + c * q;
+        }
+    }
+
+    shared_ptr<OrbitalRotation<S, FL>> orot =
+        make_shared<OrbitalRotation<S, FL>>(mps, bond_dim);
+    orot->iprint = 0;
+    vector<int> irreps = orot->site_irreps();
+    for (int i = 0; i < n; i++)
+        EXPECT_EQ(irreps[i], (int)orbsym[i]);
+
+    // Givens gates across irreps cannot be represented in the MPS
+    vector<FP> xrot(n * n, 0);
+    for (int i = 0; i < n; i++)
+        xrot[i * n + i] = 1;
+    const FP xc = cos(0.1), xs = sin(0.1);
+    xrot[2 * n + 2] = xc, xrot[2 * n + 3] = -xs;
+    xrot[3 * n + 2] = xs, xrot[3 * n + 3] = xc;
+    EXPECT_THROW(orot->solve(xrot), runtime_error);
+
+    // same irrep, but not contiguous in the site order
+    vector<int> xorbsym = {0, 1, 0};
+    vector<FP> yrot = {xc, 0, -xs, 0, 1, 0, xs, 0, xc};
+    EXPECT_THROW(
+        (OrbitalRotation<S, FL>::check_rotation(yrot, xorbsym)), runtime_error);
+    OrbitalRotation<S, FL>::check_rotation(rot, irreps);
+
+    FP dw = orot->solve(rot);
+    EXPECT_LT(dw, 1E-7);
+
+    // integrals in the rotated orbitals: rot_mat is (old, new) = rot^T
+    vector<FP> rot_t(n * n);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            rot_t[j * n + i] = rot[i * n + j];
+    shared_ptr<FCIDUMP<FL>> fcidump_rot = fcidump->deep_copy();
+    fcidump_rot->rotate(rot_t);
+    shared_ptr<HamiltonianQC<S, FL>> hamil_rot =
+        make_shared<HamiltonianQC<S, FL>>(hamil->vacuum, n, orbsym,
+                                          fcidump_rot);
+    shared_ptr<MPO<S, FL>> mpo_rot =
+        make_shared<MPOQC<S, FL>>(hamil_rot, QCTypes::Conventional);
+    mpo_rot = make_shared<SimplifiedMPO<S, FL>>(
+        mpo_rot, make_shared<RuleQC<S, FL>>(), true);
+
+    shared_ptr<MovingEnvironment<S, FL, FL>> me_rot =
+        make_shared<MovingEnvironment<S, FL, FL>>(mpo_rot, mps, mps, "DMRG");
+    me_rot->init_environments(false);
+    shared_ptr<Expect<S, FL, FL>> ex =
+        make_shared<Expect<S, FL, FL>>(me_rot, bond_dim, bond_dim);
+    double ener_rot = ex->solve(false);
+
+    cout << "== " << name << " (GIVENS/D2H) ==" << setw(20) << target
+         << " E = " << fixed << setw(22) << setprecision(12) << ener_rot
+         << " error = " << scientific << setprecision(3) << setw(10)
+         << (ener_rot - energy_std) << endl;
+
+    EXPECT_LT(abs(ener_rot - energy_std), 1E-7);
+
+    mpo_rot->deallocate();
+    hamil_rot->deallocate();
+    fcidump_rot->deallocate();
+    mps_info->deallocate();
+    mpo->deallocate();
+}
+
+TEST_F(TestRotationN2STO3G, TestGivensSU2) {
+    shared_ptr<FCIDUMP<double>> fcidump = make_shared<FCIDUMP<double>>();
+    PGTypes pg = PGTypes::D2H;
+    string filename = "data/N2.STO3G.FCIDUMP";
+    fcidump->read(filename);
+    vector<uint8_t> orbsym = fcidump->orb_sym<uint8_t>();
+    transform(orbsym.begin(), orbsym.end(), orbsym.begin(),
+              [pg](uint8_t x) { return (uint8_t)PointGroup::swap_pg(pg)(x); });
+
+    SU2 vacuum(0);
+    SU2 target(fcidump->n_elec(), fcidump->twos(),
+               PointGroup::swap_pg(pg)(fcidump->isym()));
+
+    int norb = fcidump->n_sites();
+    shared_ptr<HamiltonianQC<SU2, double>> hamil =
+        make_shared<HamiltonianQC<SU2, double>>(vacuum, norb, orbsym, fcidump);
+
+    test_givens<SU2, double>(target, hamil, fcidump, orbsym, "SU2/2-site");
+
+    hamil->deallocate();
+    fcidump->deallocate();
+}
+
+TEST_F(TestRotationN2STO3G, TestGivensSZ) {
+    shared_ptr<FCIDUMP<double>> fcidump = make_shared<FCIDUMP<double>>();
+    PGTypes pg = PGTypes::D2H;
+    string filename = "data/N2.STO3G.FCIDUMP";
+    fcidump->read(filename);
+    vector<uint8_t> orbsym = fcidump->orb_sym<uint8_t>();
+    transform(orbsym.begin(), orbsym.end(), orbsym.begin(),
+              [pg](uint8_t x) { return (uint8_t)PointGroup::swap_pg(pg)(x); });
+
+    SZ vacuum(0);
+    SZ target(fcidump->n_elec(), fcidump->twos(),
+              PointGroup::swap_pg(pg)(fcidump->isym()));
+
+    int norb = fcidump->n_sites();
+    shared_ptr<HamiltonianQC<SZ, double>> hamil =
+        make_shared<HamiltonianQC<SZ, double>>(vacuum, norb, orbsym, fcidump);
+
+    test_givens<SZ, double>(target, hamil, fcidump, orbsym, "SZ/2-site");
+
+    hamil->deallocate();
+    fcidump->deallocate();
+}
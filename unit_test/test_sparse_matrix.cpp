@@ -163,6 +163,104 @@ TYPED_TEST(TestSparseMatrix, TestSplit) {
     }
 }
 
+TYPED_TEST(TestSparseMatrix, TestCanonicalize) {
+    using S = TypeParam;
+    int iter = 5, nst = 50, nq = 20;
+    for (int i = 0; i < this->n_tests; i++) {
+        shared_ptr<Allocator<uint32_t>> i_alloc =
+            make_shared<VectorAllocator<uint32_t>>();
+        shared_ptr<Allocator<double>> d_alloc =
+            make_shared<VectorAllocator<double>>();
+        shared_ptr<StateInfo<S>> bsi = this->random_state_info(
+            Random::rand_int(2, iter), Random::rand_int(4, nq),
+            Random::rand_int(4, nst));
+        shared_ptr<StateInfo<S>> ksi = this->random_state_info(
+            Random::rand_int(2, iter), Random::rand_int(4, nq),
+            Random::rand_int(4, nst));
+        S target = bsi->quanta[Random::rand_int(0, bsi->n)] -
+                   ksi->quanta[Random::rand_int(0, ksi->n)];
+        target = target[Random::rand_int(0, target.count())];
+        const bool left = Random::rand_int(0, 2);
+        shared_ptr<SparseMatrixInfo<S>> minfo =
+            make_shared<SparseMatrixInfo<S>>(i_alloc);
+        minfo->initialize(*bsi, *ksi, target, false);
+        assert(minfo->n > 0);
+        // make all sectors tall (left) or wide (right)
+        shared_ptr<StateInfo<S>> xsi = make_shared<StateInfo<S>>(
+            (left ? ksi : bsi)->deep_copy());
+        vector<int> xdim(xsi->n, 0);
+        for (int j = 0; j < minfo->n; j++) {
+            int ix = xsi->find_state(left
+                                         ? minfo->quanta[j].get_ket()
+                                         : minfo->quanta[j].get_bra(target));
+            xdim[ix] += left ? minfo->n_states_bra[j] : minfo->n_states_ket[j];
+        }
+        for (int j = 0; j < xsi->n; j++)
+            if (xdim[j] != 0)
+                xsi->n_states[j] = min((int)xsi->n_states[j], xdim[j]);
+        xsi->collect();
+        minfo = make_shared<SparseMatrixInfo<S>>(i_alloc);
+        minfo->initialize(left ? *bsi : *xsi, left ? *xsi : *ksi, target,
+                          false);
+        shared_ptr<SparseMatrix<S, double>> a =
+            make_shared<SparseMatrix<S, double>>(d_alloc);
+        shared_ptr<SparseMatrix<S, double>> q =
+            make_shared<SparseMatrix<S, double>>(d_alloc);
+        a->allocate(minfo);
+        a->randomize();
+        q->allocate(minfo);
+        q->copy_data_from(a);
+        shared_ptr<SparseMatrixInfo<S>> xinfo =
+            make_shared<SparseMatrixInfo<S>>(i_alloc);
+        xinfo->initialize(*xsi, *xsi, S(), false);
+        shared_ptr<SparseMatrix<S, double>> x =
+            make_shared<SparseMatrix<S, double>>(d_alloc);
+        x->allocate(xinfo);
+        if (left)
+            q->left_canonicalize(x);
+        else
+            q->right_canonicalize(x);
+        // a = q * x or a = x * q for every block
+        for (int j = 0; j < minfo->n; j++) {
+            MatrixRef qm = (*q)[j], am = (*a)[j];
+            int ix = xinfo->find_state(left ? minfo->quanta[j].get_ket()
+                                            : minfo->quanta[j].get_bra(target));
+            MatrixRef tt(d_alloc->allocate(am.size()), am.m, am.n);
+            if (left)
+                MatrixFunctions::multiply(qm, false, (*x)[ix], false, tt, 1.0,
+                                          0.0);
+            else
+                MatrixFunctions::multiply((*x)[ix], false, qm, false, tt, 1.0,
+                                          0.0);
+            ASSERT_TRUE(MatrixFunctions::all_close(tt, am, 1E-10, 1E-10));
+            d_alloc->deallocate(tt.data, am.size());
+        }
+        // sum over blocks in each sector of q^T q (or q q^T) = identity
+        for (int ix = 0; ix < xinfo->n; ix++) {
+            MKL_INT nx = xinfo->n_states_bra[ix];
+            MatrixRef tt(d_alloc->allocate(nx * nx), nx, nx);
+            tt.clear();
+            bool found = false;
+            for (int j = 0; j < minfo->n; j++)
+                if ((left ? minfo->quanta[j].get_ket()
+                          : minfo->quanta[j].get_bra(target)) ==
+                    xinfo->quanta[ix].get_bra(S())) {
+                    MatrixRef qm = (*q)[j];
+                    MatrixFunctions::multiply(qm, left, qm, !left, tt, 1.0,
+                                              1.0);
+                    found = true;
+                }
+            if (found)
+                ASSERT_TRUE(MatrixFunctions::all_close(
+                    tt, IdentityMatrix(nx), 1E-10, 0.0));
+            d_alloc->deallocate(tt.data, nx * nx);
+        }
+        x->deallocate();
+        q->deallocate();
+        a->deallocate();
+    }
+}
+
 TYPED_TEST(TestSparseMatrix, TestComplexInfo) {
     using S = TypeParam;
     shared_ptr<Allocator<uint32_t>> i_alloc =
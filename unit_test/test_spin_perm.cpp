@@ -0,0 +1,82 @@
+#include "block2_core.hpp"
+#include <gtest/gtest.h>
+
+using namespace block2;
+
+class TestSpinPermScheme : public ::testing::Test {
+  protected:
+    typedef double FP;
+    size_t isize = 1LL << 20;
+    size_t dsize = 1LL << 24;
+    string cache_dir = "node0-sps-cache";
+    // keys of the cache files written by the test
+    vector<string> cache_keys;
+    void SetUp() override {
+        frame_<FP>() = make_shared<DataFrame<FP>>(isize, dsize, "nodex");
+        threading_() = make_shared<Threading>(
+            ThreadingTypes::OperatorBatchedGEMM | ThreadingTypes::Global, 4, 4,
+            1);
+    }
+    void TearDown() override {
+        for (auto &key : cache_keys) {
+            const string fn = SpinPermScheme::cache_filename(cache_dir, key);
+            EXPECT_TRUE(Parsing::file_exists(fn));
+            Parsing::remove_file(fn);
+        }
+        Parsing::remove_file(cache_dir);
+        EXPECT_FALSE(Parsing::file_exists(cache_dir));
+        frame_<FP>()->activate(0);
+        assert(ialloc_()->used == 0 && dalloc_<FP>()->used == 0);
+        frame_<FP>() = nullptr;
+    }
+};
+
+TEST_F(TestSpinPermScheme, TestSU2Cache) {
+    const string pdm2 = "((C+(C+D)0)1+D)0";
+    const string pdm3 = "((C+((C+(C+D)0)1+D)0)1+D)0";
+    vector<pair<int, string>> exprs = {make_pair(4, pdm2),
+                                       make_pair(6, pdm3)};
+    for (auto &ex : exprs) {
+        SpinPermScheme r =
+            SpinPermScheme::initialize_su2(ex.first, ex.second, true);
+        SpinPermScheme rs = SpinPermScheme::initialize_su2(
+            ex.first, ex.second, true, false, vector<uint16_t>(), 0,
+            cache_dir);
+        SpinPermScheme rl = SpinPermScheme::initialize_su2(
+            ex.first, ex.second, true, false, vector<uint16_t>(), 0,
+            cache_dir);
+        EXPECT_EQ(r.to_str(), rs.to_str());
+        EXPECT_EQ(r.to_str(), rl.to_str());
+        EXPECT_EQ(r.is_su2, rl.is_su2);
+        EXPECT_EQ(r.left_vacuum, rl.left_vacuum);
+        cache_keys.push_back(SpinPermScheme::cache_key(
+            "SU2", ex.first, ex.second, "N-", vector<uint16_t>(), 0));
+    }
+}
+
+TEST_F(TestSpinPermScheme, TestSZCache) {
+    vector<string> exprs = {"cd", "cCDd", "ccdd", "cCcdDd"};
+    vector<uint16_t> mask = {0, 0, 1, 1};
+    for (auto &ex : exprs) {
+        int nn = (int)ex.length();
+        SpinPermScheme r = SpinPermScheme::initialize_sz(nn, ex, true);
+        SpinPermScheme rs = SpinPermScheme::initialize_sz(
+            nn, ex, true, vector<uint16_t>(), 0, cache_dir);
+        SpinPermScheme rl = SpinPermScheme::initialize_sz(
+            nn, ex, true, vector<uint16_t>(), 0, cache_dir);
+        EXPECT_EQ(r.to_str(), rs.to_str());
+        EXPECT_EQ(r.to_str(), rl.to_str());
+        cache_keys.push_back(SpinPermScheme::cache_key(
+            "SZ", nn, ex, "F", vector<uint16_t>(), 0));
+        if (nn == (int)mask.size()) {
+            SpinPermScheme rm =
+                SpinPermScheme::initialize_sz(nn, ex, true, mask);
+            SpinPermScheme rml = SpinPermScheme::initialize_sz(
+                nn, ex, true, mask, 0, cache_dir);
+            EXPECT_EQ(rm.to_str(), rml.to_str());
+            EXPECT_NE(r.to_str(), rml.to_str());
+            cache_keys.push_back(
+                SpinPermScheme::cache_key("SZ", nn, ex, "F", mask, 0));
+        }
+    }
+}
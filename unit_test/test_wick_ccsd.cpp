@@ -1,5 +1,6 @@
 
 #include "ic/wick.hpp"
+#include "ic/wick_executor.hpp"
 #include <gtest/gtest.h>
 
 using namespace block2;
@@ -191,3 +192,131 @@ TEST_F(TestWickCCSD, TestCCSD) {
         EXPECT_TRUE(diff.terms.size() == 0);
     }
 }
+
+TEST_F(TestWickCCSD, TestCCSDExecutor) {
+    map<WickIndexTypes, set<WickIndex>> idx_map;
+    map<pair<string, int>, vector<WickPermutation>> perm_map;
+    idx_map[WickIndexTypes::Inactive] = WickIndex::parse_set("pqrsijklmno");
+    idx_map[WickIndexTypes::External] = WickIndex::parse_set("pqrsabcdefg");
+    perm_map[make_pair("v", 4)] = WickPermutation::four_anti();
+    perm_map[make_pair("t", 2)] = WickPermutation::non_symmetric();
+    perm_map[make_pair("t", 4)] = WickPermutation::pair_anti_symmetric(2);
+    auto px = [&idx_map, &perm_map](const string &x) {
+        return WickExpr::parse(x, idx_map, perm_map);
+    };
+    auto pt = [&idx_map, &perm_map](const string &x) {
+        return WickTensor::parse(x, idx_map, perm_map);
+    };
+    WickExpr h = (px("SUM <pq> h[pq] C[p] D[q]") +
+                  0.25 * px("SUM <pqrs> v[pqrs] C[p] C[q] D[s] D[r]"))
+                     .expand(-1, true)
+                     .simplify();
+    WickExpr t = (px("SUM <ai> t[ia] C[a] D[i]") +
+                  0.25 * px("SUM <abij> t[ijab] C[a] C[b] D[j] D[i]"))
+                     .expand(-1, true)
+                     .simplify();
+    auto hbar = [&h, &t](int order) {
+        WickExpr hx = h, amp = h;
+        for (int i = 1; i <= order; i++)
+            hx = (1.0 / i) * (hx ^ t).expand((order + 1 - i) * 4).simplify(),
+            amp = amp + hx;
+        return amp;
+    };
+    WickExpr en_eq = hbar(2).expand(0).simplify();
+    WickExpr t1_eq = (px("C[i] D[a]") * hbar(3)).expand(0).simplify();
+    WickExpr t2_eq = (px("C[i] C[j] D[b] D[a]") * hbar(4)).expand(0).simplify();
+    WickGraph gr;
+    gr.add_term(pt("E"), en_eq);
+    gr.add_term(pt("t1new[ia]"), t1_eq);
+    gr.add_term(pt("t2new[ijab]"), t2_eq);
+    WickGraph sgr = gr.simplify();
+    const MKL_INT no = 3, nv = 4, n = no + nv;
+    NDArray hx = NDArray::random({n, n}), vx = NDArray::random({n, n, n, n});
+    NDArray v({n, n, n, n}), t1 = NDArray::random({no, nv});
+    NDArray t2x = NDArray::random({no, no, nv, nv}), t2({no, no, nv, nv});
+    NDArray::transpose(vx, v);
+    NDArray::transpose(vx, v, {1, 0, 2, 3}, -1.0, 1.0);
+    NDArray::transpose(vx, v, {0, 1, 3, 2}, -1.0, 1.0);
+    NDArray::transpose(vx, v, {1, 0, 3, 2}, 1.0, 1.0);
+    NDArray::transpose(t2x, t2);
+    NDArray::transpose(t2x, t2, {1, 0, 2, 3}, -1.0, 1.0);
+    NDArray::transpose(t2x, t2, {0, 1, 3, 2}, -1.0, 1.0);
+    NDArray::transpose(t2x, t2, {1, 0, 3, 2}, 1.0, 1.0);
+    auto get_block = [no, n](const NDArray &x, const string &suffix) {
+        vector<NDArraySlice> sl;
+        for (auto &c : suffix)
+            sl.push_back(c == 'I' ? NDArraySlice(0, no) : NDArraySlice(no, n));
+        return x.slice(sl).to_c_order();
+    };
+    size_t max_dense_size = 0;
+    auto run = [&](const WickGraph &g, bool packed_t2, size_t max_slab_size,
+                   bool parallel) {
+        WickGraphExecutor ex(g);
+        ex.max_slab_size = max_slab_size;
+        ex.parallel_statements = parallel;
+        for (auto &name : ex.input_names())
+            if (name == "tIE")
+                ex.dense[name] = t1;
+            else if (name == "tIIEE" && packed_t2)
+                ex.packed[name] = make_shared<WickPackedTensor>(
+                    WickPackedTensor::pack(t2, {2, 2}));
+            else if (name == "tIIEE")
+                ex.dense[name] = t2;
+            else if (name[0] == 'h')
+                ex.dense[name] = get_block(hx, name.substr(1));
+            else if ((name == "vIIII" || name == "vEEEE") && packed_t2)
+                ex.packed[name] = make_shared<WickPackedTensor>(
+                    WickPackedTensor::pack(get_block(v, name.substr(1)),
+                                           {2, 2}));
+            else if (name[0] == 'v')
+                ex.dense[name] = get_block(v, name.substr(1));
+            else
+                EXPECT_TRUE(false) << "unknown tensor " << name;
+        ex.dense["E"] = NDArray(vector<MKL_INT>{});
+        if (packed_t2)
+            ex.packed["t2new"] = make_shared<WickPackedTensor>(
+                vector<MKL_INT>{no, no, nv, nv}, vector<int>{2, 2});
+        shared_ptr<Threading> th = threading_();
+        ex.execute();
+        // global threading settings are restored after parallel levels
+        EXPECT_EQ(threading_(), th);
+        size_t n_terms = 0;
+        for (auto &expr : g.right)
+            n_terms += expr.terms.size();
+        EXPECT_EQ(ex.profile.size(), n_terms);
+        max_dense_size = 0;
+        for (auto &p : ex.profile)
+            max_dense_size = max(max_dense_size, p.dense_size);
+        if (packed_t2)
+            ex.dense["t2new"] = ex.packed.at("t2new")->unpack();
+        return vector<NDArray>{ex.dense.at("E"), ex.dense.at("t1new"),
+                               ex.dense.at("t2new")};
+    };
+    // closed-form energy
+    double e_ref = 0;
+    for (MKL_INT i = 0; i < no; i++)
+        for (MKL_INT a = 0; a < nv; a++) {
+            e_ref += hx[{i, no + a}] * t1[{i, a}];
+            for (MKL_INT j = 0; j < no; j++)
+                for (MKL_INT b = 0; b < nv; b++)
+                    e_ref += 0.25 * v[{i, j, no + a, no + b}] *
+                                 t2[{i, j, a, b}] +
+                             0.5 * v[{i, j, no + a, no + b}] * t1[{i, a}] *
+                                 t1[{j, b}];
+        }
+    vector<NDArray> rref = run(gr, false, (size_t)1 << 24, false);
+    vector<NDArray> rsim = run(sgr, false, (size_t)1 << 24, true);
+    vector<NDArray> rpk = run(sgr, true, 20, true);
+    // packed tensors are only unpacked in slabs, at most one row of vEEEE
+    EXPECT_GT(max_dense_size, (size_t)0);
+    EXPECT_LE(max_dense_size, (size_t)(nv * nv * nv));
+    vector<NDArray> rpkx = run(gr, true, 20, false);
+    EXPECT_LE(max_dense_size, (size_t)(nv * nv * nv));
+    EXPECT_LT(abs(rref[0].item() - e_ref), 1E-10);
+    for (int k = 0; k < 3; k++) {
+        EXPECT_LT((rsim[k] - rref[k]).norm(), 1E-10 * max(1.0, rref[k].norm()));
+        EXPECT_LT((rpk[k] - rref[k]).norm(), 1E-10 * max(1.0, rref[k].norm()));
+        EXPECT_LT((rpkx[k] - rref[k]).norm(),
+                  1E-10 * max(1.0, rref[k].norm()));
+    }
+}